@@ -0,0 +1,19 @@
+#ifndef LOADGEN_CONFIG_H
+#define LOADGEN_CONFIG_H
+
+// Valores por defecto del generador de carga (sobrescribibles por línea de comandos)
+
+#define LG_DEFAULT_DEVICES      50
+#define LG_DEFAULT_THREADS      4
+#define LG_DEFAULT_SPEED        60.0     // 1 s real = 1 min simulado
+#define LG_DEFAULT_RUN_S        30
+#define LG_DEFAULT_REPORT_S     5
+
+// Cadencias iguales a Beans_telemetry_lab/src/main.cpp
+#define LG_SAMPLE_MS            5000     // updateData()
+#define LG_PUBLISH_MS           60000    // intervalo de UbidotsManager / ThingsBoardManager
+
+#define LG_TB_PORT              1883
+#define LG_WRITE_TIMEOUT_MS     5000     // timeout real de un write() bloqueado
+
+#endif
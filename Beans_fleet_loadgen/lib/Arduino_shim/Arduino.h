@@ -0,0 +1,52 @@
+#ifndef ARDUINO_SHIM_H
+#define ARDUINO_SHIM_H
+
+/**
+ * Shim mínimo de Arduino para compilar en Linux el código real del firmware
+ * (UbidotsManager, ThingsBoardManager, PubSubClient, UbidotsEsp32Mqtt).
+ * - millis()/delay() usan un reloj acelerado (ArduinoShim::setSpeed).
+ * - Serial descarta la salida salvo ArduinoShim::setVerbose(true).
+ * Solo cubre lo que usan esas librerías; no es un core Arduino completo.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "WString.h"
+#include "Print.h"
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define PROGMEM
+#define F(s) (s)
+#define pgm_read_byte_near(p) (*(const uint8_t*)(p))
+#define pgm_read_byte(p)      (*(const uint8_t*)(p))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+class HardwareSerial : public Print {
+  public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+namespace ArduinoShim {
+  // Factor de aceleración del reloj: millis() avanza speed ms por ms real
+  void   setSpeed(double speed);
+  double speed();
+  void   setVerbose(bool v);
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef IPADDRESS_SHIM_H
+#define IPADDRESS_SHIM_H
+
+#include <stdint.h>
+
+class IPAddress {
+  public:
+    IPAddress() : _b{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _b{a, b, c, d} {}
+    uint8_t  operator[](int i) const { return _b[i]; }
+    uint8_t& operator[](int i)       { return _b[i]; }
+
+  private:
+    uint8_t _b[4];
+};
+
+#endif
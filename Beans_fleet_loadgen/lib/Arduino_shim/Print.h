@@ -0,0 +1,35 @@
+#ifndef PRINT_SHIM_H
+#define PRINT_SHIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "WString.h"
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+      size_t n = 0;
+      while (size--) n += write(*buffer++);
+      return n;
+    }
+    size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+
+    size_t print(const char* s)     { return write(s); }
+    size_t print(const String& s)   { return write(s.c_str()); }
+    size_t print(char c)            { return write((uint8_t)c); }
+    size_t print(int v)             { return print(String(v)); }
+    size_t print(unsigned int v)    { return print(String(v)); }
+    size_t print(long v)            { return print(String(v)); }
+    size_t print(unsigned long v)   { return print(String(v)); }
+    size_t print(double v, int d = 2) { return print(String(v, (unsigned char)d)); }
+
+    size_t println()                     { return write("\r\n"); }
+    template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+#endif
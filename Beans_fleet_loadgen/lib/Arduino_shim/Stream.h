@@ -0,0 +1,14 @@
+#ifndef STREAM_SHIM_H
+#define STREAM_SHIM_H
+
+#include "Print.h"
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+};
+
+#endif
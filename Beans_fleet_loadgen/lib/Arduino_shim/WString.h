@@ -0,0 +1,36 @@
+#ifndef WSTRING_SHIM_H
+#define WSTRING_SHIM_H
+
+#include <string>
+
+// String de Arduino sobre std::string (solo lo usado por las librerías enlazadas)
+class String {
+  public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int v)           : _s(std::to_string(v)) {}
+    String(unsigned int v)  : _s(std::to_string(v)) {}
+    String(long v)          : _s(std::to_string(v)) {}
+    String(unsigned long v) : _s(std::to_string(v)) {}
+    String(float v, unsigned char decimals = 2);
+    String(double v, unsigned char decimals = 2);
+
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    const char*  c_str() const  { return _s.c_str(); }
+    bool         isEmpty() const { return _s.empty(); }
+
+    String& operator+=(const String& o) { _s += o._s; return *this; }
+    String& operator+=(const char* o)   { _s += o; return *this; }
+    String& operator+=(char c)          { _s += c; return *this; }
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b)   { return String(a._s + b); }
+    friend String operator+(const char* a, const String& b)   { return String(a + b._s); }
+    bool operator==(const String& o) const { return _s == o._s; }
+
+  private:
+    std::string _s;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef WIFI_SHIM_H
+#define WIFI_SHIM_H
+
+#include "Arduino.h"
+#include "Client.h"
+#include "IPAddress.h"
+
+#define WL_CONNECTED 3
+
+/**
+ * WiFiClient sobre sockets TCP de Linux.
+ * - write() es bloqueante como en el ESP32 (espera hasta writeTimeoutMs reales):
+ *   si el broker no lee, el tiempo bloqueado aparece como latencia de publish.
+ * - Todas las conexiones pueden redirigirse al broker local (WiFiShim::setBrokerOverride).
+ */
+class WiFiClient : public Client {
+  public:
+    WiFiClient() {}
+    ~WiFiClient() override { stop(); }
+    WiFiClient(const WiFiClient&) = delete;
+    WiFiClient& operator=(const WiFiClient&) = delete;
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t* buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return _fd >= 0; }
+    using Print::write;
+
+  private:
+    int _fd = -1;
+};
+
+class WiFiClass {
+  public:
+    void     begin(const char*, const char*) {}
+    int      status() { return WL_CONNECTED; }
+    String   macAddress();              // única por dispositivo (WiFiShim::setDeviceId)
+    String   localIP() { return String("127.0.0.1"); }
+};
+
+extern WiFiClass WiFi;
+
+namespace WiFiShim {
+  // Redirige todo connect() (p.ej. industrial.api.ubidots.com) a host:port
+  void setBrokerOverride(const char* host, uint16_t port);
+
+  // Id del dispositivo que se está construyendo en este hilo (define la MAC / clientId)
+  void setDeviceId(uint32_t id);
+
+  // Timeout real de write() bloqueante
+  void setWriteTimeoutMs(uint32_t ms);
+
+  struct NetStats {
+    unsigned long long bytesOut;
+    unsigned long long writeBlockedUs;   // tiempo total esperando espacio en el socket
+    unsigned long      writeTimeouts;
+    unsigned long      connects;
+    unsigned long      connectFails;
+  };
+  NetStats stats();
+
+  // Bytes escritos por los clientes que el broker aún no confirmó (SIOCOUTQ)
+  unsigned long long unsentBytes();
+}
+
+#endif
@@ -0,0 +1,252 @@
+#include "Arduino.h"
+#include "WiFi.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/sockios.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+// ================== Reloj ==================
+static const auto   g_start = std::chrono::steady_clock::now();
+static std::atomic<double> g_speed{1.0};
+static std::atomic<bool>   g_verbose{false};
+
+static double realMs() {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - g_start).count();
+}
+
+unsigned long millis() { return (unsigned long)(realMs() * g_speed.load()); }
+unsigned long micros() { return (unsigned long)(realMs() * 1000.0 * g_speed.load()); }
+
+void delay(unsigned long ms) {
+  double real = (double)ms / g_speed.load();
+  std::this_thread::sleep_for(std::chrono::microseconds((long long)(real * 1000.0)));
+}
+
+void yield() { std::this_thread::yield(); }
+
+namespace ArduinoShim {
+  void   setSpeed(double s)   { g_speed = (s > 0) ? s : 1.0; }
+  double speed()              { return g_speed.load(); }
+  void   setVerbose(bool v)   { g_verbose = v; }
+}
+
+// ================== Serial / Print / String ==================
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (g_verbose) fputc(c, stdout);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t size) {
+  if (g_verbose) fwrite(buf, 1, size, stdout);
+  return size;
+}
+
+size_t Print::printf(const char* fmt, ...) {
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n <= 0) return 0;
+  return write((const uint8_t*)buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
+
+String::String(float v, unsigned char decimals) : String((double)v, decimals) {}
+
+String::String(double v, unsigned char decimals) {
+  char b[48];
+  snprintf(b, sizeof(b), "%.*f", (int)decimals, v);
+  _s = b;
+}
+
+// ================== WiFi ==================
+WiFiClass WiFi;
+
+static std::mutex          g_netMutex;
+static std::set<int>       g_liveFds;
+static std::string         g_overrideHost;
+static uint16_t            g_overridePort = 0;
+static std::atomic<uint32_t> g_writeTimeoutMs{5000};
+static thread_local uint32_t t_deviceId = 0;
+
+static std::atomic<unsigned long long> g_bytesOut{0};
+static std::atomic<unsigned long long> g_blockedUs{0};
+static std::atomic<unsigned long>      g_writeTimeouts{0};
+static std::atomic<unsigned long>      g_connects{0};
+static std::atomic<unsigned long>      g_connectFails{0};
+
+namespace WiFiShim {
+  void setBrokerOverride(const char* host, uint16_t port) {
+    std::lock_guard<std::mutex> lk(g_netMutex);
+    g_overrideHost = host ? host : "";
+    g_overridePort = port;
+  }
+  void setDeviceId(uint32_t id)         { t_deviceId = id; }
+  void setWriteTimeoutMs(uint32_t ms)   { g_writeTimeoutMs = ms ? ms : 1; }
+
+  NetStats stats() {
+    return { g_bytesOut.load(), g_blockedUs.load(), g_writeTimeouts.load(),
+             g_connects.load(), g_connectFails.load() };
+  }
+
+  unsigned long long unsentBytes() {
+    std::lock_guard<std::mutex> lk(g_netMutex);
+    unsigned long long total = 0;
+    for (int fd : g_liveFds) {
+      int q = 0;
+      if (ioctl(fd, SIOCOUTQ, &q) == 0 && q > 0) total += (unsigned long long)q;
+    }
+    return total;
+  }
+}
+
+String WiFiClass::macAddress() {
+  char b[18];
+  snprintf(b, sizeof(b), "02:00:%02X:%02X:%02X:%02X",
+           (t_deviceId >> 24) & 0xFF, (t_deviceId >> 16) & 0xFF,
+           (t_deviceId >> 8) & 0xFF, t_deviceId & 0xFF);
+  return String(b);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+  char host[16];
+  snprintf(host, sizeof(host), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+  return connect(host, port);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+  stop();
+
+  std::string h = host ? host : "";
+  {
+    std::lock_guard<std::mutex> lk(g_netMutex);
+    if (!g_overrideHost.empty()) { h = g_overrideHost; port = g_overridePort; }
+  }
+
+  struct addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* res = nullptr;
+  char portStr[8];
+  snprintf(portStr, sizeof(portStr), "%u", (unsigned)port);
+  if (getaddrinfo(h.c_str(), portStr, &hints, &res) != 0 || !res) {
+    g_connectFails++;
+    return 0;
+  }
+
+  int fd = socket(res->ai_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0 || ::connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+    if (fd >= 0) ::close(fd);
+    freeaddrinfo(res);
+    g_connectFails++;
+    return 0;
+  }
+  freeaddrinfo(res);
+
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  _fd = fd;
+  {
+    std::lock_guard<std::mutex> lk(g_netMutex);
+    g_liveFds.insert(fd);
+  }
+  g_connects++;
+  return 1;
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+  if (_fd < 0) return 0;
+
+  size_t sent = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  bool blocked = false;
+  while (sent < size) {
+    ssize_t n = ::send(_fd, buf + sent, size - sent, MSG_NOSIGNAL);
+    if (n > 0) { sent += (size_t)n; continue; }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      blocked = true;
+      auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - t0).count();
+      long left = (long)g_writeTimeoutMs.load() - (long)waited;
+      if (left <= 0) { g_writeTimeouts++; break; }
+      struct pollfd p = { _fd, POLLOUT, 0 };
+      poll(&p, 1, (int)left);
+      continue;
+    }
+    stop();
+    break;
+  }
+  if (blocked) {
+    g_blockedUs += (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - t0).count();
+  }
+  g_bytesOut += sent;
+  return sent;
+}
+
+int WiFiClient::available() {
+  if (_fd < 0) return 0;
+  int n = 0;
+  if (ioctl(_fd, FIONREAD, &n) != 0) return 0;
+  return n;
+}
+
+int WiFiClient::read() {
+  uint8_t b;
+  return (read(&b, 1) == 1) ? b : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+  if (_fd < 0) return -1;
+  ssize_t n = ::recv(_fd, buf, size, 0);
+  if (n > 0) return (int)n;
+  if (n == 0) stop();
+  return -1;
+}
+
+int WiFiClient::peek() {
+  if (_fd < 0) return -1;
+  uint8_t b;
+  return (::recv(_fd, &b, 1, MSG_PEEK) == 1) ? b : -1;
+}
+
+void WiFiClient::stop() {
+  if (_fd < 0) return;
+  {
+    std::lock_guard<std::mutex> lk(g_netMutex);
+    g_liveFds.erase(_fd);
+  }
+  ::close(_fd);
+  _fd = -1;
+}
+
+uint8_t WiFiClient::connected() {
+  if (_fd < 0) return 0;
+  uint8_t b;
+  ssize_t n = ::recv(_fd, &b, 1, MSG_PEEK);
+  if (n == 0) { stop(); return 0; }                      // el broker cerró
+  if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) { stop(); return 0; }
+  return 1;
+}
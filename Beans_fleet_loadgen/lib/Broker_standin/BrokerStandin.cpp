@@ -0,0 +1,224 @@
+#include "BrokerStandin.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Conn {
+  std::vector<uint8_t> in;
+};
+
+void sendSmall(int fd, const uint8_t* b, size_t n) {
+  // Respuestas de 2-5 bytes: si el socket del cliente está lleno se pierden (como QoS0)
+  ::send(fd, b, n, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+
+// Decodifica "remaining length". Retorna bytes de cabecera (0 = incompleto, -1 = inválido)
+int fixedHeader(const std::vector<uint8_t>& b, uint32_t& remaining) {
+  remaining = 0;
+  uint32_t mult = 1;
+  for (size_t i = 1; i < b.size() && i <= 4; ++i) {
+    remaining += (b[i] & 0x7F) * mult;
+    if ((b[i] & 0x80) == 0) return (int)i + 1;
+    mult *= 128;
+  }
+  return (b.size() > 4) ? -1 : 0;
+}
+
+uint64_t nowMs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+uint16_t BrokerStandin::start(uint16_t port, uint32_t rateKBps, int rcvBufBytes) {
+  if (_running) return 0;
+  _rateKBps = rateKBps;
+
+  _listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (_listenFd < 0) return 0;
+  int one = 1;
+  setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  // Heredado por los sockets aceptados: buffer chico = backpressure visible antes
+  if (rcvBufBytes > 0) setsockopt(_listenFd, SOL_SOCKET, SO_RCVBUF, &rcvBufBytes, sizeof(rcvBufBytes));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (bind(_listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(_listenFd, 1024) != 0) {
+    ::close(_listenFd);
+    _listenFd = -1;
+    return 0;
+  }
+  socklen_t len = sizeof(addr);
+  getsockname(_listenFd, (sockaddr*)&addr, &len);
+
+  _epollFd = epoll_create1(EPOLL_CLOEXEC);
+  _wakeFd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.fd = _listenFd;
+  epoll_ctl(_epollFd, EPOLL_CTL_ADD, _listenFd, &ev);
+  ev.data.fd = _wakeFd;
+  epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakeFd, &ev);
+
+  _running = true;
+  _thread = std::thread(&BrokerStandin::run, this);
+  return ntohs(addr.sin_port);
+}
+
+void BrokerStandin::stop() {
+  if (!_running) return;
+  _running = false;
+  uint64_t one = 1;
+  if (::write(_wakeFd, &one, sizeof(one)) < 0) { /* el hilo sale por timeout */ }
+  if (_thread.joinable()) _thread.join();
+  ::close(_wakeFd);
+  ::close(_epollFd);
+  ::close(_listenFd);
+  _wakeFd = _epollFd = _listenFd = -1;
+}
+
+BrokerStats BrokerStandin::stats() const {
+  return { _sessions.load(), _open.load(), _publishes.load(), _payloadBytes.load(),
+           _bytesIn.load(), _pings.load(), _throttledMs.load() };
+}
+
+void BrokerStandin::run() {
+  std::unordered_map<int, Conn> conns;
+  epoll_event events[256];
+  uint8_t chunk[4096];
+
+  // Token bucket en bytes (ráfaga máxima = 100 ms de tasa)
+  const double perMs = _rateKBps * 1024.0 / 1000.0;
+  const double burst = std::max(4096.0, perMs * 100.0);
+  double tokens = burst;
+  uint64_t lastRefill = nowMs();
+
+  auto closeConn = [&](int fd) {
+    epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    conns.erase(fd);
+    _open--;
+  };
+
+  while (_running) {
+    if (_rateKBps) {
+      uint64_t now = nowMs();
+      tokens = std::min(burst, tokens + (now - lastRefill) * perMs);
+      lastRefill = now;
+      if (tokens < 1.0) {
+        // Sin presupuesto: no se lee nada y los buffers TCP de los clientes se llenan
+        usleep(2000);
+        _throttledMs += 2;
+        continue;
+      }
+    }
+
+    int n = epoll_wait(_epollFd, events, 256, 100);
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == _wakeFd) continue;
+
+      if (fd == _listenFd) {
+        for (;;) {
+          int c = accept4(_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+          if (c < 0) break;
+          epoll_event ev = {};
+          ev.events = EPOLLIN | EPOLLRDHUP;
+          ev.data.fd = c;
+          epoll_ctl(_epollFd, EPOLL_CTL_ADD, c, &ev);
+          conns[c];
+          _open++;
+        }
+        continue;
+      }
+
+      auto it = conns.find(fd);
+      if (it == conns.end()) continue;
+
+      size_t want = sizeof(chunk);
+      if (_rateKBps) want = std::min(want, (size_t)tokens);
+      if (want == 0) break;
+      ssize_t r = ::recv(fd, chunk, want, 0);
+      if (r == 0 || (r < 0 && errno != EAGAIN && errno != EINTR)) { closeConn(fd); continue; }
+      if (r < 0) continue;
+      if (_rateKBps) tokens -= r;
+      _bytesIn += r;
+
+      Conn& c = it->second;
+      c.in.insert(c.in.end(), chunk, chunk + r);
+
+      bool drop = false;
+      for (;;) {
+        if (c.in.size() < 2) break;
+        uint32_t rem;
+        int hdr = fixedHeader(c.in, rem);
+        if (hdr < 0) { drop = true; break; }
+        if (hdr == 0 || c.in.size() < hdr + rem) break;
+
+        const uint8_t type = c.in[0] >> 4;
+        const uint8_t* p = c.in.data() + hdr;
+        switch (type) {
+          case 1: {   // CONNECT
+            static const uint8_t connack[] = {0x20, 0x02, 0x00, 0x00};
+            sendSmall(fd, connack, sizeof(connack));
+            _sessions++;
+            break;
+          }
+          case 3: {   // PUBLISH
+            uint8_t qos = (c.in[0] >> 1) & 0x03;
+            if (rem < 2) { drop = true; break; }
+            uint32_t tlen = ((uint32_t)p[0] << 8) | p[1];
+            uint32_t head = 2 + tlen + (qos ? 2 : 0);
+            if (head > rem) { drop = true; break; }
+            _publishes++;
+            _payloadBytes += rem - head;
+            if (qos == 1) {
+              uint8_t puback[] = {0x40, 0x02, p[2 + tlen], p[3 + tlen]};
+              sendSmall(fd, puback, sizeof(puback));
+            }
+            break;
+          }
+          case 8: {   // SUBSCRIBE
+            if (rem < 2) { drop = true; break; }
+            uint8_t suback[] = {0x90, 0x03, p[0], p[1], 0x00};
+            sendSmall(fd, suback, sizeof(suback));
+            break;
+          }
+          case 12: {  // PINGREQ
+            static const uint8_t pingresp[] = {0xD0, 0x00};
+            sendSmall(fd, pingresp, sizeof(pingresp));
+            _pings++;
+            break;
+          }
+          case 14:    // DISCONNECT
+            drop = true;
+            break;
+          default:
+            break;
+        }
+        if (drop) break;
+        c.in.erase(c.in.begin(), c.in.begin() + hdr + rem);
+      }
+      if (drop) closeConn(fd);
+    }
+  }
+
+  for (auto& kv : conns) ::close(kv.first);
+  _open = 0;
+}
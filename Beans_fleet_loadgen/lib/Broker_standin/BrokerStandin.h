@@ -0,0 +1,53 @@
+#ifndef BROKERSTANDIN_H
+#define BROKERSTANDIN_H
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+struct BrokerStats {
+  unsigned long      sessions;      // CONNECT aceptados
+  unsigned long      openSockets;
+  unsigned long      publishes;
+  unsigned long long payloadBytes;
+  unsigned long long bytesIn;
+  unsigned long      pings;
+  unsigned long      throttledMs;   // tiempo sin leer por el límite de tasa
+};
+
+/**
+ * Broker MQTT 3.1.1 de reemplazo para pruebas de carga sin red.
+ * - CONNECT -> CONNACK(0), PUBLISH se cuenta (QoS1 -> PUBACK), SUBSCRIBE -> SUBACK,
+ *   PINGREQ -> PINGRESP. No reenvía mensajes a suscriptores.
+ * - rateKBps > 0 limita los bytes leídos por segundo: los sockets se llenan y
+ *   los clientes ven el mismo backpressure que con un broker saturado.
+ * - Un solo hilo con epoll; start() retorna el puerto (0 = error).
+ */
+class BrokerStandin {
+  public:
+    ~BrokerStandin() { stop(); }
+
+    uint16_t start(uint16_t port = 0, uint32_t rateKBps = 0, int rcvBufBytes = 0);
+    void stop();
+    BrokerStats stats() const;
+
+  private:
+    int _listenFd = -1;
+    int _epollFd  = -1;
+    int _wakeFd   = -1;
+    uint32_t _rateKBps = 0;
+    std::thread _thread;
+    std::atomic<bool> _running{false};
+
+    std::atomic<unsigned long>      _sessions{0};
+    std::atomic<unsigned long>      _open{0};
+    std::atomic<unsigned long>      _publishes{0};
+    std::atomic<unsigned long long> _payloadBytes{0};
+    std::atomic<unsigned long long> _bytesIn{0};
+    std::atomic<unsigned long>      _pings{0};
+    std::atomic<unsigned long>      _throttledMs{0};
+
+    void run();
+};
+
+#endif
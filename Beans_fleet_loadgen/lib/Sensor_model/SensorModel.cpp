@@ -0,0 +1,57 @@
+#include "SensorModel.h"
+#include <math.h>
+#include <time.h>
+
+static const float kPi = 3.14159265f;
+static const int64_t kEpochBase = 1767225600;   // 2026-01-01 00:00:00 UTC
+
+SensorModel::SensorModel(uint32_t deviceId) {
+  _rng = deviceId * 2654435761u + 1;
+  _tempOffset = noise() * 1.5f;
+  _humOffset  = noise() * 5.0f;
+  for (int i = 0; i < 3; ++i) _luxGain[i] = 1.0f + noise() * 0.12f;
+  _startHour = 6.0f + (deviceId % 12);            // la flota no arranca sincronizada
+}
+
+float SensorModel::noise() {
+  // xorshift32
+  _rng ^= _rng << 13;
+  _rng ^= _rng >> 17;
+  _rng ^= _rng << 5;
+  return (float)(_rng & 0xFFFFFF) / (float)0x7FFFFF - 1.0f;
+}
+
+void SensorModel::fill(TelemetryRecord& rec, uint32_t simMs) {
+  const float hours = _startHour + simMs / 3600000.0f;
+  const float hod = fmodf(hours, 24.0f);
+
+  // Máximo a las 15 h, mínimo a las 3 h
+  const float diurnal = sinf(2.0f * kPi * (hod - 9.0f) / 24.0f);
+
+  _cloud += noise() * 0.05f;
+  if (_cloud < 0.0f) _cloud = 0.0f;
+  if (_cloud > 1.0f) _cloud = 1.0f;
+
+  rec.temperatureOutdoor = 19.0f + 7.0f * diurnal - 2.0f * _cloud + _tempOffset + noise() * 0.3f;
+  rec.humidityOutdoor    = 68.0f - 18.0f * diurnal + 8.0f * _cloud + _humOffset + noise() * 1.0f;
+  rec.temperatureIndoor  = rec.temperatureOutdoor + 3.0f + noise() * 0.2f;
+  rec.humidityIndoor     = rec.humidityOutdoor + 6.0f + noise() * 0.8f;
+  if (rec.humidityOutdoor > 100.0f) rec.humidityOutdoor = 100.0f;
+  if (rec.humidityIndoor  > 100.0f) rec.humidityIndoor  = 100.0f;
+
+  // Luz: 0 de noche, campana entre 6 h y 18 h
+  float sun = (hod > 6.0f && hod < 18.0f) ? sinf(kPi * (hod - 6.0f) / 12.0f) : 0.0f;
+  float lux = sun * 55000.0f * (1.0f - 0.7f * _cloud);
+  rec.lux1 = fmaxf(0.0f, lux * _luxGain[0] * 0.6f + noise() * 20.0f);   // TSL2561 satura antes
+  rec.lux2 = fmaxf(0.0f, lux * _luxGain[1] + noise() * 20.0f);
+  rec.lux3 = fmaxf(0.0f, lux * _luxGain[2] * 0.9f + noise() * 20.0f);
+
+  rec.sensorsError = (noise() > 0.998f);   // ~0.1 % de lecturas con fallo
+
+  rec.uptimeMs = simMs;
+  rec.epoch = kEpochBase + (int64_t)(hours * 3600.0f);
+  time_t t = (time_t)rec.epoch;
+  struct tm tmv;
+  gmtime_r(&t, &tmv);
+  strftime(rec.timestamp, sizeof(rec.timestamp), "%Y-%m-%d %H:%M:%S", &tmv);
+}
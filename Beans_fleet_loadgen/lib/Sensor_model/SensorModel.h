@@ -0,0 +1,32 @@
+#ifndef SENSORMODEL_H
+#define SENSORMODEL_H
+
+#include <stdint.h>
+#include "TelemetryRecord.h"
+
+/**
+ * Curvas de sensores del invernadero para un dispositivo simulado.
+ * - Temperatura/humedad: ciclo diario (mínimo al amanecer, máximo ~15 h) + ruido.
+ * - Lux: campana diurna con nubosidad variable; los 3 sensores con ganancias
+ *   distintas (TSL2561, VEML7700, BH1750 no leen igual).
+ * - Cada dispositivo tiene su propio desfase, offset y semilla (deterministas por id).
+ */
+class SensorModel {
+  public:
+    explicit SensorModel(uint32_t deviceId);
+
+    // simMs: milisegundos simulados desde el arranque (millis())
+    void fill(TelemetryRecord& rec, uint32_t simMs);
+
+  private:
+    uint32_t _rng;
+    float _tempOffset;
+    float _humOffset;
+    float _luxGain[3];
+    float _startHour;
+    float _cloud = 0.0f;      // 0 = despejado, 1 = muy nublado (paseo aleatorio)
+
+    float noise();            // uniforme en [-1, 1]
+};
+
+#endif
@@ -0,0 +1,377 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "loadgen_config.h"
+#include "UbidotsManager.h"
+#include "ThingsBoardManager.h"
+#include "TelemetryPipeline.h"
+#include "BrokerStandin.h"
+#include "SensorModel.h"
+
+// =====================================================
+// Generador de carga para la flota de Beans
+//  - Cada dispositivo simulado usa el código real del firmware:
+//    TelemetryPipeline + UbidotsManager / ThingsBoardManager + PubSubClient
+//  - Arduino_shim: millis()/delay() acelerados y WiFiClient sobre sockets de Linux
+//  - Sin --broker se levanta un broker local (BrokerStandin): funciona sin red
+//  - Reporta latencia de publish, backpressure del broker y throughput
+// =====================================================
+
+enum class Target : uint8_t { UBIDOTS, THINGSBOARD, MIXED };
+
+struct Options {
+  unsigned devices  = LG_DEFAULT_DEVICES;
+  unsigned threads  = LG_DEFAULT_THREADS;
+  double   speed    = LG_DEFAULT_SPEED;
+  unsigned runS     = LG_DEFAULT_RUN_S;
+  unsigned reportS  = LG_DEFAULT_REPORT_S;
+  Target   target   = Target::THINGSBOARD;
+
+  uint32_t sampleMs  = LG_SAMPLE_MS;
+  uint32_t publishMs = LG_PUBLISH_MS;
+  uint16_t tbBatch   = 1;
+  uint8_t  queueCap  = 1;           // igual que en main.cpp del firmware
+
+  std::string host;                 // vacío => broker local
+  uint16_t    port = LG_TB_PORT;
+  std::string tokenPrefix = "loadgen-";
+
+  uint32_t brokerKBps   = 0;
+  int      brokerRcvBuf = 0;
+  uint32_t writeTimeoutMs = LG_WRITE_TIMEOUT_MS;
+  bool     verbose = false;
+};
+
+static volatile sig_atomic_t g_stop = 0;
+static void onSignal(int) { g_stop = 1; }
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+    "Uso: %s [opciones]\n"
+    "  --devices N          dispositivos simulados (%u)\n"
+    "  --threads N          hilos de trabajo (%u)\n"
+    "  --target T           ubidots | thingsboard | mixed (thingsboard)\n"
+    "  --speed X            aceleración del reloj simulado (%.0f)\n"
+    "  --run S              duración real en segundos (%u)\n"
+    "  --report S           resumen cada S s reales (%u)\n"
+    "  --sample MS          período de muestreo simulado (%u)\n"
+    "  --interval MS        intervalo de publicación simulado (%u)\n"
+    "  --batch N            lote Gorilla de ThingsBoardManager (1)\n"
+    "  --queue N            capacidad de la cola del sink (1)\n"
+    "  --broker HOST:PORT   broker externo (p.ej. el stack de ThingsBoard/docker-compose.yml)\n"
+    "  --token-prefix P     token de acceso = P + id (loadgen-)\n"
+    "  --broker-kbps K      limita la lectura del broker local a K KB/s (0 = sin límite)\n"
+    "  --broker-rcvbuf B    SO_RCVBUF del broker local en bytes\n"
+    "  --write-timeout MS   timeout real de un write() bloqueado (%u)\n"
+    "  --verbose            muestra el Serial de los dispositivos\n",
+    argv0, (unsigned)LG_DEFAULT_DEVICES, (unsigned)LG_DEFAULT_THREADS, LG_DEFAULT_SPEED,
+    (unsigned)LG_DEFAULT_RUN_S, (unsigned)LG_DEFAULT_REPORT_S, (unsigned)LG_SAMPLE_MS,
+    (unsigned)LG_PUBLISH_MS, (unsigned)LG_WRITE_TIMEOUT_MS);
+}
+
+static bool parseArgs(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    const char* v = nullptr;
+
+    if (a == "--verbose") { o.verbose = true; continue; }
+    if (a == "-h" || a == "--help") return false;
+    if (i + 1 >= argc) { fprintf(stderr, "Falta valor para %s\n", a.c_str()); return false; }
+    v = argv[++i];
+
+    if      (a == "--devices")       o.devices = (unsigned)std::max(1, atoi(v));
+    else if (a == "--threads")       o.threads = (unsigned)std::max(1, atoi(v));
+    else if (a == "--speed")         o.speed = std::max(1.0, atof(v));
+    else if (a == "--run")           o.runS = (unsigned)atol(v);
+    else if (a == "--report")        o.reportS = (unsigned)std::max(1L, atol(v));
+    else if (a == "--sample")        o.sampleMs = (uint32_t)std::max(100L, atol(v));
+    else if (a == "--interval")      o.publishMs = (uint32_t)atol(v);
+    else if (a == "--batch")         o.tbBatch = (uint16_t)std::max(1, atoi(v));
+    else if (a == "--queue")         o.queueCap = (uint8_t)std::min(16, std::max(1, atoi(v)));
+    else if (a == "--token-prefix")  o.tokenPrefix = v;
+    else if (a == "--broker-kbps")   o.brokerKBps = (uint32_t)atol(v);
+    else if (a == "--broker-rcvbuf") o.brokerRcvBuf = atoi(v);
+    else if (a == "--write-timeout") o.writeTimeoutMs = (uint32_t)atol(v);
+    else if (a == "--broker") {
+      std::string s = v;
+      size_t c = s.rfind(':');
+      o.host = s.substr(0, c);
+      if (c != std::string::npos) o.port = (uint16_t)atoi(s.c_str() + c + 1);
+    }
+    else if (a == "--target") {
+      if      (!strcmp(v, "ubidots"))     o.target = Target::UBIDOTS;
+      else if (!strcmp(v, "thingsboard")) o.target = Target::THINGSBOARD;
+      else if (!strcmp(v, "mixed"))       o.target = Target::MIXED;
+      else { fprintf(stderr, "Target desconocido: %s\n", v); return false; }
+    }
+    else { fprintf(stderr, "Opción desconocida: %s\n", a.c_str()); return false; }
+  }
+  if (o.threads > o.devices) o.threads = o.devices;
+  return true;
+}
+
+static void raiseFdLimit() {
+  struct rlimit rl;
+  if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+  }
+}
+
+// ================== Métricas ==================
+
+// Muestras de una ventana de reporte (los hilos agregan, el principal vacía)
+struct Samples {
+  std::mutex m;
+  std::vector<uint32_t> callUs;   // duración real de consume() (incluye write() bloqueado)
+  std::vector<uint32_t> ageMs;    // ms simulados entre adquisición y entrega
+};
+
+static Samples g_window;
+static Samples g_total;
+static std::atomic<unsigned long> g_delivered{0};
+static std::atomic<unsigned long> g_failed{0};
+static std::atomic<unsigned long> g_dropped{0};
+static std::atomic<unsigned long> g_sampled{0};
+static std::atomic<unsigned> g_ready{0};
+
+static uint32_t percentile(std::vector<uint32_t>& v, double p) {
+  if (v.empty()) return 0;
+  size_t k = (size_t)(p * (v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + k, v.end());
+  return v[k];
+}
+
+/**
+ * Envuelve el sink real y mide cada entrega.
+ * ready() se delega tal cual para no alterar la lógica de intervalo del firmware.
+ */
+class ProbeSink : public TelemetrySink {
+  public:
+    explicit ProbeSink(TelemetrySink* inner) : _inner(inner) {}
+    const char* sinkName() const override { return _inner->sinkName(); }
+    bool ready() override { return _inner->ready(); }
+
+    bool consume(const TelemetryRecord& rec) override {
+      auto t0 = std::chrono::steady_clock::now();
+      bool ok = _inner->consume(rec);
+      uint32_t us = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - t0).count();
+      if (ok) {
+        callUs.push_back(us);
+        ageMs.push_back(millis() - rec.uptimeMs);
+      }
+      return ok;
+    }
+
+    std::vector<uint32_t> callUs;
+    std::vector<uint32_t> ageMs;
+
+  private:
+    TelemetrySink* _inner;
+};
+
+// ================== Dispositivo simulado ==================
+
+struct Device {
+  uint32_t    id;
+  std::string label;
+  std::string token;
+  SensorModel model;
+  TelemetryPipeline pipeline;
+  std::unique_ptr<UbidotsManager>     ubidots;
+  std::unique_ptr<ThingsBoardManager> thingsboard;
+  std::unique_ptr<ProbeSink>          probe;
+  uint32_t nextSample = 0;
+  uint32_t seq = 0;
+  SinkStats last;
+
+  explicit Device(uint32_t i) : id(i), model(i) {}
+};
+
+static void worker(const Options& o, unsigned first, unsigned count) {
+  std::vector<std::unique_ptr<Device>> fleet;
+  fleet.reserve(count);
+
+  for (unsigned i = 0; i < count; ++i) {
+    uint32_t id = first + i;
+    // La MAC (clientId de Ubidots y ThingsBoard) sale del id del dispositivo en construcción
+    WiFiShim::setDeviceId(id + 1);
+    std::unique_ptr<Device> d(new Device(id));
+    char buf[32];
+    snprintf(buf, sizeof(buf), "beans-%04u", (unsigned)id);
+    d->label = buf;
+    d->token = o.tokenPrefix + std::to_string(id);
+
+    bool useUbidots = (o.target == Target::UBIDOTS) || (o.target == Target::MIXED && (id & 1));
+    TelemetrySink* sink;
+    if (useUbidots) {
+      d->ubidots.reset(new UbidotsManager(d->token.c_str(), "", "", d->label.c_str(), o.publishMs));
+      d->ubidots->begin();   // bloquea hasta conectar, igual que en el ESP32
+      sink = d->ubidots.get();
+    } else {
+      const char* host = o.host.empty() ? "127.0.0.1" : o.host.c_str();
+      d->thingsboard.reset(new ThingsBoardManager(host, o.port, d->token.c_str(), o.publishMs));
+      d->thingsboard->setBatchSize(o.tbBatch);
+      d->thingsboard->begin();
+      sink = d->thingsboard.get();
+    }
+    d->probe.reset(new ProbeSink(sink));
+    d->pipeline.addSink(d->probe.get(), o.queueCap, DropPolicy::DROP_OLDEST);
+    d->nextSample = millis();
+    fleet.push_back(std::move(d));
+  }
+  g_ready += count;
+
+  uint32_t lastFlush = millis();
+  while (!g_stop) {
+    for (auto& d : fleet) {
+      uint32_t now = millis();
+      if ((int32_t)(now - d->nextSample) >= 0) {
+        TelemetryRecord rec{};
+        rec.seq = d->seq++;
+        d->model.fill(rec, now);
+        d->pipeline.publish(rec);
+        d->nextSample += o.sampleMs;
+        g_sampled++;
+      }
+      if (d->ubidots) d->ubidots->update();
+      else            d->thingsboard->update();
+      d->pipeline.service();
+    }
+
+    // Vuelca métricas cada ~100 ms reales
+    if (millis() - lastFlush >= (uint32_t)(100 * ArduinoShim::speed())) {
+      lastFlush = millis();
+      std::vector<uint32_t> call, age;
+      for (auto& d : fleet) {
+        const SinkStats* st = d->pipeline.stats(0);
+        g_delivered += st->delivered - d->last.delivered;
+        g_failed    += st->failed - d->last.failed;
+        g_dropped   += st->dropped - d->last.dropped;
+        d->last = *st;
+        call.insert(call.end(), d->probe->callUs.begin(), d->probe->callUs.end());
+        age.insert(age.end(), d->probe->ageMs.begin(), d->probe->ageMs.end());
+        d->probe->callUs.clear();
+        d->probe->ageMs.clear();
+      }
+      for (Samples* s : {&g_window, &g_total}) {
+        std::lock_guard<std::mutex> lk(s->m);
+        s->callUs.insert(s->callUs.end(), call.begin(), call.end());
+        s->ageMs.insert(s->ageMs.end(), age.begin(), age.end());
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+static void printLatency(const char* tag, Samples& s) {
+  std::vector<uint32_t> call, age;
+  {
+    std::lock_guard<std::mutex> lk(s.m);
+    call.swap(s.callUs);
+    age.swap(s.ageMs);
+  }
+  printf("%s n=%zu publish_us p50=%u p95=%u p99=%u max=%u | edad_ms p50=%u p99=%u\n",
+         tag, call.size(), percentile(call, 0.50), percentile(call, 0.95),
+         percentile(call, 0.99), percentile(call, 1.0),
+         percentile(age, 0.50), percentile(age, 0.99));
+}
+
+int main(int argc, char** argv) {
+  Options o;
+  if (!parseArgs(argc, argv, o)) { usage(argv[0]); return 2; }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+  raiseFdLimit();
+
+  ArduinoShim::setSpeed(o.speed);
+  ArduinoShim::setVerbose(o.verbose);
+  WiFiShim::setWriteTimeoutMs(o.writeTimeoutMs);
+
+  BrokerStandin broker;
+  if (o.host.empty()) {
+    uint16_t p = broker.start(0, o.brokerKBps, o.brokerRcvBuf);
+    if (!p) { fprintf(stderr, "No se pudo iniciar el broker local\n"); return 1; }
+    // Ubidots (industrial.api.ubidots.com) y ThingsBoard terminan en el broker local
+    WiFiShim::setBrokerOverride("127.0.0.1", p);
+    o.port = p;
+    printf("Broker local en 127.0.0.1:%u (limite %u KB/s)\n", (unsigned)p, (unsigned)o.brokerKBps);
+  } else if (o.target != Target::THINGSBOARD) {
+    // Ubidots apunta a su broker fijo: se redirige al externo indicado
+    WiFiShim::setBrokerOverride(o.host.c_str(), o.port);
+  }
+
+  printf("Dispositivos=%u hilos=%u speed=x%.0f muestreo=%u ms publish=%u ms lote=%u\n",
+         o.devices, o.threads, o.speed, (unsigned)o.sampleMs, (unsigned)o.publishMs,
+         (unsigned)o.tbBatch);
+
+  std::vector<std::thread> workers;
+  unsigned per = o.devices / o.threads, extra = o.devices % o.threads, first = 0;
+  for (unsigned t = 0; t < o.threads; ++t) {
+    unsigned n = per + (t < extra ? 1 : 0);
+    workers.emplace_back(worker, std::cref(o), first, n);
+    first += n;
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  auto lastReport = t0;
+  unsigned long lastDelivered = 0, lastBrokerPub = 0;
+  unsigned long long lastBrokerBytes = 0;
+
+  while (!g_stop) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - t0).count();
+    if (o.runS && elapsed >= o.runS) g_stop = 1;
+
+    double dt = std::chrono::duration<double>(now - lastReport).count();
+    if (dt < o.reportS && !g_stop) continue;
+    lastReport = now;
+
+    unsigned long delivered = g_delivered.load();
+    BrokerStats bs = broker.stats();
+    WiFiShim::NetStats ns = WiFiShim::stats();
+
+    printf("[%6.1fs] listos=%u/%u muestras=%lu entregados=%lu (%.1f/s) fallidos=%lu descartados=%lu\n",
+           elapsed, g_ready.load(), o.devices, g_sampled.load(), delivered,
+           (delivered - lastDelivered) / dt, g_failed.load(), g_dropped.load());
+    printf("          red: out=%.1f KB bloqueado=%.1f ms timeouts=%lu sin_ack=%.1f KB conexiones=%lu fallos_conexion=%lu\n",
+           ns.bytesOut / 1024.0, ns.writeBlockedUs / 1000.0, ns.writeTimeouts,
+           WiFiShim::unsentBytes() / 1024.0, ns.connects, ns.connectFails);
+    if (o.host.empty()) {
+      printf("          broker: sesiones=%lu abiertas=%lu publish=%lu (%.1f/s, %.1f KB/s) pings=%lu throttled=%lu ms\n",
+             bs.sessions, bs.openSockets, bs.publishes, (bs.publishes - lastBrokerPub) / dt,
+             (bs.bytesIn - lastBrokerBytes) / 1024.0 / dt, bs.pings, bs.throttledMs);
+    }
+    printLatency("          ventana", g_window);
+    fflush(stdout);
+
+    lastDelivered = delivered;
+    lastBrokerPub = bs.publishes;
+    lastBrokerBytes = bs.bytesIn;
+  }
+
+  for (auto& w : workers) w.join();
+
+  printf("=== Total ===\n");
+  printLatency("total", g_total);
+  broker.stop();
+  return 0;
+}
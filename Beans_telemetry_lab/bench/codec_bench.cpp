@@ -0,0 +1,406 @@
+// =====================================================
+// Benchmark / prueba en host de TelemetryMsgPack (claves enteras)
+//  - Vectores de referencia generados con python msgpack 1.1:
+//      packb({0: 1234, 1: "2026-10-19 08:40:32", 2: 21.5, ..., 10: 1792392032},
+//            use_single_float=True)
+//    encode() tiene que producir exactamente esos bytes, y decode() tiene
+//    que leer la variante float64 + id desconocido (11) que arma python por defecto
+//  - Ida y vuelta de registros pseudoaleatorios (NaN, epoch negativo, seq grande)
+//  - Registros concatenados: decode() avanza con "used" como al leer /datalog.msgpack
+//  - Tamaño frente a las claves string "0".."10" de antes, y ns por registro
+//  - Línea base JSON (sin ArduinoJson en host: snprintf/strtod con los
+//    mismos campos que TelemetryCodec::toDocument y floats de 7 cifras, o
+//    sea un piso para el JSON real):
+//      * lote de TB_BATCH_SIZE (12) muestras realistas (5 s, DHT 0.1, lux
+//        con ruido, como series_bench): bytes y ns de encode/decode
+//      * respuesta get_last de PH-O2 (mismos bytes que bench/uart_bench en
+//        PH-O2-v2_firmware): bytes y ns para recorrer todos sus valores
+//
+// Compilar (desde Beans_telemetry_lab):
+//   g++ -std=c++11 -O2 -Wall -Wextra -Ilib/Telemetry_pipeline -Ilib/Telemetry_codec bench/codec_bench.cpp lib/Telemetry_codec/TelemetryMsgPack.cpp -o /tmp/codec_bench
+//   /tmp/codec_bench [archivo]   (con archivo: escribe 3 registros concatenados)
+//   python3 -c "import msgpack,sys; print(list(msgpack.Unpacker(open(sys.argv[1],'rb'), strict_map_key=False)))" archivo
+// =====================================================
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "TelemetryMsgPack.h"
+#include "TelemetrySchema.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const uint8_t GOLDEN_F32[] = {
+  0x8B, 0x00, 0xCD, 0x04, 0xD2, 0x01, 0xB3, 0x32, 0x30, 0x32, 0x36, 0x2D, 0x31, 0x30, 0x2D, 0x31,
+  0x39, 0x20, 0x30, 0x38, 0x3A, 0x34, 0x30, 0x3A, 0x33, 0x32, 0x02, 0xCA, 0x41, 0xAC, 0x00, 0x00,
+  0x03, 0xCA, 0x42, 0x7D, 0x00, 0x00, 0x04, 0xCA, 0x41, 0xC6, 0x00, 0x00, 0x05, 0xCA, 0x42, 0x5E,
+  0x00, 0x00, 0x06, 0xCA, 0x44, 0xBE, 0x00, 0x00, 0x07, 0xCA, 0x44, 0xBB, 0x44, 0x00, 0x08, 0xCA,
+  0x44, 0xC9, 0x70, 0x00, 0x09, 0xC2, 0x0A, 0xCE, 0x6A, 0xD5, 0xBB, 0x60
+};
+
+// Igual pero floats en float64, sensorsError = true, epoch = -5 y un id 11 = "extra"
+static const uint8_t GOLDEN_F64_EXTRA[] = {
+  0x8C, 0x00, 0xCD, 0x04, 0xD2, 0x01, 0xB3, 0x32, 0x30, 0x32, 0x36, 0x2D, 0x31, 0x30, 0x2D, 0x31,
+  0x39, 0x20, 0x30, 0x38, 0x3A, 0x34, 0x30, 0x3A, 0x33, 0x32, 0x02, 0xCB, 0x40, 0x35, 0x80, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x03, 0xCB, 0x40, 0x4F, 0xA0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xCB,
+  0x40, 0x38, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xCB, 0x40, 0x4B, 0xC0, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x06, 0xCB, 0x40, 0x97, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xCB, 0x40, 0x97,
+  0x68, 0x80, 0x00, 0x00, 0x00, 0x00, 0x08, 0xCB, 0x40, 0x99, 0x2E, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x09, 0xC3, 0x0A, 0xFB, 0x0B, 0xA5, 0x65, 0x78, 0x74, 0x72, 0x61
+};
+
+static TelemetryRecord sampleRecord() {
+  TelemetryRecord r{};
+  r.seq = 1234;
+  strcpy(r.timestamp, "2026-10-19 08:40:32");
+  r.temperatureIndoor = 21.5f;   r.humidityIndoor = 63.25f;
+  r.temperatureOutdoor = 24.75f; r.humidityOutdoor = 55.5f;
+  r.lux1 = 1520.0f; r.lux2 = 1498.125f; r.lux3 = 1611.5f;
+  r.sensorsError = false;
+  r.epoch = 1792392032;
+  return r;
+}
+
+static bool sameFloat(float a, float b) {
+  return (isnan(a) && isnan(b)) || memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static bool sameRecord(const TelemetryRecord& a, const TelemetryRecord& b) {
+  return a.seq == b.seq && strcmp(a.timestamp, b.timestamp) == 0 && a.epoch == b.epoch &&
+         a.sensorsError == b.sensorsError &&
+         sameFloat(a.temperatureIndoor, b.temperatureIndoor) && sameFloat(a.humidityIndoor, b.humidityIndoor) &&
+         sameFloat(a.temperatureOutdoor, b.temperatureOutdoor) && sameFloat(a.humidityOutdoor, b.humidityOutdoor) &&
+         sameFloat(a.lux1, b.lux1) && sameFloat(a.lux2, b.lux2) && sameFloat(a.lux3, b.lux3);
+}
+
+// xorshift32: reproducible sin <random>
+static uint32_t rng = 0x12345678;
+static uint32_t next() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+static TelemetryRecord randomRecord() {
+  TelemetryRecord r{};
+  r.seq = next() >> (next() % 32);
+  snprintf(r.timestamp, sizeof(r.timestamp), "2026-%02u-%02u %02u:%02u:%02u",
+           1 + next() % 12, 1 + next() % 28, next() % 24, next() % 60, next() % 60);
+  float* f[] = { &r.temperatureIndoor, &r.humidityIndoor, &r.temperatureOutdoor,
+                 &r.humidityOutdoor, &r.lux1, &r.lux2, &r.lux3 };
+  for (float* p : f) *p = (next() % 10 == 0) ? NAN : (float)((int32_t)next()) / 65536.0f;
+  r.sensorsError = next() & 1;
+  r.epoch = ((int64_t)(int32_t)next() << (next() % 32));
+  return r;
+}
+
+// ---------- Línea base JSON ----------
+
+// Float de 7 cifras (%g quita los ceros: "21.5"); 8 o 9 solo si no vuelve
+// al mismo valor
+static int jsonFloat(char* out, size_t cap, float v) {
+  if (isnan(v) || isinf(v)) return snprintf(out, cap, "null");
+  int n = 0;
+  for (int prec = 7; prec <= 9; ++prec) {
+    n = snprintf(out, cap, "%.*g", prec, v);
+    if (strtof(out, nullptr) == v) break;
+  }
+  return n;
+}
+
+// Objeto plano de toDocument(): timestamp + 7 floats con nombre largo
+static size_t jsonEncode(const TelemetryRecord& r, char* out, size_t cap) {
+  static const TelemetryKey KEYS[] = { TK_TEMP_IN, TK_HUM_IN, TK_TEMP_OUT, TK_HUM_OUT, TK_LUX1, TK_LUX2, TK_LUX3 };
+  const float vals[] = { r.temperatureIndoor, r.humidityIndoor, r.temperatureOutdoor, r.humidityOutdoor,
+                         r.lux1, r.lux2, r.lux3 };
+  int n = snprintf(out, cap, "{\"%s\":\"%s\"", telemetryKeyName(TK_TIMESTAMP), r.timestamp);
+  for (size_t i = 0; i < 7 && n > 0 && (size_t)n < cap; ++i) {
+    n += snprintf(out + n, cap - n, ",\"%s\":", telemetryKeyName(KEYS[i]));
+    if ((size_t)n < cap) n += jsonFloat(out + n, cap - n, vals[i]);
+  }
+  if (n > 0 && (size_t)n + 1 < cap) { out[n++] = '}'; out[n] = '\0'; return n; }
+  return 0;
+}
+
+// Lector del objeto plano (strings sin escapes, números, null), como
+// TelemetryCodec::decode: busca cada clave por nombre
+static bool jsonDecode(const char* p, TelemetryRecord& r) {
+  memset(&r, 0, sizeof(r));
+  float* f[TK_COUNT] = {};
+  f[TK_TEMP_IN] = &r.temperatureIndoor;   f[TK_HUM_IN] = &r.humidityIndoor;
+  f[TK_TEMP_OUT] = &r.temperatureOutdoor; f[TK_HUM_OUT] = &r.humidityOutdoor;
+  f[TK_LUX1] = &r.lux1; f[TK_LUX2] = &r.lux2; f[TK_LUX3] = &r.lux3;
+  if (*p++ != '{') return false;
+  while (*p == '"') {
+    const char* k = ++p;
+    while (*p && *p != '"') ++p;
+    const size_t kl = p - k;
+    if (*p++ != '"' || *p++ != ':') return false;
+    int id = -1;
+    for (int i = 0; i < TK_COUNT; ++i)
+      if (strlen(TELEMETRY_KEY_NAME[i]) == kl && !memcmp(TELEMETRY_KEY_NAME[i], k, kl)) { id = i; break; }
+    if (*p == '"') {
+      const char* v = ++p;
+      while (*p && *p != '"') ++p;
+      if (*p != '"') return false;
+      if (id == TK_TIMESTAMP) {
+        const size_t n = (size_t)(p - v) < sizeof(r.timestamp) ? p - v : sizeof(r.timestamp) - 1;
+        memcpy(r.timestamp, v, n);
+      }
+      ++p;
+    } else if (!strncmp(p, "null", 4)) {
+      if (id >= 0 && f[id]) *f[id] = NAN;
+      p += 4;
+    } else {
+      char* e;
+      const double v = strtod(p, &e);
+      if (e == p) return false;
+      if (id >= 0 && f[id]) *f[id] = (float)v;
+      p = e;
+    }
+    if (*p == ',') ++p;
+  }
+  return *p == '}';
+}
+
+// Mismos campos que toDocument (seq, epoch y sensorsError no viajan en JSON)
+static bool sameJsonFields(const TelemetryRecord& a, const TelemetryRecord& b) {
+  TelemetryRecord x = a;
+  x.seq = b.seq; x.epoch = b.epoch; x.sensorsError = b.sensorsError; x.uptimeMs = b.uptimeMs;
+  return sameRecord(x, b);
+}
+
+// Serie de series_bench: 5 s, DHT con resolución 0.1, lux con ruido
+static uint32_t unitRng = 0x9E3779B9;
+static float unit() {
+  unitRng ^= unitRng << 13; unitRng ^= unitRng >> 17; unitRng ^= unitRng << 5;
+  return (unitRng & 0xFFFFFF) / 16777216.0f;
+}
+static TelemetryRecord realistic(uint32_t i) {
+  static float tin = 22.0f, hin = 60.0f, tout = 24.0f, hout = 55.0f;
+  TelemetryRecord r{};
+  r.seq = i;
+  r.epoch = 1792392032 + 5 * i;
+  const time_t t = (time_t)r.epoch;
+  struct tm tmv;
+  gmtime_r(&t, &tmv);
+  strftime(r.timestamp, sizeof(r.timestamp), "%Y-%m-%d %H:%M:%S", &tmv);
+  tin  = roundf((tin  + (unit() - 0.5f) * 0.1f) * 10) / 10;
+  hin  = roundf((hin  + (unit() - 0.5f) * 0.3f) * 10) / 10;
+  tout = roundf((tout + (unit() - 0.5f) * 0.1f) * 10) / 10;
+  hout = roundf((hout + (unit() - 0.5f) * 0.3f) * 10) / 10;
+  r.temperatureIndoor = tin;  r.humidityIndoor = hin;
+  r.temperatureOutdoor = tout; r.humidityOutdoor = hout;
+  r.lux1 = 1500.0f + unit() * 20.0f;
+  r.lux2 = 1480.0f + unit() * 20.0f;
+  r.lux3 = 1600.0f + unit() * 20.0f;
+  return r;
+}
+
+// ---------- get_last de PH-O2 ----------
+
+static const char GET_LAST_JSON[] =
+  "{\"ok\":true,\"data\":{\"ph\":7.01,\"tempC\":24.5,\"level_sensors\":{\"h2o\":false,\"kcl\":false},"
+  "\"samples\":[{\"id\":1,\"ph_val\":6.9,\"o2_val\":null},{\"id\":2,\"ph_val\":null,\"o2_val\":null},"
+  "{\"id\":3,\"ph_val\":null,\"o2_val\":null},{\"id\":4,\"ph_val\":null,\"o2_val\":null}],"
+  "\"result\":\"CAL_PH_2PT_OK\"}}";
+
+// Claves enteras de UartKey (uart_schema.h en PH-O2)
+static const uint8_t GET_LAST_MP[] = {
+  0x82, 0x00, 0xC3, 0x02, 0x85, 0x0C, 0xCA, 0x40, 0xE0, 0x51, 0xEC, 0x0D, 0xCA, 0x41, 0xC4, 0x00,
+  0x00, 0x03, 0x82, 0x04, 0xC2, 0x05, 0xC2, 0x08, 0x94, 0x83, 0x09, 0x01, 0x0A, 0xCA, 0x40, 0xDC,
+  0xCC, 0xCD, 0x0B, 0xC0, 0x83, 0x09, 0x02, 0x0A, 0xC0, 0x0B, 0xC0, 0x83, 0x09, 0x03, 0x0A, 0xC0,
+  0x0B, 0xC0, 0x83, 0x09, 0x04, 0x0A, 0xC0, 0x0B, 0xC0, 0x0E, 0xAD, 0x43, 0x41, 0x4C, 0x5F, 0x50,
+  0x48, 0x5F, 0x32, 0x50, 0x54, 0x5F, 0x4F, 0x4B
+};
+
+// Recorrido completo de una respuesta: cuenta hojas y suma los números
+// (el trabajo mínimo de cualquier decodificador en el maestro)
+struct Leaves { int n; double sum; };
+
+static const char* jsonWalk(const char* p, Leaves& lv) {
+  if (*p == '{' || *p == '[') {
+    const char close = (*p == '{') ? '}' : ']';
+    ++p;
+    while (*p && *p != close) {
+      if (close == '}') {
+        p = strchr(p + 1, '"');
+        if (!p || *++p != ':') return nullptr;
+        ++p;
+      }
+      p = jsonWalk(p, lv);
+      if (!p) return nullptr;
+      if (*p == ',') ++p;
+    }
+    return *p ? p + 1 : nullptr;
+  }
+  lv.n++;
+  if (*p == '"') { p = strchr(p + 1, '"'); return p ? p + 1 : nullptr; }
+  if (!strncmp(p, "true", 4)) { lv.sum += 1; return p + 4; }
+  if (!strncmp(p, "false", 5)) return p + 5;
+  if (!strncmp(p, "null", 4)) return p + 4;
+  char* e;
+  lv.sum += (float)strtod(p, &e);
+  return e == p ? nullptr : e;
+}
+
+static const uint8_t* mpWalk(const uint8_t* p, const uint8_t* end, Leaves& lv, bool isKey = false) {
+  if (p >= end) return nullptr;
+  const uint8_t b = *p++;
+  size_t items = 0, skip = 0;
+  if (b <= 0x7F)                   { if (!isKey) { lv.n++; lv.sum += b; } return p; }
+  else if ((b & 0xF0) == 0x80)     items = 2 * (b & 0x0F);
+  else if ((b & 0xF0) == 0x90)     items = b & 0x0F;
+  else if ((b & 0xE0) == 0xA0)     { lv.n++; skip = b & 0x1F; }
+  else if (b == 0xC0)              { lv.n++; return p; }
+  else if (b == 0xC2 || b == 0xC3) { lv.n++; lv.sum += (b == 0xC3); return p; }
+  else if (b == 0xCA) {
+    if (end - p < 4) return nullptr;
+    const uint32_t u = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    lv.n++;
+    lv.sum += f;
+    return p + 4;
+  } else return nullptr;   // get_last no usa otros tipos
+  if (skip) return (size_t)(end - p) >= skip ? p + skip : nullptr;
+  for (size_t i = 0; i < items && p; ++i) p = mpWalk(p, end, lv, (b & 0xF0) == 0x80 && i % 2 == 0);
+  return p;
+}
+
+template <class F> static double nsPer(int iters, F f) {
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iters; ++i) f(i);
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / iters;
+}
+
+int main(int argc, char** argv) {
+  uint8_t buf[TelemetryMsgPack::MAX_BYTES];
+  TelemetryRecord out;
+
+  // ---- Vector de referencia (encode) ----
+  const TelemetryRecord ref = sampleRecord();
+  size_t n = TelemetryMsgPack::encode(ref, buf, sizeof(buf));
+  CHECK(n == sizeof(GOLDEN_F32) && memcmp(buf, GOLDEN_F32, n) == 0,
+        "encode no coincide con python msgpack (%zu bytes)", n);
+
+  // ---- Vector de referencia (decode, float64 + id desconocido) ----
+  size_t used = 0;
+  CHECK(TelemetryMsgPack::decode(GOLDEN_F64_EXTRA, sizeof(GOLDEN_F64_EXTRA), out, &used), "decode f64");
+  TelemetryRecord want = ref;
+  want.sensorsError = true;
+  want.epoch = -5;
+  CHECK(sameRecord(out, want), "decode f64: campos distintos");
+  CHECK(used == sizeof(GOLDEN_F64_EXTRA), "decode f64: used=%zu", used);
+
+  // ---- Truncado / basura ----
+  for (size_t cut = 0; cut < sizeof(GOLDEN_F32); ++cut)
+    CHECK(!TelemetryMsgPack::decode(GOLDEN_F32, cut, out), "decode aceptó %zu bytes truncados", cut);
+  CHECK(TelemetryMsgPack::encode(ref, buf, sizeof(GOLDEN_F32) - 1) == 0, "encode sin espacio");
+
+  // ---- Ida y vuelta ----
+  size_t maxBytes = 0;
+  for (int i = 0; i < 100000; ++i) {
+    TelemetryRecord r = randomRecord();
+    size_t k = TelemetryMsgPack::encode(r, buf, sizeof(buf));
+    if (k > maxBytes) maxBytes = k;
+    if (!(k > 0 && TelemetryMsgPack::decode(buf, k, out) && sameRecord(r, out))) {
+      CHECK(false, "ida y vuelta falla en iteración %d (seq=%u)", i, (unsigned)r.seq);
+      break;
+    }
+  }
+
+  // ---- Registros concatenados ----
+  uint8_t file[3 * TelemetryMsgPack::MAX_BYTES];
+  size_t fileLen = 0;
+  TelemetryRecord recs[3] = { sampleRecord(), randomRecord(), randomRecord() };
+  for (const TelemetryRecord& r : recs)
+    fileLen += TelemetryMsgPack::encode(r, file + fileLen, sizeof(file) - fileLen);
+  size_t off = 0;
+  for (int i = 0; i < 3; ++i) {
+    CHECK(TelemetryMsgPack::decode(file + off, fileLen - off, out, &used) && sameRecord(out, recs[i]),
+          "registro concatenado %d", i);
+    off += used;
+  }
+  CHECK(off == fileLen, "quedaron %zu bytes sin leer", fileLen - off);
+  if (argc > 1) {
+    FILE* f = fopen(argv[1], "wb");
+    if (f) { fwrite(file, 1, fileLen, f); fclose(f); printf("%zu bytes en %s\n", fileLen, argv[1]); }
+  }
+
+  // ---- Tamaño frente a claves string "0".."10" (fixstr: 1 + dígitos) ----
+  size_t strKeyExtra = 0;
+  for (uint8_t k = 0; k < TK_COUNT; ++k) strKeyExtra += (k < 10) ? 1 : 2;
+  printf("registro: %zu bytes (claves string: %zu, -%.0f%%), máximo observado %zu <= %zu\n",
+         sizeof(GOLDEN_F32), sizeof(GOLDEN_F32) + strKeyExtra,
+         100.0 * strKeyExtra / (sizeof(GOLDEN_F32) + strKeyExtra), maxBytes, TelemetryMsgPack::MAX_BYTES);
+  CHECK(maxBytes <= TelemetryMsgPack::MAX_BYTES, "MAX_BYTES corto");
+
+  // ---- Tiempo ----
+  const int ITER = 2000000;
+  volatile size_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITER; ++i) {
+    TelemetryRecord r = ref;
+    r.seq = (uint32_t)i;
+    sink = sink + TelemetryMsgPack::encode(r, buf, sizeof(buf));
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITER; ++i) sink = sink + TelemetryMsgPack::decode(GOLDEN_F32, sizeof(GOLDEN_F32), out);
+  auto t2 = std::chrono::steady_clock::now();
+  printf("encode %.1f ns/registro, decode %.1f ns/registro (host)\n",
+         std::chrono::duration<double, std::nano>(t1 - t0).count() / ITER,
+         std::chrono::duration<double, std::nano>(t2 - t1).count() / ITER);
+
+  // ---- JSON frente a MessagePack: lote de TB_BATCH_SIZE muestras ----
+  const int BATCH = 12;
+  TelemetryRecord batch[BATCH];
+  for (int i = 0; i < BATCH; ++i) batch[i] = realistic(i);
+  char js[BATCH][256];
+  uint8_t mp[BATCH][TelemetryMsgPack::MAX_BYTES];
+  size_t jsBytes = 0, mpBytes = 0, jsLen[BATCH], mpLen[BATCH];
+  for (int i = 0; i < BATCH; ++i) {
+    jsBytes += jsLen[i] = jsonEncode(batch[i], js[i], sizeof(js[i]));
+    mpBytes += mpLen[i] = TelemetryMsgPack::encode(batch[i], mp[i], sizeof(mp[i]));
+    CHECK(jsLen[i] > 0 && jsonDecode(js[i], out) && sameJsonFields(out, batch[i]), "JSON ida y vuelta %d", i);
+    CHECK(mpLen[i] > 0 && TelemetryMsgPack::decode(mp[i], mpLen[i], out) && sameRecord(out, batch[i]),
+          "MessagePack ida y vuelta %d", i);
+  }
+  const int BATCH_ITER = 20000;
+  char jsTmp[256];
+  const double jsEnc = nsPer(BATCH_ITER, [&](int k) { sink = sink + jsonEncode(batch[k % BATCH], jsTmp, sizeof(jsTmp)); });
+  const double jsDec = nsPer(BATCH_ITER, [&](int k) { sink = sink + jsonDecode(js[k % BATCH], out); });
+  const double mpEnc = nsPer(BATCH_ITER, [&](int k) { sink = sink + TelemetryMsgPack::encode(batch[k % BATCH], buf, sizeof(buf)); });
+  const double mpDec = nsPer(BATCH_ITER, [&](int k) {
+    sink = sink + TelemetryMsgPack::decode(mp[k % BATCH], mpLen[k % BATCH], out);
+  });
+  printf("lote de %d: JSON %zu B (%.1f/registro, 8 campos), MessagePack %zu B (%.1f/registro, 11 campos, -%.0f%%)\n",
+         BATCH, jsBytes, (double)jsBytes / BATCH, mpBytes, (double)mpBytes / BATCH,
+         100.0 * (1.0 - (double)mpBytes / jsBytes));
+  printf("  ns/registro: JSON encode %.0f decode %.0f, MessagePack encode %.0f decode %.0f (host)\n",
+         jsEnc, jsDec, mpEnc, mpDec);
+  CHECK(mpBytes < jsBytes, "MessagePack no es más chico que JSON");
+
+  // ---- JSON frente a MessagePack: get_last de PH-O2 ----
+  Leaves lj = {0, 0}, lm = {0, 0};
+  const char* je = jsonWalk(GET_LAST_JSON, lj);
+  const uint8_t* me = mpWalk(GET_LAST_MP, GET_LAST_MP + sizeof(GET_LAST_MP), lm);
+  CHECK(je && !*je && me == GET_LAST_MP + sizeof(GET_LAST_MP), "get_last: recorrido incompleto");
+  CHECK(lj.n == 18 && lm.n == lj.n && lm.sum == lj.sum, "get_last: JSON %d hojas (%.3f), MessagePack %d (%.3f)",
+        lj.n, lj.sum, lm.n, lm.sum);
+  const int GL_ITER = 200000;
+  const double glJs = nsPer(GL_ITER, [&](int) { Leaves l = {0, 0}; sink = sink + (size_t)(jsonWalk(GET_LAST_JSON, l) != nullptr) + l.n; });
+  const double glMp = nsPer(GL_ITER, [&](int) {
+    Leaves l = {0, 0};
+    sink = sink + (size_t)(mpWalk(GET_LAST_MP, GET_LAST_MP + sizeof(GET_LAST_MP), l) != nullptr) + l.n;
+  });
+  printf("get_last: JSON %zu B, MessagePack %zu B (-%.0f%%); recorrido JSON %.0f ns, MessagePack %.0f ns (host)\n",
+         sizeof(GET_LAST_JSON) - 1, sizeof(GET_LAST_MP), 100.0 * (1.0 - (double)sizeof(GET_LAST_MP) / (sizeof(GET_LAST_JSON) - 1)),
+         glJs, glMp);
+
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+// =====================================================
+// Benchmark / prueba en host del TelemetryPipeline
+//  - Repite en tiempo simulado el reparto de setupPipeline(): una muestra
+//    cada 5 s, Ubidots/ThingsBoard cada 60 s, Telnet y LCD siempre listos,
+//    SD con 16 de cola
+//  - Carga normal: ningún sink puede reportar "drop"; lo que Ubidots no
+//    publica se cuenta como "repl" (KEEP_LATEST)
+//  - Sobrecarga: la SD se traba 200 s; sólo ahí aparecen drops, y son
+//    exactamente las muestras que no caben en su cola
+//  - Mide ns por publish() + service() con los 5 sinks
+//
+// Compilar (desde Beans_telemetry_lab):
+//   g++ -std=c++11 -O2 -Wall -Wextra -Ilib/Telemetry_pipeline bench/pipeline_bench.cpp lib/Telemetry_pipeline/TelemetryPipeline.cpp -o /tmp/pipeline_bench
+//   /tmp/pipeline_bench
+// =====================================================
+
+#include <chrono>
+#include <stdio.h>
+#include "TelemetryPipeline.h"
+
+static uint32_t nowMs = 0;
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+// Publica cada intervalo (modelo de Ubidots/ThingsBoard)
+class IntervalSink : public TelemetrySink {
+  public:
+    IntervalSink(const char* name, uint32_t intervalMs) : _name(name), _interval(intervalMs) {}
+    const char* sinkName() const override { return _name; }
+    bool ready() override { return nowMs - _last >= _interval; }
+    bool consume(const TelemetryRecord& rec) override {
+      _last = nowMs;
+      lastSeq = rec.seq;
+      return true;
+    }
+    uint32_t lastSeq = 0;
+  private:
+    const char* _name;
+    uint32_t _interval;
+    uint32_t _last = 0;
+};
+
+// Siempre lista (Telnet, LCD) o trabada a voluntad (SD)
+class PlainSink : public TelemetrySink {
+  public:
+    explicit PlainSink(const char* name) : _name(name) {}
+    const char* sinkName() const override { return _name; }
+    bool ready() override { return !stalled; }
+    bool consume(const TelemetryRecord& rec) override {
+      if (got > 0 && rec.seq != lastSeq + 1) gaps++;
+      lastSeq = rec.seq;
+      got++;
+      return true;
+    }
+    bool stalled = false;
+    uint32_t got = 0, gaps = 0, lastSeq = 0;
+  private:
+    const char* _name;
+};
+
+struct Run {
+  IntervalSink ubidots{"ubidots", 60000};
+  IntervalSink thingsboard{"thingsboard", 60000};
+  PlainSink telnet{"telnet"};
+  PlainSink lcd{"lcd"};
+  PlainSink sd{"sd"};
+  TelemetryPipeline pipe;
+
+  Run() {
+    pipe.addSink(&ubidots, 1, DropPolicy::KEEP_LATEST);
+    pipe.addSink(&thingsboard, 1, DropPolicy::KEEP_LATEST);
+    pipe.addSink(&telnet, 4, DropPolicy::DROP_OLDEST);
+    pipe.addSink(&lcd, 1, DropPolicy::KEEP_LATEST);
+    pipe.addSink(&sd, 16, DropPolicy::DROP_NEWEST);
+  }
+
+  // samples muestras cada 5 s; loop() cada 10 ms. La SD se traba en [stallFrom, stallTo)
+  void simulate(uint32_t samples, uint32_t stallFrom = 0, uint32_t stallTo = 0) {
+    nowMs = 0;
+    uint32_t seq = 0, nextSample = 5000;
+    while (seq < samples) {
+      nowMs += 10;
+      sd.stalled = (nowMs >= stallFrom && nowMs < stallTo);
+      if (nowMs >= nextSample) {
+        TelemetryRecord rec{};
+        rec.seq = ++seq;
+        rec.uptimeMs = nowMs;
+        pipe.publish(rec);
+        nextSample += 5000;
+      }
+      pipe.service();
+    }
+    // Drena lo pendiente (1 min más de loop sin muestras nuevas)
+    for (uint32_t t = 0; t < 60000; t += 10) { nowMs += 10; sd.stalled = false; pipe.service(); }
+  }
+
+  void print(const char* title) const {
+    printf("%s\n  %-11s %6s %6s %6s %6s %5s\n", title, "sink", "ok", "drop", "repl", "fail", "max");
+    for (uint8_t i = 0; i < pipe.sinkCount(); ++i) {
+      const SinkStats* st = pipe.stats(i);
+      printf("  %-11s %6lu %6lu %6lu %6lu %5u\n", pipe.sinkName(i),
+             (unsigned long)st->delivered, (unsigned long)st->dropped,
+             (unsigned long)st->superseded, (unsigned long)st->failed, st->maxDepth);
+    }
+  }
+};
+
+int main() {
+  const uint32_t N = 1200;   // 100 min a 5 s
+
+  {
+    Run r;
+    r.simulate(N);
+    r.print("Carga normal (1200 muestras, 100 min):");
+    for (uint8_t i = 0; i < r.pipe.sinkCount(); ++i) {
+      const SinkStats* st = r.pipe.stats(i);
+      CHECK(st->dropped == 0, "%s: drop=%lu sin sobrecarga", r.pipe.sinkName(i), (unsigned long)st->dropped);
+      CHECK(st->delivered + st->superseded == N, "%s: ok+repl=%lu != %lu", r.pipe.sinkName(i),
+            (unsigned long)(st->delivered + st->superseded), (unsigned long)N);
+    }
+    CHECK(r.ubidots.lastSeq == N, "ubidots publicó seq %lu, no la última", (unsigned long)r.ubidots.lastSeq);
+    CHECK(r.sd.got == N && r.sd.gaps == 0, "sd: %lu muestras, %lu huecos", (unsigned long)r.sd.got, (unsigned long)r.sd.gaps);
+    CHECK(r.telnet.got == N && r.telnet.gaps == 0, "telnet: %lu muestras", (unsigned long)r.telnet.got);
+  }
+
+  {
+    // SD trabada ~200 s (40 muestras), caben 16 => 24 descartadas (las nuevas)
+    Run r;
+    r.simulate(N, 300000, 497500);
+    r.print("SD trabada 200 s:");
+    const SinkStats* sd = r.pipe.stats(4);
+    CHECK(sd->dropped == 24, "sd: drop=%lu (esperado 24)", (unsigned long)sd->dropped);
+    CHECK(sd->maxDepth == 16, "sd: max=%u", sd->maxDepth);
+    CHECK(sd->delivered == N - 24, "sd: ok=%lu", (unsigned long)sd->delivered);
+    CHECK(r.sd.gaps == 1, "sd: %lu huecos (esperado 1 tramo perdido)", (unsigned long)r.sd.gaps);
+    for (uint8_t i = 0; i < 4; ++i)
+      CHECK(r.pipe.stats(i)->dropped == 0, "%s: drop por culpa de la SD", r.pipe.sinkName(i));
+  }
+
+  {
+    // Costo por muestra: publish() + service() con los 5 sinks listos
+    Run r;
+    nowMs = 0;
+    const uint32_t ITER = 2000000;
+    TelemetryRecord rec{};
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ITER; ++i) {
+      nowMs += 60000;   // todos listos en cada vuelta
+      rec.seq = i + 1;
+      r.pipe.publish(rec);
+      r.pipe.service();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / ITER;
+    printf("publish+service, 5 sinks: %.1f ns/muestra (host)\n", ns);
+  }
+
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,205 @@
+// =====================================================
+// Prueba de propiedades + benchmark en host de SeriesCodec / SeriesBatch
+//  - Propiedad: para cualquier serie (timestamps irregulares, saltos grandes,
+//    NaN, ±inf, -0, canales constantes, ruido aleatorio) decode(encode(x))
+//    devuelve x bit a bit, y append() que no cabe deja el bloque intacto
+//  - base64: ida y vuelta de largos 0..600
+//  - Benchmark: bytes/muestra y ns/muestra con una serie SINTÉTICA (5 s, DHT +
+//    lux con ruido) para los lotes que usa el firmware: TB_BATCH_SIZE y
+//    SD_SERIES_BLOCK de src/main.cpp. No hay datalogs grabados en el repo:
+//    la compresión con datos reales de campo no está medida
+//
+// Compilar (desde Beans_telemetry_lab):
+//   g++ -std=c++11 -O2 -Wall -Wextra -Ilib/Telemetry_pipeline -Ilib/Telemetry_series bench/series_bench.cpp lib/Telemetry_series/SeriesCodec.cpp lib/Telemetry_series/SeriesBatch.cpp -o /tmp/series_bench
+//   /tmp/series_bench [casos]
+// =====================================================
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SeriesBatch.h"
+#include "SeriesCodec.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static uint32_t rng = 0x9E3779B9;
+static uint32_t next() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+static float unit() { return (next() & 0xFFFFFF) / 16777216.0f; }
+
+static float bitsToFloat(uint32_t b) { float f; memcpy(&f, &b, sizeof(f)); return f; }
+static uint32_t floatBits(float f) { uint32_t b; memcpy(&b, &f, sizeof(b)); return b; }
+
+// Valor de un canal según su "personalidad" (elegida por caso)
+static float channelValue(uint8_t kind, float prev, uint32_t i) {
+  switch (kind) {
+    case 0:  return 21.5f;                                        // constante
+    case 1:  return prev + (unit() - 0.5f) * 0.2f;                // deriva suave
+    case 2:  return bitsToFloat(next());                          // bits aleatorios (NaN incluidos)
+    case 3:  {                                                    // especiales
+      static const float s[] = { NAN, INFINITY, -INFINITY, -0.0f, 0.0f, 1e-45f, 3.4e38f };
+      return s[next() % 7];
+    }
+    case 4:  return (i % 7 == 0) ? NAN : 1000.0f + unit() * 5.0f; // lux con huecos
+    default: return (float)(next() % 4);                          // pocos valores distintos
+  }
+}
+
+// Un caso: channels, n muestras, timestamps con jitter / saltos; ida y vuelta exacta
+static bool propertyCase(uint32_t caseNo) {
+  uint8_t buf[2048];
+  const uint8_t channels = 1 + next() % SeriesEncoder::MAX_CHANNELS;
+  const uint16_t n = 1 + next() % 300;
+  uint8_t kind[SeriesEncoder::MAX_CHANNELS];
+  for (uint8_t c = 0; c < channels; ++c) kind[c] = next() % 6;
+
+  static uint32_t ts[300];
+  static float vals[300][SeriesEncoder::MAX_CHANNELS];
+
+  SeriesEncoder enc;
+  if (!enc.begin(buf, sizeof(buf), channels)) return false;
+
+  uint32_t t = next();
+  float prev[SeriesEncoder::MAX_CHANNELS];
+  for (uint8_t c = 0; c < channels; ++c) prev[c] = unit() * 100.0f;
+
+  uint16_t stored = 0;
+  for (uint16_t i = 0; i < n; ++i) {
+    switch (next() % 8) {
+      case 0:  t += next(); break;                   // salto arbitrario (incluye wrap)
+      case 1:  t += 0; break;                        // repetido
+      default: t += 5000 + (next() % 41) - 20; break; // 5 s con jitter
+    }
+    float v[SeriesEncoder::MAX_CHANNELS];
+    for (uint8_t c = 0; c < channels; ++c) prev[c] = v[c] = channelValue(kind[c], prev[c], i);
+
+    const size_t before = enc.bytes();
+    const uint16_t countBefore = enc.count();
+    if (!enc.append(t, v)) {
+      // Atómico: el bloque no cambió y sigue decodificando lo guardado
+      if (enc.count() != countBefore || enc.bytes() != before) {
+        printf("  caso %u: append fallido modificó el bloque\n", (unsigned)caseNo);
+        return false;
+      }
+      break;
+    }
+    ts[stored] = t;
+    memcpy(vals[stored], v, sizeof(v));
+    stored++;
+  }
+
+  SeriesDecoder dec;
+  if (!dec.begin(enc.data(), enc.bytes()) || dec.count() != stored || dec.channels() != channels) {
+    printf("  caso %u: cabecera (count %u/%u)\n", (unsigned)caseNo, dec.count(), stored);
+    return false;
+  }
+  for (uint16_t i = 0; i < stored; ++i) {
+    uint32_t gt;
+    float gv[SeriesEncoder::MAX_CHANNELS];
+    if (!dec.next(gt, gv) || gt != ts[i]) {
+      printf("  caso %u: muestra %u timestamp %u != %u\n", (unsigned)caseNo, i, (unsigned)gt, (unsigned)ts[i]);
+      return false;
+    }
+    for (uint8_t c = 0; c < channels; ++c)
+      if (floatBits(gv[c]) != floatBits(vals[i][c])) {
+        printf("  caso %u: muestra %u canal %u 0x%08x != 0x%08x\n", (unsigned)caseNo, i, c,
+               (unsigned)floatBits(gv[c]), (unsigned)floatBits(vals[i][c]));
+        return false;
+      }
+  }
+  uint32_t gt;
+  float gv[SeriesEncoder::MAX_CHANNELS];
+  if (dec.next(gt, gv)) { printf("  caso %u: muestra de más\n", (unsigned)caseNo); return false; }
+
+  // Truncar el bloque nunca debe leer fuera ni devolver muestras de más
+  SeriesDecoder cut;
+  const size_t cutLen = enc.bytes() / 2;
+  if (cut.begin(enc.data(), cutLen)) {
+    uint16_t k = 0;
+    while (cut.next(gt, gv) && k <= stored) k++;
+    if (k > stored) { printf("  caso %u: truncado devolvió %u muestras\n", (unsigned)caseNo, k); return false; }
+  }
+  return true;
+}
+
+static TelemetryRecord synthetic(uint32_t i) {
+  static float tin = 22.0f, hin = 60.0f, tout = 24.0f, hout = 55.0f;
+  TelemetryRecord r{};
+  r.seq = i;
+  r.uptimeMs = 5000 * i + (next() % 11);   // loop() agrega algunos ms de jitter
+  r.epoch = 1792392032 + 5 * i;
+  // DHT: resolución 0.1, cambia poco
+  tin  = roundf((tin  + (unit() - 0.5f) * 0.1f) * 10) / 10;
+  hin  = roundf((hin  + (unit() - 0.5f) * 0.3f) * 10) / 10;
+  tout = roundf((tout + (unit() - 0.5f) * 0.1f) * 10) / 10;
+  hout = roundf((hout + (unit() - 0.5f) * 0.3f) * 10) / 10;
+  r.temperatureIndoor = tin;  r.humidityIndoor = hin;
+  r.temperatureOutdoor = tout; r.humidityOutdoor = hout;
+  // Lux: ruido de sensor en todos los bits
+  r.lux1 = 1500.0f + unit() * 20.0f;
+  r.lux2 = 1480.0f + unit() * 20.0f;
+  r.lux3 = 1600.0f + unit() * 20.0f;
+  return r;
+}
+
+static void benchBatch(const char* name, uint16_t perBlock) {
+  static TelemetryRecord input[20000];
+  static TelemetryRecord out[SeriesBatch::BUF_BYTES];
+  const uint32_t N = sizeof(input) / sizeof(input[0]);
+  for (uint32_t i = 0; i < N; ++i) input[i] = synthetic(i);
+
+  SeriesBatch batch(perBlock);
+  size_t bytes = 0;
+  uint32_t blocks = 0, i = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  while (i < N) {
+    batch.reset();
+    while (i < N && batch.add(input[i])) i++;   // hasta llenarse por cantidad o por bytes
+    bytes += batch.size();
+    blocks++;
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  uint16_t got = SeriesBatch::decode(batch.data(), batch.size(), out, SeriesBatch::BUF_BYTES);
+  CHECK(got == batch.count(), "%s: decode %u de %u", name, got, batch.count());
+
+  // Registro crudo: uptimeMs + 7 floats
+  const double raw = 4.0 + 7 * 4.0;
+  const double per = (double)bytes / N;
+  const double avgBlock = (double)bytes / blocks;
+  printf("  %-12s lote %3u: %5.1f muestras/bloque, %5.1f B/muestra (crudo %.0f, x%.1f), bloque %.0f B (base64 %.0f), %.0f ns/muestra\n",
+         name, perBlock, (double)N / blocks, per, raw, raw / per, avgBlock, ceil(avgBlock / 3) * 4,
+         std::chrono::duration<double, std::nano>(t1 - t0).count() / N);
+}
+
+int main(int argc, char** argv) {
+  const uint32_t cases = (argc > 1) ? (uint32_t)atoi(argv[1]) : 20000;
+
+  uint32_t ok = 0;
+  for (uint32_t i = 0; i < cases; ++i) {
+    if (propertyCase(i)) ok++;
+    else { failures++; if (failures > 5) break; }
+  }
+  printf("ida y vuelta: %u/%u casos exactos\n", (unsigned)ok, (unsigned)cases);
+
+  // base64
+  uint8_t in[600], back[600];
+  char txt[((sizeof(in) + 2) / 3) * 4 + 1];
+  for (size_t len = 0; len <= sizeof(in); ++len) {
+    for (size_t i = 0; i < len; ++i) in[i] = (uint8_t)next();
+    size_t n = base64Encode(in, len, txt, sizeof(txt));
+    size_t m = base64Decode(txt, n, back, sizeof(back));
+    if (len > 0) CHECK(n == ((len + 2) / 3) * 4 && m == len && memcmp(in, back, len) == 0, "base64 len %zu", len);
+  }
+
+  printf("serie sintética (5 s, DHT 0.1, lux con ruido):\n");
+  benchBatch("ThingsBoard", 12);   // TB_BATCH_SIZE
+  benchBatch("SD", 30);            // SD_SERIES_BLOCK
+
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
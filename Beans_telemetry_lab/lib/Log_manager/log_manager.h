@@ -0,0 +1,90 @@
+#ifndef LOG_MANAGER_H
+#define LOG_MANAGER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =====================================================
+// Logs con nivel mínimo en compilación y nivel por módulo en ejecución
+//  - LOG_E/W/I/D(módulo, fmt, ...) con formato printf
+//  - Nivel por encima de LOG_LVL_MAX (-D en build_flags): la sentencia no
+//    genera código y sus argumentos no se evalúan
+//  - Nivel del módulo en ejecución: se compara antes de evaluar los
+//    argumentos; un log apagado cuesta una lectura y una comparación
+//  - La línea se arma en la pila (LOG_LINE_MAX) y va al sink; sin String
+//  - Sin dependencias de Arduino (se prueba en host)
+// =====================================================
+
+#define LOG_LVL_NONE   0
+#define LOG_LVL_ERROR  1
+#define LOG_LVL_WARN   2
+#define LOG_LVL_INFO   3
+#define LOG_LVL_DEBUG  4
+
+#ifndef LOG_LVL_MAX
+#define LOG_LVL_MAX LOG_LVL_INFO
+#endif
+
+#define LOG_LINE_MAX 160
+
+// Módulos del firmware (nombre en minúsculas para logParseModule)
+enum class LogMod : uint8_t {
+  SYS,    // arranque, watchdog
+  SENS,   // lux y DHT
+  DATA,   // muestras en telnet y estadísticas del pipeline
+  NET,    // Ubidots, ThingsBoard, NTP
+  SD,     // registro en la tarjeta
+  COUNT
+};
+
+typedef void (*LogSink)(const char* line);
+
+extern uint8_t logLevels[(size_t)LogMod::COUNT];
+
+void        logSetSink(LogSink sink);          // nullptr = descartar
+void        logSetLevel(LogMod mod, uint8_t lvl);
+void        logSetAll(uint8_t lvl);
+uint8_t     logLevel(LogMod mod);
+const char* logModName(LogMod mod);
+const char* logLevelName(uint8_t lvl);
+bool        logParseModule(const char* name, LogMod& mod);
+bool        logParseLevel(const char* name, uint8_t& lvl);
+
+void logWrite(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// Compilado y habilitado en el módulo: para bloques que preparan datos
+#define LOG_ON(lvl, mod) \
+  ((lvl) <= LOG_LVL_MAX && (lvl) <= logLevels[(size_t)(mod)])
+
+#define LOG_AT_(lvl, mod, ...) \
+  do { if (LOG_ON(lvl, mod)) logWrite(__VA_ARGS__); } while (0)
+
+// if (0): el formato se sigue verificando, pero no queda nada en flash
+#define LOG_OFF_(...) \
+  do { if (0) logWrite(__VA_ARGS__); } while (0)
+
+#if LOG_LVL_MAX >= LOG_LVL_ERROR
+#define LOG_E(mod, ...) LOG_AT_(LOG_LVL_ERROR, mod, __VA_ARGS__)
+#else
+#define LOG_E(mod, ...) LOG_OFF_(__VA_ARGS__)
+#endif
+
+#if LOG_LVL_MAX >= LOG_LVL_WARN
+#define LOG_W(mod, ...) LOG_AT_(LOG_LVL_WARN, mod, __VA_ARGS__)
+#else
+#define LOG_W(mod, ...) LOG_OFF_(__VA_ARGS__)
+#endif
+
+#if LOG_LVL_MAX >= LOG_LVL_INFO
+#define LOG_I(mod, ...) LOG_AT_(LOG_LVL_INFO, mod, __VA_ARGS__)
+#else
+#define LOG_I(mod, ...) LOG_OFF_(__VA_ARGS__)
+#endif
+
+#if LOG_LVL_MAX >= LOG_LVL_DEBUG
+#define LOG_D(mod, ...) LOG_AT_(LOG_LVL_DEBUG, mod, __VA_ARGS__)
+#else
+#define LOG_D(mod, ...) LOG_OFF_(__VA_ARGS__)
+#endif
+
+#endif // LOG_MANAGER_H
@@ -1,4 +1,5 @@
 #include "SDLogger.h"
+#include "log_manager.h"
 
 // Definición de pines SPI para la SD
 #define SD_MISO 2
@@ -12,11 +13,11 @@ bool SDLogger::begin() {
     spi.begin(SD_SCLK, SD_MISO, SD_MOSI, SD_CS);
 
     if (!checkSD()) {
-        Serial.println("⚠️ Fallo al montar SD en primer intento, reintentando...");
+        LOG_W(LogMod::SD, "⚠️ Fallo al montar SD en primer intento, reintentando...");
         delay(1000);
         if (!checkSD()) {
-            Serial.println("❌ Error crítico: no se pudo montar la SD.");
-            ESP.restart();
+            // Sin SD el equipo sigue publicando; el pipeline no registra este sink
+            LOG_E(LogMod::SD, "❌ No se pudo montar la SD: registro local deshabilitado.");
             return false;
         }
     }
@@ -29,7 +30,8 @@ bool SDLogger::begin() {
         }
     }
 
-    Serial.println("✅ SD montada correctamente");
+    _mounted = true;
+    LOG_I(LogMod::SD, "✅ SD montada correctamente");
     return true;
 }
 
@@ -37,28 +39,78 @@ bool SDLogger::checkSD() {
     return SD.begin(SD_CS, spi);
 }
 
-void SDLogger::logSensorData(const String& dateTime) {
-    JsonDocument entry;
+bool SDLogger::logRecord(const TelemetryRecord& rec) {
+    if (_seriesRecords > 0) {
+        if (!_series.add(rec)) {
+            // Lote lleno por bytes: se vacía y se reintenta con uno nuevo
+            if (!flushSeries() || !_series.add(rec)) return false;
+        }
+        if (_series.full()) flushSeries();   // si falla, queda pendiente para el próximo
+        return true;
+    }
+
+    if (_encoding == PayloadEncoding::MSGPACK) {
+        uint8_t buf[TelemetryMsgPack::MAX_BYTES];
+        size_t n = TelemetryCodec::encode(rec, PayloadEncoding::MSGPACK, buf, sizeof(buf));
+        if (n == 0) {
+            LOG_E(LogMod::SD, "❌ Registro no cabe en buffer MessagePack.");
+            return false;
+        }
+        return appendBinary(buf, n);
+    }
 
-    entry["timestamp"] = dateTime;
-    entry["temperatureIndoor"]  = sensorData.getTemperatureIndoor();
-    entry["humidityIndoor"]     = sensorData.getHumidityIndoor();
-    entry["temperatureOutdoor"] = sensorData.getTemperatureOutdoor();
-    entry["humidityOutdoor"]    = sensorData.getHumidityOutdoor();
-    entry["lux1"] = sensorData.getLux1();
-    entry["lux2"] = sensorData.getLux2();
-    entry["lux3"] = sensorData.getLux3();
+    JsonDocument entry;
+    TelemetryCodec::toDocument(rec, entry);
 
     String output;
     serializeJson(entry, output);
-    writeToFile(output);
+    return writeToFile(output);
+}
+
+void SDLogger::setSeriesBatching(uint16_t recordsPerBlock) {
+    if (_seriesRecords > 0 && recordsPerBlock != _seriesRecords) flushSeries();
+    _seriesRecords = recordsPerBlock;
+    if (recordsPerBlock > 0) _series.setMaxRecords(recordsPerBlock);
 }
 
-void SDLogger::writeToFile(const String& jsonData) {
+bool SDLogger::flushSeries() {
+    if (_series.empty()) return true;
+
+    uint8_t head[10];
+    uint16_t len = (uint16_t)_series.size();
+    int64_t epoch = _series.firstEpoch();
+    head[0] = (uint8_t)(len & 0xFF);
+    head[1] = (uint8_t)(len >> 8);
+    for (uint8_t i = 0; i < 8; ++i) head[2 + i] = (uint8_t)((uint64_t)epoch >> (8 * i));
+
+    File file = SD.open(seriesFilename, FILE_APPEND);
+    if (!file) {
+        LOG_E(LogMod::SD, "❌ No se pudo abrir datalog.gor.");
+        return false;
+    }
+    bool ok = (file.write(head, sizeof(head)) == sizeof(head)) &&
+              (file.write(_series.data(), len) == len);
+    file.close();
+    if (ok) _series.reset();
+    return ok;
+}
+
+bool SDLogger::appendBinary(const uint8_t* data, size_t len) {
+    File file = SD.open(binFilename, FILE_APPEND);
+    if (!file) {
+        LOG_E(LogMod::SD, "❌ No se pudo abrir datalog.msgpack.");
+        return false;
+    }
+    size_t written = file.write(data, len);
+    file.close();
+    return written == len;
+}
+
+bool SDLogger::writeToFile(const String& jsonData) {
     File file = SD.open(filename, FILE_READ);
     if (!file) {
-        Serial.println("❌ No se pudo abrir el archivo para lectura.");
-        return;
+        LOG_E(LogMod::SD, "❌ No se pudo abrir el archivo para lectura.");
+        return false;
     }
 
     String content = file.readString();
@@ -69,7 +121,7 @@ void SDLogger::writeToFile(const String& jsonData) {
 
     JsonArray array;
     if (error || !doc.is<JsonArray>()) {
-        Serial.println("⚠️ JSON corrupto o vacío. Se crea nuevo arreglo.");
+        LOG_W(LogMod::SD, "⚠️ JSON corrupto o vacío. Se crea nuevo arreglo.");
         doc.clear();
         array = doc.to<JsonArray>();
     } else {
@@ -83,12 +135,13 @@ void SDLogger::writeToFile(const String& jsonData) {
 
     File writeFile = SD.open(filename, FILE_WRITE);
     if (!writeFile) {
-        Serial.println("❌ No se pudo abrir archivo para escritura.");
-        return;
+        LOG_E(LogMod::SD, "❌ No se pudo abrir archivo para escritura.");
+        return false;
     }
 
     writeFile.seek(0);  // sobrescribe
     serializeJson(doc, writeFile);
     writeFile.close();
-    Serial.println("📁 Registro añadido a datalog.json");
+    LOG_D(LogMod::SD, "📁 Registro añadido a datalog.json");
+    return true;
 }
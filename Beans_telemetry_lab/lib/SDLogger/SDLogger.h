@@ -6,18 +6,42 @@
 #include <SD.h>
 #include <SPI.h>
 #include <ArduinoJson.h>
-#include "SensorData.h"
+#include "TelemetryPipeline.h"
+#include "TelemetryCodec.h"
+#include "SeriesBatch.h"
 
-class SDLogger {
+class SDLogger : public TelemetrySink {
 public:
     SDLogger();
     bool begin();
-    void logSensorData(const String& dateTime);
+    bool logRecord(const TelemetryRecord& rec);
+
+    // JSON: arreglo en /datalog.json (formato histórico)
+    // MSGPACK: objetos concatenados en /datalog.msgpack (solo append, sin releer el archivo)
+    void setEncoding(PayloadEncoding enc) { _encoding = enc; }
+    PayloadEncoding encoding() const { return _encoding; }
+
+    // Lotes comprimidos (delta/XOR) en /datalog.gor; 0 = desactivado.
+    // Tiene prioridad sobre setEncoding(). Cada bloque: [len u16][epoch0 i64][bloque]
+    void setSeriesBatching(uint16_t recordsPerBlock);
+    bool flushSeries();   // escribe el lote pendiente (p.ej. antes de reiniciar)
+
+    // TelemetrySink
+    const char* sinkName() const override { return "sd"; }
+    bool ready() override { return _mounted; }
+    bool consume(const TelemetryRecord& rec) override { return logRecord(rec); }
 
 private:
     bool checkSD();
-    void writeToFile(const String& jsonData);
+    bool writeToFile(const String& jsonData);
+    bool appendBinary(const uint8_t* data, size_t len);
+    bool _mounted = false;
+    PayloadEncoding _encoding = PayloadEncoding::JSON;
     const char* filename = "/datalog.json";
+    const char* binFilename = "/datalog.msgpack";
+    const char* seriesFilename = "/datalog.gor";
+    uint16_t _seriesRecords = 0;
+    SeriesBatch _series;
     SPIClass spi;
 };
 
@@ -0,0 +1,48 @@
+#include "TelemetryCodec.h"
+#include <string.h>
+#include <math.h>
+
+namespace TelemetryCodec {
+
+void toDocument(const TelemetryRecord& rec, JsonDocument& doc) {
+  doc.clear();
+  doc[telemetryKeyName(TK_TIMESTAMP)] = rec.timestamp;
+  doc[telemetryKeyName(TK_TEMP_IN)]   = rec.temperatureIndoor;
+  doc[telemetryKeyName(TK_HUM_IN)]    = rec.humidityIndoor;
+  doc[telemetryKeyName(TK_TEMP_OUT)]  = rec.temperatureOutdoor;
+  doc[telemetryKeyName(TK_HUM_OUT)]   = rec.humidityOutdoor;
+  doc[telemetryKeyName(TK_LUX1)]      = rec.lux1;
+  doc[telemetryKeyName(TK_LUX2)]      = rec.lux2;
+  doc[telemetryKeyName(TK_LUX3)]      = rec.lux3;
+}
+
+size_t encode(const TelemetryRecord& rec, PayloadEncoding enc, uint8_t* out, size_t cap) {
+  if (enc == PayloadEncoding::MSGPACK) return TelemetryMsgPack::encode(rec, out, cap);
+
+  JsonDocument doc;
+  toDocument(rec, doc);
+  // serializeJson agrega '\0' => un byte extra
+  if (measureJson(doc) + 1 > cap) return 0;
+  return serializeJson(doc, (char*)out, cap);
+}
+
+bool decode(const uint8_t* in, size_t len, PayloadEncoding enc, TelemetryRecord& rec) {
+  if (enc == PayloadEncoding::MSGPACK) return TelemetryMsgPack::decode(in, len, rec);
+
+  JsonDocument doc;
+  if (deserializeJson(doc, (const char*)in, len) || !doc.is<JsonObject>()) return false;
+
+  memset(&rec, 0, sizeof(rec));
+  const char* ts = doc[telemetryKeyName(TK_TIMESTAMP)] | "";
+  strncpy(rec.timestamp, ts, sizeof(rec.timestamp) - 1);
+  rec.temperatureIndoor  = doc[telemetryKeyName(TK_TEMP_IN)]  | NAN;
+  rec.humidityIndoor     = doc[telemetryKeyName(TK_HUM_IN)]   | NAN;
+  rec.temperatureOutdoor = doc[telemetryKeyName(TK_TEMP_OUT)] | NAN;
+  rec.humidityOutdoor    = doc[telemetryKeyName(TK_HUM_OUT)]  | NAN;
+  rec.lux1 = doc[telemetryKeyName(TK_LUX1)] | NAN;
+  rec.lux2 = doc[telemetryKeyName(TK_LUX2)] | NAN;
+  rec.lux3 = doc[telemetryKeyName(TK_LUX3)] | NAN;
+  return true;
+}
+
+}
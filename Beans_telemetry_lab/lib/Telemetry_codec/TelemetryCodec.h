@@ -0,0 +1,25 @@
+#ifndef TELEMETRYCODEC_H
+#define TELEMETRYCODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ArduinoJson.h>
+#include "TelemetryRecord.h"
+#include "TelemetrySchema.h"
+#include "TelemetryMsgPack.h"
+
+/**
+ * Codificación de TelemetryRecord en JSON (claves largas) o MessagePack (ids enteros).
+ * - JSON vía ArduinoJson; MessagePack vía TelemetryMsgPack (ArduinoJson no
+ *   serializa claves enteras). Compila igual en ESP32 y en host.
+ * - encode() retorna bytes escritos (0 si no cabe).
+ */
+namespace TelemetryCodec {
+
+  void   toDocument(const TelemetryRecord& rec, JsonDocument& doc);   // JSON (claves largas)
+  size_t encode(const TelemetryRecord& rec, PayloadEncoding enc, uint8_t* out, size_t cap);
+  bool   decode(const uint8_t* in, size_t len, PayloadEncoding enc, TelemetryRecord& rec);
+
+}
+
+#endif
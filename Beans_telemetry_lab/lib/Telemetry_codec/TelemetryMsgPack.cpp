@@ -0,0 +1,218 @@
+#include "TelemetryMsgPack.h"
+#include "TelemetrySchema.h"
+#include <string.h>
+#include <math.h>
+
+namespace TelemetryMsgPack {
+
+namespace {
+
+// ---------- Escritura ----------
+struct Writer {
+  uint8_t* p;
+  size_t   cap;
+  size_t   n = 0;
+  bool     ok = true;
+
+  Writer(uint8_t* out, size_t c) : p(out), cap(c) {}
+
+  void byte(uint8_t b) { if (n < cap) p[n++] = b; else ok = false; }
+  void be(uint64_t v, uint8_t bytes) { for (int i = bytes - 1; i >= 0; --i) byte((uint8_t)(v >> (8 * i))); }
+
+  void key(TelemetryKey k) { byte((uint8_t)k); }   // positive fixint (ids < 128)
+
+  void uint(uint64_t v) {
+    if (v < 0x80)             byte((uint8_t)v);
+    else if (v <= 0xFF)       { byte(0xCC); be(v, 1); }
+    else if (v <= 0xFFFF)     { byte(0xCD); be(v, 2); }
+    else if (v <= 0xFFFFFFFF) { byte(0xCE); be(v, 4); }
+    else                      { byte(0xCF); be(v, 8); }
+  }
+
+  void sint(int64_t v) {
+    if (v >= 0)            uint((uint64_t)v);
+    else if (v >= -32)     byte((uint8_t)v);                       // negative fixint
+    else if (v >= INT8_MIN)  { byte(0xD0); be((uint64_t)v, 1); }
+    else if (v >= INT16_MIN) { byte(0xD1); be((uint64_t)v, 2); }
+    else if (v >= INT32_MIN) { byte(0xD2); be((uint64_t)v, 4); }
+    else                     { byte(0xD3); be((uint64_t)v, 8); }
+  }
+
+  void f32(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    byte(0xCA);
+    be(bits, 4);
+  }
+
+  void str(const char* s, size_t maxLen) {
+    size_t len = strnlen(s, maxLen);
+    if (len < 32) byte((uint8_t)(0xA0 | len));
+    else          { byte(0xD9); byte((uint8_t)len); }
+    for (size_t i = 0; i < len; ++i) byte((uint8_t)s[i]);
+  }
+};
+
+// ---------- Lectura ----------
+enum class Kind : uint8_t { NIL, BOOL, UINT, SINT, FLOAT, STR };
+
+struct Value {
+  Kind        kind = Kind::NIL;
+  bool        b = false;
+  uint64_t    u = 0;
+  int64_t     i = 0;
+  double      f = 0;
+  const char* s = nullptr;
+  size_t      slen = 0;
+
+  double asDouble() const {
+    switch (kind) {
+      case Kind::FLOAT: return f;
+      case Kind::UINT:  return (double)u;
+      case Kind::SINT:  return (double)i;
+      default:          return NAN;
+    }
+  }
+  int64_t asInt() const {
+    switch (kind) {
+      case Kind::UINT:  return (int64_t)u;
+      case Kind::SINT:  return i;
+      case Kind::FLOAT: return (int64_t)f;
+      case Kind::BOOL:  return b ? 1 : 0;
+      default:          return 0;
+    }
+  }
+};
+
+struct Reader {
+  const uint8_t* p;
+  size_t         len;
+  size_t         n = 0;
+
+  Reader(const uint8_t* in, size_t l) : p(in), len(l) {}
+
+  bool be(uint8_t bytes, uint64_t& v) {
+    if (len - n < bytes) return false;
+    v = 0;
+    for (uint8_t i = 0; i < bytes; ++i) v = (v << 8) | p[n++];
+    return true;
+  }
+
+  bool value(Value& v) {
+    if (n >= len) return false;
+    const uint8_t t = p[n++];
+    uint64_t raw = 0;
+
+    if (t < 0x80)  { v.kind = Kind::UINT; v.u = t; return true; }
+    if (t >= 0xE0) { v.kind = Kind::SINT; v.i = (int8_t)t; return true; }
+    if ((t & 0xE0) == 0xA0) return strBody(v, t & 0x1F);
+
+    switch (t) {
+      case 0xC0: v.kind = Kind::NIL; return true;
+      case 0xC2: v.kind = Kind::BOOL; v.b = false; return true;
+      case 0xC3: v.kind = Kind::BOOL; v.b = true;  return true;
+      case 0xCC: case 0xCD: case 0xCE: case 0xCF:
+        if (!be((uint8_t)(1u << (t - 0xCC)), raw)) return false;
+        v.kind = Kind::UINT; v.u = raw; return true;
+      case 0xD0: if (!be(1, raw)) return false; v.kind = Kind::SINT; v.i = (int8_t)raw;  return true;
+      case 0xD1: if (!be(2, raw)) return false; v.kind = Kind::SINT; v.i = (int16_t)raw; return true;
+      case 0xD2: if (!be(4, raw)) return false; v.kind = Kind::SINT; v.i = (int32_t)raw; return true;
+      case 0xD3: if (!be(8, raw)) return false; v.kind = Kind::SINT; v.i = (int64_t)raw; return true;
+      case 0xCA: {
+        if (!be(4, raw)) return false;
+        uint32_t bits = (uint32_t)raw;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        v.kind = Kind::FLOAT; v.f = f; return true;
+      }
+      case 0xCB: {
+        if (!be(8, raw)) return false;
+        double d;
+        memcpy(&d, &raw, sizeof(d));
+        v.kind = Kind::FLOAT; v.f = d; return true;
+      }
+      case 0xD9: if (!be(1, raw)) return false; return strBody(v, (size_t)raw);
+      case 0xDA: if (!be(2, raw)) return false; return strBody(v, (size_t)raw);
+      default:   return false;   // bin/ext/arreglos/mapas anidados: no son de este esquema
+    }
+  }
+
+  bool strBody(Value& v, size_t k) {
+    if (len - n < k) return false;
+    v.kind = Kind::STR;
+    v.s    = (const char*)p + n;
+    v.slen = k;
+    n += k;
+    return true;
+  }
+};
+
+} // namespace
+
+size_t encode(const TelemetryRecord& rec, uint8_t* out, size_t cap) {
+  Writer w(out, cap);
+  w.byte((uint8_t)(0x80 | TK_COUNT));   // fixmap (TK_COUNT < 16)
+
+  w.key(TK_SEQ);         w.uint(rec.seq);
+  w.key(TK_TIMESTAMP);   w.str(rec.timestamp, sizeof(rec.timestamp));
+  w.key(TK_TEMP_IN);     w.f32(rec.temperatureIndoor);
+  w.key(TK_HUM_IN);      w.f32(rec.humidityIndoor);
+  w.key(TK_TEMP_OUT);    w.f32(rec.temperatureOutdoor);
+  w.key(TK_HUM_OUT);     w.f32(rec.humidityOutdoor);
+  w.key(TK_LUX1);        w.f32(rec.lux1);
+  w.key(TK_LUX2);        w.f32(rec.lux2);
+  w.key(TK_LUX3);        w.f32(rec.lux3);
+  w.key(TK_SENSORS_ERR); w.byte(rec.sensorsError ? 0xC3 : 0xC2);
+  w.key(TK_EPOCH);       w.sint(rec.epoch);
+
+  return w.ok ? w.n : 0;
+}
+
+bool decode(const uint8_t* in, size_t len, TelemetryRecord& rec, size_t* used) {
+  Reader r(in, len);
+  if (len == 0) return false;
+
+  size_t entries;
+  uint64_t raw;
+  const uint8_t t = in[r.n++];
+  if ((t & 0xF0) == 0x80)      entries = t & 0x0F;
+  else if (t == 0xDE)          { if (!r.be(2, raw)) return false; entries = (size_t)raw; }
+  else return false;
+
+  memset(&rec, 0, sizeof(rec));
+  rec.temperatureIndoor = rec.humidityIndoor = NAN;
+  rec.temperatureOutdoor = rec.humidityOutdoor = NAN;
+  rec.lux1 = rec.lux2 = rec.lux3 = NAN;
+
+  for (size_t e = 0; e < entries; ++e) {
+    Value k, v;
+    if (!r.value(k) || !r.value(v)) return false;
+    if (k.kind != Kind::UINT) continue;   // clave no entera: no es de este esquema
+
+    switch (k.u) {
+      case TK_SEQ:         rec.seq = (uint32_t)v.asInt(); break;
+      case TK_TIMESTAMP:
+        if (v.kind == Kind::STR) {
+          size_t n = v.slen < sizeof(rec.timestamp) - 1 ? v.slen : sizeof(rec.timestamp) - 1;
+          memcpy(rec.timestamp, v.s, n);
+          rec.timestamp[n] = '\0';
+        }
+        break;
+      case TK_TEMP_IN:     rec.temperatureIndoor  = (float)v.asDouble(); break;
+      case TK_HUM_IN:      rec.humidityIndoor     = (float)v.asDouble(); break;
+      case TK_TEMP_OUT:    rec.temperatureOutdoor = (float)v.asDouble(); break;
+      case TK_HUM_OUT:     rec.humidityOutdoor    = (float)v.asDouble(); break;
+      case TK_LUX1:        rec.lux1 = (float)v.asDouble(); break;
+      case TK_LUX2:        rec.lux2 = (float)v.asDouble(); break;
+      case TK_LUX3:        rec.lux3 = (float)v.asDouble(); break;
+      case TK_SENSORS_ERR: rec.sensorsError = v.asInt() != 0; break;
+      case TK_EPOCH:       rec.epoch = v.asInt(); break;
+      default: break;      // id nuevo: se ignora
+    }
+  }
+
+  if (used) *used = r.n;
+  return true;
+}
+
+}
@@ -0,0 +1,31 @@
+#ifndef TELEMETRYMSGPACK_H
+#define TELEMETRYMSGPACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "TelemetryRecord.h"
+
+/**
+ * MessagePack de TelemetryRecord con claves enteras (id de TelemetryKey).
+ * - ArduinoJson sólo serializa claves string; acá cada clave es un fixint
+ *   positivo de 1 byte, como lo lee cualquier decodificador MessagePack.
+ * - Mapa de TK_COUNT entradas en orden de id. Floats en float32, enteros con
+ *   la codificación mínima, timestamp como str.
+ * - decode() acepta cualquier ancho de entero/float, ignora ids desconocidos
+ *   (esquema append-only) y reporta los bytes consumidos para recorrer un
+ *   archivo de registros concatenados.
+ * - Sin dependencias de Arduino ni memoria dinámica (compila en host).
+ */
+namespace TelemetryMsgPack {
+
+  static constexpr size_t MAX_BYTES = 96;   // cota del registro codificado
+
+  // Bytes escritos (0 si no cabe en cap)
+  size_t encode(const TelemetryRecord& rec, uint8_t* out, size_t cap);
+
+  // false si no es un mapa válido; used (opcional) = bytes del registro
+  bool   decode(const uint8_t* in, size_t len, TelemetryRecord& rec, size_t* used = nullptr);
+
+}
+
+#endif
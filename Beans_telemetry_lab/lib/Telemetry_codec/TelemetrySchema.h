@@ -0,0 +1,45 @@
+#ifndef TELEMETRYSCHEMA_H
+#define TELEMETRYSCHEMA_H
+
+#include <stdint.h>
+
+/**
+ * Esquema compartido de claves de telemetría.
+ * - JSON usa el nombre largo (compatible con datalog.json histórico).
+ * - MessagePack usa el id como clave entera (fixint: 1 byte por clave),
+ *   ver TelemetryMsgPack.
+ * - No reordenar: los ids ya escritos en SD/MQTT dependen de este orden.
+ */
+enum class PayloadEncoding : uint8_t {
+  JSON,
+  MSGPACK
+};
+
+enum TelemetryKey : uint8_t {
+  TK_SEQ = 0,
+  TK_TIMESTAMP,
+  TK_TEMP_IN,
+  TK_HUM_IN,
+  TK_TEMP_OUT,
+  TK_HUM_OUT,
+  TK_LUX1,
+  TK_LUX2,
+  TK_LUX3,
+  TK_SENSORS_ERR,
+  TK_EPOCH,
+  TK_COUNT
+};
+
+static const char* const TELEMETRY_KEY_NAME[TK_COUNT] = {
+  "seq", "timestamp",
+  "temperatureIndoor", "humidityIndoor",
+  "temperatureOutdoor", "humidityOutdoor",
+  "lux1", "lux2", "lux3",
+  "sensorsError", "epoch"
+};
+
+inline const char* telemetryKeyName(TelemetryKey k) {
+  return TELEMETRY_KEY_NAME[k];
+}
+
+#endif
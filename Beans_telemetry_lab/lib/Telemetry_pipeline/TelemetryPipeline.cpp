@@ -0,0 +1,88 @@
+#include "TelemetryPipeline.h"
+
+bool TelemetryPipeline::addSink(TelemetrySink* sink, uint8_t capacity, DropPolicy policy) {
+  if (!sink || _count >= MAX_SINKS) return false;
+  if (capacity == 0) capacity = 1;
+  if (capacity > QUEUE_MAX) capacity = QUEUE_MAX;
+
+  Slot& s = _slots[_count++];
+  s.sink     = sink;
+  s.policy   = policy;
+  s.capacity = capacity;
+  s.head     = 0;
+  s.size     = 0;
+  s.st       = SinkStats();
+  return true;
+}
+
+// Encola en un slot aplicando la política. Retorna false si hubo descarte.
+bool TelemetryPipeline::push(Slot& s, const TelemetryRecord& rec) {
+  if (s.size >= s.capacity) {
+    if (s.policy == DropPolicy::KEEP_LATEST) {
+      // Reemplaza la más nueva pendiente: es la política del sink, no pérdida
+      s.buf[(uint8_t)((s.head + s.size - 1) % s.capacity)] = rec;
+      s.st.superseded++;
+      s.st.enqueued++;
+      return true;
+    }
+    s.st.dropped++;
+    if (s.policy == DropPolicy::DROP_NEWEST) return false;
+    pop(s); // DROP_OLDEST: libera la más vieja y sigue
+  }
+  uint8_t tail = (uint8_t)((s.head + s.size) % s.capacity);
+  s.buf[tail] = rec;
+  s.size++;
+  s.st.enqueued++;
+  if (s.size > s.st.maxDepth) s.st.maxDepth = s.size;
+  return true;
+}
+
+void TelemetryPipeline::pop(Slot& s) {
+  if (s.size == 0) return;
+  s.head = (uint8_t)((s.head + 1) % s.capacity);
+  s.size--;
+}
+
+uint8_t TelemetryPipeline::publish(const TelemetryRecord& rec) {
+  uint8_t accepted = 0;
+  for (uint8_t i = 0; i < _count; ++i) {
+    uint32_t droppedBefore = _slots[i].st.dropped;
+    push(_slots[i], rec);
+    if (_slots[i].st.dropped == droppedBefore) accepted++;
+  }
+  return accepted;
+}
+
+uint16_t TelemetryPipeline::service(uint8_t maxPerSink) {
+  uint16_t total = 0;
+  for (uint8_t i = 0; i < _count; ++i) {
+    Slot& s = _slots[i];
+    for (uint8_t n = 0; n < maxPerSink && s.size > 0; ++n) {
+      if (!s.sink->ready()) break;
+      if (!s.sink->consume(s.buf[s.head])) {
+        s.st.failed++;
+        break; // se reintenta la misma muestra en el próximo service()
+      }
+      pop(s);
+      s.st.delivered++;
+      total++;
+    }
+  }
+  return total;
+}
+
+const char* TelemetryPipeline::sinkName(uint8_t i) const {
+  return (i < _count) ? _slots[i].sink->sinkName() : "";
+}
+
+const SinkStats* TelemetryPipeline::stats(uint8_t i) const {
+  return (i < _count) ? &_slots[i].st : nullptr;
+}
+
+uint8_t TelemetryPipeline::depth(uint8_t i) const {
+  return (i < _count) ? _slots[i].size : 0;
+}
+
+void TelemetryPipeline::resetStats() {
+  for (uint8_t i = 0; i < _count; ++i) _slots[i].st = SinkStats();
+}
@@ -0,0 +1,83 @@
+#ifndef TELEMETRYPIPELINE_H
+#define TELEMETRYPIPELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "TelemetryRecord.h"
+
+/**
+ * Destino de muestras (Ubidots, ThingsBoard, SD, Telnet, LCD...).
+ * - ready():   true si puede aceptar una muestra ahora (conectado, intervalo cumplido...)
+ * - consume(): entrega la muestra; false => se reintenta en el próximo service()
+ */
+class TelemetrySink {
+  public:
+    virtual ~TelemetrySink() {}
+    virtual const char* sinkName() const = 0;
+    virtual bool ready() { return true; }
+    virtual bool consume(const TelemetryRecord& rec) = 0;
+};
+
+// Qué hacer cuando la cola de un sink está llena
+enum class DropPolicy : uint8_t {
+  DROP_OLDEST,   // descarta la más vieja (se queda con lo más reciente)
+  DROP_NEWEST,   // descarta la que llega (conserva el histórico pendiente)
+  KEEP_LATEST    // sink que publica cada tanto y solo quiere la última muestra:
+                 // la que llega reemplaza a la pendiente (cuenta como superseded, no dropped)
+};
+
+struct SinkStats {
+  uint32_t enqueued  = 0;   // muestras aceptadas en cola
+  uint32_t delivered = 0;   // consume() == true
+  uint32_t dropped   = 0;   // perdidas por cola llena (sobrecarga real)
+  uint32_t superseded = 0;  // KEEP_LATEST: reemplazadas por una más nueva antes de salir
+  uint32_t failed    = 0;   // consume() == false (se reintenta)
+  uint8_t  maxDepth  = 0;   // ocupación máxima observada
+};
+
+/**
+ * Fan-out de muestras hacia sinks registrados.
+ * - Cada sink tiene su propia cola acotada y política de descarte:
+ *   un sink lento solo llena SU cola, nunca bloquea a los demás.
+ * - publish() solo copia a las colas; service() entrega (llamar en loop()).
+ * - Sin dependencias de Arduino ni memoria dinámica.
+ */
+class TelemetryPipeline {
+  public:
+    static constexpr uint8_t MAX_SINKS = 6;
+    static constexpr uint8_t QUEUE_MAX = 16;
+
+    // capacity se recorta a 1..QUEUE_MAX. Devuelve false si no hay espacio.
+    bool addSink(TelemetrySink* sink, uint8_t capacity = 4, DropPolicy policy = DropPolicy::DROP_OLDEST);
+
+    // Copia la muestra a la cola de cada sink. Retorna cuántos la aceptaron sin descartar.
+    uint8_t publish(const TelemetryRecord& rec);
+
+    // Entrega hasta maxPerSink muestras por sink. Retorna cuántas se entregaron en total.
+    uint16_t service(uint8_t maxPerSink = 1);
+
+    uint8_t sinkCount() const { return _count; }
+    const char* sinkName(uint8_t i) const;
+    const SinkStats* stats(uint8_t i) const;
+    uint8_t depth(uint8_t i) const;
+    void resetStats();
+
+  private:
+    struct Slot {
+      TelemetrySink*  sink = nullptr;
+      DropPolicy      policy = DropPolicy::DROP_OLDEST;
+      uint8_t         capacity = 0;
+      uint8_t         head = 0;     // índice de la más vieja
+      uint8_t         size = 0;
+      TelemetryRecord buf[QUEUE_MAX];
+      SinkStats       st;
+    };
+
+    Slot    _slots[MAX_SINKS];
+    uint8_t _count = 0;
+
+    static bool push(Slot& s, const TelemetryRecord& rec);
+    static void pop(Slot& s);
+};
+
+#endif
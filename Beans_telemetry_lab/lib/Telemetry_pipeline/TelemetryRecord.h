@@ -0,0 +1,29 @@
+#ifndef TELEMETRYRECORD_H
+#define TELEMETRYRECORD_H
+
+#include <stdint.h>
+
+/**
+ * Muestra única producida por la adquisición.
+ * - Se construye una vez por ciclo de lectura y luego sólo se copia/lee.
+ * - Sin dependencias de Arduino (compila en host).
+ */
+struct TelemetryRecord {
+  uint32_t seq;              // nº de muestra (monotónico)
+  uint32_t uptimeMs;         // millis() al momento de la adquisición
+  int64_t  epoch;            // time_t (0 si no hay NTP)
+  char     timestamp[20];    // "YYYY-MM-DD HH:MM:SS"
+
+  float temperatureIndoor;
+  float humidityIndoor;
+  float temperatureOutdoor;
+  float humidityOutdoor;
+
+  float lux1;                // TSL2561
+  float lux2;                // VEML7700
+  float lux3;                // BH1750
+
+  bool  sensorsError;
+};
+
+#endif
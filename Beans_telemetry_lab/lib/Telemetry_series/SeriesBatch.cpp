@@ -0,0 +1,47 @@
+#include "SeriesBatch.h"
+#include <string.h>
+
+SeriesBatch::SeriesBatch(uint16_t maxRecords) : _maxRecords(maxRecords ? maxRecords : 1) {
+  reset();
+}
+
+void SeriesBatch::reset() {
+  _enc.begin(_buf, sizeof(_buf), CHANNELS);
+  _firstEpoch = 0;
+}
+
+bool SeriesBatch::add(const TelemetryRecord& rec) {
+  if (full()) return false;
+
+  const float v[CHANNELS] = {
+    rec.temperatureIndoor, rec.humidityIndoor,
+    rec.temperatureOutdoor, rec.humidityOutdoor,
+    rec.lux1, rec.lux2, rec.lux3
+  };
+  if (!_enc.append(rec.uptimeMs, v)) return false;
+
+  if (_enc.count() == 1) _firstEpoch = rec.epoch;
+  return true;
+}
+
+uint16_t SeriesBatch::decode(const uint8_t* block, size_t len, TelemetryRecord* out, uint16_t maxOut) {
+  SeriesDecoder dec;
+  if (!out || !dec.begin(block, len) || dec.channels() != CHANNELS) return 0;
+
+  uint16_t n = 0;
+  uint32_t t;
+  float v[CHANNELS];
+  while (n < maxOut && dec.next(t, v)) {
+    TelemetryRecord& r = out[n++];
+    memset(&r, 0, sizeof(r));
+    r.uptimeMs           = t;
+    r.temperatureIndoor  = v[0];
+    r.humidityIndoor     = v[1];
+    r.temperatureOutdoor = v[2];
+    r.humidityOutdoor    = v[3];
+    r.lux1 = v[4];
+    r.lux2 = v[5];
+    r.lux3 = v[6];
+  }
+  return n;
+}
@@ -0,0 +1,45 @@
+#ifndef SERIESBATCH_H
+#define SERIESBATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "TelemetryRecord.h"
+#include "SeriesCodec.h"
+
+/**
+ * Lote comprimido de TelemetryRecord (7 canales float + uptimeMs).
+ * - Orden de canales: tempIn, humIn, tempOut, humOut, lux1, lux2, lux3.
+ * - firstEpoch(): epoch de la primera muestra, para anclar uptimeMs a hora real.
+ * - Usado por SDLogger (/datalog.gor) y ThingsBoardManager (base64 en JSON).
+ */
+class SeriesBatch {
+  public:
+    static constexpr uint8_t CHANNELS  = 7;
+    static constexpr size_t  BUF_BYTES = 512;
+
+    explicit SeriesBatch(uint16_t maxRecords = 60);
+
+    // false si el lote está lleno (por cantidad o bytes): hacer flush y reintentar
+    bool add(const TelemetryRecord& rec);
+    void reset();
+
+    bool     full() const   { return _enc.count() >= _maxRecords; }
+    bool     empty() const  { return _enc.count() == 0; }
+    uint16_t count() const  { return _enc.count(); }
+    size_t   size() const   { return _enc.bytes(); }
+    const uint8_t* data() const { return _buf; }
+    int64_t  firstEpoch() const { return _firstEpoch; }
+
+    void     setMaxRecords(uint16_t n) { _maxRecords = (n == 0) ? 1 : n; }
+
+    // Decodifica un bloque a registros (timestamp/seq no se reconstruyen). Retorna cuántos.
+    static uint16_t decode(const uint8_t* block, size_t len, TelemetryRecord* out, uint16_t maxOut);
+
+  private:
+    uint8_t       _buf[BUF_BYTES];
+    SeriesEncoder _enc;
+    uint16_t      _maxRecords;
+    int64_t       _firstEpoch = 0;
+};
+
+#endif
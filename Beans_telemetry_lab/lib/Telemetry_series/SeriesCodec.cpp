@@ -0,0 +1,313 @@
+#include "SeriesCodec.h"
+#include <string.h>
+
+// Marca de "sin ventana previa" para leading/trailing
+static constexpr uint8_t NO_WINDOW = 0xFF;
+
+static inline uint32_t floatBits(float f) {
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+static inline float bitsFloat(uint32_t u) {
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+// ======================================================
+// Encoder
+// ======================================================
+bool SeriesEncoder::begin(uint8_t* buf, size_t cap, uint8_t channels) {
+  if (!buf || cap < HEADER_BYTES || channels == 0 || channels > MAX_CHANNELS) return false;
+  _buf = buf;
+  _cap = cap;
+  _channels = channels;
+  _count = 0;
+  _overflow = false;
+  _prevT = 0;
+  _prevDelta = 0;
+
+  _buf[0] = MAGIC;
+  _buf[1] = VERSION;
+  _buf[2] = channels;
+  _buf[3] = 0;
+  _buf[4] = 0;
+  _bitPos = HEADER_BYTES * 8;
+  return true;
+}
+
+void SeriesEncoder::writeBits(uint32_t value, uint8_t nbits) {
+  while (nbits > 0) {
+    size_t byteIdx = _bitPos >> 3;
+    if (byteIdx >= _cap) { _overflow = true; return; }
+    nbits--;
+    uint8_t mask = (uint8_t)(0x80 >> (_bitPos & 7));
+    if ((value >> nbits) & 1u) _buf[byteIdx] |= mask;
+    else                       _buf[byteIdx] &= (uint8_t)~mask;
+    _bitPos++;
+  }
+}
+
+// Delta-de-delta:
+//   '0'                      dod == 0
+//   '10'   + 7 bits          dod en [-63, 64]
+//   '110'  + 9 bits          dod en [-255, 256]
+//   '1110' + 12 bits         dod en [-2047, 2048]
+//   '1111' + 32 bits         delta completo (int32)
+void SeriesEncoder::writeTimestamp(uint32_t t) {
+  int32_t delta = (int32_t)(t - _prevT);
+  int64_t dod   = (int64_t)delta - (int64_t)_prevDelta;
+
+  if (dod == 0) {
+    writeBits(0b0, 1);
+  } else if (dod >= -63 && dod <= 64) {
+    writeBits(0b10, 2);
+    writeBits((uint32_t)(dod + 63), 7);
+  } else if (dod >= -255 && dod <= 256) {
+    writeBits(0b110, 3);
+    writeBits((uint32_t)(dod + 255), 9);
+  } else if (dod >= -2047 && dod <= 2048) {
+    writeBits(0b1110, 4);
+    writeBits((uint32_t)(dod + 2047), 12);
+  } else {
+    writeBits(0b1111, 4);
+    writeBits((uint32_t)delta, 32);
+  }
+  _prevT = t;
+  _prevDelta = delta;
+}
+
+// XOR contra el anterior:
+//   '0'                                  igual al anterior
+//   '10' + bits en la ventana previa     cabe en la ventana leading/trailing previa
+//   '11' + 5b leading + 5b (len-1) + len bits
+void SeriesEncoder::writeValue(uint8_t ch, uint32_t bits) {
+  uint32_t x = bits ^ _prevBits[ch];
+  _prevBits[ch] = bits;
+
+  if (x == 0) {
+    writeBits(0b0, 1);
+    return;
+  }
+
+  uint8_t lead  = (uint8_t)__builtin_clz(x);
+  uint8_t trail = (uint8_t)__builtin_ctz(x);
+
+  if (_prevLead[ch] != NO_WINDOW && lead >= _prevLead[ch] && trail >= _prevTrail[ch]) {
+    uint8_t len = (uint8_t)(32 - _prevLead[ch] - _prevTrail[ch]);
+    writeBits(0b10, 2);
+    writeBits(x >> _prevTrail[ch], len);
+    return;
+  }
+
+  uint8_t len = (uint8_t)(32 - lead - trail);   // 1..32
+  writeBits(0b11, 2);
+  writeBits(lead, 5);
+  writeBits((uint32_t)(len - 1), 5);
+  writeBits(x >> trail, len);
+  _prevLead[ch]  = lead;
+  _prevTrail[ch] = trail;
+}
+
+bool SeriesEncoder::append(uint32_t t, const float* values) {
+  if (!_buf || !values || _count == 0xFFFF) return false;
+
+  // Respaldo para deshacer si la muestra no cabe completa
+  size_t   bitPos    = _bitPos;
+  uint32_t prevT     = _prevT;
+  int32_t  prevDelta = _prevDelta;
+  uint32_t prevBits[MAX_CHANNELS];
+  uint8_t  prevLead[MAX_CHANNELS];
+  uint8_t  prevTrail[MAX_CHANNELS];
+  memcpy(prevBits,  _prevBits,  sizeof(prevBits));
+  memcpy(prevLead,  _prevLead,  sizeof(prevLead));
+  memcpy(prevTrail, _prevTrail, sizeof(prevTrail));
+
+  _overflow = false;
+  if (_count == 0) {
+    writeBits(t, 32);
+    _prevT = t;
+    _prevDelta = 0;
+    for (uint8_t ch = 0; ch < _channels; ++ch) {
+      uint32_t b = floatBits(values[ch]);
+      writeBits(b, 32);
+      _prevBits[ch]  = b;
+      _prevLead[ch]  = NO_WINDOW;
+      _prevTrail[ch] = 0;
+    }
+  } else {
+    writeTimestamp(t);
+    for (uint8_t ch = 0; ch < _channels; ++ch) writeValue(ch, floatBits(values[ch]));
+  }
+
+  if (_overflow) {
+    _bitPos    = bitPos;
+    _prevT     = prevT;
+    _prevDelta = prevDelta;
+    memcpy(_prevBits,  prevBits,  sizeof(prevBits));
+    memcpy(_prevLead,  prevLead,  sizeof(prevLead));
+    memcpy(_prevTrail, prevTrail, sizeof(prevTrail));
+    _overflow = false;
+    return false;
+  }
+
+  _count++;
+  _buf[3] = (uint8_t)(_count & 0xFF);
+  _buf[4] = (uint8_t)(_count >> 8);
+  return true;
+}
+
+// ======================================================
+// Decoder
+// ======================================================
+bool SeriesDecoder::begin(const uint8_t* buf, size_t len) {
+  if (!buf || len < SeriesEncoder::HEADER_BYTES) return false;
+  if (buf[0] != SeriesEncoder::MAGIC || buf[1] != SeriesEncoder::VERSION) return false;
+  if (buf[2] == 0 || buf[2] > SeriesEncoder::MAX_CHANNELS) return false;
+
+  _buf = buf;
+  _len = len;
+  _channels = buf[2];
+  _count = (uint16_t)(buf[3] | (buf[4] << 8));
+  _read = 0;
+  _underflow = false;
+  _bitPos = SeriesEncoder::HEADER_BYTES * 8;
+  _prevT = 0;
+  _prevDelta = 0;
+  return true;
+}
+
+uint32_t SeriesDecoder::readBits(uint8_t nbits) {
+  uint32_t v = 0;
+  while (nbits > 0) {
+    size_t byteIdx = _bitPos >> 3;
+    if (byteIdx >= _len) { _underflow = true; return 0; }
+    uint8_t mask = (uint8_t)(0x80 >> (_bitPos & 7));
+    v = (v << 1) | ((_buf[byteIdx] & mask) ? 1u : 0u);
+    _bitPos++;
+    nbits--;
+  }
+  return v;
+}
+
+uint32_t SeriesDecoder::readTimestamp() {
+  int32_t delta;
+  if (readBits(1) == 0) {
+    delta = _prevDelta;
+  } else if (readBits(1) == 0) {
+    delta = _prevDelta + (int32_t)readBits(7) - 63;
+  } else if (readBits(1) == 0) {
+    delta = _prevDelta + (int32_t)readBits(9) - 255;
+  } else if (readBits(1) == 0) {
+    delta = _prevDelta + (int32_t)readBits(12) - 2047;
+  } else {
+    delta = (int32_t)readBits(32);
+  }
+  _prevT += (uint32_t)delta;
+  _prevDelta = delta;
+  return _prevT;
+}
+
+uint32_t SeriesDecoder::readValue(uint8_t ch) {
+  if (readBits(1) == 0) return _prevBits[ch];
+
+  uint32_t x;
+  if (readBits(1) == 0) {
+    if (_prevLead[ch] == NO_WINDOW) { _underflow = true; return 0; }
+    uint8_t len = (uint8_t)(32 - _prevLead[ch] - _prevTrail[ch]);
+    x = readBits(len) << _prevTrail[ch];
+  } else {
+    uint8_t lead = (uint8_t)readBits(5);
+    uint8_t len  = (uint8_t)(readBits(5) + 1);
+    if (lead + len > 32) { _underflow = true; return 0; }
+    uint8_t trail = (uint8_t)(32 - lead - len);
+    uint32_t m = readBits(len);
+    x = (trail >= 32) ? 0 : (m << trail);
+    _prevLead[ch]  = lead;
+    _prevTrail[ch] = trail;
+  }
+  _prevBits[ch] ^= x;
+  return _prevBits[ch];
+}
+
+bool SeriesDecoder::next(uint32_t& t, float* values) {
+  if (!_buf || !values || _read >= _count || _underflow) return false;
+
+  if (_read == 0) {
+    _prevT = readBits(32);
+    _prevDelta = 0;
+    t = _prevT;
+    for (uint8_t ch = 0; ch < _channels; ++ch) {
+      _prevBits[ch]  = readBits(32);
+      _prevLead[ch]  = NO_WINDOW;
+      _prevTrail[ch] = 0;
+    }
+  } else {
+    t = readTimestamp();
+    for (uint8_t ch = 0; ch < _channels; ++ch) readValue(ch);
+  }
+  if (_underflow) return false;
+
+  for (uint8_t ch = 0; ch < _channels; ++ch) values[ch] = bitsFloat(_prevBits[ch]);
+  _read++;
+  return true;
+}
+
+// ======================================================
+// Base64
+// ======================================================
+static const char B64_ALPHABET[] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t base64Encode(const uint8_t* in, size_t len, char* out, size_t cap) {
+  size_t need = ((len + 2) / 3) * 4;
+  if (!out || need + 1 > cap) return 0;
+
+  size_t o = 0;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t n = (uint32_t)in[i] << 16;
+    if (i + 1 < len) n |= (uint32_t)in[i + 1] << 8;
+    if (i + 2 < len) n |= (uint32_t)in[i + 2];
+    out[o++] = B64_ALPHABET[(n >> 18) & 0x3F];
+    out[o++] = B64_ALPHABET[(n >> 12) & 0x3F];
+    out[o++] = (i + 1 < len) ? B64_ALPHABET[(n >> 6) & 0x3F] : '=';
+    out[o++] = (i + 2 < len) ? B64_ALPHABET[n & 0x3F] : '=';
+  }
+  out[o] = '\0';
+  return o;
+}
+
+static int8_t b64Value(char c) {
+  if (c >= 'A' && c <= 'Z') return (int8_t)(c - 'A');
+  if (c >= 'a' && c <= 'z') return (int8_t)(c - 'a' + 26);
+  if (c >= '0' && c <= '9') return (int8_t)(c - '0' + 52);
+  if (c == '+') return 62;
+  if (c == '/') return 63;
+  return -1;
+}
+
+size_t base64Decode(const char* in, size_t len, uint8_t* out, size_t cap) {
+  if (!in || !out || (len % 4) != 0) return 0;
+
+  size_t o = 0;
+  for (size_t i = 0; i < len; i += 4) {
+    int8_t a = b64Value(in[i]);
+    int8_t b = b64Value(in[i + 1]);
+    bool pad2 = (in[i + 2] == '=');
+    bool pad3 = (in[i + 3] == '=');
+    int8_t c = pad2 ? 0 : b64Value(in[i + 2]);
+    int8_t d = pad3 ? 0 : b64Value(in[i + 3]);
+    if (a < 0 || b < 0 || c < 0 || d < 0) return 0;
+    if ((pad2 || pad3) && i + 4 != len) return 0;   // '=' solo al final
+
+    uint32_t n = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | (uint32_t)d;
+    size_t k = pad2 ? 1 : (pad3 ? 2 : 3);
+    if (o + k > cap) return 0;
+    out[o++] = (uint8_t)(n >> 16);
+    if (k > 1) out[o++] = (uint8_t)(n >> 8);
+    if (k > 2) out[o++] = (uint8_t)n;
+  }
+  return o;
+}
@@ -0,0 +1,92 @@
+#ifndef SERIESCODEC_H
+#define SERIESCODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Compresión de series de tiempo estilo Gorilla (timestamp + N canales float).
+ * - Timestamp: delta-de-delta con prefijos de longitud variable.
+ * - Valores: XOR contra el valor anterior del mismo canal; solo se guardan
+ *   los bits significativos. La ida y vuelta es exacta bit a bit (NaN incluido).
+ * - Bloque: [0x47 'G'][versión][canales][count lo][count hi][bitstream...]
+ * - Sin dependencias de Arduino ni memoria dinámica (buffer provisto por el llamador).
+ */
+
+class SeriesEncoder {
+  public:
+    static constexpr uint8_t MAX_CHANNELS = 8;
+    static constexpr uint8_t MAGIC        = 0x47;
+    static constexpr uint8_t VERSION      = 1;
+    static constexpr size_t  HEADER_BYTES = 5;
+
+    // Inicia un bloque sobre buf. false si no cabe la cabecera o channels inválido.
+    bool begin(uint8_t* buf, size_t cap, uint8_t channels);
+
+    // Agrega una muestra (values[channels]). Atómico: si no cabe, el bloque
+    // queda como estaba y retorna false.
+    bool append(uint32_t t, const float* values);
+
+    uint16_t count() const    { return _count; }
+    uint8_t  channels() const { return _channels; }
+    size_t   bytes() const    { return (_bitPos + 7) / 8; }   // tamaño válido del bloque
+    const uint8_t* data() const { return _buf; }
+
+  private:
+    uint8_t* _buf = nullptr;
+    size_t   _cap = 0;
+    size_t   _bitPos = 0;
+    bool     _overflow = false;
+
+    uint8_t  _channels = 0;
+    uint16_t _count = 0;
+
+    uint32_t _prevT = 0;
+    int32_t  _prevDelta = 0;
+    uint32_t _prevBits[MAX_CHANNELS] = {};
+    uint8_t  _prevLead[MAX_CHANNELS] = {};
+    uint8_t  _prevTrail[MAX_CHANNELS] = {};
+
+    void writeBits(uint32_t value, uint8_t nbits);
+    void writeTimestamp(uint32_t t);
+    void writeValue(uint8_t ch, uint32_t bits);
+};
+
+class SeriesDecoder {
+  public:
+    // false si la cabecera no es válida
+    bool begin(const uint8_t* buf, size_t len);
+
+    // Lee la siguiente muestra. false al terminar o si el bloque está truncado.
+    bool next(uint32_t& t, float* values);
+
+    uint16_t count() const    { return _count; }
+    uint8_t  channels() const { return _channels; }
+
+  private:
+    const uint8_t* _buf = nullptr;
+    size_t   _len = 0;
+    size_t   _bitPos = 0;
+    bool     _underflow = false;
+
+    uint8_t  _channels = 0;
+    uint16_t _count = 0;
+    uint16_t _read = 0;
+
+    uint32_t _prevT = 0;
+    int32_t  _prevDelta = 0;
+    uint32_t _prevBits[SeriesEncoder::MAX_CHANNELS] = {};
+    uint8_t  _prevLead[SeriesEncoder::MAX_CHANNELS] = {};
+    uint8_t  _prevTrail[SeriesEncoder::MAX_CHANNELS] = {};
+
+    uint32_t readBits(uint8_t nbits);
+    uint32_t readTimestamp();
+    uint32_t readValue(uint8_t ch);
+};
+
+// Base64 (RFC 4648, con '='). Retorna caracteres escritos (sin '\0'), 0 si no cabe.
+size_t base64Encode(const uint8_t* in, size_t len, char* out, size_t cap);
+// Retorna bytes escritos, 0 si la entrada es inválida o no cabe.
+size_t base64Decode(const char* in, size_t len, uint8_t* out, size_t cap);
+
+#endif
@@ -0,0 +1,51 @@
+#include "TelemetrySinks.h"
+
+// ----------------------
+// Telnet
+// ----------------------
+
+bool TelnetSink::consume(const TelemetryRecord& rec) {
+  // Con "data" por debajo de info la muestra se descarta sin formatear
+  if (!LOG_ON(LOG_LVL_INFO, LogMod::DATA)) return true;
+
+  char line[64];
+  snprintf(line, sizeof(line), "Muestra #%lu - %s", (unsigned long)rec.seq, rec.timestamp);
+  _remote.log(line);
+
+  luxLine_("TSL", rec.lux1);
+  luxLine_("VEML", rec.lux2);
+  luxLine_("BH", rec.lux3);
+
+  if (rec.temperatureOutdoor > -1) {
+    snprintf(line, sizeof(line), "  Temperatura Outdoor: %.2f °C", rec.temperatureOutdoor);
+    _remote.log(line);
+  } else {
+    _remote.log("  Error al leer temperatura Outdoor");
+  }
+  if (rec.humidityOutdoor >= 0) {
+    snprintf(line, sizeof(line), "  Humedad Outdoor: %.2f %%", rec.humidityOutdoor);
+    _remote.log(line);
+  } else {
+    _remote.log("  Error al leer humedad Outdoor");
+  }
+
+  _remote.log("----------------------------------");
+  return true;
+}
+
+void TelnetSink::luxLine_(const char* name, float lux) {
+  char line[40];
+  if (lux >= 0) snprintf(line, sizeof(line), "  Lux %s: %.2f", name, lux);
+  else          snprintf(line, sizeof(line), "  Lux %s: Saturado", name);
+  _remote.log(line);
+}
+
+// ----------------------
+// LCD
+// ----------------------
+
+bool LcdSink::consume(const TelemetryRecord& rec) {
+  _last = rec;
+  _hasData = true;
+  return true;
+}
@@ -0,0 +1,39 @@
+#ifndef TELEMETRYSINKS_H
+#define TELEMETRYSINKS_H
+
+#include <Arduino.h>
+#include "TelemetryPipeline.h"
+#include "WiFiPortalManager.h"
+#include "log_manager.h"
+
+// ----------------------
+// Telnet / Serial: formatea la muestra en el log remoto (módulo "data")
+// ----------------------
+class TelnetSink : public TelemetrySink {
+  public:
+    explicit TelnetSink(RemoteAccessManager& remote) : _remote(remote) {}
+    const char* sinkName() const override { return "telnet"; }
+    bool consume(const TelemetryRecord& rec) override;
+
+  private:
+    RemoteAccessManager& _remote;
+    void luxLine_(const char* name, float lux);
+};
+
+// ----------------------
+// LCD: guarda la última muestra para que las páginas la dibujen
+// ----------------------
+class LcdSink : public TelemetrySink {
+  public:
+    const char* sinkName() const override { return "lcd"; }
+    bool consume(const TelemetryRecord& rec) override;
+
+    bool hasData() const { return _hasData; }
+    const TelemetryRecord& last() const { return _last; }
+
+  private:
+    TelemetryRecord _last{};
+    bool _hasData = false;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "ThingsBoardManager.h"
+#include "log_manager.h"
+
+ThingsBoardManager::ThingsBoardManager(const char* host, uint16_t port, const char* accessToken, unsigned long interval)
+  : _host(host), _port(port), _token(accessToken), _interval(interval), _mqtt(_tcp) {}
+
+void ThingsBoardManager::begin() {
+  // clientId único por placa: con el mismo id el broker expulsa la sesión anterior
+  _clientId = String("beans_") + WiFi.macAddress();
+  _mqtt.setServer(_host, _port);
+  _mqtt.setBufferSize(_batchSize > 1 ? BATCH_BUFFER : 512);
+  tryConnect();
+}
+
+bool ThingsBoardManager::tryConnect() {
+  _lastAttempt = millis();
+  if (_mqtt.connect(_clientId.c_str(), _token, nullptr)) {
+    LOG_I(LogMod::NET, "✔️ Conectado a ThingsBoard");
+    return true;
+  }
+  LOG_E(LogMod::NET, "❌ ThingsBoard rc=%d", _mqtt.state());
+  return false;
+}
+
+void ThingsBoardManager::update() {
+  if (!_mqtt.connected()) {
+    if (millis() - _lastAttempt >= RECONNECT_MS) tryConnect();
+    return;
+  }
+  _mqtt.loop();
+}
+
+void ThingsBoardManager::setBatchSize(uint16_t n) {
+  _batchSize = (n == 0) ? 1 : n;
+  if (_batchSize > 1) {
+    _batch.setMaxRecords(_batchSize);
+    _mqtt.setBufferSize(BATCH_BUFFER);
+  }
+}
+
+bool ThingsBoardManager::ready() {
+  // En modo lote se aceptan muestras sin conexión mientras haya espacio
+  if (_batchSize > 1) return !_batch.full() || _mqtt.connected();
+  return _mqtt.connected() && (millis() - _lastTime >= _interval);
+}
+
+bool ThingsBoardManager::publishBatch() {
+  if (_batch.empty()) return true;
+  if (!_mqtt.connected()) return false;
+
+  char b64[((SeriesBatch::BUF_BYTES + 2) / 3) * 4 + 1];
+  if (base64Encode(_batch.data(), _batch.size(), b64, sizeof(b64)) == 0) return false;
+
+  char payload[sizeof(b64) + 96];
+  int n = snprintf(payload, sizeof(payload),
+                   "{\"series_gor\":\"%s\",\"series_n\":%u,\"series_t0\":%lld}",
+                   b64, (unsigned)_batch.count(), (long long)_batch.firstEpoch());
+  if (n <= 0 || n >= (int)sizeof(payload)) return false;
+
+  if (!_mqtt.publish("v1/devices/me/telemetry", payload)) return false;
+  _lastTime = millis();
+  _batch.reset();
+  return true;
+}
+
+bool ThingsBoardManager::consume(const TelemetryRecord& rec) {
+  if (_batchSize > 1) {
+    if (!_batch.add(rec)) {
+      // Lote lleno: hay que publicarlo antes de aceptar la muestra
+      if (!publishBatch() || !_batch.add(rec)) return false;
+    }
+    if (_batch.full()) publishBatch();   // si falla, se reintenta con la próxima muestra
+    return true;
+  }
+
+  char payload[320];
+  int n;
+  if (rec.epoch > 0) {
+    n = snprintf(payload, sizeof(payload),
+                 "{\"ts\":%lld000,\"values\":{\"temperature_outdoor\":%.2f,\"humidity_outdoor\":%.2f,"
+                 "\"lux1\":%.2f,\"lux2\":%.2f,\"lux3\":%.2f,\"sensors_error\":%s}}",
+                 (long long)rec.epoch, rec.temperatureOutdoor, rec.humidityOutdoor,
+                 rec.lux1, rec.lux2, rec.lux3, rec.sensorsError ? "true" : "false");
+  } else {
+    n = snprintf(payload, sizeof(payload),
+                 "{\"temperature_outdoor\":%.2f,\"humidity_outdoor\":%.2f,"
+                 "\"lux1\":%.2f,\"lux2\":%.2f,\"lux3\":%.2f,\"sensors_error\":%s}",
+                 rec.temperatureOutdoor, rec.humidityOutdoor,
+                 rec.lux1, rec.lux2, rec.lux3, rec.sensorsError ? "true" : "false");
+  }
+  if (n <= 0 || n >= (int)sizeof(payload)) return false;
+
+  _lastTime = millis();
+  return _mqtt.publish("v1/devices/me/telemetry", payload);
+}
@@ -0,0 +1,50 @@
+#ifndef THINGSBOARDMANAGER_H
+#define THINGSBOARDMANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include "TelemetryPipeline.h"
+#include "SeriesBatch.h"
+
+// ----------------------
+// ThingsBoard (MQTT, token de dispositivo como usuario)
+// Reconexión no bloqueante con reintento cada RECONNECT_MS.
+// setBatchSize(n > 1): acumula n muestras en un SeriesBatch y publica
+// {"series_gor": base64, "series_n": n, "series_t0": epoch} (no apto para Ubidots).
+// ----------------------
+class ThingsBoardManager : public TelemetrySink {
+  public:
+    ThingsBoardManager(const char* host, uint16_t port, const char* accessToken, unsigned long interval);
+    void begin();
+    void update();   // llamar en loop(): mantiene la sesión MQTT
+
+    const char* sinkName() const override { return "thingsboard"; }
+    bool ready() override;
+    bool consume(const TelemetryRecord& rec) override;
+
+    void setBatchSize(uint16_t n);
+
+  private:
+    static constexpr unsigned long RECONNECT_MS = 5000;
+    static constexpr uint16_t BATCH_BUFFER = 1024;   // buffer MQTT en modo lote
+
+    const char* _host;
+    uint16_t _port;
+    const char* _token;
+    String _clientId;
+    unsigned long _interval;
+    unsigned long _lastTime = 0;
+    unsigned long _lastAttempt = 0;
+
+    WiFiClient _tcp;
+    PubSubClient _mqtt;
+
+    uint16_t _batchSize = 1;
+    SeriesBatch _batch;
+
+    bool tryConnect();
+    bool publishBatch();
+};
+
+#endif
@@ -1,5 +1,5 @@
 #include "UbidotsManager.h"
-#include "SensorData.h"
+#include "log_manager.h"
 
 UbidotsManager::UbidotsManager(const char* token, const char* ssid, const char* pass, const char* deviceLabel, unsigned long interval)
   : _token(token), _ssid(ssid), _pass(pass), _deviceLabel(deviceLabel), _interval(interval), _ubidots(token) {}
@@ -18,50 +18,47 @@ void UbidotsManager::update() {
   }
 
   _ubidots.loop();
+}
 
-  if (millis() - _lastTime >= _interval) {
-    sendData();
-    _lastTime = millis();
-  }
+bool UbidotsManager::ready() {
+  return _ubidots.connected() && (millis() - _lastTime >= _interval);
+}
+
+bool UbidotsManager::consume(const TelemetryRecord& rec) {
+  bool ok = sendData(rec);
+  _lastTime = millis();  // aun si falla: respeta el intervalo y no satura el broker
+  return ok;
 }
 
 void UbidotsManager::reconnect() {
   _ubidots.reconnect();
 }
 
-void UbidotsManager::sendData() {
-  static bool sendFirstGroup = true;
-
-  if (sendFirstGroup) {
-    // _ubidots.add("temperature_indoor", sensorData.getTemperatureIndoor());
-    // _ubidots.add("humidity_indoor", sensorData.getHumidityIndoor());
-    _ubidots.add("temperature_outdoor", sensorData.getTemperatureOutdoor());
-    _ubidots.add("humidity_outdoor", sensorData.getHumidityOutdoor());
-    Serial.println("Enviando primer grupo...");
+bool UbidotsManager::sendData(const TelemetryRecord& rec) {
+  if (_sendFirstGroup) {
+    // _ubidots.add("temperature_indoor", rec.temperatureIndoor);
+    // _ubidots.add("humidity_indoor", rec.humidityIndoor);
+    _ubidots.add("temperature_outdoor", rec.temperatureOutdoor);
+    _ubidots.add("humidity_outdoor", rec.humidityOutdoor);
+    LOG_D(LogMod::NET, "Enviando primer grupo...");
   } else {
-    _ubidots.add("lux1", sensorData.getLux1());
-    _ubidots.add("lux2", sensorData.getLux2());
-    _ubidots.add("lux3", sensorData.getLux3());
-    Serial.println("Enviando segundo grupo...");
+    _ubidots.add("lux1", rec.lux1);
+    _ubidots.add("lux2", rec.lux2);
+    _ubidots.add("lux3", rec.lux3);
+    LOG_D(LogMod::NET, "Enviando segundo grupo...");
   }
 
 
   bool success = _ubidots.publish(_deviceLabel);
   if (success) {
-    Serial.println("✔️ Datos enviados a Ubidots (MQTT)");
+    LOG_I(LogMod::NET, "✔️ Datos enviados a Ubidots (MQTT)");
+    _sendFirstGroup = !_sendFirstGroup;  // alternar para el siguiente envío
   } else {
-    Serial.println("❌ Error al publicar en Ubidots");
+    LOG_E(LogMod::NET, "❌ Error al publicar en Ubidots");
   }
-
-  sendFirstGroup = !sendFirstGroup;  // alternar para el siguiente envío
+  return success;
 }
 
 void UbidotsManager::callback(char* topic, byte* payload, unsigned int length) {
-  Serial.print("Mensaje recibido [");
-  Serial.print(topic);
-  Serial.print("]: ");
-  for (int i = 0; i < length; i++) {
-    Serial.print((char)payload[i]);
-  }
-  Serial.println();
+  LOG_I(LogMod::NET, "Mensaje recibido [%s]: %.*s", topic, (int)length, (const char*)payload);
 }
@@ -2,12 +2,18 @@
 #define UBIDOTSMANAGER_H
 
 #include <UbidotsEsp32Mqtt.h>
+#include "TelemetryPipeline.h"
 
-class UbidotsManager {
+class UbidotsManager : public TelemetrySink {
   public:
     UbidotsManager(const char* token, const char* ssid, const char* pass, const char* deviceLabel, unsigned long interval);
     void begin();
-    void update();
+    void update();   // mantiene la conexión MQTT (ya no envía datos por sí mismo)
+
+    // TelemetrySink: publica como máximo una muestra por intervalo
+    const char* sinkName() const override { return "ubidots"; }
+    bool ready() override;
+    bool consume(const TelemetryRecord& rec) override;
 
   private:
     const char* _ssid;
@@ -16,12 +22,13 @@ class UbidotsManager {
     const char* _deviceLabel;
     unsigned long _interval;
     unsigned long _lastTime;
+    bool _sendFirstGroup = true;
 
     Ubidots _ubidots;
 
     static void callback(char* topic, byte* payload, unsigned int length);
     void reconnect();
-    void sendData();
+    bool sendData(const TelemetryRecord& rec);
 };
 
 #endif
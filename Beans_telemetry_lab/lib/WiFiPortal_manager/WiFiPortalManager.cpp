@@ -91,6 +91,13 @@ void RemoteAccessManager::log(const String& message) {
     }
 }
 
+void RemoteAccessManager::log(const char* message) {
+    Serial.println(message);
+    if (_telnetClient && _telnetClient.connected()) {
+        _telnetClient.println(message);
+    }
+}
+
 void RemoteAccessManager::setupTelnet() {
     _telnetServer.begin();
     _telnetServer.setNoDelay(true);
@@ -35,6 +35,7 @@ public:
     void begin();
     void handle();
     void log(const String& message);
+    void log(const char* message);     // sin copia a String
 
 private:
     const char* _hostname;
@@ -9,6 +9,10 @@
 #include "SDLogger.h"
 #include "Alerts_manager.h"
 #include "LCD_manager.h"
+#include "TelemetryPipeline.h"
+#include "TelemetrySinks.h"
+#include "ThingsBoardManager.h"
+#include "log_manager.h"
 #include <globals.h>
 
 const char *SSID = "Delga";
@@ -17,6 +21,16 @@ const char *UBIDOTS_TOKEN = "BBUS-k2DesIYqrGRk5133NrNl748KpgD6Nv";
 const char *DEVICE_LABEL = "beans_lab_001";
 #define TELNET_HOSTNAME "Beans_telemetry"
 
+// ThingsBoard local (ver ThingsBoard/docker-compose.yml). Token vacío => sink deshabilitado
+const char *TB_HOST  = "thingsboard.local";
+const char *TB_TOKEN = "";
+// Muestras por publicación comprimida (delta/XOR + base64). 1 => una muestra JSON por publish.
+// 12 x 5 s = un publish por minuto con todas las muestras (~190 B de bloque, ver bench/series_bench.cpp)
+#define TB_BATCH_SIZE 12
+// Muestras por bloque comprimido en /datalog.gor (0 => un registro MessagePack por muestra).
+// 30 x 5 s: el bloque (~420 B) entra en SeriesBatch::BUF_BYTES y a lo sumo se pierden 2.5 min si se corta la energía
+#define SD_SERIES_BLOCK 30
+
 
 #define dht_indoor_PIN 33
 #define dht_outdoor_PIN 32
@@ -44,6 +58,11 @@ RemoteAccessManager remoteManager(TELNET_HOSTNAME);
 
 SDLogger logger;
 
+ThingsBoardManager thingsboard(TB_HOST, 1883, TB_TOKEN, 60000);
+TelnetSink telnetSink(remoteManager);
+LcdSink lcdSink;
+TelemetryPipeline pipeline;
+
 DebugLeds debugLeds;
 
 Lcd16x2 lcd(0x27, 16, 2);
@@ -54,6 +73,27 @@ void setupLuxSensors();
 void setupDHTSensors();
 void readDHTSensors();
 void updateData();
+void setupPipeline()
+{
+  // Colas dimensionadas para que "drop" signifique sobrecarga:
+  //  - Ubidots publica cada 60 s y el LCD redibuja cada 2 s; sólo quieren la
+  //    última muestra (KEEP_LATEST: la reemplazada no es pérdida)
+  //  - ThingsBoard en lote toma cada muestra (el lote es su buffer); sin conexión
+  //    y con el lote lleno, 16 más de cola antes de descartar lo nuevo
+  //  - Telnet entrega en cada service(); 4 absorben un loop() lento (OTA, WiFi)
+  //  - SD conserva el histórico pendiente: 16 muestras (80 s a 5 s) de margen
+  //    antes de descartar lo nuevo si la tarjeta no da abasto
+  pipeline.addSink(&ubidots, 1, DropPolicy::KEEP_LATEST);
+  if (TB_TOKEN[0] != '\0') {
+    if (TB_BATCH_SIZE > 1) pipeline.addSink(&thingsboard, 16, DropPolicy::DROP_NEWEST);
+    else                   pipeline.addSink(&thingsboard, 1, DropPolicy::KEEP_LATEST);
+  }
+  pipeline.addSink(&telnetSink, 4, DropPolicy::DROP_OLDEST);
+  pipeline.addSink(&lcdSink, 1, DropPolicy::KEEP_LATEST);
+  if (logger.ready()) pipeline.addSink(&logger, 16, DropPolicy::DROP_NEWEST);
+}
+
+void logPipelineStats();
 void LEDDebug();
 void setupLCD();
 void uiSetup();
@@ -62,6 +102,7 @@ void uiUpdate();
 void setup()
 {
   Serial.begin(115200);
+  logSetSink([](const char* line) { remoteManager.log(line); });
   sensorData.setSensorsErrorState(false);
   uiSetup();
   setupLCD();
@@ -75,7 +116,11 @@ void setup()
   delay(300);
   // Prueba inicial: LED 0 en rojo sólido
   debugLeds.setColor(0, 255, 0, 0); // LED 0 - Rojo
-  // logger.begin();
+  // Bloques comprimidos en /datalog.gor; con SD_SERIES_BLOCK = 0, MessagePack con
+  // claves enteras en /datalog.msgpack (append, sin releer el archivo)
+  logger.setEncoding(PayloadEncoding::MSGPACK);
+  logger.setSeriesBatching(SD_SERIES_BLOCK);
+  logger.begin();   // sin tarjeta sigue sin SD (el sink no se registra)
 
   wifiManager.begin();
   if (wifiManager.isConnected())
@@ -98,7 +143,10 @@ void setup()
   lcd.centerPrint(0, "Conectando al");
   lcd.centerPrint(1, "servidor");
   ubidots.begin();
+  thingsboard.setBatchSize(TB_BATCH_SIZE);
+  if (TB_TOKEN[0] != '\0') thingsboard.begin();
   timeManager.begin();
+  setupPipeline();
   debugLeds.setColor(0, 0, 100, 0);
 
   lcd.clear();
@@ -112,6 +160,9 @@ void loop()
 
   updateData();
   ubidots.update();
+  if (TB_TOKEN[0] != '\0') thingsboard.update();
+  pipeline.service();
+  logPipelineStats();
   wifiManager.loop();
   remoteManager.handle();   // <- primero maneja OTA y Telnet
   watchdogUpdate();
@@ -126,26 +177,28 @@ void watchdogUpdate()
   if (millis() - last_Check > 10000)
   {
     // Serial.println("Alimentando el WDT...");
-    remoteManager.log("Alimentando el WDT...");
+    LOG_D(LogMod::SYS, "Alimentando el WDT...");
     last_Check = millis();
 
     if (WiFi.status() != WL_CONNECTED)
     {
       // Serial.println("⚠️ WiFi desconectado, reiniciando...");
-      remoteManager.log("⚠️ WiFi desconectado, reiniciando...");
+      LOG_E(LogMod::SYS, "⚠️ WiFi desconectado, reiniciando...");
       lcd.clear();
       lcd.centerPrint(0, "ERROR DE WIFI");
       lcd.centerPrint(1, "Reiniciando...");
+      if (logger.ready()) logger.flushSeries();   // no perder el bloque pendiente de /datalog.gor
       delay(3000);
       ESP.restart();
     }
     
     if(sensorData.getSensorsErrorState()){
       // Serial.println("⚠️ Error en lectura de lux, reiniciando...");
-      remoteManager.log("⚠️ Error en lectura de sensores, reiniciando...");
+      LOG_E(LogMod::SYS, "⚠️ Error en lectura de sensores, reiniciando...");
       lcd.clear();
       lcd.centerPrint(0, "ERROR DE SENSOR");
       lcd.centerPrint(1, "Reiniciando...");
+      if (logger.ready()) logger.flushSeries();   // no perder el bloque pendiente de /datalog.gor
       delay(3000);
       ESP.restart();
     }
@@ -159,7 +212,7 @@ void setupLuxSensors()
   if (!tslSensor.begin())
   {
     // Serial.println("Error al iniciar tslSensor");
-    remoteManager.log("Error al iniciar tslSensor");
+    LOG_E(LogMod::SENS, "Error al iniciar tslSensor");
   }
   else
   {
@@ -170,7 +223,7 @@ void setupLuxSensors()
   if (!vemlSensor.begin())
   {
     // Serial.println("Error al iniciar vemlSensor");  
-    remoteManager.log("Error al iniciar vemlSensor");
+    LOG_E(LogMod::SENS, "Error al iniciar vemlSensor");
   }
   else
   {
@@ -180,7 +233,7 @@ void setupLuxSensors()
   if (!bh.begin())
   {
     // Serial.println("Error al iniciar bh");
-    remoteManager.log("Error al iniciar bh");
+    LOG_E(LogMod::SENS, "Error al iniciar bh");
   }
   else
   {
@@ -226,54 +279,17 @@ void readLuxSensors()
   }
   //1:tsl, 2:veml, 3:bh
   if(sensorData.getLux1() == 0 && sensorData.getLux2() != 0 && sensorData.getLux3() != 0){
-    remoteManager.log(" Error en lectura de VEML7700");
+    LOG_W(LogMod::SENS, " Error en lectura de VEML7700");
     sensorData.setSensorsErrorState(true);
   }
   else if (sensorData.getLux1() != 0 && sensorData.getLux2() == 0 && sensorData.getLux3() != 0){
-  remoteManager.log(" Error en lectura de TSL2561");
+  LOG_W(LogMod::SENS, " Error en lectura de TSL2561");
   sensorData.setSensorsErrorState(true);
   }
   else if (sensorData.getLux1() == 0 && sensorData.getLux2() == 0 && sensorData.getLux3() != 0){
-    remoteManager.log(" Error en lectura de BH1750");
+    LOG_W(LogMod::SENS, " Error en lectura de BH1750");
     sensorData.setSensorsErrorState(true);
   }
-
-
-  
-
-  // Mostrar resultados desde SensorData
-  // Serial.print("Sensor tsl: ");
-  remoteManager.log("Sensor tsl:");
-  if (sensorData.getLux1() >= 0)
-    // Serial.print(sensorData.getLux1());
-    remoteManager.log("  Lux TSL: " + String(sensorData.getLux1()));
-  else
-    // Serial.print("Saturado");
-  // Serial.println(" lux");
-    remoteManager.log("  Lux TSL: Saturado");
-
-  // Serial.print("Sensor veml: ");
-  remoteManager.log("Sensor veml:");
-  if (sensorData.getLux2() >= 0)
-    // Serial.print(sensorData.getLux2());
-    remoteManager.log("  Lux VEML: " + String(sensorData.getLux2()));
-  else
-    // Serial.print("Saturado");
-  // Serial.println(" lux");
-    remoteManager.log("  Lux VEML: Saturado");
-
-  // Serial.print("Sensor bh: ");
-  remoteManager.log("Sensor bh:");
-  if (sensorData.getLux3() >= 0)
-    // Serial.print(sensorData.getLux3());
-    remoteManager.log("  Lux BH: " + String(sensorData.getLux3()));
-  else
-    // Serial.print("Saturado");
-  // Serial.println(" lux");
-    remoteManager.log("  Lux BH: Saturado");
-
-  // Serial.println("----------------------------");
-  remoteManager.log("----------------------------");
 }
 
 void setupDHTSensors()
@@ -323,45 +339,25 @@ void readDHTSensors()
   //   remoteManager.log("  Error al leer humedad Indoor");
   // }
 
-  Serial.println("Sensor Outdoor:");
-  if (sensorData.getTemperatureOutdoor() > -1)
+  // Los valores se muestran en TelnetSink; aquí sólo se marcan errores
+  if (sensorData.getTemperatureOutdoor() <= -1)
   {
-    // Serial.print("  Temperatura: ");
-    // Serial.print(sensorData.getTemperatureOutdoor());
-    // Serial.println(" °C");
-    remoteManager.log("  Temperatura Outdoor: " + String(sensorData.getTemperatureOutdoor()) + " °C");
-  }
-  else
-  {
-    // Serial.println("  Error al leer temperatura");
-    remoteManager.log("  Error al leer temperatura Outdoor");
+    LOG_W(LogMod::SENS, "  Error al leer temperatura Outdoor");
     sensorData.setSensorsErrorState(true);
   }
 
-  if (sensorData.getHumidityOutdoor() >= 0)
+  if (sensorData.getHumidityOutdoor() < 0)
   {
-    // Serial.print("  Humedad: ");
-    // Serial.print(sensorData.getHumidityOutdoor());
-    // Serial.println(" %");
-    remoteManager.log("  Humedad Outdoor: " + String(sensorData.getHumidityOutdoor()) + " %");
-  }
-  else
-  {
-    // Serial.println("  Error al leer humedad");
-    remoteManager.log("  Error al leer humedad Outdoor");
+    LOG_W(LogMod::SENS, "  Error al leer humedad Outdoor");
     sensorData.setSensorsErrorState(true);
-
   }
-
-  // Serial.println("----------------------------------");
-  remoteManager.log("----------------------------------");
 }
 
 void stopLuxSensors()
 {
   Wire.end();
   // Serial.println("I2C detenido");
-  remoteManager.log("I2C detenido");
+  LOG_I(LogMod::SENS, "I2C detenido");
 }
 
 void updateData()
@@ -369,18 +365,64 @@ void updateData()
   static int update_time = 5000;
   static unsigned long int current_time = millis() + update_time;
 
+  static uint32_t seq = 0;
+
   if (millis() - current_time >= update_time)
   {
     readLuxSensors();
     readDHTSensors();
+
+    // Una sola muestra inmutable que se reparte a todos los sinks
+    TelemetryRecord rec{};
+    rec.seq      = seq++;
+    rec.uptimeMs = millis();
+    rec.epoch    = (int64_t)timeManager.getRawTime();
     String timestamp = timeManager.getDateTime();
-    // logger.logSensorData(timestamp);
-    // Serial.println("Fecha y hora: " + timestamp);
-    remoteManager.log("Fecha y hora: " + timestamp);
+    strncpy(rec.timestamp, timestamp.c_str(), sizeof(rec.timestamp) - 1);
+    rec.temperatureIndoor  = sensorData.getTemperatureIndoor();
+    rec.humidityIndoor     = sensorData.getHumidityIndoor();
+    rec.temperatureOutdoor = sensorData.getTemperatureOutdoor();
+    rec.humidityOutdoor    = sensorData.getHumidityOutdoor();
+    rec.lux1 = sensorData.getLux1();
+    rec.lux2 = sensorData.getLux2();
+    rec.lux3 = sensorData.getLux3();
+    rec.sensorsError = sensorData.getSensorsErrorState();
+
+    pipeline.publish(rec);
     current_time = millis();
   }
 }
 
+void setupPipeline()
+{
+  // Ubidots/ThingsBoard/LCD sólo necesitan la última muestra; Telnet tolera ráfagas
+  pipeline.addSink(&ubidots, 1, DropPolicy::DROP_OLDEST);
+  if (TB_TOKEN[0] != '\0') pipeline.addSink(&thingsboard, 1, DropPolicy::DROP_OLDEST);
+  pipeline.addSink(&telnetSink, 4, DropPolicy::DROP_OLDEST);
+  pipeline.addSink(&lcdSink, 1, DropPolicy::DROP_OLDEST);
+  // SD conserva el histórico pendiente: descarta lo nuevo si la tarjeta no da abasto
+  // (logger.setSeriesBatching(60) => bloques comprimidos en /datalog.gor)
+  // pipeline.addSink(&logger, 16, DropPolicy::DROP_NEWEST);
+}
+
+void logPipelineStats()
+{
+  static unsigned long lastStats = 0;
+  const unsigned long STATS_MS = 60000;
+  if (millis() - lastStats < STATS_MS) return;
+  lastStats = millis();
+
+  const float mins = millis() / 60000.0f;
+  for (uint8_t i = 0; i < pipeline.sinkCount(); ++i)
+  {
+    const SinkStats* st = pipeline.stats(i);
+    LOG_I(LogMod::DATA, "[PIPE] %-11s ok=%lu drop=%lu repl=%lu fail=%lu q=%u/%u %.2f/min",
+          pipeline.sinkName(i), (unsigned long)st->delivered, (unsigned long)st->dropped,
+          (unsigned long)st->superseded, (unsigned long)st->failed, pipeline.depth(i), st->maxDepth,
+          mins > 0 ? st->delivered / mins : 0.0f);
+  }
+}
+
 void LEDDebug()
 {
   debugLeds.update();
@@ -429,36 +471,41 @@ void renderPageSimple(int page) {
   // Datos fijos (nombre, valor, unidad)
    struct Row { String name; String value; String unit; };
 
+  // Última muestra entregada al LCD por el pipeline ("--" hasta la primera)
+  const TelemetryRecord& rec = lcdSink.last();
+  const bool hasData = lcdSink.hasData();
+  auto val = [hasData](float v) { return hasData ? String(v) : String("--"); };
+
   // Define pantallas aquí (cada case muestra 1 ó 2 filas simples)
   switch (page) {
     case 0: { // TSL
       lcd.clear();
       lcd.centerPrint(0, "TSL2561");
-      lcd.centerPrint(1, String(sensorData.getLux1()) + String(" lux"));
+      lcd.centerPrint(1, val(rec.lux1) + String(" lux"));
     } break;
 
     case 1: { // VEML
       lcd.clear();
       lcd.centerPrint(0, "VEML7700");
-      lcd.centerPrint(1, String(sensorData.getLux2()) + String(" lux"));
+      lcd.centerPrint(1, val(rec.lux2) + String(" lux"));
     } break;
 
     case 2: { // BH
       lcd.clear();
       lcd.centerPrint(0, "BH1750");
-      lcd.centerPrint(1, String(sensorData.getLux3()) + String(" lux"));
+      lcd.centerPrint(1, val(rec.lux3) + String(" lux"));
     } break;
 
     case 3: { // Temp Outdoor
       lcd.clear();
       lcd.centerPrint(0, "DHT22 - Temp");
-      lcd.centerPrint(1, String(sensorData.getTemperatureOutdoor()) + (char)223 + String("C"));
+      lcd.centerPrint(1, val(rec.temperatureOutdoor) + (char)223 + String("C"));
     } break;
 
     case 4: { // Hum Outdoor
       lcd.clear();
       lcd.centerPrint(0, "DHT22 - Hum");
-      lcd.centerPrint(1, String(sensorData.getHumidityOutdoor()) + String("%"));
+      lcd.centerPrint(1, val(rec.humidityOutdoor) + String("%"));
     } break;
 
     case 5: { // Date
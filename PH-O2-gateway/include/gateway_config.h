@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+
+// ===== Valores por defecto del gateway (todos ajustables por línea de comandos) =====
+
+#define GW_DEFAULT_BROKER_HOST   "127.0.0.1"
+#define GW_DEFAULT_BROKER_PORT   1883
+#define GW_DEFAULT_CLIENT_ID     "ph-o2-gateway"
+
+// API de gateway de ThingsBoard: {"<dispositivo>":[{"ts":..,"values":{..}}], ...}
+#define GW_DEFAULT_TOPIC         "v1/gateway/telemetry"
+
+static constexpr uint32_t GW_DEFAULT_BAUD        = 115200;
+static constexpr uint32_t GW_DEFAULT_PERIOD_MS   = 2000;
+static constexpr uint32_t GW_DEFAULT_TIMEOUT_MS  = 1000;
+static constexpr uint8_t  GW_DEFAULT_DEPTH       = 2;
+static constexpr uint32_t GW_DEFAULT_BATCH_MS    = 1000;
+static constexpr size_t   GW_MAX_PAYLOAD         = 64 * 1024;  // se parte el lote si lo supera
+static constexpr uint32_t GW_STATS_EVERY_S       = 10;
+static constexpr uint32_t GW_SIM_AUTO_EVERY_S    = 60;         // en --sim, pide auto_measure
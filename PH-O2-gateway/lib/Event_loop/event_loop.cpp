@@ -0,0 +1,60 @@
+#include "event_loop.h"
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+uint64_t monotonicMs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)(ts.tv_nsec / 1000000L);
+}
+
+uint64_t wallClockMs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)(ts.tv_nsec / 1000000L);
+}
+
+EventLoop::~EventLoop() {
+  if (epfd_ >= 0) ::close(epfd_);
+}
+
+bool EventLoop::begin() {
+  if (epfd_ >= 0) return true;
+  epfd_ = epoll_create1(EPOLL_CLOEXEC);
+  return epfd_ >= 0;
+}
+
+bool EventLoop::add(int fd, uint32_t events, EventHandler* h) {
+  struct epoll_event ev = {};
+  ev.events = events;
+  ev.data.ptr = h;
+  if (epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) != 0) return false;
+  watched_++;
+  return true;
+}
+
+bool EventLoop::modify(int fd, uint32_t events, EventHandler* h) {
+  struct epoll_event ev = {};
+  ev.events = events;
+  ev.data.ptr = h;
+  return epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EventLoop::remove(int fd) {
+  if (epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr) == 0 && watched_ > 0) watched_--;
+}
+
+int EventLoop::runOnce(int timeoutMs) {
+  struct epoll_event evs[kMaxEvents];
+  int n = epoll_wait(epfd_, evs, kMaxEvents, timeoutMs);
+  if (n < 0) return (errno == EINTR) ? 0 : -1;
+
+  for (int i = 0; i < n; ++i) {
+    EventHandler* h = static_cast<EventHandler*>(evs[i].data.ptr);
+    if (h) h->onEvents(evs[i].events);
+  }
+  return n;
+}
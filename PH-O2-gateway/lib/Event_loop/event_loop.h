@@ -0,0 +1,41 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Reloj monotónico en ms (timeouts / periodos) y reloj de pared en ms (ts de telemetría)
+uint64_t monotonicMs();
+uint64_t wallClockMs();
+
+// Receptor de eventos de un fd registrado en el EventLoop
+class EventHandler {
+public:
+  virtual ~EventHandler() {}
+  virtual void onEvents(uint32_t events) = 0;   // máscara EPOLLIN/EPOLLOUT/EPOLLHUP/EPOLLERR
+};
+
+// Envoltorio mínimo de epoll (level-triggered).
+// Los temporizadores se resuelven afuera: cada componente tiene su tick(now)
+// y el bucle principal llama runOnce() con el timeout del próximo vencimiento.
+class EventLoop {
+public:
+  EventLoop() = default;
+  ~EventLoop();
+  EventLoop(const EventLoop&) = delete;
+  EventLoop& operator=(const EventLoop&) = delete;
+
+  bool begin();
+
+  bool add(int fd, uint32_t events, EventHandler* h);
+  bool modify(int fd, uint32_t events, EventHandler* h);
+  void remove(int fd);
+
+  // Espera hasta timeoutMs y despacha. Retorna nº de eventos (0 = timeout), -1 = error.
+  int runOnce(int timeoutMs);
+
+  size_t watched() const { return watched_; }
+
+private:
+  static constexpr int kMaxEvents = 256;
+  int    epfd_ = -1;
+  size_t watched_ = 0;
+};
@@ -0,0 +1,252 @@
+#include "mqtt_client.h"
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+void MqttClient::configure(const std::string& host, uint16_t port, const std::string& clientId,
+                           const std::string& user, uint16_t keepAliveS, size_t maxPending) {
+  host_ = host;
+  port_ = port;
+  clientId_ = clientId;
+  user_ = user;
+  keepAliveS_ = keepAliveS ? keepAliveS : 30;
+  maxPending_ = maxPending;
+}
+
+bool MqttClient::begin(EventLoop& loop) {
+  loop_ = &loop;
+  startConnect_(monotonicMs());
+  return state_ != State::DISCONNECTED;
+}
+
+// ================== Conexión ==================
+void MqttClient::startConnect_(uint64_t now) {
+  retryAt_ = now + kRetryMs;
+
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* res = nullptr;
+  char portStr[8];
+  snprintf(portStr, sizeof(portStr), "%u", (unsigned)port_);
+  if (getaddrinfo(host_.c_str(), portStr, &hints, &res) != 0 || !res) {
+    fprintf(stderr, "[MQTT] no se pudo resolver %s\n", host_.c_str());
+    return;
+  }
+
+  fd_ = socket(res->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd_ < 0) { freeaddrinfo(res); return; }
+
+  int one = 1;
+  setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  int rc = ::connect(fd_, res->ai_addr, res->ai_addrlen);
+  freeaddrinfo(res);
+  if (rc != 0 && errno != EINPROGRESS) {
+    ::close(fd_);
+    fd_ = -1;
+    return;
+  }
+
+  out_.clear();
+  in_.clear();
+  state_ = State::CONNECTING;
+  wantOut_ = true;
+  loop_->add(fd_, EPOLLIN | EPOLLOUT, this);   // EPOLLOUT = connect() terminado
+}
+
+void MqttClient::drop_(uint64_t now, const char* why) {
+  if (fd_ >= 0) {
+    loop_->remove(fd_);
+    ::close(fd_);
+    fd_ = -1;
+  }
+  if (state_ == State::CONNECTED) fprintf(stderr, "[MQTT] desconectado (%s)\n", why);
+  state_ = State::DISCONNECTED;
+  out_.clear();
+  in_.clear();
+  retryAt_ = now + kRetryMs;
+}
+
+void MqttClient::putRemainingLength_(std::string& s, size_t len) {
+  do {
+    uint8_t b = len % 128;
+    len /= 128;
+    if (len > 0) b |= 0x80;
+    s.push_back((char)b);
+  } while (len > 0);
+}
+
+void MqttClient::putString_(std::string& s, const std::string& v) {
+  s.push_back((char)((v.size() >> 8) & 0xFF));
+  s.push_back((char)(v.size() & 0xFF));
+  s += v;
+}
+
+void MqttClient::sendConnect_() {
+  std::string body;
+  putString_(body, "MQTT");
+  body.push_back(0x04);                                 // 3.1.1
+  uint8_t flags = 0x02;                                 // clean session
+  if (!user_.empty()) flags |= 0x80;
+  body.push_back((char)flags);
+  body.push_back((char)(keepAliveS_ >> 8));
+  body.push_back((char)(keepAliveS_ & 0xFF));
+  putString_(body, clientId_);
+  if (!user_.empty()) putString_(body, user_);
+
+  std::string pkt;
+  pkt.push_back((char)0x10);
+  putRemainingLength_(pkt, body.size());
+  pkt += body;
+  out_ += pkt;
+  state_ = State::WAIT_CONNACK;
+  flush_();
+}
+
+// ================== Publicación ==================
+bool MqttClient::publish(const std::string& topic, const std::string& payload) {
+  if (state_ != State::CONNECTED || out_.size() > maxPending_) {
+    stats_.dropped++;
+    return false;
+  }
+
+  size_t rl = 2 + topic.size() + payload.size();
+  out_.push_back((char)0x30);                           // PUBLISH QoS0
+  putRemainingLength_(out_, rl);
+  putString_(out_, topic);
+  out_ += payload;
+  stats_.published++;
+  if (out_.size() > stats_.maxPending) stats_.maxPending = out_.size();
+  flush_();
+  return true;
+}
+
+void MqttClient::flush_() {
+  if (fd_ < 0 || state_ == State::CONNECTING) return;
+
+  while (!out_.empty()) {
+    ssize_t n = ::send(fd_, out_.data(), out_.size(), MSG_NOSIGNAL);
+    if (n > 0) {
+      out_.erase(0, (size_t)n);
+      stats_.bytesOut += (unsigned long long)n;
+      continue;
+    }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    drop_(monotonicMs(), "send");
+    return;
+  }
+
+  bool want = !out_.empty();
+  if (want != wantOut_) {
+    loop_->modify(fd_, want ? (EPOLLIN | EPOLLOUT) : EPOLLIN, this);
+    wantOut_ = want;
+  }
+}
+
+// ================== Eventos ==================
+void MqttClient::onEvents(uint32_t events) {
+  if (fd_ < 0) return;
+  uint64_t now = monotonicMs();
+
+  if (state_ == State::CONNECTING) {
+    if (!(events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) return;
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err != 0) { drop_(now, "connect"); return; }
+    lastRx_ = now;
+    state_ = State::WAIT_CONNACK;
+    sendConnect_();
+    return;
+  }
+
+  if (events & EPOLLIN) {
+    char buf[1024];
+    for (;;) {
+      ssize_t n = ::recv(fd_, buf, sizeof(buf), 0);
+      if (n > 0) { in_.append(buf, (size_t)n); lastRx_ = now; continue; }
+      if (n < 0 && errno == EINTR) continue;
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+      drop_(now, n == 0 ? "cerrado por el broker" : "recv");
+      return;
+    }
+    parseIn_();
+    if (fd_ < 0) return;
+  }
+
+  if (events & (EPOLLHUP | EPOLLERR)) { drop_(now, "hup"); return; }
+  if (events & EPOLLOUT) flush_();
+}
+
+void MqttClient::parseIn_() {
+  for (;;) {
+    if (in_.size() < 2) return;
+
+    // Remaining length (1..4 bytes)
+    size_t rl = 0, mult = 1, i = 1;
+    for (;;) {
+      if (i >= in_.size()) return;
+      if (i > 4) { drop_(monotonicMs(), "trama inválida"); return; }
+      uint8_t b = (uint8_t)in_[i++];
+      rl += (b & 0x7F) * mult;
+      mult *= 128;
+      if (!(b & 0x80)) break;
+    }
+    if (in_.size() < i + rl) return;
+
+    uint8_t type = (uint8_t)in_[0] >> 4;
+    if (type == 2) {                                    // CONNACK
+      uint8_t rc = (rl >= 2) ? (uint8_t)in_[i + 1] : 0xFF;
+      if (rc != 0) {
+        fprintf(stderr, "[MQTT] CONNACK rc=%u\n", (unsigned)rc);
+        drop_(monotonicMs(), "connack");
+        return;
+      }
+      state_ = State::CONNECTED;
+      lastPing_ = monotonicMs();
+      stats_.reconnects++;
+      fprintf(stderr, "[MQTT] conectado a %s:%u\n", host_.c_str(), (unsigned)port_);
+    }
+    // PINGRESP (13) y el resto: solo cuentan como actividad
+    in_.erase(0, i + rl);
+  }
+}
+
+void MqttClient::tick(uint64_t now) {
+  if (fd_ < 0) {
+    if (loop_ && now >= retryAt_) startConnect_(now);
+    return;
+  }
+
+  uint64_t ka = (uint64_t)keepAliveS_ * 1000ULL;
+  if (state_ != State::CONNECTED) {
+    if (now >= retryAt_ + ka) drop_(now, "timeout de conexión");
+    return;
+  }
+  if (now - lastRx_ > ka + ka / 2) { drop_(now, "keepalive"); return; }
+  // QoS0 no genera respuestas: el PINGREQ periódico es lo que mantiene vivo lastRx_
+  if (now - lastPing_ >= ka / 2) {
+    lastPing_ = now;
+    out_.push_back((char)0xC0);                         // PINGREQ
+    out_.push_back((char)0x00);
+    flush_();
+  }
+}
+
+uint64_t MqttClient::nextDeadline() const {
+  if (fd_ < 0) return retryAt_;
+  uint64_t ka = (uint64_t)keepAliveS_ * 1000ULL;
+  if (state_ != State::CONNECTED) return retryAt_ + ka;
+  uint64_t dead = lastRx_ + ka + ka / 2;
+  uint64_t ping = lastPing_ + ka / 2;
+  return ping < dead ? ping : dead;
+}
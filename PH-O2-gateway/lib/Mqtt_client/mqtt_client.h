@@ -0,0 +1,73 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include "event_loop.h"
+
+struct MqttStats {
+  unsigned long published = 0;     // PUBLISH encolados en el socket
+  unsigned long dropped = 0;       // rechazados por desconexión o backpressure
+  unsigned long reconnects = 0;
+  unsigned long long bytesOut = 0;
+  size_t        maxPending = 0;    // máximo de bytes sin escribir observado
+};
+
+/**
+ * Cliente MQTT 3.1.1 mínimo, no bloqueante, integrado al EventLoop.
+ * - Solo lo que necesita el gateway: CONNECT (usuario = token), PUBLISH QoS0,
+ *   PINGREQ/PINGRESP y reconexión con reintento.
+ * - Backpressure: publish() rechaza si hay más de maxPending bytes sin salir
+ *   al socket (broker lento); el llamador decide si descarta o reintenta.
+ * - La resolución DNS (getaddrinfo) es bloqueante: usar IP o /etc/hosts.
+ */
+class MqttClient : public EventHandler {
+public:
+  void configure(const std::string& host, uint16_t port, const std::string& clientId,
+                 const std::string& user, uint16_t keepAliveS = 30,
+                 size_t maxPending = 1u << 20);
+
+  bool begin(EventLoop& loop);
+  void tick(uint64_t now);
+  void onEvents(uint32_t events) override;
+
+  bool connected() const { return state_ == State::CONNECTED; }
+  bool publish(const std::string& topic, const std::string& payload);
+
+  size_t pending() const { return out_.size(); }
+  uint64_t nextDeadline() const;
+  const MqttStats& stats() const { return stats_; }
+
+private:
+  enum class State : uint8_t { DISCONNECTED, CONNECTING, WAIT_CONNACK, CONNECTED };
+
+  static constexpr uint32_t kRetryMs = 3000;
+
+  std::string host_;
+  uint16_t    port_ = 1883;
+  std::string clientId_;
+  std::string user_;
+  uint16_t    keepAliveS_ = 30;
+  size_t      maxPending_ = 1u << 20;
+
+  EventLoop* loop_ = nullptr;
+  int        fd_ = -1;
+  State      state_ = State::DISCONNECTED;
+  bool       wantOut_ = false;
+
+  uint64_t retryAt_ = 0;
+  uint64_t lastPing_ = 0;
+  uint64_t lastRx_ = 0;
+
+  std::string out_;
+  std::string in_;
+
+  MqttStats stats_;
+
+  void startConnect_(uint64_t now);
+  void drop_(uint64_t now, const char* why);
+  void sendConnect_();
+  void flush_();
+  void parseIn_();
+  static void putRemainingLength_(std::string& s, size_t len);
+  static void putString_(std::string& s, const std::string& v);
+};
@@ -0,0 +1,97 @@
+#include "ndjson.h"
+#include <string.h>
+
+namespace Ndjson {
+
+static size_t skipWs(const std::string& s, size_t i) {
+  while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r' || s[i] == '\n')) i++;
+  return i;
+}
+
+// Fin (exclusivo) de un string que empieza en s[i] == '"'; npos si no cierra
+static size_t endOfString(const std::string& s, size_t i) {
+  for (size_t j = i + 1; j < s.size(); ++j) {
+    if (s[j] == '\\') { j++; continue; }
+    if (s[j] == '"') return j + 1;
+  }
+  return std::string::npos;
+}
+
+// Fin (exclusivo) de un objeto/arreglo balanceado que empieza en s[i]
+static size_t endOfContainer(const std::string& s, size_t i) {
+  int depth = 0;
+  for (size_t j = i; j < s.size(); ++j) {
+    char c = s[j];
+    if (c == '"') {
+      size_t e = endOfString(s, j);
+      if (e == std::string::npos) return e;
+      j = e - 1;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if (c == '}' || c == ']') {
+      if (--depth == 0) return j + 1;
+    }
+  }
+  return std::string::npos;
+}
+
+// Posición del primer carácter del valor de "key", o npos
+static size_t findValue(const std::string& s, const char* key) {
+  std::string pat;
+  pat.reserve(strlen(key) + 2);
+  pat += '"'; pat += key; pat += '"';
+
+  size_t pos = 0;
+  while ((pos = s.find(pat, pos)) != std::string::npos) {
+    size_t i = skipWs(s, pos + pat.size());
+    if (i < s.size() && s[i] == ':') return skipWs(s, i + 1);
+    pos += pat.size();
+  }
+  return std::string::npos;
+}
+
+int getBool(const std::string& s, const char* key) {
+  size_t i = findValue(s, key);
+  if (i == std::string::npos) return -1;
+  if (s.compare(i, 4, "true") == 0)  return 1;
+  if (s.compare(i, 5, "false") == 0) return 0;
+  return -1;
+}
+
+bool getString(const std::string& s, const char* key, std::string& out) {
+  size_t i = findValue(s, key);
+  if (i == std::string::npos || s[i] != '"') return false;
+  size_t e = endOfString(s, i);
+  if (e == std::string::npos) return false;
+  out.assign(s, i + 1, e - i - 2);
+  return true;
+}
+
+bool getRaw(const std::string& s, const char* key, size_t& start, size_t& len) {
+  size_t i = findValue(s, key);
+  if (i == std::string::npos || i >= s.size()) return false;
+
+  size_t e;
+  if (s[i] == '{' || s[i] == '[') {
+    e = endOfContainer(s, i);
+  } else if (s[i] == '"') {
+    e = endOfString(s, i);
+  } else {
+    e = i;
+    while (e < s.size() && s[e] != ',' && s[e] != '}' && s[e] != ']') e++;
+    while (e > i && (s[e - 1] == ' ' || s[e - 1] == '\t')) e--;
+  }
+  if (e == std::string::npos || e == i) return false;
+  start = i;
+  len = e - i;
+  return true;
+}
+
+bool looksLikeObject(const std::string& s) {
+  size_t i = skipWs(s, 0);
+  if (i >= s.size() || s[i] != '{') return false;
+  size_t e = endOfContainer(s, i);
+  return e != std::string::npos && skipWs(s, e) == s.size();
+}
+
+} // namespace Ndjson
@@ -0,0 +1,58 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+
+namespace Ndjson {
+
+// Acumula bytes y entrega líneas completas (sin '\r'/'\n').
+// Una línea más larga que maxLine se descarta entera (como UARTManager::loop()).
+class LineFramer {
+public:
+  explicit LineFramer(size_t maxLine = 1024) : maxLine_(maxLine) {}
+
+  template <typename F>
+  void feed(const char* data, size_t n, F&& onLine) {
+    for (size_t i = 0; i < n; ++i) {
+      char c = data[i];
+      if (c == '\n') {
+        if (discarding_) { discarding_ = false; buf_.clear(); continue; }
+        if (!buf_.empty()) onLine(buf_);
+        buf_.clear();
+      } else if (c != '\r' && !discarding_) {
+        buf_.push_back(c);
+        if (buf_.size() > maxLine_) {
+          buf_.clear();
+          discarding_ = true;
+          overflows_++;
+        }
+      }
+    }
+  }
+
+  void reset() { buf_.clear(); discarding_ = false; }
+  unsigned long overflows() const { return overflows_; }
+
+private:
+  std::string   buf_;
+  size_t        maxLine_;
+  bool          discarding_ = false;
+  unsigned long overflows_ = 0;
+};
+
+// ====== Lectura puntual de campos (sin construir árbol) ======
+// Suficiente para el protocolo PH-O2: se busca "clave": y se toma el valor.
+// No distingue niveles de anidamiento: usar con claves únicas en la línea.
+
+// Retorna 1/0 si "key" es true/false, -1 si no está o no es bool.
+int  getBool(const std::string& s, const char* key);
+
+// Copia el string de "key" (sin escapes complejos). false si no está o no es string.
+bool getString(const std::string& s, const char* key, std::string& out);
+
+// Ubica el valor crudo de "key" (objeto/arreglo balanceado, string o escalar).
+bool getRaw(const std::string& s, const char* key, size_t& start, size_t& len);
+
+// true si la línea parece un objeto JSON completo ('{' ... '}' balanceado)
+bool looksLikeObject(const std::string& s);
+
+} // namespace Ndjson
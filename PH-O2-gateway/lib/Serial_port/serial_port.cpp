@@ -0,0 +1,79 @@
+#include "serial_port.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace SerialPort {
+
+static speed_t toSpeed(uint32_t baud) {
+  switch (baud) {
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default:     return B115200;
+  }
+}
+
+static bool setRaw(int fd, uint32_t baud) {
+  struct termios tio;
+  if (tcgetattr(fd, &tio) != 0) return false;
+  cfmakeraw(&tio);
+  tio.c_cflag |= (CLOCAL | CREAD);
+  tio.c_cflag &= ~CRTSCTS;
+  // VMIN=1: con O_NONBLOCK un read() sin datos da EAGAIN; con VMIN=0 daría 0
+  // y se confundiría con desconexión
+  tio.c_cc[VMIN]  = 1;
+  tio.c_cc[VTIME] = 0;
+  cfsetispeed(&tio, toSpeed(baud));
+  cfsetospeed(&tio, toSpeed(baud));
+  return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+int openRaw(const char* path, uint32_t baud) {
+  int fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) return -1;
+  if (!setRaw(fd, baud)) {
+    int e = errno;
+    ::close(fd);
+    errno = e;
+    return -1;
+  }
+  tcflush(fd, TCIOFLUSH);   // descarta basura previa a la apertura
+  return fd;
+}
+
+bool openPty(int& masterFd, int& holdFd, std::string& slavePath) {
+  masterFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (masterFd < 0) return false;
+  if (grantpt(masterFd) != 0 || unlockpt(masterFd) != 0) {
+    ::close(masterFd);
+    masterFd = -1;
+    return false;
+  }
+
+  char name[128];
+  if (ptsname_r(masterFd, name, sizeof(name)) != 0) {
+    ::close(masterFd);
+    masterFd = -1;
+    return false;
+  }
+  slavePath = name;
+
+  // Sin eco ni traducción de fin de línea desde el primer byte
+  holdFd = openRaw(name, 115200);
+  if (holdFd < 0) {
+    ::close(masterFd);
+    masterFd = -1;
+    return false;
+  }
+  return true;
+}
+
+} // namespace SerialPort
@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+namespace SerialPort {
+
+// Abre un tty en modo raw 8N1, no bloqueante. Retorna fd o -1 (errno conservado).
+int openRaw(const char* path, uint32_t baud);
+
+// Crea un par pty (para simular un esclavo PH-O2).
+//  - masterFd: lado del simulador (no bloqueante)
+//  - holdFd:   el simulador mantiene abierto el lado esclavo para que el
+//              master no reciba HUP/EIO mientras el gateway reabre el puerto
+//  - slavePath: ruta /dev/pts/N que abre el gateway
+bool openPty(int& masterFd, int& holdFd, std::string& slavePath);
+
+} // namespace SerialPort
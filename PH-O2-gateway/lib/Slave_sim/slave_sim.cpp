@@ -0,0 +1,179 @@
+#include "slave_sim.h"
+#include "serial_port.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+SlaveSim::SlaveSim(uint32_t seed, const SlaveSimConfig& cfg)
+  : cfg_(cfg), rng_(seed ? seed : 1u) {
+  for (int i = 0; i < 4; ++i) { samplePh_[i] = NAN; sampleO2_[i] = NAN; }
+  if (cfg_.serviceMs == 0) cfg_.serviceMs = 1;
+}
+
+SlaveSim::~SlaveSim() {
+  if (masterFd_ >= 0) {
+    if (loop_) loop_->remove(masterFd_);
+    ::close(masterFd_);
+  }
+  if (holdFd_ >= 0) ::close(holdFd_);
+}
+
+bool SlaveSim::open(EventLoop& loop) {
+  loop_ = &loop;
+  if (!SerialPort::openPty(masterFd_, holdFd_, slavePath_)) return false;
+  if (!loop.add(masterFd_, EPOLLIN, this)) return false;
+  // Fase aleatoria: cada esclavo atiende su UART en un instante distinto
+  nextService_ = monotonicMs() + rand_() % cfg_.serviceMs;
+  return true;
+}
+
+uint32_t SlaveSim::rand_() {
+  // xorshift32: determinista por semilla
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 17;
+  rng_ ^= rng_ << 5;
+  return rng_;
+}
+
+float SlaveSim::randRange_(float lo, float hi) {
+  return lo + (hi - lo) * (float)(rand_() % 10000) / 10000.0f;
+}
+
+// ================== E/S ==================
+void SlaveSim::onEvents(uint32_t events) {
+  if (events & EPOLLIN) {
+    char buf[512];
+    for (;;) {
+      ssize_t n = ::read(masterFd_, buf, sizeof(buf));
+      if (n > 0) {
+        // Como el firmware: solo se acumula; se procesa en el próximo servicio
+        rx_.feed(buf, (size_t)n, [this](const std::string& line) { lines_.push_back(line); });
+        continue;
+      }
+      if (n < 0 && errno == EINTR) continue;
+      break;   // EAGAIN (o EIO transitorio: holdFd_ evita el HUP)
+    }
+  }
+  if (events & EPOLLOUT) flush_();
+}
+
+void SlaveSim::flush_() {
+  while (!out_.empty()) {
+    ssize_t n = ::write(masterFd_, out_.data(), out_.size());
+    if (n > 0) { out_.erase(0, (size_t)n); continue; }
+    if (n < 0 && errno == EINTR) continue;
+    break;
+  }
+  bool want = !out_.empty();
+  if (want != wantOut_) {
+    loop_->modify(masterFd_, want ? (EPOLLIN | EPOLLOUT) : EPOLLIN, this);
+    wantOut_ = want;
+  }
+}
+
+// ================== Simulación ==================
+void SlaveSim::tick(uint64_t now) {
+  if (now < nextService_) return;
+  nextService_ += cfg_.serviceMs;
+  if (nextService_ <= now) nextService_ = now + cfg_.serviceMs;
+
+  // Equivalente a MenuDemoTick: toma el pedido y corre la receta
+  if (autoReq_ && !autoRunning_) {
+    autoReq_ = false;
+    autoRunning_ = true;
+    autoEnd_ = now + cfg_.autoMs;
+  }
+  if (autoRunning_ && now >= autoEnd_) {
+    autoRunning_ = false;
+    tempC_ = randRange_(22.0f, 27.0f);
+    for (int i = 0; i < 4; ++i) {
+      samplePh_[i] = randRange_(6.2f, 7.8f);
+      sampleO2_[i] = randRange_(5.0f, 9.0f);
+    }
+    ph_ = samplePh_[3];
+    hasLast_ = true;
+  }
+  // Deriva lenta de niveles (tanques que se vacían de vez en cuando)
+  if (rand_() % 500 == 0) h2o_ = !h2o_;
+  if (rand_() % 700 == 0) kcl_ = !kcl_;
+
+  while (!lines_.empty()) {
+    std::string line = std::move(lines_.front());
+    lines_.pop_front();
+    if (cfg_.dropPct && (rand_() % 100) < cfg_.dropPct) continue;
+    respond_(line);
+  }
+  flush_();
+}
+
+static void appendFloatOrNull(std::string& s, float v) {
+  char b[24];
+  if (isfinite(v)) snprintf(b, sizeof(b), "%.2f", (double)v);
+  else snprintf(b, sizeof(b), "null");
+  s += b;
+}
+
+void SlaveSim::appendLevels_(std::string& s) const {
+  s += "\"level_sensors\":{\"h2o\":";
+  s += h2o_ ? "true" : "false";
+  s += ",\"kcl\":";
+  s += kcl_ ? "true" : "false";
+  s += "}";
+}
+
+void SlaveSim::appendSamples_(std::string& s) const {
+  s += "\"samples\":[";
+  for (int i = 0; i < 4; ++i) {
+    if (i) s += ",";
+    s += "{\"id\":";
+    s += (char)('1' + i);
+    s += ",\"ph_val\":";
+    appendFloatOrNull(s, samplePh_[i]);
+    s += ",\"o2_val\":";
+    appendFloatOrNull(s, sampleO2_[i]);
+    s += "}";
+  }
+  s += "]";
+}
+
+void SlaveSim::respond_(const std::string& line) {
+  handled_++;
+
+  std::string op;
+  if (!Ndjson::looksLikeObject(line)) { out_ += "{\"ok\":false,\"error\":\"BAD_JSON\"}\r\n"; return; }
+  Ndjson::getString(line, "op", op);
+
+  if (op == "get_status") {
+    std::string s = "{\"ok\":true,\"data\":{";
+    appendLevels_(s);
+    s += ",\"auto_running\":";
+    s += autoRunning_ ? "true" : "false";
+    s += ",\"auto_req\":";
+    s += autoReq_ ? "true" : "false";
+    s += ",";
+    appendSamples_(s);
+    s += "}}\r\n";
+    out_ += s;
+  } else if (op == "get_last") {
+    if (!hasLast_) { out_ += "{\"ok\":false,\"error\":\"NO_DATA\"}\r\n"; return; }
+    std::string s = "{\"ok\":true,\"data\":{\"ph\":";
+    appendFloatOrNull(s, ph_);
+    s += ",\"tempC\":";
+    appendFloatOrNull(s, tempC_);
+    s += ",";
+    appendLevels_(s);
+    s += ",";
+    appendSamples_(s);
+    s += ",\"result\":\"OK\"}}\r\n";
+    out_ += s;
+  } else if (op == "auto_measure") {
+    if (autoRunning_) { out_ += "{\"ok\":false,\"error\":\"BUSY\"}\r\n"; return; }
+    autoReq_ = true;
+    out_ += "{\"ok\":true}\r\n";
+  } else {
+    out_ += "{\"ok\":false,\"error\":\"BAD_OP\"}\r\n";
+  }
+}
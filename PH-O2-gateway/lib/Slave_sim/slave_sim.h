@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include "event_loop.h"
+#include "ndjson.h"
+
+struct SlaveSimConfig {
+  uint32_t serviceMs = 200;     // cadencia de uart2.loop() en taskCore1 del firmware
+  uint32_t autoMs    = 20000;   // duración simulada de una medición automática
+  uint8_t  dropPct   = 0;       // % de comandos sin respuesta (para ejercitar timeouts)
+};
+
+/**
+ * Esclavo PH-O2 simulado sobre un pty (harness del gateway).
+ * Responde get_status / get_last / auto_measure con el mismo formato que
+ * UARTManager (PH-O2-v2_firmware/lib/UART_manager), atendiendo la entrada
+ * solo cada serviceMs como el firmware real.
+ */
+class SlaveSim : public EventHandler {
+public:
+  SlaveSim(uint32_t seed, const SlaveSimConfig& cfg);
+  ~SlaveSim() override;
+
+  bool open(EventLoop& loop);                 // crea el pty y lo registra
+  const std::string& slavePath() const { return slavePath_; }
+
+  void tick(uint64_t now);
+  void onEvents(uint32_t events) override;
+  uint64_t nextDeadline() const { return nextService_; }
+
+  unsigned long handled() const { return handled_; }
+
+private:
+  SlaveSimConfig cfg_;
+  EventLoop*  loop_ = nullptr;
+  int         masterFd_ = -1;
+  int         holdFd_ = -1;
+  std::string slavePath_;
+  bool        wantOut_ = false;
+
+  Ndjson::LineFramer      rx_;
+  std::deque<std::string> lines_;
+  std::string             out_;
+
+  uint64_t nextService_ = 0;
+  uint32_t rng_;
+
+  // Estado equivalente al de UARTManager
+  bool     h2o_ = true;
+  bool     kcl_ = true;
+  bool     autoRunning_ = false;
+  bool     autoReq_ = false;
+  uint64_t autoEnd_ = 0;
+  bool     hasLast_ = false;
+  float    ph_ = 7.0f;
+  float    tempC_ = 25.0f;
+  float    samplePh_[4];
+  float    sampleO2_[4];
+
+  unsigned long handled_ = 0;
+
+  uint32_t rand_();
+  float    randRange_(float lo, float hi);
+  void     respond_(const std::string& line);
+  void     appendLevels_(std::string& s) const;
+  void     appendSamples_(std::string& s) const;
+  void     flush_();
+};
@@ -0,0 +1,279 @@
+#include "unit_poller.h"
+#include "serial_port.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+UnitPoller::UnitPoller(const std::string& name, const std::string& path, const PollerConfig& cfg)
+  : name_(name), path_(path), cfg_(cfg) {
+  if (cfg_.depth == 0) cfg_.depth = 1;
+}
+
+UnitPoller::~UnitPoller() {
+  if (fd_ >= 0) {
+    if (loop_) loop_->remove(fd_);
+    ::close(fd_);
+  }
+}
+
+bool UnitPoller::open(EventLoop& loop) {
+  loop_ = &loop;
+  uint64_t now = monotonicMs();
+
+  fd_ = SerialPort::openRaw(path_.c_str(), cfg_.baud);
+  if (fd_ < 0) {
+    reopenAt_ = now + cfg_.reopenMs;
+    return false;
+  }
+  if (!loop.add(fd_, EPOLLIN, this)) {
+    ::close(fd_);
+    fd_ = -1;
+    reopenAt_ = now + cfg_.reopenMs;
+    return false;
+  }
+  wantOut_ = false;
+  rx_.reset();
+
+  // Fase pseudoaleatoria por nombre: reparte los ciclos de cientos de puertos
+  uint32_t h = 2166136261u;
+  for (char c : name_) h = (h ^ (uint8_t)c) * 16777619u;
+  nextPoll_ = now + (cfg_.periodMs ? h % cfg_.periodMs : 0);
+  return true;
+}
+
+void UnitPoller::closePort_(uint64_t now) {
+  if (fd_ >= 0) {
+    loop_->remove(fd_);
+    ::close(fd_);
+    fd_ = -1;
+  }
+  toSend_.clear();
+  inflight_.clear();
+  out_.clear();
+  rx_.reset();
+  if (cycleLeft_ > 0) finishCycle_();
+  reopenAt_ = now + cfg_.reopenMs;
+}
+
+// ================== Ciclo de sondeo ==================
+void UnitPoller::startCycle_(uint64_t now) {
+  // Ciclo anterior sin terminar (p.ej. esclavo lento): se cierra con lo que haya
+  if (cycleLeft_ > 0) finishCycle_();
+
+  cycle_ = UnitResult();
+  cycle_.tsMs = wallClockMs();
+  cycleId_++;
+
+  // Lo que el ciclo anterior no llegó a enviar se vuelve a pedir en éste;
+  // un auto_measure pendiente no se pierde
+  for (Op op : toSend_)
+    if (op == Op::AUTO_MEASURE) autoPending_ = true;
+  toSend_.clear();
+
+  if (autoPending_) {
+    toSend_.push_back(Op::AUTO_MEASURE);
+    autoPending_ = false;
+  }
+  toSend_.push_back(Op::GET_STATUS);
+  toSend_.push_back(Op::GET_LAST);
+  cycleLeft_ = (int)toSend_.size();
+  pump_(now);
+}
+
+void UnitPoller::finishCycle_() {
+  cycleLeft_ = 0;
+  if (cycle_.status.empty() && cycle_.last.empty()) return;
+
+  if (results_.size() >= kMaxResults) {
+    results_.pop_front();   // nadie está drenando: se conserva lo más reciente
+    stats_.resultsDropped++;
+  }
+  results_.push_back(std::move(cycle_));
+  cycle_ = UnitResult();
+}
+
+bool UnitPoller::popResult(UnitResult& out) {
+  if (results_.empty()) return false;
+  out = std::move(results_.front());
+  results_.pop_front();
+  return true;
+}
+
+const char* UnitPoller::opLine_(Op op) {
+  switch (op) {
+    case Op::GET_STATUS:   return "{\"op\":\"get_status\"}\n";
+    case Op::GET_LAST:     return "{\"op\":\"get_last\"}\n";
+    case Op::AUTO_MEASURE: return "{\"op\":\"auto_measure\"}\n";
+  }
+  return "";
+}
+
+void UnitPoller::pump_(uint64_t now) {
+  while (!toSend_.empty() && inflight_.size() < cfg_.depth) {
+    Op op = toSend_.front();
+    toSend_.pop_front();
+    out_ += opLine_(op);
+    inflight_.push_back({op, now, cycleId_});
+    stats_.polls++;
+  }
+  flush_();
+}
+
+void UnitPoller::flush_() {
+  if (fd_ < 0) return;
+
+  while (!out_.empty()) {
+    ssize_t n = ::write(fd_, out_.data(), out_.size());
+    if (n > 0) { out_.erase(0, (size_t)n); continue; }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    closePort_(monotonicMs());
+    return;
+  }
+
+  bool want = !out_.empty();
+  if (want != wantOut_) {
+    loop_->modify(fd_, want ? (EPOLLIN | EPOLLOUT) : EPOLLIN, this);
+    wantOut_ = want;
+  }
+}
+
+void UnitPoller::tick(uint64_t now) {
+  if (fd_ < 0) {
+    if (loop_ && now >= reopenAt_) {
+      stats_.reopens++;
+      open(*loop_);
+    }
+    return;
+  }
+
+  // Timeout del más viejo en vuelo: sin ids no hay forma de re-emparejar,
+  // se descarta todo lo pendiente del ciclo
+  if (!inflight_.empty() && now - inflight_.front().sentMs >= cfg_.timeoutMs) {
+    stats_.timeouts++;
+    inflight_.clear();
+    toSend_.clear();
+    finishCycle_();
+  }
+
+  if (now >= nextPoll_) {
+    nextPoll_ += cfg_.periodMs;
+    if (nextPoll_ <= now) nextPoll_ = now + cfg_.periodMs;   // nos atrasamos: no acumular ciclos
+    startCycle_(now);
+  }
+}
+
+uint64_t UnitPoller::nextDeadline() const {
+  if (fd_ < 0) return reopenAt_;
+  uint64_t d = nextPoll_;
+  if (!inflight_.empty()) {
+    uint64_t t = inflight_.front().sentMs + cfg_.timeoutMs;
+    if (t < d) d = t;
+  }
+  return d;
+}
+
+// ================== E/S ==================
+void UnitPoller::onEvents(uint32_t events) {
+  if (fd_ < 0) return;
+
+  if (events & EPOLLIN) {
+    char buf[512];
+    for (;;) {
+      ssize_t n = ::read(fd_, buf, sizeof(buf));
+      if (n > 0) {
+        rx_.feed(buf, (size_t)n, [this](const std::string& line) { onLine_(line); });
+        if (fd_ < 0) return;
+        continue;
+      }
+      if (n < 0 && errno == EINTR) continue;
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+      closePort_(monotonicMs());   // 0 / EIO: puerto desconectado
+      return;
+    }
+  }
+
+  if (events & (EPOLLHUP | EPOLLERR)) {
+    closePort_(monotonicMs());
+    return;
+  }
+
+  if (events & EPOLLOUT) flush_();
+}
+
+// Forma esperada de cada respuesta (ver UARTManager::handle_*):
+//  get_status -> data.auto_running ; get_last -> data.ph ; auto_measure -> sin data
+bool UnitPoller::matches_(Op op, const std::string& line) {
+  if (Ndjson::getBool(line, "ok") == 0) {
+    // NO_DATA solo lo da get_last y BUSY solo auto_measure; BAD_* vale para cualquiera
+    std::string err;
+    Ndjson::getString(line, "error", err);
+    if (err == "NO_DATA") return op == Op::GET_LAST;
+    if (err == "BUSY")    return op == Op::AUTO_MEASURE;
+    return true;
+  }
+  switch (op) {
+    case Op::GET_STATUS:   return line.find("\"auto_running\"") != std::string::npos;
+    case Op::GET_LAST:     return line.find("\"ph\"") != std::string::npos;
+    case Op::AUTO_MEASURE: return line.find("\"data\"") == std::string::npos;
+  }
+  return false;
+}
+
+void UnitPoller::onLine_(const std::string& line) {
+  if (!Ndjson::looksLikeObject(line) || inflight_.empty()) {
+    stats_.badLines++;
+    return;
+  }
+
+  if (!matches_(inflight_.front().op, line)) {
+    if (inflight_.size() > 1 && matches_(inflight_[1].op, line)) {
+      // El esclavo perdió el comando anterior (pipeline): se da por perdido
+      if (inflight_.front().cycle == cycleId_ && cycleLeft_ > 0) cycleLeft_--;
+      inflight_.pop_front();
+      stats_.timeouts++;
+    } else {
+      // Respuesta tardía de un ciclo ya descartado: se ignora
+      stats_.badLines++;
+      return;
+    }
+  }
+  Pending p = inflight_.front();
+  inflight_.pop_front();
+
+  uint64_t now = monotonicMs();
+  uint32_t rtt = (uint32_t)(now - p.sentMs);
+  stats_.replies++;
+  stats_.lastRttMs = rtt;
+  if (rtt > stats_.maxRttMs) stats_.maxRttMs = rtt;
+
+  int ok = Ndjson::getBool(line, "ok");
+  size_t st = 0, len = 0;
+  std::string err;
+
+  if (p.cycle != cycleId_) {
+    // Respuesta de un ciclo ya cerrado: no pertenece a cycle_ ni cuenta para cycleLeft_
+    stats_.lateReplies++;
+    pump_(now);
+    return;
+  }
+
+  switch (p.op) {
+    case Op::GET_STATUS:
+      if (ok == 1 && Ndjson::getRaw(line, "data", st, len)) cycle_.status.assign(line, st, len);
+      else stats_.errors++;
+      break;
+    case Op::GET_LAST:
+      if (ok == 1 && Ndjson::getRaw(line, "data", st, len)) cycle_.last.assign(line, st, len);
+      else if (!(Ndjson::getString(line, "error", err) && err == "NO_DATA")) stats_.errors++;
+      break;
+    case Op::AUTO_MEASURE:
+      if (ok != 1 && !(Ndjson::getString(line, "error", err) && err == "BUSY")) stats_.errors++;
+      break;
+  }
+
+  if (cycleLeft_ > 0 && --cycleLeft_ == 0) finishCycle_();
+  pump_(now);
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include "event_loop.h"
+#include "ndjson.h"
+
+struct PollerConfig {
+  uint32_t baud      = 115200;
+  uint32_t periodMs  = 2000;   // un ciclo get_status + get_last por periodo
+  uint32_t timeoutMs = 1000;   // sin respuesta => se descarta lo pendiente
+  uint8_t  depth     = 2;      // comandos en vuelo (pipeline); 1 = pregunta/respuesta
+  uint32_t reopenMs  = 2000;   // reintento de apertura del puerto
+};
+
+// Resultado de un ciclo: objetos "data" crudos tal como los envía el esclavo
+struct UnitResult {
+  uint64_t    tsMs = 0;        // reloj de pared al iniciar el ciclo
+  std::string status;          // data de get_status ("" si falló)
+  std::string last;            // data de get_last   ("" si NO_DATA o falló)
+};
+
+struct UnitStats {
+  unsigned long polls = 0;       // comandos enviados
+  unsigned long replies = 0;     // respuestas emparejadas
+  unsigned long lateReplies = 0; // emparejadas pero de un ciclo ya cerrado (se descartan)
+  unsigned long timeouts = 0;
+  unsigned long errors = 0;      // ok=false inesperado / data ausente
+  unsigned long badLines = 0;    // líneas no JSON o que no corresponden al comando
+  unsigned long reopens = 0;
+  unsigned long resultsDropped = 0;
+  uint32_t      lastRttMs = 0;
+  uint32_t      maxRttMs = 0;
+};
+
+/**
+ * Un esclavo PH-O2 (UARTManager) en un puerto serie/pty.
+ * - El protocolo no tiene ids: las respuestas se emparejan en orden (FIFO)
+ *   y se valida la forma de cada respuesta contra el comando en vuelo.
+ * - Con depth > 1 se envían varios comandos sin esperar (el firmware los
+ *   atiende todos en el mismo uart2.loop(), cada 200 ms).
+ */
+class UnitPoller : public EventHandler {
+public:
+  UnitPoller(const std::string& name, const std::string& path, const PollerConfig& cfg);
+  ~UnitPoller() override;
+
+  bool open(EventLoop& loop);      // false => se reintenta desde tick()
+  void tick(uint64_t now);
+  void onEvents(uint32_t events) override;
+
+  void requestAutoMeasure() { autoPending_ = true; }
+  bool popResult(UnitResult& out);
+
+  uint64_t nextDeadline() const;
+  const std::string& name() const { return name_; }
+  bool isOpen() const { return fd_ >= 0; }
+  const UnitStats& stats() const { return stats_; }
+
+private:
+  enum class Op : uint8_t { GET_STATUS, GET_LAST, AUTO_MEASURE };
+  // cycle: id del ciclo que emitió el comando; una respuesta de un ciclo
+  // anterior (tardía) se empareja para no desalinear el FIFO, pero no se
+  // atribuye al ciclo actual
+  struct Pending { Op op; uint64_t sentMs; uint32_t cycle; };
+
+  static constexpr size_t kMaxResults = 8;
+
+  std::string  name_;
+  std::string  path_;
+  PollerConfig cfg_;
+  EventLoop*   loop_ = nullptr;
+  int          fd_ = -1;
+  bool         wantOut_ = false;
+
+  uint64_t nextPoll_ = 0;
+  uint64_t reopenAt_ = 0;
+  bool     autoPending_ = false;
+
+  Ndjson::LineFramer   rx_;
+  std::string          out_;
+  std::deque<Op>       toSend_;
+  std::deque<Pending>  inflight_;
+  std::deque<UnitResult> results_;
+
+  UnitResult cycle_;
+  uint32_t   cycleId_ = 0;
+  int        cycleLeft_ = 0;   // comandos de ESTE ciclo todavía sin respuesta
+
+  UnitStats stats_;
+
+  void startCycle_(uint64_t now);
+  void finishCycle_();
+  void pump_(uint64_t now);
+  void flush_();
+  void closePort_(uint64_t now);
+  void onLine_(const std::string& line);
+  static bool matches_(Op op, const std::string& line);
+  static const char* opLine_(Op op);
+};
@@ -0,0 +1,334 @@
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gateway_config.h"
+#include "event_loop.h"
+#include "mqtt_client.h"
+#include "slave_sim.h"
+#include "unit_poller.h"
+
+// =====================================================
+// Gateway serie -> MQTT para esclavos PH-O2 (protocolo NDJSON de UARTManager)
+//  - Un solo hilo: epoll sobre todos los puertos + socket MQTT
+//  - Cada unidad se sondea con get_status + get_last en pipeline
+//  - Los resultados se publican en lotes (API de gateway de ThingsBoard)
+//  - --sim N: crea N esclavos simulados en pty dentro del mismo proceso
+// =====================================================
+
+struct Options {
+  std::vector<std::string> ports;
+  unsigned    sim = 0;
+  SlaveSimConfig simCfg;
+  PollerConfig   poll;
+
+  std::string host = GW_DEFAULT_BROKER_HOST;
+  uint16_t    port = GW_DEFAULT_BROKER_PORT;
+  std::string token;
+  std::string topic = GW_DEFAULT_TOPIC;
+  bool        toStdout = false;
+
+  uint32_t batchMs   = GW_DEFAULT_BATCH_MS;
+  uint32_t statsS    = GW_STATS_EVERY_S;
+  int      autoEvery = -1;   // -1 => por defecto según modo
+  uint32_t runS      = 0;    // 0 => hasta SIGINT
+};
+
+static volatile sig_atomic_t g_stop = 0;
+static void onSignal(int) { g_stop = 1; }
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+    "Uso: %s [opciones]\n"
+    "  --port PATH          puerto serie (repetible)\n"
+    "  --ports-file FILE    un puerto por línea\n"
+    "  --sim N              N esclavos simulados en pty\n"
+    "  --sim-drop PCT       %% de comandos que el simulador no responde\n"
+    "  --sim-auto-ms MS     duración de una medición simulada\n"
+    "  --baud B             (115200)\n"
+    "  --period MS          ciclo de sondeo por unidad (%u)\n"
+    "  --timeout MS         timeout por comando (%u)\n"
+    "  --depth N            comandos en vuelo por unidad (%u)\n"
+    "  --broker HOST:PORT   (%s:%u)\n"
+    "  --token TOKEN        token del dispositivo gateway en ThingsBoard\n"
+    "  --topic TOPIC        (%s)\n"
+    "  --stdout             imprime los lotes en vez de publicarlos\n"
+    "  --batch MS           intervalo de publicación (%u)\n"
+    "  --auto-every S       pide auto_measure cada S s (0 = nunca)\n"
+    "  --stats S            resumen cada S s (%u)\n"
+    "  --run S              termina después de S s\n",
+    argv0, (unsigned)GW_DEFAULT_PERIOD_MS, (unsigned)GW_DEFAULT_TIMEOUT_MS,
+    (unsigned)GW_DEFAULT_DEPTH, GW_DEFAULT_BROKER_HOST, (unsigned)GW_DEFAULT_BROKER_PORT,
+    GW_DEFAULT_TOPIC, (unsigned)GW_DEFAULT_BATCH_MS, (unsigned)GW_STATS_EVERY_S);
+}
+
+static bool parseArgs(int argc, char** argv, Options& o) {
+  o.poll.baud      = GW_DEFAULT_BAUD;
+  o.poll.periodMs  = GW_DEFAULT_PERIOD_MS;
+  o.poll.timeoutMs = GW_DEFAULT_TIMEOUT_MS;
+  o.poll.depth     = GW_DEFAULT_DEPTH;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&](const char*& v) {
+      if (i + 1 >= argc) return false;
+      v = argv[++i];
+      return true;
+    };
+    const char* v = nullptr;
+
+    if (a == "--stdout") { o.toStdout = true; continue; }
+    if (a == "-h" || a == "--help") return false;
+    if (!next(v)) { fprintf(stderr, "Falta valor para %s\n", a.c_str()); return false; }
+
+    if      (a == "--port")        o.ports.push_back(v);
+    else if (a == "--ports-file") {
+      FILE* f = fopen(v, "r");
+      if (!f) { fprintf(stderr, "No se pudo abrir %s\n", v); return false; }
+      char line[256];
+      while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] && line[0] != '#') o.ports.push_back(line);
+      }
+      fclose(f);
+    }
+    else if (a == "--sim")         o.sim = (unsigned)atoi(v);
+    else if (a == "--sim-drop")    o.simCfg.dropPct = (uint8_t)std::min(100, atoi(v));
+    else if (a == "--sim-auto-ms") o.simCfg.autoMs = (uint32_t)atol(v);
+    else if (a == "--baud")        o.poll.baud = (uint32_t)atol(v);
+    else if (a == "--period")      o.poll.periodMs = (uint32_t)atol(v);
+    else if (a == "--timeout")     o.poll.timeoutMs = (uint32_t)atol(v);
+    else if (a == "--depth")       o.poll.depth = (uint8_t)std::max(1, atoi(v));
+    else if (a == "--broker") {
+      std::string s = v;
+      size_t c = s.rfind(':');
+      o.host = s.substr(0, c);
+      if (c != std::string::npos) o.port = (uint16_t)atoi(s.c_str() + c + 1);
+    }
+    else if (a == "--token")       o.token = v;
+    else if (a == "--topic")       o.topic = v;
+    else if (a == "--batch")       o.batchMs = (uint32_t)std::max(10L, atol(v));
+    else if (a == "--auto-every")  o.autoEvery = atoi(v);
+    else if (a == "--stats")       o.statsS = (uint32_t)atol(v);
+    else if (a == "--run")         o.runS = (uint32_t)atol(v);
+    else { fprintf(stderr, "Opción desconocida: %s\n", a.c_str()); return false; }
+  }
+
+  if (o.autoEvery < 0) o.autoEvery = o.sim ? (int)GW_SIM_AUTO_EVERY_S : 0;
+  if (o.ports.empty() && o.sim == 0) {
+    fprintf(stderr, "Indica --port/--ports-file o --sim N\n");
+    return false;
+  }
+  return true;
+}
+
+// Cientos de puertos (y en --sim, 2 fds extra por esclavo) superan el límite típico de 1024
+static void raiseFdLimit() {
+  struct rlimit rl;
+  if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+  }
+}
+
+static std::string unitName(const std::string& path) {
+  size_t s = path.rfind('/');
+  return "PH-O2-" + (s == std::string::npos ? path : path.substr(s + 1));
+}
+
+// Escapa un nombre para usarlo como clave JSON
+static void appendJsonString(std::string& out, const std::string& s) {
+  out += '"';
+  for (char c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  out += '"';
+}
+
+// ================== Lotes ==================
+struct BatchStats {
+  unsigned long batches = 0;
+  unsigned long messages = 0;
+  unsigned long results = 0;
+  unsigned long long payloadBytes = 0;
+};
+
+// Drena resultados de todas las unidades y los publica partidos en mensajes
+// de hasta GW_MAX_PAYLOAD. Sin broker disponible no drena: los resultados
+// quedan en cada unidad (acotados) y se pierden los más viejos.
+static void publishBatch(std::vector<std::unique_ptr<UnitPoller>>& units, MqttClient& mqtt,
+                         const Options& o, BatchStats& bs) {
+  if (!o.toStdout && (!mqtt.connected() || mqtt.pending() > GW_MAX_PAYLOAD)) return;
+
+  std::string msg;
+  auto emit = [&]() {
+    if (msg.empty()) return;
+    msg += '}';
+    if (o.toStdout) {
+      fwrite(msg.data(), 1, msg.size(), stdout);
+      fputc('\n', stdout);
+    } else {
+      mqtt.publish(o.topic, msg);
+    }
+    bs.messages++;
+    bs.payloadBytes += msg.size();
+    msg.clear();
+  };
+
+  std::string entry;
+  UnitResult r;
+  for (auto& u : units) {
+    entry.clear();
+    while (u->popResult(r)) {
+      if (!entry.empty()) entry += ',';
+      char ts[32];
+      snprintf(ts, sizeof(ts), "{\"ts\":%llu,\"values\":{", (unsigned long long)r.tsMs);
+      entry += ts;
+      bool first = true;
+      if (!r.status.empty()) { entry += "\"status\":"; entry += r.status; first = false; }
+      if (!r.last.empty())   { if (!first) entry += ','; entry += "\"last\":"; entry += r.last; }
+      entry += "}}";
+      bs.results++;
+    }
+    if (entry.empty()) continue;
+
+    size_t need = u->name().size() + entry.size() + 8;
+    if (!msg.empty() && msg.size() + need > GW_MAX_PAYLOAD) emit();
+    msg += msg.empty() ? '{' : ',';
+    appendJsonString(msg, u->name());
+    msg += ":[";
+    msg += entry;
+    msg += ']';
+  }
+  emit();
+  bs.batches++;
+}
+
+static void printStats(const std::vector<std::unique_ptr<UnitPoller>>& units, const MqttClient& mqtt,
+                       const BatchStats& bs, const Options& o, double elapsedS) {
+  UnitStats t;
+  size_t open = 0;
+  std::vector<uint32_t> rtts;
+  rtts.reserve(units.size());
+  for (const auto& u : units) {
+    const UnitStats& s = u->stats();
+    if (u->isOpen()) open++;
+    t.polls += s.polls;
+    t.replies += s.replies;
+    t.lateReplies += s.lateReplies;
+    t.timeouts += s.timeouts;
+    t.errors += s.errors;
+    t.badLines += s.badLines;
+    t.reopens += s.reopens;
+    t.resultsDropped += s.resultsDropped;
+    if (s.maxRttMs > t.maxRttMs) t.maxRttMs = s.maxRttMs;
+    rtts.push_back(s.lastRttMs);
+  }
+  std::sort(rtts.begin(), rtts.end());
+  uint32_t p50 = rtts.empty() ? 0 : rtts[rtts.size() / 2];
+
+  const MqttStats& m = mqtt.stats();
+  fprintf(stderr,
+          "[GW %.0fs] unidades %zu/%zu | cmd %lu resp %lu (%.0f/s) tarde %lu timeouts %lu err %lu bad %lu "
+          "reopen %lu | rtt p50 %u ms max %u ms | lotes %lu msgs %lu res %lu desc %lu | ",
+          elapsedS, open, units.size(), t.polls, t.replies,
+          elapsedS > 0 ? t.replies / elapsedS : 0.0, t.lateReplies, t.timeouts, t.errors, t.badLines, t.reopens,
+          (unsigned)p50, (unsigned)t.maxRttMs, bs.batches, bs.messages, bs.results, t.resultsDropped);
+  if (o.toStdout) fprintf(stderr, "stdout %llu B\n", bs.payloadBytes);
+  else fprintf(stderr, "mqtt %s pub %lu drop %lu pend %zu B (max %zu)\n",
+               mqtt.connected() ? "ok" : "--", m.published, m.dropped, mqtt.pending(), m.maxPending);
+}
+
+int main(int argc, char** argv) {
+  Options o;
+  if (!parseArgs(argc, argv, o)) { usage(argv[0]); return 2; }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+  raiseFdLimit();
+
+  EventLoop loop;
+  if (!loop.begin()) { perror("epoll"); return 1; }
+
+  // ---- Esclavos simulados (harness pty) ----
+  std::vector<std::unique_ptr<SlaveSim>> sims;
+  for (unsigned i = 0; i < o.sim; ++i) {
+    std::unique_ptr<SlaveSim> s(new SlaveSim(0x9E3779B9u * (i + 1), o.simCfg));
+    if (!s->open(loop)) { perror("pty"); return 1; }
+    o.ports.push_back(s->slavePath());
+    sims.push_back(std::move(s));
+  }
+
+  // ---- Unidades ----
+  std::vector<std::unique_ptr<UnitPoller>> units;
+  units.reserve(o.ports.size());
+  const size_t firstSim = o.ports.size() - sims.size();
+  for (size_t i = 0; i < o.ports.size(); ++i) {
+    std::string name = unitName(o.ports[i]);
+    if (i >= firstSim) {
+      char simName[32];
+      snprintf(simName, sizeof(simName), "PH-O2-sim-%03zu", i - firstSim);
+      name = simName;
+    }
+    std::unique_ptr<UnitPoller> u(new UnitPoller(name, o.ports[i], o.poll));
+    if (!u->open(loop)) fprintf(stderr, "[GW] %s: no se pudo abrir (%s), reintentando\n",
+                                o.ports[i].c_str(), strerror(errno));
+    units.push_back(std::move(u));
+  }
+  fprintf(stderr, "[GW] %zu unidades (%zu simuladas), periodo %u ms, depth %u\n",
+          units.size(), sims.size(), (unsigned)o.poll.periodMs, (unsigned)o.poll.depth);
+
+  // ---- MQTT ----
+  MqttClient mqtt;
+  mqtt.configure(o.host, o.port, GW_DEFAULT_CLIENT_ID, o.token);
+  if (!o.toStdout) mqtt.begin(loop);
+
+  // ---- Bucle principal ----
+  BatchStats bs;
+  uint64_t start     = monotonicMs();
+  uint64_t nextBatch = start + o.batchMs;
+  uint64_t nextStats = o.statsS ? start + o.statsS * 1000ULL : UINT64_MAX;
+  uint64_t nextAuto  = o.autoEvery > 0 ? start + 1000ULL : UINT64_MAX;
+
+  while (!g_stop) {
+    uint64_t now = monotonicMs();
+    if (o.runS && now - start >= o.runS * 1000ULL) break;
+
+    uint64_t next = now + 1000;
+    for (auto& s : sims)  { s->tick(now); next = std::min(next, s->nextDeadline()); }
+    for (auto& u : units) { u->tick(now); next = std::min(next, u->nextDeadline()); }
+    if (!o.toStdout) { mqtt.tick(now); next = std::min(next, mqtt.nextDeadline()); }
+
+    if (now >= nextAuto) {
+      for (auto& u : units) u->requestAutoMeasure();
+      nextAuto = now + (uint64_t)o.autoEvery * 1000ULL;
+    }
+    if (now >= nextBatch) {
+      publishBatch(units, mqtt, o, bs);
+      nextBatch += o.batchMs;
+      if (nextBatch <= now) nextBatch = now + o.batchMs;
+    }
+    if (now >= nextStats) {
+      printStats(units, mqtt, bs, o, (now - start) / 1000.0);
+      nextStats += o.statsS * 1000ULL;
+    }
+    next = std::min(next, std::min(nextBatch, std::min(nextStats, nextAuto)));
+
+    int waitMs = next > now ? (int)(next - now) : 0;
+    if (loop.runOnce(waitMs) < 0) { perror("epoll_wait"); break; }
+  }
+
+  printStats(units, mqtt, bs, o, (monotonicMs() - start) / 1000.0);
+  return 0;
+}
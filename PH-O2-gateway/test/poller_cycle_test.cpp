@@ -0,0 +1,133 @@
+// =====================================================
+// Prueba en host: atribución de respuestas a ciclos en UnitPoller
+//  - Esclavo guionado sobre pty: contesta en orden, cada respuesta con el
+//    instante (reloj de pared) en que recibió el comando: data.rx
+//  - Un ciclo sólo puede publicar datos pedidos en ese ciclo: rx >= tsMs.
+//    Una respuesta tardía de un ciclo anterior (rx < tsMs) no debe aparecer
+//  - Casos:
+//      rápido  : 20 ms de demora, sin solapes => todos los ciclos completos
+//      lento   : una de cada 3 respuestas tarda 450 ms con periodo 300 ms =>
+//                hay respuestas tardías, se cuentan y se descartan
+//
+// Compilar (desde PH-O2-gateway):
+//   g++ -std=gnu++17 -O2 -Wall -Iinclude -Ilib/Event_loop -Ilib/Ndjson -Ilib/Serial_port -Ilib/Unit_poller test/poller_cycle_test.cpp lib/Event_loop/event_loop.cpp lib/Ndjson/ndjson.cpp lib/Serial_port/serial_port.cpp lib/Unit_poller/unit_poller.cpp -o /tmp/poller_cycle_test
+//   /tmp/poller_cycle_test
+// =====================================================
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <deque>
+#include <string>
+#include "event_loop.h"
+#include "ndjson.h"
+#include "serial_port.h"
+#include "unit_poller.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+// Esclavo serie: FIFO estricto, como UARTManager
+struct ScriptedSlave {
+  int master = -1, hold = -1;
+  std::string path;
+  Ndjson::LineFramer rx;
+  struct Reply { uint64_t dueMs; std::string text; };
+  std::deque<Reply> pending;
+  uint32_t n = 0;
+  uint32_t slowEvery = 0;   // 0 = nunca
+  uint32_t fastMs = 20, slowMs = 450;
+
+  bool open() { return SerialPort::openPty(master, hold, path); }
+  ~ScriptedSlave() { if (master >= 0) close(master); if (hold >= 0) close(hold); }
+
+  void service(uint64_t now) {
+    char buf[256];
+    ssize_t k;
+    while ((k = read(master, buf, sizeof(buf))) > 0) {
+      rx.feed(buf, (size_t)k, [&](const std::string& line) {
+        n++;
+        const uint64_t wall = wallClockMs();
+        const uint32_t delay = (slowEvery && n % slowEvery == 0) ? slowMs : fastMs;
+        uint64_t due = now + delay;
+        if (!pending.empty() && pending.back().dueMs > due) due = pending.back().dueMs;
+        char out[160];
+        if (line.find("get_status") != std::string::npos)
+          snprintf(out, sizeof(out), "{\"ok\":true,\"data\":{\"auto_running\":false,\"rx\":%llu}}\r\n",
+                   (unsigned long long)wall);
+        else
+          snprintf(out, sizeof(out), "{\"ok\":true,\"data\":{\"ph\":7.01,\"rx\":%llu}}\r\n",
+                   (unsigned long long)wall);
+        pending.push_back({due, out});
+      });
+    }
+    while (!pending.empty() && pending.front().dueMs <= now) {
+      const std::string& s = pending.front().text;
+      if (write(master, s.data(), s.size()) != (ssize_t)s.size()) break;
+      pending.pop_front();
+    }
+  }
+};
+
+static uint64_t rxOf(const std::string& data) {
+  size_t p = data.find("\"rx\":");
+  return p == std::string::npos ? 0 : strtoull(data.c_str() + p + 5, nullptr, 10);
+}
+
+struct Outcome { unsigned results = 0, complete = 0, stale = 0; UnitStats st; };
+
+static Outcome run(uint32_t slowEvery, uint32_t runMs) {
+  Outcome o;
+  EventLoop loop;
+  ScriptedSlave slave;
+  slave.slowEvery = slowEvery;
+  if (!loop.begin() || !slave.open()) { CHECK(false, "no se pudo crear el pty"); return o; }
+
+  PollerConfig cfg;
+  cfg.periodMs  = 300;
+  cfg.timeoutMs = 2000;
+  cfg.depth     = 2;
+  UnitPoller unit("test", slave.path, cfg);
+  CHECK(unit.open(loop), "open %s", slave.path.c_str());
+
+  const uint64_t start = monotonicMs();
+  for (uint64_t now = start; now - start < runMs; now = monotonicMs()) {
+    slave.service(now);
+    unit.tick(now);
+    loop.runOnce(5);
+
+    UnitResult r;
+    while (unit.popResult(r)) {
+      o.results++;
+      if (!r.status.empty() && !r.last.empty()) o.complete++;
+      // Cada dato tiene que haberse pedido en este ciclo
+      if ((!r.status.empty() && rxOf(r.status) < r.tsMs) || (!r.last.empty() && rxOf(r.last) < r.tsMs)) o.stale++;
+    }
+  }
+  o.st = unit.stats();
+  return o;
+}
+
+int main() {
+  Outcome fast = run(0, 3000);
+  printf("rápido: %u resultados, %u completos, %u con datos de otro ciclo, tarde %lu, timeouts %lu\n",
+         fast.results, fast.complete, fast.stale, fast.st.lateReplies, fast.st.timeouts);
+  CHECK(fast.results >= 8, "pocos ciclos (%u)", fast.results);
+  CHECK(fast.complete == fast.results, "ciclos incompletos sin solape");
+  CHECK(fast.stale == 0, "datos de otro ciclo");
+  CHECK(fast.st.lateReplies == 0, "respuestas tardías sin solape");
+
+  Outcome slow = run(3, 6000);
+  printf("lento:  %u resultados, %u completos, %u con datos de otro ciclo, tarde %lu, timeouts %lu\n",
+         slow.results, slow.complete, slow.stale, slow.st.lateReplies, slow.st.timeouts);
+  CHECK(slow.stale == 0, "%u resultados con respuestas de un ciclo anterior", slow.stale);
+  CHECK(slow.st.lateReplies > 0, "el caso lento no produjo respuestas tardías");
+  CHECK(slow.results > 0, "ningún resultado con solapes");
+
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
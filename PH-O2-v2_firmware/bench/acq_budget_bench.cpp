@@ -0,0 +1,164 @@
+// =====================================================
+// Medición en host del ciclo de adquisición (pH + O2) contra el ADS1115 falso
+//  - Mismo bucle que AcquisitionManager::cycle_(): beginRead de pH y O2 y
+//    stepVolts intercalados (una conversión de cada uno) hasta que ambos
+//    estimadores cierran; PHEstimator real, ADS1115Manager real, Adafruit real
+//  - Bus I2C a 100 kHz (lo fija PumpsManager: PCF8574), sondeo (ADS_RDY_PIN -1).
+//    El costo del I2C es un MODELO de bench/host/Wire.h (9 bits por byte a
+//    100 kHz + 40 us fijos por transacción), no una medición en el ESP32
+//  - Presupuesto de src/main.cpp: 48 conversiones, mínimo 8, IC95 ±0.01 pH
+//    (59 mV/pH) y ±0.05 mg/L (sonda de 40 mV en aire, 8.26 mg/L)
+//  - Ruido blanco en la entrada: "limpio" cierra por IC, "ruidoso" agota
+//    las 48 (peor caso). El tiempo es el del reloj simulado, no el del host
+//  - Solo se verifica la configuración de src/main.cpp (475 SPS / dwell 8
+//    en A0 y A2-A3): FALLA si algún ciclo, limpio o ruidoso, no entra en
+//    phPeriodMs = 500 (la tarea duerme solo lo que falta del período)
+//  Resultado (reloj simulado): 446 ms ruidoso, 127 ms limpio
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ibench/host -Ilib/ADS1115_manager -Ilib/Adafruit_ADS1X15-master -Ilib/Adafruit_BusIO-master -Ilib/ph_manager bench/acq_budget_bench.cpp lib/ADS1115_manager/ADS1115_manager.cpp lib/Adafruit_ADS1X15-master/Adafruit_ADS1X15.cpp lib/Adafruit_BusIO-master/Adafruit_I2CDevice.cpp lib/ph_manager/ph_estimator.cpp -o /tmp/acq_budget_bench
+//   /tmp/acq_budget_bench
+// =====================================================
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "fake_ads1115.h"
+#include "ADS1115_manager.h"
+#include "ph_estimator.h"
+
+TwoWire Wire;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const uint32_t PH_PERIOD_MS = 500;     // AcquisitionManager: phPeriodMs
+static const uint16_t BUDGET = 48;            // PHManager / O2Manager en src/main.cpp
+static const float    PH_CI_V = 0.01f * 0.059f;
+static const float    O2_CI_V = 0.05f / (8.26f / 0.040f);
+
+// ---- Entrada: pH en A0, O2 en A2-A3, ruido blanco gaussiano ----
+static uint32_t rng = 0x2545F491;
+static double gauss() {
+  rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+  const double u1 = (rng + 1.0) / 4294967297.0;
+  rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+  const double u2 = (rng + 1.0) / 4294967297.0;
+  return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+static double phSigma = 0, o2Sigma = 0;
+static double signal(uint8_t mux, uint64_t) {
+  if (mux == 4) return 0.120 + phSigma * gauss();    // electrodo vía el front-end
+  if (mux == 3) return 0.040 + o2Sigma * gauss();    // sonda galvánica
+  return 0.0;
+}
+
+struct ScanConfig {
+  const char* name;
+  uint16_t rate;
+  uint8_t  dwell;
+  uint8_t  discard;
+};
+
+struct CycleResult { uint32_t ms, phPushed, o2Pushed; bool phConv, o2Conv; };
+
+// Un ciclo de AcquisitionManager::cycle_() (sin temperatura: no toca el ADS)
+static CycleResult cycle(ADS1115Manager& ads) {
+  PHEstimator ph, o2;
+  PHSampleBudget pb, ob;
+  pb.maxSamples = ob.maxSamples = BUDGET;
+  pb.minSamples = ob.minSamples = 8;
+  pb.ciTarget = PH_CI_V;
+  ob.ciTarget = O2_CI_V;
+  ph.begin(pb, ads.lsbVolts(0));
+  o2.begin(ob, ads.lsbVolts(ADS1115Manager::IN_DIFF_23));
+
+  const uint32_t t0 = millis();
+  uint8_t phFails = 0, o2Fails = 0;
+  while (!ph.done() || !o2.done()) {
+    float v;
+    if (!ph.done()) {
+      if (ads.readConversion(0, v)) ph.push(v);
+      else if (++phFails >= 3) break;
+    }
+    if (!o2.done()) {
+      if (ads.readConversion(ADS1115Manager::IN_DIFF_23, v)) o2.push(v);
+      else if (++o2Fails >= 3) break;
+    }
+  }
+  CycleResult r;
+  r.ms = millis() - t0;
+  r.phPushed = ph.pushed();
+  r.o2Pushed = o2.pushed();
+  r.phConv = ph.result().converged;
+  r.o2Conv = o2.result().converged;
+  return r;
+}
+
+// 20 ciclos separados por el período (como la tarea): peor tiempo y
+// conversiones promedio por estimador
+static CycleResult measure(const ScanConfig& sc, double phS, double o2S) {
+  FakeADS1115 fake(signal);
+  Wire.attach(0x48, &fake);
+  ADS1115Manager ads;
+  ads.begin();
+  ads.setGain(GAIN_ONE);
+  ads.setDataRate(RATE_ADS1115_250SPS);
+  AdsChannelConfig phcfg;
+  phcfg.gain = GAIN_ONE;
+  phcfg.rate = sc.rate;
+  phcfg.dwell = sc.dwell;
+  phcfg.discard = sc.discard;
+  ads.setChannelConfig(0, phcfg);
+  AdsChannelConfig o2cfg = phcfg;
+  o2cfg.gain = GAIN_SIXTEEN;
+  ads.setChannelConfig(ADS1115Manager::IN_DIFF_23, o2cfg);
+  ads.startScan((1u << 0) | (1u << ADS1115Manager::IN_DIFF_23));
+
+  phSigma = phS;
+  o2Sigma = o2S;
+  CycleResult out = { 0, 0, 0, true, true };
+  const int N = 20;
+  for (int i = 0; i < N; ++i) {
+    const uint64_t start = hostNowUs();
+    const CycleResult r = cycle(ads);
+    if (r.ms > out.ms) out.ms = r.ms;
+    out.phPushed += r.phPushed;
+    out.o2Pushed += r.o2Pushed;
+    out.phConv = out.phConv && r.phConv;
+    out.o2Conv = out.o2Conv && r.o2Conv;
+    // La tarea duerme el resto del período y nadie llama service()
+    const uint64_t next = start + PH_PERIOD_MS * 1000ULL;
+    if (hostNowUs() < next) hostAdvanceUs(next - hostNowUs());
+  }
+  out.phPushed /= N;
+  out.o2Pushed /= N;
+  Wire.attach(0x48, nullptr);
+  return out;
+}
+
+int main() {
+  const ScanConfig firmware = { "475 SPS dwell 8", RATE_ADS1115_475SPS, 8, 1 };   // src/main.cpp
+  struct Noise { const char* name; double ph, o2; } noises[] = {
+    { "limpio",  0.15e-3, 0.02e-3 },
+    { "ruidoso", 4.0e-3,  2.0e-3 },
+  };
+
+  printf("ciclo pH + O2 (peor de 20), presupuesto %u, período %u ms, I2C 100 kHz (modelo), sondeo\n",
+         BUDGET, PH_PERIOD_MS);
+  printf("  %-18s %-8s %8s %10s %10s %10s\n", "escaneo", "entrada", "ms", "pH conv", "O2 conv", "I2C ms");
+  for (const Noise& n : noises) {
+    const uint64_t bus0 = Wire.busUs;
+    CycleResult r = measure(firmware, n.ph, n.o2);
+    printf("  %-18s %-8s %8u %6u %s %6u %s %10.1f\n", firmware.name, n.name, r.ms,
+           r.phPushed, r.phConv ? "IC " : "tope", r.o2Pushed, r.o2Conv ? "IC " : "tope",
+           (Wire.busUs - bus0) / 1000.0 / 20);
+    CHECK(r.ms > 0 && r.ms < PH_PERIOD_MS, "%s %s no entra en el período: %u ms", firmware.name, n.name, r.ms);
+  }
+
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+// =====================================================
+// Prueba con hilos de AcqSnapshotCell (contrato de acq_snapshot.h)
+//  - 1 escritor publica la generación k en todos los campos (ph = k,
+//    ph_ms = k, samples = k & 0xFFFF, ...); publish() asigna seq = k
+//  - 4 lectores: cada lectura tiene que ser de UNA sola publish() (todos los
+//    campos de la misma k y seq == k) y seq nunca retrocede
+//  - Otro hilo alterna ACQ_PAUSED con setFlag(): no pisa los campos y el
+//    resto de flags sigue siendo el del escritor
+//  - Con -fsanitize=thread además no debe haber data races. Con una sola CPU
+//    la coherencia casi nunca ve una copia cortada aunque falte el lock;
+//    TSan sí marca esa versión (lock()/unlock() vacíos: 7 reportes)
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -pthread -Ilib/acquisition_manager bench/acq_snapshot_test.cpp -o /tmp/acq_snapshot_test
+//   g++ -std=c++11 -O1 -g -fsanitize=thread -pthread -Ilib/acquisition_manager bench/acq_snapshot_test.cpp -o /tmp/acq_snapshot_tsan
+//   /tmp/acq_snapshot_test [publicaciones]
+// =====================================================
+
+#include <atomic>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+#include "acq_snapshot.h"
+
+static std::atomic<int> failures(0);
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static AcqSnapshot generation(uint32_t k) {
+  AcqSnapshot s;
+  s.ph_ms = k;
+  s.temp_ms = k;
+  s.ph = (float)(k & 0xFFFFF);
+  s.volts = s.ph + 0.5f;
+  s.noise_ph = s.ph + 0.25f;
+  s.ci95_ph = s.ph + 0.125f;
+  s.temp_c = s.ph - 0.5f;
+  s.o2_mgl = s.ph * 2;
+  s.o2_sat_pct = s.ph * 4;
+  s.o2_volts = s.ph * 8;
+  s.samples = (uint16_t)k;
+  s.rejected = (uint16_t)~k;
+  s.flags = ACQ_PH_OK | ((k & 1) ? ACQ_TEMP_OK : ACQ_TEMP_FALLBACK);
+  return s;
+}
+
+// true si todos los campos son de la misma generación
+static bool coherent(const AcqSnapshot& s) {
+  if (s.seq == 0) return s.ph_ms == 0 && s.samples == 0 && s.flags == 0;
+  const AcqSnapshot g = generation(s.ph_ms);
+  return s.seq == s.ph_ms && s.temp_ms == g.temp_ms && s.ph == g.ph && s.volts == g.volts &&
+         s.noise_ph == g.noise_ph && s.ci95_ph == g.ci95_ph && s.temp_c == g.temp_c &&
+         s.o2_mgl == g.o2_mgl && s.o2_sat_pct == g.o2_sat_pct && s.o2_volts == g.o2_volts &&
+         s.samples == g.samples && s.rejected == g.rejected &&
+         (s.flags & ~ACQ_PAUSED) == g.flags;
+}
+
+int main(int argc, char** argv) {
+  const uint32_t N = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200000;
+  AcqSnapshotCell cell;
+  std::atomic<bool> done(false);
+
+  CHECK(cell.read().seq == 0, "seq inicial");
+
+  std::thread writer([&] {
+    for (uint32_t k = 1; k <= N; ++k) {
+      cell.publish(generation(k));
+      if ((k & 63) == 0) sched_yield();
+    }
+    done = true;
+  });
+
+  std::thread pauser([&] {
+    bool on = false;
+    while (!done) {
+      on = !on;
+      cell.setFlag(ACQ_PAUSED, on);
+      sched_yield();
+    }
+    cell.setFlag(ACQ_PAUSED, false);
+  });
+
+  const int READERS = 4;
+  std::vector<uint64_t> reads(READERS, 0), torn(READERS, 0), backwards(READERS, 0);
+  std::vector<std::thread> readers;
+  for (int r = 0; r < READERS; ++r) {
+    readers.emplace_back([&, r] {
+      uint32_t last = 0;
+      while (!done) {
+        const AcqSnapshot s = cell.read();
+        reads[r]++;
+        if (!coherent(s)) torn[r]++;
+        if (s.seq < last) backwards[r]++;
+        last = s.seq;
+        if ((reads[r] & 255) == 0) sched_yield();
+      }
+    });
+  }
+
+  writer.join();
+  pauser.join();
+  for (std::thread& t : readers) t.join();
+
+  uint64_t totalReads = 0, totalTorn = 0, totalBack = 0;
+  for (int r = 0; r < READERS; ++r) { totalReads += reads[r]; totalTorn += torn[r]; totalBack += backwards[r]; }
+  printf("%u publicaciones, %llu lecturas en %d hilos: %llu incoherentes, %llu con seq hacia atrás\n",
+         (unsigned)N, (unsigned long long)totalReads, READERS,
+         (unsigned long long)totalTorn, (unsigned long long)totalBack);
+  CHECK(totalReads > 0, "ningún lector corrió");
+  CHECK(totalTorn == 0, "%llu lecturas mezclan dos publish()", (unsigned long long)totalTorn);
+  CHECK(totalBack == 0, "seq retrocedió %llu veces", (unsigned long long)totalBack);
+
+  const AcqSnapshot last = cell.read();
+  CHECK(last.seq == N && coherent(last) && !last.has(ACQ_PAUSED), "estado final seq=%u flags=0x%02x",
+        (unsigned)last.seq, last.flags);
+
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures.load());
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+// =====================================================
+// Prueba en host del modo continuo de ADS1115Manager contra un ADS1115
+// falso a nivel de registros (bench/host/fake_ads1115.h, I2C a 100 kHz)
+//  - Entrada en rampa: cada conversión tiene un valor distinto, así se ve
+//    si el ring repite, salta o desordena conversiones
+//  - Sondeo (rdyPin = -1): nunca repite una conversión aunque el oscilador
+//    vaya 9% lento; guarda una de cada período+10% (las que se saltan por
+//    diseño no son overruns) sin que el retraso del sondeo se acumule
+//  - ALERT/RDY: el ring tiene exactamente las conversiones del ADS menos la
+//    de asentamiento, en orden; service() tardío cuenta overruns
+//  - readFiltered() y readSingle() del canal continuo salen del ring;
+//    readSingle() de otro canal pausa, mide y reanuda el continuo
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ibench/host -Ilib/ADS1115_manager -Ilib/Adafruit_ADS1X15-master -Ilib/Adafruit_BusIO-master bench/ads_continuous_test.cpp lib/ADS1115_manager/ADS1115_manager.cpp lib/Adafruit_ADS1X15-master/Adafruit_ADS1X15.cpp lib/Adafruit_BusIO-master/Adafruit_I2CDevice.cpp -o /tmp/ads_continuous_test
+//   /tmp/ads_continuous_test
+// =====================================================
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "fake_ads1115.h"
+#include "ADS1115_manager.h"
+
+TwoWire Wire;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const int RDY_PIN = 27;
+
+// A0: rampa de 10 mV/ms (40 mV = 320 cuentas por conversión a 250 SPS, GAIN_ONE)
+// A1: 2.500 V fijos; el resto 0
+static double signal(uint8_t mux, uint64_t tUs) {
+  if (mux == 4) return 0.2 + fmod(tUs * 1e-5, 3.5);
+  if (mux == 5) return 2.5;
+  return 0.0;
+}
+
+// Copia el ring completo (más vieja primero)
+static std::vector<int16_t> ringValues(const AdsSampleRing& ring) {
+  int16_t buf[AdsSampleRing::CAPACITY];
+  const uint8_t n = ring.latest(buf, ring.size(), 0);
+  return std::vector<int16_t>(buf, buf + n);
+}
+
+// Índice en el log del ADS de cada valor del ring (-1 si no está)
+static std::vector<int> locate(const FakeADS1115& ads, const std::vector<int16_t>& vals) {
+  std::vector<int> idx;
+  size_t from = 0;
+  for (int16_t v : vals) {
+    int found = -1;
+    for (size_t i = from; i < ads.log.size(); ++i)
+      if (ads.log[i].raw == v && ads.log[i].mux == 4) { found = (int)i; from = i + 1; break; }
+    idx.push_back(found);
+  }
+  return idx;
+}
+
+// Bucle de servicio típico: service() y, si no hubo muestra, esperar un poco
+static void run(ADS1115Manager& m, uint32_t ms, uint32_t pollUs = 200) {
+  const uint64_t end = hostNowUs() + (uint64_t)ms * 1000;
+  while (hostNowUs() < end) {
+    if (!m.service()) delayMicroseconds(pollUs);
+  }
+}
+
+static void begin(ADS1115Manager& m, FakeADS1115& fake) {
+  Wire.attach(0x48, &fake);
+  CHECK(m.begin(), "begin: %s", m.lastError());
+  m.setGain(GAIN_ONE);
+  m.setDataRate(RATE_ADS1115_250SPS);
+}
+
+static void polledCase(double drift) {
+  FakeADS1115 fake(signal);
+  fake.drift = drift;
+  ADS1115Manager m;
+  begin(m, fake);
+  CHECK(m.startContinuous(0), "startContinuous: %s", m.lastError());
+  const size_t logStart = fake.log.size();
+  run(m, 1000);
+
+  const std::vector<int16_t> vals = ringValues(m.ring());
+  const std::vector<int> idx = locate(fake, vals);
+  bool ordered = true;
+  for (size_t i = 0; i < idx.size(); ++i)
+    if (idx[i] < 0 || (i && idx[i] <= idx[i - 1])) ordered = false;
+  const size_t produced = fake.log.size() - logStart;
+  const uint32_t stored = m.ring().total();
+  printf("sondeo, oscilador %+.0f%%: %zu conversiones, %u al ring (%.1f%%), overruns %u\n",
+         drift * 100, produced, stored, 100.0 * stored / produced, m.overruns());
+  CHECK(vals.size() == AdsSampleRing::CAPACITY, "ring incompleto (%zu)", vals.size());
+  CHECK(ordered, "el ring repite o desordena conversiones");
+  CHECK(stored + 1 <= produced, "más muestras que conversiones");
+  // Esperado: período real / período de sondeo (4000 us * (1 + deriva) / 4400 us)
+  const double expect = std::min(1.0, 4000.0 * (1.0 + drift) / 4400.0);
+  CHECK(stored >= produced * expect * 0.97, "pierde demasiadas (%u de %zu, esperado %.1f%%)",
+        stored, produced, expect * 100);
+  CHECK(m.overruns() == 0, "overruns sin retrasos (%u)", m.overruns());
+  m.stopContinuous();
+  CHECK(!fake.continuous(), "el ADS sigue en continuo");
+}
+
+static void rdyCase() {
+  FakeADS1115 fake(signal, RDY_PIN);
+  ADS1115Manager m;
+  begin(m, fake);
+  CHECK(m.startContinuous(0, RDY_PIN), "startContinuous rdy: %s", m.lastError());
+  const size_t logStart = fake.log.size();
+  run(m, 500);
+
+  // Toda conversión después de la de asentamiento está en el ring, en orden
+  const size_t produced = fake.log.size() - logStart;
+  CHECK(m.ring().total() + 1 == produced, "rdy: %u en ring de %zu conversiones", m.ring().total(), produced);
+  const std::vector<int16_t> vals = ringValues(m.ring());
+  bool exact = vals.size() == AdsSampleRing::CAPACITY;
+  const size_t first = fake.log.size() - vals.size();
+  for (size_t i = 0; exact && i < vals.size(); ++i) exact = (vals[i] == fake.log[first + i].raw);
+  CHECK(exact, "rdy: el ring no coincide con las últimas conversiones");
+  CHECK(m.overruns() == 0, "rdy: overruns (%u)", m.overruns());
+
+  // service() cada 3 períodos: se pierden 2 de cada 3 y se cuentan
+  const uint32_t before = m.ring().total();
+  const size_t logBefore = fake.log.size();
+  for (int i = 0; i < 100; ++i) { delayMicroseconds(12000); m.service(); }
+  const uint32_t got = m.ring().total() - before;
+  const size_t made = fake.log.size() - logBefore;
+  printf("rdy: %zu conversiones, service tardío guardó %u, overruns %u\n", made, got, m.overruns());
+  CHECK(got + m.overruns() == made, "overruns %u + guardadas %u != %zu", m.overruns(), got, made);
+  m.stopContinuous();
+}
+
+static void readsCase() {
+  FakeADS1115 fake(signal, RDY_PIN);
+  ADS1115Manager m;
+  begin(m, fake);
+  m.setAveraging(8);
+  CHECK(m.startContinuous(1, RDY_PIN), "startContinuous A1");
+
+  float v = 0;
+  CHECK(!m.readFiltered(v), "readFiltered sin muestras");
+  const uint32_t t0 = millis();
+  CHECK(m.readSingle(1, v), "readSingle A1 continuo: %s", m.lastError());
+  const uint32_t waited = millis() - t0;
+  CHECK(fabsf(v - 2.5f) < 0.001f, "A1 = %.4f", v);
+  // 8 muestras + la de asentamiento a 4 ms
+  CHECK(waited <= 45, "readSingle continuo tardó %u ms", waited);
+  CHECK(m.readFiltered(v) && fabsf(v - 2.5f) < 0.001f, "readFiltered A1 = %.4f", v);
+
+  // Otro canal: pausa, single-shot y vuelve al continuo en A1
+  const uint32_t totalBefore = m.ring(1).total();
+  CHECK(m.readSingle(0, v), "readSingle A0: %s", m.lastError());
+  CHECK(v > 0.1f && v < 3.8f, "A0 = %.4f", v);
+  CHECK(m.isContinuous() && m.continuousChannel() == 1 && fake.continuous(), "no reanudó el continuo");
+  run(m, 100);
+  CHECK(m.ring(1).total() > totalBefore + 10, "el ring de A1 no siguió llenándose");
+  CHECK(m.readFiltered(v) && fabsf(v - 2.5f) < 0.001f, "A1 tras reanudar = %.4f", v);
+  m.stopContinuous();
+}
+
+int main() {
+  polledCase(0.0);
+  polledCase(0.09);
+  polledCase(-0.09);
+  rdyCase();
+  readsCase();
+  printf("bus: %u transacciones, %.1f ms ocupado\n", Wire.transactions, Wire.busUs / 1000.0);
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+// =====================================================
+// Prueba en host del escaneo de ADS1115Manager contra el ADS1115 falso
+// (bench/host/fake_ads1115.h, I2C a 100 kHz, sondeo como ADS_RDY_PIN = -1)
+//  - Escaneo A0 (rampa, GAIN_ONE) + A2-A3 (GAIN_SIXTEEN, como la sonda de O2):
+//    readConversion(A0) intercalado con A2-A3 (como la tarea de adquisición)
+//    entrega TODAS las conversiones guardadas, en orden, incluidas las de
+//    cada ráfaga de dwell; solo faltan las de asentamiento
+//  - Un lector que vuelve tarde no recibe conversiones de hace varias vueltas
+//  - Escaneo de un solo canal con config propia: corre con esa config pero
+//    gain()/dataRate() siguen globales y las lecturas sueltas al detenerlo
+//    (o al pausarlo) usan la ganancia global
+//  - Calibración: los diferenciales salen sin calibrar por readConversion y
+//    por readDifferential23; las single-ended, calibradas
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ibench/host -Ilib/ADS1115_manager -Ilib/Adafruit_ADS1X15-master -Ilib/Adafruit_BusIO-master bench/ads_scan_test.cpp lib/ADS1115_manager/ADS1115_manager.cpp lib/Adafruit_ADS1X15-master/Adafruit_ADS1X15.cpp lib/Adafruit_BusIO-master/Adafruit_I2CDevice.cpp -o /tmp/ads_scan_test
+//   /tmp/ads_scan_test
+// =====================================================
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include <vector>
+#include "fake_ads1115.h"
+#include "ADS1115_manager.h"
+
+TwoWire Wire;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const uint8_t MUX_DIFF_23 = 3, MUX_A0 = 4, MUX_A1 = 5;
+
+// A0: rampa de 10 mV/ms; A1: 2.5 V; A2-A3: 0.1 V
+static double signal(uint8_t mux, uint64_t tUs) {
+  if (mux == MUX_A0) return 0.2 + fmod(tUs * 1e-5, 3.5);
+  if (mux == MUX_A1) return 2.5;
+  if (mux == MUX_DIFF_23) return 0.1;
+  return 0.0;
+}
+
+static void begin(ADS1115Manager& m, FakeADS1115& fake) {
+  Wire.attach(0x48, &fake);
+  CHECK(m.begin(), "begin: %s", m.lastError());
+  m.setGain(GAIN_ONE);
+  m.setDataRate(RATE_ADS1115_250SPS);
+  AdsChannelConfig o2;
+  o2.gain = GAIN_SIXTEEN;
+  o2.rate = RATE_ADS1115_250SPS;
+  m.setChannelConfig(ADS1115Manager::IN_DIFF_23, o2);
+}
+
+static uint8_t pgaOf(uint16_t cfg) { return (uint8_t)((cfg >> 9) & 7); }
+
+static void inOrderCase() {
+  FakeADS1115 fake(signal);
+  ADS1115Manager m;
+  begin(m, fake);
+  CHECK(m.startScan((1u << 0) | (1u << ADS1115Manager::IN_DIFF_23)), "startScan: %s", m.lastError());
+
+  // 48 conversiones de A0 (el presupuesto de pH) intercaladas con las de
+  // A2-A3, como AcquisitionManager::cycle_(): mientras espera la de O2 llega
+  // la ráfaga de A0, y la siguiente lectura de A0 tiene que empezar por la primera
+  const uint32_t t0 = millis();
+  std::vector<int16_t> got;
+  for (int i = 0; i < 48; ++i) {
+    float v;
+    if (!m.readConversion(0, v)) { CHECK(false, "readConversion A0 %d: %s", i, m.lastError()); break; }
+    got.push_back(m.lastRaw());
+    if (!m.readConversion(ADS1115Manager::IN_DIFF_23, v)) { CHECK(false, "readConversion O2 %d: %s", i, m.lastError()); break; }
+  }
+  const uint32_t ms = millis() - t0;
+
+  // Cada valor es una conversión de A0 distinta y en orden
+  std::vector<size_t> idx;
+  size_t from = 0;
+  for (int16_t v : got) {
+    size_t i = from;
+    while (i < fake.log.size() && !(fake.log[i].mux == MUX_A0 && fake.log[i].raw == v)) ++i;
+    if (i == fake.log.size()) break;
+    idx.push_back(i);
+    from = i + 1;
+  }
+  CHECK(idx.size() == got.size(), "%zu de %zu valores no salen del ADS en orden", got.size() - idx.size(), got.size());
+
+  // Entre la primera y la última no falta ninguna de A0 salvo las de asentamiento
+  uint32_t missing = 0, settling = 0;
+  if (!idx.empty()) {
+    size_t k = 0;
+    for (size_t i = idx.front(); i <= idx.back(); ++i) {
+      if (fake.log[i].mux != MUX_A0) continue;
+      if (k < idx.size() && idx[k] == i) { ++k; continue; }
+      if (fake.log[i].settling) ++settling; else ++missing;
+    }
+  }
+  printf("escaneo A0 + A2-A3: 48 + 48 conversiones en %u ms, %u de asentamiento descartadas, %u perdidas\n",
+         ms, settling, missing);
+  CHECK(missing == 0, "readConversion salteó %u conversiones de A0", missing);
+
+  // Lector que vuelve después de 1 s: nada de hace más de dos vueltas
+  delay(1000);
+  float v;
+  CHECK(m.readConversion(0, v), "readConversion tras pausa: %s", m.lastError());
+  CHECK(m.lastRaw() != got.back(), "entregó una conversión repetida");
+  const int16_t raw = m.lastRaw();
+  size_t at = fake.log.size();
+  while (at > 0 && !(fake.log[at - 1].mux == MUX_A0 && fake.log[at - 1].raw == raw)) --at;
+  CHECK(at > 0 && hostNowUs() - fake.log[at - 1].tUs < 120000, "conversión vieja (%.1f ms)",
+        at ? (hostNowUs() - fake.log[at - 1].tUs) / 1000.0 : -1.0);
+
+  // O2 con su ganancia y sin calibración del ADS
+  m.setCalibration(2.0f, 0.1f);
+  CHECK(m.readConversion(ADS1115Manager::IN_DIFF_23, v) && fabsf(v - 0.1f) < 0.0005f, "A2-A3 escaneo = %.5f", v);
+  CHECK(fabsf(m.lsbVolts(ADS1115Manager::IN_DIFF_23) - 0.256f / 32768) < 1e-9f, "lsb A2-A3 = %g",
+        m.lsbVolts(ADS1115Manager::IN_DIFF_23));
+  m.stopScan();
+}
+
+static void singleChannelCase() {
+  FakeADS1115 fake(signal);
+  ADS1115Manager m;
+  begin(m, fake);
+  CHECK(m.startScan(1u << ADS1115Manager::IN_DIFF_23), "startScan O2: %s", m.lastError());
+  CHECK(m.isContinuous() && pgaOf(fake.config()) == 5, "el continuo no usa GAIN_SIXTEEN (pga %u)", pgaOf(fake.config()));
+  CHECK(m.gain() == GAIN_ONE && m.dataRate() == RATE_ADS1115_250SPS, "escaneo de un canal pisó gain/rate globales");
+
+  float v;
+  CHECK(m.readConversion(ADS1115Manager::IN_DIFF_23, v) && fabsf(v - 0.1f) < 0.0005f, "A2-A3 = %.5f", v);
+
+  // Otro canal pausa el escaneo: la lectura suelta va a GAIN_ONE y se reanuda con GAIN_SIXTEEN
+  size_t before = fake.log.size();
+  CHECK(m.readSingle(1, v) && fabsf(v - 2.5f) < 0.001f, "A1 durante escaneo = %.4f", v);
+  bool gainOne = false;
+  for (size_t i = before; i < fake.log.size(); ++i) if (fake.log[i].mux == MUX_A1) gainOne = true;
+  CHECK(gainOne, "readSingle no midió A1");
+  CHECK(m.isContinuous() && pgaOf(fake.config()) == 5, "no reanudó el escaneo de O2 con su ganancia");
+
+  m.stopScan();
+  CHECK(!m.isContinuous(), "stopScan no detuvo el continuo de un canal");
+  CHECK(m.gain() == GAIN_ONE, "gain global tras stopScan");
+  before = fake.log.size();
+  CHECK(m.readSingle(1, v) && fabsf(v - 2.5f) < 0.001f, "A1 tras stopScan = %.4f", v);
+  CHECK(pgaOf(fake.config()) == 1, "lectura suelta con pga %u (esperado GAIN_ONE)", pgaOf(fake.config()));
+
+  // Calibración: diferencial sin calibrar por ambos caminos, single-ended calibrada
+  m.setCalibration(2.0f, 0.1f);
+  float d23;
+  CHECK(m.readDifferential23(d23), "readDifferential23: %s", m.lastError());
+  CHECK(fabsf(d23 - 0.1f) < 0.001f, "readDifferential23 = %.4f (calibrado)", d23);
+  CHECK(m.readSingle(1, v) && fabsf(v - 5.1f) < 0.002f, "A1 calibrado = %.4f", v);
+}
+
+int main() {
+  inOrderCase();
+  singleChannelCase();
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
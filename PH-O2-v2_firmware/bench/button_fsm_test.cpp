@@ -0,0 +1,211 @@
+// =====================================================
+// Prueba en host de ButtonFsm (lib/menu_manager) y de las teclas del menú
+// que salen de sus eventos
+//  - Pulsación limpia: PRESS debounceUs después con el tiempo del flanco;
+//    RELEASE al soltar
+//  - Rebote que vuelve al nivel previo: sin evento; ráfaga al pulsar: un
+//    PRESS con el PRIMER flanco
+//  - Mantenido: LONG una sola vez a longUs; REPEAT a repeatDelayUs y luego
+//    cada repeatUs (solo con repeat = true); una ráfaga pendiente (el
+//    soltar) frena LONG/REPEAT
+//  - Pulsado al arrancar: sin LONG; nextUs() coincide con el próximo evento
+//  - Vuelta de los µs en uint32
+//  - MenuTree: HOME vuelve a la raíz y UP/DOWN_FAST avanzan FAST_STEPS
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ilib/menu_manager bench/button_fsm_test.cpp lib/menu_manager/button_fsm.cpp lib/menu_manager/menu_tree.cpp -o /tmp/button_fsm_test
+//   /tmp/button_fsm_test
+// =====================================================
+
+#include <stdio.h>
+#include <vector>
+#include "button_fsm.h"
+#include "menu_tree.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+// Pull-up: pulsado = LOW
+static const bool UP_LVL = true, DOWN_LVL = false;
+
+struct Ev { ButtonEventType type; uint32_t tUs; uint32_t atUs; };
+struct Raw { uint32_t tUs; bool level; };
+
+// La tarea: entrega los flancos en orden a medida que pasa el tiempo (de a
+// 100 µs) y vacía poll() en cada paso
+static std::vector<Ev> run(ButtonFsm& f, const std::vector<Raw>& edges, uint32_t fromUs, uint32_t toUs) {
+  std::vector<Ev> out;
+  size_t i = 0;
+  for (uint32_t now = fromUs; (int32_t)(toUs - now) >= 0; now += 100) {
+    while (i < edges.size() && (int32_t)(now - edges[i].tUs) >= 0) { f.edge(edges[i].level, edges[i].tUs); ++i; }
+    ButtonEventType t;
+    uint32_t tUs;
+    while (f.poll(now, t, tUs)) out.push_back({t, tUs, now});
+  }
+  return out;
+}
+
+static int count(const std::vector<Ev>& v, ButtonEventType t) {
+  int n = 0;
+  for (const Ev& e : v) n += (e.type == t);
+  return n;
+}
+
+static void pressCase() {
+  ButtonFsmConfig cfg;
+  ButtonFsm f;
+  f.begin(cfg, UP_LVL, 0);
+  CHECK(f.nextUs(0) == ButtonFsm::NONE, "nextUs sin nada pendiente");
+
+  // Clic limpio de 200 ms
+  std::vector<Ev> ev = run(f, { {10000, DOWN_LVL}, {210000, UP_LVL} }, 0, 400000);
+  CHECK(ev.size() == 2, "clic: %zu eventos", ev.size());
+  if (ev.size() == 2) {
+    CHECK(ev[0].type == ButtonEventType::PRESS && ev[0].tUs == 10000 && ev[0].atUs == 10000 + cfg.debounceUs,
+          "PRESS t %u en %u", ev[0].tUs, ev[0].atUs);
+    CHECK(ev[1].type == ButtonEventType::RELEASE && ev[1].tUs == 210000, "RELEASE t %u", ev[1].tUs);
+  }
+
+  // Rebote: tres flancos en 4 ms y vuelve a HIGH
+  const uint32_t b0 = f.bounces();
+  ev = run(f, { {500000, DOWN_LVL}, {502000, UP_LVL}, {503000, DOWN_LVL}, {504000, UP_LVL} }, 400000, 600000);
+  CHECK(ev.empty() && f.bounces() == b0 + 1 && !f.pressed(), "rebote: %zu eventos, bounces %u", ev.size(),
+        f.bounces() - b0);
+
+  // Ráfaga al pulsar que queda en LOW: un PRESS con el primer flanco
+  ev = run(f, { {700000, DOWN_LVL}, {701000, UP_LVL}, {702500, DOWN_LVL}, {760000, UP_LVL} }, 600000, 900000);
+  CHECK(ev.size() == 2 && ev[0].type == ButtonEventType::PRESS && ev[0].tUs == 700000 &&
+        ev[0].atUs == 702500 + cfg.debounceUs, "ráfaga: PRESS t %u en %u", ev.empty() ? 0 : ev[0].tUs,
+        ev.empty() ? 0 : ev[0].atUs);
+}
+
+static void holdCase() {
+  ButtonFsmConfig cfg;
+  cfg.repeat = true;
+  ButtonFsm f;
+  f.begin(cfg, UP_LVL, 0);
+
+  // Mantenido 2 s: PRESS, REPEAT a 0.5 s y cada 150 ms, LONG una vez a 0.8 s
+  const uint32_t t0 = 100000, up = t0 + 2000000;
+  std::vector<Ev> ev = run(f, { {t0, DOWN_LVL}, {up, UP_LVL} }, 0, up + 100000);
+  CHECK(count(ev, ButtonEventType::LONG) == 1, "LONG %d veces", count(ev, ButtonEventType::LONG));
+  // REPEAT en t0 + 500, 650, ..., 1850 ms; el de 2000 cae con el soltar
+  CHECK(count(ev, ButtonEventType::REPEAT) == 10, "REPEAT %d veces", count(ev, ButtonEventType::REPEAT));
+  uint32_t expect = t0 + cfg.repeatDelayUs;
+  for (const Ev& e : ev) {
+    if (e.type == ButtonEventType::LONG)
+      CHECK(e.tUs == t0 + cfg.longUs && e.atUs == e.tUs, "LONG t %u en %u", e.tUs, e.atUs);
+    if (e.type != ButtonEventType::REPEAT) continue;
+    CHECK(e.tUs == expect && e.atUs == e.tUs, "REPEAT t %u (esperado %u) en %u", e.tUs, expect, e.atUs);
+    expect += cfg.repeatUs;
+  }
+  CHECK(!ev.empty() && ev.back().type == ButtonEventType::RELEASE, "falta RELEASE");
+
+  // Sin repeat: solo LONG
+  ButtonFsmConfig noRep;
+  ButtonFsm g;
+  g.begin(noRep, UP_LVL, 0);
+  ev = run(g, { {t0, DOWN_LVL}, {up, UP_LVL} }, 0, up + 100000);
+  CHECK(ev.size() == 3 && count(ev, ButtonEventType::LONG) == 1 && count(ev, ButtonEventType::REPEAT) == 0,
+        "sin repeat: %zu eventos", ev.size());
+
+  // Soltar justo antes de LONG: la ráfaga pendiente lo frena
+  ButtonFsm h;
+  h.begin(noRep, UP_LVL, 0);
+  ev = run(h, { {t0, DOWN_LVL}, {t0 + noRep.longUs - 5000, UP_LVL} }, 0, t0 + noRep.longUs + 100000);
+  CHECK(count(ev, ButtonEventType::LONG) == 0 && ev.size() == 2, "LONG con el soltar pendiente");
+
+  // Pulsado al arrancar: no dispara LONG
+  ButtonFsm s;
+  s.begin(noRep, DOWN_LVL, 0);
+  ev = run(s, {}, 0, 2000000);
+  CHECK(s.pressed() && ev.empty(), "pulsado al arrancar: %zu eventos", ev.size());
+}
+
+// nextUs() nunca se pasa del próximo evento (la tarea duerme ese tiempo)
+static void nextCase() {
+  ButtonFsmConfig cfg;
+  cfg.repeat = true;
+  ButtonFsm f;
+  f.begin(cfg, UP_LVL, 0);
+  f.edge(DOWN_LVL, 1000);
+  CHECK(f.nextUs(1000) == cfg.debounceUs, "nextUs en ráfaga %u", f.nextUs(1000));
+  ButtonEventType t;
+  uint32_t tUs;
+  uint32_t now = 1000 + cfg.debounceUs;
+  CHECK(f.poll(now, t, tUs) && t == ButtonEventType::PRESS, "PRESS");
+  int events = 0;
+  while (events < 6) {
+    const uint32_t w = f.nextUs(now);
+    CHECK(w != ButtonFsm::NONE, "nextUs NONE mantenido");
+    if (w == ButtonFsm::NONE) break;
+    CHECK(!f.poll(now + w - (w ? 1 : 0), t, tUs) || w == 0, "evento antes de nextUs (%u)", w);
+    now += w;
+    if (f.poll(now, t, tUs)) events++;
+  }
+  CHECK(events == 6, "eventos vía nextUs: %d", events);
+}
+
+// Vuelta de esp_timer en uint32 (~71 min)
+static void wrapCase() {
+  ButtonFsmConfig cfg;
+  cfg.repeat = true;
+  ButtonFsm f;
+  const uint32_t base = 0xFFFFFFFFu - 300000;
+  f.begin(cfg, UP_LVL, base);
+  std::vector<Ev> ev = run(f, { {base + 100000, DOWN_LVL}, {base + 100000 + 1000000, UP_LVL} }, base,
+                           base + 1300000);
+  CHECK(count(ev, ButtonEventType::PRESS) == 1 && count(ev, ButtonEventType::LONG) == 1 &&
+        count(ev, ButtonEventType::RELEASE) == 1, "vuelta: %zu eventos", ev.size());
+  CHECK(count(ev, ButtonEventType::REPEAT) == 4, "vuelta: REPEAT %d", count(ev, ButtonEventType::REPEAT));
+}
+
+// Display mudo: la caché de render necesita un destino
+class NullDisplay : public MenuDisplay {
+public:
+  void clear() override {}
+  void write(uint8_t, uint8_t, const char*) override {}
+};
+
+static int16_t gVal = 50;
+static const MenuValue kVal = { &gVal, 0, 100, 1, "%d", nullptr, nullptr, 0 };
+static const MenuItem kSubItems[] = { MenuItem::edit("Valor", &kVal), MenuItem::edit("Otro", &kVal) };
+static const MenuPage kSub = menuPage("Sub", kSubItems);
+static const MenuItem kRootItems[] = { MenuItem::submenu("A", &kSub), MenuItem::submenu("B", &kSub) };
+static const MenuPage kRoot = menuPage("Menu", kRootItems);
+
+static void menuKeyCase() {
+  NullDisplay d;
+  MenuTree m;
+  m.begin(&kRoot, &d, 16, 2, 0);
+  m.tick(MenuKey::DOWN, 10);
+  m.tick(MenuKey::OK, 20);      // B
+  m.tick(MenuKey::OK, 30);      // editor
+  m.tick(MenuKey::UP_FAST, 40);
+  m.tick(MenuKey::UP, 50);
+  CHECK(m.active() && m.active()->type == MenuItemType::VALUE, "no abrió el editor");
+  m.tick(MenuKey::OK, 60);
+  CHECK(gVal == 61, "UP_FAST + UP: %d (esperado 61)", gVal);
+  m.tick(MenuKey::OK, 70);
+  for (int i = 0; i < 8; ++i) m.tick(MenuKey::DOWN_FAST, 80 + i);
+  m.tick(MenuKey::OK, 100);
+  CHECK(gVal == 0, "DOWN_FAST satura en min: %d", gVal);
+  m.tick(MenuKey::DOWN_FAST, 110);   // en una página es un DOWN
+  CHECK(m.cursor() == 1, "DOWN_FAST en página: cursor %u", m.cursor());
+  m.tick(MenuKey::OK, 120);
+  m.tick(MenuKey::HOME, 130);
+  CHECK(m.atRoot() && !m.active() && m.cursor() == 0 && gVal == 0, "HOME no volvió a la raíz (o guardó)");
+}
+
+int main() {
+  pressCase();
+  holdCase();
+  nextCase();
+  wrapCase();
+  menuKeyCase();
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+// =====================================================
+// Prueba en host del CRC y la decodificación de scratchpads de
+// DS18B20Manager (readAll/snapshot) sobre el bus 1-Wire falso de
+// bench/host/fake_ds18b20.h, con DallasTemperature real
+//  - crc8 Dallas/Maxim: vector de la nota de aplicación 27 y ROM de cada
+//    sensor falso
+//  - DS18B20 a 9..12 bits (bits bajos indefinidos enmascarados), DS1822 y
+//    DS18S20 con COUNT_REMAIN, temperaturas negativas y extremos de rango
+//  - Clasificación de fallas por sensor: bit invertido = crcErrors,
+//    scratchpad en 0 o sensor ausente (todo 1 aunque otros contesten el
+//    reset) = noResponse, 85 °C sin convertir = porErrors; el resto del
+//    bus sigue leyendo
+//  - Lote: 8 sensores con un solo Convert T cuestan una conversión (más
+//    la lectura de los scratchpads), no 8
+//  - Contadores de 32 bits: 70000 fallas seguidas no dan la vuelta
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -DARDUINO=100 -Ibench/host -Ilib/Arduino-Temperature-Control-Library-master -Ilib/DS18B20_manager bench/ds18b20_decode_test.cpp lib/DS18B20_manager/DS18B20_manager.cpp lib/Arduino-Temperature-Control-Library-master/DallasTemperature.cpp -o /tmp/ds18b20_decode_test
+//   /tmp/ds18b20_decode_test
+// =====================================================
+
+#include <Arduino.h>
+#include <OneWire.h>
+#include <stdio.h>
+#include "DS18B20_manager.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const uint8_t PIN = 4;
+
+static void crcCase() {
+  // Maxim AN27: ROM 02 1C B8 01 00 00 00 con CRC A2
+  const uint8_t rom[8] = { 0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xA2 };
+  CHECK(OneWire::crc8(rom, 7) == 0xA2, "crc8 AN27 = %02X", OneWire::crc8(rom, 7));
+  CHECK(OneWire::crc8(rom, 8) == 0x00, "crc8 con su CRC no da 0");
+  uint8_t bad[8];
+  memcpy(bad, rom, 8);
+  int missed = 0;
+  for (int bit = 0; bit < 64; ++bit) {
+    bad[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    if (OneWire::crc8(bad, 8) == 0) missed++;
+    bad[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+  }
+  CHECK(missed == 0, "crc8 no detecta %d errores de un bit", missed);
+}
+
+// Un sensor en el bus: readAll() y el valor (NAN si no fue válido)
+static float readOne(DS18B20Manager& m) {
+  DS18B20Snapshot s;
+  m.readAll(s);
+  return s.probe[0].fresh ? s.probe[0].c : NAN;
+}
+
+static void decodeCase() {
+  struct Case { uint8_t family; uint8_t bits; double in; float out; } cases[] = {
+    { 0x28, 12,  25.0625,  25.0625f },
+    { 0x28, 12,  -0.0625,  -0.0625f },
+    { 0x28, 12, -10.125,  -10.125f },
+    { 0x28, 12, -55.0,    -55.0f },
+    { 0x28, 12, 125.0,    125.0f },
+    { 0x28, 11,  25.1875,  25.125f },    // 0.125 °C
+    { 0x28, 10,  25.3125,  25.25f },     // 0.25 °C
+    { 0x28,  9,  25.4375,  25.0f },      // 0.5 °C
+    { 0x28,  9,  -0.0625,  -0.5f },      // negativo: enmascara hacia abajo
+    { 0x22, 12,  19.9375,  19.9375f },   // DS1822
+    { 0x10, 12,  25.0625,  25.0625f },   // DS18S20 con COUNT_REMAIN
+    { 0x10, 12,  25.8125,  25.8125f },
+    { 0x10, 12, -10.25,   -10.25f },
+    { 0x10, 12,   0.5,      0.5f },
+  };
+  for (const Case& c : cases) {
+    FakeDS18B20 d(c.family, 0x4000 + c.bits);
+    d.tempC = c.in;
+    hostOneWire().clear();
+    hostOneWire().attach(&d);
+    DS18B20Manager m(PIN, c.bits);
+    CHECK(m.begin() == 1, "begin familia %02X", c.family);
+    const float v = readOne(m);
+    CHECK(v == c.out, "familia %02X %u bits: %.4f -> %.4f (esperado %.4f)", c.family, c.bits, c.in, v, c.out);
+  }
+
+  // 85.0 °C real es indistinguible del valor de power-on: se descarta
+  FakeDS18B20 hot(0x28, 0x4100);
+  hot.tempC = 85.0;
+  hostOneWire().clear();
+  hostOneWire().attach(&hot);
+  DS18B20Manager m(PIN);
+  m.begin();
+  CHECK(isnan(readOne(m)) && m.snapshot().probe[0].porErrors == 1, "85.0 °C no se marcó como power-on");
+}
+
+static void faultCase() {
+  FakeDS18B20 a(0x28, 0x5001), b(0x28, 0x5002), c(0x28, 0x5003), d(0x10, 0x5004);
+  a.tempC = 20.0; b.tempC = 21.0; c.tempC = 22.0; d.tempC = 23.0;
+  hostOneWire().clear();
+  hostOneWire().attach(&a); hostOneWire().attach(&b);
+  hostOneWire().attach(&c); hostOneWire().attach(&d);
+  DS18B20Manager m(PIN);
+  CHECK(m.begin() == 4, "4 sensores: %u", m.sensorCount());
+
+  DS18B20Snapshot s;
+  CHECK(m.readAll(s) == 4, "lectura limpia");
+
+  a.flipNextReads = 1;
+  b.zeroNextReads = 1;
+  c.powerOnReset = true;
+  a.tempC = 30.0; b.tempC = 31.0; c.tempC = 32.0; d.tempC = 33.0;
+  const uint8_t n = m.readAll(s);
+  CHECK(n == 1, "con 3 fallas: %u válidos", n);
+  CHECK(s.probe[0].crcErrors == 1 && s.probe[0].noResponse == 0 && s.probe[0].porErrors == 0,
+        "bit invertido: crc %u nr %u por %u", s.probe[0].crcErrors, s.probe[0].noResponse, s.probe[0].porErrors);
+  CHECK(s.probe[1].noResponse == 1 && s.probe[1].crcErrors == 0, "scratchpad en 0: nr %u crc %u",
+        s.probe[1].noResponse, s.probe[1].crcErrors);
+  CHECK(s.probe[2].porErrors == 1, "power-on: por %u", s.probe[2].porErrors);
+  CHECK(s.probe[3].crcErrors + s.probe[3].noResponse + s.probe[3].porErrors == 0, "el DS18S20 sano contó fallas");
+  CHECK(s.probe[0].c == 20.0f && s.probe[1].c == 21.0f && s.probe[2].c == 22.0f && s.probe[3].c == 33.0f,
+        "las fallas pisaron el último valor: %.2f %.2f %.2f %.2f", s.probe[0].c, s.probe[1].c, s.probe[2].c, s.probe[3].c);
+
+  CHECK(m.readAll(s) == 4, "no se recuperaron");
+  CHECK(s.probe[0].c == 30.0f && s.probe[1].c == 31.0f && s.probe[2].c == 32.0f && s.probe[3].c == 33.0f,
+        "tras recuperarse: %.2f %.2f %.2f %.2f", s.probe[0].c, s.probe[1].c, s.probe[2].c, s.probe[3].c);
+  CHECK(s.probe[0].reads == 3 && s.probe[3].reads == 3, "reads %u / %u", s.probe[0].reads, s.probe[3].reads);
+
+  // Sensor desconectado: noResponse y conserva su último valor
+  b.present = false;
+  m.readAll(s);
+  CHECK(!s.probe[1].fresh && s.probe[1].noResponse == 2 && s.probe[1].c == 31.0f,
+        "ausente: fresh %d nr %u c %.2f", s.probe[1].fresh, s.probe[1].noResponse, s.probe[1].c);
+  CHECK(s.probe[0].fresh && s.probe[2].fresh && s.probe[3].fresh, "un ausente afectó a los demás");
+}
+
+static void batchCase() {
+  FakeDS18B20* probes[8];
+  hostOneWire().clear();
+  for (int i = 0; i < 8; ++i) {
+    probes[i] = new FakeDS18B20(0x28, 0x7001 + i);
+    probes[i]->tempC = 20.0 + i;
+    hostOneWire().attach(probes[i]);
+  }
+  DS18B20Manager m(PIN);
+  CHECK(m.begin() == 8, "8 sensores: %u", m.sensorCount());
+
+  DS18B20Snapshot s;
+  const uint32_t resets0 = hostOneWire().resets;
+  const uint32_t t0 = millis();
+  const uint8_t n = m.readAll(s);
+  const uint32_t dt = millis() - t0;
+  printf("lote de 8 sensores: %u válidos en %u ms (una conversión: %u ms), %u resets\n", n, dt,
+         m.conversionMs(), hostOneWire().resets - resets0);
+  CHECK(n == 8 && s.probe[7].c == 27.0f, "lote: %u válidos, último %.2f", n, s.probe[7].c);
+  CHECK(dt < 2 * m.conversionMs(), "lote de 8 tardó %u ms", dt);
+  for (int i = 0; i < 8; ++i) delete probes[i];
+}
+
+static void wideCountersCase() {
+  FakeDS18B20 a(0x28, 0x6001);
+  hostOneWire().clear();
+  hostOneWire().attach(&a);
+  DS18B20Manager m(PIN, 9);
+  m.begin();
+  const uint32_t N = 70000;
+  a.flipNextReads = N;
+  DS18B20Snapshot s;
+  for (uint32_t i = 0; i < N; ++i) m.readAll(s);
+  printf("%u lecturas con CRC malo: reads %u crcErrors %u\n", N, s.probe[0].reads, s.probe[0].crcErrors);
+  CHECK(s.probe[0].crcErrors == N && s.probe[0].reads == N, "contadores dieron la vuelta (%u / %u)",
+        s.probe[0].crcErrors, s.probe[0].reads);
+}
+
+int main() {
+  crcCase();
+  decodeCase();
+  faultCase();
+  batchCase();
+  wideCountersCase();
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
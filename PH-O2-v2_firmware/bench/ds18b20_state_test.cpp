@@ -0,0 +1,187 @@
+// =====================================================
+// Prueba en host de la máquina de estados no bloqueante de DS18B20Manager
+// (requestConversion/update/lastC) con DallasTemperature real sobre el bus
+// 1-Wire falso de bench/host/fake_ds18b20.h y reloj simulado
+//  - Sin sensores: update() no hace nada y no hay valor cacheado
+//  - Primer update() dispara la conversión; con alimentación externa la
+//    cierra cuando el sensor avisa (600 ms de 750 nominales), en parásito
+//    espera conversionMs() completo
+//  - Ningún update() espera la conversión: solo ocupa el bus lo que tarda
+//    leer los scratchpads
+//  - Edad del cache, período automático, conversiones encadenadas
+//    (autoPeriod < conversionMs), solo manuales (autoPeriod 0), 9 bits
+//    (94 ms, pasos de 0.5 °C)
+//  - Un sensor que falla conserva su último valor válido
+//  - readC() bloqueante en medio de una conversión no rompe el cache
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -DARDUINO=100 -Ibench/host -Ilib/Arduino-Temperature-Control-Library-master -Ilib/DS18B20_manager bench/ds18b20_state_test.cpp lib/DS18B20_manager/DS18B20_manager.cpp lib/Arduino-Temperature-Control-Library-master/DallasTemperature.cpp -o /tmp/ds18b20_state_test
+//   /tmp/ds18b20_state_test
+// =====================================================
+
+#include <Arduino.h>
+#include <OneWire.h>
+#include <stdio.h>
+#include "DS18B20_manager.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const uint8_t PIN = 4;
+
+// Bucle de la tarea: update() cada stepMs. Devuelve el instante (ms desde
+// el inicio) en que empezó el update() de la primera lectura completa
+// nueva, o -1. maxCallUs: la llamada más larga de update()
+struct Loop { int32_t firstReadMs; uint32_t reads; uint32_t maxCallUs; };
+static Loop run(DS18B20Manager& m, uint32_t ms, uint32_t stepMs = 10) {
+  Loop r = { -1, 0, 0 };
+  const uint64_t t0 = hostNowUs();
+  uint32_t seq = m.snapshot().seq;
+  while (hostNowUs() - t0 < (uint64_t)ms * 1000) {
+    const uint64_t a = hostNowUs();
+    m.update();
+    const uint32_t took = (uint32_t)(hostNowUs() - a);
+    if (took > r.maxCallUs) r.maxCallUs = took;
+    if (m.snapshot().seq != seq) {
+      seq = m.snapshot().seq;
+      if (r.firstReadMs < 0) r.firstReadMs = (int32_t)((a - t0) / 1000);
+      r.reads++;
+    }
+    delay(stepMs);
+  }
+  return r;
+}
+
+static void noProbesCase() {
+  hostOneWire().clear();
+  DS18B20Manager m(PIN);
+  CHECK(m.begin() == 0, "sin sensores: begin = %u", m.sensorCount());
+  CHECK(!m.requestConversion(), "requestConversion sin sensores");
+  const uint32_t resets = hostOneWire().resets;
+  const Loop r = run(m, 200);
+  CHECK(r.reads == 0 && hostOneWire().resets == resets, "update() tocó el bus sin sensores");
+  CHECK(isnan(m.cachedC(0)), "valor cacheado sin sensores");
+}
+
+static void externalPowerCase() {
+  FakeDS18B20 a(0x28, 0x1001), b(0x28, 0x1002), c(0x28, 0x1003);
+  a.tempC = 21.5; b.tempC = 23.25; c.tempC = -4.0625;
+  hostOneWire().clear();
+  hostOneWire().attach(&a); hostOneWire().attach(&b); hostOneWire().attach(&c);
+  DS18B20Manager m(PIN);
+  CHECK(m.begin() == 3, "3 sensores: begin = %u", m.sensorCount());
+  CHECK(isnan(m.cachedC(0)), "valor antes de la primera conversión");
+
+  // Primer update(): dispara la conversión de los 3 con un solo Convert T
+  m.update();
+  CHECK(m.isConverting() && a.conversions == 1 && b.conversions == 1 && c.conversions == 1,
+        "primer update no disparó (conv %u/%u/%u)", a.conversions, b.conversions, c.conversions);
+  const Loop r = run(m, 900);
+  printf("alimentación externa, 12 bits: primera lectura a %d ms (nominal %u), update() más largo %.1f ms\n",
+         r.firstReadMs, m.conversionMs(), r.maxCallUs / 1000.0);
+  CHECK(r.firstReadMs >= 600 && r.firstReadMs < 620, "no cerró al avisar el sensor (%d ms)", r.firstReadMs);
+  CHECK(r.maxCallUs < 3 * 12000, "update() bloqueó %u us", r.maxCallUs);
+  CHECK(m.cachedC(0) == 21.5f && m.cachedC(1) == 23.25f && m.cachedC(2) == -4.0625f,
+        "valores %.4f %.4f %.4f", m.cachedC(0), m.cachedC(1), m.cachedC(2));
+
+  // Edad del cache
+  float v;
+  uint32_t age = 0;
+  CHECK(m.lastC(0, v, age) && age < 320, "edad tras leer = %u ms", age);
+  const uint32_t before = age;
+  delay(250);
+  CHECK(m.lastC(0, v, age) && age == before + 250, "edad %u tras 250 ms (antes %u)", age, before);
+  CHECK(isnan(m.cachedC(0, 100)), "cachedC devolvió un valor más viejo que maxAge");
+  CHECK(m.cachedC(0, 1000) == 21.5f, "cachedC dentro de maxAge");
+
+  // Período automático de 1000 ms: 10 conversiones en 10 s
+  a.tempC = 30.0;
+  const uint32_t convBefore = a.conversions;
+  const Loop p = run(m, 10000);
+  printf("período 1000 ms: %u conversiones y %u lecturas en 10 s\n", a.conversions - convBefore, p.reads);
+  CHECK(a.conversions - convBefore >= 9 && a.conversions - convBefore <= 11, "conversiones en 10 s: %u",
+        a.conversions - convBefore);
+  CHECK(m.cachedC(0) == 30.0f, "el cache no siguió al agua (%.3f)", m.cachedC(0));
+
+  // Sensor que falla una vez: conserva el último valor válido y lo cuenta
+  b.flipNextReads = 1;
+  b.tempC = 40.0;
+  const uint32_t seq = m.snapshot().seq;
+  while (m.snapshot().seq == seq) { m.update(); delay(10); }
+  CHECK(!m.snapshot().probe[1].fresh && m.snapshot().probe[1].crcErrors == 1, "falla no contada");
+  CHECK(m.cachedC(1) == 23.25f, "sensor fallido perdió su valor (%.3f)", m.cachedC(1));
+  CHECK(m.snapshot().probe[0].fresh && m.snapshot().probe[2].fresh, "la falla de uno afectó a los otros");
+  const uint32_t seq2 = m.snapshot().seq;
+  while (m.snapshot().seq == seq2) { m.update(); delay(10); }
+  CHECK(m.cachedC(1) == 40.0f && m.snapshot().probe[1].fresh, "no se recuperó (%.3f)", m.cachedC(1));
+
+  // readC() bloqueante en medio de una conversión automática
+  while (!m.isConverting()) { m.update(); delay(10); }
+  delay(100);
+  c.tempC = 5.5;
+  const uint32_t t0 = millis();
+  const float rc = m.readC(2);
+  const uint32_t took = millis() - t0;
+  CHECK(rc == 5.5f, "readC en medio de la conversión = %.4f", rc);
+  CHECK(took >= 500 && took < 800, "readC tardó %u ms", took);
+  const Loop after = run(m, 2500);
+  CHECK(after.reads >= 2, "tras readC el ciclo automático se detuvo");
+  CHECK(m.cachedC(2) == 5.5f && m.snapshot().probe[2].porErrors == 0, "tras readC: %.4f, por %u",
+        m.cachedC(2), m.snapshot().probe[2].porErrors);
+}
+
+static void parasiteCase() {
+  FakeDS18B20 a(0x28, 0x2001);
+  a.parasite = true;
+  a.tempC = 18.0;
+  hostOneWire().clear();
+  hostOneWire().attach(&a);
+  DS18B20Manager m(PIN);
+  CHECK(m.begin() == 1, "parásito: begin");
+  const Loop r = run(m, 900);
+  printf("parásito, 12 bits: primera lectura a %d ms\n", r.firstReadMs);
+  CHECK(r.firstReadMs >= 750 && r.firstReadMs < 770, "parásito cerró a %d ms (no puede sondear)", r.firstReadMs);
+  CHECK(m.cachedC(0) == 18.0f, "parásito = %.4f", m.cachedC(0));
+}
+
+static void nineBitCase() {
+  FakeDS18B20 a(0x28, 0x3001);
+  a.tempC = 22.8;
+  hostOneWire().clear();
+  hostOneWire().attach(&a);
+  DS18B20Manager m(PIN, 9);
+  CHECK(m.begin() == 1 && m.conversionMs() == 94, "9 bits: conversionMs = %u", m.conversionMs());
+  const Loop r = run(m, 150, 2);
+  printf("9 bits: primera lectura a %d ms, %.4f °C\n", r.firstReadMs, m.cachedC(0));
+  CHECK(r.firstReadMs >= 75 && r.firstReadMs < 90, "9 bits cerró a %d ms", r.firstReadMs);
+  CHECK(m.cachedC(0) == 22.5f, "9 bits = %.4f (esperado 22.5)", m.cachedC(0));
+
+  // Encadenadas: período menor que la conversión, una detrás de otra
+  const uint32_t convBefore = a.conversions;
+  m.setAutoPeriod(1);
+  const Loop ch = run(m, 1000, 2);
+  printf("9 bits encadenadas: %u conversiones en 1 s\n", a.conversions - convBefore);
+  CHECK(ch.reads >= 11 && ch.reads <= 13, "encadenadas: %u lecturas en 1 s", ch.reads);
+
+  // Manual: setAutoPeriod(0) no agenda nada
+  m.setAutoPeriod(0);
+  run(m, 200, 2);
+  const uint32_t conv = a.conversions;
+  run(m, 500, 2);
+  CHECK(a.conversions == conv, "con autoPeriod 0 siguió convirtiendo");
+  CHECK(m.requestConversion(), "requestConversion manual");
+  CHECK(!m.requestConversion(), "requestConversion con una en curso");
+}
+
+int main() {
+  noProbesCase();
+  externalPowerCase();
+  parasiteCase();
+  nineBitCase();
+  printf("bus: %u resets, %u slots\n", hostOneWire().resets, hostOneWire().slots);
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
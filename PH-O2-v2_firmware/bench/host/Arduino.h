@@ -0,0 +1,287 @@
+#ifndef BENCH_HOST_ARDUINO_H
+#define BENCH_HOST_ARDUINO_H
+
+// =====================================================
+// Shim mínimo de Arduino + FreeRTOS para correr UARTManager en host
+//  - String sobre std::string (solo lo que usan los logs)
+//  - Print / Stream con la interfaz que piden ArduinoJson y UARTManager
+//  - Colas, semáforo y event group de un solo hilo; las colas reservan
+//    su memoria al crearse (como FreeRTOS), no en cada envío
+//  - Reloj simulado: millis()/micros() solo avanzan con delay*() o con
+//    hostAdvanceUs(); los dispositivos falsos (HostTimed) se disparan en
+//    orden en el instante exacto de cada evento
+//  - GPIO: niveles por pin y attachInterruptArg() que se dispara desde
+//    hostSetPin() según el flanco pedido
+//  - Mutex recursivo con hostHoldByOther() para simular que lo tiene otra
+//    tarea; secciones críticas vacías; Serial a stdout
+// =====================================================
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// ---------- String ----------
+class String {
+public:
+  String() {}
+  String(const char* s) : s_(s ? s : "") {}
+  String(const std::string& s) : s_(s) {}
+  String(char c) : s_(1, c) {}
+  String(int v) : s_(std::to_string(v)) {}
+  String(unsigned v) : s_(std::to_string(v)) {}
+  String(long v) : s_(std::to_string(v)) {}
+  String(unsigned long v) : s_(std::to_string(v)) {}
+  String(float v, int dec = 2) : s_(fmt_(v, dec)) {}
+  String(double v, int dec = 2) : s_(fmt_(v, dec)) {}
+
+  const char* c_str() const { return s_.c_str(); }
+  size_t length() const { return s_.size(); }
+  bool concat(const String& o) { s_ += o.s_; return true; }
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }
+  friend String operator+(String a, const String& b) { a.s_ += b.s_; return a; }
+  friend String operator+(String a, const char* b) { a.s_ += b; return a; }
+
+private:
+  std::string s_;
+  static std::string fmt_(double v, int dec) {
+    char b[32];
+    snprintf(b, sizeof(b), "%.*f", dec, v);
+    return b;
+  }
+};
+
+// ---------- Print / Stream ----------
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n && write(buf[k])) ++k;
+    return k;
+  }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v, int base = 10) {
+    char b[24];
+    snprintf(b, sizeof(b), base == 16 ? "%X" : "%d", v);
+    return write(b);
+  }
+  size_t println() { return write("\r\n"); }
+  size_t println(const char* s) { return print(s) + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(char* buf, size_t n) {
+    size_t k = 0;
+    while (k < n) {
+      const int c = read();
+      if (c < 0) break;
+      buf[k++] = (char)c;
+    }
+    return k;
+  }
+  size_t readBytes(uint8_t* buf, size_t n) { return readBytes((char*)buf, n); }
+};
+
+class HostSerial : public Print {
+public:
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+};
+static HostSerial Serial;
+
+#if defined(__GLIBC__) && (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+inline size_t strlcpy(char* dst, const char* src, size_t n) {
+  const size_t len = strlen(src);
+  if (n) {
+    const size_t k = len < n - 1 ? len : n - 1;
+    memcpy(dst, src, k);
+    dst[k] = '\0';
+  }
+  return len;
+}
+#endif
+
+// ---------- Tiempo simulado ----------
+#define IRAM_ATTR
+
+// Dispositivo con eventos propios (fin de conversión, pulso RDY, ...)
+class HostTimed {
+public:
+  virtual ~HostTimed() {}
+  virtual uint64_t nextEventUs() const = 0;   // UINT64_MAX = ninguno
+  virtual void fire(uint64_t nowUs) = 0;
+};
+
+inline uint64_t& hostNowUs() { static uint64_t us = 0; return us; }
+inline std::vector<HostTimed*>& hostTimed() { static std::vector<HostTimed*> v; return v; }
+
+inline void hostAdvanceUs(uint64_t dt) {
+  const uint64_t target = hostNowUs() + dt;
+  for (;;) {
+    HostTimed* first = nullptr;
+    uint64_t when = target;
+    for (HostTimed* d : hostTimed()) {
+      const uint64_t t = d->nextEventUs();
+      if (t <= when) { when = t; first = d; }
+    }
+    if (!first) break;
+    if (when > hostNowUs()) hostNowUs() = when;
+    first->fire(hostNowUs());
+  }
+  // Un evento puede avanzar el reloj por su cuenta (I2C desde un timer)
+  if (hostNowUs() < target) hostNowUs() = target;
+}
+
+inline unsigned long micros() { return (unsigned long)(uint32_t)hostNowUs(); }
+inline unsigned long millis() { return (unsigned long)(uint32_t)(hostNowUs() / 1000); }
+inline void delayMicroseconds(uint32_t us) { hostAdvanceUs(us); }
+inline void delay(uint32_t ms) { hostAdvanceUs((uint64_t)ms * 1000); }
+
+// ---------- GPIO ----------
+#define LOW     0
+#define HIGH    1
+#define INPUT   0x01
+#define OUTPUT  0x03
+#define INPUT_PULLUP 0x05
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+#define digitalPinToInterrupt(p) (p)
+
+struct HostPin {
+  int   level = HIGH;
+  int   mode = 0;
+  void (*isr)(void*) = nullptr;
+  void* arg = nullptr;
+};
+inline HostPin& hostPin(uint8_t pin) { static HostPin pins[40]; return pins[pin % 40]; }
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int  digitalRead(uint8_t pin) { return hostPin(pin).level; }
+inline void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {
+  HostPin& p = hostPin(pin);
+  p.isr = isr; p.arg = arg; p.mode = mode;
+}
+inline void detachInterrupt(uint8_t pin) { hostPin(pin).isr = nullptr; }
+
+// Cambia el nivel y corre la ISR si el flanco coincide con el modo
+inline void hostSetPin(uint8_t pin, int level) {
+  HostPin& p = hostPin(pin);
+  if (level == p.level) return;
+  p.level = level;
+  if (!p.isr) return;
+  const bool fall = (level == LOW);
+  if (p.mode == CHANGE || (p.mode == FALLING && fall) || (p.mode == RISING && !fall)) p.isr(p.arg);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t level) { hostSetPin(pin, level ? HIGH : LOW); }
+
+// ---------- Varios ----------
+typedef uint8_t byte;
+#define F(s) (s)
+#define HEX 16
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+inline void yield() {}
+
+// ---------- FreeRTOS (un solo hilo) ----------
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t EventBits_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define BIT0 (1u << 0)
+#define BIT1 (1u << 1)
+#define BIT2 (1u << 2)
+#define BIT3 (1u << 3)
+
+struct HostQueue {
+  size_t   item, depth, head, count;
+  uint8_t* buf;
+};
+typedef HostQueue* QueueHandle_t;
+typedef HostQueue* SemaphoreHandle_t;
+struct HostEventGroup { EventBits_t bits; };
+typedef HostEventGroup* EventGroupHandle_t;
+
+inline QueueHandle_t xQueueCreate(size_t depth, size_t item) {
+  HostQueue* q = new HostQueue{item, depth, 0, 0, nullptr};
+  q->buf = (uint8_t*)malloc(item * depth + 1);
+  return q;
+}
+inline BaseType_t xQueueSend(QueueHandle_t q, const void* p, TickType_t) {
+  if (q->count == q->depth) return pdFALSE;
+  memcpy(q->buf + ((q->head + q->count) % q->depth) * q->item, p, q->item);
+  q->count++;
+  return pdTRUE;
+}
+inline BaseType_t xQueueOverwrite(QueueHandle_t q, const void* p) {
+  q->count = 0;
+  return xQueueSend(q, p, 0);
+}
+inline BaseType_t xQueueReceive(QueueHandle_t q, void* p, TickType_t) {
+  if (!q->count) return pdFALSE;
+  memcpy(p, q->buf + q->head * q->item, q->item);
+  q->head = (q->head + 1) % q->depth;
+  q->count--;
+  return pdTRUE;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return xQueueCreate(1, 0); }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+  if (s->count) return pdFALSE;
+  s->count = 1;
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t) {
+  if (!s->count) return pdFALSE;
+  s->count = 0;
+  return pdTRUE;
+}
+
+// Mutex recursivo: count = profundidad, head != 0 = lo tiene otra tarea
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return xQueueCreate(1, 0); }
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t s, TickType_t) {
+  if (s->head) return pdFALSE;
+  s->count++;
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t s) {
+  if (!s->count) return pdFALSE;
+  s->count--;
+  return pdTRUE;
+}
+inline void hostHoldByOther(SemaphoreHandle_t s, bool held) { s->head = held ? 1 : 0; }
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define taskENTER_CRITICAL(m) ((void)(m))
+#define taskEXIT_CRITICAL(m) ((void)(m))
+
+inline EventGroupHandle_t xEventGroupCreate() { return new HostEventGroup{0}; }
+inline EventBits_t xEventGroupSetBits(EventGroupHandle_t g, EventBits_t b) { return g->bits |= b; }
+inline EventBits_t xEventGroupClearBits(EventGroupHandle_t g, EventBits_t b) {
+  const EventBits_t prev = g->bits;
+  g->bits &= ~b;
+  return prev;
+}
+inline EventBits_t xEventGroupGetBits(EventGroupHandle_t g) { return g->bits; }
+
+inline void vTaskDelay(TickType_t) {}
+
+#endif // BENCH_HOST_ARDUINO_H
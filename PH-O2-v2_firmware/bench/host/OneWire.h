@@ -0,0 +1,52 @@
+#ifndef BENCH_HOST_ONEWIRE_H
+#define BENCH_HOST_ONEWIRE_H
+
+// =====================================================
+// OneWire en host: misma interfaz que lib/OneWire-master/OneWire.h, pero
+// cada byte/slot va al bus falso de bench/host/fake_ds18b20.h
+//  - DallasTemperature y DS18B20Manager se compilan sin cambios
+//  - crc8 es el de Dallas/Maxim (x^8 + x^5 + x^4 + 1)
+// =====================================================
+
+#include <Arduino.h>
+#include "fake_ds18b20.h"
+
+class OneWire {
+public:
+  OneWire() {}
+  OneWire(uint8_t pin) { begin(pin); }
+  void begin(uint8_t) { reset_search(); }
+
+  uint8_t reset(void) { return hostOneWire().reset(); }
+  void select(const uint8_t rom[8]) {
+    write(0x55);
+    for (uint8_t i = 0; i < 8; ++i) write(rom[i]);
+  }
+  void skip(void) { write(0xCC); }
+
+  void write(uint8_t v, uint8_t power = 0) { (void)power; hostOneWire().writeByte(v); }
+  void write_bytes(const uint8_t* buf, uint16_t count, bool power = 0) {
+    for (uint16_t i = 0; i < count; ++i) write(buf[i], power);
+  }
+  uint8_t read(void) { return hostOneWire().readByte(); }
+  void read_bytes(uint8_t* buf, uint16_t count) {
+    for (uint16_t i = 0; i < count; ++i) buf[i] = read();
+  }
+  void write_bit(uint8_t v) { hostOneWire().writeBit(v); }
+  uint8_t read_bit(void) { return hostOneWire().readBit(); }
+  void depower(void) {}
+
+  void reset_search() { searchIdx_ = 0; }
+  void target_search(uint8_t) { searchIdx_ = 0; }
+  bool search(uint8_t* newAddr, bool search_mode = true) {
+    (void)search_mode;
+    return hostOneWire().search(searchIdx_, newAddr);
+  }
+
+  static uint8_t crc8(const uint8_t* addr, uint8_t len) { return FakeDS18B20::crc8(addr, len); }
+
+private:
+  size_t searchIdx_ = 0;
+};
+
+#endif // BENCH_HOST_ONEWIRE_H
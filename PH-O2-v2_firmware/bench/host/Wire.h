@@ -0,0 +1,91 @@
+#ifndef BENCH_HOST_WIRE_H
+#define BENCH_HOST_WIRE_H
+
+// =====================================================
+// TwoWire en host: enruta cada transacción a un dispositivo falso por
+// dirección y avanza el reloj simulado lo que dura en el bus
+//  - (1 byte de dirección + datos) * 9 bits a la velocidad de setClock()
+//  - + overheadUs por transacción (driver i2c del ESP32, ~40 us)
+//  - Escritura: el dispositivo la ve al terminar; lectura: al empezar
+// =====================================================
+
+#include <Arduino.h>
+
+class HostI2CDevice {
+public:
+  virtual ~HostI2CDevice() {}
+  virtual void   i2cWrite(const uint8_t* buf, size_t n) = 0;
+  virtual size_t i2cRead(uint8_t* buf, size_t n) = 0;
+};
+
+class TwoWire {
+public:
+  static constexpr size_t BUF = 32;
+
+  void attach(uint8_t addr, HostI2CDevice* dev) { devs_[addr & 0x7F] = dev; }
+  void setOverheadUs(uint32_t us) { overheadUs_ = us; }
+
+  bool begin() { return true; }
+  bool begin(int, int) { return true; }
+  void end() {}
+  void setClock(uint32_t hz) { hz_ = hz ? hz : 100000; }
+  uint32_t getClock() const { return hz_; }
+
+  // Estadística del bus
+  uint32_t transactions = 0;
+  uint64_t busUs = 0;
+
+  void beginTransmission(uint8_t addr) { addr_ = addr & 0x7F; txLen_ = 0; }
+  size_t write(uint8_t b) {
+    if (txLen_ >= BUF) return 0;
+    tx_[txLen_++] = b;
+    return 1;
+  }
+  size_t write(const uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n && write(buf[k])) ++k;
+    return k;
+  }
+  // 0 = ok, 2 = NACK de dirección (como el core de Arduino)
+  uint8_t endTransmission(bool stop = true) {
+    (void)stop;
+    spend_(1 + txLen_);
+    HostI2CDevice* d = devs_[addr_];
+    if (!d) return 2;
+    if (txLen_) d->i2cWrite(tx_, txLen_);
+    return 0;
+  }
+
+  size_t requestFrom(uint8_t addr, uint8_t len, uint8_t stop = 1) {
+    (void)stop;
+    rxLen_ = rxPos_ = 0;
+    HostI2CDevice* d = devs_[addr & 0x7F];
+    if (len > BUF) len = BUF;
+    if (d) rxLen_ = d->i2cRead(rx_, len);
+    spend_(1 + len);
+    return rxLen_;
+  }
+  int available() const { return (int)(rxLen_ - rxPos_); }
+  int read() { return rxPos_ < rxLen_ ? rx_[rxPos_++] : -1; }
+
+private:
+  HostI2CDevice* devs_[128] = {nullptr};
+  uint32_t hz_ = 100000;
+  uint32_t overheadUs_ = 40;
+  uint8_t  addr_ = 0;
+  uint8_t  tx_[BUF];
+  size_t   txLen_ = 0;
+  uint8_t  rx_[BUF];
+  size_t   rxLen_ = 0, rxPos_ = 0;
+
+  void spend_(size_t bytes) {
+    const uint64_t us = (uint64_t)bytes * 9 * 1000000ULL / hz_ + overheadUs_;
+    transactions++;
+    busUs += us;
+    hostAdvanceUs(us);
+  }
+};
+
+extern TwoWire Wire;
+
+#endif // BENCH_HOST_WIRE_H
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+#include <chrono>
+#include <Arduino.h>
+
+inline int64_t esp_timer_get_time() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Timers one-shot sobre el reloj simulado de Arduino.h: vencen dentro de
+// hostAdvanceUs() en el instante exacto. Como en ESP-IDF, start_once sobre
+// uno armado y stop sobre uno parado devuelven ESP_ERR_INVALID_STATE
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_ERR_INVALID_STATE 0x103
+
+typedef void (*esp_timer_cb_t)(void* arg);
+struct esp_timer_create_args_t {
+  esp_timer_cb_t callback;
+  void*          arg;
+  int            dispatch_method;
+  const char*    name;
+  bool           skip_unhandled_events;
+};
+
+class HostEspTimer : public HostTimed {
+public:
+  esp_timer_cb_t cb = nullptr;
+  void*          arg = nullptr;
+  uint64_t       due = UINT64_MAX;
+  uint64_t nextEventUs() const override { return due; }
+  void fire(uint64_t) override { due = UINT64_MAX; cb(arg); }
+};
+typedef HostEspTimer* esp_timer_handle_t;
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* a, esp_timer_handle_t* out) {
+  HostEspTimer* t = new HostEspTimer;
+  t->cb = a->callback;
+  t->arg = a->arg;
+  hostTimed().push_back(t);
+  *out = t;
+  return ESP_OK;
+}
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t us) {
+  if (t->due != UINT64_MAX) return ESP_ERR_INVALID_STATE;
+  t->due = hostNowUs() + us;
+  return ESP_OK;
+}
+inline esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+  if (t->due == UINT64_MAX) return ESP_ERR_INVALID_STATE;
+  t->due = UINT64_MAX;
+  return ESP_OK;
+}
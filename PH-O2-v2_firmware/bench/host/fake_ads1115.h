@@ -0,0 +1,157 @@
+#ifndef BENCH_HOST_FAKE_ADS1115_H
+#define BENCH_HOST_FAKE_ADS1115_H
+
+// =====================================================
+// ADS1115 falso a nivel de registros para las pruebas en host
+//  - Puntero + CONVERSION / CONFIG / LO_THRESH / HI_THRESH (reset 0x8583)
+//  - Single-shot (OS=1, MODE=1): OS se lee 0 mientras convierte y la
+//    conversión queda lista un período después (8..860 SPS, con deriva
+//    del oscilador configurable)
+//  - Continuo (MODE=0): una conversión por período desde la escritura del config
+//  - ALERT/RDY: con HI_THRESH MSB=1, LO_THRESH MSB=0 y COMP_QUE != 11 el pin
+//    baja ~8 us al terminar cada conversión (hostSetPin dispara la ISR)
+//  - La primera conversión tras cambiar el MUX sale a mitad de camino entre
+//    la entrada anterior y la nueva (asentamiento que el firmware descarta)
+//  - Registro de cada conversión (valor, instante, MUX, si se leyó)
+// =====================================================
+
+#include <functional>
+#include <math.h>
+#include <vector>
+#include <Arduino.h>
+#include <Wire.h>
+
+class FakeADS1115 : public HostI2CDevice, public HostTimed {
+public:
+  // mux = bits 14:12 del config (0 = A0-A1, 3 = A2-A3, 4..7 = A0..A3)
+  typedef std::function<double(uint8_t mux, uint64_t tUs)> Signal;
+
+  struct Conversion {
+    int16_t  raw;
+    uint64_t tUs;
+    uint8_t  mux;
+    bool     settling;   // primera tras cambio de MUX
+    uint16_t reads;      // veces que se leyó el registro mientras fue la última
+  };
+
+  explicit FakeADS1115(Signal sig, int rdyPin = -1) : sig_(sig), rdyPin_(rdyPin) {
+    hostTimed().push_back(this);
+  }
+  ~FakeADS1115() {
+    std::vector<HostTimed*>& v = hostTimed();
+    for (size_t i = 0; i < v.size(); ++i) if (v[i] == this) { v.erase(v.begin() + i); break; }
+  }
+
+  double drift = 0.0;               // +0.05 = oscilador 5% lento
+  std::vector<Conversion> log;
+
+  uint16_t config() const { return cfg_; }
+  bool     continuous() const { return !(cfg_ & 0x0100); }
+  uint32_t periodUs(uint16_t cfg) const {
+    static const uint16_t sps[8] = { 8, 16, 32, 64, 128, 250, 475, 860 };
+    return (uint32_t)(1000000.0 / sps[(cfg >> 5) & 7] * (1.0 + drift));
+  }
+
+  // ---- I2C ----
+  void i2cWrite(const uint8_t* b, size_t n) override {
+    ptr_ = b[0] & 3;
+    if (n < 3) return;
+    const uint16_t v = (uint16_t)((b[1] << 8) | b[2]);
+    switch (ptr_) {
+      case 1: writeConfig_(v); break;
+      case 2: lo_ = v; break;
+      case 3: hi_ = v; break;
+      default: break;   // CONVERSION es solo lectura
+    }
+  }
+
+  size_t i2cRead(uint8_t* b, size_t n) override {
+    uint16_t v = 0;
+    switch (ptr_) {
+      case 0:
+        v = (uint16_t)conv_;
+        if (!log.empty()) log.back().reads++;
+        break;
+      case 1: v = (uint16_t)((cfg_ & 0x7FFF) | (busy_ ? 0 : 0x8000)); break;
+      case 2: v = lo_; break;
+      default: v = hi_; break;
+    }
+    if (n > 0) b[0] = (uint8_t)(v >> 8);
+    if (n > 1) b[1] = (uint8_t)v;
+    return n < 2 ? n : 2;
+  }
+
+  // ---- Tiempo ----
+  uint64_t nextEventUs() const override {
+    uint64_t t = busy_ ? doneUs_ : UINT64_MAX;
+    if (rdyLowUntil_ && rdyLowUntil_ < t) t = rdyLowUntil_;
+    return t;
+  }
+
+  void fire(uint64_t now) override {
+    if (rdyLowUntil_ && now >= rdyLowUntil_) {
+      rdyLowUntil_ = 0;
+      if (rdyPin_ >= 0) hostSetPin((uint8_t)rdyPin_, HIGH);
+      return;
+    }
+    if (!busy_ || now < doneUs_) return;
+    complete_(now);
+    if (continuous()) doneUs_ = now + periodUs(cfg_);
+    else busy_ = false;
+  }
+
+private:
+  Signal   sig_;
+  int      rdyPin_;
+  uint8_t  ptr_ = 0;
+  uint16_t cfg_ = 0x8583;
+  uint16_t lo_ = 0x8000, hi_ = 0x7FFF;
+  int16_t  conv_ = 0;
+  bool     busy_ = false;
+  uint64_t doneUs_ = 0;
+  uint64_t rdyLowUntil_ = 0;
+  int      prevMux_ = -1;     // MUX de la última conversión
+  bool     settling_ = false;
+  double   prevVolts_ = 0;
+
+  static double fullScale_(uint16_t cfg) {
+    static const double fs[8] = { 6.144, 4.096, 2.048, 1.024, 0.512, 0.256, 0.256, 0.256 };
+    return fs[(cfg >> 9) & 7];
+  }
+
+  void writeConfig_(uint16_t v) {
+    const bool single = v & 0x0100;
+    const uint8_t mux = (uint8_t)((v >> 12) & 7);
+    cfg_ = v & 0x7FFF;
+    if (single && !(v & 0x8000)) {   // MODE=1 sin OS: power-down
+      busy_ = false;
+      return;
+    }
+    settling_ = (prevMux_ >= 0 && prevMux_ != mux);
+    busy_ = true;
+    doneUs_ = hostNowUs() + periodUs(cfg_);
+  }
+
+  void complete_(uint64_t now) {
+    const uint8_t mux = (uint8_t)((cfg_ >> 12) & 7);
+    double v = sig_(mux, now);
+    if (settling_) v = (v + prevVolts_) / 2;
+    const double fs = fullScale_(cfg_);
+    double code = floor(v / fs * 32768.0 + 0.5);
+    if (code > 32767) code = 32767;
+    if (code < -32768) code = -32768;
+    conv_ = (int16_t)code;
+    log.push_back({ conv_, now, mux, settling_, 0 });
+    prevVolts_ = sig_(mux, now);
+    prevMux_ = mux;
+    settling_ = false;
+
+    const bool rdyMode = (hi_ & 0x8000) && !(lo_ & 0x8000) && (cfg_ & 3) != 3;
+    if (rdyMode && rdyPin_ >= 0) {
+      hostSetPin((uint8_t)rdyPin_, LOW);
+      rdyLowUntil_ = now + 8;
+    }
+  }
+};
+
+#endif // BENCH_HOST_FAKE_ADS1115_H
@@ -0,0 +1,274 @@
+#ifndef BENCH_HOST_FAKE_DS18B20_H
+#define BENCH_HOST_FAKE_DS18B20_H
+
+// =====================================================
+// Bus 1-Wire falso con sensores DS18B20/DS18S20 a nivel de comandos
+// (lo usa bench/host/OneWire.h en lugar de los slots por GPIO)
+//  - ROM: Skip (0xCC), Match (0x55) y búsqueda (se resuelve en search())
+//  - Función: Convert T (0x44), Read/Write Scratchpad (0xBE/0x4E),
+//    Copy Scratchpad (0x48), Read Power Supply (0xB4)
+//  - Convert T dura nominal(resolución) · speed; mientras convierte un slot
+//    de lectura da 0 (alimentación externa) y el scratchpad conserva el
+//    valor anterior; en modo parásito el slot no informa nada
+//  - Lecturas con varios sensores seleccionados: AND cableado
+//  - Tiempo: reset 960 us, slot 65 us (avanza el reloj simulado)
+//  - Fallas inyectables por sensor: ausente, bits invertidos en las próximas
+//    lecturas del scratchpad, scratchpad en 0 y reinicio (85 °C de power-on)
+// =====================================================
+
+#include <Arduino.h>
+#include <vector>
+
+class FakeDS18B20 {
+public:
+  uint8_t rom[8];
+  double  tempC = 25.0;        // temperatura del agua
+  double  speed = 0.8;         // conversión real / nominal (12 bits: 600 ms)
+  bool    present = true;
+  bool    parasite = false;
+  uint8_t config = 0x7F;       // 12 bits al encender
+
+  // Fallas inyectables
+  uint32_t flipNextReads = 0;  // invierte un bit en las próximas N lecturas
+  uint32_t zeroNextReads = 0;  // scratchpad en 0 (sensor que no contesta el dato)
+  bool     powerOnReset = false;   // la próxima conversión no ocurre: queda 85 °C
+
+  // Estadística
+  uint32_t conversions = 0;
+  uint32_t scratchReads = 0;
+
+  FakeDS18B20(uint8_t family, uint32_t serial) {
+    rom[0] = family;
+    for (uint8_t i = 0; i < 6; ++i) rom[1 + i] = (uint8_t)(i < 4 ? serial >> (8 * i) : 0);
+    rom[7] = crc8(rom, 7);
+    sp_[0] = 0x50; sp_[1] = 0x05;   // 85 °C de power-on
+    if (family == 0x10) { sp_[0] = 0xAA; sp_[1] = 0x00; }
+    sp_[2] = 0x4B; sp_[3] = 0x46;
+  }
+
+  // Tiempo de conversión nominal de la hoja de datos (us)
+  uint32_t nominalUs() const {
+    if (rom[0] == 0x10) return 750000;
+    switch ((config >> 5) & 3) {
+      case 0: return 93750;
+      case 1: return 187500;
+      case 2: return 375000;
+      default: return 750000;
+    }
+  }
+
+  bool converting(uint64_t now) const { return convEndUs_ && now < convEndUs_; }
+
+  void startConversion(uint64_t now) {
+    settle(now);
+    conversions++;
+    convEndUs_ = now + (uint64_t)(nominalUs() * speed);
+    latchC_ = tempC;
+    if (powerOnReset) {
+      powerOnReset = false;
+      skipLatch_ = true;
+      sp_[0] = rom[0] == 0x10 ? 0xAA : 0x50;
+      sp_[1] = rom[0] == 0x10 ? 0x00 : 0x05;
+    }
+  }
+
+  // Scratchpad visible en este instante (9 bytes con CRC)
+  void scratchpad(uint64_t now, uint8_t* out) {
+    settle(now);
+    scratchReads++;
+    if (rom[0] == 0x10) { sp_[4] = 0xFF; sp_[5] = 0xFF; }
+    else { sp_[4] = config; sp_[5] = 0xFF; sp_[6] = 0x0C; sp_[7] = 0x10; }
+    sp_[8] = crc8(sp_, 8);
+    for (uint8_t i = 0; i < 9; ++i) out[i] = sp_[i];
+    if (zeroNextReads) { zeroNextReads--; for (uint8_t i = 0; i < 9; ++i) out[i] = 0; }
+    else if (flipNextReads) { flipNextReads--; out[scratchReads % 8] ^= (uint8_t)(1u << (scratchReads % 7)); }
+  }
+
+  void writeScratchpad(const uint8_t* b, uint8_t n) {
+    if (n > 0) sp_[2] = b[0];
+    if (n > 1) sp_[3] = b[1];
+    if (n > 2 && rom[0] != 0x10) config = (uint8_t)((b[2] & 0x60) | 0x1F);
+  }
+
+  static uint8_t crc8(const uint8_t* p, uint8_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+      uint8_t b = *p++;
+      for (uint8_t i = 0; i < 8; ++i) {
+        const uint8_t mix = (uint8_t)((crc ^ b) & 1);
+        crc >>= 1;
+        if (mix) crc ^= 0x8C;
+        b >>= 1;
+      }
+    }
+    return crc;
+  }
+
+private:
+  uint8_t  sp_[9] = {0};
+  uint64_t convEndUs_ = 0;
+  double   latchC_ = 25.0;
+  bool     skipLatch_ = false;
+
+  // Al terminar la conversión el valor pasa al scratchpad
+  void settle(uint64_t now) {
+    if (!convEndUs_ || now < convEndUs_) return;
+    convEndUs_ = 0;
+    if (skipLatch_) { skipLatch_ = false; return; }
+    const long t16 = lround(latchC_ * 16.0);
+    int16_t raw;
+    if (rom[0] == 0x10) {
+      // 9 bits + COUNT_REMAIN: T = (raw >> 1) - 0.25 + (16 - remain) / 16
+      const long whole = (long)floor((t16 + 4) / 16.0);
+      raw = (int16_t)(whole * 2);
+      sp_[6] = (uint8_t)(12 - (t16 - whole * 16));
+      sp_[7] = 0x10;
+    } else {
+      const uint8_t bits = (uint8_t)(9 + ((config >> 5) & 3));
+      raw = (int16_t)(t16 & ~((1L << (12 - bits)) - 1));
+    }
+    sp_[0] = (uint8_t)raw;
+    sp_[1] = (uint8_t)((uint16_t)raw >> 8);
+  }
+};
+
+class FakeOneWireBus {
+public:
+  static const uint32_t RESET_US = 960;
+  static const uint32_t SLOT_US = 65;
+
+  std::vector<FakeDS18B20*> devs;
+  bool shorted = false;
+
+  // Estadística
+  uint32_t resets = 0, slots = 0;
+
+  void attach(FakeDS18B20* d) { devs.push_back(d); }
+  void clear() { devs.clear(); state_ = IDLE; }
+
+  uint8_t reset() {
+    resets++;
+    hostAdvanceUs(RESET_US);
+    state_ = ROM;
+    sel_.assign(devs.size(), false);
+    if (shorted) return 0;
+    for (FakeDS18B20* d : devs) if (d->present) return 1;
+    return 0;
+  }
+
+  void writeByte(uint8_t v) {
+    spend_(8);
+    switch (state_) {
+      case ROM:
+        if (v == 0xCC) { for (size_t i = 0; i < devs.size(); ++i) sel_[i] = devs[i]->present; state_ = FUNC; }
+        else if (v == 0x55) { matchLen_ = 0; state_ = MATCH; }
+        else state_ = IDLE;
+        break;
+      case MATCH:
+        match_[matchLen_++] = v;
+        if (matchLen_ == 8) {
+          for (size_t i = 0; i < devs.size(); ++i)
+            sel_[i] = devs[i]->present && memcmp(devs[i]->rom, match_, 8) == 0;
+          state_ = FUNC;
+        }
+        break;
+      case FUNC:
+        function_(v);
+        break;
+      case WRITE_SP:
+        wbuf_[wlen_++] = v;
+        for (size_t i = 0; i < devs.size(); ++i) if (sel_[i]) devs[i]->writeScratchpad(wbuf_, wlen_);
+        break;
+      default:
+        break;
+    }
+  }
+
+  uint8_t readByte() {
+    spend_(8);
+    if (state_ != READ_SP || rpos_ >= 9) return 0xFF;
+    return rbuf_[rpos_++];
+  }
+
+  uint8_t readBit() {
+    spend_(1);
+    const uint64_t now = hostNowUs();
+    if (state_ == CONVERT) {
+      // Alimentación externa: 0 mientras alguno convierte. Parásito: el bus
+      // queda en alto (pull-up fuerte) y el slot siempre lee 1
+      for (size_t i = 0; i < devs.size(); ++i)
+        if (sel_[i] && !devs[i]->parasite && devs[i]->converting(now)) return 0;
+      return 1;
+    }
+    if (state_ == POWER) {
+      for (size_t i = 0; i < devs.size(); ++i) if (sel_[i] && devs[i]->parasite) return 0;
+      return 1;
+    }
+    if (state_ == READ_SP) {
+      const uint8_t v = (uint8_t)((rpos_ < 9 ? rbuf_[rpos_] : 0xFF) >> rbit_ & 1);
+      if (++rbit_ == 8) { rbit_ = 0; rpos_++; }
+      return v;
+    }
+    return 1;
+  }
+
+  void writeBit(uint8_t) { spend_(1); }
+
+  // Búsqueda de ROM: los presentes en orden de conexión (64 tripletes c/u)
+  bool search(size_t& idx, uint8_t* rom) {
+    if (!reset()) return false;
+    spend_(8);
+    while (idx < devs.size() && !devs[idx]->present) ++idx;
+    if (idx >= devs.size()) return false;
+    spend_(64 * 3);
+    memcpy(rom, devs[idx]->rom, 8);
+    ++idx;
+    state_ = IDLE;
+    return true;
+  }
+
+private:
+  enum State { IDLE, ROM, MATCH, FUNC, CONVERT, READ_SP, WRITE_SP, POWER };
+  State   state_ = IDLE;
+  std::vector<bool> sel_;
+  uint8_t match_[8];
+  uint8_t matchLen_ = 0;
+  uint8_t rbuf_[9];
+  uint8_t rpos_ = 0, rbit_ = 0;
+  uint8_t wbuf_[3];
+  uint8_t wlen_ = 0;
+
+  void spend_(uint32_t n) {
+    slots += n;
+    hostAdvanceUs((uint64_t)n * SLOT_US);
+  }
+
+  void function_(uint8_t cmd) {
+    const uint64_t now = hostNowUs();
+    switch (cmd) {
+      case 0x44:
+        for (size_t i = 0; i < devs.size(); ++i) if (sel_[i]) devs[i]->startConversion(now);
+        state_ = CONVERT;
+        break;
+      case 0xBE: {
+        memset(rbuf_, 0xFF, sizeof(rbuf_));
+        for (size_t i = 0; i < devs.size(); ++i) {
+          if (!sel_[i]) continue;
+          uint8_t sp[9];
+          devs[i]->scratchpad(now, sp);
+          for (uint8_t k = 0; k < 9; ++k) rbuf_[k] &= sp[k];
+        }
+        rpos_ = rbit_ = 0;
+        state_ = READ_SP;
+        break;
+      }
+      case 0x4E: wlen_ = 0; state_ = WRITE_SP; break;
+      case 0xB4: state_ = POWER; break;
+      default:   state_ = IDLE; break;   // 0x48 copia a EEPROM: no se modela
+    }
+  }
+};
+
+inline FakeOneWireBus& hostOneWire() { static FakeOneWireBus bus; return bus; }
+
+#endif // BENCH_HOST_FAKE_DS18B20_H
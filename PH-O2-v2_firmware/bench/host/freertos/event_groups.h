@@ -0,0 +1,3 @@
+#pragma once
+// Host: el event group está en el shim de Arduino.h
+#include <Arduino.h>
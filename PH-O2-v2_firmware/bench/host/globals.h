@@ -0,0 +1,14 @@
+#ifndef GLOBALS_H
+#define GLOBALS_H
+// Host: solo el log remoto (cuenta líneas, no imprime)
+#include <Arduino.h>
+
+class RemoteAccessManager {
+public:
+  void log(const String& message) { (void)message; lines++; }
+  uint32_t lines = 0;
+};
+
+extern RemoteAccessManager remoteManager;
+
+#endif
@@ -0,0 +1,202 @@
+// =====================================================
+// Prueba en host de LevelDebouncer (lib/level_sensors_manager) y del corte
+// por guarda de AutoRecipeIOBase (lib/recipe_engine) que cuelga de él
+//  - Flanco limpio: se confirma stableUs después, con el tiempo del flanco
+//  - Ráfaga que vuelve al nivel previo: rebote, sin evento; ráfaga que
+//    queda en el nivel nuevo: un evento con el PRIMER flanco
+//  - Flancos repetidos ignorados, pendingUs(), vuelta de los µs en uint32
+//  - Latencia flanco → confirmación con rebotes aleatorios de hasta 15 ms:
+//    peor caso = ráfaga + stableUs (+ 1 tick de la tarea en el ESP32)
+//  - Corte: PUMP armado hasta la guarda se apaga en la confirmación; con
+//    HOLD se agenda offAfter() contado desde el flanco; desarmado no corta
+//  Resultado: peor latencia 34.9 ms en 2000 cambios (ráfaga de 14.9 ms +
+//  20 ms de antirrebote); en el ESP32 suma hasta 1 tick de la tarea
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ilib/level_sensors_manager -Ilib/recipe_engine bench/level_debounce_test.cpp lib/level_sensors_manager/level_debounce.cpp lib/recipe_engine/auto_recipe_io.cpp lib/recipe_engine/recipe.cpp lib/recipe_engine/fill_learner.cpp -o /tmp/level_debounce_test
+//   /tmp/level_debounce_test
+// =====================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "level_debounce.h"
+#include "auto_recipe_io.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const uint32_t STABLE_US = 20000;
+
+// La tarea: entrega los flancos crudos en orden a medida que pasa el tiempo
+// (de a 100 µs) y hace poll(); devuelve true si confirmó algo antes de maxUs
+struct Raw { uint32_t tUs; bool level; };
+static bool run(LevelDebouncer& d, const std::vector<Raw>& edges, uint32_t& nowUs, uint32_t maxUs,
+                LevelEdge& out) {
+  const uint32_t end = nowUs + maxUs;
+  size_t i = 0;
+  for (; (int32_t)(end - nowUs) > 0; nowUs += 100) {
+    while (i < edges.size() && (int32_t)(nowUs - edges[i].tUs) >= 0) { d.edge(edges[i].level, edges[i].tUs); ++i; }
+    if (d.poll(nowUs, out)) return true;
+  }
+  return false;
+}
+
+static void basicCase() {
+  LevelDebouncer d;
+  d.begin(true, 0, STABLE_US);
+  LevelEdge e;
+  uint32_t now = 5000;
+
+  CHECK(d.pendingUs(now) == LevelDebouncer::NONE, "pendiente sin flancos");
+  d.edge(false, now);
+  d.edge(false, now + 3000);   // repetido: no reinicia la espera
+  CHECK(d.pendingUs(now + 3000) == STABLE_US - 3000, "pendingUs = %u", d.pendingUs(now + 3000));
+  CHECK(!d.poll(now + STABLE_US - 1, e), "confirmó antes de stableUs");
+  CHECK(d.poll(now + STABLE_US, e) && !e.level && e.tUs == now && e.confirmUs == now + STABLE_US,
+        "flanco limpio: nivel %d t %u", e.level, e.tUs);
+  CHECK(!d.level() && d.lastChangeUs() == now, "estado tras confirmar");
+
+  // Rebote: 4 flancos en 6 ms y vuelve a LOW
+  now = 100000;
+  uint32_t t = now;
+  CHECK(!run(d, { {now, true}, {now + 2000, false}, {now + 4000, true}, {now + 6000, false} }, t, 50000, e) &&
+        d.bounces() == 1, "rebote: bounces %u", d.bounces());
+
+  // Ráfaga que queda en HIGH: un evento con el primer flanco
+  now = 200000;
+  t = now;
+  CHECK(run(d, { {now, true}, {now + 1500, false}, {now + 3000, true} }, t, 50000, e) && e.level &&
+        e.tUs == now && t == now + 3000 + STABLE_US, "ráfaga: t %u confirmado %u", e.tUs, t);
+
+  // Vuelta de uint32 (cada ~71 min)
+  LevelDebouncer w;
+  const uint32_t base = 0xFFFFFFFFu - 5000;
+  w.begin(false, base, STABLE_US);
+  w.edge(true, base + 1000);
+  CHECK(!w.poll(base + 1000 + STABLE_US - 1, e), "vuelta: confirmó antes");
+  CHECK(w.poll(base + 1000 + STABLE_US, e) && e.tUs == base + 1000, "vuelta: sin evento");
+}
+
+// Peor latencia con ráfagas aleatorias
+static void latencyCase() {
+  srand(7);
+  LevelDebouncer d;
+  uint32_t now = 0;
+  bool level = true;
+  d.begin(level, now, STABLE_US);
+  uint32_t worst = 0, events = 0, missed = 0;
+  for (int i = 0; i < 2000; ++i) {
+    now += 100000 + (uint32_t)(rand() % 50000);
+    const uint32_t t0 = now;
+    level = !level;
+    // Rebote de 0..15 ms alrededor del cruce, termina en el nivel nuevo
+    const uint32_t burst = (uint32_t)(rand() % 15001);
+    std::vector<Raw> edges = { {t0, level} };
+    for (uint32_t t = 700; t + 300 <= burst; t += 700 + (uint32_t)(rand() % 1500)) {
+      edges.push_back({ t0 + t, !level });
+      edges.push_back({ t0 + t + 300, level });
+    }
+    LevelEdge e;
+    uint32_t t = now;
+    if (!run(d, edges, t, 100000, e) || e.level != level || e.tUs != t0) { missed++; continue; }
+    events++;
+    if (t - t0 > worst) worst = t - t0;
+    now = t;
+  }
+  printf("latencia flanco -> confirmación: peor %.1f ms con rebotes <= 15 ms (%u eventos, %u rebotes)\n",
+         worst / 1000.0, events, d.bounces());
+  CHECK(missed == 0, "%u cambios sin evento correcto", missed);
+  CHECK(worst <= 15000 + STABLE_US + 1000, "peor latencia %u us", worst);
+}
+
+// AutoRecipeIOBase con niveles y bombas de mentira
+class FakeAutoIO : public AutoRecipeIOBase {
+public:
+  uint32_t t = 0;
+  bool     lv[(uint8_t)AutoLevel::COUNT] = { true, true, false, false };   // celda vacía
+  uint32_t changeMs[(uint8_t)AutoLevel::COUNT] = {};
+  bool     pump[PUMPS] = {};
+  int32_t  offAfterMs[PUMPS];
+
+  FakeAutoIO() { for (int32_t& x : offAfterMs) x = -1; }
+
+  uint32_t now() override { return t; }
+  // Un flanco confirmado como lo publica la tarea de niveles
+  void level(AutoLevel l, bool active, uint32_t edgeMs) {
+    lv[(uint8_t)l] = active;
+    changeMs[(uint8_t)l] = edgeMs;
+    onLevelChange();
+  }
+
+protected:
+  void     setPump(uint8_t p, bool on) override { pump[p] = on; }
+  void     offAfter(uint8_t p, uint32_t ms) override { offAfterMs[p] = (int32_t)ms; }
+  void     cancelOff(uint8_t p) override { offAfterMs[p] = -1; }
+  bool     levelActive(AutoLevel l) override { return lv[(uint8_t)l]; }
+  bool     levelChangeMs(AutoLevel l, uint32_t& ms) override { ms = changeMs[(uint8_t)l]; return true; }
+  uint32_t configured(RecipeParam) override { return 0; }
+};
+
+static void cutCase() {
+  FakeAutoIO io;
+  io.currentSample = 2;   // RA_SAMPLE = S3
+  io.t = 1000;
+  io.actuator(RA_SAMPLE, true);
+  io.cutOnGuard(RA_SAMPLE, RecipeGuard::SAMPLE_IN, 0);
+  CHECK(io.pump[RA_SAMPLE3] && io.armed(RA_SAMPLE3) == RecipeGuard::SAMPLE_IN, "RA_SAMPLE no armó S3");
+
+  // Primer sensor mojado: la guarda (ambos) todavía no se cumple
+  io.t = 3000;
+  io.level(AutoLevel::O2, false, 2980);
+  CHECK(io.pump[RA_SAMPLE3], "cortó con un solo sensor");
+  // Segundo sensor: se corta en la confirmación (flanco + 20 ms)
+  io.t = 3420;
+  io.level(AutoLevel::PH, false, 3400);
+  CHECK(!io.pump[RA_SAMPLE3] && io.armed(RA_SAMPLE3) == RecipeGuard::NONE, "no cortó en el flanco");
+
+  // Drenaje con HOLD de 15 s: se agenda desde el flanco (confirmado 20 ms después)
+  io.t = 10000;
+  io.actuator(RA_DRAIN, true);
+  io.cutOnGuard(RA_DRAIN, RecipeGuard::DRAINED, 15000);
+  io.t = 14000;
+  io.level(AutoLevel::PH, true, 13500);
+  CHECK(io.offAfterMs[RA_DRAIN] < 0, "agendó con un solo sensor seco");
+  io.t = 16020;
+  io.level(AutoLevel::O2, true, 16000);
+  CHECK(io.pump[RA_DRAIN] && io.offAfterMs[RA_DRAIN] == 15000 - 20, "offAfter = %d (esperado 14980)",
+        io.offAfterMs[RA_DRAIN]);
+  // El motor apaga él mismo: cancela lo agendado
+  io.cutOnGuard(RA_DRAIN, RecipeGuard::NONE, 0);
+  CHECK(io.offAfterMs[RA_DRAIN] < 0, "desarmar no canceló offAfter");
+
+  // Guarda ya cumplida al armar: el HOLD cuenta desde el armado, no desde
+  // el flanco viejo
+  io.t = 40000;
+  io.cutOnGuard(RA_DRAIN, RecipeGuard::DRAINED, 15000);
+  CHECK(io.offAfterMs[RA_DRAIN] == 15000, "guarda previa: offAfter = %d", io.offAfterMs[RA_DRAIN]);
+  io.cutOnGuard(RA_DRAIN, RecipeGuard::NONE, 0);
+
+  // Guarda ya cumplida sin HOLD: corta al armar; desarmada antes del
+  // flanco: no corta
+  io.actuator(RA_H2O, true);
+  io.cutOnGuard(RA_H2O, RecipeGuard::H2O_OK, 0);
+  CHECK(!io.pump[RA_H2O], "H2O_OK ya cumplida al armar no cortó");   // lv[H2O] = false: con nivel
+  io.actuator(RA_KCL, true);
+  io.lv[(uint8_t)AutoLevel::KCL] = true;
+  io.cutOnGuard(RA_KCL, RecipeGuard::KCL_OK, 0);
+  io.cutOnGuard(RA_KCL, RecipeGuard::NONE, 0);
+  io.level(AutoLevel::KCL, false, io.t);
+  CHECK(io.pump[RA_KCL], "cortó una bomba desarmada");
+}
+
+int main() {
+  basicCase();
+  latencyCase();
+  cutCase();
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+// =====================================================
+// Benchmark en host de la capa de logs (log_manager)
+//  - Mismo renglón de pH y misma traza de get_last armados como antes
+//    (String concatenado) y con LOG_I / LOG_D
+//  - Mide ns y reservas de heap por llamada en cada caso:
+//      String      : como estaba (siempre arma el texto)
+//      apagado     : módulo en warn, LOG_I no evalúa sus argumentos
+//      encendido   : LOG_I formatea en la pila y entrega al sink
+//      compilado   : LOG_D con LOG_LVL_MAX=INFO (no existe en el binario)
+//  - Tamaño de código: nm --size-sort sobre el objeto (funciones pre_* /
+//    log_*), o compilar con -DLOG_LVL_MAX=4 y comparar con size
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Ibench/host -Ilib/log_manager bench/log_bench.cpp lib/log_manager/log_manager.cpp -o /tmp/log_bench
+//   /tmp/log_bench [iteraciones]
+// =====================================================
+
+#include <Arduino.h>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include "log_manager.h"
+
+// ---------- Conteo de reservas ----------
+static volatile bool     counting = false;
+static volatile uint64_t allocs = 0;
+
+void* operator new(size_t n) {
+  if (counting) allocs++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// ---------- Sink que solo cuenta (como remoteManager sin telnet) ----------
+static volatile uint32_t lines = 0;
+static volatile size_t   chars = 0;
+static void countLine(const char* s) { lines++; chars += strlen(s); }
+static void countString(const String& s) { lines++; chars += s.length(); }
+
+// Datos que cambian en cada llamada (el compilador no puede plegarlos)
+struct Sample {
+  float    ph, ci, volts, temp;
+  uint16_t n, rej;
+  uint32_t ageMs;
+};
+static volatile uint32_t tick = 0;
+static Sample next() {
+  const uint32_t t = tick++;
+  return {7.0f + (t % 100) * 0.001f, 0.004f, 1.65f + (t % 7) * 0.0001f,
+          24.5f, (uint16_t)(40 + t % 8), (uint16_t)(t % 3), t % 500};
+}
+
+// ---------- Antes: String concatenado ----------
+__attribute__((noinline)) static void pre_ph(const Sample& s) {
+  countString(
+    String("pH ") + "[2p]" + " = " + String(s.ph, 3) +
+    " ±" + String(s.ci, 3) +
+    "  V=" + String(s.volts, 4) +
+    "  n=" + String((unsigned)s.n) + (s.rej ? "/-" + String((unsigned)s.rej) : String("")) +
+    "  T=" + String(s.temp, 1) + "°C" +
+    "  edad=" + String((unsigned long)s.ageMs) + "ms");
+}
+
+// Traza de UART: con UART_TRACE_LOG=0 ya no se armaba; esto es con 1
+__attribute__((noinline)) static void pre_uart(const Sample& s) {
+  countString(String("[UART] TX get_last -> ph=") + String(s.ph) +
+              " tempC=" + String(s.temp) + " h2o=" + (s.n & 1 ? "1" : "0") +
+              " kcl=" + (s.rej ? "1" : "0") + " result=" + "CAL_PH_2PT_OK");
+}
+
+// ---------- Después ----------
+__attribute__((noinline)) static void log_ph(const Sample& s) {
+  if (LOG_ON(LOG_LVL_INFO, LogMod::SENS)) {
+    char rej[12] = "";
+    if (s.rej) snprintf(rej, sizeof(rej), "/-%u", (unsigned)s.rej);
+    LOG_I(LogMod::SENS, "pH %s = %.3f ±%.3f  V=%.4f  n=%u%s  T=%.1f°C%s  edad=%lums",
+          "[2p]", s.ph, s.ci, s.volts, (unsigned)s.n, rej, s.temp, "",
+          (unsigned long)s.ageMs);
+  }
+}
+
+__attribute__((noinline)) static void log_uart(const Sample& s) {
+  LOG_D(LogMod::UART, "[UART] TX get_last -> ph=%.2f tempC=%.2f h2o=%d kcl=%d result=%s",
+        s.ph, s.temp, (int)(s.n & 1), s.rej ? 1 : 0, "CAL_PH_2PT_OK");
+}
+
+static void run(const char* name, void (*fn)(const Sample&), long iters) {
+  for (int i = 0; i < 100; ++i) fn(next());   // calentamiento
+  const uint32_t l0 = lines;
+  allocs = 0;
+  counting = true;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < iters; ++i) fn(next());
+  const auto t1 = std::chrono::steady_clock::now();
+  counting = false;
+  const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+  printf("%-22s %10.1f %12.3f %8u\n", name, ns, (double)allocs / iters,
+         (unsigned)(lines - l0));
+}
+
+int main(int argc, char** argv) {
+  const long iters = argc > 1 ? atol(argv[1]) : 1000000;
+  logSetSink(countLine);
+
+  printf("LOG_LVL_MAX=%d (%s)\n", LOG_LVL_MAX, logLevelName(LOG_LVL_MAX));
+  printf("%-22s %10s %12s %8s\n", "caso", "ns/llamada", "allocs/llam", "lineas");
+
+  run("pH String", pre_ph, iters);
+  logSetLevel(LogMod::SENS, LOG_LVL_WARN);
+  run("pH LOG_I apagado", log_ph, iters);
+  logSetLevel(LogMod::SENS, LOG_LVL_INFO);
+  run("pH LOG_I encendido", log_ph, iters);
+
+  run("uart String", pre_uart, iters);
+  logSetLevel(LogMod::UART, LOG_LVL_DEBUG);
+  run("uart LOG_D", log_uart, iters);   // compilado fuera salvo LOG_LVL_MAX=4
+  return 0;
+}
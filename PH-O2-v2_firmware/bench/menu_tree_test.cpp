@@ -0,0 +1,237 @@
+// =====================================================
+// Prueba en host de MenuTree y RenderCache (lib/menu_manager) contra un
+// display falso (buffer de caracteres que cuenta escrituras)
+//  - Página: título + ventana de ítems con cursor, vuelta arriba/abajo,
+//    ventana que avanza en un LCD de 4 filas
+//  - RenderCache: solo escribe el tramo que cambió; nada si no cambió
+//  - Submenú y ESC; editor de valor (límites, OK guarda + aviso, ESC
+//    descarta) con su refresco periódico
+//  - Vista: render al abrir, con OK y con refreshMs; nunca entre medio
+//  - Acción: dueña del LCD hasta que tick() devuelve true; open() desde
+//    fuera; las teclas no pasan mientras corre
+//  - Aviso: se quita solo o con una tecla (que igual se procesa)
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ilib/menu_manager bench/menu_tree_test.cpp lib/menu_manager/menu_tree.cpp -o /tmp/menu_tree_test
+//   /tmp/menu_tree_test
+// =====================================================
+
+#include <stdio.h>
+#include <string.h>
+#include "menu_tree.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+// LCD de caracteres en memoria
+class FakeDisplay : public MenuDisplay {
+public:
+  static constexpr uint8_t COLS = 16, ROWS = 4;
+  char     cell[ROWS][COLS + 1];
+  uint32_t writes = 0, chars = 0, clears = 0;
+
+  FakeDisplay() { clear(); clears = 0; }
+  void clear() override {
+    for (uint8_t r = 0; r < ROWS; ++r) { memset(cell[r], ' ', COLS); cell[r][COLS] = '\0'; }
+    clears++;
+  }
+  void write(uint8_t col, uint8_t row, const char* text) override {
+    writes++;
+    for (; *text && col < COLS; ++text, ++col, ++chars) cell[row][col] = *text;
+  }
+  // Fila sin los espacios del final
+  const char* row(uint8_t r) {
+    static char out[COLS + 1];
+    memcpy(out, cell[r], COLS + 1);
+    for (int i = COLS - 1; i >= 0 && out[i] == ' '; --i) out[i] = '\0';
+    return out;
+  }
+};
+
+#define CHECK_ROW(d, r, text) CHECK(strcmp((d).row(r), text) == 0, "fila %d: \"%s\" (esperado \"%s\")", r, (d).row(r), text)
+
+// ---- Árbol de prueba ----
+static int16_t gOffset = 0;
+static int     headerCalls = 0, saves = 0, renders = 0, ticks = 0, enters = 0, exits = 0;
+static int     actionLen = 3;   // ticks hasta terminar
+
+static void header(char* out, size_t n) { headerCalls++; snprintf(out, n, "T: 21.5 C"); }
+static const char* saved(int16_t) { saves++; return "Guardado"; }
+static void render(char* l0, char* l1, size_t n) {
+  renders++;
+  snprintf(l0, n, "pH: 7.0%d", renders % 10);
+  snprintf(l1, n, "OK refrescar");
+}
+static bool actTick() { ticks++; return ticks >= actionLen; }
+static void actEnter() { enters++; }
+static void actExit() { exits++; }
+
+static const MenuValue  kVal    = { &gOffset, -10, 10, 4, "Off:%+d", header, saved, 500 };
+static const MenuView   kView   = { render, 0 };
+static const MenuView   kLive   = { render, 1000 };
+static const MenuAction kAction = { actTick, actEnter, actExit };
+
+static const MenuItem kSubItems[] = {
+  MenuItem::show("Leer pH", &kView),
+  MenuItem::show("Vivo", &kLive),
+  MenuItem::edit("Temperatura", &kVal),
+};
+static const MenuPage kSub = menuPage("Config", kSubItems);
+static const MenuItem kRootItems[] = {
+  MenuItem::submenu("Config", &kSub),
+  MenuItem::run("Automatico", &kAction),
+  MenuItem::run("Bombas", &kAction),
+  MenuItem::run("Niveles", &kAction),
+  MenuItem::run("Extra", &kAction),
+};
+static const MenuPage kRoot = menuPage("Menu", kRootItems);
+
+static void pageCase() {
+  FakeDisplay d;
+  MenuTree m;
+  m.begin(&kRoot, &d, FakeDisplay::COLS, FakeDisplay::ROWS, 0);
+  CHECK_ROW(d, 0, "Menu");
+  CHECK_ROW(d, 1, ">Config");
+  CHECK_ROW(d, 3, " Bombas");
+
+  // Sin teclas ni cambios: nada que escribir
+  const uint32_t w0 = d.writes;
+  for (uint32_t t = 10; t < 5000; t += 10) m.tick(MenuKey::NONE, t);
+  CHECK(d.writes == w0, "ticks vacíos escribieron %u veces", d.writes - w0);
+
+  // Mover el cursor: solo el primer carácter de dos filas
+  const uint32_t c0 = d.chars;
+  m.tick(MenuKey::DOWN, 5000);
+  CHECK_ROW(d, 1, " Config");
+  CHECK_ROW(d, 2, ">Automatico");
+  CHECK(d.writes == w0 + 2 && d.chars == c0 + 2, "cursor: %u escrituras, %u caracteres", d.writes - w0,
+        d.chars - c0);
+
+  // Ventana de 3 ítems: el cuarto pasa a la página siguiente
+  m.tick(MenuKey::DOWN, 5010);
+  m.tick(MenuKey::DOWN, 5020);
+  CHECK_ROW(d, 1, ">Niveles");
+  CHECK_ROW(d, 2, " Extra");
+  CHECK_ROW(d, 3, "");
+  // Vuelta arriba/abajo
+  m.tick(MenuKey::DOWN, 5030);
+  m.tick(MenuKey::DOWN, 5040);
+  CHECK(m.cursor() == 0, "vuelta abajo: cursor %u", m.cursor());
+  m.tick(MenuKey::UP, 5050);
+  CHECK(m.cursor() == 4, "vuelta arriba: cursor %u", m.cursor());
+  CHECK_ROW(d, 2, ">Extra");
+
+  // ESC en la raíz no hace nada
+  m.tick(MenuKey::ESC, 5060);
+  CHECK(m.atRoot() && m.cursor() == 4, "ESC en la raíz");
+}
+
+static void valueViewCase() {
+  FakeDisplay d;
+  MenuTree m;
+  m.begin(&kRoot, &d, FakeDisplay::COLS, 2, 0);
+  m.tick(MenuKey::OK, 10);   // Config
+  CHECK_ROW(d, 0, "Config");
+  CHECK_ROW(d, 1, ">Leer pH");
+
+  // Vista: render al abrir y con OK; sin refreshMs no redibuja sola
+  renders = 0;
+  m.tick(MenuKey::OK, 20);
+  CHECK(renders == 1, "vista al abrir: %d renders", renders);
+  CHECK_ROW(d, 0, "pH: 7.01");
+  CHECK_ROW(d, 1, "OK refrescar");
+  for (uint32_t t = 30; t < 3000; t += 10) m.tick(MenuKey::NONE, t);
+  CHECK(renders == 1, "vista sin refresco redibujó %d veces", renders - 1);
+  const uint32_t w0 = d.writes;
+  m.tick(MenuKey::OK, 3000);
+  CHECK(renders == 2 && d.writes == w0 + 1, "OK: %d renders, %u escrituras", renders, d.writes - w0);
+  CHECK_ROW(d, 0, "pH: 7.02");
+  m.tick(MenuKey::ESC, 3010);
+  CHECK(!m.active() && m.page() == &kSub, "ESC no cerró la vista");
+
+  // Vista viva: una vez por refreshMs, re-armado desde el tick que redibujó
+  // (ticks de 10 ms: 4 refrescos en 5 s además del de abrir)
+  m.tick(MenuKey::DOWN, 3020);
+  renders = 0;
+  m.tick(MenuKey::OK, 3030);
+  for (uint32_t t = 3040; t <= 8030; t += 10) m.tick(MenuKey::NONE, t);
+  CHECK(renders == 5, "vista de 1 s en 5 s: %d renders", renders);
+  m.tick(MenuKey::ESC, 8040);
+
+  // Editor: copia con límites, ESC descarta, OK guarda y avisa
+  m.tick(MenuKey::DOWN, 8050);
+  headerCalls = 0;
+  m.tick(MenuKey::OK, 8060);
+  CHECK_ROW(d, 0, "T: 21.5 C");
+  CHECK_ROW(d, 1, "Off:+0");
+  for (int i = 0; i < 4; ++i) m.tick(MenuKey::UP, 8070 + i);
+  CHECK_ROW(d, 1, "Off:+10");
+  m.tick(MenuKey::ESC, 8080);
+  CHECK(gOffset == 0 && !m.active(), "ESC guardó %d", gOffset);
+  m.tick(MenuKey::OK, 8090);
+  for (int i = 0; i < 5; ++i) m.tick(MenuKey::DOWN, 8100 + i);
+  CHECK_ROW(d, 1, "Off:-10");
+  // El encabezado se refresca cada 500 ms (la temperatura viva): abierto
+  // en 8090, redibuja en 8600, 9110, 9620 y 10130
+  headerCalls = 0;
+  for (uint32_t t = 8110; t <= 10130; t += 10) m.tick(MenuKey::NONE, t);
+  CHECK(headerCalls == 4, "encabezado en 2 s: %d", headerCalls);
+  m.tick(MenuKey::OK, 10140);
+  CHECK(gOffset == -10 && saves == 1, "OK: valor %d, saves %d", gOffset, saves);
+  CHECK_ROW(d, 0, "  Temperatura");
+  CHECK_ROW(d, 1, "    Guardado");
+  // El aviso se va solo
+  m.tick(MenuKey::NONE, 10140 + MenuTree::NOTICE_MS);
+  CHECK_ROW(d, 0, "Config");
+  CHECK_ROW(d, 1, ">Temperatura");
+  gOffset = 0;
+}
+
+static void actionCase() {
+  FakeDisplay d;
+  MenuTree m;
+  m.begin(&kRoot, &d, FakeDisplay::COLS, 2, 0);
+  ticks = enters = exits = 0;
+  actionLen = 3;
+  m.tick(MenuKey::DOWN, 10);
+  const uint32_t clears = d.clears;
+  m.tick(MenuKey::OK, 20);
+  CHECK(m.busy() && enters == 1 && d.clears == clears + 1, "acción: busy %d enters %d", m.busy(), enters);
+  // La acción escribe por su cuenta; el menú no pisa el LCD
+  d.write(0, 0, "AUTO 1/4");
+  const uint32_t w0 = d.writes;
+  m.tick(MenuKey::NONE, 30);
+  m.tick(MenuKey::NONE, 40);
+  CHECK(m.busy() && d.writes == w0 && ticks == 2, "acción: el menú escribió o no llamó tick()");
+  m.tick(MenuKey::NONE, 50);
+  CHECK(!m.busy() && exits == 1, "acción no terminó");
+  CHECK_ROW(d, 0, "Menu");   // redibujo completo: la caché se invalidó
+  CHECK_ROW(d, 1, ">Automatico");
+
+  // Abrir desde fuera (AUTO por UART), y no dos veces
+  ticks = 0;
+  m.open(&kRootItems[1], 100);
+  m.open(&kRootItems[2], 100);
+  CHECK(m.busy() && m.active() == &kRootItems[1] && enters == 2, "open() externo");
+  for (uint32_t t = 110; t < 200; t += 10) m.tick(MenuKey::NONE, t);
+  CHECK(!m.busy() && exits == 2, "acción externa no terminó");
+
+  // Aviso: lo quita una tecla, que igual se procesa
+  m.notice("Hola", "Mundo", 5000, 300);
+  CHECK_ROW(d, 0, "      Hola");
+  m.tick(MenuKey::UP, 310);
+  CHECK(m.cursor() == 0, "la tecla que quitó el aviso no se procesó: cursor %u", m.cursor());
+  CHECK_ROW(d, 0, "Menu");
+  CHECK_ROW(d, 1, ">Config");
+}
+
+int main() {
+  pageCase();
+  valueViewCase();
+  actionCase();
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,288 @@
+// =====================================================
+// Prueba en host del transporte 1-Wire por UART
+// (lib/OneWire-master/util/OneWire_uart_codec.h) sobre formas de onda
+//  - Línea open-drain: el que tira a 0 gana (caída de 50 ns), con pull-up
+//    subida RC de constante tau; muestreo cada 0.25 us
+//  - TX del maestro: caracteres 8N1 del codec a 9600 (reset) y 115200
+//    (slots), uno detrás de otro como los manda el FIFO
+//  - RX del maestro: receptor UART con histéresis (VIL 0.25, VIH 0.75 de
+//    VDD, ESP32) que detecta el bit de start y muestrea cada bit en su
+//    centro; decodeReset/decodeSlot/decodeByte sobre ese eco
+//  - Esclavo DS18B20: ve un reset tras >= 480 us en bajo y contesta la
+//    presencia tPDH/tPDL después de la subida; en cada slot muestrea a
+//    tSample del flanco (escritura) o sostiene el 0 tHold (lectura)
+//  - Casos: presencia en las esquinas de tPDH/tPDL y varios tau, bus
+//    vacío y en corto, tiempos en bajo de escritura 0/1 contra la hoja de
+//    datos, lectura de 0/1 con tHold 15..60 us, bytes ida y vuelta, y el
+//    tau máximo con que una lectura de 1 todavía decodifica
+//  - Límites conocidos (nota del codec): tPDH = tPDL = 60 us no se ve
+//    (se informa, no falla) y lectura de 1 solo hasta tau ~3 us
+//  - Con un directorio como argumento guarda las formas de onda en CSV
+//    (t_us, v, maestro, esclavo) para verlas con cualquier graficador
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ilib/OneWire-master/util bench/onewire_uart_wave_test.cpp -o /tmp/onewire_uart_wave_test
+//   /tmp/onewire_uart_wave_test [directorio_csv]
+// =====================================================
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "OneWire_uart_codec.h"
+
+using namespace OneWireUart;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const double DT = 0.25;           // us
+static const double VIL = 0.25, VIH = 0.75;
+static const char*  csvDir = nullptr;
+
+// ---- Esclavo 1-Wire ----
+struct Slave {
+  bool   present = true;
+  double tPDH = 30, tPDL = 120;          // presencia
+  double tSample = 30;                   // muestreo de un slot de escritura
+  double tHold = 30;                     // 0 sostenido en un slot de lectura
+  std::vector<uint8_t> answer;           // bits a contestar (lectura)
+  std::vector<uint8_t> sampled;          // bits vistos (escritura)
+  bool   sawReset = false;
+
+  // Estado interno
+  bool   level = true;                   // nivel digital que ve el esclavo
+  double lowSince = 0, edge = -1;
+  double pullFrom = 0, pullUntil = -1;   // pulso propio (presencia o 0 leído)
+  bool   sampledThis = true, inReset = false;
+  size_t next = 0;
+
+  bool pulling(double t) const { return t >= pullFrom && t < pullUntil; }
+
+  void see(double t, double v) {
+    const bool was = level;
+    if (v < VIL) level = false;
+    else if (v > VIH) level = true;
+    if (was && !level) {                 // flanco de bajada
+      lowSince = t;
+      if (t >= pullUntil) {              // no es el propio pulso
+        edge = t;
+        sampledThis = false;
+        if (present && next < answer.size() && !answer[next++]) { pullFrom = t; pullUntil = t + tHold; }
+      }
+    }
+    if (!was && level && present && t - lowSince >= 480) {   // fin de un reset
+      sawReset = true;
+      inReset = true;
+      pullFrom = t + tPDH;
+      pullUntil = pullFrom + tPDL;
+      sampled.clear();
+      next = 0;
+    }
+    // Slot de escritura: el esclavo muestrea tSample después del flanco
+    if (!sampledThis && !inReset && t - edge >= tSample) {
+      sampledThis = true;
+      if (answer.empty()) sampled.push_back(level ? 1 : 0);
+    }
+    if (inReset && t >= pullUntil) inReset = false;
+  }
+};
+
+// ---- Transmisión de caracteres 8N1 por el pin compartido ----
+struct Wave { std::vector<double> t, v; std::vector<uint8_t> m, s; };
+
+struct Result {
+  std::vector<uint8_t> echo;             // caracteres recibidos
+  uint32_t framing = 0;                  // bit de stop leído en 0
+  std::vector<double> lowTimes;          // duración de cada pulso bajo de la línea
+};
+
+// Manda los caracteres a baud y devuelve los ecos del receptor
+static Result transmit(const std::vector<uint8_t>& chars, uint32_t baud, double tau, Slave* slave,
+                       bool shorted = false, const char* csvName = nullptr) {
+  const double bitUs = 1e6 / baud;
+  const double frameUs = 10 * bitUs;
+  const double total = chars.size() * frameUs + 400;
+  Result r;
+  Wave w;
+  double v = 1.0;
+  bool rxLevel = true, rxBusy = false;
+  double rxStart = 0;
+  uint8_t rxBits = 0;
+  int rxIdx = 0;
+  double lowStart = -1;
+
+  for (double t = 0; t < total; t += DT) {
+    // Maestro: bit del frame en curso (start 0, datos LSB primero, stop 1)
+    bool mLow = false;
+    const size_t c = (size_t)(t / frameUs);
+    if (c < chars.size()) {
+      const int bit = (int)((t - c * frameUs) / bitUs);
+      if (bit == 0) mLow = true;
+      else if (bit <= 8) mLow = !((chars[c] >> (bit - 1)) & 1);
+    }
+    const bool sLow = slave && slave->pulling(t);
+    const bool low = shorted || mLow || sLow;
+    v = low ? v * exp(-DT / 0.05) : 1 - (1 - v) * exp(-DT / tau);
+    if (slave) slave->see(t, v);
+
+    // Pulsos bajos de la línea (con el umbral del esclavo)
+    if (v < VIL && lowStart < 0) lowStart = t;
+    if (v > VIL && lowStart >= 0) { r.lowTimes.push_back(t - lowStart); lowStart = -1; }
+
+    // Receptor UART
+    const bool was = rxLevel;
+    if (v < VIL) rxLevel = false;
+    else if (v > VIH) rxLevel = true;
+    if (!rxBusy && was && !rxLevel) { rxBusy = true; rxStart = t; rxBits = 0; rxIdx = 0; }
+    if (rxBusy) {
+      const double at = rxStart + (rxIdx + 1.5) * bitUs;
+      if (t >= at) {
+        if (rxIdx < 8) { if (rxLevel) rxBits |= (uint8_t)(1u << rxIdx); rxIdx++; }
+        else {
+          if (!rxLevel) r.framing++;
+          r.echo.push_back(rxBits);
+          rxBusy = false;
+        }
+      }
+    }
+
+    if (csvName) { w.t.push_back(t); w.v.push_back(v); w.m.push_back(mLow); w.s.push_back(sLow); }
+  }
+  if (rxBusy) r.echo.push_back(rxBits);   // corto: nunca llega el stop
+
+  if (csvName && csvDir) {
+    const std::string path = std::string(csvDir) + "/" + csvName + ".csv";
+    FILE* f = fopen(path.c_str(), "w");
+    if (f) {
+      fprintf(f, "t_us,v,maestro,esclavo\n");
+      for (size_t i = 0; i < w.t.size(); ++i) fprintf(f, "%.2f,%.4f,%u,%u\n", w.t[i], w.v[i], w.m[i], w.s[i]);
+      fclose(f);
+    }
+  }
+  return r;
+}
+
+static Presence resetWith(Slave* s, double tau, bool shorted = false, const char* csv = nullptr) {
+  const Result r = transmit({ RESET_TX }, RESET_BAUD, tau, s, shorted, csv);
+  return r.echo.empty() ? PRESENCE_NONE : decodeReset(r.echo[0]);
+}
+
+static void presenceCase() {
+  const double pdh[] = { 15, 30, 45, 60 };
+  const double pdl[] = { 60, 120, 240 };
+  const double taus[] = { 0.5, 1.0, 3.0 };
+  int ok = 0, total = 0;
+  std::string missed;
+  for (double h : pdh) for (double l : pdl) for (double tau : taus) {
+    Slave s;
+    s.tPDH = h; s.tPDL = l;
+    const Presence p = resetWith(&s, tau);
+    total++;
+    if (p == PRESENCE_OK) { ok++; continue; }
+    char b[48];
+    snprintf(b, sizeof(b), " %g/%g@%g", h, l, tau);
+    missed += b;
+    // Único caso fuera de alcance: las dos esquinas a 60 us
+    CHECK(h == 60 && l == 60, "presencia tPDH %g tPDL %g tau %g: %d", h, l, tau, (int)p);
+  }
+  printf("presencia: %d de %d combinaciones tPDH/tPDL/tau (no vistas:%s)\n", ok, total, missed.c_str());
+
+  Slave typical;
+  CHECK(resetWith(&typical, 1.0, false, "reset_presencia") == PRESENCE_OK && typical.sawReset, "reset típico");
+  CHECK(resetWith(nullptr, 1.0, false, "reset_vacio") == PRESENCE_NONE, "bus vacío");
+  CHECK(resetWith(nullptr, 1.0, true) == PRESENCE_SHORTED, "bus en corto");
+  Slave absent;
+  absent.present = false;
+  CHECK(resetWith(&absent, 1.0) == PRESENCE_NONE, "esclavo ausente");
+
+  // Tiempo en bajo del reset: >= 480 us (tRSTL)
+  const Result r = transmit({ RESET_TX }, RESET_BAUD, 1.0, nullptr);
+  CHECK(!r.lowTimes.empty() && r.lowTimes[0] >= 480, "reset en bajo %.1f us", r.lowTimes.empty() ? 0 : r.lowTimes[0]);
+}
+
+static void writeSlotCase() {
+  // Tiempos en bajo: escritura 0 60..120 us (tLOW0), escritura 1 1..15 us (tLOW1)
+  const Result w0 = transmit({ SLOT_0 }, SLOT_BAUD, 1.0, nullptr, false, "slot_escritura_0");
+  const Result w1 = transmit({ SLOT_1 }, SLOT_BAUD, 1.0, nullptr, false, "slot_escritura_1");
+  printf("escritura: 0 en bajo %.1f us, 1 en bajo %.1f us, slot %.1f us\n",
+         w0.lowTimes[0], w1.lowTimes[0], 10e6 / SLOT_BAUD);
+  CHECK(w0.lowTimes.size() == 1 && w0.lowTimes[0] >= 60 && w0.lowTimes[0] <= 120, "tLOW0 = %.1f us", w0.lowTimes[0]);
+  CHECK(w1.lowTimes.size() == 1 && w1.lowTimes[0] >= 1 && w1.lowTimes[0] <= 15, "tLOW1 = %.1f us", w1.lowTimes[0]);
+  CHECK(10e6 / SLOT_BAUD >= 60 && 10e6 / SLOT_BAUD <= 120, "tSLOT fuera de 60..120 us");
+  CHECK(w0.framing == 0 && w1.framing == 0, "framing en escritura");
+
+  // El esclavo muestrea entre 15 y 60 us: lee lo escrito
+  const double taus[] = { 0.5, 1.0, 3.0 };
+  const double samples[] = { 15, 30, 60 };
+  for (double tau : taus) for (double ts : samples) {
+    Slave s;
+    s.tSample = ts;
+    uint8_t tx[8];
+    encodeByte(0xA5, tx);
+    transmit(std::vector<uint8_t>(tx, tx + 8), SLOT_BAUD, tau, &s);
+    uint8_t got = 0;
+    for (size_t i = 0; i < s.sampled.size() && i < 8; ++i) got |= (uint8_t)(s.sampled[i] << i);
+    CHECK(s.sampled.size() == 8 && got == 0xA5, "escritura 0xA5 tau %g tSample %g: %zu bits, %02X", tau, ts,
+          s.sampled.size(), got);
+  }
+}
+
+static uint8_t readByteFrom(uint8_t value, double tau, double hold, uint32_t* framing = nullptr, const char* csv = nullptr) {
+  Slave s;
+  s.tHold = hold;
+  for (int i = 0; i < 8; ++i) s.answer.push_back((value >> i) & 1);
+  uint8_t tx[8];
+  encodeByte(0xFF, tx);
+  const Result r = transmit(std::vector<uint8_t>(tx, tx + 8), SLOT_BAUD, tau, &s, false, csv);
+  if (framing) *framing = r.framing;
+  return r.echo.size() == 8 ? decodeByte(r.echo.data()) : 0xEE;
+}
+
+static void readSlotCase() {
+  const double taus[] = { 0.5, 1.0, 2.0, 3.0 };
+  const double holds[] = { 15, 30, 60 };
+  for (double tau : taus) for (double hold : holds) {
+    uint32_t framing = 0;
+    const uint8_t got = readByteFrom(0x5A, tau, hold, &framing);
+    CHECK(got == 0x5A && framing == 0, "lectura 0x5A tau %g tHold %g: %02X, framing %u", tau, hold, got, framing);
+  }
+  readByteFrom(0x02, 1.0, 30, nullptr, "slots_lectura_0x02");
+
+  // tau máximo con el que un byte todavía vuelve bien (pull-up/capacidad)
+  double maxTau = 0;
+  for (double tau = 0.5; tau <= 12.0; tau += 0.25) {
+    if (readByteFrom(0x5A, tau, 30) != 0x5A) break;
+    maxTau = tau;
+  }
+  printf("lectura: bytes correctos hasta tau = %.2f us (%.1f nF con 4k7)\n", maxTau, maxTau / 4.7);
+  CHECK(maxTau >= 3.0, "lectura falla con tau %.2f us", maxTau + 0.25);
+
+  // Todos los bytes ida y vuelta
+  int bad = 0;
+  for (int v = 0; v < 256; ++v) {
+    if (readByteFrom((uint8_t)v, 1.0, 30) != v) bad++;
+    Slave s;
+    uint8_t tx[8];
+    encodeByte((uint8_t)v, tx);
+    transmit(std::vector<uint8_t>(tx, tx + 8), SLOT_BAUD, 1.0, &s);
+    uint8_t got = 0;
+    for (size_t i = 0; i < s.sampled.size() && i < 8; ++i) got |= (uint8_t)(s.sampled[i] << i);
+    if (got != v || s.sampled.size() != 8) bad++;
+  }
+  CHECK(bad == 0, "%d bytes no vuelven iguales", bad);
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) csvDir = argv[1];
+  presenceCase();
+  writeSlotCase();
+  readSlotCase();
+  if (csvDir) printf("formas de onda en %s/*.csv\n", csvDir);
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+// =====================================================
+// Benchmark en host de PHEstimator (lib/ph_manager) sobre trazas de
+// códigos del ADS1115 reproducidas conversión a conversión
+//  - Config de src/main.cpp: GAIN_ONE (1 LSB = 0.125 mV), 250 SPS en
+//    continuo sobre A0; cada readPH() consume las conversiones siguientes
+//    de la traza, como las entrega readConversion() desde el anillo
+//  - No hay trazas grabadas en el repo: las de fábrica son SINTÉTICAS
+//    (semilla fija), cuantizadas a códigos int16. Con un archivo (un
+//    código por línea) se reproduce esa traza en lugar de las sintéticas
+//  - Por presupuesto: conversiones usadas, ruido estimado (frente al sigma
+//    real de la traza), error rms del valor y latencia MODELADA =
+//    conversiones x 4 ms (en continuo la lectura I2C se solapa con la
+//    conversión siguiente); no es una medición en el ESP32
+//  - Presupuestos: tope 16/48/96 con IC95 ±0.01 pH (default de PHManager,
+//    pendiente 59 mV/pH) y 48 fijas sin salida temprana
+//  - FALLA si el ruido estimado se aleja más del 20% del real (ruido
+//    blanco, presupuesto completo), si con espigas el error rms pasa de
+//    sigma/sqrt(minSamples) + 1 LSB o si una lectura pasa de maxSamples
+//  Resultado (48 ±0.01 pH): 11-12 conversiones (44-49 ms) hasta 0.5 mV
+//  de ruido, con espigas o 60 Hz; 36 (146 ms) con 2 mV. El ruido estimado
+//  queda 11-17% bajo el real con ruido blanco (Hampel recorta las colas)
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ilib/ph_manager bench/ph_estimator_bench.cpp lib/ph_manager/ph_estimator.cpp -o /tmp/ph_estimator_bench
+//   /tmp/ph_estimator_bench [traza.txt]
+// =====================================================
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "ph_estimator.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const double LSB_V   = 4.096 / 32768.0;   // GAIN_ONE
+static const double CONV_MS = 1000.0 / 250.0;    // 250 SPS
+static const double SLOPE_V = 0.059;             // V/pH (sin calibración: pendiente de Nernst)
+static const float  CI_V    = (float)(0.01 * SLOPE_V);   // ±0.01 pH, el default de PHManager
+static const int    READS   = 300;               // lecturas por traza y presupuesto
+
+// ---- Trazas sintéticas ----
+static uint32_t rng = 0x2545F491;
+static double uniform() {
+  rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+  return (rng + 1.0) / 4294967297.0;
+}
+static double gauss() { return sqrt(-2 * log(uniform())) * cos(2 * M_PI * uniform()); }
+
+struct Trace {
+  const char* name;
+  double sigmaV;        // ruido blanco
+  double humV;          // amplitud de 60 Hz (vista a 250 SPS)
+  double spikeProb;     // fracción de espigas de ±20 mV
+  double trueV;         // valor de referencia; NAN si la traza es externa
+  double trueSigmaV;    // sigma real sin espigas; NAN si se desconoce
+  std::vector<int16_t> codes;
+};
+
+static void synth(Trace& t, size_t n) {
+  const double base = 1.652;   // ~pH 7 a la salida del front-end
+  t.codes.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    double v = base + t.sigmaV * gauss() + t.humV * sin(2 * M_PI * 60.0 * i * CONV_MS / 1000.0);
+    if (uniform() < t.spikeProb) v += (uniform() < 0.5 ? -0.020 : 0.020);
+    t.codes[i] = (int16_t)floor(v / LSB_V + 0.5);
+  }
+  t.trueV = base;
+  // Cuantización uniforme (LSB²/12) y 60 Hz (A²/2) se suman al blanco
+  t.trueSigmaV = sqrt(t.sigmaV * t.sigmaV + t.humV * t.humV / 2 + LSB_V * LSB_V / 12);
+}
+
+static bool load(Trace& t, const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  int c;
+  while (fscanf(f, "%d", &c) == 1) t.codes.push_back((int16_t)c);
+  fclose(f);
+  if (t.codes.empty()) return false;
+  // Sin valor de referencia: se toma la mediana de toda la traza
+  std::vector<int16_t> s(t.codes);
+  std::nth_element(s.begin(), s.begin() + s.size() / 2, s.end());
+  t.trueV = s[s.size() / 2] * LSB_V;
+  t.trueSigmaV = NAN;
+  return true;
+}
+
+struct Budget {
+  const char* name;
+  uint16_t maxSamples, minSamples;
+  float    ciTarget;
+};
+
+static const Budget BUDGETS[] = {
+  {"16 IC",  16, 8, CI_V},
+  {"48 IC",  48, 8, CI_V},
+  {"96 IC",  96, 8, CI_V},
+  {"48 fijo",   48, 8, 0.0f},
+};
+
+struct Stats {
+  double pushed = 0, noiseV = 0, errRmsV = 0, rejected = 0, convergedPct = 0;
+  uint16_t maxPushed = 0;
+};
+
+// Reproduce la traza lectura tras lectura (con vuelta al principio)
+static Stats run(const Trace& t, const Budget& b) {
+  Stats s;
+  size_t pos = 0;
+  int withNoise = 0;
+  for (int r = 0; r < READS; ++r) {
+    PHEstimator est;
+    PHSampleBudget pb;
+    pb.maxSamples = b.maxSamples;
+    pb.minSamples = b.minSamples;
+    pb.ciTarget = b.ciTarget;
+    est.begin(pb, (float)LSB_V);
+    while (!est.push((float)(t.codes[pos] * LSB_V))) pos = (pos + 1) % t.codes.size();
+    pos = (pos + 1) % t.codes.size();
+
+    const PHEstimate& e = est.result();
+    s.pushed += est.pushed();
+    if (est.pushed() > s.maxPushed) s.maxPushed = est.pushed();
+    s.rejected += e.rejected;
+    s.convergedPct += e.converged;
+    const double err = e.value - t.trueV;
+    s.errRmsV += err * err;
+    if (isfinite(e.noise)) { s.noiseV += e.noise; withNoise++; }
+  }
+  s.pushed /= READS;
+  s.rejected /= READS;
+  s.convergedPct *= 100.0 / READS;
+  s.errRmsV = sqrt(s.errRmsV / READS);
+  s.noiseV = withNoise ? s.noiseV / withNoise : NAN;
+  return s;
+}
+
+int main(int argc, char** argv) {
+  std::vector<Trace> traces;
+  if (argc > 1) {
+    Trace t = {argv[1], 0, 0, 0, NAN, NAN, {}};
+    if (!load(t, argv[1])) {
+      printf("no se pudo leer %s\n", argv[1]);
+      return 1;
+    }
+    traces.push_back(t);
+  } else {
+    traces.push_back({"limpia 0.1 mV", 0.0001, 0, 0, 0, 0, {}});
+    traces.push_back({"ruido 0.5 mV",  0.0005, 0, 0, 0, 0, {}});
+    traces.push_back({"ruido 2 mV",    0.0020, 0, 0, 0, 0, {}});
+    traces.push_back({"60 Hz 1 mV",    0.0002, 0.001, 0, 0, 0, {}});
+    traces.push_back({"espigas 2%",    0.0005, 0, 0.02, 0, 0, {}});
+    for (Trace& t : traces) synth(t, 50000);
+  }
+
+  printf("%-14s %-8s %7s %7s %9s %9s %9s %6s %9s\n", "traza", "presup.", "conv", "desc.",
+         "ruido mV", "real mV", "err mV", "IC %", "lat. ms");
+  for (const Trace& t : traces) {
+    for (const Budget& b : BUDGETS) {
+      const Stats s = run(t, b);
+      printf("%-14s %-8s %7.1f %7.2f %9.3f %9.3f %9.3f %6.0f %9.1f\n", t.name, b.name, s.pushed, s.rejected,
+             s.noiseV * 1e3, t.trueSigmaV * 1e3, s.errRmsV * 1e3, s.convergedPct, s.pushed * CONV_MS);
+
+      CHECK(s.maxPushed <= b.maxSamples, "%s / %s: %u conversiones", t.name, b.name, s.maxPushed);
+      if (argc > 1) continue;
+      if (b.ciTarget == 0.0f && t.spikeProb == 0.0 && t.humV == 0.0)
+        CHECK(fabs(s.noiseV / t.trueSigmaV - 1.0) < 0.20, "%s: ruido %.3f mV frente a %.3f mV", t.name,
+              s.noiseV * 1e3, t.trueSigmaV * 1e3);
+      if (t.spikeProb > 0.0)
+        CHECK(s.errRmsV < t.sigmaV / sqrt((double)b.minSamples) + LSB_V,
+              "%s / %s: error %.3f mV con espigas", t.name, b.name, s.errRmsV * 1e3);
+    }
+  }
+
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+// =====================================================
+// Prueba en host de PumpsManager (lib/pumps_manager) contra un PCF8574
+// falso en el Wire de bench/host y los esp_timer del reloj simulado
+//  - Transacción: un solo write8 para todos los cambios
+//  - Tope: el timer corta a maxOnMs, takeTripped() lo informa una vez;
+//    off() antes del tope no corta
+//  - Corte sin ACK: el canal queda pendiente, el timer reintenta cada 1 ms
+//    (offWriteFails) y recién con el write confirmado cuenta como corte
+//  - Corte con la verificación fallida (pin que no baja): igual
+//  - offAfterMs() sin ACK: plannedOffs solo al confirmar, nunca tripped
+//  - on() a mano mientras el corte está pendiente lo deja sin efecto
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ibench/host -Ilib/pumps_manager bench/pumps_cutoff_test.cpp lib/pumps_manager/pumps_manager.cpp -o /tmp/pumps_cutoff_test
+//   /tmp/pumps_cutoff_test
+// =====================================================
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <stdio.h>
+#include "pumps_manager.h"
+
+TwoWire Wire;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const uint8_t ADDR = 0x20;
+
+// PCF8574: los pines siguen al último byte escrito; stuckHigh fuerza bits
+// en 1 al leer (relé pegado / pin en corto)
+class FakePcf : public HostI2CDevice {
+public:
+  uint8_t  pins = 0xFF, stuckHigh = 0;
+  uint32_t writes = 0;
+  void i2cWrite(const uint8_t* buf, size_t n) override { pins = buf[n - 1]; writes++; }
+  size_t i2cRead(uint8_t* buf, size_t n) override {
+    for (size_t i = 0; i < n; ++i) buf[i] = pins | stuckHigh;
+    return n;
+  }
+};
+
+static FakePcf pcf;
+static void ack(bool on) { Wire.attach(ADDR, on ? &pcf : nullptr); }
+static uint8_t bit(PumpId id) { return (uint8_t)(1u << (uint8_t)id); }
+
+static void txCase(PumpsManager& p) {
+  const uint32_t w0 = pcf.writes;
+  p.beginTx();
+  p.kclOn();
+  p.h2oOn();
+  p.beginTx();   // anidada: no escribe
+  p.mixerOn();
+  p.commitTx();
+  CHECK(pcf.writes == w0, "escribió antes del commit externo");
+  CHECK(p.commitTx(), "commit");
+  CHECK(pcf.writes == w0 + 1 && pcf.pins == (bit(PumpId::KCL) | bit(PumpId::H2O) | bit(PumpId::MIXER)),
+        "transacción: %u writes, pines 0x%02X", pcf.writes - w0, pcf.pins);
+  p.allOff();
+  CHECK(pcf.pins == 0, "allOff: pines 0x%02X", pcf.pins);
+}
+
+static void maxOnCase(PumpsManager& p) {
+  p.setMaxOnMs(PumpId::KCL, 100);
+  p.kclOn();
+  delay(99);
+  CHECK(p.isOn(PumpId::KCL) && p.takeTripped() == 0, "cortó antes del tope");
+  delay(2);
+  CHECK(!p.isOn(PumpId::KCL) && !(pcf.pins & bit(PumpId::KCL)), "no cortó al tope");
+  CHECK(p.takeTripped() == bit(PumpId::KCL) && p.takeTripped() == 0, "takeTripped");
+  CHECK(p.forcedOffs() == 1, "forcedOffs %u", p.forcedOffs());
+
+  // off() a tiempo desarma el tope
+  p.kclOn();
+  delay(50);
+  p.kclOff();
+  delay(200);
+  CHECK(p.takeTripped() == 0 && p.forcedOffs() == 1, "cortó un canal ya apagado");
+}
+
+static void nackCase(PumpsManager& p) {
+  p.setMaxOnMs(PumpId::H2O, 100);
+  p.h2oOn();
+  const uint32_t forced = p.forcedOffs(), fails = p.offWriteFails();
+  ack(false);
+  delay(101);
+  CHECK(!p.isOn(PumpId::H2O) && (pcf.pins & bit(PumpId::H2O)), "sin ACK: la bomba tendría que seguir física");
+  CHECK(p.takeTripped() == 0 && p.forcedOffs() == forced, "sin ACK informó el corte");
+  CHECK(p.offWriteFails() == fails + 1, "offWriteFails %u", p.offWriteFails() - fails);
+  delay(5);
+  CHECK(p.offWriteFails() >= fails + 5, "no reintentó cada 1 ms: %u", p.offWriteFails() - fails);
+  ack(true);
+  delay(2);
+  CHECK(!(pcf.pins & bit(PumpId::H2O)), "reintento con ACK no apagó");
+  CHECK(p.takeTripped() == bit(PumpId::H2O) && p.forcedOffs() == forced + 1, "corte confirmado no informado");
+  const uint32_t after = p.offWriteFails(), w0 = pcf.writes;
+  delay(20);
+  CHECK(p.offWriteFails() == after && pcf.writes == w0, "siguió reintentando después de confirmar");
+}
+
+static void verifyCase(PumpsManager& p) {
+  p.setMaxOnMs(PumpId::DRAIN, 50);
+  p.drainOn();
+  const uint32_t vf = p.verifyFails(), forced = p.forcedOffs();
+  pcf.stuckHigh = bit(PumpId::DRAIN);
+  delay(51);
+  CHECK(p.verifyFails() >= vf + 2 && p.takeTripped() == 0 && p.forcedOffs() == forced,
+        "verificación fallida: verifyFails +%u, forcedOffs +%u", p.verifyFails() - vf, p.forcedOffs() - forced);
+  pcf.stuckHigh = 0;
+  delay(2);
+  CHECK(p.takeTripped() == bit(PumpId::DRAIN) && p.forcedOffs() == forced + 1, "corte verificado no informado");
+}
+
+static void plannedCase(PumpsManager& p) {
+  p.sample1On();
+  p.offAfterMs(PumpId::SAMPLE1, 30);
+  const uint32_t planned = p.plannedOffs();
+  ack(false);
+  delay(31);
+  CHECK(p.plannedOffs() == planned, "agendado sin ACK contado");
+  ack(true);
+  delay(2);
+  CHECK(!(pcf.pins & bit(PumpId::SAMPLE1)) && p.plannedOffs() == planned + 1 && p.takeTripped() == 0,
+        "agendado: plannedOffs +%u", p.plannedOffs() - planned);
+}
+
+static void manualOnCase(PumpsManager& p) {
+  p.setMaxOnMs(PumpId::SAMPLE2, 40);
+  p.sample2On();
+  const uint32_t forced = p.forcedOffs();
+  ack(false);
+  delay(41);
+  ack(true);
+  p.sample2On();   // el control lo vuelve a pedir antes del reintento
+  delay(2);
+  CHECK(p.isOn(PumpId::SAMPLE2) && (pcf.pins & bit(PumpId::SAMPLE2)), "el reintento pisó un on() posterior");
+  CHECK(p.takeTripped() == 0 && p.forcedOffs() == forced, "corte anulado informado");
+  // El tope vuelve a correr desde el on() confirmado
+  delay(40);
+  CHECK(!(pcf.pins & bit(PumpId::SAMPLE2)) && p.takeTripped() == bit(PumpId::SAMPLE2), "tope re-armado");
+}
+
+int main() {
+  ack(true);
+  PumpsManager p;
+  CHECK(p.begin(ADDR, 21, 22, 100000, true), "begin");
+  CHECK(pcf.pins == 0, "begin: pines 0x%02X", pcf.pins);
+
+  txCase(p);
+  maxOnCase(p);
+  nackCase(p);
+  verifyCase(p);
+  plannedCase(p);
+  manualOnCase(p);
+
+  printf("writes %u, sin ACK %u, verif %u (%u fallas), cortes %u (sin write %u), agendados %u\n",
+         (unsigned)p.writes(), (unsigned)p.writeErrors(), (unsigned)p.verifies(), (unsigned)p.verifyFails(),
+         (unsigned)p.forcedOffs(), (unsigned)p.offWriteFails(), (unsigned)p.plannedOffs());
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,403 @@
+// =====================================================
+// Prueba en host de RecipeEngine y de la receta de fábrica
+// (lib/recipe_engine) con un RecipeIO guionado y reloj virtual
+//  - Formato: RecipeStep de 10 bytes empaquetado, validación de recetas
+//  - Receta de fábrica: orden de actuadores, H2O y KCL en paralelo, JOIN,
+//    pausas RS_PAUSE (y pauseMs = 0), tiempo total exacto, todo apagado
+//  - Timeout de una guarda: aborta en ese paso y apaga lo encendido;
+//    RS_SOFT solo lo registra y sigue
+//  - ON/OFF/CHECK se encadenan en el mismo tick; CHECK o hook en FAIL
+//    abortan; tope del hook
+//  - RS_ASYNC: hasta MAX_PARALLEL en paralelo, el quinto espera lugar;
+//    abort() apaga también los de segundo plano
+//  - guardSince(): el HOLD cuenta desde el flanco, no desde el tick
+//  - cutOnGuard(): PUMP con guarda arma su bomba con afterMs = HOLD; WAIT
+//    con guarda arma lo encendido que se apaga después sin otra espera de
+//    sensor/hook (afterMs = HOLD + WAIT fijos); se desarma al apagar o si
+//    la guarda vence
+//  Resultado: la receta de fábrica dura 62.0 s con pausas de 1.5 s y
+//  59.0 s sin ellas (drenaje de 4 + 15 s, sensores mojados a los 2 s)
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ilib/recipe_engine bench/recipe_engine_test.cpp lib/recipe_engine/recipe.cpp lib/recipe_engine/recipe_engine.cpp -o /tmp/recipe_engine_test
+//   /tmp/recipe_engine_test
+// =====================================================
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "recipe_engine.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const uint32_t NEVER = 0xFFFFFFFFu;
+
+// IO guionado: cada guarda se cumple desde un instante fijo; los hooks
+// terminan después de hookMs[id]
+class ScriptIO : public RecipeIO {
+public:
+  uint32_t t = 0;
+  uint32_t guardAt[(uint8_t)RecipeGuard::COUNT];
+  uint32_t edgeAt[(uint8_t)RecipeGuard::COUNT];   // para guardSince (NEVER = no lo sabe)
+  uint32_t params[(uint8_t)RecipeParam::COUNT];
+  uint32_t hookMs[RH_COUNT] = { 0, 0, 0 };
+  RecipeHookStatus hookEnd[RH_COUNT] = { RecipeHookStatus::DONE, RecipeHookStatus::DONE, RecipeHookStatus::DONE };
+
+  struct Ev { uint32_t t; uint8_t act; bool on; };
+  std::vector<Ev> events;
+  bool on[RA_COUNT] = { false };
+  int  maxOn = 0;
+  struct Arm { uint8_t act; RecipeGuard g; uint32_t afterMs; };
+  std::vector<Arm> arms;
+  RecipeGuard armG[RA_COUNT] = {};
+  uint32_t    armAfter[RA_COUNT] = {};
+  std::vector<RecipeStepReport> reports;
+
+  ScriptIO() {
+    for (uint8_t i = 0; i < (uint8_t)RecipeGuard::COUNT; ++i) { guardAt[i] = 0; edgeAt[i] = NEVER; }
+    for (uint8_t i = 0; i < (uint8_t)RecipeParam::COUNT; ++i) params[i] = 0;
+    params[(uint8_t)RecipeParam::KCL_FILL]       = 3000;
+    params[(uint8_t)RecipeParam::H2O_FILL]       = 3000;
+    params[(uint8_t)RecipeParam::SAMPLE_FILL]    = 3000;
+    params[(uint8_t)RecipeParam::DRAIN]          = 15000;
+    params[(uint8_t)RecipeParam::SAMPLE_TIMEOUT] = 3000;
+    params[(uint8_t)RecipeParam::DRAIN_TIMEOUT]  = 15000;
+    params[(uint8_t)RecipeParam::STABILIZATION]  = 30000;
+  }
+
+  uint32_t now() override { return t; }
+  void actuator(uint8_t act, bool v) override {
+    events.push_back({ t, act, v });
+    on[act] = v;
+    int n = 0;
+    for (bool b : on) n += b;
+    if (n > maxOn) maxOn = n;
+  }
+  bool guard(RecipeGuard g) override { return t >= guardAt[(uint8_t)g]; }
+  uint32_t param(RecipeParam p, uint8_t) override { return params[(uint8_t)p]; }
+  RecipeHookStatus hook(uint8_t id, bool enter, uint32_t) override {
+    if (enter) hookT0_[id] = t;
+    return (t - hookT0_[id] >= hookMs[id]) ? hookEnd[id] : RecipeHookStatus::RUNNING;
+  }
+  uint32_t guardSince(RecipeGuard g, uint32_t n) override {
+    return edgeAt[(uint8_t)g] != NEVER ? edgeAt[(uint8_t)g] : n;
+  }
+  void cutOnGuard(uint8_t act, RecipeGuard g, uint32_t afterMs) override {
+    if (g != RecipeGuard::NONE) arms.push_back({ act, g, afterMs });
+    armG[act] = g;
+    armAfter[act] = afterMs;
+  }
+  void stepDone(const RecipeStepReport& r) override { reports.push_back(r); }
+
+  bool anyOn() const { for (bool b : on) if (b) return true; return false; }
+  bool anyArmed() const { for (RecipeGuard g : armG) if (g != RecipeGuard::NONE) return true; return false; }
+  int  armCount(uint8_t act, RecipeGuard g, uint32_t afterMs) const {
+    int n = 0;
+    for (const Arm& a : arms) n += (a.act == act && a.g == g && a.afterMs == afterMs);
+    return n;
+  }
+  // Primer encendido de act a partir del evento i
+  int firstOn(uint8_t act, size_t from = 0) const {
+    for (size_t i = from; i < events.size(); ++i) if (events[i].act == act && events[i].on) return (int)i;
+    return -1;
+  }
+
+private:
+  uint32_t hookT0_[RH_COUNT] = { 0, 0, 0 };
+};
+
+static RecipeStep mk(RecipeOp op, uint8_t act, RecipeGuard g, RecipeParam tmo, uint16_t tmoDs,
+                     RecipeParam dur, uint16_t durDs, uint8_t flags = 0) {
+  RecipeStep s;
+  s.op = op; s.act = act; s.guard = g; s.flags = flags;
+  s.tmo = tmo; s.dur = dur; s.tmoDs = tmoDs; s.durDs = durDs;
+  return s;
+}
+
+static Recipe make(std::initializer_list<RecipeStep> steps, uint16_t pauseMs = 0) {
+  Recipe r;
+  memset(&r, 0, sizeof(r));
+  for (const RecipeStep& s : steps) r.steps[r.count++] = s;
+  r.pauseMs = pauseMs;
+  return r;
+}
+
+// Avanza de a tickMs hasta que el motor termine (o maxMs)
+static RecipeRunState runTo(RecipeEngine& e, ScriptIO& io, uint32_t maxMs, uint32_t tickMs = 100) {
+  const uint32_t end = io.t + maxMs;
+  RecipeRunState st = e.tick();
+  while (st == RecipeRunState::RUNNING && io.t < end) { io.t += tickMs; st = e.tick(); }
+  return st;
+}
+
+static void formatCase() {
+  CHECK(sizeof(RecipeStep) == 10, "RecipeStep ocupa %zu bytes", sizeof(RecipeStep));
+  CHECK(sizeof(Recipe) == 3 + 10 * Recipe::MAX_STEPS, "Recipe ocupa %zu bytes", sizeof(Recipe));
+
+  Recipe r;
+  recipeDefault(r);
+  uint8_t bad = 0xEE;
+  CHECK(recipeValid(r, bad), "receta de fábrica inválida en el paso %u", bad);
+
+  typedef RecipeOp O; typedef RecipeGuard G; typedef RecipeParam P;
+  Recipe x = make({ mk(O::WAIT, 0, G::DRAINED, P::NONE, 0, P::NONE, 0) });
+  CHECK(!recipeValid(x, bad) && bad == 0, "guarda sin tope aceptada");
+  x = make({ mk(O::ON, RA_H2O, G::NONE, P::NONE, 0, P::NONE, 0),
+             mk(O::HOOK, RH_READ, G::NONE, P::NONE, 0, P::NONE, 0, RS_ASYNC) });
+  CHECK(!recipeValid(x, bad) && bad == 1, "hook en paralelo aceptado (bad %u)", bad);
+  x = make({ mk(O::CHECK, 0, G::NONE, P::NONE, 0, P::NONE, 0) });
+  CHECK(!recipeValid(x, bad), "CHECK sin guarda aceptado");
+  x = make({ mk(O::PUMP, RA_COUNT, G::NONE, P::NONE, 0, P::CONST, 10) });
+  CHECK(!recipeValid(x, bad), "actuador fuera de rango aceptado");
+  x = make({ mk(O::PUMP, RA_H2O, G::NONE, P::NONE, 0, P::CONST, 10, 0x80) });
+  CHECK(!recipeValid(x, bad), "bandera desconocida aceptada");
+  x = make({ mk((RecipeOp)9, 0, G::NONE, P::NONE, 0, P::NONE, 0) });
+  CHECK(!recipeValid(x, bad), "op desconocido aceptado");
+  memset(&x, 0, sizeof(x));
+  CHECK(!recipeValid(x, bad) && bad == 0, "receta vacía aceptada");
+  x.count = Recipe::MAX_STEPS + 1;
+  CHECK(!recipeValid(x, bad), "receta de 17 pasos aceptada");
+
+  // Nombres ida y vuelta (los usa set_recipe)
+  RecipeParam p;
+  CHECK(recipeParseParam(recipeParamName(RecipeParam::DRAIN_TIMEOUT), p) && p == RecipeParam::DRAIN_TIMEOUT,
+        "nombre de parámetro");
+  uint8_t a;
+  CHECK(recipeParseAct("sample", a) && a == RA_SAMPLE && !recipeParseAct("bomba", a), "nombre de actuador");
+}
+
+static void factoryCase(uint16_t pauseMs) {
+  ScriptIO io;
+  // Celda: se vacía a los 4 s de drenar, los sensores se mojan a los 2 s de
+  // bombear muestra
+  io.guardAt[(uint8_t)RecipeGuard::DRAINED] = NEVER;
+  io.guardAt[(uint8_t)RecipeGuard::SAMPLE_IN] = NEVER;
+  io.hookMs[RH_STABLE] = 12000;
+  io.hookMs[RH_READ] = 1000;
+
+  Recipe r;
+  recipeDefault(r);
+  r.pauseMs = pauseMs;
+  RecipeEngine e(io);
+  CHECK(e.start(r), "start de fábrica");
+
+  // Guion de la planta según lo que enciende la receta
+  RecipeRunState st = e.tick();
+  uint32_t drainOn = NEVER, sampleOn = NEVER;
+  while (st == RecipeRunState::RUNNING && io.t < 200000) {
+    if (io.on[RA_DRAIN] && drainOn == NEVER) drainOn = io.t;
+    if (!io.on[RA_DRAIN]) drainOn = NEVER;
+    if (io.on[RA_SAMPLE] && sampleOn == NEVER) sampleOn = io.t;
+    io.guardAt[(uint8_t)RecipeGuard::DRAINED]   = (drainOn != NEVER) ? drainOn + 4000 : NEVER;
+    io.guardAt[(uint8_t)RecipeGuard::SAMPLE_IN] = (sampleOn != NEVER) ? sampleOn + 2000 : NEVER;
+    io.t += 100;
+    st = e.tick();
+  }
+
+  CHECK(st == RecipeRunState::DONE, "fábrica terminó en %d (paso %d)", (int)st, e.abortStep());
+  CHECK(!io.anyOn(), "quedó algo encendido");
+
+  // Orden: drenaje, muestra, mixer (tras mojar sensores), estabilidad,
+  // lectura, drenaje, H2O y KCL a la vez
+  const int d1 = io.firstOn(RA_DRAIN), s1 = io.firstOn(RA_SAMPLE), m1 = io.firstOn(RA_MIXER);
+  const int d2 = io.firstOn(RA_DRAIN, (size_t)m1), h = io.firstOn(RA_H2O), k = io.firstOn(RA_KCL);
+  CHECK(d1 >= 0 && d1 < s1 && s1 < m1 && m1 < d2 && d2 < h && h < k, "orden de actuadores %d %d %d %d %d %d",
+        d1, s1, m1, d2, h, k);
+  CHECK(m1 >= 0 && io.events[m1].t - io.events[s1].t == 2000, "mixer a %u ms de la muestra (esperado 2000)",
+        m1 >= 0 ? io.events[m1].t - io.events[s1].t : 0);
+  CHECK(h >= 0 && k >= 0 && io.events[h].t == io.events[k].t, "H2O y KCL no arrancan juntos");
+  CHECK(io.maxOn <= 2, "más de dos actuadores a la vez (%d)", io.maxOn);
+
+  // Cortes en el flanco: drenajes tras su HOLD, muestra tras SAMPLE_FILL
+  CHECK(io.armCount(RA_DRAIN, RecipeGuard::DRAINED, 15000) == 2 &&
+        io.armCount(RA_SAMPLE, RecipeGuard::SAMPLE_IN, 3000) == 1 && io.arms.size() == 3,
+        "cortes armados: %zu", io.arms.size());
+  CHECK(!io.anyArmed(), "quedó un corte armado");
+
+  // Tiempo: nivel + 2×(4 s + 15 s de drenaje) + 2 s + 3 s de muestra +
+  // 12 s de estabilidad + 1 s de lectura + 3 s de H2O/KCL + 2 pausas
+  const uint32_t expect = 2 * (4000 + 15000) + 2000 + 3000 + 12000 + 1000 + 3000 + 2 * pauseMs;
+  printf("receta de fábrica, pauseMs %u: %.1f s (esperado %.1f s), %zu reportes\n",
+         pauseMs, e.elapsedMs() / 1000.0, expect / 1000.0, io.reports.size());
+  CHECK(e.elapsedMs() >= expect && e.elapsedMs() <= expect + 100, "duración %u ms", e.elapsedMs());
+  CHECK(io.reports.size() == r.count, "%zu reportes de %u pasos", io.reports.size(), r.count);
+  CHECK(e.report(1).sensorMs == 4000 && e.report(3).sensorMs == 2000, "espera de sensor %u / %u",
+        e.report(1).sensorMs, e.report(3).sensorMs);
+}
+
+static void timeoutCase() {
+  typedef RecipeOp O; typedef RecipeGuard G; typedef RecipeParam P;
+  ScriptIO io;
+  io.guardAt[(uint8_t)G::DRAINED] = NEVER;
+  Recipe r;
+  recipeDefault(r);
+  RecipeEngine e(io);
+  e.start(r);
+  const RecipeRunState st = runTo(e, io, 60000);
+  CHECK(st == RecipeRunState::ABORTED && e.abortStep() == 1 && e.abortOutcome() == RecipeOutcome::TIMEOUT,
+        "drenaje trabado: estado %d paso %d", (int)st, e.abortStep());
+  CHECK(e.elapsedMs() >= 15000 + 1500 && e.elapsedMs() <= 15000 + 1500 + 100, "abortó a %u ms", e.elapsedMs());
+  CHECK(!io.anyOn(), "abortó con algo encendido");
+  CHECK(!io.anyArmed(), "corte por guarda quedó armado");
+
+  // RS_SOFT: se registra y sigue
+  ScriptIO io2;
+  io2.guardAt[(uint8_t)G::SAMPLE_IN] = NEVER;
+  Recipe s = make({
+    mk(O::WAIT, 0, G::SAMPLE_IN, P::CONST, 20, P::NONE, 0, RS_SOFT),
+    mk(O::PUMP, RA_H2O, G::NONE, P::NONE, 0, P::CONST, 10),
+  });
+  RecipeEngine e2(io2);
+  e2.start(s);
+  CHECK(runTo(e2, io2, 10000) == RecipeRunState::DONE, "RS_SOFT abortó");
+  CHECK(e2.report(0).outcome == RecipeOutcome::TIMEOUT && e2.report(1).outcome == RecipeOutcome::OK,
+        "reportes RS_SOFT");
+  CHECK(e2.elapsedMs() == 3000, "RS_SOFT tardó %u ms", e2.elapsedMs());
+}
+
+static void instantAndHookCase() {
+  typedef RecipeOp O; typedef RecipeGuard G; typedef RecipeParam P;
+  ScriptIO io;
+  Recipe r = make({
+    mk(O::ON,    RA_MIXER, G::NONE, P::NONE, 0, P::NONE, 0),
+    mk(O::ON,    RA_H2O,   G::NONE, P::NONE, 0, P::NONE, 0),
+    mk(O::CHECK, 0,        G::H2O_OK, P::NONE, 0, P::NONE, 0),
+    mk(O::OFF,   RA_H2O,   G::NONE, P::NONE, 0, P::NONE, 0),
+    mk(O::OFF,   RA_MIXER, G::NONE, P::NONE, 0, P::NONE, 0),
+  });
+  RecipeEngine e(io);
+  e.start(r);
+  CHECK(e.tick() == RecipeRunState::DONE && io.events.size() == 4 && io.t == 0,
+        "pasos instantáneos no se encadenaron en un tick (%zu eventos)", io.events.size());
+
+  // CHECK que falla aborta y apaga el mixer
+  io.guardAt[(uint8_t)G::H2O_OK] = NEVER;
+  io.events.clear();
+  e.start(r);
+  CHECK(e.tick() == RecipeRunState::ABORTED && e.abortStep() == 2 && !io.anyOn(), "CHECK fallido");
+
+  // Hook en FAIL aborta; hook lento vence su tope
+  ScriptIO io2;
+  io2.hookMs[RH_READ] = 500;
+  io2.hookEnd[RH_READ] = RecipeHookStatus::FAIL;
+  Recipe h = make({ mk(O::HOOK, RH_READ, G::NONE, P::NONE, 0, P::NONE, 0) });
+  RecipeEngine e2(io2);
+  e2.start(h);
+  CHECK(runTo(e2, io2, 5000) == RecipeRunState::ABORTED && e2.abortOutcome() == RecipeOutcome::FAIL, "hook FAIL");
+  io2.hookMs[RH_READ] = 60000;
+  h.steps[0].tmo = P::CONST;
+  h.steps[0].tmoDs = 20;
+  e2.start(h);
+  CHECK(runTo(e2, io2, 5000) == RecipeRunState::ABORTED && e2.abortOutcome() == RecipeOutcome::TIMEOUT &&
+        e2.elapsedMs() == 2000, "tope del hook: %u ms", e2.elapsedMs());
+}
+
+static void asyncCase() {
+  typedef RecipeOp O; typedef RecipeGuard G; typedef RecipeParam P;
+  ScriptIO io;
+  // Cinco bombas en paralelo de 1..5 s: la quinta espera a que termine la primera
+  Recipe r = make({
+    mk(O::PUMP, RA_SAMPLE1, G::NONE, P::NONE, 0, P::CONST, 10, RS_ASYNC),
+    mk(O::PUMP, RA_SAMPLE2, G::NONE, P::NONE, 0, P::CONST, 20, RS_ASYNC),
+    mk(O::PUMP, RA_SAMPLE3, G::NONE, P::NONE, 0, P::CONST, 30, RS_ASYNC),
+    mk(O::PUMP, RA_SAMPLE4, G::NONE, P::NONE, 0, P::CONST, 40, RS_ASYNC),
+    mk(O::PUMP, RA_H2O,     G::NONE, P::NONE, 0, P::CONST, 50, RS_ASYNC),
+    mk(O::JOIN, 0,          G::NONE, P::NONE, 0, P::NONE, 0),
+    mk(O::ON,   RA_MIXER,   G::NONE, P::NONE, 0, P::NONE, 0),
+  });
+  RecipeEngine e(io);
+  e.start(r);
+  CHECK(runTo(e, io, 20000) == RecipeRunState::DONE, "paralelo no terminó");
+  CHECK(io.maxOn == 4, "%d a la vez (máximo %u)", io.maxOn, RecipeEngine::MAX_PARALLEL);
+  const int h = io.firstOn(RA_H2O), m = io.firstOn(RA_MIXER);
+  CHECK(h >= 0 && io.events[h].t == 1000, "la quinta arrancó a %u ms", h >= 0 ? io.events[h].t : 0);
+  CHECK(m >= 0 && io.events[m].t == 6000, "JOIN liberó a %u ms (esperado 6000)", m >= 0 ? io.events[m].t : 0);
+  CHECK(!io.anyOn(), "el fin de la receta no apagó el mixer");
+
+  // abort() con bombas de fondo corriendo
+  e.start(r);
+  io.t += 100;
+  e.tick();
+  io.t += 100;
+  e.tick();
+  CHECK(io.anyOn(), "nada corriendo antes de abort()");
+  e.abort();
+  CHECK(e.state() == RecipeRunState::ABORTED && e.abortStep() == -1 && !io.anyOn(), "abort() dejó bombas encendidas");
+}
+
+static void guardTimingCase() {
+  typedef RecipeOp O; typedef RecipeGuard G; typedef RecipeParam P;
+  ScriptIO io;
+  // Flanco a los 1234 ms, ticks de 500 ms: el HOLD de 1 s termina a 2234
+  io.guardAt[(uint8_t)G::DRAINED] = 1234;
+  io.edgeAt[(uint8_t)G::DRAINED] = 1234;
+  Recipe r = make({ mk(O::PUMP, RA_DRAIN, G::DRAINED, P::CONST, 50, P::CONST, 10) });
+  RecipeEngine e(io);
+  e.start(r);
+  runTo(e, io, 10000, 500);
+  CHECK(e.report(0).sensorMs == 1234, "sensorMs %u (esperado 1234)", e.report(0).sensorMs);
+  CHECK(io.arms.size() == 1 && io.armCount(RA_DRAIN, G::DRAINED, 1000) == 1, "PUMP con HOLD: %zu armados",
+        io.arms.size());
+  CHECK(!io.anyArmed(), "PUMP con HOLD quedó armado");
+
+  // Hasta la guarda sin HOLD: se arma el corte y se desarma al cumplirse
+  ScriptIO io2;
+  io2.guardAt[(uint8_t)G::SAMPLE_IN] = 1500;
+  Recipe s = make({ mk(O::PUMP, RA_SAMPLE, G::SAMPLE_IN, P::CONST, 50, P::NONE, 0) });
+  RecipeEngine e2(io2);
+  e2.start(s);
+  e2.tick();
+  CHECK(io2.armG[RA_SAMPLE] == G::SAMPLE_IN && io2.armAfter[RA_SAMPLE] == 0, "cutOnGuard no se armó");
+  runTo(e2, io2, 10000);
+  CHECK(!io2.anyArmed() && !io2.anyOn() && e2.state() == RecipeRunState::DONE, "cutOnGuard no se desarmó");
+
+  // WAIT con guarda: la muestra se apaga 0.5 s de HOLD + 2 s fijos después
+  // del flanco; el mixer no (lo apaga la receta después de un hook)
+  ScriptIO io3;
+  io3.guardAt[(uint8_t)G::SAMPLE_IN] = 1500;
+  Recipe w = make({
+    mk(O::ON,   RA_SAMPLE, G::NONE,      P::NONE,  0,  P::NONE,  0),
+    mk(O::ON,   RA_MIXER,  G::NONE,      P::NONE,  0,  P::NONE,  0),
+    mk(O::WAIT, 0,         G::SAMPLE_IN, P::CONST, 50, P::CONST, 5),
+    mk(O::ON,   RA_H2O,    G::NONE,      P::NONE,  0,  P::NONE,  0),
+    mk(O::WAIT, 0,         G::NONE,      P::NONE,  0,  P::CONST, 20),
+    mk(O::OFF,  RA_SAMPLE, G::NONE,      P::NONE,  0,  P::NONE,  0),
+    mk(O::OFF,  RA_H2O,    G::NONE,      P::NONE,  0,  P::NONE,  0),
+    mk(O::HOOK, RH_READ,   G::NONE,      P::NONE,  0,  P::NONE,  0),
+    mk(O::OFF,  RA_MIXER,  G::NONE,      P::NONE,  0,  P::NONE,  0),
+  });
+  RecipeEngine e3(io3);
+  e3.start(w);
+  e3.tick();
+  CHECK(io3.arms.size() == 1 && io3.armCount(RA_SAMPLE, G::SAMPLE_IN, 2500) == 1,
+        "WAIT: %zu armados (muestra tras %u ms)", io3.arms.size(), io3.armAfter[RA_SAMPLE]);
+  CHECK(runTo(e3, io3, 10000) == RecipeRunState::DONE && !io3.anyArmed(), "WAIT: no se desarmó");
+
+  // Guarda vencida con RS_SOFT: se desarma aunque la receta siga
+  ScriptIO io4;
+  io4.guardAt[(uint8_t)G::SAMPLE_IN] = NEVER;
+  w.steps[2].flags = RS_SOFT;
+  RecipeEngine e4(io4);
+  e4.start(w);
+  e4.tick();
+  CHECK(io4.armG[RA_SAMPLE] == G::SAMPLE_IN, "RS_SOFT: no se armó");
+  io4.t = 5000;
+  e4.tick();
+  CHECK(io4.armG[RA_SAMPLE] == G::NONE && io4.on[RA_SAMPLE], "RS_SOFT: armado tras vencer la guarda");
+}
+
+int main() {
+  formatCase();
+  factoryCase(1500);
+  factoryCase(0);
+  timeoutCase();
+  instantAndHookCase();
+  asyncCase();
+  guardTimingCase();
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
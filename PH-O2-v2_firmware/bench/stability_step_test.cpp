@@ -0,0 +1,169 @@
+// =====================================================
+// Simulación en host de StabilityDetector con respuestas al escalón del
+// electrodo (lib/ph_manager/stability_detector.h)
+//  - Escalón de 30 mV: V(t) = Vf - A·(w·e^(-t/τ1) + (1-w)·e^(-t/τ2)) + ruido
+//    gaussiano; primer orden con w = 1
+//  - Mezcla AUTO (stabilityMixConfig): un snapshot cada 500 ms, ruido
+//    0.1 mV (promedio de la adquisición), tope 90 s
+//  - Wizard de calibración (calStabilityConfig en src/main.cpp): bloque
+//    corto cada 300 ms, ruido 0.3 mV, tope 180 s
+//  - 200 corridas por caso. Toda declaración STABLE tiene que llegar con la
+//    deriva real por debajo de 2× el límite (nunca en plena subida); los
+//    casos rápidos estabilizan siempre y el lento termina por tope
+//  - El residuo (Vf - V) al terminar se compara con la espera fija de 30 s
+//  Resultado (mezcla): ya estable 10.7 s, τ 3 s 26.3 s, τ 4/20 s 61.1 s
+//  con 0.43 mV de residuo (2.02 mV con 30 s fijos), τ 6/60 s siempre al
+//  tope. Frente a la espera fija de 30 s solo es más corto si la muestra
+//  ya llega estable; con τ 3 s ahorra ~4 s y con τ 4/20 s espera el doble
+//  para leer 5 veces más cerca del valor final
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ilib/ph_manager bench/stability_step_test.cpp lib/ph_manager/stability_detector.cpp -o /tmp/stability_step_test
+//   /tmp/stability_step_test
+// =====================================================
+
+#include <math.h>
+#include <stdio.h>
+#include "stability_detector.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+static const double STEP_V = 0.030;
+static const double MV_PER_PH = 59.16;
+
+static uint32_t rng = 0x9E3779B9;
+static double gauss() {
+  rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+  const double u1 = (rng + 1.0) / 4294967297.0;
+  rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+  const double u2 = (rng + 1.0) / 4294967297.0;
+  return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+struct Electrode {
+  const char* name;
+  double tau1, tau2;   // s (tau1 = 0: ya estable)
+  double w;            // peso de tau1
+};
+
+// Distancia al valor final (V) y deriva real (V/min) a t segundos del escalón
+static double remaining(const Electrode& e, double t) {
+  if (e.tau1 <= 0) return 0;
+  double r = e.w * exp(-t / e.tau1);
+  if (e.w < 1) r += (1 - e.w) * exp(-t / e.tau2);
+  return STEP_V * r;
+}
+static double trueDrift(const Electrode& e, double t) {
+  if (e.tau1 <= 0) return 0;
+  double d = e.w * exp(-t / e.tau1) / e.tau1;
+  if (e.w < 1) d += (1 - e.w) * exp(-t / e.tau2) / e.tau2;
+  return STEP_V * d * 60.0;
+}
+
+struct Outcome {
+  unsigned stable, timeout, early;
+  double   meanS, maxS;
+  double   meanResidMv, maxResidMv;
+};
+
+static Outcome simulate(const Electrode& e, const StabilityConfig& cfg, uint32_t periodMs, double sigma) {
+  Outcome o = { 0, 0, 0, 0, 0, 0, 0 };
+  const int RUNS = 200;
+  const uint32_t t0 = 100000;   // millis() arbitrario
+  for (int r = 0; r < RUNS; ++r) {
+    StabilityDetector det;
+    det.begin(cfg, t0);
+    // Primer dato un poco después de entrar al paso (fase aleatoria)
+    uint32_t t = t0 + 1 + (rng % periodMs);
+    while (!det.done()) {
+      const double s = (t - t0) / 1000.0;
+      det.push(t, (float)(0.120 - remaining(e, s) + sigma * gauss()));
+      t += periodMs;
+    }
+    const double s = det.timeToStableMs() / 1000.0;
+    const double resid = remaining(e, s) * 1000.0;
+    if (det.state() == StabilityState::STABLE) {
+      o.stable++;
+      if (trueDrift(e, s) > 2.0 * cfg.driftLimit) o.early++;
+    } else {
+      o.timeout++;
+    }
+    o.meanS += s;
+    if (s > o.maxS) o.maxS = s;
+    o.meanResidMv += resid;
+    if (resid > o.maxResidMv) o.maxResidMv = resid;
+  }
+  o.meanS /= RUNS;
+  o.meanResidMv /= RUNS;
+  return o;
+}
+
+static void print(const char* what, const Electrode& e, const Outcome& o) {
+  printf("  %-6s %-12s estable %3u tope %3u | t medio %5.1f s máx %5.1f s | residuo %5.2f mV (%4.1f mpH) máx %5.2f mV | 30 s fijos: %5.2f mV\n",
+         what, e.name, o.stable, o.timeout, o.meanS, o.maxS, o.meanResidMv,
+         o.meanResidMv / MV_PER_PH * 1000.0, o.maxResidMv, remaining(e, 30.0) * 1000.0);
+}
+
+int main() {
+  const Electrode already = { "ya estable", 0, 0, 1 };
+  const Electrode fast    = { "τ 3 s",      3, 0, 1 };
+  const Electrode twoTau  = { "τ 4 s/20 s", 4, 20, 0.7 };
+  const Electrode slow    = { "τ 6 s/60 s", 6, 60, 0.6 };
+
+  printf("escalón de %.0f mV, 200 corridas por caso\n", STEP_V * 1000);
+
+  // ---- Mezcla AUTO ----
+  const StabilityConfig mix = stabilityMixConfig(90000);
+  Outcome o = simulate(already, mix, 500, 0.1e-3);
+  print("mezcla", already, o);
+  CHECK(o.stable == 200, "mezcla ya estable: %u por tope", o.timeout);
+  CHECK(o.maxS >= mix.minMs / 1000.0 && o.maxS < 13.0, "mezcla ya estable tarda %.1f s", o.maxS);
+
+  o = simulate(fast, mix, 500, 0.1e-3);
+  print("mezcla", fast, o);
+  CHECK(o.stable == 200 && o.early == 0, "mezcla τ 3 s: %u estables, %u antes de tiempo", o.stable, o.early);
+  CHECK(o.maxS < 35.0, "mezcla τ 3 s tarda %.1f s", o.maxS);
+
+  o = simulate(twoTau, mix, 500, 0.1e-3);
+  print("mezcla", twoTau, o);
+  CHECK(o.stable == 200 && o.early == 0, "mezcla τ 4/20 s: %u estables, %u antes de tiempo", o.stable, o.early);
+  CHECK(o.meanResidMv < remaining(twoTau, 30.0) * 1000.0,
+        "mezcla τ 4/20 s: residuo %.2f mV no mejora la espera fija", o.meanResidMv);
+
+  o = simulate(slow, mix, 500, 0.1e-3);
+  print("mezcla", slow, o);
+  CHECK(o.early == 0, "mezcla lenta: %u estables en plena deriva", o.early);
+  CHECK(o.timeout >= 190, "mezcla lenta: solo %u por tope", o.timeout);
+
+  // Sin snapshots nuevos: tick() vence el tope igual
+  StabilityDetector det;
+  det.begin(stabilityMixConfig(30000), 0);
+  det.push(500, 0.1f);
+  for (uint32_t t = 1000; t <= 31000 && !det.done(); t += 500) det.tick(t);
+  CHECK(det.state() == StabilityState::TIMEOUT && det.timeToStableMs() == 30000,
+        "tick sin muestras: estado %d en %u ms", (int)det.state(), det.timeToStableMs());
+
+  // ---- Wizard de calibración (config de src/main.cpp) ----
+  StabilityConfig cal;
+  cal.minMs = 5000;
+  cal.maxMs = 180000;
+  o = simulate(fast, cal, 300, 0.3e-3);
+  print("calib", fast, o);
+  CHECK(o.stable == 200 && o.early == 0, "calib τ 3 s: %u estables, %u antes de tiempo", o.stable, o.early);
+
+  o = simulate(twoTau, cal, 300, 0.3e-3);
+  print("calib", twoTau, o);
+  CHECK(o.stable == 200 && o.early == 0, "calib τ 4/20 s: %u estables, %u antes de tiempo", o.stable, o.early);
+  CHECK(o.maxResidMv < 0.6, "calib τ 4/20 s: residuo máx %.2f mV (> 0.01 pH)", o.maxResidMv);
+
+  o = simulate(slow, cal, 300, 0.3e-3);
+  print("calib", slow, o);
+  CHECK(o.early == 0, "calib lenta: %u estables en plena deriva", o.early);
+
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+// =====================================================
+// Benchmark en host de UARTManager (framing + parseo + respuesta)
+//  - Un Stream falso entrega N veces la misma línea y descarta la salida
+//  - Mide comandos/s y reservas de heap por comando (operator new contado
+//    durante la medición; las colas se crean antes)
+//  - Luego get_status/get_last en MessagePack (claves enteras,
+//    uart_msgpack): mismo camino, bytes frente a JSON, y la trama de
+//    get_last contra bytes de referencia (msgpack de Python, float32)
+//  - Shim de Arduino/FreeRTOS en bench/host; ArduinoJson 6 el de lib_deps
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   pio pkg install -e esp32doit-devkit-v1
+//   AJ=.pio/libdeps/esp32doit-devkit-v1/ArduinoJson/src
+//   g++ -std=c++11 -O2 -Ibench/host -Ilib/UART_manager -Ilib/recipe_engine -Ilib/log_manager -I$AJ -DARDUINOJSON_ENABLE_ARDUINO_STREAM=1 -DARDUINOJSON_ENABLE_ARDUINO_PRINT=1 -DARDUINOJSON_ENABLE_ARDUINO_STRING=0 -DARDUINOJSON_ENABLE_PROGMEM=0 bench/uart_bench.cpp lib/UART_manager/uart_manager.cpp lib/UART_manager/uart_msgpack.cpp lib/UART_manager/line_framer.cpp lib/UART_manager/event_ring.cpp lib/recipe_engine/recipe.cpp lib/log_manager/log_manager.cpp -o /tmp/uart_bench
+//   /tmp/uart_bench [iteraciones]
+// =====================================================
+
+#include <Arduino.h>
+#include <globals.h>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include "uart_manager.h"
+#include "log_manager.h"
+
+RemoteAccessManager remoteManager;
+static uint32_t logLines = 0;
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+// ---------- Conteo de reservas ----------
+static volatile bool     counting = false;
+static volatile uint64_t allocs = 0;
+
+void* operator new(size_t n) {
+  if (counting) allocs++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// ---------- Stream falso ----------
+class FakeStream : public Stream {
+public:
+  void feed(const char* line) { in_ = line; pos_ = 0; len_ = strlen(line); }
+
+  int available() override { return (int)(len_ - pos_); }
+  int read() override { return pos_ < len_ ? (uint8_t)in_[pos_++] : -1; }
+  int peek() override { return pos_ < len_ ? (uint8_t)in_[pos_] : -1; }
+
+  size_t write(uint8_t c) override {
+    if (outLen_ < sizeof(out_) - 1) out_[outLen_++] = (char)c;
+    bytesOut++;
+    return 1;
+  }
+  size_t write(const uint8_t* buf, size_t n) override {
+    for (size_t i = 0; i < n; ++i) write(buf[i]);
+    return n;
+  }
+
+  // Primera respuesta capturada (para verla en el reporte)
+  const char* firstOut() { out_[outLen_] = '\0'; return out_; }
+  const uint8_t* outBytes() const { return (const uint8_t*)out_; }
+  size_t outLen() const { return outLen_; }
+  void clearOut() { outLen_ = 0; }
+
+  uint64_t bytesOut = 0;
+
+private:
+  const char* in_ = "";
+  size_t      pos_ = 0, len_ = 0;
+  char        out_[600];
+  size_t      outLen_ = 0;
+};
+
+struct Case {
+  const char* name;
+  const char* line;
+};
+
+static const Case CASES[] = {
+  {"get_status",   "{\"op\":\"get_status\"}\n"},
+  {"get_last",     "{\"op\":\"get_last\"}\n"},
+  {"auto_measure", "{\"op\":\"auto_measure\"}\n"},
+  {"set_format",   "{\"op\":\"set_format\",\"data\":{\"fmt\":\"json\"}}\n"},
+  {"set_recipe",   "{\"op\":\"set_recipe\",\"data\":{\"pause\":500,\"steps\":["
+                   "[\"pump\",\"drain\",\"drained\",\"drain_t\",\"drain\"],"
+                   "[\"pump\",\"sample\",\"full\",\"sample_t\",\"sample_fill\"],"
+                   "[\"hook\",\"read\",null,null,null,\"p\"]]}}\n"},
+  {"bad_json",     "{\"op\":\"get_status\"\n"},
+};
+
+// get_last del estado de abajo: {0:true, 2:{12:7.01, 13:24.5, 3:{4:false, 5:false},
+// 8:[{9:1, 10:6.9, 11:nil}, {9:2, ...}, ...], 14:"CAL_PH_2PT_OK"}}
+static const uint8_t GOLDEN_GET_LAST[] = {
+  0x82, 0x00, 0xC3, 0x02, 0x85, 0x0C, 0xCA, 0x40, 0xE0, 0x51, 0xEC, 0x0D, 0xCA, 0x41, 0xC4, 0x00,
+  0x00, 0x03, 0x82, 0x04, 0xC2, 0x05, 0xC2, 0x08, 0x94, 0x83, 0x09, 0x01, 0x0A, 0xCA, 0x40, 0xDC,
+  0xCC, 0xCD, 0x0B, 0xC0, 0x83, 0x09, 0x02, 0x0A, 0xC0, 0x0B, 0xC0, 0x83, 0x09, 0x03, 0x0A, 0xC0,
+  0x0B, 0xC0, 0x83, 0x09, 0x04, 0x0A, 0xC0, 0x0B, 0xC0, 0x0E, 0xAD, 0x43, 0x41, 0x4C, 0x5F, 0x50,
+  0x48, 0x5F, 0x32, 0x50, 0x54, 0x5F, 0x4F, 0x4B
+};
+
+struct Result {
+  double cmdsPerS, allocsPerCmd, bytesPerCmd;
+};
+
+static Result run(UartProto::UARTManager& uart, FakeStream& io, const Case& c, long iters) {
+  // Calentamiento: primera respuesta y estado interno estable
+  io.clearOut();
+  for (int i = 0; i < 10; ++i) {
+    io.feed(c.line);
+    uart.loop();
+  }
+
+  const uint64_t bytes0 = io.bytesOut;
+  allocs = 0;
+  counting = true;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < iters; ++i) {
+    io.feed(c.line);
+    uart.loop();
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  counting = false;
+
+  // auto_measure deja el pedido en cola: se vacía fuera de la medición
+  UartProto::UartCommand cmd;
+  while (uart.nextCommand(cmd, 0)) {}
+  Recipe r;
+  uart.takeRecipe(r);
+
+  const double s = std::chrono::duration<double>(t1 - t0).count();
+  return {iters / s, (double)allocs / iters, (double)(io.bytesOut - bytes0) / iters};
+}
+
+int main(int argc, char** argv) {
+  const long iters = argc > 1 ? atol(argv[1]) : 100000;
+
+  logSetSink([](const char*) { logLines++; });
+
+  FakeStream io;
+  UartProto::UARTManager uart(io);
+  uart.begin();
+  uart.setLastPh(7.01f);
+  uart.setLastTempC(24.5f);
+  uart.setSamplePhValueById(1, 6.9f);
+  uart.setLastResult("CAL_PH_2PT_OK");
+
+  printf("%-13s %12s %12s %10s\n", "op", "cmds/s", "allocs/cmd", "bytes/cmd");
+  double jsonBytes[2] = {0, 0};
+  for (const Case& c : CASES) {
+    const Result r = run(uart, io, c, iters);
+    if (&c - CASES < 2) jsonBytes[&c - CASES] = r.bytesPerCmd;
+    printf("%-13s %12.0f %12.3f %10.1f\n", c.name, r.cmdsPerS, r.allocsPerCmd, r.bytesPerCmd);
+  }
+
+  io.clearOut();
+  io.feed(CASES[1].line);
+  uart.loop();
+  printf("\nget_last -> %s", io.firstOut());
+
+  // Mismas respuestas en MessagePack con claves enteras (la de set_format sale en JSON)
+  io.feed("{\"op\":\"set_format\",\"data\":{\"fmt\":\"msgpack\"}}\n");
+  uart.loop();
+  for (int i = 0; i < 2; ++i) {
+    const Result r = run(uart, io, CASES[i], iters);
+    char name[20];
+    snprintf(name, sizeof(name), "%s/mp", CASES[i].name);
+    printf("%-13s %12.0f %12.3f %10.1f  (JSON %.0f, -%.0f%%)\n", name, r.cmdsPerS, r.allocsPerCmd,
+           r.bytesPerCmd, jsonBytes[i], 100.0 * (1.0 - r.bytesPerCmd / jsonBytes[i]));
+  }
+
+  // Trama de get_last: A5, largo big-endian y el cuerpo de referencia
+  io.clearOut();
+  io.feed(CASES[1].line);
+  uart.loop();
+  const uint8_t* f = io.outBytes();
+  const size_t n = sizeof(GOLDEN_GET_LAST);
+  CHECK(io.outLen() == 3 + n && f[0] == UartProto::kFrameSync && f[1] == (n >> 8) && f[2] == (n & 0xFF),
+        "trama get_last: %zu bytes", io.outLen());
+  CHECK(io.outLen() == 3 + n && !memcmp(f + 3, GOLDEN_GET_LAST, n), "get_last en MessagePack difiere de la referencia");
+  printf("get_last/mp -> %zu bytes (trama %zu)\n", n, io.outLen());
+
+  printf("logs: %u  resultados perdidos: %u  comandos perdidos: %u\n",
+         (unsigned)logLines, (unsigned)uart.droppedResults(),
+         (unsigned)uart.droppedCommands());
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
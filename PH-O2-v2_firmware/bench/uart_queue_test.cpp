@@ -0,0 +1,164 @@
+// =====================================================
+// Prueba en host del camino por colas de UARTManager (comandos, resultados,
+// receta y bits de estado) con un Stream falso y las colas del shim
+//  - auto_measure queda en la cola de comandos al procesar la línea: la
+//    tarea de control lo toma con nextCommand() sin esperar a su sondeo,
+//    con las marcas rx <= encolado
+//  - Con AUTO corriendo responde BUSY y no encola; con la cola llena
+//    (4) cuenta droppedCommands() y el bit de pedido sigue puesto
+//  - Los setters de otras tareas solo encolan: el estado del puerto
+//    cambia recién cuando loop() vacía la cola, antes de responder;
+//    cola llena (16) => droppedResults()
+//  - set_recipe: la última receta gana y takeRecipe() la entrega una vez
+//  - Un solo hilo: valida el contrato de las colas, no la concurrencia
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Wall -Ibench/host -Ilib/UART_manager -Ilib/recipe_engine -Ilib/log_manager -I$AJ -DARDUINOJSON_ENABLE_ARDUINO_STREAM=1 -DARDUINOJSON_ENABLE_ARDUINO_PRINT=1 -DARDUINOJSON_ENABLE_ARDUINO_STRING=0 -DARDUINOJSON_ENABLE_PROGMEM=0 bench/uart_queue_test.cpp lib/UART_manager/uart_manager.cpp lib/UART_manager/uart_msgpack.cpp lib/UART_manager/line_framer.cpp lib/UART_manager/event_ring.cpp lib/recipe_engine/recipe.cpp lib/log_manager/log_manager.cpp -o /tmp/uart_queue_test
+//   /tmp/uart_queue_test
+// =====================================================
+
+#include <Arduino.h>
+#include <globals.h>
+#include <stdio.h>
+#include <string.h>
+#include "uart_manager.h"
+
+RemoteAccessManager remoteManager;
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+  if (!(cond)) { failures++; printf("FALLA %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } \
+} while (0)
+
+using namespace UartProto;
+
+// ---------- Stream falso ----------
+class FakeStream : public Stream {
+public:
+  void feed(const char* line) { in_ = line; pos_ = 0; len_ = strlen(line); }
+
+  int available() override { return (int)(len_ - pos_); }
+  int read() override { return pos_ < len_ ? (uint8_t)in_[pos_++] : -1; }
+  int peek() override { return pos_ < len_ ? (uint8_t)in_[pos_] : -1; }
+
+  size_t write(uint8_t c) override {
+    if (outLen_ < sizeof(out_) - 1) out_[outLen_++] = (char)c;
+    return 1;
+  }
+  size_t write(const uint8_t* buf, size_t n) override {
+    for (size_t i = 0; i < n; ++i) write(buf[i]);
+    return n;
+  }
+
+  // Respuestas acumuladas desde el último clearOut()
+  const char* out() { out_[outLen_] = '\0'; return out_; }
+  void clearOut() { outLen_ = 0; }
+
+private:
+  const char* in_ = "";
+  size_t      pos_ = 0, len_ = 0;
+  char        out_[2048];
+  size_t      outLen_ = 0;
+};
+
+static const char* AUTO_MEASURE = "{\"op\":\"auto_measure\"}\n";
+static const char* GET_LAST     = "{\"op\":\"get_last\"}\n";
+
+// Como la tarea del puerto: aviso de RX, línea y loop()
+static const char* request(UARTManager& uart, FakeStream& io, const char* line) {
+  io.clearOut();
+  io.feed(line);
+  uart.notifyRx();
+  uart.waitRx(0);
+  uart.loop();
+  return io.out();
+}
+
+static void commandCase() {
+  FakeStream io;
+  UARTManager uart(io);
+  uart.begin();
+
+  UartCommand c;
+  CHECK(!uart.nextCommand(c, 0), "cola de comandos no vacía al empezar");
+  const char* r = request(uart, io, AUTO_MEASURE);
+  CHECK(strstr(r, "true") != nullptr, "auto_measure: %s", r);
+  CHECK(uart.nextCommand(c, 0) && c.type == UartCmd::AUTO_MEASURE, "auto_measure no llegó a la cola");
+  CHECK(c.rxUs != 0 && (int32_t)(c.queuedUs - c.rxUs) >= 0, "marcas rx %u encolado %u", c.rxUs, c.queuedUs);
+  CHECK(uart.getAutoMeasureRequested(), "bit de pedido sin poner");
+  CHECK(!uart.nextCommand(c, 0), "auto_measure encolado dos veces");
+
+  // AUTO corriendo: BUSY y nada en la cola
+  uart.setAutoRunning(true);
+  r = request(uart, io, AUTO_MEASURE);
+  CHECK(strstr(r, "BUSY") != nullptr && !uart.nextCommand(c, 0), "auto_measure con AUTO corriendo: %s", r);
+  uart.setAutoRunning(false);
+  uart.setAutoMeasureRequested(false);
+  CHECK(!uart.getAutoRunning() && !uart.getAutoMeasureRequested(), "bits no se limpiaron");
+
+  // Cola de 4: el quinto se cuenta y queda el bit para el sondeo
+  for (int i = 0; i < 5; ++i) request(uart, io, AUTO_MEASURE);
+  int n = 0;
+  while (uart.nextCommand(c, 0)) n++;
+  CHECK(n == 4 && uart.droppedCommands() == 1 && uart.getAutoMeasureRequested(),
+        "cola llena: %d encolados, %u perdidos", n, uart.droppedCommands());
+  printf("comandos: 1 encolado por auto_measure, %u perdido con la cola llena\n", uart.droppedCommands());
+}
+
+static void resultCase() {
+  FakeStream io;
+  UARTManager uart(io);
+  uart.begin();
+
+  const char* r = request(uart, io, GET_LAST);
+  CHECK(strstr(r, "NO_DATA") != nullptr, "get_last sin datos: %s", r);
+
+  // Otra tarea publica: no toca el estado del puerto hasta loop()
+  uart.setLastPh(6.5f);
+  uart.setLastTempC(21.25f);
+  uart.setSamplePhValueById(2, 7.5f);
+  uart.setLastResult("CAL_PH_2PT_OK");
+  uart.setLevelH2O(true);
+  CHECK(uart.getLastPh() == 7.0f && !uart.getLastHasData(), "setter escribió sin pasar por la cola");
+  r = request(uart, io, GET_LAST);
+  CHECK(strstr(r, "6.5") && strstr(r, "21.25") && strstr(r, "7.5") && strstr(r, "CAL_PH_2PT_OK"),
+        "get_last no vio los resultados encolados: %s", r);
+  CHECK(uart.getLastPh() == 6.5f && uart.getLevelH2O() && uart.getSamplePhValueById(2) == 7.5f,
+        "estado del puerto tras loop()");
+
+  // Cola de 16: el 17.º se cuenta
+  for (int i = 0; i < 17; ++i) uart.setLastPh(5.0f + i * 0.125f);
+  CHECK(uart.droppedResults() == 1, "resultados perdidos %u (esperado 1)", uart.droppedResults());
+  uart.loop();
+  CHECK(uart.getLastPh() == 5.0f + 15 * 0.125f, "último aplicado %.3f", uart.getLastPh());
+}
+
+static void recipeCase() {
+  FakeStream io;
+  UARTManager uart(io);
+  uart.begin();
+
+  Recipe got;
+  CHECK(!uart.takeRecipe(got), "receta sin set_recipe");
+  request(uart, io, "{\"op\":\"set_recipe\",\"data\":{\"pause\":500,\"steps\":["
+                    "[\"pump\",\"drain\",\"drained\",\"drain_t\",\"drain\"]]}}\n");
+  const char* r = request(uart, io, "{\"op\":\"set_recipe\",\"data\":{\"pause\":700,\"steps\":["
+                                    "[\"pump\",\"drain\",\"drained\",\"drain_t\",\"drain\"],"
+                                    "[\"hook\",\"read\",null,null,null,\"p\"]]}}\n");
+  CHECK(strstr(r, "true") != nullptr, "set_recipe: %s", r);
+  CHECK(uart.takeRecipe(got) && got.pauseMs == 700 && got.count == 2, "no ganó la última receta (pausa %u, %u pasos)",
+        got.pauseMs, got.count);
+  CHECK(!uart.takeRecipe(got), "receta entregada dos veces");
+
+  uart.setAutoRunning(true);
+  r = request(uart, io, "{\"op\":\"set_recipe\",\"data\":{\"steps\":[]}}\n");
+  CHECK(strstr(r, "BUSY") != nullptr && !uart.takeRecipe(got), "set_recipe con AUTO corriendo: %s", r);
+}
+
+int main() {
+  commandCase();
+  resultCase();
+  recipeCase();
+  printf(failures ? "%d FALLAS\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
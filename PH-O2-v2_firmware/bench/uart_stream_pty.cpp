@@ -0,0 +1,317 @@
+// =====================================================
+// Prueba en host del modo streaming de UARTManager con un maestro por pty
+//  - El esclavo (UARTManager real + shim de bench/host) usa el lado
+//    maestro del pty; el "maestro" abre /dev/pts/N en crudo, como abriría
+//    el UART real, y lee líneas en un hilo aparte
+//  - Casos: subscribe, campos de cada evento, salto de seq recuperado con
+//    resend (línea descartada a propósito), cola de eventos llena (EV_LOST),
+//    unsubscribe, historial pisado (oldest > from) y argumentos inválidos
+//  - Sale con 1 si algún chequeo falla
+//
+// Compilar (desde PH-O2-v2_firmware):
+//   pio pkg install -e esp32doit-devkit-v1
+//   AJ=.pio/libdeps/esp32doit-devkit-v1/ArduinoJson/src
+//   g++ -std=c++11 -O1 -pthread -Ibench/host -Ilib/UART_manager -Ilib/recipe_engine -Ilib/log_manager -I$AJ -DARDUINOJSON_ENABLE_ARDUINO_STREAM=1 -DARDUINOJSON_ENABLE_ARDUINO_PRINT=1 -DARDUINOJSON_ENABLE_ARDUINO_STRING=0 -DARDUINOJSON_ENABLE_PROGMEM=0 bench/uart_stream_pty.cpp lib/UART_manager/uart_manager.cpp lib/UART_manager/uart_msgpack.cpp lib/UART_manager/line_framer.cpp lib/UART_manager/event_ring.cpp lib/recipe_engine/recipe.cpp lib/log_manager/log_manager.cpp -o /tmp/uart_stream_pty
+//   /tmp/uart_stream_pty
+// =====================================================
+
+#include <Arduino.h>
+#include <globals.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "uart_manager.h"
+#include "log_manager.h"
+
+RemoteAccessManager remoteManager;
+
+static int fails = 0;
+static void check(bool ok, const char* what) {
+  printf("%s  %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok) fails++;
+}
+
+// ---------- Lado esclavo: Stream sobre el fd maestro del pty ----------
+class PtyStream : public Stream {
+public:
+  explicit PtyStream(int fd) : fd_(fd) {}
+
+  int available() override {
+    int n = 0;
+    return ioctl(fd_, FIONREAD, &n) == 0 ? n : 0;
+  }
+  int read() override {
+    uint8_t c;
+    return ::read(fd_, &c, 1) == 1 ? c : -1;
+  }
+  int peek() override { return -1; }   // UARTManager no lo usa
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t n) override {
+    size_t k = 0;
+    while (k < n) {
+      const ssize_t w = ::write(fd_, buf + k, n - k);
+      if (w <= 0) break;
+      k += (size_t)w;
+    }
+    return k;
+  }
+
+private:
+  int fd_;
+};
+
+// ---------- Lado maestro: /dev/pts/N en crudo, lector en otro hilo ----------
+class PtyMaster {
+public:
+  bool open(const char* path) {
+    fd_ = ::open(path, O_RDWR | O_NOCTTY);
+    if (fd_ < 0) return false;
+    termios t;
+    tcgetattr(fd_, &t);
+    cfmakeraw(&t);
+    tcsetattr(fd_, TCSANOW, &t);
+    reader_ = std::thread([this] { readLoop_(); });
+    return true;
+  }
+
+  void close() {
+    stop_ = true;
+    reader_.join();
+    ::close(fd_);
+  }
+
+  void send(const char* line) {
+    std::string s = std::string(line) + "\n";
+    (void)!::write(fd_, s.data(), s.size());
+  }
+
+  // false si no llegó nada en timeoutMs
+  bool next(std::string& out, int timeoutMs = 500) {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (!cv_.wait_for(lk, std::chrono::milliseconds(timeoutMs), [this] { return !lines_.empty(); }))
+      return false;
+    out = lines_.front();
+    lines_.pop_front();
+    return true;
+  }
+
+private:
+  int fd_ = -1;
+  volatile bool stop_ = false;
+  std::thread reader_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<std::string> lines_;
+  LineFramer framer_;
+
+  void readLoop_() {
+    while (!stop_) {
+      pollfd p = {fd_, POLLIN, 0};
+      if (poll(&p, 1, 20) <= 0) continue;
+      char buf[256];
+      const ssize_t n = ::read(fd_, buf, sizeof(buf));
+      for (ssize_t i = 0; i < n; ++i) {
+        if (framer_.push(buf[i]) != LineFramer::Status::LINE) continue;
+        std::lock_guard<std::mutex> lk(mu_);
+        lines_.push_back(framer_.line());
+        cv_.notify_one();
+      }
+    }
+  }
+};
+
+// ---------- Arnés ----------
+static int          devFd = -1;
+static PtyMaster    master;
+static PtyStream*   io = nullptr;
+static UartProto::UARTManager* uart = nullptr;
+
+// Una vuelta de la tarea del puerto: espera RX o un aviso de emit*
+static void service(int ms = 50) {
+  pollfd p = {devFd, POLLIN, 0};
+  if (!uart->waitRx(0)) poll(&p, 1, ms);
+  uart->loop();
+}
+
+// Comando y respuesta (ok:true|false)
+static bool command(const char* line, StaticJsonDocument<512>& reply) {
+  master.send(line);
+  std::string s;
+  for (int i = 0; i < 20; ++i) {
+    service();
+    if (master.next(s, 20)) break;
+  }
+  if (s.empty()) return false;
+  static char buf[1024];
+  strlcpy(buf, s.c_str(), sizeof(buf));
+  return !deserializeJson(reply, buf) && !reply["ok"].isNull();
+}
+
+// Estado del maestro: próximo seq esperado y saltos detectados
+struct Tracker {
+  uint32_t expect = 0;
+  uint32_t gaps = 0;
+  uint32_t dups = 0;
+  uint32_t got = 0;
+  char     lastEv[16] = "";
+};
+
+// Lee eventos hasta que no llegue nada en timeoutMs. drop = seq a descartar
+// (simula una línea corrompida en el cable)
+static uint32_t drainEvents(Tracker& t, uint32_t drop = 0, int timeoutMs = 100,
+                            StaticJsonDocument<512>* last = nullptr) {
+  uint32_t n = 0;
+  std::string s;
+  static StaticJsonDocument<512> doc;
+  static char buf[1024];
+  service(0);
+  while (master.next(s, timeoutMs)) {
+    strlcpy(buf, s.c_str(), sizeof(buf));
+    if (deserializeJson(doc, buf) || doc["ev"].isNull()) continue;
+    const uint32_t seq = doc["seq"].as<uint32_t>();
+    if (seq == drop) { drop = 0; continue; }
+    n++;
+    if (seq < t.expect) { t.dups++; continue; }
+    if (seq > t.expect) t.gaps++;
+    t.expect = seq + 1;
+    t.got++;
+    strlcpy(t.lastEv, doc["ev"] | "", sizeof(t.lastEv));
+    if (last) *last = doc;
+    service(0);
+  }
+  return n;
+}
+
+int main() {
+  logSetAll(LOG_LVL_WARN);
+  logSetSink([](const char* l) { printf("  [log] %s\n", l); });
+
+  // pty: el esclavo usa el lado maestro, el "maestro" abre /dev/pts/N
+  devFd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (devFd < 0 || grantpt(devFd) || unlockpt(devFd)) { perror("pty"); return 1; }
+  const char* pts = ptsname(devFd);
+  if (!master.open(pts)) { perror(pts); return 1; }
+  printf("pty: %s\n", pts);
+
+  io = new PtyStream(devFd);
+  uart = new UartProto::UARTManager(*io);
+  uart->begin();
+
+  StaticJsonDocument<512> r;
+  Tracker t;
+
+  // 1) subscribe: ventana vacía
+  check(command("{\"op\":\"subscribe\"}", r) && r["ok"] == true, "subscribe ok");
+  t.expect = r["data"]["next"] | 0u;
+  check(t.expect == 1 && (r["data"]["oldest"] | 0u) == 1, "subscribe next=1 oldest=1");
+
+  // 2) Un ciclo corto: cada tipo de evento
+  RecipeStepReport rep;
+  rep.index = 2; rep.op = RecipeOp::PUMP; rep.act = RA_DRAIN;
+  rep.outcome = RecipeOutcome::TIMEOUT; rep.totalMs = 1234;
+  uart->emitAuto("start", 1, 2);
+  uart->emitStep(1, rep);
+  uart->emitLevel("o2", true, 5000);
+  uart->emitSample(1, 7.01f, NAN);
+  uart->emitAuto("done", 2, 2);
+
+  std::string s;
+  static char buf[1024];
+  std::vector<std::string> lines;
+  service(0);
+  while (master.next(s, 100)) { lines.push_back(s); service(0); }
+  check(lines.size() == 5, "5 eventos empujados sin pedirlos");
+  for (const std::string& l : lines) printf("        %s\n", l.c_str());
+  if (lines.size() == 5) {
+    strlcpy(buf, lines[1].c_str(), sizeof(buf));
+    deserializeJson(r, buf);
+    check(!strcmp(r["ev"] | "", "step") && r["seq"] == 2 &&
+          !strcmp(r["data"]["op"] | "", "pump") && !strcmp(r["data"]["act"] | "", "drain") &&
+          !strcmp(r["data"]["outcome"] | "", "timeout") && r["data"]["ms"] == 1234,
+          "step: op/act/outcome/ms");
+    strlcpy(buf, lines[2].c_str(), sizeof(buf));
+    deserializeJson(r, buf);
+    check(!strcmp(r["data"]["sensor"] | "", "o2") && r["data"]["active"] == true && r["t"] == 5000,
+          "level: sensor/active/t del flanco");
+    strlcpy(buf, lines[3].c_str(), sizeof(buf));
+    deserializeJson(r, buf);
+    check(r["data"]["id"] == 1 && r["data"]["o2_val"].isNull() &&
+          fabs((r["data"]["ph_val"] | 0.0f) - 7.01f) < 0.001f, "sample: id/ph_val/o2_val null");
+    strlcpy(buf, lines[4].c_str(), sizeof(buf));
+    deserializeJson(r, buf);
+    check(!strcmp(r["ev"] | "", "auto") && !strcmp(r["data"]["state"] | "", "done") &&
+          r["data"]["total"] == 2 && r["seq"] == 5, "auto: done, seq 5");
+  }
+  t.expect = 6;
+
+  // 3) Línea perdida: el maestro ve el salto y la recupera con resend
+  for (int i = 0; i < 3; ++i) uart->emitLevel("ph", i & 1, 6000 + i);
+  drainEvents(t, 7);
+  check(t.gaps == 1 && t.expect == 9, "salto 6 -> 8 detectado");
+  check(command("{\"op\":\"resend\",\"data\":{\"from\":7}}", r) && r["ok"] == true &&
+        r["data"]["next"] == 9 && r["data"]["oldest"] == 1, "resend ok, ventana 1..8");
+  const uint32_t gotBefore = t.got;
+  t.expect = 7;   // el maestro vuelve a esperar desde el que faltaba
+  drainEvents(t);
+  check(t.got - gotBefore == 2 && t.expect == 9, "resend trae 7 y 8 con su seq original");
+
+  // 4) Cola de eventos llena (20 sin atender): 16 + un "error" EV_LOST
+  for (int i = 0; i < 20; ++i) uart->emitLevel("kcl", i & 1, 7000 + i);
+  StaticJsonDocument<512> last;
+  const uint32_t g0 = t.gaps;
+  const uint32_t n4 = drainEvents(t, 0, 100, &last);
+  check(n4 == 17 && t.gaps == g0, "cola llena: 16 eventos + aviso, seq sin saltos");
+  check(!strcmp(last["ev"] | "", "error") && !strcmp(last["data"]["code"] | "", "EV_LOST") &&
+        last["data"]["detail"] == 4, "aviso EV_LOST detail=4");
+  check(uart->droppedEvents() == 4, "droppedEvents() == 4");
+
+  // 5) unsubscribe: nada se empuja, pero se sigue numerando
+  check(command("{\"op\":\"unsubscribe\"}", r) && r["ok"] == true, "unsubscribe ok");
+  uart->emitAuto("start", 1, 1);
+  const uint32_t seqQuiet = t.expect;
+  check(drainEvents(t) == 0, "sin suscripción no llegan eventos");
+  check(command("{\"op\":\"resend\",\"data\":{\"from\":0}}", r) && r["ok"] == true &&
+        r["data"]["next"] == seqQuiet + 1, "el evento callado tiene seq");
+  Tracker t5;
+  t5.expect = r["data"]["oldest"] | 0u;
+  drainEvents(t5);
+  check(t5.gaps == 0 && t5.expect == seqQuiet + 1 && !strcmp(t5.lastEv, "auto"),
+        "resend sin suscripción trae el historial completo");
+  t.expect = seqQuiet + 1;
+
+  // 6) Historial pisado: oldest > from avisa que lo anterior no está
+  for (int b = 0; b < 3; ++b) {
+    for (int i = 0; i < 14; ++i) uart->emitLevel("h2o", i & 1, 8000 + i);
+    service(0);
+  }
+  const uint32_t next6 = t.expect + 42;
+  check(command("{\"op\":\"resend\",\"data\":{\"from\":1}}", r) && r["ok"] == true &&
+        r["data"]["next"] == next6 && r["data"]["oldest"] == next6 - EventRing::CAP,
+        "historial pisado: oldest = next - CAP");
+  Tracker t6;
+  t6.expect = r["data"]["oldest"] | 0u;
+  check(drainEvents(t6) == EventRing::CAP && t6.gaps == 0, "resend entrega CAP eventos");
+
+  // 7) Argumentos inválidos
+  check(command("{\"op\":\"resend\",\"data\":{\"from\":999999}}", r) &&
+        r["ok"] == false && !strcmp(r["error"] | "", "BAD_ARGS"), "resend futuro -> BAD_ARGS");
+  check(command("{\"op\":\"resend\"}", r) && r["ok"] == false, "resend sin from -> BAD_ARGS");
+
+  // 8) Resubscribe: sigue la numeración
+  check(command("{\"op\":\"subscribe\"}", r) && r["data"]["next"] == next6, "resubscribe next");
+
+  master.close();
+  ::close(devFd);
+  printf("\n%s (%d fallas)\n", fails ? "FALLO" : "OK", fails);
+  return fails ? 1 : 0;
+}
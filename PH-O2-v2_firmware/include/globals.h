@@ -23,6 +23,9 @@
 #define MIXER_PIN 26
 
 #define TEMP_SENSOR 19
+#define ADS_RDY_PIN -1   // ALERT/RDY del ADS1115 (-1 = sin cablear: sondeo por período)
+// Entradas escaneadas (bit0=A0 .. bit3=A3, bit4=A0-A1, bit5=A2-A3); 1 solo bit => continuo
+#define ADS_SCAN_MASK ((1u << 0) /* pH */ | (1u << ADS1115Manager::IN_DIFF_23) /* O2 */)
 
 #define TELNET_HOSTNAME "ph-remote"
 
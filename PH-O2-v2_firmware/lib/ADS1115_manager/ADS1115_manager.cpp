@@ -20,11 +20,60 @@ bool ADS1115Manager::begin() {
 void ADS1115Manager::setGain(adsGain_t g) {
   gain_ = g;
   if (connected_) ads_.setGain(gain_);
+  if (scanRunning_()) startScan(scan_mask_, rdy_pin_);           // canales sin config propia
+  else if (cont_active_) startContinuous(cont_ch_, rdy_pin_);    // reescribe el config
 }
 
 void ADS1115Manager::setDataRate(uint16_t r) {
   rate_ = r;
   if (connected_) ads_.setDataRate(rate_);
+  if (scanRunning_()) startScan(scan_mask_, rdy_pin_);
+  else if (cont_active_) startContinuous(cont_ch_, rdy_pin_);
+}
+
+uint16_t ADS1115Manager::spsOf_(uint16_t rate) {
+  switch (rate) {
+    case RATE_ADS1115_8SPS:   return 8;
+    case RATE_ADS1115_16SPS:  return 16;
+    case RATE_ADS1115_32SPS:  return 32;
+    case RATE_ADS1115_64SPS:  return 64;
+    case RATE_ADS1115_128SPS: return 128;
+    case RATE_ADS1115_250SPS: return 250;
+    case RATE_ADS1115_475SPS: return 475;
+    case RATE_ADS1115_860SPS: return 860;
+    default:                  return 128;
+  }
+}
+
+uint32_t ADS1115Manager::periodUs_(uint16_t rate) {
+  uint32_t us = 1000000UL / spsOf_(rate);
+  return us + us / 10;
+}
+
+float ADS1115Manager::fullScale_(adsGain_t g) {
+  switch (g) {
+    case GAIN_TWOTHIRDS: return 6.144f;
+    case GAIN_ONE:       return 4.096f;
+    case GAIN_TWO:       return 2.048f;
+    case GAIN_FOUR:      return 1.024f;
+    case GAIN_EIGHT:     return 0.512f;
+    case GAIN_SIXTEEN:   return 0.256f;
+    default:             return 6.144f;
+  }
+}
+
+float ADS1115Manager::lsbVolts(uint8_t channel) const {
+  const adsGain_t g = (channel == 0xFF) ? gain_ : gainOf_(channel);
+  // Los diferenciales no llevan la calibración del ADS (ver toVolts_)
+  const float scale = (channel == 0xFF || channel < 4) ? fabsf(cal_scale_) : 1.0f;
+  return scale * fullScale_(g) / 32768.0f;
+}
+
+uint8_t ADS1115Manager::window_() const {
+  uint8_t n = avg_;
+  if (n < 5) n = 5;
+  if (n > AdsSampleRing::CAPACITY) n = AdsSampleRing::CAPACITY;
+  return n;
 }
 
 void ADS1115Manager::setAveraging(uint8_t n) {
@@ -49,6 +98,24 @@ bool ADS1115Manager::checkChannel_(uint8_t ch) {
   return true;
 }
 
+bool ADS1115Manager::checkInput_(uint8_t in) {
+  if (in >= INPUTS) {
+    setError_("Entrada inválida (0..3, 01, 23)");
+    return false;
+  }
+  if (!connected_) {
+    setError_("ADS1115 no inicializado");
+    return false;
+  }
+  return true;
+}
+
+uint16_t ADS1115Manager::muxOf_(uint8_t in) {
+  if (in == IN_DIFF_01) return ADS1X15_REG_CONFIG_MUX_DIFF_0_1;
+  if (in == IN_DIFF_23) return ADS1X15_REG_CONFIG_MUX_DIFF_2_3;
+  return MUX_BY_CHANNEL[in & 3];
+}
+
 void ADS1115Manager::setError_(const char* msg) {
   strncpy(last_error_, msg, sizeof(last_error_) - 1);
   last_error_[sizeof(last_error_) - 1] = '\0';
@@ -65,6 +132,7 @@ bool ADS1115Manager::readOnceRawSingle_(uint8_t ch, int16_t& raw) {
 }
 
 bool ADS1115Manager::readOnceRawDiff_(uint8_t pair, int16_t& raw) {
+  last_single_ch_ = (pair <= 1) ? (uint8_t)(IN_DIFF_01 + pair) : 0xFF;
   if (pair == 0) {           // A0-A1
     raw = ads_.readADC_Differential_0_1();
     return true;
@@ -75,6 +143,10 @@ bool ADS1115Manager::readOnceRawDiff_(uint8_t pair, int16_t& raw) {
   return false;
 }
 
+bool ADS1115Manager::readOnceRawInput_(uint8_t in, int16_t& raw) {
+  return (in < 4) ? readOnceRawSingle_(in, raw) : readOnceRawDiff_((uint8_t)(in - IN_DIFF_01), raw);
+}
+
 //mediana aritmética de n lecturas single-ended
 // bool ADS1115Manager::readSingleRaw(uint8_t channel, int16_t& raw) {
 //   if (!checkChannel_(channel)) return false;
@@ -103,10 +175,25 @@ bool ADS1115Manager::readOnceRawDiff_(uint8_t pair, int16_t& raw) {
 //   return true;
 // }
 
-//mediana aritmética de n lecturas single-ended
+// Banda en cuentas ADC: ~0.1 V a PGA±4.096 V => 0.1 / 0.000125 ≈ 800 cuentas
+// Ajusta si usas otro PGA.
+static const int16_t GATE = 800; // ≈ 0.1 V @ 4.096VFS. Sube/baja según tu ruido real.
+
 bool ADS1115Manager::readSingleRaw(uint8_t channel, int16_t& raw) {
   if (!checkChannel_(channel)) return false;
 
+  if (streaming_(channel)) return collectContinuous_(channel, raw);
+
+  // Otro canal: pausa continuo/escaneo, single-shot y reanuda (los rings se reinician)
+  const uint8_t paused = pauseStream_();
+  bool ok = readSingleShotRaw_(channel, raw);
+  resumeStream_(paused);
+  return ok;
+}
+
+//mediana aritmética de n lecturas single-ended
+bool ADS1115Manager::readSingleShotRaw_(uint8_t channel, int16_t& raw) {
+  last_single_ch_ = channel;
   // ---- Dummy para estabilizar tras cambio de MUX/ganancia ----
   int16_t throwaway;
   if (!readOnceRawSingle_(channel, throwaway)) {
@@ -115,8 +202,10 @@ bool ADS1115Manager::readSingleRaw(uint8_t channel, int16_t& raw) {
   }
 
   // ---- Espera adicional tras el dummy (CLAVE) ----
-  auto convDelayMs = [](uint16_t rate)->uint16_t {
-    switch (rate) {
+  // Antes se comparaba rate_ (código del registro, p.ej. 0x00A0) con SPS y
+  // casi siempre caía en el default; ahora se usa sps_().
+  auto convDelayMs = [](uint16_t sps)->uint16_t {
+    switch (sps) {
       case 8:   return 140;
       case 16:  return 75;
       case 32:  return 40;
@@ -128,16 +217,13 @@ bool ADS1115Manager::readSingleRaw(uint8_t channel, int16_t& raw) {
       default:  return 10;
     }
   };
-  const uint16_t waitMs = convDelayMs(rate_);
+  const uint16_t waitMs = convDelayMs(sps_());
   delay(waitMs);  // <<--- evita que el primer sample real salga 0/160/16383
 
   // ---- Tamaño de ventana ----
-  static constexpr uint8_t MAX_SAMPLES = 32;
-  uint8_t N = avg_;
-  if (N < 5) N = 5;
-  if (N > MAX_SAMPLES) N = MAX_SAMPLES;
+  const uint8_t N = window_();
 
-  int16_t buf[MAX_SAMPLES];
+  int16_t buf[AdsSampleRing::CAPACITY];
   for (uint8_t i = 0; i < N; ++i) {
     int16_t r;
     if (!readOnceRawSingle_(channel, r)) {
@@ -148,61 +234,435 @@ bool ADS1115Manager::readSingleRaw(uint8_t channel, int16_t& raw) {
     if (i + 1 < N) delay(waitMs);
   }
 
-  // ---- Ordena (insertion sort) ----
-  for (uint8_t i = 1; i < N; ++i) {
-    int16_t x = buf[i];
-    int8_t j = i - 1;
-    while (j >= 0 && buf[j] > x) { buf[j + 1] = buf[j]; --j; }
-    buf[j + 1] = x;
+  if (!adsRobustMean(buf, N, GATE, last_raw_)) {
+    setError_("Trim vacio");
+    return false;
   }
+  last_error_[0] = '\0';
+  raw = last_raw_;
+  return true;
+}
 
-  // ---- Mediana base ----
-  int16_t med;
-  if (N & 1) med = buf[N / 2];
-  else       med = (int16_t)((int32_t)buf[N/2 - 1] + (int32_t)buf[N/2]) / 2;
+// ===== Modo continuo =====
 
-  // ---- Recorte anclado a la mediana (banda de aceptación) ----
-  // Banda en cuentas ADC: ~0.1 V a PGA±4.096 V => 0.1 / 0.000125 ≈ 800 cuentas
-  // Ajusta si usas otro PGA.
-  const int16_t GATE = 800; // ≈ 0.1 V @ 4.096VFS. Sube/baja según tu ruido real.
+void IRAM_ATTR ADS1115Manager::rdyIsr_(void* arg) {
+  static_cast<ADS1115Manager*>(arg)->rdy_pending_.fetch_add(1, std::memory_order_relaxed);
+}
 
-  int32_t acc = 0; uint16_t cnt = 0;
-  for (uint8_t i = 0; i < N; ++i) {
-    int32_t d = (int32_t)buf[i] - (int32_t)med;
-    if (d < 0) d = -d;
-    if (d <= GATE) { acc += buf[i]; ++cnt; }
-  }
-
-  // Si la banda dejó muy pocos, cae a recortada 25% clásica
-  if (cnt < (N / 2)) {
-    uint8_t k = N / 4;                // 25%
-    uint8_t start = k;
-    uint8_t end = N - k;              // exclusivo
-    if (end <= start) { start = 0; end = N; }
-
-    acc = 0; cnt = 0;
-    for (uint8_t i = start; i < end; ++i) { acc += buf[i]; ++cnt; }
-    if (cnt == 0) {
-      setError_("Trim vacio");
-      return false;
-    }
+bool ADS1115Manager::startContinuous(uint8_t channel, int8_t rdyPin) {
+  if (!startContinuous_(channel, rdyPin, gain_, rate_)) return false;
+  scan_single_ = false;
+  return true;
+}
+
+bool ADS1115Manager::startContinuous_(uint8_t channel, int8_t rdyPin, adsGain_t g, uint16_t rate) {
+  if (!checkInput_(channel)) return false;
+  if (cont_active_) stopContinuous();
+  if (scan_active_) stopScan();
+
+  // startADCReading() también programa HI/LO_THRESH para que ALERT/RDY
+  // pulse al final de cada conversión
+  cont_gain_ = g;
+  cont_rate_ = rate;
+  ads_.setGain(cont_gain_);
+  ads_.setDataRate(cont_rate_);
+  ads_.startADCReading(muxOf_(channel), /*continuous=*/true);
+
+  cont_ch_     = channel;
+  rdy_pin_     = rdyPin;
+  seen_[channel] = rings_[channel].total();
+  last_single_ch_ = 0xFF;
+  settle_left_ = 1;
+  rings_[channel].clear();
+  rdy_pending_.store(0);
+
+  // +10%: el oscilador interno del ADS tiene ±10%, así nunca se lee dos veces la misma
+  period_us_ = periodUs_(cont_rate_);
+  next_poll_us_ = micros() + period_us_;
+
+  if (rdy_pin_ >= 0) {
+    pinMode(rdy_pin_, INPUT_PULLUP);   // ALERT/RDY es open-drain
+    attachInterruptArg(digitalPinToInterrupt(rdy_pin_), rdyIsr_, this, FALLING);
+  }
+  cont_active_ = true;
+  last_error_[0] = '\0';
+  return true;
+}
+
+void ADS1115Manager::stopContinuous() {
+  if (!cont_active_) return;
+  if (rdy_pin_ >= 0) detachInterrupt(digitalPinToInterrupt(rdy_pin_));
+  // Una conversión single-shot deja al ADS en power-down; después vuelven
+  // ganancia/tasa globales para las lecturas sueltas
+  ads_.startADCReading(muxOf_(cont_ch_), /*continuous=*/false);
+  ads_.setGain(gain_);
+  ads_.setDataRate(rate_);
+  cont_active_ = false;
+}
+
+// ===== Escaneo round-robin =====
+
+void ADS1115Manager::setChannelConfig(uint8_t channel, const AdsChannelConfig& cfg) {
+  if (channel >= INPUTS) return;
+  chan_cfg_[channel] = cfg;
+  if (chan_cfg_[channel].dwell == 0) chan_cfg_[channel].dwell = 1;
+  chan_cfg_set_ |= (uint8_t)(1u << channel);
+  if (scanRunning_() && (scan_mask_ & (1u << channel))) startScan(scan_mask_, rdy_pin_);
+}
+
+AdsChannelConfig ADS1115Manager::channelConfig(uint8_t channel) const {
+  if (channel >= INPUTS) channel = 0;
+  if (chan_cfg_set_ & (1u << channel)) return chan_cfg_[channel];
+  AdsChannelConfig c;      // sin config propia: ganancia/tasa globales
+  c.gain = gain_;
+  c.rate = rate_;
+  return c;
+}
+
+bool ADS1115Manager::startScan(uint8_t channelMask, int8_t rdyPin) {
+  channelMask &= (uint8_t)((1u << INPUTS) - 1);
+  if (channelMask == 0) {
+    setError_("Escaneo sin canales");
+    return false;
+  }
+  if (!connected_) {
+    setError_("ADS1115 no inicializado");
+    return false;
   }
+  if (cont_active_) stopContinuous();
+  if (scan_active_) stopScan();
+  scan_mask_ = channelMask;
+  rdy_pin_   = rdyPin;
+
+  // Un solo canal: sin cambios de MUX, el continuo rinde el 100% de la tasa.
+  // La config del canal va solo al continuo: gain_/rate_ siguen siendo las globales.
+  if ((channelMask & (channelMask - 1)) == 0) {
+    uint8_t ch = 0;
+    while (!(channelMask & (1u << ch))) ++ch;
+    const AdsChannelConfig cfg = channelConfig(ch);
+    if (!startContinuous_(ch, rdyPin, cfg.gain, cfg.rate)) return false;
+    scan_single_ = true;
+    return true;
+  }
+
+  for (uint8_t ch = 0; ch < INPUTS; ++ch) {
+    if (!(channelMask & (1u << ch))) continue;
+    rings_[ch].clear();
+    seen_[ch] = rings_[ch].total();
+  }
+  last_single_ch_ = 0xFF;
+  rdy_pending_.store(0);
+
+  scan_ch_ = nextScanCh_(INPUTS - 1);
+  const AdsChannelConfig cfg = channelConfig(scan_ch_);
+  scan_discard_left_ = cfg.discard;
+  scan_dwell_left_   = cfg.dwell ? cfg.dwell : 1;
 
-  last_raw_ = (int16_t)(acc / (int32_t)cnt);
+  if (rdy_pin_ >= 0) {
+    pinMode(rdy_pin_, INPUT_PULLUP);
+    attachInterruptArg(digitalPinToInterrupt(rdy_pin_), rdyIsr_, this, FALLING);
+  }
+  scan_active_ = true;
   last_error_[0] = '\0';
+  triggerScan_();
+  return true;
+}
+
+void ADS1115Manager::stopScan() {
+  if (cont_active_ && scan_single_) {
+    stopContinuous();
+    return;
+  }
+  if (!scan_active_) return;
+  if (rdy_pin_ >= 0) detachInterrupt(digitalPinToInterrupt(rdy_pin_));
+  // El single-shot en curso termina solo y el ADS queda en power-down;
+  // se restauran ganancia/tasa globales para las lecturas sueltas
+  ads_.setGain(gain_);
+  ads_.setDataRate(rate_);
+  scan_active_ = false;
+  scan_busy_ = false;
+}
+
+uint8_t ADS1115Manager::nextScanCh_(uint8_t from) const {
+  for (uint8_t i = 1; i <= INPUTS; ++i) {
+    const uint8_t ch = (uint8_t)((from + i) % INPUTS);
+    if (scan_mask_ & (1u << ch)) return ch;
+  }
+  return from;
+}
+
+void ADS1115Manager::triggerScan_() {
+  const AdsChannelConfig cfg = channelConfig(scan_ch_);
+  // setGain/setDataRate de Adafruit solo guardan el valor; startADCReading
+  // escribe MUX + PGA + DR + OS en una sola transacción
+  ads_.setGain(cfg.gain);
+  ads_.setDataRate(cfg.rate);
+  rdy_pending_.store(0);
+  ads_.startADCReading(muxOf_(scan_ch_), /*continuous=*/false);
+
+  const uint32_t now = micros();
+  const uint32_t per = periodUs_(cfg.rate);          // ya trae +10%
+  scan_ready_us_    = now + per - per / 5;           // el oscilador puede ir 10% rápido
+  scan_deadline_us_ = now + 2 * per + 2000;
+  scan_busy_ = true;
+}
+
+uint8_t ADS1115Manager::serviceScan_() {
+  if (!scan_busy_) {
+    triggerScan_();
+    return 0;
+  }
+
+  const uint32_t now = micros();
+  bool ready;
+  if (rdy_pin_ >= 0) ready = rdy_pending_.exchange(0) != 0;
+  else ready = (int32_t)(now - scan_ready_us_) >= 0 && ads_.conversionComplete();
+
+  if ((int32_t)(now - scan_deadline_us_) >= 0) {
+    // Pasado el plazo: o el ADS no terminó, o nadie llamó service() (la tarea
+    // de adquisición duerme entre ciclos) y la conversión es vieja. En ambos
+    // casos no va al ring; se repite el mismo canal.
+    if (ready) {
+      ++scan_discarded_;
+    } else {
+      ++overruns_;
+      setError_("Timeout escaneo");
+    }
+    triggerScan_();
+    return 0;
+  }
+  if (!ready) return 0;
+
+  const int16_t r  = ads_.getLastConversionResults();
+  const uint8_t ch = scan_ch_;
+  uint8_t kept = 0;
+  if (scan_discard_left_) {
+    --scan_discard_left_;
+    ++scan_discarded_;
+  } else {
+    rings_[ch].push(r, millis());
+    kept = 1;
+    if (scan_dwell_left_) --scan_dwell_left_;
+  }
+
+  if (!scan_discard_left_ && !scan_dwell_left_) {
+    scan_ch_ = nextScanCh_(ch);
+    const AdsChannelConfig cfg = channelConfig(scan_ch_);
+    // Con dwell se paga el asentamiento una vez por visita, no por muestra
+    scan_discard_left_ = (scan_ch_ != ch) ? cfg.discard : 0;
+    scan_dwell_left_   = cfg.dwell ? cfg.dwell : 1;
+  }
+
+  triggerScan_();   // encadenada: el ADS no queda ocioso esperando al lector
+  return kept;
+}
+
+bool ADS1115Manager::streaming_(uint8_t ch) const {
+  if (ch >= INPUTS) return false;
+  if (cont_active_) return ch == cont_ch_;
+  if (scan_active_) return (scan_mask_ >> ch) & 1u;
+  return false;
+}
+
+uint8_t ADS1115Manager::dwellOf_(uint8_t ch) const {
+  if (!scan_active_) return 1;
+  const uint8_t d = channelConfig(ch).dwell;
+  return d ? d : 1;
+}
+
+adsGain_t ADS1115Manager::gainOf_(uint8_t ch) const {
+  if (cont_active_ && ch == cont_ch_) return cont_gain_;
+  if (scan_active_ && ch < INPUTS && ((scan_mask_ >> ch) & 1u)) return channelConfig(ch).gain;
+  return gain_;
+}
+
+uint32_t ADS1115Manager::streamCycleUs_() const {
+  if (!scan_active_) return period_us_;
+  // ~300 us de I2C por conversión (disparo + OS + resultado a 400 kHz)
+  uint32_t us = 0;
+  for (uint8_t ch = 0; ch < INPUTS; ++ch) {
+    if (!(scan_mask_ & (1u << ch))) continue;
+    const AdsChannelConfig cfg = channelConfig(ch);
+    us += (uint32_t)(cfg.discard + (cfg.dwell ? cfg.dwell : 1)) * (periodUs_(cfg.rate) + 300);
+  }
+  return us;
+}
+
+uint8_t ADS1115Manager::pauseStream_() {
+  if (scanRunning_()) { stopScan(); return 2; }
+  if (cont_active_) { stopContinuous(); return 1; }
+  return 0;
+}
+
+void ADS1115Manager::resumeStream_(uint8_t what) {
+  if (what == 1) startContinuous(cont_ch_, rdy_pin_);
+  else if (what == 2) startScan(scan_mask_, rdy_pin_);
+}
+
+// Espera hasta la próxima conversión esperada: cede la CPU si falta mucho,
+// espera activa corta si falta poco (delay(1) sobre 4 ms perdería ~25%)
+void ADS1115Manager::idle_() {
+  if (rdy_pin_ >= 0) {
+    delay(1);
+    return;
+  }
+  const uint32_t target = scan_active_ ? scan_ready_us_ : next_poll_us_;
+  const int32_t left = (int32_t)(target - micros());
+  if (left >= 2000) delay((uint32_t)left / 1000);
+  else if (left > 0) delayMicroseconds((uint32_t)left);
+  else delayMicroseconds(50);
+}
+
+uint8_t ADS1115Manager::service() {
+  if (scan_active_) return serviceScan_();
+  if (!cont_active_) return 0;
+
+  if (rdy_pin_ >= 0) {
+    uint32_t n = rdy_pending_.exchange(0);
+    if (n == 0) return 0;
+    if (n > 1) overruns_ += n - 1;   // solo queda la última en el registro
+  } else {
+    const uint32_t now = micros();
+    if ((int32_t)(now - next_poll_us_) < 0) return 0;
+    // Agenda fija (no now + período): el retraso de cada sondeo no se acumula
+    const uint32_t late = now - next_poll_us_;
+    if (late >= period_us_) {
+      overruns_ += late / period_us_;
+      next_poll_us_ = now + period_us_;
+    } else {
+      next_poll_us_ += period_us_;
+    }
+  }
+
+  const int16_t r = ads_.getLastConversionResults();
+  if (settle_left_) {
+    --settle_left_;
+    return 0;
+  }
+  rings_[cont_ch_].push(r, millis());
+  return 1;
+}
+
+bool ADS1115Manager::readFilteredRaw(int16_t& raw, uint32_t maxAgeMs) {
+  if (!cont_active_) {
+    setError_("Modo continuo inactivo");
+    return false;
+  }
+  return readFilteredRaw(cont_ch_, raw, maxAgeMs);
+}
+
+bool ADS1115Manager::readFiltered(float& volts, uint32_t maxAgeMs) {
+  if (!cont_active_) {
+    setError_("Modo continuo inactivo");
+    return false;
+  }
+  return readFiltered(cont_ch_, volts, maxAgeMs);
+}
+
+bool ADS1115Manager::readFilteredRaw(uint8_t channel, int16_t& raw, uint32_t maxAgeMs) {
+  if (!streaming_(channel)) {
+    setError_("Canal fuera del continuo/escaneo");
+    return false;
+  }
+  const uint8_t N = window_();
+  int16_t buf[AdsSampleRing::CAPACITY];
+  if (rings_[channel].latest(buf, N, millis() - maxAgeMs) < N) return false;
+
+  if (!adsRobustMean(buf, N, GATE, last_raw_)) return false;
   raw = last_raw_;
   return true;
 }
 
+bool ADS1115Manager::readFiltered(uint8_t channel, float& volts, uint32_t maxAgeMs) {
+  int16_t raw;
+  if (!readFilteredRaw(channel, raw, maxAgeMs)) return false;
+  last_volts_ = toVolts_(raw, channel);
+  volts = last_volts_;
+  return true;
+}
 
+bool ADS1115Manager::readConversion(uint8_t channel, float& volts) {
+  if (!checkInput_(channel)) return false;
+
+  int16_t r;
+  if (streaming_(channel)) {
+    // Entrega en orden las conversiones no leídas (seen_ .. total()): en
+    // escaneo llegan por ráfagas de dwell y cada una cuenta para el estimador.
+    // Las más viejas que dos vueltas (lector que volvió tarde) o que el ring
+    // ya pisó se consumen sin entregar.
+    const AdsSampleRing& ring = rings_[channel];
+    const uint32_t cycleUs = streamCycleUs_();
+    const uint32_t freshMs = (cycleUs * 2) / 1000UL + 2;
+    const uint32_t t0 = millis();
+    const uint32_t timeoutMs = (cycleUs * 4) / 1000UL + 20;
+    AdsSample s;
+    for (;;) {
+      const uint32_t total = ring.total();
+      if (total - seen_[channel] > ring.size()) seen_[channel] = total - ring.size();
+      bool got = false;
+      while (!got && seen_[channel] != total) {
+        got = ring.get(seen_[channel]++, s) && millis() - s.t_ms <= freshMs;
+      }
+      if (got) break;
+      if (millis() - t0 > timeoutMs) {
+        setError_("Timeout modo continuo");
+        return false;
+      }
+      if (!service()) idle_();
+    }
+    r = s.raw;
+  } else {
+    if (cont_active_ || scan_active_) {
+      setError_("ADS en continuo en otro canal");
+      return false;
+    }
+    if (channel != last_single_ch_) {
+      int16_t throwaway;
+      if (!readOnceRawInput_(channel, throwaway)) {
+        setError_("Lectura dummy falló");
+        return false;
+      }
+    }
+    if (!readOnceRawInput_(channel, r)) {
+      setError_("Lectura raw falló");
+      return false;
+    }
+    last_single_ch_ = channel;
+  }
 
+  last_raw_ = r;
+  last_volts_ = toVolts_(r, channel);
+  volts = last_volts_;
+  return true;
+}
+
+// Bloqueante (API de readSingle): espera solo lo necesario para juntar una
+// ventana fresca; el ritmo lo marcan las conversiones, no delays fijos.
+bool ADS1115Manager::collectContinuous_(uint8_t ch, int16_t& raw) {
+  const uint8_t  N = window_();
+  const uint8_t  dwell = dwellOf_(ch);
+  const uint32_t cycles = (uint32_t)(N + dwell - 1) / dwell + (scan_active_ ? 1 : 0);
+  const uint32_t freshMs = (uint32_t)(((uint64_t)cycles * streamCycleUs_()) / 1000UL) + 2;
+  const uint32_t timeoutMs = freshMs * 2 + 20;
+
+  const uint32_t t0 = millis();
+  for (;;) {
+    if (readFilteredRaw(ch, raw, freshMs)) {
+      last_error_[0] = '\0';
+      return true;
+    }
+    if (millis() - t0 > timeoutMs) break;
+    if (!service()) idle_();
+  }
+  setError_("Timeout modo continuo");
+  return false;
+}
 
 bool ADS1115Manager::readSingle(uint8_t channel, float& volts) {
   int16_t raw;
   if (!readSingleRaw(channel, raw)) return false;
 
-  float v = ads_.computeVolts(raw);
-  last_volts_ = applyCal_(v);
+  last_volts_ = toVolts_(raw, channel);
   volts = last_volts_;
   return true;
 }
@@ -217,15 +677,30 @@ bool ADS1115Manager::readDifferentialRaw(uint8_t pair, int16_t& raw) {
     return false;
   }
 
+  // El MUX diferencial pisa al continuo/escaneo: se pausa y se reanuda al final
+  const uint8_t paused = pauseStream_();
+
+  // Tras cambio de MUX se descarta una conversión, como en readConversion()
   int32_t acc = 0;
-  for (uint8_t i = 0; i < avg_; ++i) {
+  bool ok = true;
+  if (last_single_ch_ != IN_DIFF_01 + pair) {
+    int16_t throwaway;
+    ok = readOnceRawDiff_(pair, throwaway);
+  }
+  for (uint8_t i = 0; ok && i < avg_; ++i) {
     int16_t r;
     if (!readOnceRawDiff_(pair, r)) {
-      setError_("Lectura diff raw falló");
-      return false;
+      ok = false;
+      break;
     }
     acc += r;
   }
+  resumeStream_(paused);
+  if (!ok) {
+    setError_("Lectura diff raw falló");
+    return false;
+  }
+
   last_raw_ = static_cast<int16_t>(acc / (int32_t)avg_);
   last_error_[0] = '\0';
   raw = last_raw_;
@@ -235,8 +710,8 @@ bool ADS1115Manager::readDifferentialRaw(uint8_t pair, int16_t& raw) {
 bool ADS1115Manager::readDifferential01(float& volts) {
   int16_t raw;
   if (!readDifferentialRaw(0, raw)) return false;
-  float v = ads_.computeVolts(raw);
-  last_volts_ = applyCal_(v);
+  // Sin calibración del ADS, igual que toVolts_() (ganancia global: la de la lectura)
+  last_volts_ = raw * fullScale_(gain_) / 32768.0f;
   volts = last_volts_;
   return true;
 }
@@ -244,8 +719,8 @@ bool ADS1115Manager::readDifferential01(float& volts) {
 bool ADS1115Manager::readDifferential23(float& volts) {
   int16_t raw;
   if (!readDifferentialRaw(1, raw)) return false;
-  float v = ads_.computeVolts(raw);
-  last_volts_ = applyCal_(v);
+  // Sin calibración del ADS, igual que toVolts_() (ganancia global: la de la lectura)
+  last_volts_ = raw * fullScale_(gain_) / 32768.0f;
   volts = last_volts_;
   return true;
 }
@@ -4,11 +4,30 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <Adafruit_ADS1X15.h>
+#include <atomic>
+#include "ads_sample_ring.h"
+
+// Configuración por canal para el escaneo
+struct AdsChannelConfig {
+  adsGain_t gain = GAIN_ONE;
+  uint16_t  rate = RATE_ADS1115_250SPS;  // código del registro (RATE_ADS1115_*)
+  uint8_t   discard = 1;                 // conversiones descartadas al entrar al canal
+  uint8_t   dwell = 4;                   // conversiones guardadas por visita (>=1)
+};
 
 class ADS1115Manager {
 public:
   explicit ADS1115Manager(uint8_t i2c_addr = 0x48, TwoWire* wire = &Wire);
 
+  // Entradas para escaneo/continuo/readConversion: 0..3 single-ended y los
+  // pares diferenciales. La calibración del ADS (setCalibration) solo se aplica
+  // a las single-ended: se mide en A0 a GAIN_ONE. Los diferenciales
+  // (readDifferential*, readConversion, lsbVolts) se entregan sin calibrar;
+  // cada sonda diferencial se calibra en su manager (O2Manager).
+  static constexpr uint8_t IN_DIFF_01 = 4;   // A0-A1
+  static constexpr uint8_t IN_DIFF_23 = 5;   // A2-A3
+  static constexpr uint8_t INPUTS     = 6;
+
   // Inicialización
   bool begin();
   bool isConnected() const { return connected_; }
@@ -33,6 +52,57 @@ public:
   bool readDifferential23(float& volts);
   bool readDifferentialRaw(uint8_t pair, int16_t& raw); // pair: 0->01, 1->23
 
+  // ===== Modo continuo =====
+  // El ADS convierte sin parar en el canal elegido y service() guarda cada
+  // conversión en un ring. Con rdyPin >= 0 se usa el pin ALERT/RDY (interrupción
+  // por flanco de bajada); con -1 se lee el registro cada período de conversión.
+  // readSingle()/readSingleRaw() del mismo canal salen del ring; otro canal
+  // pausa el modo continuo, hace single-shot y lo reanuda.
+  bool startContinuous(uint8_t channel, int8_t rdyPin = -1);
+  void stopContinuous();
+  bool isContinuous() const { return cont_active_; }
+  uint8_t continuousChannel() const { return cont_ch_; }
+
+  // ===== Escaneo round-robin =====
+  // Recorre las entradas de channelMask (bit0 = A0 .. bit3 = A3, bit4 = A0-A1,
+  // bit5 = A2-A3) con single-shots
+  // encadenados: al terminar una conversión se dispara la siguiente, sin delays.
+  // Cada visita descarta cfg.discard conversiones (asentamiento tras cambio de
+  // MUX) y guarda cfg.dwell en el ring del canal. Con un solo canal no hay
+  // cambios de MUX: equivale a startContinuous() con la config de ese canal,
+  // sin tocar la ganancia/tasa globales (las de lecturas sueltas).
+  // Lecturas de canales del escaneo salen de su ring; los demás lo pausan.
+  void setChannelConfig(uint8_t channel, const AdsChannelConfig& cfg);
+  AdsChannelConfig channelConfig(uint8_t channel) const;
+  bool startScan(uint8_t channelMask, int8_t rdyPin = -1);
+  void stopScan();
+  bool isScanning() const { return scan_active_; }
+  uint8_t scanMask() const { return scan_mask_; }
+  uint32_t scanDiscarded() const { return scan_discarded_; }   // conversiones de asentamiento
+
+  // Llamar seguido (cada <= 1 período ideal). Retorna cuántas conversiones guardó (0/1).
+  uint8_t service();
+
+  // No bloqueante: filtra las últimas avg (>=5) conversiones con edad <= maxAgeMs.
+  // false si aún no hay suficientes.
+  bool readFilteredRaw(int16_t& raw, uint32_t maxAgeMs = 200);
+  bool readFiltered(float& volts, uint32_t maxAgeMs = 200);
+  // Igual, para un canal del escaneo (o el continuo)
+  bool readFilteredRaw(uint8_t channel, int16_t& raw, uint32_t maxAgeMs = 200);
+  bool readFiltered(uint8_t channel, float& volts, uint32_t maxAgeMs = 200);
+
+  // Una sola conversión calibrada, sin ventana ni filtro (para estimadores en streaming).
+  //  - Canal en continuo/escaneo: la conversión más vieja aún no entregada
+  //    (en orden, sin saltear las de una ráfaga de dwell); si no hay, la próxima
+  //  - Otro canal: single-shot; tras cambio de MUX descarta una conversión
+  bool readConversion(uint8_t channel, float& volts);
+  // Voltios por cuenta con la ganancia del canal (0xFF = ganancia global)
+  float lsbVolts(uint8_t channel = 0xFF) const;
+
+  const AdsSampleRing& ring() const { return rings_[cont_ch_]; }
+  const AdsSampleRing& ring(uint8_t channel) const { return rings_[channel < INPUTS ? channel : 0]; }
+  uint32_t overruns() const { return overruns_; }   // conversiones perdidas (service tardío)
+
   // Utilidades
   float lastVoltage() const { return last_volts_; }
   int16_t lastRaw() const { return last_raw_; }
@@ -56,11 +126,69 @@ private:
   char    last_error_[64] = {0};
 
   bool  checkChannel_(uint8_t ch);
+  bool  checkInput_(uint8_t in);          // 0..INPUTS-1
+  static uint16_t muxOf_(uint8_t in);
   float applyCal_(float v) const { return cal_scale_ * v + cal_offset_; }
   void  setError_(const char* msg);
 
+  // Continuo (un canal) y escaneo (varios) comparten rings_/seen_
+  bool     cont_active_ = false;
+  uint8_t  cont_ch_ = 0;
+  adsGain_t cont_gain_ = GAIN_TWOTHIRDS;   // del continuo; gain_/rate_ quedan para single-shots
+  uint16_t cont_rate_ = RATE_ADS1115_128SPS;
+  bool     scan_single_ = false;  // el continuo es un escaneo de un solo canal
+  int8_t   rdy_pin_ = -1;
+  uint8_t  settle_left_ = 0;      // conversiones a descartar tras cambio de MUX
+  uint32_t period_us_ = 0;
+  uint32_t next_poll_us_ = 0;
+  uint32_t overruns_ = 0;
+  std::atomic<uint32_t> rdy_pending_{0};
+  uint32_t seen_[INPUTS] = {0};   // rings_[ch].total() ya entregado por readConversion()
+  uint8_t  last_single_ch_ = 0xFF; // MUX del último single-shot (0xFF = desconocido)
+  AdsSampleRing rings_[INPUTS];
+
+  // Escaneo
+  AdsChannelConfig chan_cfg_[INPUTS];
+  uint8_t  chan_cfg_set_ = 0;     // bits de canales con config propia
+  bool     scan_active_ = false;
+  uint8_t  scan_mask_ = 0;
+  uint8_t  scan_ch_ = 0;          // canal con conversión en curso
+  uint8_t  scan_discard_left_ = 0;
+  uint8_t  scan_dwell_left_ = 0;
+  bool     scan_busy_ = false;    // hay un single-shot disparado
+  uint32_t scan_ready_us_ = 0;    // antes de esto no vale la pena consultar OS
+  uint32_t scan_deadline_us_ = 0;
+  uint32_t scan_discarded_ = 0;
+
+  static void IRAM_ATTR rdyIsr_(void* arg);
+  static uint16_t spsOf_(uint16_t rate);     // código del registro -> muestras/s
+  static float    fullScale_(adsGain_t g);   // ±V de fondo de escala
+  uint16_t sps_() const { return spsOf_(rate_); }
+  bool     startContinuous_(uint8_t channel, int8_t rdyPin, adsGain_t g, uint16_t rate);
+  bool     scanRunning_() const { return scan_active_ || (cont_active_ && scan_single_); }
+  uint8_t  window_() const;       // tamaño de ventana del filtro (avg_ acotado a 5..32)
+  static uint32_t periodUs_(uint16_t rate);  // período de conversión +10% (oscilador ±10%)
+  bool     streaming_(uint8_t ch) const;     // ch sale de un ring (continuo o escaneo)
+  uint32_t streamCycleUs_() const;           // una vuelta completa del escaneo (o 1 período)
+  uint8_t  dwellOf_(uint8_t ch) const;       // muestras de ch por vuelta
+  adsGain_t gainOf_(uint8_t ch) const;
+  float    toVolts_(int16_t raw, uint8_t in) const {
+    const float v = raw * fullScale_(gainOf_(in)) / 32768.0f;
+    return in < 4 ? applyCal_(v) : v;
+  }
+  bool     collectContinuous_(uint8_t ch, int16_t& raw);
+  uint8_t  serviceScan_();
+  void     idle_();               // espera hasta la próxima conversión esperada
+  void     triggerScan_();
+  uint8_t  nextScanCh_(uint8_t from) const;
+  // Pausa lo que esté corriendo para un single-shot y lo reanuda después
+  uint8_t  pauseStream_();        // 0 = nada, 1 = continuo, 2 = escaneo
+  void     resumeStream_(uint8_t what);
+
+  bool readSingleShotRaw_(uint8_t ch, int16_t& raw);
   bool readOnceRawSingle_(uint8_t ch, int16_t& raw);
   bool readOnceRawDiff_(uint8_t pair, int16_t& raw);
+  bool readOnceRawInput_(uint8_t in, int16_t& raw);
 };
 
 #endif // ADS1115_MANAGER_H
@@ -0,0 +1,113 @@
+#ifndef ADS_SAMPLE_RING_H
+#define ADS_SAMPLE_RING_H
+
+#include <stdint.h>
+
+// =====================================================
+// Ring de conversiones del ADS1115 + filtro robusto
+//  - Sin dependencias de Arduino (se prueba en host)
+//  - push() desde el muestreo, latest() copia las más recientes
+// =====================================================
+
+struct AdsSample {
+  int16_t  raw;
+  uint32_t t_ms;   // millis() al leer la conversión
+};
+
+class AdsSampleRing {
+public:
+  static constexpr uint8_t CAPACITY = 32;
+
+  void clear() { head_ = 0; size_ = 0; }
+
+  void push(int16_t raw, uint32_t t_ms) {
+    buf_[head_].raw  = raw;
+    buf_[head_].t_ms = t_ms;
+    head_ = (uint8_t)((head_ + 1) % CAPACITY);
+    if (size_ < CAPACITY) ++size_;
+    ++total_;
+  }
+
+  uint8_t  size()  const { return size_; }
+  uint32_t total() const { return total_; }   // conversiones guardadas desde el arranque
+
+  // Copia hasta n muestras (la más reciente al final) con t_ms >= since_ms.
+  // Retorna cuántas copió.
+  uint8_t latest(int16_t* out, uint8_t n, uint32_t since_ms) const {
+    uint8_t avail = 0;
+    for (uint8_t i = 0; i < size_ && avail < n; ++i) {
+      const AdsSample& s = at_(i);
+      if ((int32_t)(s.t_ms - since_ms) < 0) break;
+      ++avail;
+    }
+    for (uint8_t i = 0; i < avail; ++i) out[avail - 1 - i] = at_(i).raw;
+    return avail;
+  }
+
+  // Muestra número seq (0 = la primera guardada); false si el ring ya la pisó
+  // o todavía no llegó. Las disponibles son [total() - size(), total()).
+  bool get(uint32_t seq, AdsSample& s) const {
+    const uint32_t back = total_ - 1 - seq;   // 0 = la más reciente
+    if (seq >= total_ || back >= size_) return false;
+    s = at_((uint8_t)back);
+    return true;
+  }
+
+  bool newest(AdsSample& s) const {
+    if (size_ == 0) return false;
+    s = at_(0);
+    return true;
+  }
+
+private:
+  AdsSample buf_[CAPACITY];
+  uint8_t   head_ = 0;     // próxima posición de escritura
+  uint8_t   size_ = 0;
+  uint32_t  total_ = 0;
+
+  // i = 0 -> más reciente
+  const AdsSample& at_(uint8_t i) const {
+    return buf_[(uint8_t)((head_ + CAPACITY - 1 - i) % CAPACITY)];
+  }
+};
+
+// Media recortada anclada a la mediana (ordena buf in-place).
+//  - Promedia las muestras a <= gate cuentas de la mediana
+//  - Si la banda deja menos de la mitad, cae a recortada 25% clásica
+// Retorna false si n == 0.
+inline bool adsRobustMean(int16_t* buf, uint8_t n, int16_t gate, int16_t& out) {
+  if (n == 0) return false;
+
+  for (uint8_t i = 1; i < n; ++i) {
+    int16_t x = buf[i];
+    int8_t j = i - 1;
+    while (j >= 0 && buf[j] > x) { buf[j + 1] = buf[j]; --j; }
+    buf[j + 1] = x;
+  }
+
+  int16_t med;
+  if (n & 1) med = buf[n / 2];
+  else       med = (int16_t)(((int32_t)buf[n/2 - 1] + (int32_t)buf[n/2]) / 2);
+
+  int32_t acc = 0; uint16_t cnt = 0;
+  for (uint8_t i = 0; i < n; ++i) {
+    int32_t d = (int32_t)buf[i] - (int32_t)med;
+    if (d < 0) d = -d;
+    if (d <= gate) { acc += buf[i]; ++cnt; }
+  }
+
+  if (cnt < (n / 2)) {
+    uint8_t k = n / 4;
+    uint8_t start = k;
+    uint8_t end = n - k;
+    if (end <= start) { start = 0; end = n; }
+
+    acc = 0; cnt = 0;
+    for (uint8_t i = start; i < end; ++i) { acc += buf[i]; ++cnt; }
+  }
+
+  out = (int16_t)(acc / (int32_t)cnt);
+  return true;
+}
+
+#endif // ADS_SAMPLE_RING_H
@@ -1,5 +1,21 @@
 #include "DS18B20_manager.h"
 
+// Temperatura del scratchpad (°C) según la familia del sensor
+static float scratchToC(const uint8_t *addr, const uint8_t *sp) {
+  const int16_t raw = (int16_t)(((uint16_t)sp[1] << 8) | sp[0]);
+
+  if (addr[0] == DS18S20MODEL) {
+    // 9 bits + COUNT_REMAIN/COUNT_PER_C (hoja de datos DS18S20)
+    if (sp[7] == 0) return raw * 0.5f;
+    return (float)(raw >> 1) - 0.25f + (float)(sp[7] - sp[6]) / (float)sp[7];
+  }
+
+  // DS18B20/DS1822: 1/16 °C; bits bajos indefinidos según resolución (byte 4)
+  const uint8_t bits = (uint8_t)(9 + ((sp[4] >> 5) & 0x03));
+  const int16_t mask = (int16_t)~((1 << (12 - bits)) - 1);
+  return (float)(raw & mask) / 16.0f;
+}
+
 DS18B20Manager::DS18B20Manager(uint8_t dataPin, uint8_t resolutionBits)
 : _pin(dataPin),
   _resolution(constrain(resolutionBits, 9, 12)),
@@ -9,7 +25,7 @@ DS18B20Manager::DS18B20Manager(uint8_t dataPin, uint8_t resolutionBits)
 
 uint8_t DS18B20Manager::begin() {
   _dt.begin();
-  _dt.setWaitForConversion(true);      // bloqueante sencillo
+  _dt.setWaitForConversion(true);      // readC() sigue siendo bloqueante
   _count = _dt.getDS18Count();
   if (_count > MAX_SENSORS) _count = MAX_SENSORS;
 
@@ -24,12 +40,42 @@ uint8_t DS18B20Manager::begin() {
   if (_count > 0) {
     _dt.setResolution(_resolution);    // aplicar a todos
   }
+  _parasite   = _dt.isParasitePowerMode();
+  _converting = false;
+  _started    = false;
+  _snap       = DS18B20Snapshot();
+  _snap.count = _count;
   return _count;
 }
 
-float DS18B20Manager::_norm(float c) const {
-  if (c <= DEVICE_DISCONNECTED_C + 0.001f) return NAN;
-  return c;
+void DS18B20Manager::setResolution(uint8_t bits) {
+  _resolution = constrain(bits, 9, 12);
+  if (_count > 0) _dt.setResolution(_resolution);
+}
+
+// Un scratchpad: presencia, CRC y valor de power-on. Si falla se conserva
+// el último valor válido del sensor y se cuenta el motivo.
+bool DS18B20Manager::_readProbe(uint8_t i) {
+  DS18B20Probe &p = _snap.probe[i];
+  p.reads++;
+  p.fresh = false;
+
+  uint8_t sp[9];
+  const bool present = _dt.readScratchPad(_addr[i], sp);
+  uint8_t any = 0, all = 0xFF;
+  for (uint8_t k = 0; k < 9; ++k) { any |= sp[k]; all &= sp[k]; }
+  // Todo 0 pasa el CRC; todo 1 es el bus en reposo: con otros sensores
+  // presentes el reset contesta igual aunque este no esté
+  if (!present || any == 0 || all == 0xFF) { p.noResponse++; return false; }
+  if (OneWire::crc8(sp, 8) != sp[8]) { p.crcErrors++; return false; }
+
+  const uint16_t raw = (uint16_t)(((uint16_t)sp[1] << 8) | sp[0]);
+  if (raw == (_addr[i][0] == DS18S20MODEL ? 0x00AA : 0x0550)) { p.porErrors++; return false; }
+
+  p.c     = scratchToC(_addr[i], sp);
+  p.ms    = millis();
+  p.fresh = true;
+  return true;
 }
 
 float DS18B20Manager::readC(uint8_t index) {
@@ -37,8 +83,19 @@ float DS18B20Manager::readC(uint8_t index) {
 
   // Solicitar conversión y leer específicamente por dirección (bloqueante)
   _dt.requestTemperaturesByAddress(_addr[index]);
-  float c = _dt.getTempC(_addr[index]);
-  return _norm(c);
+  return _readProbe(index) ? _snap.probe[index].c : NAN;
+}
+
+uint8_t DS18B20Manager::readAll(DS18B20Snapshot &out) {
+  uint8_t n = 0;
+  if (_count > 0) {
+    if (!_converting) requestConversion();   // si ya hay una en curso, se aprovecha
+    while (!_conversionDone(millis())) delay(_parasite ? 10 : 2);
+    _converting = false;
+    n = _collect();
+  }
+  out = _snap;
+  return n;
 }
 
 float DS18B20Manager::readF(uint8_t index) {
@@ -47,6 +104,70 @@ float DS18B20Manager::readF(uint8_t index) {
   return DallasTemperature::toFahrenheit(c);
 }
 
+bool DS18B20Manager::requestConversion() {
+  if (_count == 0 || _converting) return false;
+
+  // Skip ROM + Convert T a todos; no espera (readC() mantiene el modo bloqueante)
+  _dt.setWaitForConversion(false);
+  _dt.requestTemperatures();
+  _dt.setWaitForConversion(true);
+
+  _convStartMs = millis();
+  _converting  = true;
+  _started     = true;
+  return true;
+}
+
+// Todos los scratchpads de la conversión común
+uint8_t DS18B20Manager::_collect() {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < _count; ++i) {
+    if (_readProbe(i)) ++n;
+  }
+  _snap.count       = _count;
+  _snap.convStartMs = _convStartMs;
+  _snap.readMs      = millis();
+  _snap.seq++;
+  return n;
+}
+
+bool DS18B20Manager::_conversionDone(uint32_t now) {
+  const uint32_t elapsed = now - _convStartMs;
+  // Con alimentación externa el sensor responde 1 al terminar: se sondea desde
+  // la mitad del tiempo nominal (12 bits suele terminar bastante antes de 750 ms)
+  if (elapsed >= conversionMs()) return true;
+  return !_parasite && elapsed >= conversionMs() / 2 && _dt.isConversionComplete();
+}
+
+void DS18B20Manager::update() {
+  if (_count == 0) return;
+  const uint32_t now = millis();
+
+  if (_converting) {
+    if (!_conversionDone(now)) return;
+    _converting = false;
+    _collect();
+  }
+
+  if (_autoPeriodMs && (!_started || (uint32_t)(now - _convStartMs) >= _autoPeriodMs)) {
+    requestConversion();
+  }
+}
+
+bool DS18B20Manager::lastC(uint8_t index, float &c, uint32_t &ageMs) const {
+  if (!_valid(index) || isnan(_snap.probe[index].c)) return false;
+  c     = _snap.probe[index].c;
+  ageMs = millis() - _snap.probe[index].ms;
+  return true;
+}
+
+float DS18B20Manager::cachedC(uint8_t index, uint32_t maxAgeMs) const {
+  float c;
+  uint32_t age;
+  if (!lastC(index, c, age) || age > maxAgeMs) return NAN;
+  return c;
+}
+
 bool DS18B20Manager::getAddress(uint8_t index, DevAddr out) const {
   if (!_valid(index)) return false;
   for (uint8_t i = 0; i < 8; ++i) out[i] = _addr[index][i];
@@ -57,4 +178,4 @@ void DS18B20Manager::addrToString(const DevAddr a, char *out, size_t n) {
   if (n < 24) { if (n) out[0] = '\0'; return; }
   snprintf(out, n, "%02X-%02X-%02X-%02X-%02X-%02X-%02X-%02X",
            a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
-}
\ No newline at end of file
+}
@@ -52,7 +52,10 @@ bool ConfigStore::load() {
     return false;
   }
 
-  // Solo aceptamos la versión actual (v7)
+  // v7, v8 y v9 son prefijos de v10: se migran sin perder calibraciones
+  if (version >= 0x0007 && version <= 0x0009) return loadOld_(version);
+
+  // Solo aceptamos la versión actual (v10)
   if (version != kVersion) {
     strncpy(_err, "VERSION distinta (no soportada)", sizeof(_err)-1);
     return false;
@@ -74,6 +77,39 @@ bool ConfigStore::load() {
   return true;
 }
 
+bool ConfigStore::loadOld_(uint16_t version) {
+  // El CRC venía justo después del último campo de esa versión:
+  // v7 terminaba en stabilization_ms (antes de o2), v8 en o2 (antes de recipe),
+  // v9 en recipe (antes de learn)
+  const size_t len = (version == 0x0007) ? offsetof(ConfigData, o2)
+                   : (version == 0x0008) ? offsetof(ConfigData, recipe)
+                                         : offsetof(ConfigData, learn);
+  ConfigData tmp{};
+  uint8_t* bytes = reinterpret_cast<uint8_t*>(&tmp);
+  for (size_t i = 0; i < len; ++i) bytes[i] = EEPROM.read(_base + i);
+
+  uint32_t crc = 0;
+  EEPROM.get(_base + len, crc);
+  if (crc32(bytes, len) != crc) {
+    strncpy(_err, version == 0x0007 ? "CRC invalido (v7)"
+                : version == 0x0008 ? "CRC invalido (v8)" : "CRC invalido (v9)", sizeof(_err)-1);
+    return false;
+  }
+
+  tmp.version = kVersion;
+  if (version == 0x0007) {
+    tmp.o2.Vzero = NAN;
+    tmp.o2.Vsat  = NAN;
+    tmp.o2.tC    = NAN;
+  }
+  if (version <= 0x0008) tmp.recipe.count = 0;   // receta de fábrica
+  _cfg = tmp;
+  clearFillLearn();       // sin historia: arranca con los tiempos configurados
+  computeCrc_();
+  _err[0] = '\0';
+  return true;   // queda en RAM como v10; el próximo save() la persiste
+}
+
 bool ConfigStore::save() {
   _cfg.magic   = kMagic;
   _cfg.version = kVersion;
@@ -123,6 +159,16 @@ void ConfigStore::resetDefaults() {
   // Stabilization (ms)
   _cfg.stabilization_ms = 30000;
 
+  // O2 sin calibrar
+  _cfg.o2.Vzero = NAN;
+  _cfg.o2.Vsat  = NAN;
+  _cfg.o2.tC    = NAN;
+
+  // Receta: la de fábrica (memset dejó count = 0)
+
+  // Sin tiempos aprendidos
+  clearFillLearn();
+
   computeCrc_();
   _err[0] = '\0';
 }
@@ -169,6 +215,21 @@ bool ConfigStore::hasPH3pt() const {
   return !(isnan(_cfg.ph3pt.V4) || isnan(_cfg.ph3pt.V7) || isnan(_cfg.ph3pt.V10));
 }
 
+// ---- O2 ----
+void ConfigStore::setO2Cal(float Vzero, float Vsat, float tCalC) {
+  _cfg.o2.Vzero = Vzero;
+  _cfg.o2.Vsat  = Vsat;
+  _cfg.o2.tC    = tCalC;
+}
+void ConfigStore::getO2Cal(float& Vzero, float& Vsat, float& tCalC) const {
+  Vzero = _cfg.o2.Vzero;
+  Vsat  = _cfg.o2.Vsat;
+  tCalC = _cfg.o2.tC;
+}
+bool ConfigStore::hasO2Cal() const {
+  return !isnan(_cfg.o2.Vsat);
+}
+
 // ---- FILL TIMES ----
 void ConfigStore::setFillTimes(uint32_t kcl_ms, uint32_t h2o_ms, uint32_t sample_ms) {
   _cfg.kcl_fill_ms    = clampFill(kcl_ms);
@@ -204,3 +265,21 @@ uint8_t ConfigStore::sampleCount() const       { return _cfg.sample_count; }
 // ---- Stabilization ----
 void ConfigStore::setStabilizationMs(uint32_t ms) { _cfg.stabilization_ms = ms; }
 uint32_t ConfigStore::stabilizationMs() const     { return _cfg.stabilization_ms; }
+
+// ---- Receta AUTO ----
+void ConfigStore::setRecipe(const Recipe& r) { _cfg.recipe = r; }
+void ConfigStore::clearRecipe()              { _cfg.recipe.count = 0; }
+bool ConfigStore::getRecipe(Recipe& r) const {
+  uint8_t bad;
+  if (_cfg.recipe.count == 0 || !recipeValid(_cfg.recipe, bad)) return false;
+  r = _cfg.recipe;
+  return true;
+}
+
+// ---- Aprendizaje de llenado ----
+void ConfigStore::setFillLearn(const FillLearnData& d) { _cfg.learn = d; }
+void ConfigStore::getFillLearn(FillLearnData& d) const { d = _cfg.learn; }
+void ConfigStore::clearFillLearn() {
+  memset(&_cfg.learn, 0, sizeof(_cfg.learn));
+  for (uint8_t i = 0; i < FillLearnData::MAX_ENTRIES; ++i) _cfg.learn.e[i].step = 0xFF;
+}
@@ -1,11 +1,13 @@
 #pragma once
 #include <Arduino.h>
 #include <EEPROM.h>
+#include "recipe.h"
+#include "fill_learner.h"
 
 class ConfigStore {
 public:
-  // Inicializa EEPROM (ESP32). eepromSize sugerido: 256 bytes.
-  bool begin(size_t eepromSize = 256, uint16_t baseAddr = 0);
+  // Inicializa EEPROM (ESP32). eepromSize sugerido: 512 bytes (v10 usa ~410).
+  bool begin(size_t eepromSize = 512, uint16_t baseAddr = 0);
 
   // Carga y guarda configuración
   bool load();
@@ -26,9 +28,15 @@ public:
   void setPH3pt(float V4, float V7, float V10, float tCalC);
   void getPH3pt(float& V4, float& V7, float& V10, float& tCalC) const;
 
+  // --- O2 (Vzero, Vsat, tCalC) ---
+  // 1 punto: Vzero = NaN (cero asumido en 0 V); 2 puntos: Vzero medido
+  void setO2Cal(float Vzero, float Vsat, float tCalC);
+  void getO2Cal(float& Vzero, float& Vsat, float& tCalC) const;
+
   // Helpers para disponibilidad de calibraciones
   bool hasPH2pt() const;  // true si V7 y V4 no son NaN
   bool hasPH3pt() const;  // true si V4, V7 y V10 no son NaN
+  bool hasO2Cal() const;  // true si Vsat no es NaN
 
   // === FILL TIMES (duraciones planificadas) ===
   void     setFillTimes(uint32_t kcl_ms, uint32_t h2o_ms, uint32_t sample_ms);
@@ -61,19 +69,31 @@ public:
   void     setStabilizationMs(uint32_t ms);
   uint32_t stabilizationMs() const;
 
+  // --- Receta del modo AUTO ---
+  // getRecipe() retorna false si no hay una guardada (usar la de fábrica)
+  void     setRecipe(const Recipe& r);
+  bool     getRecipe(Recipe& r) const;
+  void     clearRecipe();
+
+  // --- Aprendizaje de tiempos hasta el sensor (FillLearner) ---
+  void     setFillLearn(const FillLearnData& d);
+  void     getFillLearn(FillLearnData& d) const;
+  void     clearFillLearn();
+
   // Último error
   const char* lastError() const { return _err; }
 
   // Versión del layout actual
-  static constexpr uint16_t kVersion = 0x0007;  // v7: añade ph3pt (4,7,10) manteniendo ph2pt
+  static constexpr uint16_t kVersion = 0x000A;  // v10: añade aprendizaje de llenado (v7..v9 se migran al cargar)
 
 private:
   // ====== Estructuras ======
   struct Pair  { float scale; float offset; };
   struct PH2pt { float V7; float V4; float tC; };
   struct PH3pt { float V4; float V7; float V10; float tC; };
+  struct O2Cal { float Vzero; float Vsat; float tC; };
 
-  // ====== Estructura persistente (v7) ======
+  // ====== Estructura persistente (v10) ======
   struct ConfigData {
     uint16_t magic;     // 0xC0AD
     uint16_t version;   // kVersion
@@ -98,6 +118,15 @@ private:
     uint8_t  sample_count;       // 0..4 bombas sample
     uint32_t stabilization_ms;   // Espera de mezcla/estabilización
 
+    // v8: calibración O2 (v7 termina justo antes de este campo)
+    O2Cal    o2;
+
+    // v9: receta AUTO (count = 0 → de fábrica; v8 termina antes de este campo)
+    Recipe   recipe;
+
+    // v10: tiempos aprendidos en AUTO (v9 termina antes de este campo)
+    FillLearnData learn;
+
     uint32_t crc;                // CRC32 (sin incluir este campo)
   } __attribute__((packed));
 
@@ -106,6 +135,7 @@ private:
 
   static uint32_t crc32(const uint8_t* data, size_t len);
   void computeCrc_();
+  bool loadOld_(uint16_t version);   // migra v7 (sin o2), v8 (sin receta) y v9 (sin aprendizaje) a v10
 
   // Clamps internos
   static uint32_t clampMs(uint32_t ms, uint32_t lo=100, uint32_t hi=600000);
@@ -49,6 +49,14 @@ void Lcd16x2::printAt(uint8_t col, uint8_t row, const String& text) {
   }
 }
 
+// Escribe solo los caracteres dados (lo usa la caché del menú para
+// reescribir el tramo que cambió)
+void Lcd16x2::writeAt(uint8_t col, uint8_t row, const char* text) {
+  if (row >= _rows || col >= _cols || !text) return;
+  _lcd.setCursor(col, row);
+  for (uint8_t c = col; c < _cols && *text; ++c) _lcd.write((uint8_t)*text++);
+}
+
 void Lcd16x2::centerPrint(uint8_t row, const String& text) {
   if (row >= _rows) return;
   String s = text;
@@ -19,6 +19,7 @@ public:
   void clear();
   void setBacklight(bool on);
   void printAt(uint8_t col, uint8_t row, const String& text);
+  void writeAt(uint8_t col, uint8_t row, const char* text);   // sin limpiar la línea
   void centerPrint(uint8_t row, const String& text);
   void splash(const String& line1, const String& line2, unsigned long ms = 1500);
 
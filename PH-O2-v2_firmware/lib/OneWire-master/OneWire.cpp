@@ -147,6 +147,11 @@ sample code bearing this copyright.
 #include <Arduino.h>
 #include "OneWire.h"
 #include "util/OneWire_direct_gpio.h"
+#if defined(ONEWIRE_UART_NUM)
+#include <driver/uart.h>
+#include <driver/gpio.h>
+#include "util/OneWire_uart_codec.h"
+#endif
 
 #ifdef ARDUINO_ARCH_ESP32
 // due to the dual core esp32, a critical section works better than disabling interrupts
@@ -159,6 +164,152 @@ sample code bearing this copyright.
 #endif
 
 
+#if defined(ONEWIRE_UART_NUM)
+//
+// UART transport (see util/OneWire_uart_codec.h): same API, the UART
+// generates every slot. Build with -D ONEWIRE_UART_NUM=<1|2> and keep the
+// external pull-up on the bus. Parasite power ("power" = 1) is not
+// available: the pin is open-drain and cannot drive a strong pull-up.
+//
+#if !defined(ARDUINO_ARCH_ESP32)
+#error "ONEWIRE_UART_NUM requires an ESP32"
+#endif
+
+#define OW_UART_PORT ((uart_port_t)(ONEWIRE_UART_NUM))
+#define OW_UART_CHUNK 16	// bytes per transfer: 128 slots = one UART FIFO
+
+// The UART is configured on first use: OneWire objects are usually
+// globals, constructed before the RTOS and drivers are up.
+void OneWire::begin(uint8_t pin)
+{
+	uartPin = pin;
+	uartReady = false;
+#if ONEWIRE_SEARCH
+	reset_search();
+#endif
+}
+
+bool OneWire::uartInit()
+{
+	const uint8_t pin = uartPin;
+	uart_config_t cfg = {};
+	cfg.baud_rate = OneWireUart::SLOT_BAUD;
+	cfg.data_bits = UART_DATA_8_BITS;
+	cfg.parity    = UART_PARITY_DISABLE;
+	cfg.stop_bits = UART_STOP_BITS_1;
+	cfg.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+	cfg.source_clk = UART_SCLK_APB;
+
+	if (uart_driver_install(OW_UART_PORT, 256, 0, 0, NULL, 0) != ESP_OK) return false;
+	if (uart_param_config(OW_UART_PORT, &cfg) != ESP_OK) return false;
+	if (uart_set_pin(OW_UART_PORT, pin, pin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) return false;
+	// TX and RX share the pin: open-drain output plus input, so the echo
+	// is the real bus level (uart_set_pin left it input-only)
+	gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT_OUTPUT_OD);
+	gpio_set_pull_mode((gpio_num_t)pin, GPIO_PULLUP_ONLY);
+	uartReady = true;
+	return true;
+}
+
+// Send n slot characters and collect their echoes
+bool OneWire::uartTouch(const uint8_t *tx, uint8_t *rx, uint16_t n)
+{
+	if (!uartReady && !uartInit()) return false;
+	uart_flush_input(OW_UART_PORT);
+	uart_write_bytes(OW_UART_PORT, (const char *)tx, n);
+	// 87 us per slot character, 1.04 ms for the reset character
+	return uart_read_bytes(OW_UART_PORT, rx, n, pdMS_TO_TICKS(2 + n / 8)) == (int)n;
+}
+
+uint8_t OneWire::reset(void)
+{
+	uint8_t tx = OneWireUart::RESET_TX, rx = 0;
+	if (!uartReady && !uartInit()) return 0;
+	// the 10-bit character at 9600 bps (1.04 ms) already covers the
+	// 480 us reset low time and the 480 us presence window
+	uart_set_baudrate(OW_UART_PORT, OneWireUart::RESET_BAUD);
+	bool ok = uartTouch(&tx, &rx, 1);
+	uart_set_baudrate(OW_UART_PORT, OneWireUart::SLOT_BAUD);
+	return ok && OneWireUart::decodeReset(rx) == OneWireUart::PRESENCE_OK;
+}
+
+void OneWire::write_bit(uint8_t v)
+{
+	uint8_t tx = OneWireUart::encodeSlot(v), rx;
+	uartTouch(&tx, &rx, 1);
+}
+
+uint8_t OneWire::read_bit(void)
+{
+	uint8_t tx = OneWireUart::SLOT_1, rx = 0;
+	if (!uartTouch(&tx, &rx, 1)) return 1;	// idle bus reads as 1
+	return OneWireUart::decodeSlot(rx);
+}
+
+void OneWire::write(uint8_t v, uint8_t power /* = 0 */) {
+	uint8_t tx[8], rx[8];
+	(void)power;
+	OneWireUart::encodeByte(v, tx);
+	uartTouch(tx, rx, 8);
+}
+
+void OneWire::write_bytes(const uint8_t *buf, uint16_t count, bool power /* = 0 */) {
+	uint8_t tx[OW_UART_CHUNK * 8], rx[OW_UART_CHUNK * 8];
+	(void)power;
+	while (count) {
+		const uint16_t n = count < OW_UART_CHUNK ? count : OW_UART_CHUNK;
+		for (uint16_t i = 0; i < n; i++) OneWireUart::encodeByte(buf[i], tx + 8 * i);
+		uartTouch(tx, rx, n * 8);
+		buf += n;
+		count -= n;
+	}
+}
+
+uint8_t OneWire::read() {
+	uint8_t tx[8], rx[8];
+	OneWireUart::encodeByte(0xFF, tx);
+	if (!uartTouch(tx, rx, 8)) return 0xFF;
+	return OneWireUart::decodeByte(rx);
+}
+
+void OneWire::read_bytes(uint8_t *buf, uint16_t count) {
+	uint8_t tx[OW_UART_CHUNK * 8], rx[OW_UART_CHUNK * 8];
+	while (count) {
+		const uint16_t n = count < OW_UART_CHUNK ? count : OW_UART_CHUNK;
+		OneWireUart::encodeByte(0xFF, tx);
+		for (uint16_t i = 1; i < n; i++) memcpy(tx + 8 * i, tx, 8);
+		if (!uartTouch(tx, rx, n * 8)) memset(rx, 0xFF, n * 8);
+		for (uint16_t i = 0; i < n; i++) buf[i] = OneWireUart::decodeByte(rx + 8 * i);
+		buf += n;
+		count -= n;
+	}
+}
+
+//
+// Do a ROM select
+//
+void OneWire::select(const uint8_t rom[8])
+{
+	uint8_t cmd[9] = { 0x55 };	// Choose ROM + address in one transfer
+	for (uint8_t i = 0; i < 8; i++) cmd[i + 1] = rom[i];
+	write_bytes(cmd, 9);
+}
+
+//
+// Do a ROM skip
+//
+void OneWire::skip()
+{
+    write(0xCC);           // Skip ROM
+}
+
+void OneWire::depower()
+{
+	// open-drain: the pull-up already holds the bus high when idle
+}
+
+#else // GPIO bit-banging
+
 void OneWire::begin(uint8_t pin)
 {
 	pinMode(pin, INPUT);
@@ -333,6 +484,8 @@ void OneWire::depower()
 	interrupts();
 }
 
+#endif // ONEWIRE_UART_NUM
+
 #if ONEWIRE_SEARCH
 
 //
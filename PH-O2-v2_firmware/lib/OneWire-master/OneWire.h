@@ -60,6 +60,14 @@ class OneWire
     IO_REG_TYPE bitmask;
     volatile IO_REG_TYPE *baseReg;
 
+#if defined(ONEWIRE_UART_NUM)
+    // UART transport (util/OneWire_uart_codec.h)
+    uint8_t uartPin = 0;
+    bool uartReady = false;
+    bool uartInit();
+    bool uartTouch(const uint8_t *tx, uint8_t *rx, uint16_t n);
+#endif
+
 #if ONEWIRE_SEARCH
     // global search state
     unsigned char ROM_NO[8];
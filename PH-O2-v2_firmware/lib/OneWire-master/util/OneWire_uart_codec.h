@@ -0,0 +1,83 @@
+#ifndef OneWire_uart_codec_h
+#define OneWire_uart_codec_h
+
+// 1-Wire over a UART ("UART-as-1-Wire"): TX and RX on the same open-drain
+// pin with the usual bus pull-up. Every 1-Wire time slot is one UART
+// character, so the UART peripheral generates all timing and no
+// noInterrupts() window is needed.
+//
+//   reset  @ 9600 bps   : send 0xF0 -> ~520 us low (start + 4 zero bits),
+//                          then released; a presence pulse pulls some of
+//                          the high nibble low in the echo.
+//   slot   @ 115200 bps : one character per bit, LSB first on the wire
+//                          write 1 / read : send 0xFF -> 8.7 us low (start)
+//                          write 0        : send 0x00 -> 78 us low
+//
+// The echo of a read slot is decoded from data bit 0, sampled by the
+// UART at 1.5 bit times = 13 us after the falling edge, inside the 15 us
+// window in which a slave answering 0 must hold the bus low.
+//
+// Limits of the scheme (Maxim AN214): at 9600 bps the presence pulse is
+// sampled every 104 us, so a device at both datasheet corners (tPDH =
+// 60 us and tPDL = 60 us) is missed; a read 1 needs the bus above VIH
+// (0.75 VDD on the ESP32) 4.3 us after release, so the pull-up RC must
+// stay below ~3 us (<= ~0.7 nF with 4k7). bench/onewire_uart_wave_test.cpp
+// checks both limits on simulated waveforms.
+//
+// This header is Arduino-free so the encoding can be checked on a host
+// against sampled waveforms.
+
+#include <stdint.h>
+
+namespace OneWireUart {
+
+static const uint32_t RESET_BAUD = 9600;
+static const uint32_t SLOT_BAUD  = 115200;
+
+static const uint8_t RESET_TX = 0xF0;
+static const uint8_t SLOT_1   = 0xFF;   // write 1, or read slot
+static const uint8_t SLOT_0   = 0x00;   // write 0
+
+enum Presence : uint8_t {
+	PRESENCE_NONE    = 0,   // echo == 0xF0: nobody answered
+	PRESENCE_OK      = 1,   // some device pulled the bus low
+	PRESENCE_SHORTED = 2    // bus held low the whole frame (short to GND)
+};
+
+// Echo of a reset character
+inline Presence decodeReset(uint8_t echo)
+{
+	if (echo == 0x00) return PRESENCE_SHORTED;
+	// the master holds the low nibble at 0; anything else is noise
+	if ((echo & 0x0F) != 0) return PRESENCE_NONE;
+	return (echo == RESET_TX) ? PRESENCE_NONE : PRESENCE_OK;
+}
+
+// Echo of one slot -> bit value
+inline uint8_t decodeSlot(uint8_t echo)
+{
+	return echo & 0x01;
+}
+
+inline uint8_t encodeSlot(uint8_t bit)
+{
+	return (bit & 1) ? SLOT_1 : SLOT_0;
+}
+
+// One data byte -> 8 slot characters (1-Wire is LSB first)
+inline void encodeByte(uint8_t v, uint8_t *slots)
+{
+	for (uint8_t i = 0; i < 8; i++) slots[i] = encodeSlot(v >> i);
+}
+
+// 8 slot echoes -> data byte (read slots are sent as encodeByte(0xFF))
+inline uint8_t decodeByte(const uint8_t *echo)
+{
+	uint8_t v = 0;
+	for (uint8_t i = 0; i < 8; i++) v |= (uint8_t)(decodeSlot(echo[i]) << i);
+	return v;
+}
+
+} // namespace OneWireUart
+
+#endif // OneWire_uart_codec_h
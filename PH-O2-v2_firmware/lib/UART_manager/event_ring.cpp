@@ -0,0 +1,27 @@
+#include "event_ring.h"
+
+static const char* const EV_NAME[(uint8_t)UartEvType::COUNT] = {
+  "step", "sample", "level", "auto", "error"
+};
+
+const char* uartEvName(UartEvType t) {
+  return (uint8_t)t < (uint8_t)UartEvType::COUNT ? EV_NAME[(uint8_t)t] : "?";
+}
+
+uint32_t EventRing::push(UartEvent& e) {
+  e.seq = next_++;
+  if (count_ < CAP) {
+    buf_[(head_ + count_) % CAP] = e;
+    count_++;
+  } else {
+    buf_[head_] = e;
+    head_ = (uint8_t)((head_ + 1) % CAP);
+  }
+  return e.seq;
+}
+
+const UartEvent* EventRing::find(uint32_t seq) const {
+  const uint32_t off = seq - oldestSeq();   // sin signo: fuera de rango si es más viejo
+  if (off >= count_) return nullptr;
+  return &buf_[(head_ + off) % CAP];
+}
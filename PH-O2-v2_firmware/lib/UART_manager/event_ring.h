@@ -0,0 +1,67 @@
+#ifndef EVENT_RING_H
+#define EVENT_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =====================================================
+// Historial de eventos del modo streaming ("subscribe")
+//  - push() numera cada evento con seq creciente (1, 2, 3...) y lo guarda;
+//    lleno, pisa el más viejo
+//  - find(seq) sirve a "resend": el maestro pide desde el último seq que
+//    vio y se le reenvía lo que todavía esté en el historial
+//  - Sin heap y sin dependencias de Arduino (se prueba en host)
+// =====================================================
+
+enum class UartEvType : uint8_t {
+  STEP = 0,   // paso de la receta AUTO terminado
+  SAMPLE,     // resultado pH/O2 de una muestra
+  LEVEL,      // flanco de un sensor de nivel
+  AUTO,       // inicio / fin / aborto del ciclo AUTO
+  ERROR,      // fallo (corte de seguridad, paso abortado, eventos perdidos)
+  COUNT
+};
+
+// Campos genéricos según el tipo (POD: viaja por cola de FreeRTOS)
+//   STEP   : a = muestra 1..4, b = paso, c = RecipeOp, d = act/hook,
+//            u = total ms, text = "ok" | "timeout" | "fail"
+//   SAMPLE : a = muestra 1..4, f1 = pH, f2 = O2 (NaN = sin dato)
+//   LEVEL  : b = 1 activo, text = sensor ("o2", "ph", "kcl", "h2o")
+//   AUTO   : a = muestra 1..4, b = total, text = "start" | "done" | "abort" | "cancel"
+//   ERROR  : b = paso (0xFF = n/a), u = detalle, text = código
+struct UartEvent {
+  uint32_t   seq;    // lo asigna EventRing::push
+  uint32_t   ms;     // instante del hecho (ms desde el arranque)
+  UartEvType type;
+  uint8_t    a, b, c, d;
+  uint32_t   u;
+  float      f1, f2;
+  char       text[16];
+};
+
+const char* uartEvName(UartEvType t);   // "step", "sample", ...
+
+class EventRing {
+public:
+  static constexpr uint8_t CAP = 32;
+
+  // Asigna e.seq y guarda una copia; retorna el seq asignado
+  uint32_t push(UartEvent& e);
+
+  // nullptr si seq ya salió del historial o todavía no existe
+  const UartEvent* find(uint32_t seq) const;
+
+  uint32_t nextSeq() const { return next_; }                       // el del próximo evento
+  uint32_t oldestSeq() const { return next_ - count_; }            // == nextSeq() si está vacío
+  uint8_t  size() const { return count_; }
+
+  void     reset() { head_ = 0; count_ = 0; next_ = 1; }
+
+private:
+  UartEvent buf_[CAP];
+  uint8_t   head_ = 0;    // posición del más viejo
+  uint8_t   count_ = 0;
+  uint32_t  next_ = 1;    // seq 0 = ninguno
+};
+
+#endif // EVENT_RING_H
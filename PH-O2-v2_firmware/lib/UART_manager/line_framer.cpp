@@ -0,0 +1,22 @@
+#include "line_framer.h"
+
+LineFramer::Status LineFramer::push(char c) {
+  if (c == '\n') {
+    const bool dropped = dropping_;
+    dropping_ = false;
+    lineLen_ = len_;
+    len_ = 0;
+    if (dropped || lineLen_ == 0) return Status::NONE;
+    buf_[lineLen_] = '\0';
+    return Status::LINE;
+  }
+  if (c == '\r' || dropping_) return Status::NONE;
+
+  if (len_ >= MAX_LINE) {
+    dropping_ = true;
+    len_ = 0;
+    return Status::OVERFLOW;
+  }
+  buf_[len_++] = c;
+  return Status::NONE;
+}
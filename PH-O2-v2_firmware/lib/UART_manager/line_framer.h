@@ -0,0 +1,38 @@
+#ifndef LINE_FRAMER_H
+#define LINE_FRAMER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =====================================================
+// Armado de líneas NDJSON en un buffer fijo
+//  - Un byte por push(); al llegar '\n' la línea queda terminada en '\0'
+//    dentro del mismo buffer (se parsea en sitio, sin copias)
+//  - '\r' se ignora; las líneas vacías no se entregan
+//  - Línea más larga que MAX_LINE: OVERFLOW una vez y se descarta hasta
+//    el próximo '\n' (el resto no se interpreta como otro comando)
+//  - Sin heap y sin dependencias de Arduino (se prueba en host)
+// =====================================================
+
+class LineFramer {
+public:
+  static constexpr size_t MAX_LINE = 1024;
+
+  enum class Status : uint8_t { NONE, LINE, OVERFLOW };
+
+  Status push(char c);
+
+  // Válidos tras LINE hasta el próximo push()
+  char*  line() { return buf_; }
+  size_t length() const { return lineLen_; }
+
+  void   reset() { len_ = 0; lineLen_ = 0; dropping_ = false; }
+
+private:
+  char   buf_[MAX_LINE + 1];
+  size_t len_ = 0;
+  size_t lineLen_ = 0;
+  bool   dropping_ = false;
+};
+
+#endif // LINE_FRAMER_H
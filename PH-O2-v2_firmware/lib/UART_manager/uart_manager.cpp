@@ -1,72 +1,241 @@
 #include "uart_manager.h"
-#include "globals.h"   // remoteManager
+#include "log_manager.h"
+#include <esp_timer.h>
+
+// Traza por comando (RX, OP, TX) en LOG_D: fuera del binario salvo con
+// -D LOG_LVL_MAX=4, y aun así apagada hasta "set_log" uart debug.
+// Los rechazos van en LOG_W y los errores de trama en LOG_E.
 
 namespace UartProto {
 
 UARTManager::UARTManager(Stream& inOut) : io_(inOut) {
-  remoteManager.log("[UART] Manager creado");
+  LOG_D(LogMod::UART, "[UART] Manager creado");
 }
 
 void UARTManager::begin(unsigned long baud) {
   (void)baud; // El SerialX.begin(...) lo hace el usuario
-  remoteManager.log("[UART] begin() llamado (recuerda inicializar SerialX)");
+  if (!cmdQ_)    cmdQ_    = xQueueCreate(4, sizeof(UartCommand));
+  if (!resQ_)    resQ_    = xQueueCreate(16, sizeof(Result));
+  if (!recipeQ_) recipeQ_ = xQueueCreate(1, sizeof(Recipe));
+  if (!evQ_)     evQ_     = xQueueCreate(16, sizeof(UartEvent));
+  if (!flags_)   flags_   = xEventGroupCreate();
+  if (!rxSem_)   rxSem_   = xSemaphoreCreateBinary();
+  if (!cmdQ_ || !resQ_ || !recipeQ_ || !evQ_ || !flags_ || !rxSem_)
+    LOG_E(LogMod::UART, "[UART] ERROR: sin memoria para colas");
+  LOG_I(LogMod::UART, "[UART] begin() llamado (recuerda inicializar SerialX)");
 }
 
+// Lee en bloques hacia el LineFramer; cada línea se procesa en su buffer
 void UARTManager::loop() {
-  while (io_.available()) {
-    char c = (char)io_.read();
-    if (c == '\n') {
-      String line = lineBuf_;
-      lineBuf_ = "";
-      if (line.length() > 0) {
-        remoteManager.log(String("[UART] RX: ") + line);
-        processLine_(line);
-      }
-    } else if (c != '\r') {
-      lineBuf_ += c;
-      if (lineBuf_.length() > 1024) {
-        lineBuf_.clear();
-        remoteManager.log("[UART] ERROR: BAD_ARGS (línea demasiado larga)");
+  drainResults_();
+  drainEvents_();
+  char chunk[64];
+  int avail;
+  while ((avail = io_.available()) > 0) {
+    const size_t n = io_.readBytes(chunk, avail < (int)sizeof(chunk) ? (size_t)avail : sizeof(chunk));
+    for (size_t i = 0; i < n; ++i) {
+      const LineFramer::Status st = framer_.push(chunk[i]);
+      if (st == LineFramer::Status::LINE) {
+        LOG_D(LogMod::UART, "[UART] RX: %s", framer_.line());
+        drainResults_();   // lo que llegó mientras se leía la línea
+        processLine_(framer_.line());
+      } else if (st == LineFramer::Status::OVERFLOW) {
+        LOG_E(LogMod::UART, "[UART] ERROR: BAD_ARGS (línea demasiado larga)");
         sendError_("BAD_ARGS");
       }
     }
   }
 }
 
-// ====== Setters ======
-void UARTManager::setLevelH2O(bool v)              { lock(); levelH2O_ok_ = v;            unlock(); }
-void UARTManager::setLevelKCL(bool v)              { lock(); levelKCL_ok_ = v;            unlock(); }
-void UARTManager::setAutoRunning(bool v)           { lock(); auto_running_ = v;           unlock(); }
-void UARTManager::setAutoMeasureRequested(bool v)  { lock(); autoMeasureRequested_ = v;   unlock(); }
+// ====== Despertar por RX ======
+// Corre en la tarea de eventos del driver UART (no en ISR)
+void UARTManager::notifyRx() {
+  rxUs_ = (uint32_t)esp_timer_get_time();
+  if (rxSem_) xSemaphoreGive(rxSem_);
+}
+
+bool UARTManager::waitRx(TickType_t wait) {
+  if (!rxSem_) { vTaskDelay(wait); return false; }
+  return xSemaphoreTake(rxSem_, wait) == pdTRUE;
+}
+
+// ====== Comandos ======
+bool UARTManager::nextCommand(UartCommand& c, TickType_t wait) {
+  if (!cmdQ_) { vTaskDelay(wait); return false; }
+  return xQueueReceive(cmdQ_, &c, wait) == pdTRUE;
+}
+
+// ====== Resultados: cola hacia la tarea del puerto ======
+void UARTManager::post_(const Result& r) {
+  if (!resQ_) { apply_(r); return; }   // antes de begin(): un solo contexto
+  if (xQueueSend(resQ_, &r, 0) != pdTRUE) resDropped_++;
+}
+
+void UARTManager::apply_(const Result& r) {
+  switch (r.kind) {
+    case ResKind::PH:        last_ph_ = r.v;    last_has_data_ = true; break;
+    case ResKind::TEMP:      last_tempC_ = r.v; last_has_data_ = true; break;
+    case ResKind::TEXT:      memcpy(last_result_, r.text, RESULT_LEN); last_has_data_ = true; break;
+    case ResKind::HAS_DATA:  last_has_data_ = r.v != 0.0f; break;
+    case ResKind::SAMPLE_PH: sample_ph_val_[r.idx] = r.v; break;
+    case ResKind::SAMPLE_O2: sample_o2_val_[r.idx] = r.v; break;
+    case ResKind::H2O:       levelH2O_ok_ = r.v != 0.0f; break;
+    case ResKind::KCL:       levelKCL_ok_ = r.v != 0.0f; break;
+  }
+}
+
+void UARTManager::drainResults_() {
+  if (!resQ_) return;
+  Result r;
+  while (xQueueReceive(resQ_, &r, 0) == pdTRUE) apply_(r);
+}
+
+// ====== Eventos: cola hacia la tarea del puerto ======
+static uint32_t nowMs_() { return (uint32_t)(esp_timer_get_time() / 1000); }
+
+static const char* outcomeName_(RecipeOutcome o) {
+  switch (o) {
+    case RecipeOutcome::OK:      return "ok";
+    case RecipeOutcome::TIMEOUT: return "timeout";
+    default:                     return "fail";
+  }
+}
+
+void UARTManager::emit_(UartEvent& e) {
+  if (!evQ_) { record_(e); return; }   // antes de begin(): un solo contexto
+  if (xQueueSend(evQ_, &e, 0) != pdTRUE) { evDropped_++; return; }
+  if (rxSem_) xSemaphoreGive(rxSem_);  // sale ya, sin esperar al próximo RX
+}
+
+// Numera, guarda en el historial y, con suscripción, lo empuja
+void UARTManager::record_(UartEvent& e) {
+  events_.push(e);
+  if (subscribed_) sendEvent_(e);
+}
+
+void UARTManager::drainEvents_() {
+  if (!evQ_) return;
+  UartEvent e;
+  while (xQueueReceive(evQ_, &e, 0) == pdTRUE) record_(e);
+
+  // Cola llena: lo perdido no tiene seq, se avisa con un evento propio
+  const uint32_t lost = evDropped_ - evLost_;
+  if (!lost) return;
+  evLost_ += lost;
+  UartEvent x = {};
+  x.type = UartEvType::ERROR;
+  x.ms   = nowMs_();
+  x.b    = 0xFF;
+  x.u    = lost;
+  strlcpy(x.text, "EV_LOST", sizeof(x.text));
+  record_(x);
+  LOG_W(LogMod::UART, "[UART] %lu eventos perdidos (cola llena)", (unsigned long)lost);
+}
+
+void UARTManager::emitStep(uint8_t sample, const RecipeStepReport& r) {
+  UartEvent e = {};
+  e.type = UartEvType::STEP;
+  e.ms   = nowMs_();
+  e.a    = sample;
+  e.b    = r.index;
+  e.c    = (uint8_t)r.op;
+  e.d    = r.act;
+  e.u    = r.totalMs;
+  strlcpy(e.text, outcomeName_(r.outcome), sizeof(e.text));
+  emit_(e);
+}
+
+void UARTManager::emitSample(uint8_t id, float ph, float o2) {
+  UartEvent e = {};
+  e.type = UartEvType::SAMPLE;
+  e.ms   = nowMs_();
+  e.a    = id;
+  e.f1   = ph;
+  e.f2   = o2;
+  emit_(e);
+}
+
+void UARTManager::emitLevel(const char* sensor, bool active, uint32_t ms) {
+  UartEvent e = {};
+  e.type = UartEvType::LEVEL;
+  e.ms   = ms;
+  e.b    = active ? 1 : 0;
+  strlcpy(e.text, sensor, sizeof(e.text));
+  emit_(e);
+}
+
+void UARTManager::emitAuto(const char* state, uint8_t sample, uint8_t total) {
+  UartEvent e = {};
+  e.type = UartEvType::AUTO;
+  e.ms   = nowMs_();
+  e.a    = sample;
+  e.b    = total;
+  strlcpy(e.text, state, sizeof(e.text));
+  emit_(e);
+}
+
+void UARTManager::emitError(const char* code, uint8_t step, uint32_t detail) {
+  UartEvent e = {};
+  e.type = UartEvType::ERROR;
+  e.ms   = nowMs_();
+  e.b    = step;
+  e.u    = detail;
+  strlcpy(e.text, code, sizeof(e.text));
+  emit_(e);
+}
 
-void UARTManager::setLastPh(float v)               { lock(); last_ph_ = v;  last_has_data_ = true; unlock(); }
-void UARTManager::setLastTempC(float v)            { lock(); last_tempC_ = v; last_has_data_ = true; unlock(); }
-void UARTManager::setLastResult(const String& r)   { lock(); last_result_ = r; last_has_data_ = true; unlock(); }
-void UARTManager::setLastHasData(bool v)           { lock(); last_has_data_ = v; unlock(); }
+// ====== Bits de estado ======
+void UARTManager::setFlag_(EventBits_t bit, bool v) {
+  if (!flags_) return;
+  if (v) xEventGroupSetBits(flags_, bit);
+  else   xEventGroupClearBits(flags_, bit);
+}
+
+bool UARTManager::flag_(EventBits_t bit) const {
+  return flags_ && (xEventGroupGetBits(flags_) & bit);
+}
+
+// ====== Setters ======
+void UARTManager::setLevelH2O(bool v)              { post_({ResKind::H2O, 0, v ? 1.0f : 0.0f, {}}); }
+void UARTManager::setLevelKCL(bool v)              { post_({ResKind::KCL, 0, v ? 1.0f : 0.0f, {}}); }
+void UARTManager::setAutoRunning(bool v)           { setFlag_(EV_AUTO_RUNNING, v); }
+void UARTManager::setAutoMeasureRequested(bool v)  { setFlag_(EV_AUTO_REQ, v); }
+
+void UARTManager::setLastPh(float v)               { post_({ResKind::PH, 0, v, {}}); }
+void UARTManager::setLastTempC(float v)            { post_({ResKind::TEMP, 0, v, {}}); }
+void UARTManager::setLastHasData(bool v)           { post_({ResKind::HAS_DATA, 0, v ? 1.0f : 0.0f, {}}); }
+void UARTManager::setLastResult(const String& r) {
+  Result m = {ResKind::TEXT, 0, 0.0f, {}};
+  strlcpy(m.text, r.c_str(), sizeof(m.text));
+  post_(m);
+}
 
 // Setters por SAMPLE (por id 1..4)
 void UARTManager::setSamplePhValueById(uint8_t id, float v) {
   uint8_t idx = idToIndex_(id);
   if (idx == 255) return;
-  lock(); sample_ph_val_[idx] = v; unlock();
+  post_({ResKind::SAMPLE_PH, idx, v, {}});
 }
 void UARTManager::setSampleO2ValueById(uint8_t id, float v) {
   uint8_t idx = idToIndex_(id);
   if (idx == 255) return;
-  lock(); sample_o2_val_[idx] = v; unlock();
+  post_({ResKind::SAMPLE_O2, idx, v, {}});
 }
 
 // ====== Getters ======
 bool   UARTManager::getLevelH2O() const            { return levelH2O_ok_; }
 bool   UARTManager::getLevelKCL() const            { return levelKCL_ok_; }
-bool   UARTManager::getAutoRunning() const         { return auto_running_; }
-bool   UARTManager::getAutoMeasureRequested() const{ return autoMeasureRequested_; }
+bool   UARTManager::getAutoRunning() const         { return flag_(EV_AUTO_RUNNING); }
+bool   UARTManager::getAutoMeasureRequested() const{ return flag_(EV_AUTO_REQ); }
 
 float  UARTManager::getLastPh() const              { return last_ph_; }
 float  UARTManager::getLastTempC() const           { return last_tempC_; }
 String UARTManager::getLastResult() const          { return last_result_; }
 bool   UARTManager::getLastHasData() const         { return last_has_data_; }
 
+void       UARTManager::setWireFormat(WireFormat f)  { fmt_ = f; }
+WireFormat UARTManager::getWireFormat() const        { return fmt_; }
+
 // Getters por SAMPLE (por id 1..4)
 float UARTManager::getSamplePhValueById(uint8_t id) const {
   uint8_t idx = idToIndex_(id);
@@ -80,165 +249,412 @@ float UARTManager::getSampleO2ValueById(uint8_t id) const {
 }
 
 // ================== Procesamiento NDJSON ==================
-void UARTManager::processLine_(const String& lineRaw) {
-  String line = lineRaw;
-  line.trim();
-  int i = line.indexOf('{');
-  if (i > 0) line.remove(0, i);
-  if (line.isEmpty() || line[0] != '{') {
-    remoteManager.log("[UART] DESCARTE: línea sin JSON válido");
+// La línea es del LineFramer: se parsea en sitio (char* = modo zero-copy,
+// los strings del documento apuntan a ella) y solo vive durante el comando
+void UARTManager::processLine_(char* line) {
+  line = strchr(line, '{');   // basura antes del JSON (p.ej. eco o ruido)
+  if (!line) {
+    LOG_W(LogMod::UART, "[UART] DESCARTE: línea sin JSON válido");
     sendError_("BAD_JSON");
     return;
   }
 
-  StaticJsonDocument<256> in;
-  DeserializationError err = deserializeJson(in, line);
+  DeserializationError err = deserializeJson(in_, line);
   if (err) {
-    remoteManager.log(String("[UART] ERROR: BAD_JSON (") + err.c_str() + ")");
+    LOG_E(LogMod::UART, "[UART] ERROR: BAD_JSON (%s)", err.c_str());
     sendError_("BAD_JSON");
     return;
   }
 
-  const char* op = in["op"] | "";
-  JsonObject dataIn = in["data"].isNull() ? JsonObject() : in["data"].as<JsonObject>();
-
-  if      (!strcmp(op, "get_status"))   { remoteManager.log("[UART] OP: get_status");  handle_get_status_(); }
-  else if (!strcmp(op, "get_last"))     { remoteManager.log("[UART] OP: get_last");    handle_get_last_(); }
-  else if (!strcmp(op, "auto_measure")) { remoteManager.log("[UART] OP: auto_measure");handle_auto_measure_(dataIn); }
+  const char* op = in_["op"] | "";
+  JsonObject dataIn = in_["data"].isNull() ? JsonObject() : in_["data"].as<JsonObject>();
+
+  LOG_D(LogMod::UART, "[UART] OP: %s", op);
+  if      (!strcmp(op, "get_status"))   handle_get_status_();
+  else if (!strcmp(op, "get_last"))     handle_get_last_();
+  else if (!strcmp(op, "auto_measure")) handle_auto_measure_(dataIn);
+  else if (!strcmp(op, "set_format"))   handle_set_format_(dataIn);
+  else if (!strcmp(op, "set_recipe"))   handle_set_recipe_(dataIn);
+  else if (!strcmp(op, "set_log"))      handle_set_log_(dataIn);
+  else if (!strcmp(op, "subscribe"))    handle_subscribe_();
+  else if (!strcmp(op, "unsubscribe"))  handle_unsubscribe_();
+  else if (!strcmp(op, "resend"))       handle_resend_(dataIn);
   else {
-    remoteManager.log(String("[UART] ERROR: BAD_OP (") + op + ")");
+    LOG_W(LogMod::UART, "[UART] ERROR: BAD_OP (%s)", op);
     sendError_("BAD_OP");
   }
 }
 
 // Helper: inyecta arreglo "samples" con {id, ph_val, o2_val}
 void UARTManager::addSamplesArray_(JsonObject parent) {
-  JsonArray arr = parent.createNestedArray("samples");
+  JsonArray arr = parent.createNestedArray(k_(UK_SAMPLES));
   for (uint8_t i = 0; i < 4; ++i) {
-    float phv, o2v;
-    lock(); 
-      phv = sample_ph_val_[i]; 
-      o2v = sample_o2_val_[i];
-    unlock();
+    const float phv = sample_ph_val_[i];
+    const float o2v = sample_o2_val_[i];
 
     JsonObject it = arr.createNestedObject();
-    it["id"]      = (uint8_t)(i + 1);
+    it[k_(UK_ID)]      = (uint8_t)(i + 1);
     // Escribir null si no hay valor (NaN)
-    if (isfinite(phv)) it["ph_val"] = phv; else it["ph_val"] = nullptr;
-    if (isfinite(o2v)) it["o2_val"] = o2v; else it["o2_val"] = nullptr;
+    if (isfinite(phv)) it[k_(UK_PH_VAL)] = phv; else it[k_(UK_PH_VAL)] = nullptr;
+    if (isfinite(o2v)) it[k_(UK_O2_VAL)] = o2v; else it[k_(UK_O2_VAL)] = nullptr;
   }
 }
 
 // --- get_status ---
 void UARTManager::handle_get_status_() {
-  bool h2o, kcl, run, areq;
-  lock();
-  h2o  = levelH2O_ok_;
-  kcl  = levelKCL_ok_;
-  run  = auto_running_;
-  areq = autoMeasureRequested_;
-  unlock();
+  const bool h2o  = levelH2O_ok_;
+  const bool kcl  = levelKCL_ok_;
+  const bool run  = getAutoRunning();
+  const bool areq = getAutoMeasureRequested();
 
   StaticJsonDocument<512> out;
-  out["ok"] = true;
-  JsonObject data = out.createNestedObject("data");
+  out[k_(UK_OK)] = true;
+  JsonObject data = out.createNestedObject(k_(UK_DATA));
 
-  JsonObject js = data.createNestedObject("level_sensors");
-  js["h2o"] = h2o;
-  js["kcl"] = kcl;
+  JsonObject js = data.createNestedObject(k_(UK_LEVEL_SENSORS));
+  js[k_(UK_H2O)] = h2o;
+  js[k_(UK_KCL)] = kcl;
 
-  data["auto_running"] = run;
-  data["auto_req"]     = areq;
+  data[k_(UK_AUTO_RUNNING)] = run;
+  data[k_(UK_AUTO_REQ)] = areq;
 
   // [{id, ph_val, o2_val} x4]
   addSamplesArray_(data);
 
   sendJson_(out);
 
-  remoteManager.log(String("[UART] TX get_status -> h2o=") + (h2o?"1":"0") +
-                    " kcl=" + (kcl?"1":"0") +
-                    " auto_running=" + (run?"1":"0") +
-                    " auto_req=" + (areq?"1":"0"));
+  LOG_D(LogMod::UART, "[UART] TX get_status -> h2o=%d kcl=%d auto_running=%d auto_req=%d",
+        h2o, kcl, run, areq);
 }
 
 // --- get_last ---
 void UARTManager::handle_get_last_() {
-  bool has;
-  float ph, tc;
-  String res;
-  bool h2o, kcl;
-
-  lock();
-  has = last_has_data_;
-  ph  = last_ph_;
-  tc  = last_tempC_;
-  res = last_result_;
-  h2o = levelH2O_ok_;
-  kcl = levelKCL_ok_;
-  unlock();
+  const bool   has = last_has_data_;
+  const float  ph  = last_ph_;
+  const float  tc  = last_tempC_;
+  const char*  res = last_result_;   // el documento guarda el puntero
+  const bool   h2o = levelH2O_ok_;
+  const bool   kcl = levelKCL_ok_;
 
   if (!has) {
-    remoteManager.log("[UART] TX get_last -> NO_DATA");
+    LOG_D(LogMod::UART, "[UART] TX get_last -> NO_DATA");
     sendError_("NO_DATA");
     return;
   }
 
   StaticJsonDocument<576> out;
-  out["ok"] = true;
-  JsonObject data = out.createNestedObject("data");
-  data["ph"]    = ph;
-  data["tempC"] = tc;
+  out[k_(UK_OK)] = true;
+  JsonObject data = out.createNestedObject(k_(UK_DATA));
+  data[k_(UK_PH)] = ph;
+  data[k_(UK_TEMPC)] = tc;
 
-  JsonObject js = data.createNestedObject("level_sensors");
-  js["h2o"] = h2o;
-  js["kcl"] = kcl;
+  JsonObject js = data.createNestedObject(k_(UK_LEVEL_SENSORS));
+  js[k_(UK_H2O)] = h2o;
+  js[k_(UK_KCL)] = kcl;
 
   // [{id, ph_val, o2_val} x4]
   addSamplesArray_(data);
 
-  data["result"] = res;
+  data[k_(UK_RESULT)] = res;
   sendJson_(out);
 
-  remoteManager.log(String("[UART] TX get_last -> ph=") + ph +
-                    " tempC=" + tc +
-                    " h2o=" + (h2o?"1":"0") +
-                    " kcl=" + (kcl?"1":"0") +
-                    " result=" + res);
+  LOG_D(LogMod::UART, "[UART] TX get_last -> ph=%.2f tempC=%.2f h2o=%d kcl=%d result=%s",
+        ph, tc, h2o, kcl, res);
 }
 
 // --- auto_measure ---
 void UARTManager::handle_auto_measure_(JsonObject) {
   if (getAutoRunning()) {
-    remoteManager.log("[UART] auto_measure rechazado -> BUSY");
+    LOG_D(LogMod::UART, "[UART] auto_measure rechazado -> BUSY");
     sendError_("BUSY");
     return;
   }
 
+  // El bit queda hasta que AUTO termine; la cola despierta al control ya
   setAutoMeasureRequested(true);
+  UartCommand c;
+  c.type     = UartCmd::AUTO_MEASURE;
+  c.rxUs     = rxUs_;
+  c.queuedUs = (uint32_t)esp_timer_get_time();
+  if (!cmdQ_ || xQueueSend(cmdQ_, &c, 0) != pdTRUE) cmdDropped_++;   // lo toma el sondeo del bit
+  sendOk_();
+  LOG_D(LogMod::UART, "[UART] auto_measure aceptado -> auto_req=true");
+}
+
+// --- set_format ---
+// data: {"fmt":"json"|"msgpack"}. La respuesta sale en el formato ANTERIOR;
+// desde la siguiente respuesta se usa el nuevo.
+void UARTManager::handle_set_format_(JsonObject dataIn) {
+  const char* f = dataIn.isNull() ? "" : (dataIn["fmt"] | "");
+  WireFormat nf;
+  if      (!strcmp(f, "json"))    nf = WireFormat::JSON;
+  else if (!strcmp(f, "msgpack")) nf = WireFormat::MSGPACK;
+  else {
+    LOG_W(LogMod::UART, "[UART] set_format rechazado -> BAD_ARGS (%s)", f);
+    sendError_("BAD_ARGS");
+    return;
+  }
+
   sendOk_();
-  remoteManager.log("[UART] auto_measure aceptado -> auto_req=true");
+  setWireFormat(nf);
+  LOG_D(LogMod::UART, "[UART] formato de respuesta -> %s", f);
+}
+
+// --- set_recipe ---
+// data: {"pause":ms, "steps":[[op, act|hook, guard, tmo, dur, flags], ...]}
+//  - Elementos finales opcionales (null/"" = none); act se ignora en wait/check/join
+//  - tmo/dur: nombre de parámetro ("drain_t", "sample_fill"...) o ms constantes
+//  - flags: letras "a" (paralelo), "s" (no aborta), "p" (pausa cosmética)
+//  - steps vacío: vuelve a la receta de fábrica
+// Ej.: ["pump","drain","drained","drain_t","drain"], ["hook","read",null,null,null,"p"]
+static bool parseRecipeTime_(JsonVariant v, RecipeParam& p, uint16_t& ds) {
+  p = RecipeParam::NONE;
+  ds = 0;
+  if (v.isNull()) return true;
+  if (v.is<const char*>()) {
+    const char* s = v.as<const char*>();
+    return !*s || recipeParseParam(s, p);
+  }
+  if (v.is<uint32_t>()) {
+    const uint32_t ms = v.as<uint32_t>();
+    if (ms > 65535UL * 100UL) return false;
+    p  = RecipeParam::CONST;
+    ds = (uint16_t)((ms + 50) / 100);
+    return true;
+  }
+  return false;
+}
+
+static bool parseRecipeStep_(JsonArray a, RecipeStep& st) {
+  if (a.isNull() || a.size() == 0 || a.size() > 6) return false;
+  memset(&st, 0, sizeof(st));
+  if (!recipeParseOp(a[0] | "", st.op)) return false;
+
+  const char* act = a[1] | "";
+  if (st.op == RecipeOp::HOOK) {
+    if (!recipeParseHook(act, st.act)) return false;
+  } else if (st.op == RecipeOp::PUMP || st.op == RecipeOp::ON || st.op == RecipeOp::OFF) {
+    if (!recipeParseAct(act, st.act)) return false;
+  }
+
+  const char* g = a[2] | "";
+  if (*g && !recipeParseGuard(g, st.guard)) return false;
+  // RecipeStep es packed: sin referencias a sus campos
+  RecipeParam p;
+  uint16_t ds;
+  if (!parseRecipeTime_(a[3].as<JsonVariant>(), p, ds)) return false;
+  st.tmo = p;
+  st.tmoDs = ds;
+  if (!parseRecipeTime_(a[4].as<JsonVariant>(), p, ds)) return false;
+  st.dur = p;
+  st.durDs = ds;
+
+  for (const char* f = a[5] | ""; *f; ++f) {
+    if      (*f == 'a') st.flags |= RS_ASYNC;
+    else if (*f == 's') st.flags |= RS_SOFT;
+    else if (*f == 'p') st.flags |= RS_PAUSE;
+    else return false;
+  }
+  return true;
+}
+
+void UARTManager::handle_set_recipe_(JsonObject dataIn) {
+  if (getAutoRunning()) {
+    LOG_D(LogMod::UART, "[UART] set_recipe rechazado -> BUSY");
+    sendError_("BUSY");
+    return;
+  }
+
+  JsonArray steps = dataIn.isNull() ? JsonArray() : dataIn["steps"].as<JsonArray>();
+  if (steps.isNull() || steps.size() > Recipe::MAX_STEPS) {
+    LOG_W(LogMod::UART, "[UART] set_recipe rechazado -> BAD_ARGS (steps)");
+    sendError_("BAD_ARGS");
+    return;
+  }
+
+  Recipe r;
+  memset(&r, 0, sizeof(r));
+  r.pauseMs = dataIn["pause"] | (uint16_t)0;
+  for (JsonVariant v : steps) {
+    if (!parseRecipeStep_(v.as<JsonArray>(), r.steps[r.count])) {
+      LOG_W(LogMod::UART, "[UART] set_recipe rechazado -> BAD_ARGS (paso %u)", (unsigned)r.count);
+      sendError_("BAD_ARGS");
+      return;
+    }
+    r.count++;
+  }
+
+  uint8_t bad;
+  if (r.count && !recipeValid(r, bad)) {
+    LOG_W(LogMod::UART, "[UART] set_recipe rechazado -> BAD_ARGS (paso %u invalido)", (unsigned)bad);
+    sendError_("BAD_ARGS");
+    return;
+  }
+
+  if (recipeQ_) xQueueOverwrite(recipeQ_, &r);   // la última gana
+
+  sendOk_();
+  LOG_D(LogMod::UART, "[UART] receta recibida: %u pasos", (unsigned)r.count);
+}
+
+// --- set_log ---
+// data: {"mod":"uart"|"sens"|..., "lvl":"none"|"error"|"warn"|"info"|"debug"}
+// Sin "mod": todos los módulos. Niveles por encima de LOG_LVL_MAX se
+// aceptan pero no producen salida (ese código no está en el binario).
+void UARTManager::handle_set_log_(JsonObject dataIn) {
+  const char* m = dataIn.isNull() ? "" : (dataIn["mod"] | "");
+  const char* l = dataIn.isNull() ? "" : (dataIn["lvl"] | "");
+  uint8_t lvl;
+  LogMod mod;
+  if (!logParseLevel(l, lvl) || (*m && !logParseModule(m, mod))) {
+    LOG_W(LogMod::UART, "[UART] set_log rechazado -> BAD_ARGS (%s %s)", m, l);
+    sendError_("BAD_ARGS");
+    return;
+  }
+
+  if (*m) logSetLevel(mod, lvl);
+  else    logSetAll(lvl);
+  sendOk_();
+  LOG_I(LogMod::UART, "[UART] log %s -> %s", *m ? m : "*", logLevelName(lvl));
+}
+
+// --- subscribe ---
+// Desde la respuesta, cada evento sale apenas ocurre (mismo formato que
+// las respuestas, JSON o MessagePack):
+//   {"ev":"step"|"sample"|"level"|"auto"|"error","seq":N,"t":ms,"data":{...}}
+// La respuesta trae data {"next":seq del próximo evento, "oldest":el más
+// viejo que "resend" todavía tiene}. Un salto en seq = línea perdida.
+void UARTManager::handle_subscribe_() {
+  subscribed_ = true;
+  sendSeqWindow_();
+  LOG_I(LogMod::UART, "[UART] subscribe desde seq %lu", (unsigned long)events_.nextSeq());
+}
+
+// --- unsubscribe ---
+// Los eventos se siguen numerando y guardando (un resend posterior los trae)
+void UARTManager::handle_unsubscribe_() {
+  subscribed_ = false;
+  sendOk_();
+  LOG_I(LogMod::UART, "[UART] unsubscribe");
+}
+
+// --- resend ---
+// data: {"from":seq}. Responde como subscribe y reenvía, con su seq
+// original, los eventos desde max(from, oldest). oldest > from: lo anterior
+// ya no está (el maestro vuelve a get_status/get_last). No hace falta estar
+// suscrito.
+void UARTManager::handle_resend_(JsonObject dataIn) {
+  if (dataIn.isNull() || !dataIn["from"].is<uint32_t>()) {
+    LOG_W(LogMod::UART, "[UART] resend rechazado -> BAD_ARGS");
+    sendError_("BAD_ARGS");
+    return;
+  }
+  const uint32_t from = dataIn["from"].as<uint32_t>();
+  if ((int32_t)(from - events_.nextSeq()) > 0) {
+    LOG_W(LogMod::UART, "[UART] resend rechazado -> BAD_ARGS (seq %lu futuro)", (unsigned long)from);
+    sendError_("BAD_ARGS");
+    return;
+  }
+
+  sendSeqWindow_();
+  uint32_t seq = (int32_t)(from - events_.oldestSeq()) < 0 ? events_.oldestSeq() : from;
+  LOG_D(LogMod::UART, "[UART] resend %lu..%lu", (unsigned long)seq,
+        (unsigned long)(events_.nextSeq() - 1));
+  for (; seq != events_.nextSeq(); ++seq) sendEvent_(*events_.find(seq));
+}
+
+bool UARTManager::takeRecipe(Recipe& out) {
+  return recipeQ_ && xQueueReceive(recipeQ_, &out, 0) == pdTRUE;
 }
 
 // ================== Helpers ==================
 void UARTManager::sendOk_() {
   StaticJsonDocument<32> out;
-  out["ok"] = true;
+  out[k_(UK_OK)] = true;
   sendJson_(out);
-  remoteManager.log("[UART] TX ok=true");
+  LOG_D(LogMod::UART, "[UART] TX ok=true");
 }
 
 void UARTManager::sendError_(const char* err) {
   StaticJsonDocument<96> out;
-  out["ok"] = false;
-  out["error"] = err;
+  out[k_(UK_OK)] = false;
+  out[k_(UK_ERROR)] = err;
   sendJson_(out);
-  remoteManager.log(String("[UART] TX ok=false error=") + err);
+  LOG_D(LogMod::UART, "[UART] TX ok=false error=%s", err);
 }
 
+void UARTManager::sendSeqWindow_() {
+  StaticJsonDocument<96> out;
+  out[k_(UK_OK)] = true;
+  JsonObject data = out.createNestedObject(k_(UK_DATA));
+  data[k_(UK_NEXT)]   = events_.nextSeq();
+  data[k_(UK_OLDEST)] = events_.oldestSeq();
+  sendJson_(out);
+}
+
+// Los textos del evento van por puntero (el evento vive durante el envío)
+void UARTManager::sendEvent_(const UartEvent& e) {
+  StaticJsonDocument<256> out;
+  out[k_(UK_EV)]  = uartEvName(e.type);
+  out[k_(UK_SEQ)] = e.seq;
+  out[k_(UK_T)]   = e.ms;
+  JsonObject data = out.createNestedObject(k_(UK_DATA));
+
+  switch (e.type) {
+    case UartEvType::STEP: {
+      const RecipeOp op = (RecipeOp)e.c;
+      data[k_(UK_SAMPLE)] = e.a;
+      data[k_(UK_STEP)]   = e.b;
+      data[k_(UK_OP)]     = recipeOpName(op);
+      if (op == RecipeOp::HOOK)
+        data[k_(UK_ACT)] = recipeHookName(e.d);
+      else if (op == RecipeOp::PUMP || op == RecipeOp::ON || op == RecipeOp::OFF)
+        data[k_(UK_ACT)] = recipeActName(e.d);
+      data[k_(UK_OUTCOME)] = (const char*)e.text;
+      data[k_(UK_MS)]      = e.u;
+    } break;
+    case UartEvType::SAMPLE:
+      data[k_(UK_ID)] = e.a;
+      if (isfinite(e.f1)) data[k_(UK_PH_VAL)] = e.f1; else data[k_(UK_PH_VAL)] = nullptr;
+      if (isfinite(e.f2)) data[k_(UK_O2_VAL)] = e.f2; else data[k_(UK_O2_VAL)] = nullptr;
+      break;
+    case UartEvType::LEVEL:
+      data[k_(UK_SENSOR)] = (const char*)e.text;
+      data[k_(UK_ACTIVE)] = e.b != 0;
+      break;
+    case UartEvType::AUTO:
+      data[k_(UK_STATE)]  = (const char*)e.text;
+      data[k_(UK_SAMPLE)] = e.a;
+      data[k_(UK_TOTAL)]  = e.b;
+      break;
+    case UartEvType::ERROR:
+    default:
+      data[k_(UK_CODE)] = (const char*)e.text;
+      if (e.b != 0xFF) data[k_(UK_STEP)] = e.b;
+      data[k_(UK_DETAIL)] = e.u;
+      break;
+  }
+
+  sendJson_(out);
+  LOG_D(LogMod::UART, "[UART] TX ev %s seq=%lu", uartEvName(e.type), (unsigned long)e.seq);
+}
+
+// Directo al Stream, sin buffer intermedio
 void UARTManager::sendJson_(const JsonDocument& doc) {
-  String payload;
-  serializeJson(doc, payload);
-  io_.println(payload);
+  if (fmt_ == WireFormat::MSGPACK) {
+    const size_t n = measureMsgPackKeys(doc);
+    if (n == 0 || n > kFrameMaxLen) {
+      LOG_E(LogMod::UART, "[UART] ERROR: trama MessagePack excede kFrameMaxLen");
+      return;
+    }
+    const uint8_t hdr[3] = {kFrameSync, (uint8_t)(n >> 8), (uint8_t)(n & 0xFF)};
+    io_.write(hdr, sizeof(hdr));
+    serializeMsgPackKeys(doc, io_);
+    return;
+  }
+
+  serializeJson(doc, io_);
+  io_.println();
 }
 
 } // namespace UartProto
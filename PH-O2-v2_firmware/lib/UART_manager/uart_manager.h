@@ -1,17 +1,57 @@
 #pragma once
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <freertos/event_groups.h>
 #include <globals.h>
+#include "uart_schema.h"
+#include "uart_msgpack.h"
+#include "line_framer.h"
+#include "event_ring.h"
+#include "recipe.h"
+#include "recipe_engine.h"
 
 namespace UartProto {
 
+// Comando que el puerto entrega a la tarea de control (cola de FreeRTOS)
+enum class UartCmd : uint8_t { AUTO_MEASURE };
+
+struct UartCommand {
+  UartCmd  type = UartCmd::AUTO_MEASURE;
+  uint32_t rxUs = 0;       // esp_timer del aviso de RX que trajo la línea
+  uint32_t queuedUs = 0;   // esp_timer al encolar (línea ya procesada)
+};
+
+/*
+  Hilos
+  -----
+  - Una sola tarea atiende el puerto: waitRx() la duerme hasta que
+    notifyRx() (HardwareSerial::onReceive) avisa que llegó algo, y luego
+    llama loop().
+  - Comandos hacia el control: cola (nextCommand bloquea en ella).
+  - Resultados desde otras tareas (setLast*, setSample*, setLevel*): cola
+    que loop() vacía antes de responder; esos campos son solo de la tarea
+    del puerto.
+  - auto_running / auto_req: bits de un event group (sin sección crítica).
+  - Receta: cola de un elemento (la última gana).
+  - Eventos (emit*): cola que loop() vacía; ahí se numeran (seq), se
+    guardan en el historial y, con "subscribe", se empujan al maestro.
+    emit* despierta a la tarea del puerto como un aviso de RX.
+*/
 class UARTManager {
 public:
   explicit UARTManager(Stream& inOut);
 
+  // Crea colas y event group: antes de arrancar las tareas
   void begin(unsigned long baud = 115200);
   void loop();
 
+  // ====== Despertar por RX ======
+  void notifyRx();                        // desde el callback de recepción
+  bool waitRx(TickType_t wait);           // true = hubo aviso
+
+  // ====== Comandos (tarea de control) ======
+  bool nextCommand(UartCommand& c, TickType_t wait = 0);
+
   // ====== Setters de estado general ======
   void setLevelH2O(bool v);
   void setLevelKCL(bool v);
@@ -30,6 +70,7 @@ public:
   bool   getLevelKCL() const;
   bool   getAutoRunning() const;
 
+  // Solo la tarea del puerto (los demás escriben por la cola)
   float  getLastPh() const;
   float  getLastTempC() const;
   String getLastResult() const;
@@ -37,6 +78,10 @@ public:
 
   bool   getAutoMeasureRequested() const;
 
+  // Formato de respuesta (JSON por defecto; el maestro lo cambia con op "set_format")
+  void       setWireFormat(WireFormat f);
+  WireFormat getWireFormat() const;
+
   // ====== Set/Get por SAMPLE (id 1..4) ======
   // Guarda/lee valores NUMÉRICOS (no bool) de pH y O2 por muestra.
   void  setSamplePhValueById(uint8_t id /*1..4*/, float v);
@@ -44,48 +89,113 @@ public:
   float getSamplePhValueById(uint8_t id /*1..4*/) const;
   float getSampleO2ValueById(uint8_t id /*1..4*/) const;
 
-private:
-  Stream& io_;
-  String lineBuf_;
+  // ====== Eventos (streaming): cualquier tarea ======
+  void emitStep(uint8_t sample /*1..4*/, const RecipeStepReport& r);
+  void emitSample(uint8_t id /*1..4*/, float ph, float o2);
+  void emitLevel(const char* sensor, bool active, uint32_t ms);
+  void emitAuto(const char* state, uint8_t sample, uint8_t total);
+  void emitError(const char* code, uint8_t step = 0xFF, uint32_t detail = 0);
+
+  // ====== Receta AUTO recibida por "set_recipe" ======
+  // true (una sola vez) si llegó una receta nueva; count = 0 pide la de fábrica
+  bool  takeRecipe(Recipe& out);
+
+  // Diagnóstico
+  uint32_t droppedResults() const { return resDropped_; }
+  uint32_t droppedCommands() const { return cmdDropped_; }
+  uint32_t droppedEvents() const { return evDropped_; }
 
-  // Estado global
-  volatile bool   levelH2O_ok_ = false;
-  volatile bool   levelKCL_ok_ = false;
-  volatile bool   auto_running_ = false;
-  volatile bool   autoMeasureRequested_ = false;
+private:
+  static constexpr size_t RESULT_LEN = 24;   // "CAL_PH_3PT_PW_OK" y similares
+
+  // Resultado en tránsito hacia la tarea del puerto
+  enum class ResKind : uint8_t { PH, TEMP, TEXT, HAS_DATA, SAMPLE_PH, SAMPLE_O2, H2O, KCL };
+  struct Result {
+    ResKind kind;
+    uint8_t idx;
+    float   v;
+    char    text[RESULT_LEN];
+  };
+
+  // Bits del event group
+  static constexpr EventBits_t EV_AUTO_RUNNING = BIT0;
+  static constexpr EventBits_t EV_AUTO_REQ     = BIT1;
+
+  // Documento de entrada: set_recipe es el más grande (16 pasos x 6).
+  // Parseo en sitio: los strings apuntan a la línea, solo cuentan los nodos
+  // (raíz con margen para claves extra del maestro)
+  static constexpr size_t IN_DOC_CAP =
+      JSON_OBJECT_SIZE(4) + JSON_OBJECT_SIZE(2) + JSON_ARRAY_SIZE(Recipe::MAX_STEPS) +
+      Recipe::MAX_STEPS * JSON_ARRAY_SIZE(6);
 
-  volatile float  last_ph_ = 7.0f;
-  volatile float  last_tempC_ = 25.0f;
-  String          last_result_ = "OK";
-  volatile bool   last_has_data_ = false;
+  Stream& io_;
+  LineFramer framer_;
+  StaticJsonDocument<IN_DOC_CAP> in_;
+
+  QueueHandle_t      cmdQ_ = nullptr;
+  QueueHandle_t      resQ_ = nullptr;
+  QueueHandle_t      recipeQ_ = nullptr;
+  QueueHandle_t      evQ_ = nullptr;
+  EventGroupHandle_t flags_ = nullptr;
+  SemaphoreHandle_t  rxSem_ = nullptr;
+  volatile uint32_t  rxUs_ = 0;
+  volatile uint32_t  resDropped_ = 0;
+  volatile uint32_t  cmdDropped_ = 0;
+  volatile uint32_t  evDropped_ = 0;
+
+  // Estado de la tarea del puerto (se actualiza desde resQ_)
+  bool            levelH2O_ok_ = false;
+  bool            levelKCL_ok_ = false;
+  float           last_ph_ = 7.0f;
+  float           last_tempC_ = 25.0f;
+  char            last_result_[RESULT_LEN] = "OK";
+  bool            last_has_data_ = false;
+
+  WireFormat      fmt_ = WireFormat::JSON;
+
+  // Streaming: historial numerado y suscripción del maestro
+  EventRing       events_;
+  bool            subscribed_ = false;
+  uint32_t        evLost_ = 0;   // evDropped_ ya avisado con un evento "error"
 
   // Estado por SAMPLE (S1..S4) — valores numéricos
-  volatile float  sample_ph_val_[4] = {NAN, NAN, NAN, NAN};
-  volatile float  sample_o2_val_[4] = {NAN, NAN, NAN, NAN};
-
-#if defined(ESP32)
-  portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
-  void lock()   { taskENTER_CRITICAL(&mux_); }
-  void unlock() { taskEXIT_CRITICAL(&mux_); }
-#else
-  void lock()   {}
-  void unlock() {}
-#endif
+  float           sample_ph_val_[4] = {NAN, NAN, NAN, NAN};
+  float           sample_o2_val_[4] = {NAN, NAN, NAN, NAN};
+
+  void post_(const Result& r);
+  void apply_(const Result& r);
+  void drainResults_();
+  void setFlag_(EventBits_t bit, bool v);
+  bool flag_(EventBits_t bit) const;
+  void emit_(UartEvent& e);
+  void record_(UartEvent& e);
+  void drainEvents_();
 
   // Procesamiento de comandos NDJSON
-  void processLine_(const String& line);
+  void processLine_(char* line);
   void handle_get_status_();
   void handle_get_last_();
   void handle_auto_measure_(JsonObject dataIn);
+  void handle_set_format_(JsonObject dataIn);
+  void handle_set_recipe_(JsonObject dataIn);
+  void handle_set_log_(JsonObject dataIn);
+  void handle_subscribe_();
+  void handle_unsubscribe_();
+  void handle_resend_(JsonObject dataIn);
 
   // Helpers de salida
   void sendOk_();
   void sendError_(const char* err);
   void sendJson_(const JsonDocument& doc);
+  void sendSeqWindow_();
+  void sendEvent_(const UartEvent& e);
 
   // Helper JSON: inyectar arreglo "samples" [{id, ph_val, o2_val} x4]
   void addSamplesArray_(JsonObject parent);
 
+  // Nombre de la clave; en MessagePack sale como su id (uart_msgpack)
+  const char* k_(UartKey k) const { return uartKey(k); }
+
   // Helper índice interno (id 1..4 -> idx 0..3), devuelve 255 si inválido
   static uint8_t idToIndex_(uint8_t id) {
     if (id < 1 || id > 4) return 255;
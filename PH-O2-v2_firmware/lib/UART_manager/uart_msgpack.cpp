@@ -0,0 +1,95 @@
+#include "uart_msgpack.h"
+#include <string.h>
+
+namespace UartProto {
+
+namespace {
+
+struct Writer {
+  Print* out;
+  size_t n = 0;
+
+  explicit Writer(Print* o) : out(o) {}
+
+  void byte(uint8_t b) { if (out) out->write(b); n++; }
+  void be(uint64_t v, uint8_t bytes) { for (int i = bytes - 1; i >= 0; --i) byte((uint8_t)(v >> (8 * i))); }
+
+  void uint(uint32_t v) {
+    if (v < 0x80)        byte((uint8_t)v);
+    else if (v <= 0xFF)  { byte(0xCC); be(v, 1); }
+    else if (v <= 0xFFFF){ byte(0xCD); be(v, 2); }
+    else                 { byte(0xCE); be(v, 4); }
+  }
+
+  void sint(int32_t v) {
+    if (v >= 0)              uint((uint32_t)v);
+    else if (v >= -32)       byte((uint8_t)v);                       // negative fixint
+    else if (v >= INT8_MIN)  { byte(0xD0); be((uint32_t)v, 1); }
+    else if (v >= INT16_MIN) { byte(0xD1); be((uint32_t)v, 2); }
+    else                     { byte(0xD2); be((uint32_t)v, 4); }
+  }
+
+  void f32(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    byte(0xCA);
+    be(bits, 4);
+  }
+
+  void str(const char* s) {
+    const size_t len = s ? strlen(s) : 0;
+    if (len < 32)         byte((uint8_t)(0xA0 | len));
+    else if (len <= 0xFF) { byte(0xD9); be(len, 1); }
+    else                  { byte(0xDA); be(len, 2); }
+    for (size_t i = 0; i < len; ++i) byte((uint8_t)s[i]);
+  }
+
+  void head(size_t count, uint8_t fix, uint8_t x16, uint8_t x32) {
+    if (count < 16)          byte((uint8_t)(fix | count));
+    else if (count <= 0xFFFF){ byte(x16); be(count, 2); }
+    else                     { byte(x32); be(count, 4); }
+  }
+
+  void key(const char* k) {
+    const UartKey id = uartKeyId(k);
+    if (id < UK_COUNT) byte((uint8_t)id);   // positive fixint (ids < 128)
+    else               str(k);
+  }
+
+  void value(JsonVariantConst v) {
+    if (v.is<JsonObjectConst>()) {
+      JsonObjectConst o = v.as<JsonObjectConst>();
+      head(o.size(), 0x80, 0xDE, 0xDF);
+      for (JsonPairConst kv : o) {
+        key(kv.key().c_str());
+        value(kv.value());
+      }
+    } else if (v.is<JsonArrayConst>()) {
+      JsonArrayConst a = v.as<JsonArrayConst>();
+      head(a.size(), 0x90, 0xDC, 0xDD);
+      for (JsonVariantConst e : a) value(e);
+    } else if (v.is<bool>()) {
+      byte(v.as<bool>() ? 0xC3 : 0xC2);
+    } else if (v.is<const char*>()) {
+      str(v.as<const char*>());
+    } else if (v.is<uint32_t>()) {
+      uint(v.as<uint32_t>());
+    } else if (v.is<int32_t>()) {
+      sint(v.as<int32_t>());
+    } else if (v.is<float>()) {
+      f32(v.as<float>());
+    } else {
+      byte(0xC0);   // null (o algo que el esquema no usa)
+    }
+  }
+};
+
+} // namespace
+
+size_t writeMsgPack(JsonVariantConst v, Print* out) {
+  Writer w(out);
+  w.value(v);
+  return w.n;
+}
+
+} // namespace UartProto
@@ -0,0 +1,30 @@
+#ifndef UART_MSGPACK_H
+#define UART_MSGPACK_H
+
+#include <ArduinoJson.h>
+#include "uart_schema.h"
+
+// =====================================================
+// Respuestas del UART en MessagePack con claves enteras
+//  - serializeMsgPack() de ArduinoJson solo escribe claves string; acá
+//    cada clave de UART_KEY_NAME sale como su id de UartKey (fixint de
+//    1 byte), igual que TelemetryMsgPack en Beans_telemetry_lab
+//  - Una clave fuera del esquema sale como string (no se pierde)
+//  - Floats en float32, enteros con la codificación mínima
+//  - out = nullptr solo cuenta (para el encabezado de la trama)
+// =====================================================
+
+namespace UartProto {
+
+size_t writeMsgPack(JsonVariantConst v, Print* out);
+
+inline size_t measureMsgPackKeys(const JsonDocument& doc) {
+  return writeMsgPack(doc.as<JsonVariantConst>(), nullptr);
+}
+inline size_t serializeMsgPackKeys(const JsonDocument& doc, Print& out) {
+  return writeMsgPack(doc.as<JsonVariantConst>(), &out);
+}
+
+} // namespace UartProto
+
+#endif // UART_MSGPACK_H
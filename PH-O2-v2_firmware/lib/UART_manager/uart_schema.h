@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+namespace UartProto {
+
+// Formato de las RESPUESTAS (los comandos entrantes siguen siendo NDJSON)
+//  - JSON:    una línea JSON terminada en '\n' (histórico)
+//  - MSGPACK: trama binaria [0xA5][len_hi][len_lo][payload MessagePack]
+enum class WireFormat : uint8_t {
+  JSON = 0,
+  MSGPACK
+};
+
+static constexpr uint8_t  kFrameSync   = 0xA5;
+static constexpr uint16_t kFrameMaxLen = 512;
+
+// Claves compartidas con el maestro. En JSON viaja el nombre; en
+// MessagePack el id como clave entera (fixint de 1 byte, ver
+// uart_msgpack.h), como TelemetrySchema en Beans_telemetry_lab.
+// No reordenar: el maestro decodifica por id.
+enum UartKey : uint8_t {
+  UK_OK = 0,
+  UK_ERROR,
+  UK_DATA,
+  UK_LEVEL_SENSORS,
+  UK_H2O,
+  UK_KCL,
+  UK_AUTO_RUNNING,
+  UK_AUTO_REQ,
+  UK_SAMPLES,
+  UK_ID,
+  UK_PH_VAL,
+  UK_O2_VAL,
+  UK_PH,
+  UK_TEMPC,
+  UK_RESULT,
+  // Streaming (subscribe / resend)
+  UK_EV,
+  UK_SEQ,
+  UK_T,
+  UK_NEXT,
+  UK_OLDEST,
+  UK_SAMPLE,
+  UK_STEP,
+  UK_OP,
+  UK_ACT,
+  UK_OUTCOME,
+  UK_MS,
+  UK_SENSOR,
+  UK_ACTIVE,
+  UK_STATE,
+  UK_TOTAL,
+  UK_CODE,
+  UK_DETAIL,
+  UK_COUNT
+};
+
+static const char* const UART_KEY_NAME[UK_COUNT] = {
+  "ok", "error", "data", "level_sensors", "h2o", "kcl",
+  "auto_running", "auto_req", "samples", "id",
+  "ph_val", "o2_val", "ph", "tempC", "result",
+  "ev", "seq", "t", "next", "oldest", "sample", "step", "op", "act",
+  "outcome", "ms", "sensor", "active", "state", "total", "code", "detail"
+};
+
+inline const char* uartKey(UartKey k) { return UART_KEY_NAME[k]; }
+
+// Id de un nombre del esquema (UK_COUNT si no está)
+inline UartKey uartKeyId(const char* name) {
+  for (uint8_t i = 0; i < UK_COUNT; ++i)
+    if (name == UART_KEY_NAME[i] || !strcmp(name, UART_KEY_NAME[i])) return (UartKey)i;
+  return UK_COUNT;
+}
+
+} // namespace UartProto
@@ -0,0 +1,95 @@
+#ifndef ACQ_SNAPSHOT_H
+#define ACQ_SNAPSHOT_H
+
+#include <stdint.h>
+#include <math.h>
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#else
+#include <mutex>
+#endif
+
+// =====================================================
+// Snapshot de adquisición (pH, O2 y temperatura) y su celda compartida
+//  - Un solo escritor: la tarea de adquisición (publish)
+//  - N lectores: UI, modo automático, UART (read); copian ~50 bytes
+//  - Contrato:
+//    * read() nunca bloquea más que la copia del struct y nunca toca el
+//      ADS ni el bus 1-Wire
+//    * Lo leído es coherente: todos los campos vienen de la misma publish()
+//    * seq crece en cada publish(); seq == 0 => aún no hay datos
+//    * ph_ms/temp_ms son millis() del inicio de cada medición: un lector
+//      que necesita un dato posterior a t espera ph_ms >= t
+//  - En ESP32 la sección crítica es un portMUX (igual que UARTManager);
+//    en host un std::mutex (se prueba con hilos)
+// =====================================================
+
+enum AcqFlags : uint8_t {
+  ACQ_PH_OK        = 1 << 0,   // ph/volts válidos
+  ACQ_PH_CONVERGED = 1 << 1,   // la lectura cerró por IC, no por presupuesto
+  ACQ_TEMP_OK      = 1 << 2,   // temp_c viene del DS18B20 y es reciente
+  ACQ_TEMP_FALLBACK= 1 << 3,   // sin sensor o lectura vieja: compensado a 25 °C
+  ACQ_ADC_ERROR    = 1 << 4,   // la última lectura de pH falló
+  ACQ_PAUSED       = 1 << 5,   // adquisición detenida (calibración en curso)
+  ACQ_O2_OK        = 1 << 6    // o2_* válidos (misma ventana que el pH)
+};
+
+struct AcqSnapshot {
+  uint32_t seq = 0;
+  uint32_t ph_ms = 0;          // millis() al iniciar la lectura de pH
+  uint32_t temp_ms = 0;        // millis() de la última temperatura válida
+  float    ph = NAN;
+  float    volts = NAN;
+  float    noise_ph = NAN;
+  float    ci95_ph = NAN;
+  float    temp_c = NAN;       // temperatura usada para compensar
+  float    o2_mgl = NAN;
+  float    o2_sat_pct = NAN;
+  float    o2_volts = NAN;
+  uint16_t samples = 0;
+  uint16_t rejected = 0;
+  uint8_t  flags = 0;
+
+  bool has(uint8_t f) const { return (flags & f) != 0; }
+};
+
+class AcqSnapshotCell {
+public:
+  // Escritor único. Asigna seq.
+  void publish(const AcqSnapshot& s) {
+    lock();
+    snap_ = s;
+    snap_.seq = ++seq_;
+    unlock();
+  }
+
+  AcqSnapshot read() const {
+    lock();
+    AcqSnapshot s = snap_;
+    unlock();
+    return s;
+  }
+
+  // Solo actualiza flags (p.ej. ACQ_PAUSED) sin publicar medición nueva
+  void setFlag(uint8_t f, bool on) {
+    lock();
+    snap_.flags = on ? (uint8_t)(snap_.flags | f) : (uint8_t)(snap_.flags & ~f);
+    unlock();
+  }
+
+private:
+  AcqSnapshot snap_;
+  uint32_t    seq_ = 0;
+
+#if defined(ESP32)
+  mutable portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+  void lock()   const { taskENTER_CRITICAL(&mux_); }
+  void unlock() const { taskEXIT_CRITICAL(&mux_); }
+#else
+  mutable std::mutex mux_;
+  void lock()   const { mux_.lock(); }
+  void unlock() const { mux_.unlock(); }
+#endif
+};
+
+#endif // ACQ_SNAPSHOT_H
@@ -0,0 +1,149 @@
+#include "acquisition_manager.h"
+
+static constexpr float kTempFallbackC = 25.0f;
+
+AcquisitionManager::AcquisitionManager(PHManager* ph, O2Manager* o2, DS18B20Manager* thermo,
+                                       uint32_t phPeriodMs, uint32_t tempPeriodMs)
+: ph_(ph), o2_(o2), thermo_(thermo), ph_period_ms_(phPeriodMs), temp_period_ms_(tempPeriodMs) {}
+
+bool AcquisitionManager::begin(uint8_t core, UBaseType_t priority, uint32_t stackWords) {
+  if (task_) return true;
+  if (!ph_) return false;
+
+  busy_ = xSemaphoreCreateMutex();
+  if (!busy_) return false;
+
+  // Conversiones del DS18B20 agendadas por el propio driver: el ciclo solo recoge
+  if (thermo_) thermo_->setAutoPeriod(temp_period_ms_);
+
+  BaseType_t ok = xTaskCreatePinnedToCore(taskEntry_, "Acq", stackWords, this,
+                                          priority, &task_, core);
+  return ok == pdPASS;
+}
+
+void AcquisitionManager::setPeriods(uint32_t phPeriodMs, uint32_t tempPeriodMs) {
+  ph_period_ms_   = phPeriodMs ? phPeriodMs : 1;
+  temp_period_ms_ = tempPeriodMs ? tempPeriodMs : 1;
+  if (thermo_) thermo_->setAutoPeriod(temp_period_ms_);
+}
+
+DS18B20Snapshot AcquisitionManager::probes() const {
+  taskENTER_CRITICAL(&probes_mux_);
+  DS18B20Snapshot s = probes_;
+  taskEXIT_CRITICAL(&probes_mux_);
+  return s;
+}
+
+uint32_t AcquisitionManager::requestFresh() {
+  const uint32_t t = millis();
+  if (task_) xTaskNotifyGive(task_);
+  return t;
+}
+
+void AcquisitionManager::pause() {
+  if (!busy_ || paused_) return;
+  paused_ = true;
+  xSemaphoreTake(busy_, portMAX_DELAY);   // espera a que termine el ciclo en curso
+  cell_.setFlag(ACQ_PAUSED, true);
+}
+
+void AcquisitionManager::resume() {
+  if (!busy_ || !paused_) return;
+  cell_.setFlag(ACQ_PAUSED, false);
+  paused_ = false;
+  xSemaphoreGive(busy_);
+  requestFresh();   // lo medido antes de la pausa puede estar viejo
+}
+
+void AcquisitionManager::taskEntry_(void* self) {
+  static_cast<AcquisitionManager*>(self)->run_();
+}
+
+void AcquisitionManager::run_() {
+  for (;;) {
+    const uint32_t t0 = millis();
+    if (!paused_ && xSemaphoreTake(busy_, 0) == pdTRUE) {
+      cycle_();
+      xSemaphoreGive(busy_);
+    }
+    // Duerme lo que falta del período (el ciclo ya gastó parte) o hasta
+    // requestFresh(); al menos un tick para ceder la CPU
+    const uint32_t spent = millis() - t0;
+    const uint32_t left  = spent < ph_period_ms_ ? ph_period_ms_ - spent : 0;
+    ulTaskNotifyTake(pdTRUE, left ? pdMS_TO_TICKS(left) : 1);
+  }
+}
+
+void AcquisitionManager::updateTemp_(uint32_t now) {
+  if (!thermo_ || thermo_->sensorCount() == 0) return;
+
+  // No bloquea: cierra/dispara conversiones y devuelve el último valor con su edad
+  thermo_->update();
+  const DS18B20Snapshot& ps = thermo_->snapshot();
+  if (ps.seq != probes_.seq) {            // único escritor: leer seq sin lock es seguro
+    taskENTER_CRITICAL(&probes_mux_);
+    probes_ = ps;
+    taskEXIT_CRITICAL(&probes_mux_);
+  }
+
+  float c;
+  uint32_t age;
+  if (thermo_->lastC(0, c, age) && c > -40.0f && c < 125.0f) {
+    temp_c_  = c;
+    temp_ms_ = now - age;
+  }
+}
+
+void AcquisitionManager::cycle_() {
+  updateTemp_(millis());
+
+  AcqSnapshot s;
+  s.ph_ms   = millis();
+  s.temp_ms = temp_ms_;
+
+  // Temperatura "reciente": hasta 3 períodos sin lectura válida
+  const bool tempFresh = isfinite(temp_c_) &&
+                         (uint32_t)(s.ph_ms - temp_ms_) <= 3 * temp_period_ms_;
+  if (tempFresh) {
+    s.temp_c = temp_c_;
+    s.flags |= ACQ_TEMP_OK;
+  } else {
+    s.temp_c = kTempFallbackC;
+    s.flags |= ACQ_TEMP_FALLBACK;
+  }
+
+  // pH y O2 en la misma ventana: una conversión de cada uno por vuelta
+  // (el escaneo del ADS llena los dos rings a la vez)
+  bool phDone = !ph_->beginRead();
+  bool o2Done = !(o2_ && o2_->isCalibrated() && o2_->beginRead());
+  bool phFail = phDone;
+  bool o2Fail = o2Done;
+  while (!phDone || !o2Done) {
+    if (!phDone && !ph_->stepVolts(phDone)) phFail = true;
+    if (!o2Done && !o2_->stepVolts(o2Done)) o2Fail = true;
+  }
+
+  PHReading rd;
+  if (!phFail && ph_->finishRead(s.temp_c, rd)) {
+    s.ph       = rd.ph;
+    s.volts    = rd.volts;
+    s.noise_ph = rd.noisePH;
+    s.ci95_ph  = rd.ci95PH;
+    s.samples  = rd.samples;
+    s.rejected = rd.rejected;
+    s.flags   |= ACQ_PH_OK;
+    if (rd.converged) s.flags |= ACQ_PH_CONVERGED;
+  } else {
+    s.flags |= ACQ_ADC_ERROR;
+  }
+
+  O2Reading o2;
+  if (!o2Fail && o2_->finishRead(s.temp_c, o2)) {
+    s.o2_mgl     = o2.mgL;
+    s.o2_sat_pct = o2.satPct;
+    s.o2_volts   = o2.volts;
+    s.flags     |= ACQ_O2_OK;
+  }
+
+  cell_.publish(s);
+}
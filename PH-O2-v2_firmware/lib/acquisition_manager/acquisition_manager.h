@@ -0,0 +1,72 @@
+#ifndef ACQUISITION_MANAGER_H
+#define ACQUISITION_MANAGER_H
+
+#include <Arduino.h>
+#include "ph_manager.h"
+#include "o2_manager.h"
+#include "DS18B20_manager.h"
+#include "acq_snapshot.h"
+
+// =====================================================
+// Tarea de adquisición en segundo plano
+//  - Es la única que usa el ADS (pH y O2) y el DS18B20 mientras corre
+//  - Temperatura cada tempPeriodMs (conversión asíncrona del DS18B20, sin
+//    bloquear el ciclo); pH y O2 compensados cada phPeriodMs,
+//    intercalando sus conversiones en la misma ventana del ADS
+//  - Publica un AcqSnapshot; los demás solo leen snapshot()
+//  - pause()/resume(): acceso exclusivo al ADS/DS18B20 (calibraciones)
+// =====================================================
+
+class AcquisitionManager {
+public:
+  // o2 puede ser nullptr (equipo sin sonda de O2)
+  AcquisitionManager(PHManager* ph, O2Manager* o2, DS18B20Manager* thermo,
+                     uint32_t phPeriodMs = 500, uint32_t tempPeriodMs = 2000);
+
+  // Crea la tarea (core 1 por defecto, junto a WiFi/UART)
+  bool begin(uint8_t core = 1, UBaseType_t priority = 1, uint32_t stackWords = 4096);
+
+  AcqSnapshot snapshot() const { return cell_.read(); }
+
+  // Todos los DS18B20 de la última conversión común (copia coherente)
+  DS18B20Snapshot probes() const;
+
+  // Adelanta el próximo ciclo. Retorna millis() de la petición:
+  // el primer snapshot con ph_ms >= ese valor es posterior a la llamada.
+  uint32_t requestFresh();
+
+  // Bloquea hasta que termina el ciclo en curso y deja la tarea detenida.
+  // Llamar pause() y resume() desde la MISMA tarea.
+  void pause();
+  void resume();
+  bool isPaused() const { return paused_; }
+
+  void setPeriods(uint32_t phPeriodMs, uint32_t tempPeriodMs);
+
+private:
+  PHManager*      ph_;
+  O2Manager*      o2_;
+  DS18B20Manager* thermo_;
+  uint32_t        ph_period_ms_;
+  uint32_t        temp_period_ms_;
+
+  TaskHandle_t      task_ = nullptr;
+  SemaphoreHandle_t busy_ = nullptr;   // lo tiene la tarea durante un ciclo, o pause()
+  volatile bool     paused_ = false;
+
+  AcqSnapshotCell cell_;
+
+  DS18B20Snapshot      probes_;      // copia de thermo_->snapshot() para otras tareas
+  mutable portMUX_TYPE probes_mux_ = portMUX_INITIALIZER_UNLOCKED;
+
+  // Estado de la tarea (solo lo toca run_())
+  float    temp_c_ = NAN;
+  uint32_t temp_ms_ = 0;
+
+  static void taskEntry_(void* self);
+  void run_();
+  void cycle_();
+  void updateTemp_(uint32_t now);
+};
+
+#endif // ACQUISITION_MANAGER_H
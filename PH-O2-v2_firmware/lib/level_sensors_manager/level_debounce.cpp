@@ -0,0 +1,41 @@
+#include "level_debounce.h"
+
+void LevelDebouncer::begin(bool level, uint32_t nowUs, uint32_t stableUs) {
+  stableUs_ = stableUs;
+  stable_ = raw_ = level;
+  burst_ = false;
+  burstUs_ = lastUs_ = changeUs_ = nowUs;
+  bounces_ = 0;
+}
+
+void LevelDebouncer::edge(bool level, uint32_t tUs) {
+  if (level == raw_) return;   // la ISR pudo perder el flanco intermedio
+  raw_ = level;
+  lastUs_ = tUs;
+  if (!burst_) {
+    burst_ = true;
+    burstUs_ = tUs;
+  }
+}
+
+bool LevelDebouncer::poll(uint32_t nowUs, LevelEdge& out) {
+  if (!burst_ || nowUs - lastUs_ < stableUs_) return false;
+
+  burst_ = false;
+  if (raw_ == stable_) {   // volvió al nivel de antes: rebote
+    bounces_++;
+    return false;
+  }
+  stable_ = raw_;
+  changeUs_ = burstUs_;
+  out.level = stable_;
+  out.tUs = burstUs_;
+  out.confirmUs = nowUs;
+  return true;
+}
+
+uint32_t LevelDebouncer::pendingUs(uint32_t nowUs) const {
+  if (!burst_) return NONE;
+  const uint32_t quiet = nowUs - lastUs_;
+  return quiet >= stableUs_ ? 0 : stableUs_ - quiet;
+}
@@ -0,0 +1,56 @@
+#ifndef LEVEL_DEBOUNCE_H
+#define LEVEL_DEBOUNCE_H
+
+#include <stdint.h>
+
+// =====================================================
+// Antirrebote por flancos para un sensor de nivel
+//  - Se alimenta con los flancos crudos que captura la ISR (nivel + tiempo
+//    en µs de esp_timer) y con poll() desde la tarea que los consume
+//  - Un cambio se confirma cuando el nivel crudo queda quieto stableUs
+//    desde el último flanco; si la ráfaga vuelve al nivel previo es un rebote
+//  - El evento lleva el tiempo del PRIMER flanco de la ráfaga: el cruce
+//    real del líquido, no el instante en que se confirmó
+//  - Tiempos uint32 en µs con resta sin signo (vuelta cada ~71 min)
+//  - Sin dependencias de Arduino (se prueba en host)
+// =====================================================
+
+struct LevelEdge {
+  bool     level = false;   // nivel crudo confirmado
+  uint32_t tUs   = 0;       // primer flanco de la ráfaga
+  uint32_t confirmUs = 0;   // cuándo se confirmó (tUs + ráfaga + stableUs)
+};
+
+class LevelDebouncer {
+public:
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+  void begin(bool level, uint32_t nowUs, uint32_t stableUs = 20000);
+
+  // Flanco crudo (en orden; los repetidos se ignoran)
+  void edge(bool level, uint32_t tUs);
+
+  // true si en nowUs se confirma un cambio (out = evento)
+  bool poll(uint32_t nowUs, LevelEdge& out);
+
+  // µs hasta que poll() pueda confirmar algo (NONE = nada pendiente)
+  uint32_t pendingUs(uint32_t nowUs) const;
+
+  bool     level() const { return stable_; }
+  bool     raw() const { return raw_; }
+  uint32_t lastChangeUs() const { return changeUs_; }
+  uint32_t bounces() const { return bounces_; }
+  uint32_t stableUs() const { return stableUs_; }
+
+private:
+  uint32_t stableUs_ = 20000;
+  bool     stable_ = false;     // nivel confirmado
+  bool     raw_ = false;        // último flanco crudo
+  bool     burst_ = false;      // hay flancos sin confirmar
+  uint32_t burstUs_ = 0;        // primer flanco de la ráfaga
+  uint32_t lastUs_ = 0;         // último flanco crudo
+  uint32_t changeUs_ = 0;       // tiempo (del primer flanco) del último cambio confirmado
+  uint32_t bounces_ = 0;
+};
+
+#endif // LEVEL_DEBOUNCE_H
@@ -1,4 +1,6 @@
 #include "level_sensors_manager.h"
+#include <driver/gpio.h>
+#include <esp_timer.h>
 
 bool LevelSensorsManager::begin(int pinO2, int pinPH, int pinKCL, int pinH2O) {
   pinO2_  = pinO2;
@@ -17,10 +19,11 @@ bool LevelSensorsManager::begin(int pinO2, int pinPH, int pinKCL, int pinH2O) {
 }
 
 // --- Lecturas específicas ---
-bool LevelSensorsManager::o2()  const { return readHigh_(pinO2_);  }
-bool LevelSensorsManager::ph()  const { return readHigh_(pinPH_);  }
-bool LevelSensorsManager::kcl() const { return readHigh_(pinKCL_); }
-bool LevelSensorsManager::h2o() const { return readHigh_(pinH2O_); }
+// Con eventos: estado con antirrebote que publica la tarea
+bool LevelSensorsManager::o2()  const { return task_ ? active_[0] : readHigh_(pinO2_);  }
+bool LevelSensorsManager::ph()  const { return task_ ? active_[1] : readHigh_(pinPH_);  }
+bool LevelSensorsManager::kcl() const { return task_ ? active_[2] : readHigh_(pinKCL_); }
+bool LevelSensorsManager::h2o() const { return task_ ? active_[3] : readHigh_(pinH2O_); }
 
 // --- Lectura genérica por ID ---
 bool LevelSensorsManager::read(LevelSensorId id) const {
@@ -33,3 +36,155 @@ bool LevelSensorsManager::read(LevelSensorId id) const {
   }
 
 }
+
+// =====================================================
+// Modo por interrupciones
+// =====================================================
+int LevelSensorsManager::pinOf_(uint8_t id) const {
+  switch ((LevelSensorId)id) {
+    case LevelSensorId::O2:  return pinO2_;
+    case LevelSensorId::PH:  return pinPH_;
+    case LevelSensorId::KCL: return pinKCL_;
+    case LevelSensorId::H2O: return pinH2O_;
+    default:                 return -1;
+  }
+}
+
+bool LevelSensorsManager::beginEvents(uint32_t debounceMs, uint8_t core, UBaseType_t priority,
+                                      uint32_t stackWords) {
+  if (task_) return true;
+
+  rawQ_ = xQueueCreate(32, sizeof(RawEdge));
+  if (!rawQ_) return false;
+
+  const uint32_t nowUs = (uint32_t)esp_timer_get_time();
+  for (uint8_t i = 0; i < N; ++i) {
+    const int pin = pinOf_(i);
+    const bool level = validPin_(pin) ? (digitalRead(pin) == HIGH) : true;
+    deb_[i].begin(level, nowUs, debounceMs * 1000UL);
+    active_[i]   = !level;   // "activo" = LOW (ver readHigh_)
+    changeMs_[i] = millis();
+  }
+
+  // La tarea antes que las ISR: así nunca se llena la cola sin consumidor
+  BaseType_t ok = xTaskCreatePinnedToCore(taskEntry_, "Levels", stackWords, this,
+                                          priority, &task_, core);
+  if (ok != pdPASS) {
+    task_ = nullptr;
+    return false;
+  }
+
+  for (uint8_t i = 0; i < N; ++i) {
+    isrCtx_[i] = {this, i, pinOf_(i)};
+    if (validPin_(isrCtx_[i].pin))
+      attachInterruptArg(digitalPinToInterrupt(isrCtx_[i].pin), isrEntry_, &isrCtx_[i], CHANGE);
+  }
+  return true;
+}
+
+void LevelSensorsManager::setEventCallback(LevelEventCallback cb, void* ctx) {
+  taskENTER_CRITICAL(&mux_);
+  cb_ = cb;
+  cbCtx_ = ctx;
+  taskEXIT_CRITICAL(&mux_);
+}
+
+// Solo marca tiempo y nivel; todo lo demás en la tarea
+void IRAM_ATTR LevelSensorsManager::isrEntry_(void* arg) {
+  IsrCtx* c = static_cast<IsrCtx*>(arg);
+  RawEdge e;
+  e.id    = c->id;
+  e.level = (uint8_t)gpio_get_level((gpio_num_t)c->pin);
+  e.tUs   = (uint32_t)esp_timer_get_time();
+
+  BaseType_t woken = pdFALSE;
+  if (xQueueSendFromISR(c->self->rawQ_, &e, &woken) != pdTRUE) c->self->overruns_++;
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void LevelSensorsManager::taskEntry_(void* self) {
+  static_cast<LevelSensorsManager*>(self)->run_();
+}
+
+void LevelSensorsManager::run_() {
+  for (;;) {
+    // Duerme hasta el próximo flanco o hasta que venza un antirrebote
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    uint32_t waitUs = LevelDebouncer::NONE;
+    for (uint8_t i = 0; i < N; ++i) {
+      const uint32_t w = deb_[i].pendingUs(nowUs);
+      if (w < waitUs) waitUs = w;
+    }
+    TickType_t wait = pdMS_TO_TICKS(1000);   // sin nada pendiente: resincroniza cada 1 s
+    if (waitUs != LevelDebouncer::NONE) wait = (TickType_t)((waitUs + portTICK_PERIOD_MS * 1000 - 1) /
+                                                            (portTICK_PERIOD_MS * 1000));
+
+    RawEdge e;
+    if (xQueueReceive(rawQ_, &e, wait) == pdTRUE) {
+      do { deb_[e.id].edge(e.level != 0, e.tUs); } while (xQueueReceive(rawQ_, &e, 0) == pdTRUE);
+    }
+
+    nowUs = (uint32_t)esp_timer_get_time();
+    for (uint8_t i = 0; i < N; ++i) {
+      // Flanco perdido (cola llena o ISR tardía): el pin manda
+      const int pin = pinOf_(i);
+      if (validPin_(pin) && deb_[i].pendingUs(nowUs) == LevelDebouncer::NONE) {
+        const bool level = gpio_get_level((gpio_num_t)pin) != 0;
+        if (level != deb_[i].raw()) deb_[i].edge(level, nowUs);
+      }
+
+      LevelEdge out;
+      if (deb_[i].poll(nowUs, out)) publish_(i, out, nowUs);
+    }
+  }
+}
+
+void LevelSensorsManager::publish_(uint8_t id, const LevelEdge& e, uint32_t nowUs) {
+  LevelEvent ev;
+  ev.id        = (LevelSensorId)id;
+  ev.active    = !e.level;
+  ev.latencyUs = nowUs - e.tUs;
+  ev.ms        = millis() - ev.latencyUs / 1000UL;
+
+  taskENTER_CRITICAL(&mux_);
+  active_[id]   = ev.active;
+  changeMs_[id] = ev.ms;
+  if (ev.latencyUs > maxLatencyUs_) maxLatencyUs_ = ev.latencyUs;
+  const uint8_t slot = (uint8_t)((evHead_[id] + evCount_[id]) % EVENT_DEPTH);
+  events_[id][slot] = ev;
+  if (evCount_[id] < EVENT_DEPTH) evCount_[id]++;
+  else evHead_[id] = (uint8_t)((evHead_[id] + 1) % EVENT_DEPTH);   // pisa el más viejo
+  LevelEventCallback cb = cb_;
+  void* ctx = cbCtx_;
+  taskEXIT_CRITICAL(&mux_);
+
+  if (cb) cb(ev, ctx);
+}
+
+bool LevelSensorsManager::popEvent(LevelSensorId id, LevelEvent& e) {
+  const uint8_t i = (uint8_t)id;
+  if (i >= N) return false;
+  taskENTER_CRITICAL(&mux_);
+  const bool ok = evCount_[i] > 0;
+  if (ok) {
+    e = events_[i][evHead_[i]];
+    evHead_[i] = (uint8_t)((evHead_[i] + 1) % EVENT_DEPTH);
+    evCount_[i]--;
+  }
+  taskEXIT_CRITICAL(&mux_);
+  return ok;
+}
+
+uint32_t LevelSensorsManager::lastChangeMs(LevelSensorId id) const {
+  const uint8_t i = (uint8_t)id;
+  return i < N ? changeMs_[i] : 0;
+}
+
+uint32_t LevelSensorsManager::stackFreeMin() const {
+  return task_ ? (uint32_t)uxTaskGetStackHighWaterMark(task_) : 0;
+}
+
+uint32_t LevelSensorsManager::bounces(LevelSensorId id) const {
+  const uint8_t i = (uint8_t)id;
+  return (i < N && task_) ? deb_[i].bounces() : 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <Arduino.h>
+#include "level_debounce.h"
 
 /*
   level_sensors_manager
@@ -11,6 +12,11 @@
       pH  -> 27
       KCL -> 32
       H2O -> 33
+  - beginEvents(): modo por interrupciones. La ISR (CHANGE) marca cada
+    flanco con esp_timer y lo encola; una tarea aplica el antirrebote
+    (LevelDebouncer), publica el estado y un evento por sensor y llama al
+    callback al instante, sin esperar al poll de la UI. Sin beginEvents()
+    las lecturas siguen siendo digitalRead directo.
 */
 
 enum class LevelSensorId : uint8_t {
@@ -21,6 +27,16 @@ enum class LevelSensorId : uint8_t {
   COUNT
 };
 
+struct LevelEvent {
+  LevelSensorId id = LevelSensorId::O2;
+  bool     active = false;    // estado nuevo (true = activo)
+  uint32_t ms = 0;            // millis() del primer flanco (captura en la ISR)
+  uint32_t latencyUs = 0;     // del flanco a la publicación (incluye antirrebote)
+};
+
+// Corre en la tarea de niveles: corto y sin bloquear
+typedef void (*LevelEventCallback)(const LevelEvent& e, void* ctx);
+
 class LevelSensorsManager {
 public:
   LevelSensorsManager() = default;
@@ -41,6 +57,26 @@ public:
   // Lectura por ID (útil para bucles)
   bool read(LevelSensorId id) const;
 
+  // --- Modo por interrupciones (llamar después de begin) ---
+  // La pila cubre el callback (PCF8574 por I2C con verificación, esp_timer
+  // y la cola de la UART): 2048 quedaba justo; ver stackFreeMin()
+  bool beginEvents(uint32_t debounceMs = 20, uint8_t core = 1, UBaseType_t priority = 3,
+                   uint32_t stackWords = 4096);
+  bool eventsEnabled() const { return task_ != nullptr; }
+  void setEventCallback(LevelEventCallback cb, void* ctx);
+
+  // Cola por sensor: eventos aún no leídos (se pisan los más viejos)
+  bool popEvent(LevelSensorId id, LevelEvent& e);
+
+  // millis() del primer flanco del último cambio confirmado
+  uint32_t lastChangeMs(LevelSensorId id) const;
+
+  // Diagnóstico
+  uint32_t maxLatencyUs() const { return maxLatencyUs_; }
+  uint32_t bounces(LevelSensorId id) const;
+  uint32_t overruns() const { return overruns_; }   // flancos perdidos (cola de la ISR llena)
+  uint32_t stackFreeMin() const;                     // mínimo de pila libre de la tarea (0 sin tarea)
+
   // Pines actuales
   inline int pinO2()  const { return pinO2_;  }
   inline int pinPH()  const { return pinPH_;  }
@@ -55,4 +91,33 @@ private:
 
   static inline bool validPin_(int pin) { return pin >= 0; }
   static inline bool readHigh_(int pin) { return digitalRead(pin) == LOW; }
+
+  // --- Modo por interrupciones ---
+  static constexpr uint8_t N = (uint8_t)LevelSensorId::COUNT;
+  static constexpr uint8_t EVENT_DEPTH = 4;
+
+  struct RawEdge { uint8_t id; uint8_t level; uint32_t tUs; };
+  struct IsrCtx  { LevelSensorsManager* self; uint8_t id; int pin; };
+
+  IsrCtx             isrCtx_[N];
+  QueueHandle_t      rawQ_ = nullptr;
+  TaskHandle_t       task_ = nullptr;
+  LevelDebouncer     deb_[N];               // solo la tarea
+  volatile bool      active_[N] = {false, false, false, false};
+  volatile uint32_t  changeMs_[N] = {0, 0, 0, 0};
+  volatile uint32_t  maxLatencyUs_ = 0;
+  volatile uint32_t  overruns_ = 0;
+
+  LevelEvent         events_[N][EVENT_DEPTH];
+  uint8_t            evHead_[N] = {0, 0, 0, 0};
+  uint8_t            evCount_[N] = {0, 0, 0, 0};
+  LevelEventCallback cb_ = nullptr;
+  void*              cbCtx_ = nullptr;
+  mutable portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+
+  int pinOf_(uint8_t id) const;
+  static void IRAM_ATTR isrEntry_(void* arg);
+  static void taskEntry_(void* self);
+  void run_();
+  void publish_(uint8_t id, const LevelEdge& e, uint32_t nowUs);
 };
@@ -0,0 +1,87 @@
+#include "button_driver.h"
+#include <driver/gpio.h>
+#include <esp_timer.h>
+
+bool ButtonDriver::begin(const uint8_t* pins, uint8_t n, uint8_t repeatMask,
+                         uint8_t core, UBaseType_t priority) {
+  if (task_) return true;
+  if (n == 0 || n > MAX_BUTTONS) return false;
+  n_ = n;
+
+  rawQ_ = xQueueCreate(32, sizeof(RawEdge));
+  evQ_  = xQueueCreate(16, sizeof(ButtonEvent));
+  if (!rawQ_ || !evQ_) return false;
+
+  const uint32_t nowUs = (uint32_t)esp_timer_get_time();
+  for (uint8_t i = 0; i < n_; ++i) {
+    ButtonFsmConfig cfg;
+    cfg.repeat = (repeatMask >> i) & 1u;
+    fsm_[i].begin(cfg, digitalRead(pins[i]) == HIGH, nowUs);
+    isrCtx_[i] = {this, i, pins[i]};
+  }
+
+  BaseType_t ok = xTaskCreatePinnedToCore(taskEntry_, "Buttons", 2048, this,
+                                          priority, &task_, core);
+  if (ok != pdPASS) {
+    task_ = nullptr;
+    return false;
+  }
+  for (uint8_t i = 0; i < n_; ++i)
+    attachInterruptArg(digitalPinToInterrupt(pins[i]), isrEntry_, &isrCtx_[i], CHANGE);
+  return true;
+}
+
+bool ButtonDriver::next(ButtonEvent& e, TickType_t wait) {
+  return evQ_ && xQueueReceive(evQ_, &e, wait) == pdTRUE;
+}
+
+void IRAM_ATTR ButtonDriver::isrEntry_(void* arg) {
+  IsrCtx* c = static_cast<IsrCtx*>(arg);
+  RawEdge e;
+  e.id    = c->id;
+  e.level = (uint8_t)gpio_get_level((gpio_num_t)c->pin);
+  e.tUs   = (uint32_t)esp_timer_get_time();
+
+  BaseType_t woken = pdFALSE;
+  if (xQueueSendFromISR(c->self->rawQ_, &e, &woken) != pdTRUE) c->self->overruns_++;
+  if (woken) portYIELD_FROM_ISR();
+}
+
+void ButtonDriver::taskEntry_(void* self) {
+  static_cast<ButtonDriver*>(self)->run_();
+}
+
+void ButtonDriver::run_() {
+  for (;;) {
+    // Duerme hasta el próximo flanco, antirrebote, LONG o REPEAT
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    uint32_t waitUs = ButtonFsm::NONE;
+    for (uint8_t i = 0; i < n_; ++i) {
+      const uint32_t w = fsm_[i].nextUs(nowUs);
+      if (w < waitUs) waitUs = w;
+    }
+    TickType_t wait = pdMS_TO_TICKS(1000);   // sin nada pendiente: resincroniza cada 1 s
+    if (waitUs != ButtonFsm::NONE) wait = (TickType_t)((waitUs + portTICK_PERIOD_MS * 1000 - 1) /
+                                                       (portTICK_PERIOD_MS * 1000));
+
+    RawEdge r;
+    if (xQueueReceive(rawQ_, &r, wait) == pdTRUE) {
+      do { fsm_[r.id].edge(r.level != 0, r.tUs); } while (xQueueReceive(rawQ_, &r, 0) == pdTRUE);
+    }
+
+    nowUs = (uint32_t)esp_timer_get_time();
+    for (uint8_t i = 0; i < n_; ++i) {
+      // Flanco perdido: el pin manda
+      if (!fsm_[i].settling()) {
+        const bool level = gpio_get_level((gpio_num_t)isrCtx_[i].pin) != 0;
+        if (level != fsm_[i].raw()) fsm_[i].edge(level, nowUs);
+      }
+
+      ButtonEvent e;
+      e.id = i;
+      while (fsm_[i].poll(nowUs, e.type, e.tUs)) {
+        if (xQueueSend(evQ_, &e, 0) != pdTRUE) dropped_++;
+      }
+    }
+  }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <Arduino.h>
+#include "button_fsm.h"
+
+/*
+  button_driver
+  -------------
+  - Botones por interrupción: la ISR (CHANGE) marca cada flanco con
+    esp_timer y lo encola; una tarea corre ButtonFsm por botón y publica
+    ButtonEvent en una cola de FreeRTOS.
+  - Lo pulsado durante un splash o una lectura bloqueante queda en la cola
+    hasta que la UI la consuma (se pierde solo si se llena).
+  - Pines con pull-up (externa en 34-39): pulsado = LOW.
+*/
+
+struct ButtonEvent {
+  uint8_t         id = 0;           // índice en el arreglo de begin()
+  ButtonEventType type = ButtonEventType::PRESS;
+  uint32_t        tUs = 0;          // esp_timer del primer flanco (ISR)
+};
+
+class ButtonDriver {
+public:
+  static constexpr uint8_t MAX_BUTTONS = 4;
+
+  // repeatMask: bit i = el botón i autorepite mientras se mantiene
+  bool begin(const uint8_t* pins, uint8_t n, uint8_t repeatMask = 0,
+             uint8_t core = 1, UBaseType_t priority = 3);
+  bool running() const { return task_ != nullptr; }
+
+  // Próximo evento (wait = 0: no bloquea)
+  bool next(ButtonEvent& e, TickType_t wait = 0);
+
+  // Diagnóstico
+  uint32_t dropped() const { return dropped_; }     // cola de eventos llena
+  uint32_t overruns() const { return overruns_; }   // cola de la ISR llena
+
+private:
+  struct RawEdge { uint8_t id; uint8_t level; uint32_t tUs; };
+  struct IsrCtx  { ButtonDriver* self; uint8_t id; uint8_t pin; };
+
+  uint8_t           n_ = 0;
+  IsrCtx            isrCtx_[MAX_BUTTONS];
+  ButtonFsm         fsm_[MAX_BUTTONS];        // solo la tarea
+  QueueHandle_t     rawQ_ = nullptr;
+  QueueHandle_t     evQ_ = nullptr;
+  TaskHandle_t      task_ = nullptr;
+  volatile uint32_t dropped_ = 0;
+  volatile uint32_t overruns_ = 0;
+
+  static void IRAM_ATTR isrEntry_(void* arg);
+  static void taskEntry_(void* self);
+  void run_();
+};
@@ -0,0 +1,81 @@
+#include "button_fsm.h"
+
+void ButtonFsm::begin(const ButtonFsmConfig& cfg, bool level, uint32_t nowUs) {
+  cfg_ = cfg;
+  raw_ = level;
+  pressed_ = isPressed_(level);
+  burst_ = false;
+  burstUs_ = lastUs_ = pressUs_ = nowUs;
+  nextRepeatUs_ = nowUs + cfg_.repeatDelayUs;
+  longSent_ = pressed_;   // pulsado al arrancar: no dispara LONG
+  bounces_ = 0;
+}
+
+void ButtonFsm::edge(bool level, uint32_t tUs) {
+  if (level == raw_) return;
+  raw_ = level;
+  lastUs_ = tUs;
+  if (!burst_) {
+    burst_ = true;
+    burstUs_ = tUs;
+  }
+}
+
+bool ButtonFsm::poll(uint32_t nowUs, ButtonEventType& type, uint32_t& tUs) {
+  // 1) Antirrebote
+  if (burst_ && nowUs - lastUs_ >= cfg_.debounceUs) {
+    burst_ = false;
+    const bool p = isPressed_(raw_);
+    if (p == pressed_) {
+      bounces_++;
+    } else {
+      pressed_ = p;
+      tUs = burstUs_;
+      if (p) {
+        pressUs_ = burstUs_;
+        nextRepeatUs_ = burstUs_ + cfg_.repeatDelayUs;
+        longSent_ = false;
+        type = ButtonEventType::PRESS;
+      } else {
+        type = ButtonEventType::RELEASE;
+      }
+      return true;
+    }
+  }
+
+  // 2) Mantenido (sin flancos pendientes: una ráfaga puede ser el soltar)
+  if (!pressed_ || burst_) return false;
+  if (!longSent_ && nowUs - pressUs_ >= cfg_.longUs) {
+    longSent_ = true;
+    type = ButtonEventType::LONG;
+    tUs = pressUs_ + cfg_.longUs;
+    return true;
+  }
+  if (cfg_.repeat && (int32_t)(nowUs - nextRepeatUs_) >= 0) {
+    type = ButtonEventType::REPEAT;
+    tUs = nextRepeatUs_;
+    nextRepeatUs_ += cfg_.repeatUs;
+    return true;
+  }
+  return false;
+}
+
+uint32_t ButtonFsm::nextUs(uint32_t nowUs) const {
+  if (burst_) {
+    const uint32_t quiet = nowUs - lastUs_;
+    return quiet >= cfg_.debounceUs ? 0 : cfg_.debounceUs - quiet;
+  }
+  if (!pressed_) return NONE;
+
+  uint32_t w = NONE;
+  if (!longSent_) {
+    const uint32_t held = nowUs - pressUs_;
+    w = held >= cfg_.longUs ? 0 : cfg_.longUs - held;
+  }
+  if (cfg_.repeat) {
+    const int32_t d = (int32_t)(nextRepeatUs_ - nowUs);
+    const uint32_t r = d <= 0 ? 0 : (uint32_t)d;
+    if (r < w) w = r;
+  }
+  return w;
+}
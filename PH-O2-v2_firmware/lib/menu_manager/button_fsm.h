@@ -0,0 +1,64 @@
+#ifndef BUTTON_FSM_H
+#define BUTTON_FSM_H
+
+#include <stdint.h>
+
+// =====================================================
+// Máquina de estados de un botón (antirrebote + eventos)
+//  - Se alimenta con los flancos crudos de la ISR (nivel + µs de esp_timer)
+//    y con poll() desde la tarea que los consume
+//  - Un cambio vale cuando el nivel queda quieto debounceUs; el evento
+//    lleva el tiempo del primer flanco de la ráfaga
+//  - PRESS / RELEASE; LONG una vez si se mantiene longUs; REPEAT cada
+//    repeatUs tras repeatDelayUs (solo si repeat = true)
+//  - Tiempos uint32 en µs con resta sin signo
+//  - Sin dependencias de Arduino (se prueba en host)
+// =====================================================
+
+enum class ButtonEventType : uint8_t { PRESS, RELEASE, LONG, REPEAT };
+
+struct ButtonFsmConfig {
+  uint32_t debounceUs    = 15000;
+  uint32_t longUs        = 800000;
+  uint32_t repeatDelayUs = 500000;
+  uint32_t repeatUs      = 150000;
+  bool     repeat        = false;
+  bool     activeLow     = true;    // pull-up: pulsado = LOW
+};
+
+class ButtonFsm {
+public:
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+  void begin(const ButtonFsmConfig& cfg, bool level, uint32_t nowUs);
+
+  // Flanco crudo (en orden; los repetidos se ignoran)
+  void edge(bool level, uint32_t tUs);
+
+  // Un evento por llamada: repetir hasta false
+  bool poll(uint32_t nowUs, ButtonEventType& type, uint32_t& tUs);
+
+  // µs hasta que poll() pueda tener algo (NONE = nada pendiente)
+  uint32_t nextUs(uint32_t nowUs) const;
+
+  bool     pressed() const { return pressed_; }
+  bool     raw() const { return raw_; }
+  bool     settling() const { return burst_; }   // flancos sin confirmar
+  uint32_t bounces() const { return bounces_; }
+
+private:
+  ButtonFsmConfig cfg_;
+  bool     raw_ = true;          // último flanco crudo
+  bool     pressed_ = false;     // estado confirmado
+  bool     burst_ = false;
+  uint32_t burstUs_ = 0;
+  uint32_t lastUs_ = 0;
+  uint32_t pressUs_ = 0;
+  uint32_t nextRepeatUs_ = 0;
+  bool     longSent_ = false;
+  uint32_t bounces_ = 0;
+
+  bool isPressed_(bool level) const { return cfg_.activeLow ? !level : level; }
+};
+
+#endif // BUTTON_FSM_H
@@ -1,5 +1,8 @@
 #include "menu_manager.h"
 #include "globals.h"
+#include "button_driver.h"
+#include "log_manager.h"
+#include <esp_timer.h>
 
 namespace Buttons {
 
@@ -9,6 +12,45 @@ namespace Buttons {
     Button BTN_OK(SW_OK);
     Button BTN_ESC(SW_ESC);
 
+  // Mismo orden que los pines de beginEvents()
+  static Button* const kButtons[] = {&BTN_DOWN, &BTN_UP, &BTN_OK, &BTN_ESC};
+  static ButtonDriver driver;
+  static uint32_t maxLatUs = 0;
+
+  bool beginEvents() {
+    const uint8_t pins[] = {SW_DOWN, SW_UP, SW_OK, SW_ESC};
+    return driver.begin(pins, 4, /*repeatMask=*/0b0011);   // DOWN y UP autorepiten
+  }
+
+  void pollEvents() {
+    ButtonEvent e;
+    while (driver.next(e)) {
+      Button& b = *kButtons[e.id];
+      switch (e.type) {
+        case ButtonEventType::PRESS:  b.value = 1; b.edge = 1; b.repeats = 0; b.tUs = e.tUs; break;
+        case ButtonEventType::REPEAT:
+          b.value = 1;
+          if (b.repeats < 255) b.repeats++;
+          if (!b.tUs) b.tUs = e.tUs;
+          break;
+        case ButtonEventType::LONG:   b.held = 1; if (!b.tUs) b.tUs = e.tUs; break;
+        default: break;
+      }
+    }
+  }
+
+  // Se mide cuando el handler suelta el latch, no al latchear: incluye lo
+  // que la UI tardó en llegar a leerlo (splash, lecturas bloqueantes)
+  void noteHandled(uint32_t tUs) {
+    const uint32_t lat = (uint32_t)esp_timer_get_time() - tUs;
+    if (lat > maxLatUs) {
+      maxLatUs = lat;
+      LOG_I(LogMod::MENU, "[BTN] latencia max evento->handler %.1f ms", lat / 1000.0f);
+    }
+  }
+
+  uint32_t maxLatencyUs() { return maxLatUs; }
+
 
   void testBuzzer(int buzzerPin, int durationMs) {
     pinMode(buzzerPin, OUTPUT);
@@ -23,27 +65,31 @@ namespace Buttons {
     unsigned long now = millis();
 
     // Actualiza: al detectar LOW estable, queda latcheado (value=1) y no cambia más
-    BTN_DOWN.update(now, debounceMs);
-    BTN_UP.update(now, debounceMs);
-    BTN_OK.update(now, debounceMs);
-    BTN_ESC.update(now, debounceMs);
+    if (driver.running()) {
+      pollEvents();
+    } else {
+      BTN_DOWN.update(now, debounceMs);
+      BTN_UP.update(now, debounceMs);
+      BTN_OK.update(now, debounceMs);
+      BTN_ESC.update(now, debounceMs);
+    }
 
     // Sonar una sola vez por cada latch (no vuelve a sonar hasta reset())
     if (BTN_DOWN.consumeEdge()) {
       testBuzzer(BUZZER, duration);
-      remoteManager.log("SW_DOWN pressed (latched)");
+      LOG_I(LogMod::MENU, "SW_DOWN pressed (latched)");
     }
     if(BTN_UP.consumeEdge()) {
       testBuzzer(BUZZER, duration);
-      remoteManager.log("SW_UP pressed (latched)");
+      LOG_I(LogMod::MENU, "SW_UP pressed (latched)");
     }
     if(BTN_OK.consumeEdge()) {
       testBuzzer(BUZZER, duration);
-      remoteManager.log("SW_OK pressed (latched)");
+      LOG_I(LogMod::MENU, "SW_OK pressed (latched)");
     }
     if(BTN_ESC.consumeEdge()) {
       testBuzzer(BUZZER, duration);
-      remoteManager.log("SW_ESC pressed (latched)");
+      LOG_I(LogMod::MENU, "SW_ESC pressed (latched)");
     }
 
     // Ejemplo de uso del latch:
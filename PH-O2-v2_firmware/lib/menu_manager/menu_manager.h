@@ -4,6 +4,10 @@
 
 namespace Buttons {
 
+  // El handler tomó un latch de la cola de eventos (tUs = esp_timer del
+  // evento): acumula la latencia evento → handler
+  void noteHandled(uint32_t tUs);
+
   // ====== Estructura de botón ======
   struct Button {
     uint8_t pin;
@@ -11,6 +15,9 @@ namespace Buttons {
     unsigned long lastMs = 0;       // último cambio estable (debounce)
     uint8_t value = 0;              // 1 = LATCHEADO (no cambia al soltar)
     uint8_t edge  = 0;              // 1 = hubo “clic” (flanco estable a LOW)
+    uint8_t held  = 0;              // 1 = pulsación larga (solo con beginEvents)
+    uint8_t repeats = 0;            // REPEAT desde el último PRESS (solo con beginEvents)
+    uint32_t tUs = 0;               // esp_timer del evento latcheado (0 = poll)
 
     explicit Button(uint8_t p) : pin(p) {}
 
@@ -41,8 +48,11 @@ namespace Buttons {
 
     // Limpia el LATCH manualmente y se rearma a partir del nivel actual
     void reset() {
+      if ((value || held) && tUs) noteHandled(tUs);
+      tUs = 0;
       value = 0;
       edge  = 0;
+      held  = 0;
       prev = digitalRead(pin);
       lastMs = millis();
     }
@@ -56,6 +66,13 @@ namespace Buttons {
 
   // Prototipos
   void testBuzzer(int buzzerPin, int durationMs);
-  void testButtons();
+  void testButtons();   // refresca los latch (poll o cola de eventos) y avisa cada clic
+
+  // Botones por interrupción (button_driver): la cola de eventos alimenta
+  // los mismos latch. PRESS → value/edge, REPEAT (UP/DOWN) → value y
+  // repeats, LONG → held. Sin beginEvents() se sigue leyendo por poll.
+  bool beginEvents();
+  void pollEvents();
+  uint32_t maxLatencyUs();   // flanco → reset() del handler que lo atendió
 
 } // namespace Buttons
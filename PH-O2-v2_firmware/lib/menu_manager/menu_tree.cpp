@@ -0,0 +1,273 @@
+#include "menu_tree.h"
+#include <stdio.h>
+#include <string.h>
+
+// ----------------------------
+// RenderCache
+// ----------------------------
+void RenderCache::begin(MenuDisplay* display, uint8_t cols, uint8_t rows) {
+  display_ = display;
+  cols_ = cols > MAX_COLS ? MAX_COLS : cols;
+  rows_ = rows > MAX_ROWS ? MAX_ROWS : rows;
+  invalidate();
+}
+
+void RenderCache::setLine(uint8_t row, const char* text) {
+  if (!display_ || row >= rows_) return;
+
+  char next[MAX_COLS + 1];
+  size_t len = text ? strlen(text) : 0;
+  if (len > cols_) len = cols_;
+  if (len) memcpy(next, text, len);
+  memset(next + len, ' ', cols_ - len);
+  next[cols_] = '\0';
+
+  // Solo el tramo entre el primer y el último carácter distinto
+  uint8_t first = 0, last = cols_;
+  if (valid_[row]) {
+    while (first < cols_ && next[first] == shown_[row][first]) ++first;
+    if (first == cols_) return;
+    while (last > first && next[last - 1] == shown_[row][last - 1]) --last;
+  }
+
+  char span[MAX_COLS + 1];
+  memcpy(span, next + first, last - first);
+  span[last - first] = '\0';
+  display_->write(first, row, span);
+  writes_++;
+  chars_ += last - first;
+
+  memcpy(shown_[row], next, cols_ + 1);
+  valid_[row] = true;
+}
+
+void RenderCache::invalidate() {
+  for (uint8_t r = 0; r < MAX_ROWS; ++r) valid_[r] = false;
+}
+
+void RenderCache::clear() {
+  if (!display_) return;
+  display_->clear();
+  for (uint8_t r = 0; r < rows_; ++r) {
+    memset(shown_[r], ' ', cols_);
+    shown_[r][cols_] = '\0';
+    valid_[r] = true;
+  }
+}
+
+// ----------------------------
+// MenuTree
+// ----------------------------
+void MenuTree::begin(const MenuPage* root, MenuDisplay* display,
+                     uint8_t cols, uint8_t rows, uint32_t nowMs) {
+  cache_.begin(display, cols, rows);
+  stack_[0] = {root, 0};
+  depth_ = 1;
+  open_ = nullptr;
+  noticeOn_ = false;
+  cache_.clear();
+  dirty_ = true;
+  tick(MenuKey::NONE, nowMs);
+}
+
+void MenuTree::tick(MenuKey key, uint32_t nowMs) {
+  if (!depth_) return;
+
+  // Aviso: expira solo o lo quita una tecla (que igual se procesa)
+  if (noticeOn_ && (key != MenuKey::NONE || (int32_t)(nowMs - noticeUntil_) >= 0)) {
+    noticeOn_ = false;
+    dirty_ = true;
+  }
+
+  // Acción en curso: es dueña de la pantalla y de los botones
+  if (busy()) {
+    const MenuAction* a = open_->action;
+    if (a->tick && !a->tick()) return;
+    if (a->onExit) a->onExit();
+    close_();
+    cache_.invalidate();   // la acción escribió por su cuenta
+  } else if (!noticeOn_) {
+    key_(key, nowMs);
+  }
+
+  // Refresco periódico de valores y vistas
+  if (open_ && refreshAt_ && (int32_t)(nowMs - refreshAt_) >= 0) {
+    dirty_ = true;
+    armRefresh_(nowMs);
+  }
+
+  if (dirty_ && !busy()) render_();
+}
+
+void MenuTree::open(const MenuItem* item, uint32_t nowMs) {
+  if (!item || busy()) return;
+  close_();
+  noticeOn_ = false;
+  enter_(item, nowMs);
+  if (dirty_ && !busy()) render_();
+}
+
+void MenuTree::notice(const char* l0, const char* l1, uint32_t ms, uint32_t nowMs) {
+  const uint8_t cols = cache_.cols();
+  const char* src[2] = {l0 ? l0 : "", l1 ? l1 : ""};
+  for (uint8_t i = 0; i < 2; ++i) {
+    size_t len = strlen(src[i]);
+    if (len > cols) len = cols;
+    const size_t pad = (cols - len) / 2;
+    memset(notice_[i], ' ', pad);
+    memcpy(notice_[i] + pad, src[i], len);
+    notice_[i][pad + len] = '\0';
+  }
+  noticeUntil_ = nowMs + ms;
+  noticeOn_ = true;
+  dirty_ = true;
+  if (!busy()) render_();
+}
+
+void MenuTree::key_(MenuKey key, uint32_t nowMs) {
+  if (key == MenuKey::NONE) return;
+
+  // ESC mantenido: descarta lo abierto y vuelve a la raíz
+  if (key == MenuKey::HOME) {
+    if (open_) close_();
+    depth_ = 1;
+    stack_[0].cursor = 0;
+    dirty_ = true;
+    return;
+  }
+
+  // La autorepetición rápida solo cambia el paso de un editor
+  const bool fast = (key == MenuKey::UP_FAST || key == MenuKey::DOWN_FAST);
+  if (key == MenuKey::UP_FAST)   key = MenuKey::UP;
+  if (key == MenuKey::DOWN_FAST) key = MenuKey::DOWN;
+  Level& lv = stack_[depth_ - 1];
+
+  // Editor de valor
+  if (open_ && open_->type == MenuItemType::VALUE) {
+    const MenuValue* v = open_->value;
+    const int32_t step = (int32_t)v->step * (fast ? FAST_STEPS : 1);
+    switch (key) {
+      case MenuKey::UP:
+        edit_ = (edit_ > v->max - step) ? v->max : (int16_t)(edit_ + step);
+        break;
+      case MenuKey::DOWN:
+        edit_ = (edit_ < v->min + step) ? v->min : (int16_t)(edit_ - step);
+        break;
+      case MenuKey::OK: {
+        *v->value = edit_;
+        const char* msg = v->onSave ? v->onSave(edit_) : nullptr;
+        const char* label = open_->label;
+        close_();
+        if (msg) notice(label, msg, NOTICE_MS, nowMs);
+      } break;
+      case MenuKey::ESC:
+        close_();
+        break;
+      default: break;
+    }
+    dirty_ = true;
+    return;
+  }
+
+  // Vista de lectura
+  if (open_ && open_->type == MenuItemType::VIEW) {
+    if (key == MenuKey::ESC) close_();
+    dirty_ = true;     // OK (o cualquier otra) refresca
+    return;
+  }
+
+  // Página
+  const uint8_t n = lv.page->count;
+  switch (key) {
+    case MenuKey::UP:
+      lv.cursor = (lv.cursor == 0) ? (uint8_t)(n - 1) : (uint8_t)(lv.cursor - 1);
+      dirty_ = true;
+      break;
+    case MenuKey::DOWN:
+      lv.cursor = (uint8_t)((lv.cursor + 1) % n);
+      dirty_ = true;
+      break;
+    case MenuKey::OK:
+      enter_(&lv.page->items[lv.cursor], nowMs);
+      break;
+    case MenuKey::ESC:
+      if (depth_ > 1) {
+        depth_--;
+        dirty_ = true;
+      }
+      break;
+    default: break;
+  }
+}
+
+void MenuTree::enter_(const MenuItem* item, uint32_t nowMs) {
+  switch (item->type) {
+    case MenuItemType::SUBMENU:
+      if (depth_ >= MAX_DEPTH || !item->page || !item->page->count) return;
+      stack_[depth_++] = {item->page, 0};
+      break;
+    case MenuItemType::ACTION:
+      open_ = item;
+      cache_.clear();
+      if (item->action->onEnter) item->action->onEnter();
+      return;   // el primer tick lo da tick()
+    case MenuItemType::VALUE:
+      open_ = item;
+      edit_ = *item->value->value;
+      armRefresh_(nowMs);
+      break;
+    case MenuItemType::VIEW:
+      open_ = item;
+      armRefresh_(nowMs);
+      break;
+  }
+  dirty_ = true;
+}
+
+void MenuTree::close_() {
+  open_ = nullptr;
+  refreshAt_ = 0;
+  dirty_ = true;
+}
+
+void MenuTree::armRefresh_(uint32_t nowMs) {
+  uint16_t ms = 0;
+  if (open_ && open_->type == MenuItemType::VALUE) ms = open_->value->refreshMs;
+  if (open_ && open_->type == MenuItemType::VIEW)  ms = open_->view->refreshMs;
+  refreshAt_ = ms ? (nowMs + ms) | 1u : 0;   // 0 = sin refresco
+}
+
+void MenuTree::render_() {
+  dirty_ = false;
+  const uint8_t rows = cache_.rows();
+  const uint8_t cols = cache_.cols();
+  char line[2][RenderCache::MAX_COLS + 1] = {};
+  uint8_t row = 0;
+
+  if (noticeOn_) {
+    cache_.setLine(row++, notice_[0]);
+    cache_.setLine(row++, notice_[1]);
+  } else if (open_ && open_->type == MenuItemType::VALUE) {
+    const MenuValue* v = open_->value;
+    if (v->header) v->header(line[0], cols + 1);
+    else snprintf(line[0], cols + 1, "%s", open_->label);
+    snprintf(line[1], cols + 1, v->fmt ? v->fmt : "%d", (int)edit_);
+    cache_.setLine(row++, line[0]);
+    cache_.setLine(row++, line[1]);
+  } else if (open_ && open_->type == MenuItemType::VIEW) {
+    open_->view->render(line[0], line[1], cols + 1);
+    cache_.setLine(row++, line[0]);
+    cache_.setLine(row++, line[1]);
+  } else {
+    // Título + ventana de ítems con el cursor marcado
+    const Level& lv = stack_[depth_ - 1];
+    const uint8_t win = rows > 1 ? (uint8_t)(rows - 1) : 1;
+    const uint8_t top = (uint8_t)(lv.cursor - lv.cursor % win);
+    if (rows > 1) cache_.setLine(row++, lv.page->title);
+    for (uint8_t i = top; i < top + win && i < lv.page->count; ++i) {
+      snprintf(line[0], cols + 1, "%c%s", i == lv.cursor ? '>' : ' ', lv.page->items[i].label);
+      cache_.setLine(row++, line[0]);
+    }
+  }
+  while (row < rows) cache_.setLine(row++, "");
+}
@@ -0,0 +1,166 @@
+#ifndef MENU_TREE_H
+#define MENU_TREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =====================================================
+// Menú declarativo para LCD de caracteres
+//  - El árbol es una tabla de páginas e ítems: submenú, acción, editor de
+//    valor y vista de lectura. Una página nueva = una entrada más
+//  - RenderCache recuerda lo que hay en pantalla y escribe solo el tramo de
+//    cada fila que cambió
+//  - Las acciones son ticks cooperativos (true = terminó): el menú las
+//    llama una vez por tick y nunca espera; los avisos tampoco bloquean
+//  - Sin dependencias de Arduino (se prueba en host con un display falso)
+// =====================================================
+
+// HOME = ESC mantenido (vuelve a la raíz); UP/DOWN_FAST = autorepetición
+// sostenida (en un editor de valor avanza FAST_STEPS pasos)
+enum class MenuKey : uint8_t { NONE, OK, ESC, UP, DOWN, HOME, UP_FAST, DOWN_FAST };
+
+// Destino de la escritura (el LCD en firmware, un buffer en host)
+class MenuDisplay {
+public:
+  virtual ~MenuDisplay() {}
+  virtual void clear() = 0;
+  // Escribe desde (col, row) sin tocar el resto de la fila
+  virtual void write(uint8_t col, uint8_t row, const char* text) = 0;
+};
+
+class RenderCache {
+public:
+  static constexpr uint8_t MAX_COLS = 20;
+  static constexpr uint8_t MAX_ROWS = 4;
+
+  void begin(MenuDisplay* display, uint8_t cols, uint8_t rows);
+
+  // Texto de la fila completa (se recorta/rellena a cols)
+  void setLine(uint8_t row, const char* text);
+
+  void invalidate();   // alguien más escribió: la próxima fila va completa
+  void clear();        // borra la pantalla y deja la caché en blanco
+
+  uint8_t  cols() const { return cols_; }
+  uint8_t  rows() const { return rows_; }
+  uint32_t writes() const { return writes_; }   // llamadas a write()
+  uint32_t chars() const { return chars_; }     // caracteres enviados
+
+private:
+  MenuDisplay* display_ = nullptr;
+  uint8_t  cols_ = 16;
+  uint8_t  rows_ = 2;
+  char     shown_[MAX_ROWS][MAX_COLS + 1] = {};
+  bool     valid_[MAX_ROWS] = {};
+  uint32_t writes_ = 0;
+  uint32_t chars_ = 0;
+};
+
+// ----- Ítems -----
+struct MenuPage;
+
+struct MenuAction {
+  bool (*tick)();           // true = terminó (vuelve a la página)
+  void (*onEnter)();        // opcional
+  void (*onExit)();         // opcional
+};
+
+// Entero con límites: UP/DOWN editan una copia, OK guarda, ESC descarta
+struct MenuValue {
+  int16_t*    value;
+  int16_t     min, max, step;
+  const char* fmt;                          // fila 1, p.ej. "Off:%+d"
+  void (*header)(char* out, size_t n);      // fila 0 (nullptr = etiqueta)
+  const char* (*onSave)(int16_t v);         // aviso tras OK (nullptr = ninguno)
+  uint16_t    refreshMs;                    // redibujo periódico (0 = no)
+};
+
+// Dos filas de solo lectura: OK refresca, ESC vuelve
+struct MenuView {
+  void (*render)(char* l0, char* l1, size_t n);
+  uint16_t refreshMs;                       // 0 = solo con OK
+};
+
+enum class MenuItemType : uint8_t { SUBMENU, ACTION, VALUE, VIEW };
+
+struct MenuItem {
+  const char*       label;
+  MenuItemType      type;
+  const MenuPage*   page;
+  const MenuAction* action;
+  const MenuValue*  value;
+  const MenuView*   view;
+
+  static constexpr MenuItem submenu(const char* l, const MenuPage* p) {
+    return {l, MenuItemType::SUBMENU, p, nullptr, nullptr, nullptr};
+  }
+  static constexpr MenuItem run(const char* l, const MenuAction* a) {
+    return {l, MenuItemType::ACTION, nullptr, a, nullptr, nullptr};
+  }
+  static constexpr MenuItem edit(const char* l, const MenuValue* v) {
+    return {l, MenuItemType::VALUE, nullptr, nullptr, v, nullptr};
+  }
+  static constexpr MenuItem show(const char* l, const MenuView* v) {
+    return {l, MenuItemType::VIEW, nullptr, nullptr, nullptr, v};
+  }
+};
+
+struct MenuPage {
+  const char*     title;
+  const MenuItem* items;
+  uint8_t         count;
+};
+
+template <size_t N>
+constexpr MenuPage menuPage(const char* title, const MenuItem (&items)[N]) {
+  return {title, items, (uint8_t)N};
+}
+
+// ----- Navegación -----
+class MenuTree {
+public:
+  static constexpr uint8_t  MAX_DEPTH = 6;
+  static constexpr uint32_t NOTICE_MS = 600;   // aviso tras guardar un valor
+  static constexpr int16_t  FAST_STEPS = 10;   // UP/DOWN_FAST en un editor
+
+  void begin(const MenuPage* root, MenuDisplay* display,
+             uint8_t cols, uint8_t rows, uint32_t nowMs);
+
+  // Una tecla (o NONE) por tick; corre la acción abierta y redibuja
+  void tick(MenuKey key, uint32_t nowMs);
+
+  // Abre un ítem desde fuera (p.ej. AUTO pedido por UART)
+  void open(const MenuItem* item, uint32_t nowMs);
+
+  // Aviso centrado que se quita solo o con cualquier tecla
+  void notice(const char* l0, const char* l1, uint32_t ms, uint32_t nowMs);
+
+  bool busy() const { return open_ && open_->type == MenuItemType::ACTION; }
+  bool atRoot() const { return depth_ == 1 && !open_; }
+  const MenuItem* active() const { return open_; }
+  const MenuPage* page() const { return stack_[depth_ - 1].page; }
+  uint8_t cursor() const { return stack_[depth_ - 1].cursor; }
+  const RenderCache& cache() const { return cache_; }
+
+private:
+  struct Level { const MenuPage* page; uint8_t cursor; };
+
+  RenderCache     cache_;
+  Level           stack_[MAX_DEPTH] = {};
+  uint8_t         depth_ = 0;
+  const MenuItem* open_ = nullptr;
+  int16_t         edit_ = 0;
+  bool            dirty_ = true;
+  uint32_t        refreshAt_ = 0;
+  char            notice_[2][RenderCache::MAX_COLS + 1] = {};
+  uint32_t        noticeUntil_ = 0;
+  bool            noticeOn_ = false;
+
+  void key_(MenuKey key, uint32_t nowMs);
+  void enter_(const MenuItem* item, uint32_t nowMs);
+  void close_();
+  void render_();
+  void armRefresh_(uint32_t nowMs);
+};
+
+#endif // MENU_TREE_H
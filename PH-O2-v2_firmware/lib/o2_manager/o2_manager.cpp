@@ -0,0 +1,175 @@
+#include "o2_manager.h"
+#include <string.h>
+#include "eeprom_manager.h"
+
+O2Manager::O2Manager(ADS1115Manager* ads, uint8_t ads_input, uint16_t sampleBudget)
+: ads_(ads), in_(ads_input) {
+  budget_.maxSamples = sampleBudget ? sampleBudget : 1;
+  budget_.minSamples = 8;
+  budget_.ciTarget   = 0.05f;   // ±0.05 mg/L (IC95)
+}
+
+bool O2Manager::begin() {
+  if (!ads_) {
+    setError_("ADS pointer null");
+    return false;
+  }
+  last_error_[0] = '\0';
+  return true;
+}
+
+void O2Manager::setError_(const char* msg) {
+  strncpy(last_error_, msg, sizeof(last_error_) - 1);
+  last_error_[sizeof(last_error_) - 1] = '\0';
+}
+
+// ===== Solubilidad (Benson & Krause 1984, USGS) =====
+float O2Manager::saturationMgL(float tempC, float pressureKPa) {
+  const float T  = tempC + 273.15f;
+  const float T2 = T * T;
+  const float lnC = -139.34411f + 1.575701e5f / T - 6.642308e7f / T2
+                  + 1.243800e10f / (T2 * T) - 8.621949e11f / (T2 * T2);
+  const float c1 = expf(lnC);                       // a 1 atm
+
+  // Corrección por presión (vapor de agua y no idealidad del O2)
+  const float P     = pressureKPa / 101.325f;       // atm
+  const float pwv   = expf(11.8571f - 3840.70f / T - 216961.0f / T2);
+  const float theta = 0.000975f - 1.426e-5f * tempC + 6.436e-8f * tempC * tempC;
+  return c1 * P * ((1.0f - pwv / P) * (1.0f - theta * P)) / ((1.0f - pwv) * (1.0f - theta));
+}
+
+float O2Manager::mgLPerVolt_(float tempC) const {
+  const float span = vsat_ - vzero_;
+  if (!isfinite(span) || fabsf(span) < 1e-6f) return NAN;
+  const float sT = span * expf(k_temp_ * (tempC - tcal_c_));
+  return saturationMgL(tempC, p_kpa_) / sT;
+}
+
+// ===== Estimador de voltaje =====
+bool O2Manager::beginVolts_(const PHSampleBudget& budget) {
+  if (!ads_) {
+    setError_("ADS pointer null");
+    return false;
+  }
+  est_.begin(budget, ads_->lsbVolts(in_));
+  step_fails_ = 0;
+  return true;
+}
+
+bool O2Manager::stepVolts(bool& done) {
+  done = est_.done();
+  if (done) return true;
+
+  float v;
+  if (!ads_->readConversion(in_, v)) {
+    if (++step_fails_ >= 3) {
+      setError_("ADS read fail");
+      done = true;
+      return false;
+    }
+    return true;
+  }
+  step_fails_ = 0;
+  done = est_.push(v);
+  return true;
+}
+
+bool O2Manager::measureVolts(const PHSampleBudget& budget, PHEstimate& out) {
+  if (!beginVolts_(budget)) return false;
+  bool done = false;
+  while (!done) {
+    if (!stepVolts(done)) return false;
+  }
+  out = est_.result();
+  if (out.count == 0) {
+    setError_("Sin conversiones válidas");
+    return false;
+  }
+  return true;
+}
+
+void O2Manager::setSampleBudget(uint16_t maxSamples, uint16_t minSamples, float ciMgL) {
+  budget_.maxSamples = maxSamples ? maxSamples : 1;
+  budget_.minSamples = minSamples;
+  budget_.ciTarget   = ciMgL > 0.0f ? ciMgL : 0.0f;
+}
+
+// ===== Lectura =====
+bool O2Manager::beginRead() {
+  // IC objetivo en mg/L -> voltios con la pendiente a Tcal
+  PHSampleBudget b = budget_;
+  const float k = mgLPerVolt_(tcal_c_);
+  b.ciTarget = (isfinite(k) && k > 0.0f) ? budget_.ciTarget / k : 0.0f;
+  return beginVolts_(b);
+}
+
+bool O2Manager::finishRead(float tempC, O2Reading& out) {
+  const PHEstimate& e = est_.result();
+  if (e.count == 0) {
+    setError_("Sin conversiones válidas");
+    return false;
+  }
+  if (!isCalibrated()) {
+    setError_("O2 sin calibrar");
+    return false;
+  }
+  const float k = mgLPerVolt_(tempC);
+  if (!isfinite(k)) {
+    setError_("Calibración O2 inválida");
+    return false;
+  }
+
+  const float mgL = (e.value - vzero_) * k;
+  out.mgL        = mgL > 0.0f ? mgL : 0.0f;
+  out.satPct     = 100.0f * out.mgL / saturationMgL(tempC, p_kpa_);
+  out.volts      = e.value;
+  out.noiseVolts = e.noise;
+  out.ci95MgL    = e.ci95 * fabsf(k);
+  out.samples    = e.count;
+  out.rejected   = e.rejected;
+  out.converged  = e.converged;
+  last_reading_  = out;
+  last_error_[0] = '\0';
+  return true;
+}
+
+bool O2Manager::readO2(float tempC, O2Reading& out) {
+  if (!beginRead()) return false;
+  bool done = false;
+  while (!done) {
+    if (!stepVolts(done)) return false;
+  }
+  return finishRead(tempC, out);
+}
+
+// ===== Calibración =====
+void O2Manager::setOnePointCalibration(float Vsat, float tCalC) {
+  vzero_  = 0.0f;
+  vsat_   = Vsat;
+  tcal_c_ = tCalC;
+  last_error_[0] = '\0';
+}
+
+bool O2Manager::setTwoPointCalibration(float Vzero, float Vsat, float tCalC) {
+  if (!isfinite(Vzero) || !isfinite(Vsat) || fabsf(Vsat - Vzero) < 1e-5f) {
+    setError_("Calibración inválida (Vsat≈Vzero)");
+    return false;
+  }
+  vzero_  = Vzero;
+  vsat_   = Vsat;
+  tcal_c_ = tCalC;
+  last_error_[0] = '\0';
+  return true;
+}
+
+bool O2Manager::applyEEPROMCalibration(const ConfigStore& eeprom) {
+  if (!eeprom.hasO2Cal()) return false;
+  float vz, vs, tc;
+  eeprom.getO2Cal(vz, vs, tc);
+  if (!(isfinite(tc) && tc > -40.0f && tc < 125.0f)) tc = 25.0f;
+  if (isnan(vz)) {
+    setOnePointCalibration(vs, tc);
+    return true;
+  }
+  return setTwoPointCalibration(vz, vs, tc);
+}
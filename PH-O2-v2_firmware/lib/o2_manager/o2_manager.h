@@ -0,0 +1,93 @@
+#ifndef O2_MANAGER_H
+#define O2_MANAGER_H
+
+#include <Arduino.h>
+#include <math.h>
+#include "ADS1115_manager.h"
+#include "ph_estimator.h"
+
+class ConfigStore;
+
+// Resultado de una lectura de oxígeno disuelto con su calidad
+struct O2Reading {
+  float    mgL = NAN;           // mg/L
+  float    satPct = NAN;        // % de saturación a la temperatura de la muestra
+  float    volts = NAN;         // señal de la sonda (diferencial)
+  float    noiseVolts = NAN;
+  float    ci95MgL = NAN;       // semiancho IC95 en mg/L
+  uint16_t samples = 0;
+  uint16_t rejected = 0;
+  bool     converged = false;
+};
+
+// =====================================================
+// Sonda de O2 galvánica/polarográfica en un par diferencial del ADS
+//  - Señal proporcional a la presión parcial de O2: S = V - Vzero
+//  - Calibración 1 punto (aire saturado, cero en 0 V) o 2 puntos (cero + aire)
+//  - Compensación de temperatura:
+//      * sensibilidad de la membrana: Ssat(T) = Ssat(Tcal) * exp(k (T - Tcal))
+//      * solubilidad: Cs(T, P) de Benson & Krause (agua dulce)
+//    mg/L = S / Ssat(T) * Cs(T, P)
+//  - Mismo estimador en streaming que PHManager (Hampel + IC95)
+// =====================================================
+
+class O2Manager {
+public:
+  explicit O2Manager(ADS1115Manager* ads,
+                     uint8_t ads_input = ADS1115Manager::IN_DIFF_23,
+                     uint16_t sampleBudget = 48);
+
+  bool begin();
+
+  bool readO2(float tempC, O2Reading& out);
+
+  // En pasos, para compartir la ventana del ADS con el pH
+  bool beginRead();
+  bool stepVolts(bool& done);
+  bool finishRead(float tempC, O2Reading& out);
+
+  // Presupuesto por lectura. ciMgL: semiancho IC95 objetivo (0 = usar todo)
+  void setSampleBudget(uint16_t maxSamples, uint16_t minSamples, float ciMgL);
+
+  // Solo voltaje (calibraciones). budget.ciTarget en VOLTIOS.
+  bool measureVolts(const PHSampleBudget& budget, PHEstimate& out);
+
+  // ===== Calibración =====
+  void setOnePointCalibration(float Vsat, float tCalC);               // aire saturado
+  bool setTwoPointCalibration(float Vzero, float Vsat, float tCalC);  // cero + aire
+  bool isCalibrated() const { return isfinite(vsat_); }
+  bool applyEEPROMCalibration(const ConfigStore& eeprom);
+
+  // ===== Compensación =====
+  void setTempCoeff(float perC) { k_temp_ = perC; }      // fracción/°C (típico 0.02..0.04)
+  void setPressureKPa(float kPa) { p_kpa_ = kPa > 10.0f ? kPa : 101.325f; }
+
+  // Solubilidad de O2 en agua dulce saturada de aire (mg/L)
+  static float saturationMgL(float tempC, float pressureKPa = 101.325f);
+
+  const O2Reading& lastReading() const { return last_reading_; }
+  const char* lastError() const { return last_error_; }
+
+private:
+  ADS1115Manager* ads_ = nullptr;
+  uint8_t in_ = ADS1115Manager::IN_DIFF_23;
+
+  PHSampleBudget budget_;        // ciTarget en mg/L
+  PHEstimator    est_;
+  uint8_t        step_fails_ = 0;
+  O2Reading      last_reading_;
+
+  float vzero_ = 0.0f;           // 1 punto => 0
+  float vsat_ = NAN;             // señal en aire saturado a Tcal
+  float tcal_c_ = 25.0f;
+  float k_temp_ = 0.03f;
+  float p_kpa_ = 101.325f;
+
+  char  last_error_[64] = {0};
+
+  void  setError_(const char* msg);
+  bool  beginVolts_(const PHSampleBudget& budget);
+  float mgLPerVolt_(float tempC) const;   // Cs(T) / Ssat(T)
+};
+
+#endif // O2_MANAGER_H
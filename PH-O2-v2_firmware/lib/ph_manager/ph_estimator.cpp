@@ -0,0 +1,93 @@
+#include "ph_estimator.h"
+
+static void sortSmall_(float* a, uint8_t n) {
+  for (uint8_t i = 1; i < n; ++i) {
+    float x = a[i];
+    int8_t j = i - 1;
+    while (j >= 0 && a[j] > x) { a[j + 1] = a[j]; --j; }
+    a[j + 1] = x;
+  }
+}
+
+static float medianSorted_(const float* a, uint8_t n) {
+  return (n & 1) ? a[n / 2] : 0.5f * (a[n / 2 - 1] + a[n / 2]);
+}
+
+void PHEstimator::begin(const PHSampleBudget& budget, float madFloor) {
+  budget_ = budget;
+  if (budget_.maxSamples == 0) budget_.maxSamples = 1;
+  if (budget_.minSamples > budget_.maxSamples) budget_.minSamples = budget_.maxSamples;
+  madFloor_ = madFloor > 0.0f ? madFloor : 0.0f;
+
+  win_n_ = win_i_ = 0;
+  warmup_ = 0;
+  shift_ = mean_ = m2_ = 0.0f;
+  est_ = PHEstimate();
+  done_ = false;
+}
+
+bool PHEstimator::isOutlier_(float x) const {
+  float s[WINDOW];
+  for (uint8_t i = 0; i < win_n_; ++i) s[i] = win_[i];
+  sortSmall_(s, win_n_);
+  const float med = medianSorted_(s, win_n_);
+
+  for (uint8_t i = 0; i < win_n_; ++i) s[i] = fabsf(win_[i] - med);
+  sortSmall_(s, win_n_);
+  float mad = medianSorted_(s, win_n_);
+  if (mad < madFloor_) mad = madFloor_;
+
+  return fabsf(x - med) > HAMPEL_K * 1.4826f * mad;
+}
+
+void PHEstimator::update_() {
+  const uint16_t n = est_.count;
+  est_.value = shift_ + mean_;
+  if (n >= 2) {
+    est_.noise = sqrtf(m2_ / (float)(n - 1));
+    est_.ci95  = 1.96f * est_.noise / sqrtf((float)n);
+  } else {
+    est_.noise = NAN;
+    est_.ci95  = NAN;
+  }
+}
+
+bool PHEstimator::push(float x) {
+  if (done_) return true;
+  if (!isfinite(x)) {
+    ++est_.rejected;
+  } else {
+    // Las primeras WARMUP solo llenan la ventana: sin mediana no hay con qué juzgarlas
+    const bool warm = (win_n_ >= WARMUP);
+    const bool outlier = warm && isOutlier_(x);
+
+    // La ventana Hampel ve todas las conversiones: un escalón real se acepta
+    // en cuanto domina la ventana
+    win_[win_i_] = x;
+    win_i_ = (uint8_t)((win_i_ + 1) % WINDOW);
+    if (win_n_ < WINDOW) ++win_n_;
+
+    if (!warm) {
+      ++warmup_;
+    } else if (outlier) {
+      ++est_.rejected;
+    } else {
+      if (est_.count == 0) shift_ = x;
+      const float y = x - shift_;
+      ++est_.count;
+      const float d = y - mean_;
+      mean_ += d / (float)est_.count;
+      m2_ += d * (y - mean_);
+      update_();
+    }
+  }
+
+  if (budget_.ciTarget > 0.0f && est_.count >= budget_.minSamples && est_.count >= 2 &&
+      est_.ci95 <= budget_.ciTarget) {
+    est_.converged = true;
+    done_ = true;
+  } else if (pushed() >= budget_.maxSamples) {
+    done_ = true;
+  }
+  return done_;
+}
@@ -0,0 +1,68 @@
+#ifndef PH_ESTIMATOR_H
+#define PH_ESTIMATOR_H
+
+#include <stdint.h>
+#include <math.h>
+
+// =====================================================
+// Estimador en streaming para lecturas de pH (o cualquier voltaje lento)
+//  - Filtro Hampel: descarta la muestra si se aleja más de K·1.4826·MAD
+//    de la mediana de las últimas WINDOW conversiones
+//  - Media y varianza (Welford) de las aceptadas
+//  - Presupuesto único de conversiones con salida temprana por IC95
+//  - Sin dependencias de Arduino (se prueba en host)
+// =====================================================
+
+struct PHSampleBudget {
+  uint16_t maxSamples = 48;    // tope de conversiones (aceptadas + descartadas)
+  uint16_t minSamples = 8;     // mínimo antes de evaluar la salida temprana
+  float    ciTarget   = 0.0f;  // semiancho IC95 objetivo; 0 => usa todo el presupuesto
+};
+
+struct PHEstimate {
+  float    value = NAN;        // media de las muestras aceptadas
+  float    noise = NAN;        // desviación estándar de las aceptadas
+  float    ci95  = NAN;        // semiancho del IC95 de value
+  uint16_t count = 0;          // aceptadas
+  uint16_t rejected = 0;       // descartadas por Hampel
+  bool     converged = false;  // terminó por IC (no por presupuesto)
+};
+
+class PHEstimator {
+public:
+  static constexpr uint8_t WINDOW   = 7;
+  static constexpr float   HAMPEL_K = 3.0f;
+  static constexpr uint8_t WARMUP   = 3;   // conversiones que solo llenan la ventana
+
+  // madFloor: MAD mínima (p.ej. 1 LSB) para no descartar todo con señal muy limpia
+  void begin(const PHSampleBudget& budget, float madFloor);
+
+  // Agrega una conversión. Retorna true cuando la estimación terminó.
+  bool push(float x);
+
+  bool done() const { return done_; }
+  uint16_t pushed() const { return (uint16_t)(est_.count + est_.rejected + warmup_); }
+  const PHEstimate& result() const { return est_; }
+
+private:
+  PHSampleBudget budget_;
+  float madFloor_ = 0.0f;
+
+  float   win_[WINDOW];
+  uint8_t win_n_ = 0;
+  uint8_t win_i_ = 0;
+  uint8_t warmup_ = 0;
+
+  // Welford desplazado por la primera muestra (evita cancelación en float)
+  float shift_ = 0.0f;
+  float mean_ = 0.0f;
+  float m2_ = 0.0f;
+
+  PHEstimate est_;
+  bool done_ = false;
+
+  bool isOutlier_(float x) const;
+  void update_();
+};
+
+#endif // PH_ESTIMATOR_H
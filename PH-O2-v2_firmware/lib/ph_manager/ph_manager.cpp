@@ -4,15 +4,18 @@
 // Opcional: si vas a usar applyEEPROMCalibration()
 #include "eeprom_manager.h"  // define ConfigStore v7 con hasPH3pt/hasPH2pt y getters
 
-PHManager::PHManager(ADS1115Manager* ads, uint8_t ads_channel, uint8_t avgSamples)
-: ads_(ads), ch_(ads_channel), avg_(avgSamples) {}
+PHManager::PHManager(ADS1115Manager* ads, uint8_t ads_channel, uint16_t sampleBudget)
+: ads_(ads), ch_(ads_channel) {
+  budget_.maxSamples = sampleBudget ? sampleBudget : 1;
+  budget_.minSamples = 8;
+  budget_.ciTarget   = 0.01f;   // ±0.01 pH (IC95)
+}
 
 bool PHManager::begin() {
   if (!ads_) {
     setError_("ADS pointer null");
     return false;
   }
-  if (avg_ == 0) avg_ = 1;
   last_error_[0] = '\0';
   model_ = CalModel::TWO_PT; // por defecto deja un modelo lineal válido
   return true;
@@ -24,25 +27,65 @@ void PHManager::setError_(const char* msg) {
   last_error_[sizeof(last_error_) - 1] = '\0';
 }
 
-bool PHManager::readAveragedVolts_(float& volts) {
+// ===== Estimador de voltaje =====
+bool PHManager::beginVolts(const PHSampleBudget& budget) {
   if (!ads_) {
     setError_("ADS pointer null");
     return false;
   }
-  float acc = 0.0f;
-  float v = 0.0f;
-  for (uint8_t i = 0; i < avg_; ++i) {
-    if (!ads_->readSingle(ch_, v)) {
+  // MAD mínima = 1 LSB: con señal muy limpia no se descarta por cuantización
+  est_.begin(budget, ads_->lsbVolts(ch_));
+  step_fails_ = 0;
+  return true;
+}
+
+bool PHManager::stepVolts(bool& done) {
+  done = est_.done();
+  if (done) return true;
+
+  float v;
+  if (!ads_->readConversion(ch_, v)) {
+    // Fallos sueltos no cortan la lectura; 3 seguidos sí
+    if (++step_fails_ >= 3) {
       setError_("ADS read fail");
+      done = true;
       return false;
     }
-    acc += v;
+    return true;
   }
-  volts = acc / (float)avg_;
-  last_volts_ = volts;
+  step_fails_ = 0;
+  done = est_.push(v);
   return true;
 }
 
+bool PHManager::measureVolts(const PHSampleBudget& budget, PHEstimate& out) {
+  if (!beginVolts(budget)) return false;
+  bool done = false;
+  while (!done) {
+    if (!stepVolts(done)) return false;
+  }
+  out = est_.result();
+  if (out.count == 0) {
+    setError_("Sin conversiones válidas");
+    return false;
+  }
+  last_volts_ = out.value;
+  return true;
+}
+
+float PHManager::slopeAbs_() const {
+  float a = NAN;
+  if (model_ == CalModel::THREE_PT_PW) a = fmaxf(fabsf(a1_pw_), fabsf(a2_pw_));
+  else                                 a = fabsf(a_cal_);
+  return (isfinite(a) && a > 1e-6f) ? a : 1.0f;
+}
+
+void PHManager::setSampleBudget(uint16_t maxSamples, uint16_t minSamples, float ciPH) {
+  budget_.maxSamples = maxSamples ? maxSamples : 1;
+  budget_.minSamples = minSamples;
+  budget_.ciTarget   = ciPH > 0.0f ? ciPH : 0.0f;
+}
+
 bool PHManager::evalLinearAt_(float volts, float tempC, float a_base, float b_base, float& ph_out) {
   const float TK_meas = kelvin_(tempC);
   const float TK_cal  = kelvin_(tcal_c_);
@@ -162,12 +205,56 @@ bool PHManager::build3ptPiecewise_(float V4, float V7, float V10, float tCalC) {
 
 // ===== Lectura con compensación de temperatura =====
 bool PHManager::readPH(float tempC, float& ph, float* voltsOut) {
-  float v;
-  if (!readAveragedVolts_(v)) {
+  PHReading r;
+  if (!readPH(tempC, r)) return false;
+  ph = r.ph;
+  if (voltsOut) *voltsOut = r.volts;
+  return true;
+}
+
+bool PHManager::readPH(float tempC, PHReading& out) {
+  if (!beginRead()) return false;
+  bool done = false;
+  while (!done) {
+    if (!stepVolts(done)) return false;
+  }
+  return finishRead(tempC, out);
+}
+
+bool PHManager::beginRead() {
+  // IC objetivo en pH -> voltios con la pendiente del modelo (a Tcal)
+  PHSampleBudget b = budget_;
+  b.ciTarget = budget_.ciTarget / slopeAbs_();
+  return beginVolts(b);
+}
+
+bool PHManager::finishRead(float tempC, PHReading& out) {
+  const PHEstimate& e = est_.result();
+  if (e.count == 0) {
+    setError_("Sin conversiones válidas");
     return false;
   }
-  if (voltsOut) *voltsOut = v;
+  last_volts_ = e.value;
+  const float slope = slopeAbs_();
+
+  float ph;
+  if (!evalPH_(e.value, tempC, ph)) return false;
+
+  // El ruido escala con la misma pendiente compensada que usa evalLinearAt_
+  const float slopeT = slope * kelvin_(tempC) / kelvin_(tcal_c_);
+  out.ph         = ph;
+  out.volts      = e.value;
+  out.noiseVolts = e.noise;
+  out.noisePH    = e.noise * slopeT;
+  out.ci95PH     = e.ci95 * slopeT;
+  out.samples    = e.count;
+  out.rejected   = e.rejected;
+  out.converged  = e.converged;
+  last_reading_  = out;
+  return true;
+}
 
+bool PHManager::evalPH_(float v, float tempC, float& ph) {
   switch (model_) {
     case CalModel::TWO_PT:
     case CalModel::THREE_PT_LS: {
@@ -212,7 +299,7 @@ bool PHManager::readPH(float tempC, float& ph, float* voltsOut) {
 // ===== Configuración varias =====
 void PHManager::setAveraging(uint8_t n) {
   if (n == 0) n = 1;
-  avg_ = n;
+  setSampleBudget(n, n, 0.0f);
 }
 void PHManager::setChannel(uint8_t ch) {
   ch_ = ch;
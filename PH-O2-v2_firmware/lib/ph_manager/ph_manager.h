@@ -4,22 +4,57 @@
 #include <Arduino.h>
 #include <math.h>
 #include "ADS1115_manager.h"
+#include "ph_estimator.h"
 
 // Forward decl opcional (para el helper que carga desde EEPROM v7)
 class ConfigStore;
 
+// Resultado de una lectura de pH con su calidad
+struct PHReading {
+  float    ph = NAN;
+  float    volts = NAN;
+  float    noiseVolts = NAN;    // desviación estándar de las conversiones aceptadas
+  float    noisePH = NAN;       // idem llevada a pH con la pendiente vigente
+  float    ci95PH = NAN;        // semiancho IC95 del pH
+  uint16_t samples = 0;         // conversiones aceptadas
+  uint16_t rejected = 0;        // descartadas por Hampel
+  bool     converged = false;   // salió antes de agotar el presupuesto
+};
+
 class PHManager {
 public:
+  // sampleBudget: tope de conversiones del ADS por lectura de pH
   explicit PHManager(ADS1115Manager* ads,
                      uint8_t ads_channel,
-                     uint8_t avgSamples = 8);
+                     uint16_t sampleBudget = 48);
 
   bool begin();
 
   // Lectura con compensación de temperatura:
   //  - Aplica pendiente reescalada: a_T = a_cal * (T_K / Tcal_K)
   //  - Mantiene el offset (b_cal) del modelo elegido (2pt/3pt).
+  //  - Voltaje: un único estimador en streaming (Hampel + media) sobre
+  //    conversiones sueltas del ADS, con presupuesto y salida temprana.
   bool readPH(float tempC, float& ph, float* volts = nullptr);
+  bool readPH(float tempC, PHReading& out);
+
+  // La misma lectura en pasos, para compartir la ventana del ADS con otra
+  // sonda (O2): beginRead(), stepVolts() hasta done, finishRead().
+  bool beginRead();
+  bool finishRead(float tempC, PHReading& out);
+
+  // Presupuesto por lectura. ciPH: semiancho IC95 objetivo en pH (0 = usar todo)
+  void setSampleBudget(uint16_t maxSamples, uint16_t minSamples, float ciPH);
+  const PHSampleBudget& sampleBudget() const { return budget_; }
+  const PHReading& lastReading() const { return last_reading_; }
+
+  // Solo voltaje (calibraciones). budget.ciTarget en VOLTIOS.
+  bool measureVolts(const PHSampleBudget& budget, PHEstimate& out);
+  // Igual, paso a paso (para mostrar progreso): beginVolts() y luego stepVolts()
+  // hasta done == true; el resultado queda en voltsEstimate().
+  bool beginVolts(const PHSampleBudget& budget);
+  bool stepVolts(bool& done);
+  const PHEstimate& voltsEstimate() const { return est_.result(); }
 
   // ===== Calibración 2 Puntos =====
   // Define una recta única pH = a*V + b (a temperatura tCalC).
@@ -42,7 +77,7 @@ public:
   bool isPiecewise3pt()      const { return model_ == CalModel::THREE_PT_PW; }
 
   // ===== Utilidades =====
-  void setAveraging(uint8_t n); // n>=1
+  void setAveraging(uint8_t n); // compat: presupuesto = n conversiones, sin salida temprana
   void setChannel(uint8_t ch);  // 0..3
 
   float lastPH()        const { return last_ph_;    }
@@ -56,7 +91,11 @@ public:
 private:
   ADS1115Manager* ads_ = nullptr;
   uint8_t ch_ = 0;
-  uint8_t avg_ = 8;
+
+  PHSampleBudget budget_;        // ciTarget en pH
+  PHEstimator    est_;
+  uint8_t        step_fails_ = 0;
+  PHReading      last_reading_;
 
   // === Modelos de calibración soportados ===
   enum class CalModel : uint8_t {
@@ -90,7 +129,8 @@ private:
 
   // Helpers
   void  setError_(const char* msg);
-  bool  readAveragedVolts_(float& volts);
+  bool  evalPH_(float volts, float tempC, float& ph);
+  float slopeAbs_() const;       // |dpH/dV| del modelo activo a Tcal
   float kelvin_(float c) const { return c + 273.15f; }
 
   // Construcción de modelos
@@ -0,0 +1,100 @@
+#include "stability_detector.h"
+
+void StabilityDetector::begin(const StabilityConfig& cfg, uint32_t t0_ms) {
+  cfg_ = cfg;
+  if (cfg_.holdMs > cfg_.windowMs) cfg_.windowMs = cfg_.holdMs;
+  t0_ = t0_ms;
+  head_ = n_ = 0;
+  drift_ = noise_ = last_x_ = NAN;
+  elapsed_ = 0;
+  holding_ = false;
+  hold_since_ = 0;
+  t_done_ = 0;
+  state_ = StabilityState::TRACKING;
+}
+
+void StabilityDetector::finish_(StabilityState s) {
+  state_ = s;
+  t_done_ = elapsed_;
+}
+
+StabilityState StabilityDetector::tick(uint32_t now_ms) {
+  if (done()) return state_;
+  elapsed_ = now_ms - t0_;
+  if (cfg_.maxMs && elapsed_ >= cfg_.maxMs) finish_(StabilityState::TIMEOUT);
+  return state_;
+}
+
+// Recta x = a + b·t sobre la ventana (t en minutos desde la muestra más vieja)
+void StabilityDetector::fit_(uint32_t now_ms) {
+  // Descarta por edad: las más viejas quedan al final del recorrido
+  uint8_t m = 0;
+  while (m < n_) {
+    const uint8_t i = (uint8_t)((head_ + CAPACITY - 1 - m) % CAPACITY);
+    if (now_ms - t_[i] > cfg_.windowMs) break;
+    ++m;
+  }
+  n_ = m;
+
+  drift_ = NAN;
+  noise_ = NAN;
+  if (n_ < 3) return;
+
+  const uint8_t oldest = (uint8_t)((head_ + CAPACITY - n_) % CAPACITY);
+  const uint8_t newest = (uint8_t)((head_ + CAPACITY - 1) % CAPACITY);
+  // La ventana tiene que estar casi llena para que la pendiente signifique algo
+  if (t_[newest] - t_[oldest] < (cfg_.windowMs * 3) / 4) return;
+
+  const float x0 = x_[oldest];
+  float st = 0, sx = 0, stt = 0, stx = 0;
+  for (uint8_t k = 0; k < n_; ++k) {
+    const uint8_t i = (uint8_t)((oldest + k) % CAPACITY);
+    const float t = (float)(t_[i] - t_[oldest]) / 60000.0f;
+    const float x = x_[i] - x0;
+    st += t; sx += x; stt += t * t; stx += t * x;
+  }
+  const float n = (float)n_;
+  const float den = n * stt - st * st;
+  if (den <= 0.0f) return;
+  const float b = (n * stx - st * sx) / den;
+  const float a = (sx - b * st) / n;
+
+  float ss = 0;
+  for (uint8_t k = 0; k < n_; ++k) {
+    const uint8_t i = (uint8_t)((oldest + k) % CAPACITY);
+    const float t = (float)(t_[i] - t_[oldest]) / 60000.0f;
+    const float r = (x_[i] - x0) - (a + b * t);
+    ss += r * r;
+  }
+  drift_ = b;
+  noise_ = sqrtf(ss / (n - 2.0f));
+}
+
+StabilityState StabilityDetector::push(uint32_t t_ms, float x) {
+  if (done()) return state_;
+  if (isfinite(x)) {
+    t_[head_] = t_ms;
+    x_[head_] = x;
+    head_ = (uint8_t)((head_ + 1) % CAPACITY);
+    if (n_ < CAPACITY) ++n_;
+    last_x_ = x;
+  }
+  fit_(t_ms);
+
+  const bool ok = isfinite(drift_) && fabsf(drift_) <= cfg_.driftLimit &&
+                  (cfg_.noiseLimit <= 0.0f || noise_ <= cfg_.noiseLimit);
+  if (!ok) {
+    holding_ = false;
+  } else if (!holding_) {
+    holding_ = true;
+    hold_since_ = t_ms;
+  }
+
+  elapsed_ = t_ms - t0_;
+  if (holding_ && t_ms - hold_since_ >= cfg_.holdMs && elapsed_ >= cfg_.minMs) {
+    finish_(StabilityState::STABLE);
+  } else if (cfg_.maxMs && elapsed_ >= cfg_.maxMs) {
+    finish_(StabilityState::TIMEOUT);
+  }
+  return state_;
+}
@@ -0,0 +1,88 @@
+#ifndef STABILITY_DETECTOR_H
+#define STABILITY_DETECTOR_H
+
+#include <stdint.h>
+#include <math.h>
+
+// =====================================================
+// Detector de estabilidad (punto final) para el voltaje de una sonda
+//  - Recta por mínimos cuadrados sobre las muestras de los últimos windowMs:
+//    pendiente (deriva, unidades/min) y ruido (desvío de los residuos)
+//  - "Estable" cuando |deriva| <= driftLimit (y ruido <= noiseLimit si se
+//    pide) se mantiene holdMs seguidos, nunca antes de minMs
+//  - maxMs es el tope: termina como TIMEOUT y el llamador sigue igual
+//  - Guarda hasta CAPACITY muestras: la ventana debe cubrirse con menos
+//    (p.ej. 15 s con una muestra cada >= 250 ms)
+//  - Sin dependencias de Arduino (se simula en host)
+// =====================================================
+
+struct StabilityConfig {
+  float    driftLimit = 0.0012f;   // |pendiente| máx por minuto (1.2 mV/min ≈ 0.02 pH/min)
+  float    noiseLimit = 0.0f;      // desvío máx de residuos; 0 = no se evalúa
+  uint32_t windowMs   = 15000;     // ventana de la regresión
+  uint32_t holdMs     = 5000;      // tiempo continuo bajo el umbral
+  uint32_t minMs      = 5000;      // no declarar estable antes
+  uint32_t maxMs      = 30000;     // tope (0 = sin tope)
+};
+
+enum class StabilityState : uint8_t { TRACKING, STABLE, TIMEOUT };
+
+// Muestra recién mezclada en el ciclo AUTO: el tiempo de estabilización
+// configurado pasa a ser el tope (0 = sin espera). No acorta mucho la
+// espera fija de antes (30 s): tras un escalón el electrodo tarda ~20 s en
+// bajar de 2 mV/min. Lo que cambia es que uno lento sigue hasta el tope en
+// vez de leerse a mitad de camino (bench/stability_step_test.cpp)
+inline StabilityConfig stabilityMixConfig(uint32_t maxMs) {
+  StabilityConfig c;
+  c.driftLimit = 0.0020f;   // 2 mV/min ≈ 0.034 pH/min
+  c.windowMs   = 10000;
+  c.holdMs     = 3000;
+  c.minMs      = 8000;
+  c.maxMs      = maxMs ? maxMs : 1;
+  return c;
+}
+
+class StabilityDetector {
+public:
+  static constexpr uint8_t CAPACITY = 64;
+
+  void begin(const StabilityConfig& cfg, uint32_t t0_ms);
+
+  // Agrega una muestra (t_ms no decreciente). Retorna el estado.
+  StabilityState push(uint32_t t_ms, float x);
+  // Solo avanza el reloj (p.ej. sin muestras nuevas): permite vencer maxMs
+  StabilityState tick(uint32_t now_ms);
+
+  StabilityState state() const { return state_; }
+  bool done() const { return state_ != StabilityState::TRACKING; }
+
+  float    driftPerMin() const { return drift_; }   // NAN hasta tener ventana
+  float    noise() const { return noise_; }
+  float    last() const { return last_x_; }
+  uint32_t elapsedMs() const { return elapsed_; }
+  uint32_t timeToStableMs() const { return t_done_; }   // elapsed al terminar (0 = sigue)
+  uint8_t  count() const { return n_; }
+
+private:
+  StabilityConfig cfg_;
+  uint32_t t0_ = 0;
+
+  uint32_t t_[CAPACITY];
+  float    x_[CAPACITY];
+  uint8_t  head_ = 0;   // próxima escritura
+  uint8_t  n_ = 0;
+
+  float    drift_ = NAN;
+  float    noise_ = NAN;
+  float    last_x_ = NAN;
+  uint32_t elapsed_ = 0;
+  bool     holding_ = false;
+  uint32_t hold_since_ = 0;
+  uint32_t t_done_ = 0;
+  StabilityState state_ = StabilityState::TRACKING;
+
+  void fit_(uint32_t now_ms);
+  void finish_(StabilityState s);
+};
+
+#endif // STABILITY_DETECTOR_H
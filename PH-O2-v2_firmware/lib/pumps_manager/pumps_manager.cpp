@@ -12,19 +12,25 @@ void PumpsManager::ensureWireBegun_() {
 }
 
 bool PumpsManager::write8(uint8_t value) {
+  lockTake_();
   ensureWireBegun_();
   Wire.beginTransmission(addr_);
   Wire.write(value);
   bool ok = (Wire.endTransmission(true) == 0);
+  writes_++;
   if (ok) shadow_ = value; // cache del último físico escrito
+  else    writeErrors_++;
+  lockGive_();
   return ok;
 }
 
 uint8_t PumpsManager::read8() {
+  lockTake_();
   ensureWireBegun_();
   uint8_t value = 0xFF;
   Wire.requestFrom((int)addr_, 1);
   if (Wire.available()) value = Wire.read();
+  lockGive_();
   return value;
 }
 
@@ -53,6 +59,18 @@ bool PumpsManager::begin(uint8_t addr, int sda, int scl, uint32_t i2cHz, bool ac
   i2cHz_      = i2cHz;
   activeHigh_ = activeHigh;
 
+  // Lock y timers antes del primer write
+  if (!lock_) lock_ = xSemaphoreCreateRecursiveMutex();
+  for (uint8_t i = 0; i < 8; ++i) {
+    if (timers_[i]) continue;
+    timerCtx_[i] = {this, i};
+    esp_timer_create_args_t args = {};
+    args.callback = &PumpsManager::onTimer_;
+    args.arg      = &timerCtx_[i];
+    args.name     = "pumpMaxOn";
+    esp_timer_create(&args, &timers_[i]);
+  }
+
   ensureWireBegun_();
 
   // Estado lógico inicial: todo OFF
@@ -74,8 +92,19 @@ void PumpsManager::off(PumpId id) { set(id, false); }
 void PumpsManager::set(PumpId id, bool enable) {
   uint8_t b = bitOf(id);
   if (b > 7) return;
+  lockTake_();
   states_[b] = enable;
-  rebuildAndWriteShadow_();
+  // Encender a mano deja sin efecto un corte todavía sin confirmar: sin
+  // reintento, y el tope vuelve a contar desde este on()
+  const uint8_t m = (uint8_t)(1u << b);
+  if (enable && (cutting_ & m)) {
+    cutting_ &= (uint8_t)~m;
+    cutPlanned_ &= (uint8_t)~m;
+    if (timers_[b]) esp_timer_stop(timers_[b]);
+    onMask_ &= (uint8_t)~m;
+  }
+  if (txDepth_ == 0) rebuildAndWriteShadow_();
+  lockGive_();
 }
 
 bool PumpsManager::isOn(PumpId id) const {
@@ -85,19 +114,214 @@ bool PumpsManager::isOn(PumpId id) const {
 }
 
 void PumpsManager::allOff() {
+  lockTake_();
   for (uint8_t i = 0; i < 8; ++i) states_[i] = false;
-  rebuildAndWriteShadow_();
+  if (txDepth_ == 0) rebuildAndWriteShadow_();
+  lockGive_();
 }
 
 void PumpsManager::setActiveHigh(bool activeHigh) {
+  lockTake_();
   activeHigh_ = activeHigh;
   // Re-aplica el shadow según la nueva política
-  rebuildAndWriteShadow_();
+  if (txDepth_ == 0) rebuildAndWriteShadow_();
+  lockGive_();
+}
+
+// ----------------------------
+// Transacciones
+// ----------------------------
+// El lock queda tomado hasta el commit: los set() de esta tarea se juntan,
+// los de otras esperan
+void PumpsManager::beginTx() {
+  lockTake_();
+  txDepth_++;
+}
+
+bool PumpsManager::commitTx() {
+  if (txDepth_ == 0) return false;   // commit sin begin
+  bool ok = true;
+  if (--txDepth_ == 0) ok = rebuildAndWriteShadow_();
+  lockGive_();
+  return ok;
+}
+
+// ----------------------------
+// Tope de encendido
+// ----------------------------
+void PumpsManager::setMaxOnMs(PumpId id, uint32_t ms) {
+  uint8_t b = bitOf(id);
+  if (b > 7) return;
+  lockTake_();
+  maxOnMs_[b] = ms;
+  // Un canal ya encendido se rearma con el tope nuevo desde ahora (salvo
+  // con un apagado agendado pendiente)
+  if (timers_[b] && (onMask_ & (1u << b)) && !(planned_ & (1u << b))) {
+    esp_timer_stop(timers_[b]);
+    if (ms) esp_timer_start_once(timers_[b], (uint64_t)ms * 1000ULL);
+  }
+  lockGive_();
+}
+
+uint32_t PumpsManager::maxOnMs(PumpId id) const {
+  uint8_t b = bitOf(id);
+  return (b > 7) ? 0 : maxOnMs_[b];
+}
+
+uint8_t PumpsManager::takeTripped() {
+  lockTake_();
+  const uint8_t t = tripped_;
+  tripped_ = 0;
+  lockGive_();
+  return t;
+}
+
+void PumpsManager::offAfterMs(PumpId id, uint32_t ms) {
+  uint8_t b = bitOf(id);
+  if (b > 7 || !timers_[b]) return;
+  if (ms == 0) { off(id); return; }
+  lockTake_();
+  // El tope corta antes si es menor: se deja
+  if ((onMask_ & (1u << b)) && (maxOnMs_[b] == 0 || ms < maxOnMs_[b])) {
+    esp_timer_stop(timers_[b]);
+    esp_timer_start_once(timers_[b], (uint64_t)ms * 1000ULL);
+    planned_ |= (uint8_t)(1u << b);
+  }
+  lockGive_();
+}
+
+void PumpsManager::cancelOffAfter(PumpId id) {
+  uint8_t b = bitOf(id);
+  if (b > 7 || !timers_[b]) return;
+  lockTake_();
+  if (planned_ & (1u << b)) {
+    planned_ &= (uint8_t)~(1u << b);
+    esp_timer_stop(timers_[b]);
+    if ((onMask_ & (1u << b)) && maxOnMs_[b])
+      esp_timer_start_once(timers_[b], (uint64_t)maxOnMs_[b] * 1000ULL);
+  }
+  lockGive_();
+}
+
+// Corre en la tarea de esp_timer: no puede quedarse esperando el lock
+void PumpsManager::onTimer_(void* arg) {
+  TimerCtx* c = static_cast<TimerCtx*>(arg);
+  c->self->forceOff_(c->ch);
+}
+
+void PumpsManager::forceOff_(uint8_t ch) {
+  if (lock_ && xSemaphoreTakeRecursive(lock_, 0) != pdTRUE) {
+    // El dueño del lock lo aplica al soltarlo (applyPending_); el reintento
+    // cubre a una tarea que se quede con el lock
+    taskENTER_CRITICAL(&pendMux_);
+    pendingOff_ |= (uint8_t)(1u << ch);
+    taskEXIT_CRITICAL(&pendMux_);
+    esp_timer_start_once(timers_[ch], RETRY_US);
+    return;
+  }
+  lockDepth_++;
+  taskENTER_CRITICAL(&pendMux_);
+  pendingOff_ &= (uint8_t)~(1u << ch);
+  taskEXIT_CRITICAL(&pendMux_);
+  applyOff_(ch);
+  lockGive_();
+}
+
+// Con el lock tomado. También reintenta un corte cuyo write falló (el
+// canal ya está apagado en states_ pero sigue en cutting_)
+void PumpsManager::applyOff_(uint8_t ch) {
+  const uint8_t m = (uint8_t)(1u << ch);
+  if (states_[ch]) {
+    states_[ch] = false;
+    cutting_ |= m;
+    if (planned_ & m) cutPlanned_ |= m;
+  }
+  planned_ &= (uint8_t)~m;
+  if (!(cutting_ & m)) return;
+  // En una transacción abierta el commit escribe con el resto
+  if (txDepth_ == 0) rebuildAndWriteShadow_();
+}
+
+// Después de cada write con cortes en curso: confirmado => se informan
+// (tripped_ / contadores); si no, siguen pendientes y el timer reintenta
+void PumpsManager::settleCuts_(bool written) {
+  const uint8_t cut = cutting_;
+  if (!cut) return;
+  if (!written) {
+    offWriteFails_++;
+    for (uint8_t i = 0; i < 8; ++i) {
+      if (!(cut & (1u << i)) || !timers_[i]) continue;
+      esp_timer_stop(timers_[i]);
+      esp_timer_start_once(timers_[i], RETRY_US);
+    }
+    return;
+  }
+  cutting_ = 0;
+  for (uint8_t i = 0; i < 8; ++i) {
+    const uint8_t m = (uint8_t)(1u << i);
+    if (!(cut & m) || states_[i]) continue;
+    if (cutPlanned_ & m) {
+      plannedOffs_++;
+    } else {
+      tripped_ |= m;
+      forcedOffs_++;
+    }
+  }
+  cutPlanned_ = 0;
+}
+
+// Cortes que el timer no pudo aplicar mientras el lock estaba tomado
+void PumpsManager::applyPending_() {
+  taskENTER_CRITICAL(&pendMux_);
+  const uint8_t pend = pendingOff_;
+  pendingOff_ = 0;
+  taskEXIT_CRITICAL(&pendMux_);
+  if (!pend) return;
+  applying_ = true;
+  for (uint8_t i = 0; i < 8; ++i) {
+    if (!(pend & (1u << i))) continue;
+    if (timers_[i]) esp_timer_stop(timers_[i]);   // el reintento ya no hace falta
+    applyOff_(i);
+  }
+  applying_ = false;
 }
 
 // ----------------------------
 // Internas
 // ----------------------------
+// Antes de begin() no hay lock (un solo contexto en el arranque)
+void PumpsManager::lockTake_() {
+  if (!lock_) return;
+  xSemaphoreTakeRecursive(lock_, portMAX_DELAY);
+  lockDepth_++;
+}
+
+// Al soltar el lock más externo (y sin transacción abierta) aplica los
+// cortes que el timer dejó pendientes
+void PumpsManager::lockGive_() {
+  if (!lock_) return;
+  if (lockDepth_ == 1 && txDepth_ == 0 && !applying_ && pendingOff_) applyPending_();
+  lockDepth_--;
+  xSemaphoreGiveRecursive(lock_);
+}
+
+// Arma el tope de los canales que pasaron a ON y desarma los que se apagaron
+void PumpsManager::armTimers_() {
+  uint8_t mask = 0;
+  for (uint8_t i = 0; i < 8; ++i) if (states_[i]) mask |= (uint8_t)(1u << i);
+  const uint8_t changed = mask ^ onMask_;
+  for (uint8_t i = 0; i < 8; ++i) {
+    if (!(changed & (1u << i)) || !timers_[i]) continue;
+    if (mask & (1u << i)) {
+      if (maxOnMs_[i]) esp_timer_start_once(timers_[i], (uint64_t)maxOnMs_[i] * 1000ULL);
+    } else {
+      esp_timer_stop(timers_[i]);
+      planned_ &= (uint8_t)~(1u << i);
+    }
+  }
+  onMask_ = mask;
+}
+
 // Construye el byte a escribir en PCF a partir de los estados lógicos.
 //  - Para cada canal: decide si el bit va en 1 o 0 según activeHigh_.
 //  - Evita I2C si el byte no cambió.
@@ -110,6 +334,29 @@ bool PumpsManager::rebuildAndWriteShadow_() {
   // 'next' quedó como b7..b0 (MSB primero); equivalente a armar:
   // next = (b7<<7)|(b6<<6)|...|(b0<<0)
 
-  if (next == shadow_) return true; // nada que escribir
-  return write8(next);
+  if (next == shadow_ && !shadowStale_) {   // nada que escribir
+    settleCuts_(true);
+    armTimers_();
+    return true;
+  }
+  bool ok = write8(next);
+
+  // Verificación: el PCF devuelve el nivel de sus pines; un reintento,
+  // también verificado
+  if (ok && verify_) {
+    verifies_++;
+    if (read8() != next) {
+      verifyFails_++;
+      ok = write8(next);
+      if (ok) {
+        verifies_++;
+        if (read8() != next) { verifyFails_++; ok = false; }
+      }
+    }
+  }
+  // Sin confirmar, el próximo rebuild escribe aunque el byte no cambie
+  shadowStale_ = !ok;
+  settleCuts_(ok);
+  if (ok) armTimers_();
+  return ok;
 }
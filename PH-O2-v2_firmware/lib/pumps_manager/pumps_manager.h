@@ -1,6 +1,7 @@
 #pragma once
 #include <Arduino.h>
 #include <Wire.h>
+#include <esp_timer.h>
 
 /*
   pumps_manager (fase 2)
@@ -11,6 +12,21 @@
       activeHigh = false → ON lógico escribe bit=0  (típico con ULN2803/relés activo-bajo)
   - SIN inversión especial para MIXER.
   - Se mantiene acceso de 8 bits (read8/write8) y control por canal.
+  - Transacciones: entre beginTx() y commitTx() los set/on/off/allOff solo
+    cambian el estado lógico; el commit hace UN write8 con todo el cambio.
+    El lock es recursivo y por tarea: otra tarea que toque las bombas
+    espera al commit.
+  - Tope de encendido por canal (setMaxOnMs): un esp_timer apaga el canal
+    aunque la tarea de control no corra. takeTripped() informa los cortes.
+    El callback nunca espera el lock: si otra tarea lo tiene (transacción
+    abierta o I2C en curso) deja el corte pendiente, lo aplica esa tarea al
+    soltar el lock y el timer reintenta cada 1 ms por las dudas.
+  - offAfterMs(): apagado agendado con el mismo esp_timer (corte por guarda
+    de la receta con HOLD); no cuenta como corte por tope.
+  - Cada escritura se verifica leyendo el PCF (setVerify(false) la omite).
+  - Un corte (tope o agendado) cuenta recién con el write confirmado; sin
+    ACK o con la verificación fallida el canal queda pendiente y su timer
+    reintenta cada 1 ms (offWriteFails() cuenta esos intentos).
 */
 
 enum class PumpId : uint8_t {
@@ -64,6 +80,29 @@ public:
   // Apaga todos los canales del módulo fijo (usa lógica activa global).
   void allOff();
 
+  // --- Transacciones (anidables; el commit más externo escribe)
+  void beginTx();
+  bool commitTx();
+
+  // --- Tope de encendido por canal (0 = sin tope). Se arma al encender.
+  void     setMaxOnMs(PumpId id, uint32_t ms);
+  uint32_t maxOnMs(PumpId id) const;
+  uint8_t  takeTripped();            // máscara de canales cortados por tope (y la limpia)
+
+  // --- Apagado agendado de un canal encendido (cancelOffAfter vuelve al tope)
+  void     offAfterMs(PumpId id, uint32_t ms);
+  void     cancelOffAfter(PumpId id);
+
+  // --- Contadores
+  void     setVerify(bool on) { verify_ = on; }
+  uint32_t writes() const      { return writes_; }       // write8 al PCF
+  uint32_t writeErrors() const { return writeErrors_; }  // sin ACK
+  uint32_t verifies() const    { return verifies_; }     // lecturas de verificación
+  uint32_t verifyFails() const { return verifyFails_; }  // leído != escrito
+  uint32_t forcedOffs() const  { return forcedOffs_; }   // cortes por tope
+  uint32_t plannedOffs() const { return plannedOffs_; }  // apagados agendados cumplidos
+  uint32_t offWriteFails() const { return offWriteFails_; } // cortes sin write confirmado (reintento)
+
   // Configura lógica en caliente y re-aplica el registro sombra.
   void setActiveHigh(bool activeHigh);
 
@@ -85,8 +124,46 @@ private:
   bool     states_[8]   = {false,false,false,false,false,false,false,false}; // ON lógico por canal
   uint8_t  shadow_      = 0xFF;        // último byte escrito al PCF (físico)
 
+  // --- Transacciones / tope
+  SemaphoreHandle_t  lock_ = nullptr;            // recursivo
+  uint8_t            txDepth_ = 0;
+  uint8_t            onMask_ = 0;                // canales ON en el último write
+  uint32_t           maxOnMs_[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  esp_timer_handle_t timers_[8] = {nullptr, nullptr, nullptr, nullptr,
+                                   nullptr, nullptr, nullptr, nullptr};
+  struct TimerCtx { PumpsManager* self; uint8_t ch; };
+  TimerCtx           timerCtx_[8];
+  volatile uint8_t   tripped_ = 0;
+  volatile uint8_t   planned_ = 0;               // timer armado por offAfterMs
+  volatile uint8_t   pendingOff_ = 0;            // cortes del timer esperando el lock
+  uint8_t            cutting_ = 0;               // cortes ya en states_, sin write confirmado
+  uint8_t            cutPlanned_ = 0;            // de esos, los agendados
+  bool               shadowStale_ = false;       // el último write no se confirmó
+  static constexpr uint64_t RETRY_US = 1000;
+  portMUX_TYPE       pendMux_ = portMUX_INITIALIZER_UNLOCKED;
+  uint8_t            lockDepth_ = 0;             // solo el dueño del lock
+  bool               applying_ = false;
+
+  // --- Contadores
+  bool              verify_ = true;
+  volatile uint32_t writes_ = 0;
+  volatile uint32_t writeErrors_ = 0;
+  volatile uint32_t verifies_ = 0;
+  volatile uint32_t verifyFails_ = 0;
+  volatile uint32_t forcedOffs_ = 0;
+  volatile uint32_t plannedOffs_ = 0;
+  volatile uint32_t offWriteFails_ = 0;
+
   // --- Internas
   void ensureWireBegun_();
+  void lockTake_();
+  void lockGive_();
+  void armTimers_();
+  static void onTimer_(void* arg);
+  void forceOff_(uint8_t ch);
+  void applyOff_(uint8_t ch);
+  void applyPending_();
+  void settleCuts_(bool written);
   static inline uint8_t bitOf(PumpId id) { return static_cast<uint8_t>(id); }
 
   // Traduce ON lógico de un canal al valor del bit según activeHigh_
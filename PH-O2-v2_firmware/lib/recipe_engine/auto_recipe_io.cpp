@@ -0,0 +1,120 @@
+#include "auto_recipe_io.h"
+
+bool AutoRecipeIOBase::guard(RecipeGuard g) {
+  switch (g) {
+    case RecipeGuard::SAMPLE_IN: return !levelActive(AutoLevel::O2) && !levelActive(AutoLevel::PH);   // ambos ACTIVOS
+    case RecipeGuard::DRAINED:   return levelActive(AutoLevel::O2) && levelActive(AutoLevel::PH);     // ambos INACTIVOS
+    case RecipeGuard::H2O_OK:    return !levelActive(AutoLevel::H2O);
+    case RecipeGuard::KCL_OK:    return !levelActive(AutoLevel::KCL);
+    default:                     return true;
+  }
+}
+
+// SAMPLE_IN/DRAINED se cumplen cuando cambió el último de los dos sensores
+uint32_t AutoRecipeIOBase::guardSince(RecipeGuard g, uint32_t now) {
+  if (g != RecipeGuard::SAMPLE_IN && g != RecipeGuard::DRAINED) return now;
+  uint32_t a, b;
+  if (!levelChangeMs(AutoLevel::O2, a) || !levelChangeMs(AutoLevel::PH, b)) return now;
+  return (int32_t)(a - b) > 0 ? a : b;
+}
+
+void AutoRecipeIOBase::cutOnGuard(uint8_t act, RecipeGuard g, uint32_t afterMs) {
+  const uint8_t id = pumpId(act);
+  if (id >= PUMPS) return;
+  lockCut();
+  cut_[id].guard   = g;
+  cut_[id].afterMs = afterMs;
+  cut_[id].armMs   = now();
+  const bool cancel = (g == RecipeGuard::NONE) && (scheduled_ & (1u << id));
+  if (cancel) scheduled_ &= (uint8_t)~(1u << id);
+  unlockCut();
+  if (cancel) cancelOff(id);
+  // Guarda ya cumplida al armar: no habrá flanco que la dispare
+  if (g != RecipeGuard::NONE) checkCut_(id);
+}
+
+RecipeGuard AutoRecipeIOBase::armed(uint8_t pump) const {
+  if (pump >= PUMPS) return RecipeGuard::NONE;
+  lockCut();
+  const RecipeGuard g = cut_[pump].guard;
+  unlockCut();
+  return g;
+}
+
+uint32_t AutoRecipeIOBase::armedAfterMs(uint8_t pump) const {
+  if (pump >= PUMPS) return 0;
+  lockCut();
+  const uint32_t ms = cut_[pump].afterMs;
+  unlockCut();
+  return ms;
+}
+
+bool AutoRecipeIOBase::takeDue_(uint8_t pump, Cut& c) {
+  lockCut();
+  c = cut_[pump];
+  unlockCut();
+  if (c.guard == RecipeGuard::NONE || !guard(c.guard)) return false;
+  lockCut();
+  const bool still = cut_[pump].guard == c.guard;   // el motor pudo desarmarla
+  if (still) cut_[pump].guard = RecipeGuard::NONE;
+  unlockCut();
+  return still;
+}
+
+void AutoRecipeIOBase::onLevelChange() {
+  for (uint8_t id = 0; id < PUMPS; ++id) checkCut_(id);
+}
+
+void AutoRecipeIOBase::checkCut_(uint8_t pump) {
+  Cut c;
+  if (!takeDue_(pump, c)) return;
+  // El HOLD cuenta desde el flanco, igual que en el motor: no antes de armar
+  const uint32_t t = now();
+  uint32_t since = t - guardSince(c.guard, t);
+  if ((int32_t)since < 0) since = 0;
+  if (since > t - c.armMs) since = t - c.armMs;
+  if (c.afterMs <= since) {
+    setPump(pump, false);
+    return;
+  }
+  lockCut();
+  scheduled_ |= (uint8_t)(1u << pump);
+  unlockCut();
+  offAfter(pump, c.afterMs - since);
+}
+
+uint32_t AutoRecipeIOBase::param(RecipeParam p, uint8_t step) {
+  if (!learner || !recipe) return configured(p);
+  const RecipeStep& s = recipe->steps[step];
+  const uint8_t pump = learnPump(s);
+  if (pump != 0xFF && p == s.tmo && p != RecipeParam::CONST)
+    return learner->timeoutMs(step, pump, configured(p));
+  if (p == RecipeParam::SAMPLE_FILL)
+    return learner->fillMs(samplePump(), configured(p));
+  return configured(p);
+}
+
+uint8_t AutoRecipeIOBase::learnPump(const RecipeStep& s) const {
+  if (s.op != RecipeOp::PUMP && s.op != RecipeOp::WAIT) return 0xFF;
+  switch (s.guard) {
+    case RecipeGuard::SAMPLE_IN: return samplePump();
+    case RecipeGuard::DRAINED:   return RA_DRAIN;
+    case RecipeGuard::NONE:      return 0xFF;
+    default: break;
+  }
+  if (s.op != RecipeOp::PUMP) return 0xFF;
+  return pumpId(s.act);
+}
+
+bool AutoRecipeIOBase::learn(const RecipeStepReport& r, uint32_t& beforeMs, uint32_t& afterMs) {
+  if (!learner || !recipe) return false;
+  const RecipeStep& s = recipe->steps[r.index];
+  const uint8_t pump = learnPump(s);
+  if (pump == 0xFF || r.outcome == RecipeOutcome::FAIL) return false;
+
+  const uint32_t cfgMs = (s.tmo == RecipeParam::CONST) ? (uint32_t)s.tmoDs * 100u : configured(s.tmo);
+  beforeMs = learner->timeoutMs(r.index, pump, cfgMs);
+  learner->observe(r.index, pump, r.sensorMs, r.outcome == RecipeOutcome::OK, cfgMs);
+  afterMs  = learner->timeoutMs(r.index, pump, cfgMs);
+  return afterMs != beforeMs;
+}
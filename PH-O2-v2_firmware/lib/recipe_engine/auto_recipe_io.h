@@ -0,0 +1,78 @@
+#ifndef AUTO_RECIPE_IO_H
+#define AUTO_RECIPE_IO_H
+
+#include <stdint.h>
+#include "recipe_engine.h"
+#include "fill_learner.h"
+
+// =====================================================
+// Parte de AutoRecipeIO que no depende del hardware
+//  - Mapeo de actuadores (RA_SAMPLE = bomba de esta vuelta), guardas a
+//    partir de los sensores de nivel y flancos con marca de tiempo
+//  - cutOnGuard(): bomba armada → guarda (+ afterMs); onLevelChange() la
+//    apaga en el flanco o agenda el apagado afterMs después de él (lo llama
+//    quien ve los flancos)
+//  - Parámetros con lo aprendido por FillLearner y aprendizaje por paso
+//  - La comparten el firmware (src/main.cpp) y el simulador de planta
+//    (sim/plant_sim.cpp): el hardware entra por las virtuales protegidas
+// =====================================================
+
+// Sensores de nivel; mismo orden que LevelSensorId
+enum class AutoLevel : uint8_t { O2 = 0, PH, KCL, H2O, COUNT };
+
+class AutoRecipeIOBase : public RecipeIO {
+public:
+  static constexpr uint8_t PUMPS = RA_SAMPLE;   // RA_KCL..RA_SAMPLE4, mismo orden que PumpId
+
+  uint8_t       currentSample = 0;         // 0..totalSamples-1
+  uint8_t       totalSamples  = 1;
+  const Recipe* recipe  = nullptr;         // la que corre el motor (índices de paso)
+  FillLearner*  learner = nullptr;         // null = tiempos configurados
+
+  void     actuator(uint8_t act, bool on) override { setPump(pumpId(act), on); }
+  bool     guard(RecipeGuard g) override;
+  uint32_t guardSince(RecipeGuard g, uint32_t now) override;
+  void     cutOnGuard(uint8_t act, RecipeGuard g, uint32_t afterMs) override;
+  uint32_t param(RecipeParam p, uint8_t step) override;
+
+  // Cambió un sensor de nivel: apaga (o agenda el apagado de) las bombas
+  // armadas cuya guarda ya se cumple, sin esperar al próximo tick del motor
+  void onLevelChange();
+
+  // Tiempo hasta el sensor de un paso con guarda (desde stepDone).
+  // true si movió el timeout vigente (before/after en ms)
+  bool learn(const RecipeStepReport& r, uint32_t& beforeMs, uint32_t& afterMs);
+
+  uint8_t samplePump() const { return (uint8_t)(RA_SAMPLE1 + currentSample % 4); }
+  // RA_* sigue el orden de PumpId; RA_SAMPLE es la bomba de esta vuelta
+  uint8_t pumpId(uint8_t act) const { return (act == RA_SAMPLE) ? samplePump() : act; }
+  // Bomba cuyo caudal decide cuándo se cumple la guarda (0xFF = no se aprende)
+  uint8_t learnPump(const RecipeStep& s) const;
+  // Armada para cortar con la guarda (NONE = no)
+  RecipeGuard armed(uint8_t pump) const;
+  uint32_t    armedAfterMs(uint8_t pump) const;
+
+protected:
+  virtual void     setPump(uint8_t pump, bool on) = 0;
+  // Apagado agendado dentro de ms (> 0) y su cancelación
+  virtual void     offAfter(uint8_t pump, uint32_t ms) = 0;
+  virtual void     cancelOff(uint8_t pump) = 0;
+  virtual bool     levelActive(AutoLevel l) = 0;          // true = activo = sin líquido
+  virtual uint32_t configured(RecipeParam p) = 0;         // ConfigStore (ms)
+  // Último cambio confirmado del sensor (now()); false = sin flancos
+  virtual bool     levelChangeMs(AutoLevel l, uint32_t& ms) { (void)l; (void)ms; return false; }
+  // cut_ lo leen el motor y la tarea de niveles
+  virtual void     lockCut() const {}
+  virtual void     unlockCut() const {}
+
+private:
+  struct Cut { RecipeGuard guard; uint32_t afterMs; uint32_t armMs; };
+  Cut     cut_[PUMPS] = {};
+  uint8_t scheduled_ = 0;   // bombas con offAfter() pendiente
+
+  // Lee y desarma si la guarda armada ya se cumple
+  bool takeDue_(uint8_t pump, Cut& c);
+  void checkCut_(uint8_t pump);
+};
+
+#endif // AUTO_RECIPE_IO_H
@@ -0,0 +1,154 @@
+#include "fill_learner.h"
+
+static constexpr uint8_t  kFree = 0xFF;
+static constexpr uint16_t kMaxN = 0xFFFF;
+
+void FillLearner::begin(const FillLearnConfig& cfg) {
+  cfg_ = cfg;
+  reset();
+}
+
+void FillLearner::reset() {
+  for (uint8_t i = 0; i < FillLearnData::MAX_ENTRIES; ++i) {
+    FillLearnEntry& e = data_.e[i];
+    e.step = kFree;
+    e.pump = 0;
+    e.n = 0;
+    e.mean = e.var = e.baseMean = 0.0f;
+    e.timeoutMs = 0;
+    saved_[i] = 0;
+  }
+}
+
+void FillLearner::load(const FillLearnData& d) {
+  data_ = d;
+  for (uint8_t i = 0; i < FillLearnData::MAX_ENTRIES; ++i) {
+    FillLearnEntry& e = data_.e[i];
+    // EEPROM virgen o corrupta: la entrada vuelve a libre
+    const bool ok = e.step != kFree && e.n > 0 && isfinite(e.mean) && isfinite(e.var) &&
+                    isfinite(e.baseMean) && e.mean >= 0.0f && e.var >= 0.0f;
+    if (!ok) {
+      e.step = kFree;
+      e.n = 0;
+      e.mean = e.var = e.baseMean = 0.0f;
+      e.timeoutMs = 0;
+    }
+    saved_[i] = e.timeoutMs;
+  }
+  everSaved_ = false;   // tras el arranque se permite una escritura inmediata
+}
+
+const FillLearnEntry* FillLearner::find(uint8_t step, uint8_t pump) const {
+  for (uint8_t i = 0; i < FillLearnData::MAX_ENTRIES; ++i) {
+    const FillLearnEntry& e = data_.e[i];
+    if (e.step == step && e.pump == pump) return &e;
+  }
+  return nullptr;
+}
+
+FillLearnEntry* FillLearner::slot_(uint8_t step, uint8_t pump) {
+  FillLearnEntry* empty = nullptr;
+  for (uint8_t i = 0; i < FillLearnData::MAX_ENTRIES; ++i) {
+    FillLearnEntry& e = data_.e[i];
+    if (e.step == step && e.pump == pump) return &e;
+    if (!empty && e.step == kFree) empty = &e;
+  }
+  if (empty) {
+    empty->step = step;
+    empty->pump = pump;
+  }
+  return empty;  // tabla llena: ese paso sigue con el valor configurado
+}
+
+// σ con piso: con pocas muestras parecidas la varianza sale casi cero
+float FillLearner::sigma_(const FillLearnEntry& e) const {
+  float s = sqrtf(e.var);
+  const float rel = 0.05f * e.mean;
+  if (s < rel)   s = rel;
+  if (s < 20.0f) s = 20.0f;
+  return s;
+}
+
+void FillLearner::observe(uint8_t step, uint8_t pump, uint32_t sensorMs, bool reached, uint32_t configuredMs) {
+  if (sensorMs == 0) return;   // el sensor ya estaba: no dice nada del caudal
+  FillLearnEntry* e = slot_(step, pump);
+  if (!e) return;
+
+  const float x = (float)sensorMs;
+  if (e->n == 0) {
+    e->mean = x;
+    e->var  = 0.0f;
+  } else {
+    const float s = sigma_(*e);
+    float r = x - e->mean;
+    if (reached) {
+      const float lim = cfg_.clipSigma * s;
+      if (r >  lim) r =  lim;
+      if (r < -lim) r = -lim;
+    } else if (r < 0.0f) {
+      r = 0.0f;   // censurada: el tiempo real es al menos x
+    }
+    // Promedio simple hasta minSamples, EWMA después
+    const float a = (e->n < cfg_.minSamples) ? 1.0f / (float)(e->n + 1) : cfg_.alpha;
+    e->mean += a * r;
+    e->var   = (1.0f - a) * (e->var + a * r * r);
+  }
+  if (e->n < kMaxN) e->n++;
+  if (e->n < cfg_.minSamples) return;
+
+  if (e->baseMean <= 0.0f) e->baseMean = e->mean;
+
+  // Timeout: media + k·σ, dentro de la banda y con cambio acotado
+  float target = e->mean + cfg_.k * sigma_(*e);
+  const float lo = cfg_.minFactor * (float)configuredMs;
+  const float hi = cfg_.maxFactor * (float)configuredMs;
+  if (target < lo) target = lo;
+  if (target > hi) target = hi;
+
+  const float cur = (float)(e->timeoutMs ? e->timeoutMs : configuredMs);
+  const float dn = cur * (1.0f - cfg_.maxStep);
+  const float up = cur * (1.0f + cfg_.maxStep);
+  if (target < dn) target = dn;
+  if (target > up) target = up;
+  e->timeoutMs = (uint32_t)(target + 0.5f);
+}
+
+uint32_t FillLearner::timeoutMs(uint8_t step, uint8_t pump, uint32_t configuredMs) const {
+  const FillLearnEntry* e = find(step, pump);
+  if (!e || e->n < cfg_.minSamples || !e->timeoutMs) return configuredMs;
+  return e->timeoutMs;
+}
+
+uint32_t FillLearner::fillMs(uint8_t pump, uint32_t configuredMs) const {
+  // La entrada con más historia de esa bomba
+  const FillLearnEntry* best = nullptr;
+  for (uint8_t i = 0; i < FillLearnData::MAX_ENTRIES; ++i) {
+    const FillLearnEntry& e = data_.e[i];
+    if (e.step == kFree || e.pump != pump || e.n < cfg_.minSamples || e.baseMean <= 0.0f) continue;
+    if (!best || e.n > best->n) best = &e;
+  }
+  if (!best) return configuredMs;
+
+  float scale = best->mean / best->baseMean;
+  if (scale < cfg_.fillScaleMin) scale = cfg_.fillScaleMin;
+  if (scale > cfg_.fillScaleMax) scale = cfg_.fillScaleMax;
+  return (uint32_t)((float)configuredMs * scale + 0.5f);
+}
+
+bool FillLearner::wantsSave(uint32_t nowMs) const {
+  if (everSaved_ && nowMs - lastSaveMs_ < cfg_.saveMinMs) return false;
+  for (uint8_t i = 0; i < FillLearnData::MAX_ENTRIES; ++i) {
+    const uint32_t t = data_.e[i].timeoutMs;
+    if (!t || t == saved_[i]) continue;
+    if (!saved_[i]) return true;
+    const float d = fabsf((float)t - (float)saved_[i]) / (float)saved_[i];
+    if (d >= cfg_.saveDelta) return true;
+  }
+  return false;
+}
+
+void FillLearner::markSaved(uint32_t nowMs) {
+  for (uint8_t i = 0; i < FillLearnData::MAX_ENTRIES; ++i) saved_[i] = data_.e[i].timeoutMs;
+  lastSaveMs_ = nowMs;
+  everSaved_ = true;
+}
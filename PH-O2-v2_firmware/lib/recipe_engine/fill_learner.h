@@ -0,0 +1,88 @@
+#ifndef FILL_LEARNER_H
+#define FILL_LEARNER_H
+
+#include <stdint.h>
+#include <math.h>
+
+// =====================================================
+// Aprendizaje en lazo cerrado del tiempo hasta el sensor
+//  - Una entrada por (paso de la receta, bomba): los dos drenajes del
+//    ciclo parten de volúmenes distintos y cada bomba de muestra se gasta
+//    a su ritmo
+//  - Media y varianza EWMA; residuos recortados a clipSigma·σ para que un
+//    rebote del sensor o un atasco suelto no muevan la estimación
+//  - Timeout = media + k·σ, con cambio acotado a maxStep por observación
+//    y dentro de [minFactor, maxFactor] × el valor configurado
+//  - Un timeout es una muestra censurada (el sensor tarda ≥ timeout):
+//    empuja la media hacia arriba sin recorte
+//  - Llenado tras el sensor escalado por media / media de referencia
+//    (mismo volumen con la bomba más lenta o más rápida)
+//  - Guardado con cuidado de la flash: solo si algún timeout se movió
+//    saveDelta desde lo guardado y pasó saveMinMs desde el último save()
+//  - Sin dependencias de Arduino (se simula en host)
+// =====================================================
+
+struct FillLearnConfig {
+  float    alpha        = 0.2f;      // peso EWMA una vez arrancado
+  float    k            = 5.0f;      // timeout = media + k·σ
+  float    clipSigma    = 3.0f;      // recorte de residuos
+  float    maxStep      = 0.15f;     // cambio máx. del timeout por observación
+  float    minFactor    = 0.5f;      // timeout >= minFactor × configurado
+  float    maxFactor    = 3.0f;      // timeout <= maxFactor × configurado
+  uint8_t  minSamples   = 5;         // antes se usa el valor configurado
+  float    fillScaleMin = 0.7f;
+  float    fillScaleMax = 1.3f;
+  float    saveDelta    = 0.10f;     // cambio relativo que justifica escribir
+  uint32_t saveMinMs    = 3600000UL; // 1 h entre escrituras
+};
+
+struct FillLearnEntry {
+  uint8_t  step;        // paso de la receta (0xFF = libre)
+  uint8_t  pump;        // RecipeAct efectivo (RA_SAMPLE1..4, RA_DRAIN...)
+  uint16_t n;           // observaciones (satura)
+  float    mean;        // ms hasta el sensor
+  float    var;         // ms²
+  float    baseMean;    // referencia del llenado (media al arrancar)
+  uint32_t timeoutMs;   // vigente (0 = todavía el configurado)
+} __attribute__((packed));
+
+// Bloque persistente (vive en ConfigStore)
+struct FillLearnData {
+  static constexpr uint8_t MAX_ENTRIES = 8;
+  FillLearnEntry e[MAX_ENTRIES];
+} __attribute__((packed));
+
+class FillLearner {
+public:
+  void begin(const FillLearnConfig& cfg);
+  void load(const FillLearnData& d);     // estado guardado (o vacío)
+  void reset();
+  const FillLearnData& data() const { return data_; }
+
+  // Tiempo hasta el sensor de un paso con guarda.
+  // reached = false: terminó por timeout (sensorMs = timeout usado).
+  void observe(uint8_t step, uint8_t pump, uint32_t sensorMs, bool reached, uint32_t configuredMs);
+
+  // Timeout a usar en ese paso (configuredMs hasta tener minSamples)
+  uint32_t timeoutMs(uint8_t step, uint8_t pump, uint32_t configuredMs) const;
+  // Llenado tras el sensor para esa bomba
+  uint32_t fillMs(uint8_t pump, uint32_t configuredMs) const;
+
+  // Política de escritura: true si conviene save(); markSaved() al guardar
+  bool wantsSave(uint32_t nowMs) const;
+  void markSaved(uint32_t nowMs);
+
+  const FillLearnEntry* find(uint8_t step, uint8_t pump) const;
+
+private:
+  FillLearnConfig cfg_;
+  FillLearnData   data_;
+  uint32_t saved_[FillLearnData::MAX_ENTRIES];   // timeouts en la última escritura
+  uint32_t lastSaveMs_ = 0;
+  bool     everSaved_ = false;
+
+  FillLearnEntry* slot_(uint8_t step, uint8_t pump);
+  float sigma_(const FillLearnEntry& e) const;
+};
+
+#endif // FILL_LEARNER_H
@@ -0,0 +1,141 @@
+#include "recipe.h"
+#include <string.h>
+
+static const char* const OP_NAME[(uint8_t)RecipeOp::COUNT] = {
+  "pump", "wait", "on", "off", "check", "hook", "join"
+};
+static const char* const ACT_NAME[RA_COUNT] = {
+  "kcl", "h2o", "drain", "mixer", "sample1", "sample2", "sample3", "sample4", "sample"
+};
+static const char* const HOOK_NAME[RH_COUNT] = {
+  "levels", "stable", "read"
+};
+static const char* const GUARD_NAME[(uint8_t)RecipeGuard::COUNT] = {
+  "none", "sample_in", "drained", "h2o_ok", "kcl_ok"
+};
+static const char* const PARAM_NAME[(uint8_t)RecipeParam::COUNT] = {
+  "none", "const", "kcl_fill", "h2o_fill", "sample_fill", "drain",
+  "sample_t", "drain_t", "stabilization"
+};
+
+static bool lookup_(const char* const* names, uint8_t n, const char* s, uint8_t& out) {
+  if (!s) return false;
+  for (uint8_t i = 0; i < n; ++i) {
+    if (!strcmp(names[i], s)) { out = i; return true; }
+  }
+  return false;
+}
+
+const char* recipeOpName(RecipeOp op) {
+  return (uint8_t)op < (uint8_t)RecipeOp::COUNT ? OP_NAME[(uint8_t)op] : "?";
+}
+const char* recipeActName(uint8_t act)       { return act < RA_COUNT ? ACT_NAME[act] : "?"; }
+const char* recipeHookName(uint8_t hook)     { return hook < RH_COUNT ? HOOK_NAME[hook] : "?"; }
+const char* recipeGuardName(RecipeGuard g) {
+  return (uint8_t)g < (uint8_t)RecipeGuard::COUNT ? GUARD_NAME[(uint8_t)g] : "?";
+}
+const char* recipeParamName(RecipeParam p) {
+  return (uint8_t)p < (uint8_t)RecipeParam::COUNT ? PARAM_NAME[(uint8_t)p] : "?";
+}
+
+bool recipeParseOp(const char* s, RecipeOp& op) {
+  uint8_t i;
+  if (!lookup_(OP_NAME, (uint8_t)RecipeOp::COUNT, s, i)) return false;
+  op = (RecipeOp)i;
+  return true;
+}
+bool recipeParseAct(const char* s, uint8_t& act)   { return lookup_(ACT_NAME, RA_COUNT, s, act); }
+bool recipeParseHook(const char* s, uint8_t& hook) { return lookup_(HOOK_NAME, RH_COUNT, s, hook); }
+bool recipeParseGuard(const char* s, RecipeGuard& g) {
+  uint8_t i;
+  if (!lookup_(GUARD_NAME, (uint8_t)RecipeGuard::COUNT, s, i)) return false;
+  g = (RecipeGuard)i;
+  return true;
+}
+bool recipeParseParam(const char* s, RecipeParam& p) {
+  uint8_t i;
+  if (!lookup_(PARAM_NAME, (uint8_t)RecipeParam::COUNT, s, i)) return false;
+  p = (RecipeParam)i;
+  return true;
+}
+
+// ---------- Receta de fábrica ----------
+static RecipeStep step_(RecipeOp op, uint8_t act, RecipeGuard g, RecipeParam tmo,
+                        RecipeParam dur, uint8_t flags = 0) {
+  RecipeStep s;
+  s.op = op; s.act = act; s.guard = g; s.flags = flags;
+  s.tmo = tmo; s.dur = dur; s.tmoDs = 0; s.durDs = 0;
+  return s;
+}
+
+void recipeDefault(Recipe& r) {
+  typedef RecipeOp    O;
+  typedef RecipeGuard G;
+  typedef RecipeParam P;
+
+  const RecipeStep S[] = {
+    step_(O::HOOK, RH_LEVELS, G::NONE,      P::NONE,           P::NONE, RS_PAUSE),
+    step_(O::PUMP, RA_DRAIN,  G::DRAINED,   P::DRAIN_TIMEOUT,  P::DRAIN),
+    // Llenado de muestra: el mixer arranca apenas los sensores se mojan
+    step_(O::ON,   RA_SAMPLE, G::NONE,      P::NONE,           P::NONE),
+    step_(O::WAIT, 0,         G::SAMPLE_IN, P::SAMPLE_TIMEOUT, P::NONE),
+    step_(O::ON,   RA_MIXER,  G::NONE,      P::NONE,           P::NONE),
+    step_(O::WAIT, 0,         G::NONE,      P::NONE,           P::SAMPLE_FILL),
+    step_(O::OFF,  RA_SAMPLE, G::NONE,      P::NONE,           P::NONE),
+    step_(O::HOOK, RH_STABLE, G::NONE,      P::NONE,           P::STABILIZATION),
+    step_(O::OFF,  RA_MIXER,  G::NONE,      P::NONE,           P::NONE),
+    step_(O::HOOK, RH_READ,   G::NONE,      P::NONE,           P::NONE, RS_PAUSE),
+    step_(O::PUMP, RA_DRAIN,  G::DRAINED,   P::DRAIN_TIMEOUT,  P::DRAIN),
+    // H2O y KCL sin sensores: se llenan a la vez
+    step_(O::PUMP, RA_H2O,    G::NONE,      P::NONE,           P::H2O_FILL, RS_ASYNC),
+    step_(O::PUMP, RA_KCL,    G::NONE,      P::NONE,           P::KCL_FILL),
+    step_(O::JOIN, 0,         G::NONE,      P::NONE,           P::NONE),
+  };
+
+  memset(&r, 0, sizeof(r));
+  r.count   = (uint8_t)(sizeof(S) / sizeof(S[0]));
+  r.pauseMs = 1500;
+  memcpy(r.steps, S, sizeof(S));
+}
+
+// ---------- Validación ----------
+static bool stepValid_(const RecipeStep& s) {
+  if ((uint8_t)s.op    >= (uint8_t)RecipeOp::COUNT)    return false;
+  if ((uint8_t)s.guard >= (uint8_t)RecipeGuard::COUNT) return false;
+  if ((uint8_t)s.tmo   >= (uint8_t)RecipeParam::COUNT) return false;
+  if ((uint8_t)s.dur   >= (uint8_t)RecipeParam::COUNT) return false;
+  if (s.flags & ~(RS_ASYNC | RS_SOFT | RS_PAUSE))      return false;
+
+  // Una espera de sensor sin tope podría colgar el ciclo
+  if (s.guard != RecipeGuard::NONE && s.tmo == RecipeParam::NONE &&
+      (s.op == RecipeOp::PUMP || s.op == RecipeOp::WAIT)) return false;
+
+  switch (s.op) {
+    case RecipeOp::PUMP:
+    case RecipeOp::ON:
+    case RecipeOp::OFF:
+      return s.act < RA_COUNT;
+    case RecipeOp::WAIT:
+      return true;
+    case RecipeOp::CHECK:
+      return s.guard != RecipeGuard::NONE && !(s.flags & RS_ASYNC);
+    case RecipeOp::HOOK:
+      // Los hooks usan la pantalla y la adquisición: solo en primer plano
+      return s.act < RH_COUNT && !(s.flags & RS_ASYNC);
+    case RecipeOp::JOIN:
+      return !(s.flags & RS_ASYNC);
+    default:
+      return false;
+  }
+}
+
+bool recipeValid(const Recipe& r, uint8_t& badStep) {
+  if (r.count == 0 || r.count > Recipe::MAX_STEPS) {
+    badStep = r.count;
+    return false;
+  }
+  for (uint8_t i = 0; i < r.count; ++i) {
+    if (!stepValid_(r.steps[i])) { badStep = i; return false; }
+  }
+  return true;
+}
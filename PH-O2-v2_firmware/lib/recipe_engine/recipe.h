@@ -0,0 +1,121 @@
+#ifndef RECIPE_H
+#define RECIPE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// =====================================================
+// Receta del ciclo AUTO como DATOS (sin dependencias de Arduino)
+//  - Una receta es una lista de pasos de 10 bytes: se guarda tal cual en
+//    ConfigStore y se puede reemplazar por UART (JSON) sin reflashear
+//  - Actuadores y guardas son ids lógicos: quien ejecuta la receta los
+//    traduce (PCF8574 + sensores de nivel en la placa, planta simulada en host)
+//  - Los tiempos son referencias a parámetros de ConfigStore o constantes
+// =====================================================
+
+enum class RecipeOp : uint8_t {
+  PUMP = 0,   // enciende act, [espera guard con tope tmo], mantiene dur, apaga
+  WAIT,       // como PUMP pero sin actuador (espera guard y/o dur)
+  ON,         // enciende act y sigue (no espera)
+  OFF,        // apaga act y sigue
+  CHECK,      // la guarda debe cumplirse ya; si no, falla el paso
+  HOOK,       // acción de la aplicación (act = RecipeHook), con tope tmo
+  JOIN,       // espera a que terminen los pasos en paralelo
+  COUNT
+};
+
+// Actuadores: mismo orden que PumpId (0..7) + la bomba de muestra del ciclo
+enum RecipeAct : uint8_t {
+  RA_KCL = 0,
+  RA_H2O,
+  RA_DRAIN,
+  RA_MIXER,
+  RA_SAMPLE1,
+  RA_SAMPLE2,
+  RA_SAMPLE3,
+  RA_SAMPLE4,
+  RA_SAMPLE,     // la que toca en esta vuelta (S1..S4 según el nº de muestra)
+  RA_COUNT
+};
+
+// Acciones de la aplicación (op HOOK)
+enum RecipeHook : uint8_t {
+  RH_LEVELS = 0,   // muestra los niveles
+  RH_STABLE,       // espera estabilidad del pH (dur = tope)
+  RH_READ,         // lee pH/O2 y publica el resultado de la muestra
+  RH_COUNT
+};
+
+// Condiciones de sensores (las evalúa quien ejecuta la receta)
+enum class RecipeGuard : uint8_t {
+  NONE = 0,
+  SAMPLE_IN,    // celda llena: sensores O2 y pH mojados
+  DRAINED,      // celda vacía: sensores O2 y pH secos
+  H2O_OK,       // tanque de H2O con nivel
+  KCL_OK,       // tanque de KCL con nivel
+  COUNT
+};
+
+// Origen de un tiempo
+enum class RecipeParam : uint8_t {
+  NONE = 0,       // sin tope / sin duración
+  CONST,          // constante del paso (décimas de segundo)
+  KCL_FILL,
+  H2O_FILL,
+  SAMPLE_FILL,
+  DRAIN,
+  SAMPLE_TIMEOUT,
+  DRAIN_TIMEOUT,
+  STABILIZATION,
+  COUNT
+};
+
+// Banderas por paso
+enum : uint8_t {
+  RS_ASYNC = 1u << 0,   // corre en paralelo: la receta sigue con el próximo paso
+  RS_SOFT  = 1u << 1,   // timeout/fallo no aborta: se registra y se sigue
+  RS_PAUSE = 1u << 2,   // pausa cosmética al terminar (Recipe::pauseMs; 0 = no)
+};
+
+struct RecipeStep {
+  RecipeOp    op;
+  uint8_t     act;      // RecipeAct (PUMP/ON/OFF) o RecipeHook (HOOK)
+  RecipeGuard guard;    // PUMP/WAIT: fin de la fase 1; CHECK: condición
+  uint8_t     flags;    // RS_*
+  RecipeParam tmo;      // tope de la fase 1 (PUMP/WAIT) o del hook
+  RecipeParam dur;      // fase 2 (PUMP/WAIT) o parámetro del hook
+  uint16_t    tmoDs;    // si tmo == CONST (0.1 s)
+  uint16_t    durDs;    // si dur == CONST (0.1 s)
+} __attribute__((packed));
+
+struct Recipe {
+  static constexpr uint8_t MAX_STEPS = 16;
+
+  uint8_t    count;     // 0 = sin receta (se usa la de fábrica)
+  uint16_t   pauseMs;   // pausa de los pasos con RS_PAUSE
+  RecipeStep steps[MAX_STEPS];
+} __attribute__((packed));
+
+// Receta de fábrica: la secuencia histórica del modo AUTO sin pausas
+// cosméticas en cada paso y con H2O/KCL en paralelo
+void recipeDefault(Recipe& r);
+
+// Comprueba rangos y combinaciones. badStep = primer paso inválido
+// (count si el problema es la receta entera).
+bool recipeValid(const Recipe& r, uint8_t& badStep);
+
+// Nombres para JSON/logs ("pump", "drain", "sample_in", "drain_t"...).
+// Los parse* retornan false si el nombre no existe.
+const char* recipeOpName(RecipeOp op);
+const char* recipeActName(uint8_t act);
+const char* recipeHookName(uint8_t hook);
+const char* recipeGuardName(RecipeGuard g);
+const char* recipeParamName(RecipeParam p);
+
+bool recipeParseOp(const char* s, RecipeOp& op);
+bool recipeParseAct(const char* s, uint8_t& act);
+bool recipeParseHook(const char* s, uint8_t& hook);
+bool recipeParseGuard(const char* s, RecipeGuard& g);
+bool recipeParseParam(const char* s, RecipeParam& p);
+
+#endif // RECIPE_H
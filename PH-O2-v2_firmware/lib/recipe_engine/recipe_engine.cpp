@@ -0,0 +1,293 @@
+#include "recipe_engine.h"
+
+bool RecipeEngine::start(const Recipe& r) {
+  uint8_t bad;
+  if (!recipeValid(r, bad)) return false;
+  if (running()) abort();
+
+  recipe_ = r;
+  next_ = 0;
+  onMask_ = 0;
+  cutMask_ = 0;
+  planned_ = 0;
+  abortStep_ = -1;
+  abortOutcome_ = RecipeOutcome::OK;
+  fg_ = Runner();
+  for (uint8_t i = 0; i < MAX_PARALLEL; ++i) bg_[i] = Runner();
+  for (uint8_t i = 0; i < Recipe::MAX_STEPS; ++i) reports_[i] = RecipeStepReport();
+
+  t0_ = io_.now();
+  totalMs_ = 0;
+  state_ = RecipeRunState::RUNNING;
+  return true;
+}
+
+void RecipeEngine::abort() {
+  if (!running()) return;
+  abortStep_ = -1;
+  abortOutcome_ = RecipeOutcome::FAIL;
+  stop_(RecipeRunState::ABORTED, io_.now());
+}
+
+uint32_t RecipeEngine::resolve_(uint8_t step, RecipeParam p, uint16_t ds) {
+  if (p == RecipeParam::NONE)  return 0;
+  if (p == RecipeParam::CONST) return (uint32_t)ds * 100u;
+  return io_.param(p, step);
+}
+
+void RecipeEngine::setAct_(uint8_t act, bool on) {
+  if (on) onMask_ |= (uint16_t)(1u << act);
+  else    onMask_ &= (uint16_t)~(1u << act);
+  if (!on) disarm_((uint16_t)(1u << act));
+  io_.actuator(act, on);
+}
+
+void RecipeEngine::disarm_(uint16_t mask) {
+  mask &= cutMask_;
+  for (uint8_t a = 0; a < RA_COUNT; ++a)
+    if (mask & (1u << a)) io_.cutOnGuard(a, RecipeGuard::NONE, 0);
+  cutMask_ &= (uint16_t)~mask;
+}
+
+// Paso con guarda entrando a SENSOR: qué puede apagar el IO en el flanco.
+//  - PUMP: su bomba, después del HOLD (dur)
+//  - WAIT: lo encendido que la receta apaga más adelante sin otra espera
+//    de sensor ni hook de por medio; afterMs suma el HOLD de este paso,
+//    los WAIT de tiempo fijo y las pausas hasta el OFF
+// Se desarma cuando el motor apaga el actuador o si la guarda vence.
+void RecipeEngine::armCuts_(Runner& r, uint8_t step) {
+  const RecipeStep& s = recipe_.steps[step];
+  auto arm = [&](uint8_t act, uint32_t afterMs) {
+    io_.cutOnGuard(act, s.guard, afterMs);
+    r.cuts   |= (uint16_t)(1u << act);
+    cutMask_ |= (uint16_t)(1u << act);
+  };
+
+  if (s.op == RecipeOp::PUMP) {
+    arm(s.act, r.durMs);
+    return;
+  }
+
+  uint32_t after = r.durMs + ((s.flags & RS_PAUSE) ? recipe_.pauseMs : 0);
+  uint16_t seen  = 0;
+  for (uint8_t j = (uint8_t)(step + 1); j < recipe_.count; ++j) {
+    const RecipeStep& t = recipe_.steps[j];
+    if (t.flags & RS_ASYNC) continue;   // arranca y sigue: no espera
+    if (t.op == RecipeOp::OFF) {
+      const uint16_t bit = (uint16_t)(1u << t.act);
+      if ((onMask_ & bit) && !(seen & bit)) arm(t.act, after);
+      seen |= bit;
+    } else if (t.op == RecipeOp::ON) {
+      seen |= (uint16_t)(1u << t.act);  // lo que se enciende después no es de este paso
+    } else if (t.op == RecipeOp::WAIT && t.guard == RecipeGuard::NONE) {
+      // El paso usará este mismo valor aunque el aprendizaje lo mueva antes
+      plannedMs_[j] = resolve_(j, t.dur, t.durDs);
+      planned_ |= (uint16_t)(1u << j);
+      after += plannedMs_[j];
+    } else if (t.op != RecipeOp::CHECK) {
+      break;                            // hook, PUMP, JOIN o espera de sensor
+    }
+    if (t.flags & RS_PAUSE) after += recipe_.pauseMs;
+  }
+}
+
+bool RecipeEngine::bgBusy_() const {
+  for (uint8_t i = 0; i < MAX_PARALLEL; ++i)
+    if (bg_[i].step >= 0) return true;
+  return false;
+}
+
+void RecipeEngine::stop_(RecipeRunState s, uint32_t now) {
+  // Nada queda encendido al salir, termine como termine
+  for (uint8_t a = 0; a < RA_COUNT; ++a) {
+    if (onMask_ & (1u << a)) io_.actuator(a, false);
+    io_.cutOnGuard(a, RecipeGuard::NONE, 0);
+  }
+  onMask_ = 0;
+  cutMask_ = 0;
+
+  fg_.step = -1;
+  for (uint8_t i = 0; i < MAX_PARALLEL; ++i) bg_[i].step = -1;
+  totalMs_ = now - t0_;
+  state_ = s;
+}
+
+void RecipeEngine::launch_(Runner& r, uint8_t step, uint32_t now) {
+  r = Runner();
+  r.step = (int8_t)step;
+  r.t0 = r.tSub = now;
+
+  RecipeStepReport& rep = reports_[step];
+  rep = RecipeStepReport();
+  rep.index   = step;
+  rep.op      = recipe_.steps[step].op;
+  rep.act     = recipe_.steps[step].act;
+  rep.startMs = now - t0_;
+}
+
+void RecipeEngine::finish_(Runner& r, RecipeOutcome o, uint32_t now) {
+  const RecipeStep& s = recipe_.steps[r.step];
+  if (s.op == RecipeOp::PUMP) setAct_(s.act, false);
+
+  r.outcome = o;
+  RecipeStepReport& rep = reports_[r.step];
+  rep.outcome  = o;
+  rep.sensorMs = r.sensorMs;
+  rep.totalMs  = now - r.t0;
+  io_.stepDone(rep);
+
+  if (o == RecipeOutcome::OK && (s.flags & RS_PAUSE) && recipe_.pauseMs) {
+    r.sub  = RecipeSub::PAUSE;
+    r.tSub = now;
+  } else {
+    r.sub  = RecipeSub::START;
+    r.step = -1;   // libre; el llamador revisa r.outcome
+  }
+}
+
+// Encadena las fases que terminan en el mismo instante
+bool RecipeEngine::advance_(Runner& r, uint32_t now) {
+  while (r.step >= 0) {
+    const RecipeStep& s = recipe_.steps[r.step];
+
+    switch (r.sub) {
+      case RecipeSub::START:
+        r.tmoMs = resolve_((uint8_t)r.step, s.tmo, s.tmoDs);
+        if (planned_ & (1u << r.step)) {
+          r.durMs = plannedMs_[r.step];
+          planned_ &= (uint16_t)~(1u << r.step);
+        } else {
+          r.durMs = resolve_((uint8_t)r.step, s.dur, s.durDs);
+        }
+        switch (s.op) {
+          case RecipeOp::ON:    setAct_(s.act, true);  finish_(r, RecipeOutcome::OK, now); break;
+          case RecipeOp::OFF:   setAct_(s.act, false); finish_(r, RecipeOutcome::OK, now); break;
+          case RecipeOp::CHECK:
+            finish_(r, io_.guard(s.guard) ? RecipeOutcome::OK : RecipeOutcome::FAIL, now);
+            break;
+          case RecipeOp::JOIN:
+            if (bgBusy_()) return false;
+            finish_(r, RecipeOutcome::OK, now);
+            break;
+          case RecipeOp::HOOK:
+            r.sub  = RecipeSub::HOOK;
+            r.tSub = now;
+            break;
+          default:   // PUMP / WAIT
+            if (s.op == RecipeOp::PUMP) setAct_(s.act, true);
+            r.sub  = (s.guard != RecipeGuard::NONE) ? RecipeSub::SENSOR : RecipeSub::HOLD;
+            r.tSub = now;
+            if (r.sub == RecipeSub::SENSOR) armCuts_(r, (uint8_t)r.step);
+            break;
+        }
+        break;
+
+      case RecipeSub::SENSOR:
+        if (io_.guard(s.guard)) {
+          // El flanco pudo llegar entre ticks: el HOLD cuenta desde él
+          uint32_t t = io_.guardSince(s.guard, now);
+          if ((int32_t)(t - r.tSub) < 0 || (int32_t)(now - t) < 0) t = now;
+          r.sensorMs = t - r.tSub;
+          r.sub  = RecipeSub::HOLD;
+          r.tSub = t;
+        } else if (r.tmoMs && now - r.tSub >= r.tmoMs) {
+          disarm_(r.cuts);   // sin flanco no hay corte que esperar
+          r.sensorMs = now - r.tSub;
+          finish_(r, RecipeOutcome::TIMEOUT, now);
+        } else {
+          return false;
+        }
+        break;
+
+      case RecipeSub::HOLD:
+        if (now - r.tSub < r.durMs) return false;
+        finish_(r, RecipeOutcome::OK, now);
+        break;
+
+      case RecipeSub::HOOK: {
+        const RecipeHookStatus st = io_.hook(s.act, r.enter, r.durMs);
+        r.enter = false;
+        if      (st == RecipeHookStatus::DONE) finish_(r, RecipeOutcome::OK, now);
+        else if (st == RecipeHookStatus::FAIL) finish_(r, RecipeOutcome::FAIL, now);
+        else if (r.tmoMs && now - r.tSub >= r.tmoMs) finish_(r, RecipeOutcome::TIMEOUT, now);
+        else return false;
+      } break;
+
+      case RecipeSub::PAUSE:
+        if (now - r.tSub < recipe_.pauseMs) return false;
+        r.sub  = RecipeSub::START;
+        r.step = -1;
+        break;
+    }
+  }
+  return true;
+}
+
+RecipeRunState RecipeEngine::tick() {
+  if (state_ != RecipeRunState::RUNNING) return state_;
+  const uint32_t now = io_.now();
+
+  // Un paso que falla sin RS_SOFT aborta la receta
+  auto fatal = [&](const Runner& r, uint8_t step) -> bool {
+    if (r.outcome == RecipeOutcome::OK || (recipe_.steps[step].flags & RS_SOFT)) return false;
+    abortStep_    = (int8_t)step;
+    abortOutcome_ = r.outcome;
+    stop_(RecipeRunState::ABORTED, now);
+    return true;
+  };
+
+  // Segundo plano
+  for (uint8_t i = 0; i < MAX_PARALLEL; ++i) {
+    Runner& r = bg_[i];
+    if (r.step < 0) continue;
+    const uint8_t step = (uint8_t)r.step;
+    if (advance_(r, now) && fatal(r, step)) return state_;
+  }
+
+  // Primer plano: cada vuelta termina un paso o lanza uno nuevo
+  for (;;) {
+    if (fg_.step >= 0) {
+      const uint8_t step = (uint8_t)fg_.step;
+      if (!advance_(fg_, now)) break;
+      if (fatal(fg_, step)) return state_;
+    }
+
+    if (next_ >= recipe_.count) {
+      if (!bgBusy_()) stop_(RecipeRunState::DONE, now);
+      break;
+    }
+
+    const uint8_t step = next_;
+    if (recipe_.steps[step].flags & RS_ASYNC) {
+      Runner* slot = nullptr;
+      for (uint8_t i = 0; i < MAX_PARALLEL && !slot; ++i)
+        if (bg_[i].step < 0) slot = &bg_[i];
+      if (!slot) break;   // sin lugar: espera a que se libere uno
+      next_++;
+      launch_(*slot, step, now);
+      if (advance_(*slot, now) && fatal(*slot, step)) return state_;
+      continue;
+    }
+
+    next_++;
+    launch_(fg_, step, now);
+  }
+  return state_;
+}
+
+RecipeProgress RecipeEngine::progress() const {
+  RecipeProgress p;
+  if (!running() || fg_.step < 0) return p;
+
+  p.step      = fg_.step;
+  p.sub       = fg_.sub;
+  p.elapsedMs = io_.now() - fg_.tSub;
+  switch (fg_.sub) {
+    case RecipeSub::SENSOR: p.limitMs = fg_.tmoMs;          break;
+    case RecipeSub::HOLD:
+    case RecipeSub::HOOK:   p.limitMs = fg_.durMs;          break;
+    case RecipeSub::PAUSE:  p.limitMs = recipe_.pauseMs;    break;
+    default:                p.limitMs = 0;                  break;
+  }
+  return p;
+}
@@ -0,0 +1,142 @@
+#ifndef RECIPE_ENGINE_H
+#define RECIPE_ENGINE_H
+
+#include <stdint.h>
+#include "recipe.h"
+
+// =====================================================
+// Motor de recetas no bloqueante
+//  - tick() avanza todos los pasos activos y retorna enseguida; los pasos
+//    instantáneos (ON/OFF/CHECK) se encadenan en el mismo tick
+//  - RS_ASYNC deja el paso corriendo en segundo plano (hasta MAX_PARALLEL);
+//    JOIN y el fin de la receta esperan a que terminen
+//  - Timeout o fallo de un paso aborta la receta salvo RS_SOFT; al terminar
+//    o abortar se apagan los actuadores que la receta dejó encendidos
+//  - Telemetría por paso (inicio, espera de sensor, total, resultado)
+//  - El hardware entra por RecipeIO: en host se conecta una planta simulada
+// =====================================================
+
+enum class RecipeHookStatus : uint8_t { RUNNING, DONE, FAIL };
+enum class RecipeOutcome    : uint8_t { OK, TIMEOUT, FAIL };
+enum class RecipeRunState   : uint8_t { IDLE, RUNNING, DONE, ABORTED };
+
+struct RecipeStepReport {
+  uint8_t       index   = 0;     // paso dentro de la receta
+  RecipeOp      op      = RecipeOp::WAIT;
+  uint8_t       act     = 0;
+  RecipeOutcome outcome = RecipeOutcome::OK;
+  uint32_t      startMs  = 0;    // desde el inicio de la receta
+  uint32_t      sensorMs = 0;    // espera de la guarda (0 si no tiene)
+  uint32_t      totalMs  = 0;    // sin la pausa cosmética
+};
+
+class RecipeIO {
+public:
+  virtual ~RecipeIO() {}
+
+  virtual uint32_t now() = 0;
+  virtual void     actuator(uint8_t act, bool on) = 0;
+  virtual bool     guard(RecipeGuard g) = 0;
+  virtual uint32_t param(RecipeParam p, uint8_t step) = 0;   // tiempos configurados (ms) del paso
+
+  // Op HOOK: se llama en cada tick hasta DONE/FAIL (enter = primera vez).
+  // durMs es el parámetro dur del paso ya resuelto.
+  virtual RecipeHookStatus hook(uint8_t id, bool enter, uint32_t durMs) {
+    (void)id; (void)enter; (void)durMs;
+    return RecipeHookStatus::DONE;
+  }
+
+  // Instante (now()) en que la guarda pasó a cumplirse, si el IO lo sabe
+  // (flancos con marca de tiempo). El HOLD posterior se mide desde ahí.
+  virtual uint32_t guardSince(RecipeGuard g, uint32_t now) { (void)g; return now; }
+
+  // Corte en el camino del flanco: el IO puede apagar act afterMs después
+  // de que se cumpla g (0 = en el flanco), sin esperar al próximo tick.
+  // Lo arman PUMP con guarda (afterMs = dur) y WAIT con guarda para lo que
+  // la receta apaga después sin otra espera de por medio. g = NONE desarma.
+  virtual void cutOnGuard(uint8_t act, RecipeGuard g, uint32_t afterMs) { (void)act; (void)g; (void)afterMs; }
+
+  // Telemetría: un reporte por paso terminado
+  virtual void stepDone(const RecipeStepReport& r) { (void)r; }
+};
+
+// Qué está haciendo el paso en primer plano (para la UI)
+enum class RecipeSub : uint8_t { START, SENSOR, HOLD, HOOK, PAUSE };
+
+struct RecipeProgress {
+  int8_t    step      = -1;      // -1 = nada en primer plano
+  RecipeSub sub       = RecipeSub::START;
+  uint32_t  elapsedMs = 0;       // en la fase actual
+  uint32_t  limitMs   = 0;       // tope/duración de la fase actual (0 = sin tope)
+};
+
+class RecipeEngine {
+public:
+  static constexpr uint8_t MAX_PARALLEL = 4;
+
+  explicit RecipeEngine(RecipeIO& io) : io_(io) {}
+
+  // Copia la receta y arranca. false si la receta no es válida.
+  bool start(const Recipe& r);
+  RecipeRunState tick();
+  // Cancela (ESC): apaga lo encendido por la receta
+  void abort();
+
+  RecipeRunState state() const { return state_; }
+  bool running() const { return state_ == RecipeRunState::RUNNING; }
+
+  const Recipe&  recipe() const { return recipe_; }
+  RecipeProgress progress() const;
+  uint32_t       elapsedMs() const { return (state_ == RecipeRunState::RUNNING) ? io_.now() - t0_ : totalMs_; }
+
+  // Resultado del último start(): paso que abortó (-1 = cancelado por abort())
+  int8_t        abortStep() const { return abortStep_; }
+  RecipeOutcome abortOutcome() const { return abortOutcome_; }
+
+  // Telemetría del último ciclo, indexada por paso
+  const RecipeStepReport& report(uint8_t i) const { return reports_[i < Recipe::MAX_STEPS ? i : 0]; }
+
+private:
+  struct Runner {
+    int8_t        step   = -1;     // -1 = libre
+    RecipeSub     sub    = RecipeSub::START;
+    bool          enter  = true;   // primera llamada al hook
+    RecipeOutcome outcome = RecipeOutcome::OK;
+    uint32_t      t0     = 0;      // inicio del paso
+    uint32_t      tSub   = 0;      // inicio de la fase actual
+    uint32_t      tmoMs  = 0;
+    uint32_t      durMs  = 0;
+    uint32_t      sensorMs = 0;
+    uint16_t      cuts   = 0;      // actuadores armados con cutOnGuard en este paso
+  };
+
+  RecipeIO&      io_;
+  Recipe         recipe_{};
+  RecipeRunState state_ = RecipeRunState::IDLE;
+  uint8_t        next_  = 0;
+  uint32_t       t0_    = 0;
+  uint32_t       totalMs_ = 0;
+  uint16_t       onMask_  = 0;     // actuadores encendidos por la receta
+  uint16_t       cutMask_ = 0;     // armados con cutOnGuard
+  uint16_t       planned_ = 0;     // pasos con dur ya resuelto por armCuts_
+  uint32_t       plannedMs_[Recipe::MAX_STEPS];
+  int8_t         abortStep_ = -1;
+  RecipeOutcome  abortOutcome_ = RecipeOutcome::OK;
+
+  Runner fg_;
+  Runner bg_[MAX_PARALLEL];
+  RecipeStepReport reports_[Recipe::MAX_STEPS];
+
+  uint32_t resolve_(uint8_t step, RecipeParam p, uint16_t ds);
+  void     setAct_(uint8_t act, bool on);
+  void     armCuts_(Runner& r, uint8_t step);
+  void     disarm_(uint16_t mask);
+  void     launch_(Runner& r, uint8_t step, uint32_t now);
+  // true cuando el paso terminó (incluida la pausa cosmética)
+  bool     advance_(Runner& r, uint32_t now);
+  void     finish_(Runner& r, RecipeOutcome o, uint32_t now);
+  bool     bgBusy_() const;
+  void     stop_(RecipeRunState s, uint32_t now);
+};
+
+#endif // RECIPE_ENGINE_H
@@ -1,6 +1,7 @@
 #include "test_board.h"
 #include <Arduino.h>
 #include <globals.h>
+#include "log_manager.h"
 
 
 namespace TestBoard {
@@ -48,7 +49,7 @@ void testButtons() {
     bool currDown = digitalRead(SW_DOWN);
     if (prevDown == HIGH && currDown == LOW && (now - lastDownMs > debounceMs)) {
         testBuzzer(BUZZER, duration);
-        remoteManager.log("SW_DOWN pressed");
+        LOG_I(LogMod::MENU, "SW_DOWN pressed");
         lastDownMs = now;
     }
     prevDown = currDown;
@@ -57,7 +58,7 @@ void testButtons() {
     bool currUp = digitalRead(SW_UP);
     if (prevUp == HIGH && currUp == LOW && (now - lastUpMs > debounceMs)) {
         testBuzzer(BUZZER, duration);
-        remoteManager.log("SW_UP pressed");
+        LOG_I(LogMod::MENU, "SW_UP pressed");
         lastUpMs = now;
     }
     prevUp = currUp;
@@ -66,7 +67,7 @@ void testButtons() {
     bool currOk = digitalRead(SW_OK);
     if (prevOk == HIGH && currOk == LOW && (now - lastOkMs > debounceMs)) {
         testBuzzer(BUZZER, duration);
-        remoteManager.log("SW_OK pressed");
+        LOG_I(LogMod::MENU, "SW_OK pressed");
         lastOkMs = now;
     }
     prevOk = currOk;
@@ -75,7 +76,7 @@ void testButtons() {
     bool currEsc = digitalRead(SW_ESC);
     if (prevEsc == HIGH && currEsc == LOW && (now - lastEscMs > debounceMs)) {
         testBuzzer(BUZZER, duration);
-        remoteManager.log("SW_ESC pressed");
+        LOG_I(LogMod::MENU, "SW_ESC pressed");
         lastEscMs = now;
     }
     prevEsc = currEsc;
@@ -0,0 +1,136 @@
+#include "plant_model.h"
+#include <math.h>
+
+static constexpr float kStepS = 0.010f;   // paso de integración
+
+void PlantModel::begin(const PlantConfig& cfg, uint32_t seed) {
+  cfg_ = cfg;
+  now_ = 0;
+  rng_ = seed ? seed : 1;
+  pcf_ = 0;
+
+  vol_ = 0.0f;
+  h2oTank_ = cfg_.h2oTankMl;
+  kclTank_ = cfg_.kclTankMl;
+  for (uint8_t i = 0; i < 8; ++i) { flowScale_[i] = 1.0f; wasOn_[i] = false; }
+  wear_ = 0.0f;
+  o2Active_ = phActive_ = true;
+  overflowing_ = false;
+  overfillEvents_ = 0;
+  overflowMl_ = 0.0f;
+
+  cellPH_ = localPH_ = electrodePH_ = 7.0f;
+  cellC_ = dsC_ = cfg_.ambientC;
+  offsetV_ = 0.0f;
+  dsNextMs_ = 750;
+}
+
+void PlantModel::set(uint8_t pin, bool on) {
+  if (on) pcf_ |= (uint8_t)(1u << pin);
+  else    pcf_ &= (uint8_t)~(1u << pin);
+}
+
+// xorshift32: reproducible con la misma semilla
+float PlantModel::uniform_() {
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 17;
+  rng_ ^= rng_ << 5;
+  return (float)(rng_ >> 8) / 16777216.0f;
+}
+
+float PlantModel::gauss_() {
+  const float u1 = uniform_() + 1e-7f;
+  const float u2 = uniform_();
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+// Umbral con histéresis; dentro de la franja de rebote la lectura salta
+bool PlantModel::sensor_(bool active, float levelMl) {
+  const float d = vol_ - levelMl;
+  if (fabsf(d) < cfg_.sensorBounceMl && uniform_() < 0.2f) return !active;
+  if (active  && d >=  cfg_.sensorHystMl * 0.5f) return false;
+  if (!active && d <= -cfg_.sensorHystMl * 0.5f) return true;
+  return active;
+}
+
+void PlantModel::advance(uint32_t ms) {
+  const uint32_t end = now_ + ms;
+  while ((int32_t)(end - now_) > 0) {
+    const uint32_t dms = (end - now_) < 10u ? (end - now_) : 10u;
+    step_(dms / 1000.0f);
+    now_ += dms;
+  }
+}
+
+void PlantModel::step_(float dt) {
+  // Cada encendido sortea su propio caudal
+  for (uint8_t p = 0; p < 8; ++p) {
+    const bool on = on_(p);
+    if (on && !wasOn_[p]) flowScale_[p] = 1.0f + cfg_.flowJitter * gauss_();
+    wasOn_[p] = on;
+  }
+
+  // Entradas: volumen, pH y temperatura ponderados
+  auto add = [&](float dv, float ph, float tC) {
+    if (dv <= 0.0f) return;
+    const float v = vol_ + dv;
+    cellPH_ = (cellPH_ * vol_ + ph * dv) / v;
+    cellC_  = (cellC_ * vol_ + tC * dv) / v;
+    vol_ = v;
+  };
+
+  const float sampleFlow = cfg_.sampleFlow * (1.0f - wear_);
+  for (uint8_t s = 0; s < 4; ++s) {
+    if (on_(PL_S1 + s)) add(sampleFlow * flowScale_[PL_S1 + s] * dt, cfg_.samplePH[s], cfg_.sampleTempC[s]);
+  }
+  if (on_(PL_H2O) && h2oTank_ > 0.0f) {
+    const float dv = cfg_.h2oFlow * flowScale_[PL_H2O] * dt;
+    h2oTank_ -= dv;
+    add(dv, 7.0f, cfg_.ambientC);
+  }
+  if (on_(PL_KCL) && kclTank_ > 0.0f) {
+    const float dv = cfg_.kclFlow * flowScale_[PL_KCL] * dt;
+    kclTank_ -= dv;
+    add(dv, 7.0f, cfg_.ambientC);
+  }
+  if (on_(PL_DRAIN)) {
+    vol_ -= cfg_.drainFlow * flowScale_[PL_DRAIN] * dt;
+    if (vol_ < 0.0f) vol_ = 0.0f;
+  }
+
+  // Rebalse: un evento por excursión sobre la capacidad
+  if (vol_ > cfg_.capacityMl) {
+    overflowMl_ += vol_ - cfg_.capacityMl;
+    vol_ = cfg_.capacityMl;
+    if (!overflowing_) { overflowing_ = true; overfillEvents_++; }
+  } else if (vol_ < cfg_.capacityMl - 1.0f) {
+    overflowing_ = false;
+  }
+
+  o2Active_ = sensor_(o2Active_, cfg_.o2SensorMl);
+  phActive_ = sensor_(phActive_, cfg_.phSensorMl);
+
+  // Homogeneización, temperatura y electrodo (primer orden)
+  const float mixTau = on_(PL_MIXER) ? cfg_.mixTauS : cfg_.stillTauS;
+  localPH_ += (cellPH_ - localPH_) * (dt / mixTau);
+  cellC_   += (cfg_.ambientC - cellC_) * (dt / 300.0f);
+  const float eTau = cfg_.electrodeTauS * (1.0f + 0.03f * fmaxf(0.0f, 25.0f - cellC_));
+  if (!phActive_) electrodePH_ += (localPH_ - electrodePH_) * (dt / eTau);
+  offsetV_ += cfg_.driftMvPerH * 1e-3f * dt / 3600.0f;
+
+  if ((int32_t)(now_ - dsNextMs_) >= 0) {
+    dsC_ = roundf(cellC_ * 16.0f) / 16.0f;
+    dsNextMs_ = now_ + 750;
+  }
+}
+
+// Entrada del ADS: amplificador con la calibración de fábrica de PHManager
+// (a = -3.5 pH/V, b = 7 a 25 °C) y pendiente Nernst ∝ T absoluta
+float PlantModel::adsPH() {
+  const float TK = cellC_ + 273.15f;
+  float v = (electrodePH_ - 7.0f) / -3.5f * (TK / 298.15f) + offsetV_;
+  v += cfg_.noiseMv * 1e-3f * gauss_();
+  if (uniform_() < cfg_.spikeProb) v += (uniform_() < 0.5f ? -0.05f : 0.05f);
+  const float lsb = adsLsb();
+  return roundf(v / lsb) * lsb;
+}
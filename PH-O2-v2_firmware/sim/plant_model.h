@@ -0,0 +1,126 @@
+#ifndef PLANT_MODEL_H
+#define PLANT_MODEL_H
+
+#include <stdint.h>
+
+// =====================================================
+// Modelo de la planta PH-O2 v2 para simular en host
+//  - PCF8574: byte de salida con el mismo mapa que PumpId (bit = bomba ON)
+//  - Celda: volumen con caudales por bomba (dispersión por corrida y
+//    desgaste acumulado), rebalse sobre la capacidad
+//  - Sensores de nivel O2/pH a distinta altura, con histéresis y rebote;
+//    tanques de H2O/KCL que se vacían. Misma polaridad que
+//    LevelSensorsManager: true = "activo" = sin líquido
+//  - Electrodo de pH: respuesta de primer orden, pendiente Nernst con la
+//    temperatura, deriva de offset y ruido; ADS1115 con LSB de GAIN_ONE
+//  - DS18B20: 12 bits, conversión de 750 ms
+//  - Reloj virtual en ms: advance() integra con pasos de 10 ms
+// =====================================================
+
+struct PlantConfig {
+  // Celda (mL)
+  float capacityMl    = 80.0f;   // por encima rebalsa
+  float o2SensorMl    = 25.0f;   // altura del sensor de O2
+  float phSensorMl    = 30.0f;   // altura del sensor de pH
+  float sensorHystMl  = 0.5f;
+  float sensorBounceMl = 0.3f;   // franja con rebote alrededor del umbral
+
+  // Caudales nominales (mL/s)
+  float sampleFlow    = 12.0f;
+  float drainFlow     = 4.0f;
+  float h2oFlow       = 5.0f;
+  float kclFlow       = 5.0f;
+  float flowJitter    = 0.05f;   // dispersión por corrida (fracción, 1σ)
+  float wearPerCycle  = 0.0f;    // pérdida de caudal de las bombas de muestra por ciclo
+
+  // Tanques (mL)
+  float h2oTankMl     = 20000.0f;
+  float kclTankMl     = 20000.0f;
+  float tankLowMl     = 100.0f;  // el sensor del tanque se activa por debajo
+
+  // Muestras (pH verdadero de S1..S4)
+  float samplePH[4]   = {6.80f, 7.40f, 8.10f, 5.90f};
+  float sampleTempC[4] = {22.0f, 22.0f, 22.0f, 22.0f};
+
+  // Electrodo / ADS
+  float ambientC      = 24.0f;
+  float electrodeTauS = 2.5f;    // a 25 °C (más lento en frío)
+  float mixTauS       = 1.0f;    // homogeneización con mixer
+  float stillTauS     = 25.0f;   // sin mixer
+  float driftMvPerH   = 0.5f;    // deriva del offset del electrodo
+  float noiseMv       = 0.3f;    // ruido blanco (1σ) a la entrada del ADS
+  float spikeProb     = 0.002f;  // probabilidad de pico por conversión
+};
+
+enum PlantPin : uint8_t {   // mismo orden que PumpId / RecipeAct
+  PL_KCL = 0, PL_H2O, PL_DRAIN, PL_MIXER, PL_S1, PL_S2, PL_S3, PL_S4
+};
+
+class PlantModel {
+public:
+  void     begin(const PlantConfig& cfg, uint32_t seed);
+
+  // Reloj virtual
+  uint32_t now() const { return now_; }
+  void     advance(uint32_t ms);
+
+  // PCF8574 (bit en 1 = bomba ON, activeHigh)
+  void     write8(uint8_t v) { pcf_ = v; }
+  uint8_t  read8() const { return pcf_; }
+  void     set(uint8_t pin, bool on);
+
+  // Sensores de nivel (true = activo = seco / tanque bajo)
+  bool     levelO2()  const { return o2Active_; }
+  bool     levelPH()  const { return phActive_; }
+  bool     levelH2O() const { return h2oTank_ < cfg_.tankLowMl; }
+  bool     levelKCL() const { return kclTank_ < cfg_.tankLowMl; }
+
+  // ADS1115: una conversión del canal de pH (V)
+  float    adsPH();
+  float    adsLsb() const { return 4.096f / 32768.0f; }
+  // DS18B20: última conversión terminada (°C, 0.0625)
+  float    ds18b20() const { return dsC_; }
+
+  // Verdad del modelo (para los reportes)
+  float    volumeMl() const { return vol_; }
+  float    cellPH() const { return cellPH_; }
+  float    cellTempC() const { return cellC_; }
+  float    pumpWear() const { return wear_; }
+  uint32_t overfillEvents() const { return overfillEvents_; }
+  float    overflowMl() const { return overflowMl_; }
+
+  // Desgaste: lo llama el simulador al cerrar cada ciclo
+  void     endCycle() { wear_ += cfg_.wearPerCycle; }
+
+private:
+  PlantConfig cfg_;
+  uint32_t now_ = 0;
+  uint32_t rng_ = 1;
+  uint8_t  pcf_ = 0;
+
+  float vol_ = 0.0f;
+  float h2oTank_ = 0.0f, kclTank_ = 0.0f;
+  float flowScale_[8];         // dispersión de la corrida en curso por bomba
+  bool  wasOn_[8];
+  float wear_ = 0.0f;
+  bool  o2Active_ = true, phActive_ = true;
+  bool  overflowing_ = false;
+  uint32_t overfillEvents_ = 0;
+  float overflowMl_ = 0.0f;
+
+  float cellPH_ = 7.0f;        // pH de la mezcla homogénea
+  float localPH_ = 7.0f;       // lo que ve el electrodo (sin homogeneizar)
+  float electrodePH_ = 7.0f;   // respuesta del electrodo
+  float cellC_ = 24.0f;
+  float offsetV_ = 0.0f;
+  uint32_t dsNextMs_ = 0;
+  float dsC_ = 24.0f;
+
+  bool  on_(uint8_t pin) const { return (pcf_ >> pin) & 1u; }
+  float uniform_();            // [0,1)
+  float gauss_();
+  void  step_(float dt);
+  bool  sensor_(bool active, float levelMl);
+};
+
+#endif // PLANT_MODEL_H
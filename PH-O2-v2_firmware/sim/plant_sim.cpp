@@ -0,0 +1,392 @@
+// =====================================================
+// Simulador de la planta PH-O2 v2 en tiempo acelerado
+//  - Corre la lógica real del firmware que no depende de Arduino: motor y
+//    receta de fábrica (lib/recipe_engine), detector de estabilidad y
+//    estimador de pH (lib/ph_manager), contra PlantModel con reloj virtual
+//  - SimIO comparte con AutoRecipeIO de src/main.cpp la base
+//    AutoRecipeIOBase (guardas, flancos, corte por guarda, parámetros y
+//    aprendizaje); pone los hooks de estabilidad y lectura, la tarea de
+//    niveles (flancos cada 10 ms con LevelDebouncer) y la adquisición cada
+//    500 ms con el mismo presupuesto de conversiones que PHManager
+//  - Reporta tiempo de ciclo, rebalses, timeouts y error de lectura
+//  - --learn activa FillLearner como en AUTO (timeouts y llenado
+//    aprendidos, escrituras a EEPROM con la misma política)
+//
+// Compilar y correr (desde PH-O2-v2_firmware):
+//   g++ -std=c++11 -O2 -Ilib/recipe_engine -Ilib/ph_manager -Ilib/level_sensors_manager -Isim sim/*.cpp lib/recipe_engine/*.cpp lib/ph_manager/stability_detector.cpp lib/ph_manager/ph_estimator.cpp lib/level_sensors_manager/level_debounce.cpp -o plant_sim
+//   ./plant_sim -n 200 --sample-t 3000 --wear 0.001 --learn
+// =====================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+
+#include "plant_model.h"
+#include "recipe_engine.h"
+#include "fill_learner.h"
+#include "auto_recipe_io.h"
+#include "level_debounce.h"
+#include "stability_detector.h"
+#include "ph_estimator.h"
+
+// Valores de ConfigStore::resetDefaults() (ms)
+struct SimParams {
+  uint32_t kclFill = 3000, h2oFill = 3000, sampleFill = 3000, drain = 15000;
+  uint32_t sampleTimeout = 3000, drainTimeout = 15000, stabilization = 30000;
+  uint8_t  samples = 4;
+};
+
+// Snapshot de la tarea de adquisición (solo lo que usa el ciclo AUTO)
+struct SimSnapshot {
+  uint32_t seq = 0;
+  uint32_t ph_ms = 0;
+  float    volts = NAN;
+  float    ph = NAN;
+  float    temp_c = 25.0f;
+};
+
+class SimIO : public AutoRecipeIOBase {
+public:
+  PlantModel&  plant;
+  SimParams    params;
+  SimSnapshot  snap;
+  bool         verbose = false;
+
+  // Resultados del ciclo en curso
+  float        readPH = NAN;
+  bool         stable = false;
+  uint32_t     stableMs = 0;
+  RecipeStepReport reports[Recipe::MAX_STEPS];
+  uint32_t     guardCuts = 0;   // bombas apagadas en el flanco por onLevelChange()
+  uint32_t     plannedOffs = 0; // apagados agendados tras la guarda (HOLD) cumplidos
+
+  explicit SimIO(PlantModel& p) : plant(p) {
+    for (uint8_t i = 0; i < (uint8_t)AutoLevel::COUNT; ++i) {
+      deb_[i].begin(rawLevel_((AutoLevel)i), 0, LEVEL_DEBOUNCE_US);
+      changeMs_[i] = 0;
+    }
+  }
+
+  // ---- Tarea de niveles: flancos cada 10 ms, antirrebote de 20 ms ----
+  void advance(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += 10) {
+      plant.advance(10);
+      // esp_timer de PumpsManager: apagado agendado por offAfter()
+      for (uint8_t p = 0; p < PUMPS; ++p) {
+        if (!(offMask_ & (1u << p)) || (int32_t)(plant.now() - offAtMs_[p]) < 0) continue;
+        offMask_ &= (uint8_t)~(1u << p);
+        if ((plant.read8() >> p) & 1u) plannedOffs++;
+        plant.set(p, false);
+      }
+      const uint32_t nowUs = plant.now() * 1000u;
+      bool changed = false;
+      for (uint8_t i = 0; i < (uint8_t)AutoLevel::COUNT; ++i) {
+        deb_[i].edge(rawLevel_((AutoLevel)i), nowUs);
+        LevelEdge e;
+        if (!deb_[i].poll(nowUs, e)) continue;
+        changeMs_[i] = plant.now() - (nowUs - e.tUs) / 1000u;
+        changed = true;
+      }
+      if (!changed) continue;
+      const uint8_t before = plant.read8();
+      onLevelChange();
+      if (plant.read8() != before) guardCuts++;
+    }
+  }
+
+  // ---- Adquisición: pH cada 500 ms, temperatura del DS18B20 cada 2 s ----
+  void acquire() {
+    const uint32_t now = plant.now();
+    if ((int32_t)(now - nextAcqMs_) < 0) return;
+    nextAcqMs_ = now + 500;
+    if ((int32_t)(now - nextTempMs_) >= 0) { tempC_ = plant.ds18b20(); nextTempMs_ = now + 2000; }
+
+    PHSampleBudget b;                    // PHManager: 48 conv, mín 8, IC95 ±0.01 pH
+    b.maxSamples = 48;
+    b.minSamples = 8;
+    b.ciTarget   = 0.01f / 3.5f;
+    PHEstimator est;
+    est.begin(b, plant.adsLsb());
+    while (!est.push(plant.adsPH())) {}
+
+    const PHEstimate& e = est.result();
+    if (e.count == 0) return;
+    snap.seq++;
+    snap.ph_ms  = now;
+    snap.volts  = e.value;
+    snap.temp_c = tempC_;
+    // evalLinearAt_ con la calibración de fábrica (a=-3.5, b=7, Tcal=25 °C)
+    snap.ph = -3.5f * ((tempC_ + 273.15f) / 298.15f) * e.value + 7.0f;
+  }
+  void requestFresh() { nextAcqMs_ = plant.now(); }
+
+  // ---- RecipeIO (el resto lo pone AutoRecipeIOBase, igual que en AUTO) ----
+  uint32_t now() override { return plant.now(); }
+
+  RecipeHookStatus hook(uint8_t id, bool enter, uint32_t durMs) override {
+    const uint32_t now = plant.now();
+    if (id == RH_STABLE) {
+      if (enter) {
+        t0_ = now;
+        mixStab_.begin(stabilityMixConfig(durMs), t0_);
+        mixSeq_ = snap.seq;
+        requestFresh();
+      }
+      if (snap.seq != mixSeq_ && (int32_t)(snap.ph_ms - t0_) >= 0) {
+        mixSeq_ = snap.seq;
+        mixStab_.push(snap.ph_ms, snap.volts);
+      } else {
+        mixStab_.tick(now);
+      }
+      if (!mixStab_.done()) return RecipeHookStatus::RUNNING;
+      stable   = mixStab_.state() == StabilityState::STABLE;
+      stableMs = mixStab_.timeToStableMs();
+      return RecipeHookStatus::DONE;
+    }
+    if (id == RH_READ) {
+      if (enter) { tReq_ = now; requestFresh(); }
+      const bool fresh = snap.seq != 0 && (int32_t)(snap.ph_ms - tReq_) >= 0;
+      if (!fresh && now - tReq_ < 5000) return RecipeHookStatus::RUNNING;
+      readPH = fresh ? snap.ph : NAN;
+      return RecipeHookStatus::DONE;
+    }
+    return RecipeHookStatus::DONE;   // RH_LEVELS: solo pantalla
+  }
+
+  void stepDone(const RecipeStepReport& r) override {
+    reports[r.index] = r;
+    uint32_t before, after;
+    learn(r, before, after);
+    if (!verbose) return;
+    const RecipeStep& s = recipe->steps[r.index];
+    const char* what = (r.op == RecipeOp::HOOK) ? recipeHookName(r.act) :
+                       (r.op == RecipeOp::PUMP || r.op == RecipeOp::ON || r.op == RecipeOp::OFF)
+                         ? recipeActName(r.act) : recipeGuardName(s.guard);
+    printf("    #%-2u %-5s %-9s t0=%6.1f sensor=%5.1f total=%5.1f %s\n", r.index, recipeOpName(r.op), what,
+           r.startMs / 1000.0, r.sensorMs / 1000.0, r.totalMs / 1000.0,
+           r.outcome == RecipeOutcome::OK ? "OK" : r.outcome == RecipeOutcome::TIMEOUT ? "TIMEOUT" : "FALLO");
+  }
+
+protected:
+  void setPump(uint8_t pump, bool on) override {
+    if (!on) offMask_ &= (uint8_t)~(1u << pump);
+    plant.set(pump, on);
+  }
+  void offAfter(uint8_t pump, uint32_t ms) override {
+    offAtMs_[pump] = plant.now() + ms;
+    offMask_ |= (uint8_t)(1u << pump);
+  }
+  void cancelOff(uint8_t pump) override { offMask_ &= (uint8_t)~(1u << pump); }
+  bool levelActive(AutoLevel l) override { return deb_[(uint8_t)l].level(); }
+  bool levelChangeMs(AutoLevel l, uint32_t& ms) override { ms = changeMs_[(uint8_t)l]; return true; }
+
+  uint32_t configured(RecipeParam p) override {
+    switch (p) {
+      case RecipeParam::KCL_FILL:       return params.kclFill;
+      case RecipeParam::H2O_FILL:       return params.h2oFill;
+      case RecipeParam::SAMPLE_FILL:    return params.sampleFill;
+      case RecipeParam::DRAIN:          return params.drain;
+      case RecipeParam::SAMPLE_TIMEOUT: return params.sampleTimeout;
+      case RecipeParam::DRAIN_TIMEOUT:  return params.drainTimeout;
+      case RecipeParam::STABILIZATION:  return params.stabilization;
+      default:                          return 0;
+    }
+  }
+
+private:
+  static constexpr uint32_t LEVEL_DEBOUNCE_US = 20000;   // LevelSensorsManager::beginEvents()
+
+  StabilityDetector mixStab_;
+  uint32_t mixSeq_ = 0, t0_ = 0, tReq_ = 0;
+  uint32_t nextAcqMs_ = 0, nextTempMs_ = 0;
+  float    tempC_ = 25.0f;
+  LevelDebouncer deb_[(uint8_t)AutoLevel::COUNT];
+  uint32_t changeMs_[(uint8_t)AutoLevel::COUNT];
+  uint8_t  offMask_ = 0;
+  uint32_t offAtMs_[PUMPS] = {};
+
+  bool rawLevel_(AutoLevel l) const {
+    switch (l) {
+      case AutoLevel::O2:  return plant.levelO2();
+      case AutoLevel::PH:  return plant.levelPH();
+      case AutoLevel::KCL: return plant.levelKCL();
+      default:             return plant.levelH2O();
+    }
+  }
+};
+
+// ---------- Línea de comandos ----------
+static void usage() {
+  printf("uso: plant_sim [opciones]\n"
+         "  -n N              ciclos de muestra (200)\n"
+         "  -s SEED           semilla (1)\n"
+         "  -v                telemetría por paso\n"
+         "  --samples N       bombas de muestra 1..4 (4)\n"
+         "  --pause MS        pausa cosmética de la receta (la de fábrica)\n"
+         "  --sample-fill MS  --sample-t MS  --drain MS  --drain-t MS\n"
+         "  --h2o-fill MS     --kcl-fill MS  --stab MS   (ConfigStore)\n"
+         "  --flow ML_S       caudal de las bombas de muestra (12)\n"
+         "  --jitter F        dispersión del caudal por corrida (0.05)\n"
+         "  --wear F          pérdida de caudal por ciclo (0)\n"
+         "  --drift MV_H      deriva del electrodo (0.5)\n"
+         "  --learn           timeouts/llenado aprendidos (FillLearner)\n");
+}
+
+static float percentile(std::vector<float> v, float p) {
+  if (v.empty()) return NAN;
+  std::sort(v.begin(), v.end());
+  size_t i = (size_t)(p * (v.size() - 1) + 0.5f);
+  return v[i];
+}
+
+int main(int argc, char** argv) {
+  uint32_t cycles = 200, seed = 1;
+  bool verbose = false, learn = false;
+  int pauseMs = -1;
+  SimParams prm;
+  PlantConfig pc;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    auto num = [&]() { ++i; return v ? atof(v) : 0.0; };
+    if      (!strcmp(a, "-n"))            cycles = (uint32_t)num();
+    else if (!strcmp(a, "-s"))            seed = (uint32_t)num();
+    else if (!strcmp(a, "-v"))            verbose = true;
+    else if (!strcmp(a, "--samples"))     prm.samples = (uint8_t)num();
+    else if (!strcmp(a, "--pause"))       pauseMs = (int)num();
+    else if (!strcmp(a, "--sample-fill")) prm.sampleFill = (uint32_t)num();
+    else if (!strcmp(a, "--sample-t"))    prm.sampleTimeout = (uint32_t)num();
+    else if (!strcmp(a, "--drain"))       prm.drain = (uint32_t)num();
+    else if (!strcmp(a, "--drain-t"))     prm.drainTimeout = (uint32_t)num();
+    else if (!strcmp(a, "--h2o-fill"))    prm.h2oFill = (uint32_t)num();
+    else if (!strcmp(a, "--kcl-fill"))    prm.kclFill = (uint32_t)num();
+    else if (!strcmp(a, "--stab"))        prm.stabilization = (uint32_t)num();
+    else if (!strcmp(a, "--flow"))        pc.sampleFlow = (float)num();
+    else if (!strcmp(a, "--jitter"))      pc.flowJitter = (float)num();
+    else if (!strcmp(a, "--wear"))        pc.wearPerCycle = (float)num();
+    else if (!strcmp(a, "--drift"))       pc.driftMvPerH = (float)num();
+    else if (!strcmp(a, "--learn"))       learn = true;
+    else { usage(); return (!strcmp(a, "-h") || !strcmp(a, "--help")) ? 0 : 1; }
+  }
+  if (prm.samples < 1 || prm.samples > 4) prm.samples = 4;
+
+  Recipe recipe;
+  recipeDefault(recipe);
+  if (pauseMs >= 0) recipe.pauseMs = (uint16_t)pauseMs;
+
+  PlantModel plant;
+  plant.begin(pc, seed);
+  SimIO io(plant);
+  io.params  = prm;
+  io.verbose = verbose;
+  io.recipe  = &recipe;
+  FillLearner learner;
+  learner.begin(FillLearnConfig());
+  if (learn) io.learner = &learner;
+  RecipeEngine engine(io);
+  uint32_t saves = 0;
+
+  // Estadísticas
+  uint32_t done = 0, aborted = 0, timeouts = 0, failures = 0, stableN = 0;
+  uint32_t abortAt[Recipe::MAX_STEPS] = {0};
+  std::vector<float> cycleS, errPH, stableS;
+  double sensorSum[Recipe::MAX_STEPS] = {0};
+  uint32_t sensorN[Recipe::MAX_STEPS] = {0};
+
+  const clock_t wall0 = clock();
+  for (uint32_t c = 0; c < cycles; ++c) {
+    if (plant.levelH2O() || plant.levelKCL()) {
+      printf("tanques bajos tras %u ciclos: se detiene\n", c);
+      break;
+    }
+    io.currentSample = (uint8_t)(c % prm.samples);
+    io.readPH = NAN;
+    io.stable = false;
+    if (verbose) printf("  ciclo %u S%u\n", c + 1, io.currentSample + 1);
+
+    engine.start(recipe);
+    // Mismo ritmo que taskCore0: un tick de UI cada 100 ms
+    while (engine.tick() == RecipeRunState::RUNNING) {
+      io.advance(100);
+      io.acquire();
+    }
+    plant.write8(0);   // AutoModeTick: pumps.allOff() al cerrar cada ciclo
+    plant.endCycle();
+
+    // Fin de una corrida AUTO (todas las muestras o abortada): política de escritura
+    const bool runEnd = engine.state() != RecipeRunState::DONE || io.currentSample + 1 == prm.samples;
+    if (learn && runEnd && learner.wantsSave(plant.now())) {
+      learner.markSaved(plant.now());
+      saves++;
+    }
+
+    if (engine.state() == RecipeRunState::DONE) {
+      done++;
+      cycleS.push_back(engine.elapsedMs() / 1000.0f);
+      if (isfinite(io.readPH)) errPH.push_back(fabsf(io.readPH - pc.samplePH[io.currentSample % 4]));
+      if (io.stable) { stableN++; stableS.push_back(io.stableMs / 1000.0f); }
+      for (uint8_t i = 0; i < recipe.count; ++i) {
+        const RecipeStep& s = recipe.steps[i];
+        if (s.guard == RecipeGuard::NONE) continue;
+        sensorSum[i] += io.reports[i].sensorMs / 1000.0;
+        sensorN[i]++;
+      }
+    } else {
+      // El firmware sale de AUTO; aquí se sigue como si el maestro
+      // volviera a pedir la medición
+      aborted++;
+      if (engine.abortOutcome() == RecipeOutcome::TIMEOUT) timeouts++;
+      else failures++;
+      if (engine.abortStep() >= 0) abortAt[engine.abortStep()]++;
+    }
+  }
+  const double wallS = (double)(clock() - wall0) / CLOCKS_PER_SEC;
+
+  // ---------- Reporte ----------
+  const uint32_t ran = done + aborted;
+  float mean = 0;
+  for (float x : cycleS) mean += x;
+  if (!cycleS.empty()) mean /= cycleS.size();
+  float errMean = 0;
+  for (float x : errPH) errMean += x;
+  if (!errPH.empty()) errMean /= errPH.size();
+
+  printf("ciclos: %u  completos: %u  abortados: %u (timeout %u, fallo %u)\n",
+         ran, done, aborted, timeouts, failures);
+  printf("tasa de timeout: %.2f%%\n", ran ? 100.0 * timeouts / ran : 0.0);
+  printf("tiempo de ciclo: media %.1f s  p95 %.1f s  max %.1f s\n",
+         mean, percentile(cycleS, 0.95f), percentile(cycleS, 1.0f));
+  printf("rebalses: %u eventos (%.1f mL, %.2f por ciclo)\n",
+         plant.overfillEvents(), plant.overflowMl(), ran ? (double)plant.overfillEvents() / ran : 0.0);
+  printf("cortes por guarda: %u en el flanco, %u tras el HOLD (esp_timer)\n", io.guardCuts, io.plannedOffs);
+  printf("estabilidad: %u/%u estables, mediana %.1f s\n", stableN, done,
+         stableS.empty() ? 0.0 : percentile(stableS, 0.5f));
+  printf("error de pH |medido - muestra|: media %.3f  p95 %.3f  max %.3f\n",
+         errMean, percentile(errPH, 0.95f), percentile(errPH, 1.0f));
+  for (uint8_t i = 0; i < recipe.count; ++i) {
+    if (!sensorN[i] && !abortAt[i]) continue;
+    printf("  paso %-2u %-5s %-9s espera sensor media %.2f s  abortos %u\n", i,
+           recipeOpName(recipe.steps[i].op), recipeGuardName(recipe.steps[i].guard),
+           sensorN[i] ? sensorSum[i] / sensorN[i] : 0.0, abortAt[i]);
+  }
+  if (learn) {
+    printf("aprendizaje: %u escrituras a EEPROM\n", saves);
+    for (uint8_t i = 0; i < FillLearnData::MAX_ENTRIES; ++i) {
+      const FillLearnEntry& e = learner.data().e[i];
+      if (e.step == 0xFF) continue;
+      printf("  paso %-2u %-8s n=%-4u media %.2f s  sigma %.2f s  timeout %.2f s  llenado x%.2f\n",
+             e.step, recipeActName(e.pump), e.n, e.mean / 1000.0, sqrt(e.var) / 1000.0,
+             e.timeoutMs / 1000.0, e.baseMean > 0 ? e.mean / e.baseMean : 1.0);
+    }
+  }
+  printf("desgaste final de bombas: %.1f%%  deriva acumulada: %.2f mV\n",
+         plant.pumpWear() * 100.0f, pc.driftMvPerH * plant.now() / 3.6e6);
+  printf("tiempo virtual %.2f h en %.2f s reales (x%.0f)\n",
+         plant.now() / 3.6e6, wallS, wallS > 0 ? plant.now() / 1000.0 / wallS : 0.0);
+  return 0;
+}
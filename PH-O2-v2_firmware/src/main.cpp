@@ -1,17 +1,27 @@
 #include "WiFiPortalManager.h"
 #include "eeprom_manager.h"
 #include "menu_manager.h"
+#include "menu_tree.h"
 #include "pH_manager.h"
+#include "o2_manager.h"
 #include "pumps_manager.h"
 #include "level_sensors_manager.h"
 #include "test_board.h"
 #include "uart_manager.h"
+#include "acquisition_manager.h"
+#include "stability_detector.h"
+#include "recipe_engine.h"
+#include "fill_learner.h"
+#include "auto_recipe_io.h"
+#include "log_manager.h"
 #include <Arduino.h>
+#include <esp_timer.h>
 #include <globals.h>
 
 
 TaskHandle_t TaskCore0;
 TaskHandle_t TaskCore1;
+TaskHandle_t TaskUart;
 
 WiFiPortalManager wifiManager(TELNET_HOSTNAME, "12345678", SW_DOWN);
 #define RX_PIN 16
@@ -19,7 +29,10 @@ WiFiPortalManager wifiManager(TELNET_HOSTNAME, "12345678", SW_DOWN);
 UartProto::UARTManager uart2(Serial2);
 
 PumpsManager pumps;
-PHManager ph(&ads, /*channel=*/0, /*avgSamples=*/6);
+PHManager ph(&ads, /*channel=*/0, /*sampleBudget=*/48);
+O2Manager o2(&ads, ADS1115Manager::IN_DIFF_23, /*sampleBudget=*/48);
+// Dueña del ADS (A0 y A2-A3) y del DS18B20: pH+O2 cada 500 ms, temperatura cada 2 s
+AcquisitionManager acq(&ph, &o2, &thermo, /*phPeriodMs=*/500, /*tempPeriodMs=*/2000);
 ConfigStore eeprom;
 LevelSensorsManager levels; 
 
@@ -32,21 +45,31 @@ void initThermo();
 void initLCD();
 void initADC();
 void initPH();
+void initO2();
 void initEEPROM();
 void initPumps();
 float readThermo();
 float readADC();
 float readPH();
+float readO2();
 
 void APIUI();
-static void MenuDemoTick();
+static void MenuDemoTick(const UartProto::UartCommand* cmd);
 
 static bool AutoModeTick();
+static void loadAutoRecipe();
+static void applyPendingRecipe();
+static void resetFillLearner();
+static void initLevelEvents();
+static void applyPumpLimits();
 
 void setup() {
   initPumps();
   Serial.begin(115200);
+  logSetSink([](const char* line) { remoteManager.log(line); });
   Serial2.begin(115200);
+  uart2.begin();
+  Serial2.onReceive([]() { uart2.notifyRx(); });   // despierta la tarea del puerto
   initHardware();
   initDualCore();
   initEEPROM();
@@ -56,6 +79,10 @@ void setup() {
   initLCD();
   initADC();
   initPH();
+  initO2();
+  if (!acq.begin(/*core=*/1)) LOG_E(LogMod::SYS, "Adquisicion: no se pudo crear la tarea");
+  initLevelEvents();
+  if (!Buttons::beginEvents()) LOG_W(LogMod::MENU, "Botones: sin interrupciones, se leen por poll");
   startProcess = true;
 }
 
@@ -66,21 +93,36 @@ void testpin(){
   pinMode(SENSOR_LEVEL_H2O, OUTPUT);
   digitalWrite(SENSOR_LEVEL_H2O, HIGH);
   delay(10000);
-  remoteManager.log(String("Pin ") + String(SENSOR_LEVEL_H2O) + " set HIGH.");
+  LOG_I(LogMod::IO, "Pin %d set HIGH.", SENSOR_LEVEL_H2O);
 
   digitalWrite(SENSOR_LEVEL_H2O, LOW);
   delay(10000);
-  remoteManager.log(String("Pin ") + String(SENSOR_LEVEL_H2O) + " set LOW.");
+  LOG_I(LogMod::IO, "Pin %d set LOW.", SENSOR_LEVEL_H2O);
 
   pinMode(SENSOR_LEVEL_H2O, INPUT_PULLUP);
-  remoteManager.log(String("Pin ") + String(SENSOR_LEVEL_H2O) + " set INPUT.");
+  LOG_I(LogMod::IO, "Pin %d set INPUT.", SENSOR_LEVEL_H2O);
   delay(1000);
 
-  remoteManager.log(String("Pin ") + String(SENSOR_LEVEL_H2O) + " test done." + String("state=") + String(digitalRead(SENSOR_LEVEL_H2O)));
+  LOG_I(LogMod::IO, "Pin %d test done.state=%d", SENSOR_LEVEL_H2O, digitalRead(SENSOR_LEVEL_H2O));
 }
 
+// Control: tick del menú cada 100 ms, pero un comando UART lo despierta
+// en el acto (bloquea en la cola de comandos en vez de dormir)
 void taskCore0(void *pvParameters) {
+  const TickType_t PERIOD = pdMS_TO_TICKS(100);
+  TickType_t next = xTaskGetTickCount() + PERIOD;
   for (;;) {
+    const TickType_t now = xTaskGetTickCount();
+    const TickType_t wait = ((int32_t)(next - now) > 0) ? next - now : 0;
+
+    UartProto::UartCommand cmd;
+    const bool gotCmd = uart2.nextCommand(cmd, wait);
+    if (!gotCmd) {
+      next += PERIOD;
+      // Un tick largo (splash, lectura bloqueante) no acumula atraso
+      if ((int32_t)(xTaskGetTickCount() - next) > 0) next = xTaskGetTickCount() + PERIOD;
+    }
+
     if (startProcess) {
 
       // TestBoard::testPumps(PUMP_1, PUMP_2, PUMP_3, PUMP_4, MIXER);
@@ -88,14 +130,12 @@ void taskCore0(void *pvParameters) {
       // TestBoard::testButtons();
       // readADS();
       // readPH();
-      MenuDemoTick();
+      MenuDemoTick(gotCmd ? &cmd : nullptr);
       // AutoModeTick();
       // testpin();
 
 
     }
-
-    vTaskDelay(100 / portTICK_PERIOD_MS); // Espera 100 ms
   }
 }
 // loop
@@ -103,8 +143,22 @@ void taskCore1(void *pvParameters) {
   for (;;) {
     wifiManager.loop();
     remoteManager.handle();
+    vTaskDelay(200 / portTICK_PERIOD_MS); // Espera 200 ms
+  }
+}
+
+// Puerto UART2: duerme hasta que llega algo (onReceive); el timeout solo
+// refresca el último snapshot para get_last
+void taskUart(void *pvParameters) {
+  for (;;) {
+    uart2.waitRx(pdMS_TO_TICKS(1000));
+
+    // UART responde con el último snapshot, sin leer sensores aquí
+    AcqSnapshot s = acq.snapshot();
+    if (s.has(ACQ_TEMP_OK)) uart2.setLastTempC(s.temp_c);
+    if (s.has(ACQ_PH_OK))   uart2.setLastPh(s.ph);
+
     uart2.loop();
-    vTaskDelay(200 / portTICK_PERIOD_MS); // Espera 100 ms
   }
 }
 
@@ -123,6 +177,9 @@ void initDualCore() {
   xTaskCreatePinnedToCore(taskCore1, "TaskCore1", 4096, NULL, 1, &TaskCore1,
                           1 // core 1
   );
+
+  // Puerto UART2 en core 1, por encima del loop de WiFi
+  xTaskCreatePinnedToCore(taskUart, "Uart", 4096, NULL, 2, &TaskUart, 1);
 }
 
 void initHardware() {
@@ -148,7 +205,7 @@ void initWiFi() {
 
 void initThermo() {
   uint8_t n = thermo.begin();
-  remoteManager.log("DS18B20 encontrados: " + String(n));
+  LOG_I(LogMod::SENS, "DS18B20 encontrados: %u", n);
 }
 
 void initLCD() {
@@ -167,7 +224,7 @@ void initLCD() {
 
 void initADC() {
   if (!ads.begin()) {
-    remoteManager.log(String("ADS1115 no responde: ") + ads.lastError());
+    LOG_E(LogMod::SENS, "ADS1115 no responde: %s", ads.lastError());
     return;
   }
   // Rango y tasa recomendados (tu versión usa uint16_t en set/getDataRate)
@@ -180,7 +237,26 @@ void initADC() {
   eeprom.getADC(m, b);
   ads.setCalibration(m, b);
 
-  remoteManager.log("ADS1115 listo (GAIN_ONE, 250SPS)");
+  // Escaneo pH + O2 a 475 SPS con ráfagas de 8: 48 + 48 conversiones entran
+  // en el período de 500 ms de la adquisición con el bus a 100 kHz
+  // (bench/acq_budget_bench.cpp: 446 ms peor caso con el I2C modelado).
+  // Las lecturas sueltas siguen con la tasa global de 250 SPS.
+  AdsChannelConfig phcfg;
+  phcfg.gain  = GAIN_ONE;
+  phcfg.rate  = RATE_ADS1115_475SPS;
+  phcfg.dwell = 8;
+  ads.setChannelConfig(0, phcfg);
+
+  // O2: sonda galvánica en A2-A3, señal de decenas de mV => ±0.256 V
+  AdsChannelConfig o2cfg = phcfg;
+  o2cfg.gain = GAIN_SIXTEEN;
+  ads.setChannelConfig(ADS1115Manager::IN_DIFF_23, o2cfg);
+
+  // Entradas de ADS_SCAN_MASK en round-robin (una sola => continuo); las
+  // lecturas salen del ring de cada entrada sin delays fijos.
+  ads.startScan(ADS_SCAN_MASK, ADS_RDY_PIN);
+
+  LOG_I(LogMod::SENS, "ADS1115 listo (GAIN_ONE, 250SPS; escaneo 475SPS, canales 0x%X)", (unsigned)ADS_SCAN_MASK);
 }
 
 void initPH() {
@@ -200,13 +276,11 @@ void initPH() {
     ph.setTwoPointCalibration(7.00f, V7, 4.00f, V4, tCalC);
 
     // Log de verificación
-    remoteManager.log(String("pH cal cargada: V7=") + String(V7, 5) + " V4=" +
-                      String(V4, 5) + " Tcal=" + String(tCalC, 1) + "C");
+    LOG_I(LogMod::CAL, "pH cal cargada: V7=%.5f V4=%.5f Tcal=%.1fC", V7, V4, tCalC);
   } else {
     // No hay datos persistidos aún: dejar sin cal específica o valores por
     // defecto
-    remoteManager.log(
-        "pH cal: no hay V7/V4 en EEPROM. Usa defaults o ejecuta cal.");
+    LOG_W(LogMod::CAL, "pH cal: no hay V7/V4 en EEPROM. Usa defaults o ejecuta cal.");
     // Si tu clase 'ph' requiere un estado definido, puedes fijar un default
     // aquí:
     ph.setTwoPointCalibration(7.00f, 1.650f, 4.00f, 1.650f,
@@ -214,12 +288,26 @@ void initPH() {
   }
 }
 
+void initO2() {
+  o2.begin();
+  if (o2.applyEEPROMCalibration(eeprom)) {
+    float vz, vs, tc;
+    eeprom.getO2Cal(vz, vs, tc);
+    LOG_I(LogMod::CAL, "O2 cal cargada: %s Vsat=%.2fmV Tcal=%.1fC",
+          isnan(vz) ? "1p" : "2p", vs * 1000.0f, tc);
+  } else {
+    LOG_W(LogMod::CAL, "O2 cal: no hay calibracion en EEPROM. Ejecuta cal O2.");
+  }
+}
+
 void initEEPROM() {
-  eeprom.begin(256);
+  eeprom.begin(512);
   if (!eeprom.load()) {
     eeprom.resetDefaults();
     eeprom.save();
   }
+  loadAutoRecipe();
+  applyPumpLimits();
 
   // float m,b;
   // eeprom.getADC(m,b);
@@ -237,99 +325,137 @@ static const int  PCF_ADDR    = 0x20;
   pumps.allOff();
 }
 
+// Lecturas para la UI: salen del snapshot de la tarea de adquisición
+// (instantáneas). Con la adquisición en pausa (calibraciones) leen directo.
 float readADC() {
-  // Lee A0..A3 single-ended
-  // for (uint8_t ch = 0; ch < 4; ch++) {
-  //   float v;
-  //   if (ads.readSingle(ch, v)) {
-  //     remoteManager.log("A" + String(ch) + ": " + String(v, 6) + " V");
-  //   } else {
-  //     remoteManager.log(String("ADS err A") + ch + ": " + ads.lastError());
-  //   }
-  // }
-  float v;
-  if (ads.readSingle(0, v)) {
-    remoteManager.log("A0"
-                      ": " +
-                      String(v, 6) + " V");
-    return v;
-  } else {
-    remoteManager.log(String("ADS err A0") + ": " + ads.lastError());
+  if (acq.isPaused()) {
+    float v;
+    if (ads.readSingle(0, v)) return v;
+    LOG_E(LogMod::SENS, "ADS err A0: %s", ads.lastError());
     return -1;
   }
+
+  AcqSnapshot s = acq.snapshot();
+  if (!s.has(ACQ_PH_OK)) {
+    LOG_W(LogMod::SENS, "%s", s.seq ? "ADS err A0" : "ADS A0: sin datos aun");
+    return -1;
+  }
+  LOG_I(LogMod::SENS, "A0: %.6f V", s.volts);
+  return s.volts;
+}
+
+// Todos los DS18B20 en una línea: "T0=24.50 T1=-- (crc2 nr0 por0)"
+static void logThermoProbes(const DS18B20Snapshot& s) {
+  if (!LOG_ON(LOG_LVL_INFO, LogMod::SENS)) return;
+  char line[LOG_LINE_MAX];
+  size_t n = snprintf(line, sizeof(line), "DS18B20:");
+  for (uint8_t i = 0; i < s.count && n < sizeof(line); ++i) {
+    const DS18B20Probe& p = s.probe[i];
+    if (p.fresh) n += snprintf(line + n, sizeof(line) - n, " T%u=%.2f", i, p.c);
+    else         n += snprintf(line + n, sizeof(line) - n, " T%u=--", i);
+    if (n < sizeof(line) && (p.crcErrors || p.noResponse || p.porErrors))
+      n += snprintf(line + n, sizeof(line) - n, " (crc%u nr%u por%u)",
+                    (unsigned)p.crcErrors, (unsigned)p.noResponse, (unsigned)p.porErrors);
+  }
+  LOG_I(LogMod::SENS, "%s", line);
 }
 
 float readThermo() {
   if (thermo.sensorCount() == 0) {
     // Serial.println("Sin sensores");
-    remoteManager.log("Sin sensores");
-    // delay(1000);
+    LOG_W(LogMod::SENS, "Sin sensores");
     return -1;
   }
-  float c = thermo.readC(0);
+
+  float c = NAN;
+  DS18B20Snapshot ps;
+  if (acq.isPaused()) {
+    // Una conversión para todos los sensores (mismo costo que leer uno)
+    thermo.readAll(ps);
+    if (ps.probe[0].fresh) c = ps.probe[0].c;
+  } else {
+    AcqSnapshot s = acq.snapshot();
+    if (s.has(ACQ_TEMP_OK)) c = s.temp_c;
+    ps = acq.probes();
+  }
+  if (ps.count > 1) logThermoProbes(ps);
+
   if (isnan(c)) {
     // Serial.println("Lectura inválida");
-    remoteManager.log("Lectura inválida");
+    LOG_W(LogMod::SENS, "Lectura inválida");
     return -1;
   } else {
     // Serial.printf("T0: %.2f °C\n", c);
-    remoteManager.log("T: " + String(c) + " °C");
+    LOG_I(LogMod::SENS, "T: %.2f °C", c);
     uart2.setLastTempC(c);
     return c;
   }
-  // delay(1000);
 }
 
-float readPH() {
-  extern ConfigStore eeprom;
-  extern UartProto::UARTManager uart2;
-  extern float readThermo();
-
-  // 1) Leer temperatura actual (para compensación)
-  float tC = readThermo();
-  bool tOk = isfinite(tC) && tC > -40.0f && tC < 125.0f;
-  if (!tOk) tC = 25.0f; // fallback si el sensor falla
-  uart2.setLastTempC(tC);
-
-  // 2) Leer pH con compensación de temperatura
-  float phValue = NAN, volts = NAN;
-  if (!ph.readPH(tC, phValue, &volts)) {
-    remoteManager.log(String("pH ERR: ") + ph.lastError());
+// Temperatura para pantallas que se redibujan seguido (vistas del menú):
+// último valor convertido del DS18B20, sin esperar una conversión ni
+// loguear. NAN si no hay o tiene más de maxAgeMs
+static float cachedThermoC(uint32_t maxAgeMs) {
+  if (acq.isPaused()) return thermo.cachedC(0, maxAgeMs);   // misma tarea que readAll()
+  // Con adquisición: la copia de thermo.snapshot() que publica su tarea
+  const DS18B20Snapshot ps = acq.probes();
+  if (!ps.count || isnan(ps.probe[0].c) || millis() - ps.probe[0].ms > maxAgeMs) return NAN;
+  return ps.probe[0].c;
+}
+
+// Etiqueta de la calibración vigente para los logs
+static const char* phCalTag() {
+  float V4 = NAN, V7 = NAN, V10 = NAN, Tcal = NAN;
+  eeprom.getPH3pt(V4, V7, V10, Tcal);
+  if (isfinite(V4) && isfinite(V7) && isfinite(V10)) return "[3p]";
+
+  float V7b = NAN, V4b = NAN, Tc2 = NAN;
+  eeprom.getPH2pt(V7b, V4b, Tc2);
+  if (isfinite(V7b) && isfinite(V4b)) return "[2p]";
+  return "[NoCal]";
+}
+
+// Registra un snapshot de pH en log y UART. Retorna el pH o -99 si no es válido.
+static float logPHSnapshot(const AcqSnapshot& s) {
+  if (!s.has(ACQ_PH_OK)) {
+    // ph.lastError() pertenece a la tarea de adquisición: solo los flags
+    LOG_W(LogMod::SENS, "%s", s.seq ? "pH ERR: fallo lectura ADS" : "pH: sin datos aun");
     uart2.setLastPh(-99.0f);
     return -99.0f;
   }
 
-  // 3) Determinar tipo de calibración vigente
-  float V4 = NAN, V7 = NAN, V10 = NAN, Tcal = NAN;
-  bool has3p = false;
-  bool has2p = false;
+  // phCalTag() lee la EEPROM: solo si el log va a salir
+  if (LOG_ON(LOG_LVL_INFO, LogMod::SENS)) {
+    char rej[12] = "";
+    if (s.rejected) snprintf(rej, sizeof(rej), "/-%u", (unsigned)s.rejected);
+    LOG_I(LogMod::SENS, "pH %s = %.3f ±%.3f  V=%.4f  n=%u%s  T=%.1f°C%s  edad=%lums",
+          phCalTag(), s.ph, s.ci95_ph, s.volts, (unsigned)s.samples, rej,
+          s.temp_c, s.has(ACQ_TEMP_FALLBACK) ? " (fallback)" : "",
+          (unsigned long)(millis() - s.ph_ms));
+  }
 
-  // Intentar leer 3 puntos (si el layout lo tiene)
-  eeprom.getPH3pt(V4, V7, V10, Tcal);
-  if (isfinite(V4) && isfinite(V7) && isfinite(V10)) has3p = true;
+  uart2.setLastTempC(s.temp_c);
+  uart2.setLastPh(s.ph);
+  return s.ph;
+}
 
-  // Si no hay 3 puntos válidos, intentar 2 puntos
-  if (!has3p) {
-    float V7b = NAN, V4b = NAN, Tc2 = NAN;
-    eeprom.getPH2pt(V7b, V4b, Tc2);
-    if (isfinite(V7b) && isfinite(V4b)) has2p = true;
-  }
+float readPH() {
+  return logPHSnapshot(acq.snapshot());
+}
 
-  // 4) Mostrar en log UART según tipo de calibración
-  String calTag;
-  if (has3p)      calTag = "[3p]";
-  else if (has2p) calTag = "[2p]";
-  else            calTag = "[NoCal]";
-
-  // 5) Registro en log y UART
-  remoteManager.log(
-    "pH " + calTag + " = " + String(phValue, 3) +
-    "  V=" + String(volts, 4) +
-    "  T=" + String(tC, 1) + "°C"
-  );
+// O2 del snapshot (mg/L). NAN si no hay lectura válida (sin calibrar o error).
+static float logO2Snapshot(const AcqSnapshot& s) {
+  if (!s.has(ACQ_O2_OK)) {
+    LOG_W(LogMod::SENS, "%s", o2.isCalibrated() ? "O2 ERR: sin lectura" : "O2: sin calibrar");
+    return NAN;
+  }
+  LOG_I(LogMod::SENS, "O2 = %.2f mg/L  (%.1f%%)  V=%.2fmV  T=%.1f°C",
+        s.o2_mgl, s.o2_sat_pct, s.o2_volts * 1000.0f, s.temp_c);
+  return s.o2_mgl;
+}
 
-  uart2.setLastPh(phValue);
-  return phValue;
+float readO2() {
+  return logO2Snapshot(acq.snapshot());
 }
 
 static bool runADSCalibration_0V_3p31V(uint8_t channel = 0,
@@ -375,13 +501,16 @@ static bool runADSCalibration_0V_3p31V(uint8_t channel = 0,
 
   switch (step) {
   case Step::START: {
+    // El wizard usa el ADS directo: detiene la adquisición hasta DONE
+    acq.pause();
+
     // Medir "en crudo": desactiva cal temporalmente
     ads.setCalibration(1.0f, 0.0f);
     ads.setAveraging(samples);
 
     lcd.clear();
     showStep0();
-    remoteManager.log("ADS cal: START -> 0V");
+    LOG_I(LogMod::CAL, "ADS cal: START -> 0V");
     step = Step::WAIT_ZERO;
     return false;
   }
@@ -400,13 +529,13 @@ static bool runADSCalibration_0V_3p31V(uint8_t channel = 0,
     showBusy("Midiendo 0V...");
     float v;
     if (!ads.readSingle(channel, v)) {
-      remoteManager.log("ADS cal: fallo lectura 0V");
+      LOG_E(LogMod::CAL, "ADS cal: fallo lectura 0V");
       showError("Error lectura", "0V");
       step = Step::CANCEL;
       return false;
     }
     v_meas_0 = v; // sin cal (m=1, b=0)
-    remoteManager.log(String("ADS cal: V_meas0=") + String(v_meas_0, 6));
+    LOG_I(LogMod::CAL, "ADS cal: V_meas0=%.6f", v_meas_0);
 
     lcd.splash("0V capturado", "", 500);
     lcd.clear();
@@ -429,13 +558,13 @@ static bool runADSCalibration_0V_3p31V(uint8_t channel = 0,
     showBusy("Mid. 3.31V...");
     float v;
     if (!ads.readSingle(channel, v)) {
-      remoteManager.log("ADS cal: fallo lectura Vref");
+      LOG_E(LogMod::CAL, "ADS cal: fallo lectura Vref");
       showError("Error lectura", "Vref");
       step = Step::CANCEL;
       return false;
     }
     v_meas_ref = v; // sin cal
-    remoteManager.log(String("ADS cal: V_measRef=") + String(v_meas_ref, 6));
+    LOG_I(LogMod::CAL, "ADS cal: V_measRef=%.6f", v_meas_ref);
     step = Step::APPLY;
     return false;
   }
@@ -457,14 +586,13 @@ static bool runADSCalibration_0V_3p31V(uint8_t channel = 0,
     // Persiste en EEPROM (usa tu instancia global 'eeprom')
     eeprom.setADC(scale, offset);
     if (!eeprom.save()) {
-      remoteManager.log(String("EEPROM save fallo: ") + eeprom.lastError());
+      LOG_E(LogMod::SYS, "EEPROM save fallo: %s", eeprom.lastError());
       showError("EEPROM", "Save fallo");
       step = Step::DONE; // igual finalizamos
       return false;
     }
 
-    remoteManager.log(String("ADS cal aplicada: m=") + String(scale, 6) +
-                      " b=" + String(offset, 6));
+    LOG_I(LogMod::CAL, "ADS cal aplicada: m=%.6f b=%.6f", scale, offset);
     char l2[17];
     snprintf(l2, sizeof(l2), "m=%.3f b=%.3f", scale, offset);
     lcd.splash("ADS calibrado", l2, 800);
@@ -474,18 +602,66 @@ static bool runADSCalibration_0V_3p31V(uint8_t channel = 0,
   }
 
   case Step::CANCEL:
-    remoteManager.log("ADS cal: CANCEL");
+    LOG_I(LogMod::CAL, "ADS cal: CANCEL");
     showError("Calibracion", "Cancelada");
     step = Step::DONE;
     return false;
 
   case Step::DONE:
   default:
+    acq.resume();
     step = Step::START; // listo para próxima vez
     return true;        // informa al caller que ya terminó
   }
 }
 
+// ---- Espera de estabilidad del electrodo en los wizards de pH ----
+// El ADS es exclusivo del wizard (acq en pausa): cada ~300 ms mide un bloque
+// corto y alimenta el detector. Termina por estabilidad, por tope o porque
+// el operador fuerza la captura con OK. Retorna true al terminar.
+static StabilityConfig calStabilityConfig() {
+  StabilityConfig c;          // 1.2 mV/min, ventana 15 s, hold 5 s
+  c.minMs = 5000;
+  c.maxMs = 180000;           // 3 min: electrodo lento o sucio
+  return c;
+}
+
+static bool calStabilityTick(StabilityDetector& det, const char* titulo, const char* etiqueta) {
+  static uint32_t tLast = 0;
+  const uint32_t now = millis();
+  if (now - tLast >= 300) {
+    tLast = now;
+    PHSampleBudget b;
+    b.maxSamples = 16;
+    b.minSamples = 16;
+    PHEstimate e;
+    if (ph.measureVolts(b, e) && e.count >= 3) det.push(millis(), e.value);
+    else                                       det.tick(millis());
+  } else {
+    det.tick(now);
+  }
+
+  const bool forced = Buttons::BTN_OK.value;
+  if (forced) Buttons::BTN_OK.reset();
+
+  char l0[17], l1[17];
+  snprintf(l0, sizeof(l0), "%-12s OK", titulo);
+  const unsigned long s = (unsigned long)(det.elapsedMs() / 1000UL);
+  if (isfinite(det.driftPerMin()))
+    snprintf(l1, sizeof(l1), "%-4s%+5.1fmV/m%3lu", etiqueta, det.driftPerMin() * 1000.0f, s);
+  else
+    snprintf(l1, sizeof(l1), "%-4s estab.. %3lus", etiqueta, s);
+  lcd.printAt(0, 0, l0);
+  lcd.printAt(0, 1, l1);
+
+  if (!forced && !det.done()) return false;
+  const char* fin = forced ? "forzado" :
+                    (det.state() == StabilityState::STABLE) ? "estable" : "tope";
+  LOG_I(LogMod::CAL, "pH cal: %s %s en %.1f s deriva=%.2f mV/min",
+        etiqueta, fin, det.elapsedMs() / 1000.0f, det.driftPerMin() * 1000.0f);
+  return true;
+}
+
 static bool runPHCalibration_7_4(uint8_t samples = 64) {
   // Externs típicos del proyecto
   extern PHManager               ph;
@@ -498,8 +674,10 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
   enum class Step : uint8_t {
     START,
     WAIT_7,
+    STAB_7,
     CAPT_7,
     WAIT_4,
+    STAB_4,
     CAPT_4,
     APPLY,
     DONE,
@@ -509,6 +687,7 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
 
   static float V7 = NAN, V4 = NAN; // voltajes (mediana)
   static float T1 = NAN, T2 = NAN; // temperaturas (trazabilidad)
+  static StabilityDetector stab;   // espera hasta que el electrodo deja de derivar
 
   // --- UI helpers ---
   auto title = []() { lcd.printAt(0, 0, "Calibrar pH"); };
@@ -517,62 +696,23 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
   auto busy = [&](const char *m){ title(); lcd.printAt(0, 1, m); };
   auto showErr = [](const char *a, const char *b = "") { lcd.splash(a, b, 900); };
 
-  // ---- Utilidad: ordenación por insertion sort (simple y estable) ----
-  auto insertionSort = [](float* arr, uint16_t n){
-    for (uint16_t i = 1; i < n; ++i) {
-      float key = arr[i];
-      int j = (int)i - 1;
-      while (j >= 0 && arr[j] > key) {
-        arr[j+1] = arr[j];
-        --j;
-      }
-      arr[j+1] = key;
-    }
-  };
-
-  // ---- Mediana del VOLTAJE usando ph.readPH() (con compensación T) ----
+  // ---- Voltaje del buffer: un estimador (Hampel + media) con presupuesto = samples ----
+  // La temperatura no interviene en el voltaje: se lee aparte en T1/T2.
   auto medianVoltPH = [&](uint16_t N) -> float {
-    // Bound razonable para stack en microcontrolador
-    static constexpr uint16_t MAX_S = 128;
-    if (N == 0) N = 1;
-    if (N > MAX_S) N = MAX_S;
-
-    float buf[MAX_S];
-    uint16_t k = 0;
-
-    for (uint16_t i = 0; i < N; ++i) {
-      float tC = readThermo();
-      bool tOk = isfinite(tC) && tC > -40.0f && tC < 125.0f;
-      float tUsed = tOk ? tC : 25.0f;
-
-      float phVal = NAN, v = NAN;
-      if (!ph.readPH(tUsed, phVal, &v)) {
-        // si una lectura falla, simplemente la omitimos
-      } else if (isfinite(v)) {
-        buf[k++] = v;
-      }
-      delay(4); // pequeño settling
-    }
-
-    if (k < 3) {
-      // muy pocas válidas para una mediana robusta
-      return NAN;
-    }
-
-    insertionSort(buf, k);
-    if (k & 1) {
-      // impar
-      return buf[k/2];
-    } else {
-      // par
-      uint16_t r = k/2;
-      return 0.5f * (buf[r-1] + buf[r]);
-    }
+    PHSampleBudget b;
+    b.maxSamples = N ? N : 1;
+    b.minSamples = b.maxSamples / 2;
+    b.ciTarget   = 0.0005f;             // ±0.5 mV IC95
+    PHEstimate e;
+    if (!ph.measureVolts(b, e) || e.count < 3) return NAN;
+    LOG_I(LogMod::CAL, "pH cal: n=%u desc=%u ruido=%.3f mV",
+          (unsigned)e.count, (unsigned)e.rejected, e.noise * 1000.0f);
+    return e.value;
   };
 
   switch (step) {
     case Step::START: {
-      ads.setAveraging(samples);
+      acq.pause();   // ADS y DS18B20 exclusivos del wizard hasta DONE
       lcd.clear();
       ask7();
       step = Step::WAIT_7;
@@ -581,7 +721,17 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
 
     case Step::WAIT_7: {
       if (Buttons::BTN_ESC.value) { Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
-      if (Buttons::BTN_OK.value)  { Buttons::BTN_OK.reset();  step = Step::CAPT_7; return false; }
+      if (Buttons::BTN_OK.value)  {
+        Buttons::BTN_OK.reset();
+        stab.begin(calStabilityConfig(), millis());
+        step = Step::STAB_7;
+      }
+      return false;
+    }
+
+    case Step::STAB_7: {
+      if (Buttons::BTN_ESC.value) { Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
+      if (calStabilityTick(stab, "Estabilizando", "pH7")) step = Step::CAPT_7;
       return false;
     }
 
@@ -594,7 +744,7 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
         step = Step::CANCEL;
         return false;
       }
-      if (&remoteManager) remoteManager.log(String("pH cal: V7=") + String(V7,5) + " T1=" + String(T1,1));
+      LOG_I(LogMod::CAL, "pH cal: V7=%.5f T1=%.1f", V7, T1);
       lcd.splash("pH 7.00 OK", "", 600);
       lcd.clear();
       ask4();
@@ -604,7 +754,17 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
 
     case Step::WAIT_4: {
       if (Buttons::BTN_ESC.value) { Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
-      if (Buttons::BTN_OK.value)  { Buttons::BTN_OK.reset();  step = Step::CAPT_4; return false; }
+      if (Buttons::BTN_OK.value)  {
+        Buttons::BTN_OK.reset();
+        stab.begin(calStabilityConfig(), millis());
+        step = Step::STAB_4;
+      }
+      return false;
+    }
+
+    case Step::STAB_4: {
+      if (Buttons::BTN_ESC.value) { Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
+      if (calStabilityTick(stab, "Estabilizando", "pH4")) step = Step::CAPT_4;
       return false;
     }
 
@@ -617,7 +777,7 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
         step = Step::CANCEL;
         return false;
       }
-      if (&remoteManager) remoteManager.log(String("pH cal: V4=") + String(V4,5) + " T2=" + String(T2,1));
+      LOG_I(LogMod::CAL, "pH cal: V4=%.5f T2=%.1f", V4, T2);
       step = Step::APPLY;
       return false;
     }
@@ -643,9 +803,9 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
       #endif
 
       if (!eeprom.save()) {
-        if (&remoteManager) remoteManager.log(String("EEPROM save PH2pt fallo: ") + eeprom.lastError());
+        LOG_E(LogMod::SYS, "EEPROM save PH2pt fallo: %s", eeprom.lastError());
       } else {
-        if (&remoteManager) remoteManager.log("EEPROM: PH2pt guardado (3p invalidado)");
+        LOG_I(LogMod::SYS, "EEPROM: PH2pt guardado (3p invalidado)");
       }
 
       uart2.setLastResult("CAL_PH_2PT_OK");
@@ -653,7 +813,7 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
       char l2[17];
       snprintf(l2, sizeof(l2), "V7=%.3f V4=%.3f", V7, V4);
       lcd.splash("pH calibrado", l2, 900);
-      if (&remoteManager) remoteManager.log(String("pH cal 2pt OK (Tcal=") + String(tCalC,1) + "C)");
+      LOG_I(LogMod::CAL, "pH cal 2pt OK (Tcal=%.1fC)", tCalC);
       step = Step::DONE;
       return false;
     }
@@ -667,6 +827,7 @@ static bool runPHCalibration_7_4(uint8_t samples = 64) {
 
     case Step::DONE:
     default: {
+      acq.resume();
       step = Step::START;
       return true;
     }
@@ -683,9 +844,9 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
 
   enum class Step : uint8_t {
     START,
-    WAIT_4,  CAPT_4,
-    WAIT_7,  CAPT_7,
-    WAIT_10, CAPT_10,
+    WAIT_4,  STAB_4,  CAPT_4,
+    WAIT_7,  STAB_7,  CAPT_7,
+    WAIT_10, STAB_10, CAPT_10,
     APPLY,
     DONE,
     CANCEL
@@ -695,6 +856,7 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
   // Voltajes (mediana) y temperaturas (trazabilidad)
   static float V4 = NAN, V7 = NAN, V10 = NAN;
   static float T4 = NAN, T7 = NAN, T10 = NAN;
+  static StabilityDetector stab;
 
   // --- UI helpers ---
   auto title = []() { lcd.printAt(0,0,"Calibrar pH 3pt"); };
@@ -717,62 +879,51 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
     lcd.printAt(0,1,l1);
   };
 
-  // ---- Utilidades: insertion sort + mediana ----
-  auto insertionSort = [](float* arr, uint16_t n){
-    for (uint16_t i = 1; i < n; ++i) {
-      float key = arr[i];
-      int j = (int)i - 1;
-      while (j >= 0 && arr[j] > key) { arr[j+1] = arr[j]; --j; }
-      arr[j+1] = key;
-    }
-  };
-  auto medianFrom = [&](float* buf, uint16_t k) -> float {
-    if (k < 3) return NAN;              // muy pocas válidas para robustez
-    insertionSort(buf, k);
-    if (k & 1) return buf[k/2];
-    uint16_t r = k/2; return 0.5f*(buf[r-1] + buf[r]);
-  };
-
-  // ---- Mediana del VOLTAJE (con compensación T) mostrando % de progreso ----
+  // ---- Voltaje del buffer (estimador con presupuesto) mostrando % de progreso ----
   auto medianVoltPH = [&](uint16_t N, const char* etiqueta) -> float {
-    static constexpr uint16_t MAX_S = 128;
-    if (N == 0) N = 1;
-    if (N > MAX_S) N = MAX_S;
-
-    float buf[MAX_S];
-    uint16_t k = 0;
-
-    for (uint16_t i = 0; i < N; ++i) {
-      showProgressPct(etiqueta, (uint16_t)(i+1), N);
-
-      float tC = readThermo();
-      bool tOk = isfinite(tC) && tC > -40.0f && tC < 125.0f;
-      float tUsed = tOk ? tC : 25.0f;
-
-      float phVal = NAN, v = NAN;
-      if (ph.readPH(tUsed, phVal, &v) && isfinite(v)) {
-        buf[k++] = v;
-      }
-      delay(4);
+    PHSampleBudget b;
+    b.maxSamples = N ? N : 1;
+    b.minSamples = b.maxSamples / 2;
+    b.ciTarget   = 0.0005f;             // ±0.5 mV IC95
+    if (!ph.beginVolts(b)) return NAN;
+
+    bool done = false;
+    while (!done) {
+      if (!ph.stepVolts(done)) return NAN;
+      const PHEstimate& e = ph.voltsEstimate();
+      showProgressPct(etiqueta, (uint16_t)(e.count + e.rejected), b.maxSamples);
     }
-    return medianFrom(buf, k);
+    const PHEstimate& e = ph.voltsEstimate();
+    if (e.count < 3) return NAN;         // muy pocas válidas para robustez
+    LOG_I(LogMod::CAL, "pH 3pt: %s n=%u desc=%u ruido=%.3f mV",
+          etiqueta, (unsigned)e.count, (unsigned)e.rejected, e.noise * 1000.0f);
+    return e.value;
   };
 
   Buttons::testButtons();
 
   switch (step) {
     case Step::START: {
-      ads.setAveraging((uint8_t)min<uint16_t>(samples, 255));
+      acq.pause();   // ADS y DS18B20 exclusivos del wizard hasta DONE
       V4 = V7 = V10 = NAN;  T4 = T7 = T10 = NAN;
       lcd.clear(); ask4();
-      if (&remoteManager) remoteManager.log("pH 3pt: START -> pH4");
+      LOG_I(LogMod::CAL, "pH 3pt: START -> pH4");
       step = Step::WAIT_4;
       return false;
     }
 
     case Step::WAIT_4:
       if (Buttons::BTN_ESC.value){ Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
-      if (Buttons::BTN_OK.value) { Buttons::BTN_OK.reset();  step = Step::CAPT_4;  return false; }
+      if (Buttons::BTN_OK.value) {
+        Buttons::BTN_OK.reset();
+        stab.begin(calStabilityConfig(), millis());
+        step = Step::STAB_4;
+      }
+      return false;
+
+    case Step::STAB_4:
+      if (Buttons::BTN_ESC.value){ Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
+      if (calStabilityTick(stab, "Estabilizando", "pH4")) step = Step::CAPT_4;
       return false;
 
     case Step::CAPT_4: {
@@ -780,7 +931,7 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
       V4 = medianVoltPH(samples, "pH4");
       T4 = readThermo();
       if (!isfinite(V4)) { splash("Error lectura","pH 4.00", 900); step = Step::CANCEL; return false; }
-      if (&remoteManager) remoteManager.log(String("pH 3pt: V4=")+String(V4,5)+" T4="+String(T4,1));
+      LOG_I(LogMod::CAL, "pH 3pt: V4=%.5f T4=%.1f", V4, T4);
       splash("pH 4.00 OK","",600);
       lcd.clear(); ask7();
       step = Step::WAIT_7;
@@ -789,7 +940,16 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
 
     case Step::WAIT_7:
       if (Buttons::BTN_ESC.value){ Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
-      if (Buttons::BTN_OK.value) { Buttons::BTN_OK.reset();  step = Step::CAPT_7;  return false; }
+      if (Buttons::BTN_OK.value) {
+        Buttons::BTN_OK.reset();
+        stab.begin(calStabilityConfig(), millis());
+        step = Step::STAB_7;
+      }
+      return false;
+
+    case Step::STAB_7:
+      if (Buttons::BTN_ESC.value){ Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
+      if (calStabilityTick(stab, "Estabilizando", "pH7")) step = Step::CAPT_7;
       return false;
 
     case Step::CAPT_7: {
@@ -797,7 +957,7 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
       V7 = medianVoltPH(samples, "pH7");
       T7 = readThermo();
       if (!isfinite(V7)) { splash("Error lectura","pH 7.00", 900); step = Step::CANCEL; return false; }
-      if (&remoteManager) remoteManager.log(String("pH 3pt: V7=")+String(V7,5)+" T7="+String(T7,1));
+      LOG_I(LogMod::CAL, "pH 3pt: V7=%.5f T7=%.1f", V7, T7);
       splash("pH 7.00 OK","",600);
       lcd.clear(); ask10();
       step = Step::WAIT_10;
@@ -806,7 +966,16 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
 
     case Step::WAIT_10:
       if (Buttons::BTN_ESC.value){ Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
-      if (Buttons::BTN_OK.value) { Buttons::BTN_OK.reset();  step = Step::CAPT_10; return false; }
+      if (Buttons::BTN_OK.value) {
+        Buttons::BTN_OK.reset();
+        stab.begin(calStabilityConfig(), millis());
+        step = Step::STAB_10;
+      }
+      return false;
+
+    case Step::STAB_10:
+      if (Buttons::BTN_ESC.value){ Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
+      if (calStabilityTick(stab, "Estabilizando", "pH10")) step = Step::CAPT_10;
       return false;
 
     case Step::CAPT_10: {
@@ -814,7 +983,7 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
       V10 = medianVoltPH(samples, "pH10");
       T10 = readThermo();
       if (!isfinite(V10)) { splash("Error lectura","pH 10.0", 900); step = Step::CANCEL; return false; }
-      if (&remoteManager) remoteManager.log(String("pH 3pt: V10=")+String(V10,5)+" T10="+String(T10,1));
+      LOG_I(LogMod::CAL, "pH 3pt: V10=%.5f T10=%.1f", V10, T10);
       step = Step::APPLY;
       return false;
     }
@@ -836,14 +1005,14 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
         eeprom.setPHCalMode(ConfigStore::PHCalMode::PH3);
       #endif
       if (!eeprom.save()) {
-        if (&remoteManager) remoteManager.log(String("EEPROM save PH3pt fallo: ")+eeprom.lastError());
+        LOG_E(LogMod::SYS, "EEPROM save PH3pt fallo: %s", eeprom.lastError());
       } else {
-        if (&remoteManager) remoteManager.log("EEPROM: PH3pt guardado");
+        LOG_I(LogMod::SYS, "EEPROM: PH3pt guardado");
       }
 
       // Aplicar al PHManager (modo PW o LS según flag)
       if (!ph.setThreePointCalibration(V4, V7, V10, tCalC, /*piecewise=*/piecewise)) {
-        if (&remoteManager) remoteManager.log("pH 3pt: setThreePointCalibration fallo");
+        LOG_E(LogMod::CAL, "pH 3pt: setThreePointCalibration fallo");
         splash("PHManager","Set cal 3pt fallo", 900);
         step = Step::DONE; return false;
       }
@@ -868,11 +1037,154 @@ static bool runPHCalibration_4_7_10(uint16_t samples = 64, bool piecewise = fals
 
     case Step::DONE:
     default:
+      acq.resume();
       step = Step::START;
       return true;
   }
 }
 
+// Calibración O2: 1 punto (aire saturado) o 2 puntos (solución cero + aire)
+static bool runO2Calibration(bool twoPoint, uint16_t samples = 64) {
+  extern O2Manager               o2;
+  extern float                   readThermo();
+  extern ConfigStore             eeprom;
+  extern UartProto::UARTManager  uart2;
+
+  enum class Step : uint8_t {
+    START,
+    WAIT_ZERO,
+    CAPT_ZERO,
+    WAIT_AIR,
+    CAPT_AIR,
+    APPLY,
+    DONE,
+    CANCEL
+  };
+  static Step step = Step::START;
+
+  static float Vzero = NAN, Vsat = NAN;
+  static float T1 = NAN, T2 = NAN;
+
+  // --- UI helpers ---
+  auto title   = []() { lcd.printAt(0, 0, "Calibrar O2"); };
+  auto askZero = [&]() { title(); lcd.printAt(0, 1, "Sol. cero    OK"); };
+  auto askAir  = [&]() { title(); lcd.printAt(0, 1, "Aire sat.    OK"); };
+  auto busy    = [&](const char *m){ title(); lcd.printAt(0, 1, m); };
+  auto showErr = [](const char *a, const char *b = "") { lcd.splash(a, b, 900); };
+
+  // Señal de la sonda con el mismo estimador que el pH
+  auto measure = [&](uint16_t N) -> float {
+    PHSampleBudget b;
+    b.maxSamples = N ? N : 1;
+    b.minSamples = b.maxSamples / 2;
+    b.ciTarget   = 0.00005f;            // ±0.05 mV IC95
+    PHEstimate e;
+    if (!o2.measureVolts(b, e) || e.count < 3) return NAN;
+    LOG_I(LogMod::CAL, "O2 cal: n=%u desc=%u ruido=%.3f mV",
+          (unsigned)e.count, (unsigned)e.rejected, e.noise * 1000.0f);
+    return e.value;
+  };
+
+  switch (step) {
+    case Step::START: {
+      acq.pause();   // ADS y DS18B20 exclusivos del wizard hasta DONE
+      Vzero = Vsat = NAN;  T1 = T2 = NAN;
+      lcd.clear();
+      if (twoPoint) { askZero(); step = Step::WAIT_ZERO; }
+      else          { askAir();  step = Step::WAIT_AIR;  }
+      return false;
+    }
+
+    case Step::WAIT_ZERO: {
+      if (Buttons::BTN_ESC.value) { Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
+      if (Buttons::BTN_OK.value)  { Buttons::BTN_OK.reset();  step = Step::CAPT_ZERO; return false; }
+      return false;
+    }
+
+    case Step::CAPT_ZERO: {
+      busy("Midiendo cero..");
+      Vzero = measure(samples);
+      T1 = readThermo();
+      if (!isfinite(Vzero)) {
+        showErr("Error lectura", "O2 cero");
+        step = Step::CANCEL;
+        return false;
+      }
+      LOG_I(LogMod::CAL, "O2 cal: Vzero=%.3fmV T1=%.1f", Vzero * 1000.0f, T1);
+      lcd.splash("Cero OK", "", 600);
+      lcd.clear();
+      askAir();
+      step = Step::WAIT_AIR;
+      return false;
+    }
+
+    case Step::WAIT_AIR: {
+      if (Buttons::BTN_ESC.value) { Buttons::BTN_ESC.reset(); step = Step::CANCEL; return false; }
+      if (Buttons::BTN_OK.value)  { Buttons::BTN_OK.reset();  step = Step::CAPT_AIR; return false; }
+      return false;
+    }
+
+    case Step::CAPT_AIR: {
+      busy("Midiendo aire..");
+      Vsat = measure(samples);
+      T2 = readThermo();
+      if (!isfinite(Vsat)) {
+        showErr("Error lectura", "O2 aire");
+        step = Step::CANCEL;
+        return false;
+      }
+      LOG_I(LogMod::CAL, "O2 cal: Vsat=%.3fmV T2=%.1f", Vsat * 1000.0f, T2);
+      step = Step::APPLY;
+      return false;
+    }
+
+    case Step::APPLY: {
+      // La sensibilidad se fija a la temperatura del punto de aire
+      const bool t2ok = isfinite(T2) && T2 > -40.0f && T2 < 125.0f;
+      const float tCalC = t2ok ? T2 : 25.0f;
+
+      if (twoPoint) {
+        if (!o2.setTwoPointCalibration(Vzero, Vsat, tCalC)) {
+          showErr("Error cal O2", "Vsat~Vcero");
+          step = Step::CANCEL;
+          return false;
+        }
+      } else {
+        o2.setOnePointCalibration(Vsat, tCalC);
+      }
+
+      eeprom.setO2Cal(twoPoint ? Vzero : NAN, Vsat, tCalC);
+      if (!eeprom.save()) {
+        LOG_E(LogMod::SYS, "EEPROM save O2 fallo: %s", eeprom.lastError());
+      } else {
+        LOG_I(LogMod::SYS, "EEPROM: O2 %s guardado", twoPoint ? "2p" : "1p");
+      }
+
+      uart2.setLastResult(twoPoint ? "CAL_O2_2PT_OK" : "CAL_O2_1PT_OK");
+
+      char l2[17];
+      snprintf(l2, sizeof(l2), "Vs=%.2fmV", Vsat * 1000.0f);
+      lcd.splash("O2 calibrado", l2, 900);
+      step = Step::DONE;
+      return false;
+    }
+
+    case Step::CANCEL: {
+      lcd.splash("Calibracion", "Cancelada", 700);
+      uart2.setLastResult("CAL_O2_CANCEL");
+      step = Step::DONE;
+      return false;
+    }
+
+    case Step::DONE:
+    default: {
+      acq.resume();
+      step = Step::START;
+      return true;
+    }
+  }
+}
+
 static bool PumpFillLearnWizard() {
   extern ConfigStore  eeprom;
   extern PumpsManager pumps;
@@ -918,7 +1230,10 @@ static bool PumpFillLearnWizard() {
       case ItemId::DRAIN:       eeprom.setDrainMs(ms);       break;
       default: break;
     }
+    // Nuevo punto de partida para sample/drain: se vuelve a aprender
+    if (id == ItemId::SAMPLE_FILL || id == ItemId::DRAIN) resetFillLearner();
     eeprom.save();
+    applyPumpLimits();
   };
 
   auto renderSelect = [&](bool force=false){
@@ -968,7 +1283,9 @@ static bool PumpFillLearnWizard() {
     }
     case Step::WAIT:{
       if (Buttons::BTN_OK.value){
-        Buttons::BTN_OK.reset(); pumps.on(pumpForFill(fillId));
+        Buttons::BTN_OK.reset();
+        pumps.setMaxOnMs(pumpForFill(fillId), 600000UL);   // se está midiendo: tope = máximo de ConfigStore
+        pumps.on(pumpForFill(fillId));
         t0_ms=millis(); lcd.clear(); renderRun(); step=Step::RUN; return false;
       }
       if (Buttons::BTN_ESC.value){
@@ -1034,8 +1351,8 @@ static bool PumpTimeoutsWizard() {
   auto setSecs = [&](ItemId id, int32_t s){
     uint32_t ms = (uint32_t)clampSecs(s)*1000UL;
     switch(id){
-      case ItemId::SAMPLE_T: eeprom.setSampleTimeoutMs(ms); break;
-      case ItemId::DRAIN_T:  eeprom.setDrainTimeoutMs(ms);  break;
+      case ItemId::SAMPLE_T: eeprom.setSampleTimeoutMs(ms); resetFillLearner(); break;
+      case ItemId::DRAIN_T:  eeprom.setDrainTimeoutMs(ms);  resetFillLearner(); break;
       case ItemId::ESTAB_T:  eeprom.setStabilizationMs(ms); break;
       default: break;
     }
@@ -1095,6 +1412,7 @@ static bool PumpTimeoutsWizard() {
         if(items[cursor].isSeconds) setSecs(items[cursor].id, editValue);
         else                        setSamples(editValue);
         eeprom.save();
+        applyPumpLimits();
         char l0[17], l1[17];
         snprintf(l0,sizeof(l0),"%-8s GUARD",items[cursor].name);
         if(items[cursor].isSeconds) snprintf(l1,sizeof(l1),"%ld s",(long)editValue);
@@ -1447,161 +1765,337 @@ static bool ManualLevelsTick() {
   return false; // permanecer en esta pantalla
 }
 
-static bool AutoModeTick() {
-  extern PumpsManager           pumps;
-  extern ConfigStore            eeprom;
-  extern LevelSensorsManager    levels;     // O2/PH/KCL/H2O (pull-up externas, activo=HIGH)
-  extern float                  readPH();
-  extern float                  readThermo();
-  extern UartProto::UARTManager uart2;      // para registrar pH por sample
-
-  // ---------- Tipos de paso ----------
-  enum class Op : uint8_t {
-    READ_LEVELS,
-    PUMP_FOR,        // 1) espera sensor (con/ sin timeout)  2) mantiene FILL  3) continúa
-    MIXER_ON,
-    MIXER_OFF,
-    WAIT,
-    READ_PH,
-    END
-  };
+// =====================================================
+// Modo AUTO: la secuencia es una receta (lib/recipe_engine). Aquí solo se
+// conecta el motor con bombas, sensores de nivel, adquisición y LCD.
+// =====================================================
+static Recipe autoRecipe;   // vigente: la guardada en EEPROM o la de fábrica
 
-  enum class DurKind : uint8_t {
-    CONST,           // usa Step.ms
-    SAMPLE_T,        // timeout de SAMPLE (fase 1)
-    DRAIN_T,         // timeout de DRAIN  (fase 1)
-    MIX_WAIT_VAR     // estabilización configurable
-  };
+// Tiempos hasta el sensor aprendidos en AUTO: ajustan los timeouts de los
+// pasos con guarda y el llenado de cada bomba de muestra según su desgaste
+static FillLearner fillLearner;
 
-  struct Step {
-    Op          op;
-    PumpId      pump;      // SAMPLE es placeholder (se resuelve por ciclo)
-    DurKind     dkind;
-    uint32_t    ms;        // sólo si dkind==CONST
-    const char* label;
-  };
+static void loadAutoRecipe() {
+  fillLearner.begin(FillLearnConfig());
+  FillLearnData d;
+  eeprom.getFillLearn(d);
+  fillLearner.load(d);
 
-  // ---------- Tiempos ----------
-  static uint32_t mixWaitMs = 30000;            // fallback
-  mixWaitMs = eeprom.stabilizationMs();
-  static const uint32_t MSG_MS = 1500;
-
-  // Timeouts (fase 1: esperar sensor)
-  auto getSampleTimeoutMs = [&](){ return eeprom.sampleTimeoutMs(); };
-  auto getDrainTimeoutMs  = [&](){ return eeprom.drainTimeoutMs();  };
-
-  auto computeTimeoutMs = [&](DurKind dk) -> uint32_t {
-    switch (dk) {
-      case DurKind::SAMPLE_T:     return getSampleTimeoutMs();
-      case DurKind::DRAIN_T:      return getDrainTimeoutMs();
-      case DurKind::MIX_WAIT_VAR: return mixWaitMs;
-      case DurKind::CONST:        return 0;
-      default:                    return 0;
-    }
-  };
+  if (eeprom.getRecipe(autoRecipe)) {
+    LOG_I(LogMod::AUTO, "AUTO: receta de EEPROM (%u pasos)", (unsigned)autoRecipe.count);
+  } else {
+    recipeDefault(autoRecipe);
+    LOG_I(LogMod::AUTO, "AUTO: receta de fabrica (%u pasos)", (unsigned)autoRecipe.count);
+  }
+}
+
+// Receta llegada por UART ("set_recipe"): se valida allá, se persiste aquí
+static void applyPendingRecipe() {
+  Recipe r;
+  if (!uart2.takeRecipe(r)) return;
+  if (r.count == 0) eeprom.clearRecipe();
+  else              eeprom.setRecipe(r);
+  eeprom.clearFillLearn();   // lo aprendido va por índice de paso
+  if (!eeprom.save()) LOG_E(LogMod::AUTO, "AUTO: receta no guardada: %s", eeprom.lastError());
+  loadAutoRecipe();
+}
 
-  // Fill (fase 2: mantener encendida)
-  auto getKclFillMs    = [&](){ return eeprom.kclFillMs();    };
-  auto getH2oFillMs    = [&](){ return eeprom.h2oFillMs();    };
-  auto getSampleFillMs = [&](){ return eeprom.sampleFillMs(); };
-  auto getDrainMs      = [&](){ return eeprom.drainMs();      };
+// Tope de encendido por bomba (esp_timer en PumpsManager): el doble de lo
+// más largo que la receta de fábrica puede pedir, con lo aprendido al máximo
+static void applyPumpLimits() {
+  static const uint32_t MARGIN_MS = 5000;
+  static const uint32_t FLOOR_MS  = 60000;   // recetas propias con tiempos CONST
+  const FillLearnConfig lc;
+  auto cap = [](uint32_t ms) { return ms < FLOOR_MS ? FLOOR_MS : ms; };
+
+  pumps.setMaxOnMs(PumpId::KCL, cap(2 * eeprom.kclFillMs() + MARGIN_MS));
+  pumps.setMaxOnMs(PumpId::H2O, cap(2 * eeprom.h2oFillMs() + MARGIN_MS));
+  pumps.setMaxOnMs(PumpId::DRAIN,
+                   cap(2 * (uint32_t)(lc.maxFactor * eeprom.drainTimeoutMs() + eeprom.drainMs()) + MARGIN_MS));
+  const uint32_t sample =
+      cap(2 * (uint32_t)(lc.maxFactor * eeprom.sampleTimeoutMs() + lc.fillScaleMax * eeprom.sampleFillMs()) + MARGIN_MS);
+  pumps.setMaxOnMs(PumpId::SAMPLE1, sample);
+  pumps.setMaxOnMs(PumpId::SAMPLE2, sample);
+  pumps.setMaxOnMs(PumpId::SAMPLE3, sample);
+  pumps.setMaxOnMs(PumpId::SAMPLE4, sample);
+  // MIXER sin tope: acompaña la estabilización
+}
+
+// Los asistentes de bombas/timeouts guardan valores nuevos: lo aprendido
+// sobre los viejos ya no aplica (el llamador hace el save())
+static void resetFillLearner() {
+  eeprom.clearFillLearn();
+  fillLearner.reset();
+}
 
-  auto computeFillMs = [&](PumpId id) -> uint32_t {
+// Fin de una corrida AUTO: escribe solo si algún timeout se movió lo
+// suficiente y pasó el intervalo mínimo (cuida la flash)
+static void saveFillLearnerIfDue() {
+  static uint32_t saves = 0;
+  if (!fillLearner.wantsSave(millis())) return;
+  eeprom.setFillLearn(fillLearner.data());
+  if (!eeprom.save()) {
+    LOG_E(LogMod::AUTO, "AUTO: aprendizaje no guardado: %s", eeprom.lastError());
+    return;
+  }
+  fillLearner.markSaved(millis());
+  ++saves;
+  LOG_I(LogMod::AUTO, "AUTO: tiempos aprendidos guardados (#%lu)", (unsigned long)saves);
+}
+
+class AutoRecipeIO : public AutoRecipeIOBase {
+public:
+  AutoRecipeIO() {
+    recipe  = &autoRecipe;
+    learner = &fillLearner;
+  }
+
+  uint32_t now() override { return millis(); }
+
+  RecipeHookStatus hook(uint8_t id, bool enter, uint32_t durMs) override {
     switch (id) {
-      case PumpId::KCL:     return getKclFillMs();
-      case PumpId::H2O:     return getH2oFillMs();
-      case PumpId::SAMPLE1:
-      case PumpId::SAMPLE2:
-      case PumpId::SAMPLE3:
-      case PumpId::SAMPLE4: return getSampleFillMs();
-      case PumpId::DRAIN:   return getDrainMs();
-      default:              return 0;
+      case RH_LEVELS: return hookLevels_();
+      case RH_STABLE: return hookStable_(enter, durMs);
+      case RH_READ:   return hookRead_(enter);
+      default:        return RecipeHookStatus::FAIL;
     }
-  };
+  }
 
-  // ---------- Receta ----------
-  static const Step STEPS[] = {
-    { Op::READ_LEVELS, PumpId::KCL,     DurKind::CONST,        0, "Lee niveles" },
-    { Op::PUMP_FOR,    PumpId::DRAIN,   DurKind::DRAIN_T,      0, "Drenando"    },
-    { Op::PUMP_FOR,    PumpId::SAMPLE1, DurKind::SAMPLE_T,     0, "Sample"      }, // SAMPLE dinámico
-    { Op::MIXER_ON,    PumpId::MIXER,   DurKind::CONST,        0, "Mixer ON"    },
-    { Op::WAIT,        PumpId::MIXER,   DurKind::MIX_WAIT_VAR, 0, "Mezclando"   },
-    { Op::MIXER_OFF,   PumpId::MIXER,   DurKind::CONST,        0, "Mixer OFF"   },
-    { Op::READ_PH,     PumpId::MIXER,   DurKind::CONST,        0, "Leer pH"     },
-    { Op::PUMP_FOR,    PumpId::DRAIN,   DurKind::DRAIN_T,      0, "Drenando"    },
-    // H2O/KCL: SIN sensores ni timeout → sólo FILL ascendente
-    { Op::PUMP_FOR,    PumpId::H2O,     DurKind::CONST,        0, "H2O"         },
-    { Op::PUMP_FOR,    PumpId::KCL,     DurKind::CONST,        0, "KCL"         },
-    { Op::END,         PumpId::KCL,     DurKind::CONST,        0, "FIN"         },
-  };
-  static const uint8_t N_STEPS = sizeof(STEPS)/sizeof(STEPS[0]);
+  // Telemetría: un renglón por paso
+  void stepDone(const RecipeStepReport& r) override {
+    uint32_t before, after;
+    if (learn(r, before, after)) {
+      const FillLearnEntry* e = fillLearner.find(r.index, learnPump(autoRecipe.steps[r.index]));
+      LOG_I(LogMod::AUTO, "[AUTO] #%u %s media=%.2fs timeout %.1f->%.1fs",
+            (unsigned)r.index, recipeActName(e->pump), e->mean / 1000.0f,
+            before / 1000.0f, after / 1000.0f);
+    }
+    uart2.emitStep((uint8_t)(currentSample + 1), r);
+    const char* res = (r.outcome == RecipeOutcome::OK) ? "OK" :
+                      (r.outcome == RecipeOutcome::TIMEOUT) ? "TIMEOUT" : "FALLO";
+    const char* what = (r.op == RecipeOp::HOOK) ? recipeHookName(r.act) :
+                       (r.op == RecipeOp::PUMP || r.op == RecipeOp::ON || r.op == RecipeOp::OFF)
+                         ? recipeActName(r.act) : "";
+    LOG_I(LogMod::AUTO, "[AUTO] S%u #%u %s %s t0=%.1fs sensor=%.1fs total=%.1fs %s",
+          currentSample + 1u, (unsigned)r.index, recipeOpName(r.op), what,
+          r.startMs / 1000.0f, r.sensorMs / 1000.0f, r.totalMs / 1000.0f, res);
+  }
+
+protected:
+  void setPump(uint8_t pump, bool on) override { pumps.set((PumpId)pump, on); }
+  // HOLD tras la guarda: lo cumple el esp_timer del canal
+  void offAfter(uint8_t pump, uint32_t ms) override { pumps.offAfterMs((PumpId)pump, ms); }
+  void cancelOff(uint8_t pump) override { pumps.cancelOffAfter((PumpId)pump); }
+
+  bool levelActive(AutoLevel l) override {
+    switch (l) {
+      case AutoLevel::O2:  return levels.o2();
+      case AutoLevel::PH:  return levels.ph();
+      case AutoLevel::KCL: return levels.kcl();
+      default:             return levels.h2o();
+    }
+  }
 
-  // ---------- Estado ----------
-  enum class Phase   : uint8_t { ENTER, RUN, POST, EXIT };
-  enum class PumpSub : uint8_t { WAIT_SENSOR, FILL, DONE };
+  // Flancos con marca de tiempo de la tarea de niveles (millis())
+  bool levelChangeMs(AutoLevel l, uint32_t& ms) override {
+    if (!levels.eventsEnabled()) return false;
+    ms = levels.lastChangeMs((LevelSensorId)l);
+    return true;
+  }
+
+  uint32_t configured(RecipeParam p) override {
+    switch (p) {
+      case RecipeParam::KCL_FILL:       return eeprom.kclFillMs();
+      case RecipeParam::H2O_FILL:       return eeprom.h2oFillMs();
+      case RecipeParam::SAMPLE_FILL:    return eeprom.sampleFillMs();
+      case RecipeParam::DRAIN:          return eeprom.drainMs();
+      case RecipeParam::SAMPLE_TIMEOUT: return eeprom.sampleTimeoutMs();
+      case RecipeParam::DRAIN_TIMEOUT:  return eeprom.drainTimeoutMs();
+      case RecipeParam::STABILIZATION:  return eeprom.stabilizationMs();
+      default:                          return 0;
+    }
+  }
 
-  static bool          started      = false;
-  static uint8_t       idx          = 0;
-  static Phase         phase        = Phase::ENTER;
-  static PumpSub       pumpSub      = PumpSub::WAIT_SENSOR;
+  // cut_ lo tocan el motor (core 0) y la tarea de niveles
+  void lockCut() const override { taskENTER_CRITICAL(&cutMux_); }
+  void unlockCut() const override { taskEXIT_CRITICAL(&cutMux_); }
 
-  static uint32_t      timeoutMs    = 0;      // fase 1
-  static uint32_t      fillMs       = 0;      // fase 2
-  static unsigned long t0           = 0;      // inicio WAIT_SENSOR
-  static unsigned long tFillStart   = 0;      // inicio FILL
-  static unsigned long tPost        = 0;
-  static float         lastPHShown  = NAN;
+private:
+  StabilityDetector mixStab_;   // RH_STABLE: deriva del voltaje de pH
+  uint32_t          mixSeq_ = 0;
+  uint32_t          t0_     = 0;
+  uint32_t          tPhReq_ = 0;  // RH_READ: pide un snapshot posterior a este instante
+  mutable portMUX_TYPE cutMux_ = portMUX_INITIALIZER_UNLOCKED;
 
-  // iteraciones por nº de samples
-  static uint8_t totalSamples = 0;   // EEPROM
-  static uint8_t currentSample = 0;  // 0..totalSamples-1
+  static void show_(const char* l0, const char* l1) {
+    lcd.printAt(0, 0, l0);
+    lcd.printAt(0, 1, l1);
+  }
+
+  RecipeHookStatus hookLevels_() {
+    const char* sH2O = levels.h2o() ? "ACT" : "OK ";
+    const char* sKCL = levels.kcl() ? "ACT" : "OK ";
+    const char* sO2  = levels.o2()  ? "ACT" : "OK ";
+    const char* sPH  = levels.ph()  ? "ACT" : "OK ";
+    char L0[17], L1[17];
+    snprintf(L0, sizeof(L0), "H2O:%s KCL:%s", sH2O, sKCL);
+    snprintf(L1, sizeof(L1), "O2:%s  pH:%s",  sO2,  sPH);
+    show_(L0, L1);
+    return RecipeHookStatus::DONE;
+  }
+
+  // Muestra recién mezclada: termina al estabilizar el pH; durMs es el tope
+  RecipeHookStatus hookStable_(bool enter, uint32_t durMs) {
+    if (enter) {
+      t0_ = millis();
+      mixStab_.begin(stabilityMixConfig(durMs), t0_);
+      mixSeq_ = acq.snapshot().seq;
+      acq.requestFresh();
+    }
+
+    // Snapshots nuevos medidos después de entrar al paso
+    AcqSnapshot snap = acq.snapshot();
+    if (snap.seq != mixSeq_ && snap.has(ACQ_PH_OK) && (int32_t)(snap.ph_ms - t0_) >= 0) {
+      mixSeq_ = snap.seq;
+      mixStab_.push(snap.ph_ms, snap.volts);
+    } else {
+      mixStab_.tick(millis());
+    }
+
+    char L1[17];
+    const unsigned long s = (unsigned long)((millis() - t0_) / 1000UL);
+    if (isfinite(mixStab_.driftPerMin()))
+      snprintf(L1, sizeof(L1), "%+5.1fmV/m %lus", mixStab_.driftPerMin() * 1000.0f, s);
+    else
+      snprintf(L1, sizeof(L1), "t=%lus/%lus", s, (unsigned long)(durMs / 1000UL));
+    show_("Mezclando", L1);
+
+    if (!mixStab_.done()) return RecipeHookStatus::RUNNING;
+    LOG_I(LogMod::AUTO, "Mezcla: %s%.1f s (deriva=%.2f mV/min ruido=%.3f mV)",
+          mixStab_.state() == StabilityState::STABLE ? "pH estable en " : "tope en ",
+          mixStab_.timeToStableMs() / 1000.0f, mixStab_.driftPerMin() * 1000.0f,
+          mixStab_.noise() * 1000.0f);
+    return RecipeHookStatus::DONE;
+  }
+
+  RecipeHookStatus hookRead_(bool enter) {
+    static const uint32_t PH_FRESH_TIMEOUT_MS = 5000;
+    if (enter) {
+      show_("Leyendo pH/O2", " ");
+      // La muestra recién llegó: sirve un snapshot medido después de ahora
+      tPhReq_ = acq.requestFresh();
+    }
+
+    AcqSnapshot snap = acq.snapshot();
+    const bool fresh = snap.seq != 0 && (int32_t)(snap.ph_ms - tPhReq_) >= 0;
+    if (!fresh && (millis() - tPhReq_) < PH_FRESH_TIMEOUT_MS) return RecipeHookStatus::RUNNING;
+    if (!fresh) snap.flags &= (uint8_t)~(ACQ_PH_OK | ACQ_O2_OK);   // sin dato nuevo: se registra como error
+
+    // pH y O2 salen de la misma ventana de adquisición
+    const float phv = logPHSnapshot(snap);
+    const float o2v = logO2Snapshot(snap);
+
+    // Guardar en JSON del sample actual (1..4)
+    uint8_t sampleId = (uint8_t)(currentSample + 1);
+    if (sampleId > 4) sampleId = 4;
+    uart2.setLastPh(phv);
+    uart2.setSamplePhValueById(sampleId, phv);
+    uart2.setSampleO2ValueById(sampleId, o2v);   // NAN => null en el JSON
+    uart2.emitSample(sampleId, phv, o2v);
+
+    char L0[17], L1[17];
+    snprintf(L0, sizeof(L0), "pH: %.02f", phv);
+    if (isfinite(o2v)) snprintf(L1, sizeof(L1), "O2: %.2f mg/L", o2v);
+    else               snprintf(L1, sizeof(L1), "O2: --");
+    show_(L0, L1);
+    return RecipeHookStatus::DONE;
+  }
+};
+
+static AutoRecipeIO autoIO;
+static RecipeEngine autoEngine(autoIO);
+
+// Mismo orden que LevelSensorId
+static const char* const kLevelName[(uint8_t)LevelSensorId::COUNT] = {"o2", "ph", "kcl", "h2o"};
+
+// Tarea de niveles: apaga la bomba armada sin esperar al tick de la UI
+static void onLevelEvent(const LevelEvent& e, void* ctx) {
+  static_cast<AutoRecipeIO*>(ctx)->onLevelChange();
+  uart2.emitLevel(kLevelName[(uint8_t)e.id], e.active, e.ms);
+}
+
+// Niveles por interrupción: flancos con marca de tiempo y corte inmediato
+static void initLevelEvents() {
+  if (!levels.beginEvents()) {
+    LOG_W(LogMod::IO, "Niveles: sin interrupciones, se leen por poll");
+    return;
+  }
+  levels.setEventCallback(onLevelEvent, &autoIO);
+}
+
+// Escrituras al PCF8574, cortes por tope y apagados agendados por guarda
+static void logPumpStats() {
+  LOG_I(LogMod::IO, "[BOMBAS] writes=%lu errores=%lu verif=%lu verif_fallo=%lu cortes=%lu agendados=%lu corte_sin_write=%lu",
+        (unsigned long)pumps.writes(), (unsigned long)pumps.writeErrors(),
+        (unsigned long)pumps.verifies(), (unsigned long)pumps.verifyFails(),
+        (unsigned long)pumps.forcedOffs(), (unsigned long)pumps.plannedOffs(),
+        (unsigned long)pumps.offWriteFails());
+}
+
+// Peor latencia flanco → estado publicado (incluye el antirrebote)
+static void logLevelStats() {
+  if (!levels.eventsEnabled()) return;
+  LOG_I(LogMod::IO, "[NIVEL] latencia max %.1f ms, rebotes O2=%lu pH=%lu, flancos perdidos %lu, pila libre %lu",
+        levels.maxLatencyUs() / 1000.0f, (unsigned long)levels.bounces(LevelSensorId::O2),
+        (unsigned long)levels.bounces(LevelSensorId::PH), (unsigned long)levels.overruns(),
+        (unsigned long)levels.stackFreeMin());
+}
+
+static bool AutoModeTick() {
+  static bool started = false;
 
-  // ---------- UI ----------
   auto show = [&](const char* l0, const char* l1) {
     lcd.printAt(0, 0, l0);
     lcd.printAt(0, 1, l1);
   };
 
-  // Timeouts: cuenta regresiva (restante / total)
-  auto progressTimeoutCountdown = [&](const char* title, uint32_t totalMs, unsigned long tStart) {
-    uint32_t elapsed = (uint32_t)(millis() - tStart);
-    uint32_t remain  = (elapsed >= totalMs) ? 0 : (totalMs - elapsed);
-    char L0[17], L1[17];
-    snprintf(L0, sizeof(L0), "%s", title);
-    snprintf(L1, sizeof(L1), "t=%lus/%lus", (unsigned long)(remain/1000UL), (unsigned long)(totalMs/1000UL));
-    show(L0, L1);
+  auto reset = [&]() {
+    pumps.allOff();
+    started = false;
+    autoIO.currentSample = 0;
+    autoIO.totalSamples  = 1;
   };
 
-  // Fills: ascendente (transcurrido / total)
-  auto progressFillUp = [&](const char* title, uint32_t totalMs, unsigned long tStart) {
-    uint32_t elapsed = (uint32_t)(millis() - tStart);
-    if (elapsed > totalMs) elapsed = totalMs;
-    char L0[17], L1[17];
-    snprintf(L0, sizeof(L0), "%s", title);
-    snprintf(L1, sizeof(L1), "t=%lus/%lus", (unsigned long)(elapsed/1000UL), (unsigned long)(totalMs/1000UL));
-    show(L0, L1);
+  auto startCycle = [&]() -> bool {
+    if (autoEngine.start(autoRecipe)) return true;
+    uart2.emitError("BAD_RECIPE");
+    uart2.emitAuto("abort", (uint8_t)(autoIO.currentSample + 1), autoIO.totalSamples);
+    lcd.splash("AUTO", "Receta invalida", 900);
+    reset();
+    return false;
   };
 
-  // SAMPLE dinámico por ciclo
-  auto samplePumpForCycle = [&]() -> PumpId {
-    uint8_t n = totalSamples;
-    if (n == 0) n = 1;
-    uint8_t i = (currentSample % n);
-    switch (i) {
-      case 0:  return PumpId::SAMPLE1;
-      case 1:  return PumpId::SAMPLE2;
-      case 2:  return PumpId::SAMPLE3;
-      default: return PumpId::SAMPLE4;
-    }
+  // Título del paso en primer plano (los hooks dibujan su propia pantalla)
+  auto stepLabel = [&](const RecipeStep& s, char* out, size_t n) {
+    const bool sample = s.act == RA_SAMPLE || s.guard == RecipeGuard::SAMPLE_IN ||
+                        s.dur == RecipeParam::SAMPLE_FILL;
+    const bool drain  = s.act == RA_DRAIN || s.guard == RecipeGuard::DRAINED;
+    if (s.op == RecipeOp::JOIN)                      snprintf(out, n, "Esperando");
+    else if (s.op == RecipeOp::PUMP && s.act == RA_H2O) snprintf(out, n, "H2O");
+    else if (s.op == RecipeOp::PUMP && s.act == RA_KCL) snprintf(out, n, "KCL");
+    else if (sample) snprintf(out, n, "Sample %u/%u", (unsigned)(autoIO.currentSample + 1),
+                              (unsigned)autoIO.totalSamples);
+    else if (drain)  snprintf(out, n, "Drenando");
+    else             snprintf(out, n, "Paso %u", (unsigned)(autoEngine.progress().step + 1));
   };
 
   // ---------- ESC cancela ----------
   if (Buttons::BTN_ESC.value) {
     Buttons::BTN_ESC.reset();
-    pumps.allOff();
+    autoEngine.abort();
+    if (started) uart2.emitAuto("cancel", (uint8_t)(autoIO.currentSample + 1), autoIO.totalSamples);
+    reset();
     lcd.splash("AUTO cancelado", "", 800);
-    started = false; idx = 0; phase = Phase::ENTER; lastPHShown = NAN;
-    currentSample = 0; totalSamples = 0;
     return true;
   }
 
@@ -1621,544 +2115,292 @@ static bool AutoModeTick() {
       return false;
     }
 
-    totalSamples  = eeprom.sampleCount();     // 0..4
-    if (totalSamples == 0) totalSamples = 1;
-    currentSample = 0;
+    autoIO.totalSamples  = eeprom.sampleCount();     // 0..4
+    if (autoIO.totalSamples == 0) autoIO.totalSamples = 1;
+    autoIO.currentSample = 0;
 
     pumps.allOff();
+    pumps.takeTripped();   // cortes de antes (modo manual) no cuentan para esta corrida
     lcd.splash("Niveles OK", "Iniciando...", 500);
-    started     = true;
-    idx         = 0;
-    phase       = Phase::ENTER;
-    lastPHShown = NAN;
+    started = true;
+    uart2.emitAuto("start", 1, autoIO.totalSamples);
+    if (!startCycle()) return true;
   }
 
-  // ---------- Sensor alcanzado? ----------
-  auto sensorReached = [&](PumpId pump) -> bool {
-    switch (pump) {
-      case PumpId::KCL:     return false; // (1) NO dependen de sensores
-      case PumpId::H2O:     return false; // (1) NO dependen de sensores
-      case PumpId::SAMPLE1:
-      case PumpId::SAMPLE2:
-      case PumpId::SAMPLE3:
-      case PumpId::SAMPLE4: return (!levels.o2() && !levels.ph()); // ambos ACTIVOS
-      case PumpId::DRAIN:   return (levels.o2() && levels.ph());   // ambos INACTIVOS
-      default:              return false;
-    }
-  };
-
-  // ---------- Paso actual ----------
-  const Step& S = STEPS[idx];
-
-  switch (S.op) {
-    case Op::READ_LEVELS: {
-      if (phase == Phase::ENTER) {
-        const bool h2o = levels.h2o();
-        const bool kcl = levels.kcl();
-        const bool o2  = levels.o2();
-        const bool ph  = levels.ph();
-        const char* sH2O = h2o ? "ACT" : "OK ";
-        const char* sKCL = kcl ? "ACT" : "OK ";
-        const char* sO2  = o2  ? "ACT" : "OK ";
-        const char* sPH  = ph  ? "ACT" : "OK ";
-        char L0[17], L1[17];
-        snprintf(L0, sizeof(L0), "H2O:%s KCL:%s", sH2O, sKCL);
-        snprintf(L1, sizeof(L1), "O2:%s  pH:%s",  sO2,  sPH);
-        show(L0, L1);
-        tPost = millis();
-        phase = Phase::POST;
-      } else if (phase == Phase::POST) {
-        if (millis() - tPost >= MSG_MS) phase = Phase::EXIT;
-      } else if (phase == Phase::EXIT) {
-        idx++; phase = Phase::ENTER;
-      }
-    } break;
-
-    case Op::PUMP_FOR: {
-      // Resolver SAMPLE dinámico
-      PumpId effPump = (S.pump == PumpId::SAMPLE1) ? samplePumpForCycle() : S.pump;
-
-      if (phase == Phase::ENTER) {
-        timeoutMs = computeTimeoutMs(S.dkind);   // 0 para CONST
-        fillMs    = computeFillMs(effPump);
-        if (fillMs == 0) fillMs = 500;           // mínimo
-
-        pumps.on(effPump);
-
-        // (1) KCL/H2O no esperan sensor ni tienen timeout → saltar directo a FILL
-        if (effPump == PumpId::KCL || effPump == PumpId::H2O) {
-          pumpSub    = PumpSub::FILL;
-          tFillStart = millis();
-          progressFillUp(S.label, fillMs, tFillStart); // ascendente
-        } else {
-          pumpSub = PumpSub::WAIT_SENSOR;
-          t0      = millis();
-          if (timeoutMs > 0)
-            progressTimeoutCountdown(S.label, timeoutMs, t0); // regresiva
-          else
-            show(S.label, "Esperando sens");
-        }
+  // ---------- Corte de seguridad (tope de encendido vencido) ----------
+  const uint8_t tripped = pumps.takeTripped();
+  if (tripped) {
+    autoEngine.abort();
+    uart2.emitError("PUMP_TRIP", 0xFF, tripped);
+    uart2.emitAuto("abort", (uint8_t)(autoIO.currentSample + 1), autoIO.totalSamples);
+    reset();
+    LOG_E(LogMod::AUTO, "[AUTO] corte por tope de encendido, canales 0x%X", tripped);
+    logPumpStats();
+    lcd.splash("AUTO STOP", "Corte seguridad", 900);
+    return true;
+  }
 
-        phase = Phase::RUN;
-      }
-      else if (phase == Phase::RUN) {
-        if (pumpSub == PumpSub::WAIT_SENSOR) {
-          bool reached = sensorReached(effPump);
-          bool to_exp  = (timeoutMs > 0) && ((millis() - t0) >= timeoutMs);
-
-          if (reached) {
-            pumpSub    = PumpSub::FILL;
-            tFillStart = millis();
-            progressFillUp(S.label, fillMs, tFillStart);       // ascendente
-          } else if (to_exp) {
-            pumps.off(effPump);
-            lcd.splash("AUTO STOP", "Timeout sensor", 900);
-            started = false; idx = 0; phase = Phase::ENTER; lastPHShown = NAN;
-            currentSample = 0; totalSamples = 0;
-            return true;
-          } else {
-            if (timeoutMs > 0) progressTimeoutCountdown(S.label, timeoutMs, t0); // regresiva
-          }
-        }
-        else if (pumpSub == PumpSub::FILL) {
-          progressFillUp(S.label, fillMs, tFillStart);         // ascendente
-          if ((millis() - tFillStart) >= fillMs) {
-            pumpSub = PumpSub::DONE;
-          }
-        }
-        else { // DONE
-          pumps.off(effPump);
-          show(S.label, "OK");
-          tPost = millis();
-          phase = Phase::POST;
-        }
-      }
-      else if (phase == Phase::POST) {
-        if (millis() - tPost >= MSG_MS) phase = Phase::EXIT;
-      }
-      else if (phase == Phase::EXIT) {
-        idx++; phase = Phase::ENTER;
-      }
-    } break;
-
-    case Op::MIXER_ON: {
-      if (phase == Phase::ENTER) {
-        pumps.on(PumpId::MIXER);
-        show("Mixer ON", "OK");
-        tPost = millis();
-        phase = Phase::POST;
-      } else if (phase == Phase::POST) {
-        if (millis() - tPost >= MSG_MS) phase = Phase::EXIT;
-      } else if (phase == Phase::EXIT) {
-        idx++; phase = Phase::ENTER;
-      }
-    } break;
-
-    case Op::MIXER_OFF: {
-      if (phase == Phase::ENTER) {
-        pumps.off(PumpId::MIXER);
-        show("Mixer OFF", "OK");
-        tPost = millis();
-        phase = Phase::POST;
-      } else if (phase == Phase::POST) {
-        if (millis() - tPost >= MSG_MS) phase = Phase::EXIT;
-      } else if (phase == Phase::EXIT) {
-        idx++; phase = Phase::ENTER;
-      }
-    } break;
-
-    case Op::WAIT: {
-      if (phase == Phase::ENTER) {
-        uint32_t waitMs = (S.dkind == DurKind::CONST) ? S.ms : computeTimeoutMs(S.dkind);
-        t0 = millis();
-        timeoutMs = waitMs;
-        phase = Phase::RUN;
-        progressTimeoutCountdown(S.label, timeoutMs, t0); // regresiva
-      } else if (phase == Phase::RUN) {
-        progressTimeoutCountdown(S.label, timeoutMs, t0); // regresiva
-        if ((millis() - t0) >= timeoutMs) {
-          show(S.label, "OK");
-          tPost = millis();
-          phase = Phase::POST;
-        }
-      } else if (phase == Phase::POST) {
-        if (millis() - tPost >= MSG_MS) phase = Phase::EXIT;
-      } else if (phase == Phase::EXIT) {
-        idx++; phase = Phase::ENTER;
-      }
-    } break;
-
-    case Op::READ_PH: {
-      if (phase == Phase::ENTER) {
-        char L0[17], L1[17];
-        snprintf(L0, sizeof(L0), "Leyendo pH");
-        snprintf(L1, sizeof(L1), " ");
-        show(L0, L1);
-
-        float phv = readPH();
-        lastPHShown = phv;
-
-        // Guardar en JSON del sample actual (1..4)
-        uint8_t sampleId = (uint8_t)(currentSample + 1);
-        if (sampleId < 1) sampleId = 1;
-        if (sampleId > 4) sampleId = 4;
-
-        uart2.setLastPh(phv);
-        uart2.setSamplePhValueById(sampleId, phv);
-
-        snprintf(L0, sizeof(L0), "pH: %.02f", phv);
-        snprintf(L1, sizeof(L1), "OK");
-        show(L0, L1);
-
-        tPost = millis();
-        phase = Phase::POST;
-      } else if (phase == Phase::POST) {
-        if (millis() - tPost >= MSG_MS) phase = Phase::EXIT;
-      } else if (phase == Phase::EXIT) {
-        idx++; phase = Phase::ENTER;
-      }
-    } break;
+  // ---------- Receta ----------
+  // Un tick = una transacción: los cambios de salidas del tick van en un write
+  pumps.beginTx();
+  const RecipeRunState st = autoEngine.tick();
+  pumps.commitTx();
 
-    case Op::END: {
-      pumps.allOff();
+  if (st == RecipeRunState::RUNNING) {
+    const RecipeProgress p = autoEngine.progress();
+    if (p.step < 0 || p.sub == RecipeSub::HOOK || p.sub == RecipeSub::PAUSE) return false;
 
-      // Fin de un ciclo de sample
-      currentSample++;
+    char L0[17], L1[17];
+    stepLabel(autoEngine.recipe().steps[p.step], L0, sizeof(L0));
+    const uint32_t shown = (p.sub == RecipeSub::SENSOR)                 // timeouts: regresiva
+                             ? (p.elapsedMs >= p.limitMs ? 0 : p.limitMs - p.elapsedMs)
+                             : (p.elapsedMs > p.limitMs ? p.limitMs : p.elapsedMs);
+    if (p.limitMs) snprintf(L1, sizeof(L1), "t=%lus/%lus", (unsigned long)(shown / 1000UL),
+                            (unsigned long)(p.limitMs / 1000UL));
+    else           snprintf(L1, sizeof(L1), "...");
+    show(L0, L1);
+    return false;
+  }
 
-      if (currentSample < totalSamples) {
-        char l0[17], l1[17];
-        snprintf(l0, sizeof(l0), "Sample %u/%u", (unsigned)currentSample, (unsigned)totalSamples);
-        snprintf(l1, sizeof(l1), "Repitiendo...");
-        lcd.splash(l0, l1, 800);
-
-        // Reiniciar receta
-        idx     = 0;
-        phase   = Phase::ENTER;
-        started = true;
-        return false;
-      }
+  if (st == RecipeRunState::ABORTED) {
+    char l1[17];
+    if (autoEngine.abortOutcome() == RecipeOutcome::TIMEOUT) snprintf(l1, sizeof(l1), "Timeout sensor");
+    else snprintf(l1, sizeof(l1), "Fallo paso %d", (int)autoEngine.abortStep() + 1);
+    LOG_W(LogMod::AUTO, "[AUTO] abortado en paso %d: %s", (int)autoEngine.abortStep(), l1);
+    uart2.emitError(autoEngine.abortOutcome() == RecipeOutcome::TIMEOUT ? "STEP_TIMEOUT" : "STEP_FAIL",
+                    (uint8_t)autoEngine.abortStep());
+    uart2.emitAuto("abort", (uint8_t)(autoIO.currentSample + 1), autoIO.totalSamples);
+    reset();
+    saveFillLearnerIfDue();
+    logLevelStats();
+    logPumpStats();
+    lcd.splash("AUTO STOP", l1, 900);
+    return true;
+  }
 
-      // Todo completado
-      lcd.splash("AUTO OK", "Completado", 900);
-      started = false; idx = 0; phase = Phase::ENTER; lastPHShown = NAN;
-      currentSample = 0; totalSamples = 0;
-      return true;
-    }
+  // ---------- Fin de un ciclo de sample ----------
+  LOG_I(LogMod::AUTO, "[AUTO] S%u ciclo %.1f s", autoIO.currentSample + 1u,
+        autoEngine.elapsedMs() / 1000.0f);
+  pumps.allOff();
+  autoIO.currentSample++;
 
-    default: {
-      pumps.allOff();
-      lcd.splash("AUTO", "Error step", 800);
-      started = false; idx = 0; phase = Phase::ENTER; lastPHShown = NAN;
-      currentSample = 0; totalSamples = 0;
-      return true;
-    }
+  if (autoIO.currentSample < autoIO.totalSamples) {
+    char l0[17], l1[17];
+    snprintf(l0, sizeof(l0), "Sample %u/%u", (unsigned)autoIO.currentSample, (unsigned)autoIO.totalSamples);
+    snprintf(l1, sizeof(l1), "Repitiendo...");
+    if (autoRecipe.pauseMs) lcd.splash(l0, l1, 800);
+    else                    show(l0, l1);
+    if (!startCycle()) return true;
+    return false;
   }
 
-  return false;
+  // Todo completado
+  uart2.emitAuto("done", autoIO.currentSample, autoIO.totalSamples);
+  reset();
+  saveFillLearnerIfDue();
+  logLevelStats();
+  logPumpStats();
+  lcd.splash("AUTO OK", "Completado", 900);
+  return true;
 }
 
-static void MenuDemoTick() {
-  // --- prototipos externos que usa el menú ---
-  extern ConfigStore eeprom;
-  extern bool  runADSCalibration_0V_3p31V(uint8_t, uint8_t);
-  extern bool  runPHCalibration_7_4(uint8_t samples);
-  extern bool  runPHCalibration_4_7_10(uint16_t samples, bool piecewise);
-  extern float readADC();
-  extern float readPH();
-  extern float readThermo();
-  extern bool  AutoModeTick();
-  extern UartProto::UARTManager uart2;
-
-  // Subpantallas externas
-  extern bool ManualPumpsTick();
-  extern bool ManualLevelsTick();
-
-  // Wizards de configuración
-  extern bool PumpTimeoutsWizard();
-  extern bool PumpFillLearnWizard();
-
-  // ----- Estado persistente -----
-  enum class View : uint8_t {
-    ROOT,
-    MANUAL_MENU,
-    MANUAL_PUMPS,
-    MANUAL_LEVELS,
-    AUTO,
-    CONFIG,
-    TEMP,
-    CAL_ADS_MENU,
-    CAL_ADS_READ,
-    CAL_ADS_RUN,
-    CAL_PH_MENU,
-    CAL_PH_READ,        // <-- conservado
-    CAL_PH_RUN_2P,      // <-- calibración 2 puntos
-    CAL_PH_RUN_3P_PW,   // <-- calibración 3 puntos (piecewise)
-    CFG_TIMEOUTS,
-    CFG_FILL
-  };
+// =====================================================
+// Menú principal (menu_tree)
+//  - Cada página es una tabla; agregar una pantalla = agregar una entrada
+//  - Los wizards y calibraciones son acciones: ticks que devuelven true al
+//    terminar y mientras tanto son dueños del LCD y de los botones
+// =====================================================
+class LcdMenuDisplay : public MenuDisplay {
+public:
+  void clear() override { lcd.clear(); }
+  void write(uint8_t col, uint8_t row, const char* text) override { lcd.writeAt(col, row, text); }
+};
+
+// ---- Acciones ----
+static bool menuCalADS()    { return runADSCalibration_0V_3p31V(0, 32); }
+static bool menuCalPH2p()   { return runPHCalibration_7_4(31); }
+static bool menuCalPH3p()   { return runPHCalibration_4_7_10(31, false); }
+static bool menuCalO2Air()  { return runO2Calibration(false, 64); }
+static bool menuCalO2Zero() { return runO2Calibration(true, 64); }
+
+static void menuAutoEnter() { uart2.setAutoRunning(true); }
+static void menuAutoExit() {
+  uart2.setAutoRunning(false);
+  uart2.setAutoMeasureRequested(false);
+}
+
+static const MenuAction kActAuto        = {AutoModeTick, menuAutoEnter, menuAutoExit};
+static const MenuAction kActPumps       = {ManualPumpsTick, nullptr, nullptr};
+static const MenuAction kActLevels      = {ManualLevelsTick, nullptr, nullptr};
+static const MenuAction kActTimeouts    = {PumpTimeoutsWizard, nullptr, nullptr};
+static const MenuAction kActFill        = {PumpFillLearnWizard, nullptr, nullptr};
+static const MenuAction kActCalADS      = {menuCalADS, nullptr, nullptr};
+static const MenuAction kActCalPH2p     = {menuCalPH2p, nullptr, nullptr};
+static const MenuAction kActCalPH3p     = {menuCalPH3p, nullptr, nullptr};
+static const MenuAction kActCalO2Air    = {menuCalO2Air, nullptr, nullptr};
+static const MenuAction kActCalO2Zero   = {menuCalO2Zero, nullptr, nullptr};
+
+// ---- Vistas de lectura (OK refresca) ----
+static void menuReadADC(char* l0, char* l1, size_t n) {
+  float v = readADC();
+  float m, b; eeprom.getADC(m, b);
+  snprintf(l0, n, "ADC: %.3f V", v);
+  snprintf(l1, n, "m%.3f b%.3f", m, b);
+}
+static void menuReadPH(char* l0, char* l1, size_t n) {
+  snprintf(l0, n, "pH: %.02f", readPH());
+  snprintf(l1, n, "OK refrescar");
+}
+static void menuReadO2(char* l0, char* l1, size_t n) {
+  float v = readO2();
+  if (isfinite(v)) snprintf(l0, n, "O2: %.2f mg/L", v);
+  else             snprintf(l0, n, "O2: --");
+  snprintf(l1, n, "OK refrescar");
+}
+
+static const MenuView kViewADC = {menuReadADC, 0};
+static const MenuView kViewPH  = {menuReadPH, 0};
+static const MenuView kViewO2  = {menuReadO2, 0};
+
+// ---- Temperatura: lectura viva + offset ----
+static int16_t tempOffset = 0;
+
+// Tres períodos de la adquisición (2 s) sin lectura nueva = sin dato
+static constexpr uint32_t MENU_TEMP_MAX_AGE_MS = 6000;
+
+static void menuTempHeader(char* out, size_t n) {
+  // Se redibuja cada 500 ms: readThermo() podía esperar una conversión
+  // (~750 ms) con la adquisición en pausa
+  const float t = cachedThermoC(MENU_TEMP_MAX_AGE_MS);
+  if (!isnan(t)) snprintf(out, n, "T: %.1f C", t);
+  else                        snprintf(out, n, "T: --.- C");
+}
+static const char* menuTempSaved(int16_t) { return "Guardado"; }
+
+static const MenuValue kValTemp = {&tempOffset, -10, 10, 1, "Off:%+d",
+                                   menuTempHeader, menuTempSaved, 500};
+
+// ---- Árbol ----
+static const MenuItem kManualItems[] = {
+  MenuItem::run("Bombas", &kActPumps),
+  MenuItem::run("Sensores Nivel", &kActLevels),
+};
+static const MenuPage kManualPage = menuPage("Manual", kManualItems);
+
+static const MenuItem kPHItems[] = {
+  MenuItem::show("Leer pH", &kViewPH),
+  MenuItem::run("Cal 7-4 (2p)", &kActCalPH2p),
+  MenuItem::run("Cal 4-7-10 (PW)", &kActCalPH3p),
+};
+static const MenuPage kPHPage = menuPage("Calibrar pH", kPHItems);
+
+static const MenuItem kO2Items[] = {
+  MenuItem::show("Leer O2", &kViewO2),
+  MenuItem::run("Cal aire (1p)", &kActCalO2Air),
+  MenuItem::run("Cal cero+aire", &kActCalO2Zero),
+};
+static const MenuPage kO2Page = menuPage("Calibrar O2", kO2Items);
+
+static const MenuItem kADSItems[] = {
+  MenuItem::show("Leer ADC", &kViewADC),
+  MenuItem::run("Calibrar", &kActCalADS),
+};
+static const MenuPage kADSPage = menuPage("Calibrar ADC", kADSItems);
+
+static const MenuItem kConfigItems[] = {
+  MenuItem::submenu("pH", &kPHPage),
+  MenuItem::submenu("O2", &kO2Page),
+  MenuItem::edit("Temperatura", &kValTemp),
+  MenuItem::submenu("ADC", &kADSPage),
+  MenuItem::run("Timeouts", &kActTimeouts),
+  MenuItem::run("Fill (aprender)", &kActFill),
+};
+static const MenuPage kConfigPage = menuPage("Configuracion", kConfigItems);
+
+static const MenuItem kRootItems[] = {
+  MenuItem::submenu("Manual", &kManualPage),
+  MenuItem::run("Automatico", &kActAuto),
+  MenuItem::submenu("Configuracion", &kConfigPage),
+};
+static const MenuPage kRootPage = menuPage("Menu", kRootItems);
+
+static const MenuItem kAutoItem = MenuItem::run("Automatico", &kActAuto);
+
+// Autorepeticiones (150 ms) antes de pasar a UP/DOWN_FAST: ~1.2 s mantenido
+static constexpr uint8_t MENU_FAST_REPEATS = 5;
+
+static MenuKey readMenuKey() {
+  using namespace Buttons;
+  if (BTN_ESC.held)  { BTN_ESC.reset();  return MenuKey::HOME; }   // LONG
+  if (BTN_OK.value)  { BTN_OK.reset();   return MenuKey::OK; }
+  if (BTN_ESC.value) { BTN_ESC.reset();  return MenuKey::ESC; }
+  if (BTN_UP.value) {
+    const bool fast = BTN_UP.repeats >= MENU_FAST_REPEATS;
+    BTN_UP.reset();
+    return fast ? MenuKey::UP_FAST : MenuKey::UP;
+  }
+  if (BTN_DOWN.value) {
+    const bool fast = BTN_DOWN.repeats >= MENU_FAST_REPEATS;
+    BTN_DOWN.reset();
+    return fast ? MenuKey::DOWN_FAST : MenuKey::DOWN;
+  }
+  // LONG de OK/UP/DOWN: sin uso en el menú, no debe quedar latcheado
+  if (BTN_OK.held)   BTN_OK.reset();
+  if (BTN_UP.held)   BTN_UP.reset();
+  if (BTN_DOWN.held) BTN_DOWN.reset();
+  return MenuKey::NONE;
+}
+
+// Latencia de un comando UART hasta la acción (esp_timer, µs):
+// aviso de RX → en cola → AUTO abierto
+static uint32_t cmdLatencyMaxUs = 0;
+
+static void logCommandLatency(const UartProto::UartCommand& c) {
+  const uint32_t nowUs = (uint32_t)esp_timer_get_time();
+  const uint32_t total = nowUs - c.rxUs;
+  if (total > cmdLatencyMaxUs) cmdLatencyMaxUs = total;
+  LOG_I(LogMod::UART, "[CMD] auto_measure rx->cola %lu us, cola->AUTO %lu us, total %lu us (max %lu)",
+        (unsigned long)(c.queuedUs - c.rxUs), (unsigned long)(nowUs - c.queuedUs),
+        (unsigned long)total, (unsigned long)cmdLatencyMaxUs);
+}
 
+static void MenuDemoTick(const UartProto::UartCommand* cmd) {
+  static LcdMenuDisplay display;
+  static MenuTree menu;
   static bool init = false;
-  static View view = View::ROOT;
-  static bool autoFirst = true;
-
-  // ----- Menús -----
-  static const char *rootItems[] = {"Manual", "Automatico", "Configuracion"};
-  static uint8_t rootCursor = 0;
-  const uint8_t ROOT_N = sizeof(rootItems) / sizeof(rootItems[0]);
-
-  static const char *manualItems[] = {"Bombas", "Sensores Nivel"};
-  static uint8_t manualCursor = 0;
-  const uint8_t MAN_N = sizeof(manualItems) / sizeof(manualItems[0]);
-
-  static const char *cfgItems[] = {"pH", "O2", "Temperatura", "ADC", "Timeouts", "Fill (aprender)"};
-  static uint8_t cfgCursor = 0;
-  const uint8_t CFG_N = sizeof(cfgItems) / sizeof(cfgItems[0]);
-
-  static const char *adsItems[] = {"Leer ADC", "Calibrar"};
-  static uint8_t adsCursor = 0;
-  const uint8_t ADS_N = sizeof(adsItems) / sizeof(adsItems[0]);
-
-  // ---- Submenú pH: leer + 2 calibraciones ----
-  static const char *phItems[] = {
-    "Leer pH",
-    "Cal 7-4 (2p)",
-    "Cal 4-7-10 (PW)"
-  };
-  static uint8_t phCursor = 0;
-  const uint8_t PH_N = sizeof(phItems) / sizeof(phItems[0]);
-
-  // ---- Temperatura ----
-  static int8_t tempOffset = 0;
-  static float lastTemp = -1.0f;
-  static unsigned long lastReadMs = 0;
-  const unsigned long TEMP_READ_PERIOD = 500; // ms
-
-  // ---- UI helpers ----
-  auto renderRoot = [&]() {
-    lcd.printAt(0, 0, "Menu");
-    String line = ">" + String(rootItems[rootCursor]);
-    lcd.printAt(0, 1, line);
-  };
-  auto renderManualMenu = [&]() {
-    lcd.printAt(0, 0, "Manual");
-    lcd.printAt(0, 1, ">" + String(manualItems[manualCursor]));
-  };
-  auto renderConfig = [&]() {
-    lcd.printAt(0, 0, "Configuracion");
-    lcd.printAt(0, 1, ">" + String(cfgItems[cfgCursor]));
-  };
-  auto renderTemp = [&]() {
-    String l0 = "T:";
-    if (lastTemp >= 0.0f) l0 += " " + String(lastTemp, 1) + " C";
-    else l0 += " --.- C";
-    lcd.printAt(0, 0, l0);
-    char buf[17];
-    snprintf(buf, sizeof(buf), "Off:%+d", (int)tempOffset);
-    lcd.printAt(0, 1, buf);
-  };
-  auto renderADSMenu = [&]() {
-    lcd.printAt(0, 0, "Calibrar ADC");
-    lcd.printAt(0, 1, ">" + String(adsItems[adsCursor]));
-  };
-  auto renderPHMenu = [&]() {
-    lcd.printAt(0, 0, "Calibrar pH");
-    lcd.printAt(0, 1, ">" + String(phItems[phCursor]));
-  };
-  auto renderADSRead = [&]() {
-    float v = readADC();
-    float m, b; eeprom.getADC(m, b);
-    char l0[17]; snprintf(l0, sizeof(l0), "ADC: %.3f V", v);
-    char l1[17]; snprintf(l1, sizeof(l1), "m%.3f b%.3f", m, b);
-    lcd.printAt(0, 0, l0);
-    lcd.printAt(0, 1, l1);
-  };
-  auto renderPHRead = [&]() {
-    float phv = readPH();
-    char l0[17]; snprintf(l0, sizeof(l0), "pH: %.02f", phv);
-    lcd.printAt(0, 0, l0);
-    lcd.printAt(0, 1, "OK refrescar");
-  };
 
-  // ---- Init ----
   if (!init) {
-    lcd.clear();
-    renderRoot();
+    menu.begin(&kRootPage, &display, lcd.cols(), lcd.rows(), millis());
     init = true;
-    remoteManager.log("[MENU] Init -> ROOT");
+    LOG_I(LogMod::MENU, "[MENU] Init -> ROOT");
   }
 
+  // ---- Receta nueva por UART (nunca con AUTO en curso) ----
+  const MenuItem* active = menu.active();
+  if (!active || active->action != &kActAuto) applyPendingRecipe();
+
   // ---- Auto mode trigger por UART ----
+  // El comando llega por cola; si el menú no está en ROOT queda el bit
+  // auto_req y se atiende al volver (con la latencia del comando guardado)
+  static bool pendingCmd = false;
+  static UartProto::UartCommand lastCmd;
+  if (cmd && cmd->type == UartProto::UartCmd::AUTO_MEASURE) { lastCmd = *cmd; pendingCmd = true; }
+
   static bool prevAutoReq = false;
   bool autoReq = uart2.getAutoMeasureRequested();
   bool autoRun = uart2.getAutoRunning();
-  if (view == View::ROOT) {
+  if (menu.atRoot()) {
     if ((autoReq && !prevAutoReq) || (autoReq && !autoRun)) {
-      view = View::AUTO; autoFirst = true;
-      remoteManager.log("[MENU] DISPARO AUTO desde ROOT");
+      menu.open(&kAutoItem, millis());
+      LOG_I(LogMod::MENU, "[MENU] DISPARO AUTO desde ROOT");
+      if (pendingCmd) logCommandLatency(lastCmd);
+      pendingCmd = false;
     }
   }
+  if (!autoReq) pendingCmd = false;
   prevAutoReq = autoReq;
 
-  // ---- Botones ----
+  // ---- Botones: con una acción abierta los lee ella ----
   Buttons::testButtons();
-  enum class Btn : uint8_t { NONE, OK, ESC, UP, DOWN };
-  auto readLatched = []() -> Btn {
-    if (Buttons::BTN_OK.value)   { Buttons::BTN_OK.reset();   return Btn::OK; }
-    if (Buttons::BTN_ESC.value)  { Buttons::BTN_ESC.reset();  return Btn::ESC; }
-    if (Buttons::BTN_UP.value)   { Buttons::BTN_UP.reset();   return Btn::UP; }
-    if (Buttons::BTN_DOWN.value) { Buttons::BTN_DOWN.reset(); return Btn::DOWN; }
-    return Btn::NONE;
-  };
-
-  // ---- Refresco temperatura ----
-  if (view == View::TEMP) {
-    unsigned long now = millis();
-    if (now - lastReadMs >= TEMP_READ_PERIOD) {
-      lastReadMs = now;
-      float t = readThermo();
-      lastTemp = (t >= 0.0f && !isnan(t)) ? t : -1.0f;
-      renderTemp();
-    }
-  }
-
-  // ---- FSM ----
-  switch (view) {
-  // ---------- ROOT ----------
-  case View::ROOT: {
-    switch (readLatched()) {
-      case Btn::UP:
-        rootCursor = (rootCursor == 0) ? 2 : rootCursor - 1;
-        lcd.clear(); renderRoot(); break;
-      case Btn::DOWN:
-        rootCursor = (rootCursor + 1) % 3;
-        lcd.clear(); renderRoot(); break;
-      case Btn::OK:
-        if (rootCursor == 0) { view = View::MANUAL_MENU; lcd.clear(); renderManualMenu(); }
-        else if (rootCursor == 1) { view = View::AUTO; autoFirst = true; lcd.clear(); }
-        else { view = View::CONFIG; lcd.clear(); renderConfig(); }
-        break;
-      default: break;
-    }
-  } break;
-
-  // ---------- MANUAL ----------
-  case View::MANUAL_MENU: {
-    switch (readLatched()) {
-      case Btn::UP:
-        manualCursor = (manualCursor == 0) ? 1 : manualCursor - 1;
-        lcd.clear(); renderManualMenu(); break;
-      case Btn::DOWN:
-        manualCursor = (manualCursor + 1) % 2;
-        lcd.clear(); renderManualMenu(); break;
-      case Btn::OK:
-        lcd.clear();
-        view = (manualCursor == 0) ? View::MANUAL_PUMPS : View::MANUAL_LEVELS;
-        break;
-      case Btn::ESC:
-        view = View::ROOT; lcd.clear(); renderRoot(); break;
-      default: break;
-    }
-  } break;
-
-  case View::MANUAL_PUMPS:
-    if (ManualPumpsTick()) { view = View::MANUAL_MENU; lcd.clear(); renderManualMenu(); }
-    break;
-  case View::MANUAL_LEVELS:
-    if (ManualLevelsTick()) { view = View::MANUAL_MENU; lcd.clear(); renderManualMenu(); }
-    break;
-
-  // ---------- AUTO ----------
-  case View::AUTO:
-    if (autoFirst) { lcd.clear(); autoFirst = false; }
-    uart2.setAutoRunning(true);
-    if (AutoModeTick()) {
-      view = View::ROOT; lcd.clear(); renderRoot();
-      uart2.setAutoRunning(false);
-      uart2.setAutoMeasureRequested(false);
-    }
-    break;
-
-  // ---------- CONFIG ----------
-  case View::CONFIG: {
-    switch (readLatched()) {
-      case Btn::UP:
-        cfgCursor = (cfgCursor == 0) ? (CFG_N - 1) : cfgCursor - 1;
-        lcd.clear(); renderConfig(); break;
-      case Btn::DOWN:
-        cfgCursor = (cfgCursor + 1) % CFG_N;
-        lcd.clear(); renderConfig(); break;
-      case Btn::OK:
-        lcd.clear();
-        if (cfgCursor == 0) view = View::CAL_PH_MENU, renderPHMenu();
-        else if (cfgCursor == 1) lcd.splash("Calibrar O2", "Pendiente", 700), renderConfig();
-        else if (cfgCursor == 2) view = View::TEMP, renderTemp();
-        else if (cfgCursor == 3) view = View::CAL_ADS_MENU, renderADSMenu();
-        else if (cfgCursor == 4) view = View::CFG_TIMEOUTS;
-        else view = View::CFG_FILL;
-        break;
-      case Btn::ESC:
-        view = View::ROOT; lcd.clear(); renderRoot(); break;
-      default: break;
-    }
-  } break;
-
-  // ---------- CALIBRACIÓN PH ----------
-  case View::CAL_PH_MENU: {
-    switch (readLatched()) {
-      case Btn::UP:
-        phCursor = (phCursor == 0) ? (PH_N - 1) : phCursor - 1;
-        lcd.clear(); renderPHMenu(); break;
-      case Btn::DOWN:
-        phCursor = (phCursor + 1) % PH_N;
-        lcd.clear(); renderPHMenu(); break;
-      case Btn::OK:
-        if (phCursor == 0) view = View::CAL_PH_READ, lcd.clear(), renderPHRead();
-        else if (phCursor == 1) view = View::CAL_PH_RUN_2P, lcd.clear();
-        else view = View::CAL_PH_RUN_3P_PW, lcd.clear();
-        break;
-      case Btn::ESC:
-        view = View::CONFIG; lcd.clear(); renderConfig(); break;
-      default: break;
-    }
-  } break;
-
-  case View::CAL_PH_READ: {
-    switch (readLatched()) {
-      case Btn::OK: lcd.clear(); renderPHRead(); break;
-      case Btn::ESC: view = View::CAL_PH_MENU; lcd.clear(); renderPHMenu(); break;
-      default: break;
-    }
-  } break;
-
-  case View::CAL_PH_RUN_2P:
-    if (runPHCalibration_7_4(31)) {
-      view = View::CAL_PH_MENU; lcd.clear(); renderPHMenu();
-    }
-    break;
-
-  case View::CAL_PH_RUN_3P_PW:
-    if (runPHCalibration_4_7_10(31, false)) {
-      view = View::CAL_PH_MENU; lcd.clear(); renderPHMenu();
-    }
-    break;
-
-  // ---------- WIZARDS ----------
-  case View::CFG_TIMEOUTS:
-    if (PumpTimeoutsWizard()) { view = View::CONFIG; lcd.clear(); renderConfig(); }
-    break;
-  case View::CFG_FILL:
-    if (PumpFillLearnWizard()) { view = View::CONFIG; lcd.clear(); renderConfig(); }
-    break;
-
-  // ---------- TEMP ----------
-  case View::TEMP: {
-    switch (readLatched()) {
-      case Btn::UP: if (tempOffset < 10) ++tempOffset; lcd.clear(); renderTemp(); break;
-      case Btn::DOWN: if (tempOffset > -10) --tempOffset; lcd.clear(); renderTemp(); break;
-      case Btn::OK: lcd.splash("Temp offset", "Guardado", 600); view = View::CONFIG; lcd.clear(); renderConfig(); break;
-      case Btn::ESC: view = View::CONFIG; lcd.clear(); renderConfig(); break;
-      default: break;
-    }
-  } break;
-  }
+  menu.tick(menu.busy() ? MenuKey::NONE : readMenuKey(), millis());
 }
@@ -71,6 +71,7 @@ void taskCore0(void *pvParameters) {
       // TestBoard::testButtons();
       // readADS();
       // readPH();
+      thermo.update();   // DS18B20 asíncrono: misma tarea que readThermo()
       MenuDemoTick();
       // AutoModeTick();
     }
@@ -255,7 +256,9 @@ float readThermo(){
     // delay(1000);
     return -1;
   }
-  float c = thermo.readC(0);
+  // Último valor de las conversiones asíncronas; bloqueante solo si está viejo
+  float c = thermo.cachedC(0, 3000);
+  if (isnan(c)) c = thermo.readC(0);
   if (isnan(c)) {
     // Serial.println("Lectura inválida");
     remoteManager.log("Lectura inválida");
@@ -5,16 +5,41 @@
 #include <OneWire.h>
 #include <DallasTemperature.h>
 
+/** Estado de un sensor dentro de DS18B20Snapshot. */
+struct DS18B20Probe {
+  float    c = NAN;          // último valor válido (°C)
+  uint32_t ms = 0;           // millis() en que se leyó ese valor
+  bool     fresh = false;    // la última lectura de este sensor fue válida
+  // Contadores de 32 bits: a 1 lectura/s uno de 16 daba la vuelta en 18 h
+  uint32_t reads = 0;        // scratchpads leídos (válidos o no)
+  uint32_t crcErrors = 0;    // CRC del scratchpad no coincide
+  uint32_t noResponse = 0;   // sin pulso de presencia o scratchpad en 0
+  uint32_t porErrors = 0;    // 85 °C de power-on: el sensor no convirtió
+};
+
+/** Todos los sensores de una misma conversión (para registrarlos juntos). */
+struct DS18B20Snapshot {
+  static constexpr uint8_t MAX_SENSORS = 8;
+  uint32_t     seq = 0;          // crece con cada lectura completa del bus
+  uint32_t     convStartMs = 0;  // inicio de la conversión común
+  uint32_t     readMs = 0;       // fin de la lectura de scratchpads
+  uint8_t      count = 0;
+  DS18B20Probe probe[MAX_SENSORS];
+};
+
 /**
  * - Lecturas bloqueantes y directas (°C y °F)
+ * - Modo no bloqueante: requestConversion()/update() y último valor cacheado
+ *   con su edad; update() agenda sola la próxima conversión (setAutoPeriod)
+ * - Varios sensores: un Convert T (Skip ROM) para todo el bus y una sola espera;
+ *   luego cada scratchpad con CRC y contadores de error por sensor (snapshot())
  * - Detecta y guarda hasta MAX_SENSORS al iniciar
- * - Sin modos no-bloqueantes
- * - Pin, resolución
+ * - Pin, resolución (9 bits: 94 ms/0.5 °C ... 12 bits: 750 ms/0.0625 °C)
  */
 class DS18B20Manager {
 public:
   using DevAddr = DeviceAddress;
-  static constexpr uint8_t MAX_SENSORS = 8;
+  static constexpr uint8_t MAX_SENSORS = DS18B20Snapshot::MAX_SENSORS;
 
   explicit DS18B20Manager(uint8_t dataPin, uint8_t resolutionBits = 12);
 
@@ -27,6 +52,13 @@ public:
   /** Lee en °C (bloqueante). Devuelve NAN si falla o índice inválido. */
   float readC(uint8_t index = 0);
 
+  /**
+   * Lee todos los sensores (bloqueante, ~una conversión para N sensores):
+   * un Convert T broadcast, una espera y los N scratchpads.
+   * Retorna cuántos sensores dieron lectura válida.
+   */
+  uint8_t readAll(DS18B20Snapshot &out);
+
   /** Lee en °F (bloqueante). Devuelve NAN si falla o índice inválido. */
   float readF(uint8_t index = 0);
 
@@ -36,6 +68,47 @@ public:
   /** Convierte dirección a texto tipo "28-FF-...". */
   static void addrToString(const DevAddr addr, char *out, size_t outLen);
 
+  // ---------- Resolución / latencia ----------
+
+  /** 9..12 bits. Menos bits = conversión más corta y menos precisa. */
+  void setResolution(uint8_t bits);
+  uint8_t resolution() const { return _resolution; }
+
+  /** Tiempo máximo de conversión para la resolución actual (ms). */
+  uint16_t conversionMs() const { return DallasTemperature::millisToWaitForConversion(_resolution); }
+
+  // ---------- Modo no bloqueante ----------
+
+  /**
+   * Período entre inicios de conversión que agenda update() (ms).
+   * 0 = solo conversiones pedidas con requestConversion().
+   * Menor que conversionMs() => conversiones encadenadas.
+   */
+  void setAutoPeriod(uint32_t ms) { _autoPeriodMs = ms; }
+  uint32_t autoPeriod() const { return _autoPeriodMs; }
+
+  /** Inicia una conversión de todos los sensores sin esperarla. false si no hay sensores o ya hay una en curso. */
+  bool requestConversion();
+
+  /**
+   * Avanza la máquina de estados; llamar seguido (loop/tarea) desde UNA sola tarea.
+   * Cierra la conversión en curso al vencer conversionMs() (o antes si el sensor
+   * avisa que terminó), cachea los valores y agenda la siguiente.
+   * Nunca espera la conversión: solo lee los scratchpads al terminar.
+   */
+  void update();
+
+  bool isConverting() const { return _converting; }
+
+  /** Último valor completado (°C) y su edad (ms desde que se leyó). false si aún no hay. */
+  bool lastC(uint8_t index, float &c, uint32_t &ageMs) const;
+
+  /** Último valor (°C), o NAN si no hay o es más viejo que maxAgeMs. */
+  float cachedC(uint8_t index = 0, uint32_t maxAgeMs = 0xFFFFFFFFUL) const;
+
+  /** Todos los sensores de la última lectura completa, con sus contadores. Misma tarea que update(). */
+  const DS18B20Snapshot &snapshot() const { return _snap; }
+
 private:
   uint8_t  _pin;
   uint8_t  _resolution;   // 9..12
@@ -45,9 +118,19 @@ private:
   uint8_t _count = 0;
   DevAddr _addr[MAX_SENSORS];
 
+  // Estado no bloqueante
+  bool     _parasite = false;      // en modo parásito no se puede sondear el fin de conversión
+  bool     _converting = false;
+  bool     _started = false;       // hubo al menos un inicio (para el primer disparo de update)
+  uint32_t _convStartMs = 0;
+  uint32_t _autoPeriodMs = 1000;
+  DS18B20Snapshot _snap;
+
   bool  _valid(uint8_t i) const { return i < _count; }
-  float _norm(float c) const; // convierte DEVICE_DISCONNECTED_C a NAN
+  bool  _conversionDone(uint32_t now);
+  bool  _readProbe(uint8_t i);       // scratchpad + CRC + contadores; true si válido
+  uint8_t _collect();
 };
 
 
-#endif // DS18B20_MANAGER_H
\ No newline at end of file
+#endif // DS18B20_MANAGER_H
@@ -1,4 +1,5 @@
 #include "LevelSensorMaster.h"
+#include "log_manager.h"
 
 namespace LevelSensorMaster {
 
@@ -33,14 +34,14 @@ namespace LevelSensorMaster {
     s_wire->beginTransmission(s_addr);
     s_wire->write(reg);
     if (s_wire->endTransmission() != 0) {
-      Serial.printf("[LevelSensorMaster] falló TX reg 0x%02X\n", reg);
+      LOG_W(LogMod::I2C, "[LevelSensorMaster] falló TX reg 0x%02X", reg);
       return NAN;
     }
 
     // 2) Solicitar 4 bytes
     int n = s_wire->requestFrom((int)s_addr, 4);
     if (n != 4) {
-      Serial.printf("[LevelSensorMaster] esperaba 4 bytes en reg 0x%02X, recibí %d\n", reg, n);
+      LOG_W(LogMod::I2C, "[LevelSensorMaster] esperaba 4 bytes en reg 0x%02X, recibí %d", reg, n);
       return NAN;
     }
 
@@ -61,7 +62,7 @@ namespace LevelSensorMaster {
     uint8_t err = s_wire->endTransmission();
 
     if (err != 0) {
-      Serial.printf("[LevelSensorMaster] Error I2C al escribir reg 0x%02X, code=%u\n", reg, err);
+      LOG_W(LogMod::I2C, "[LevelSensorMaster] Error I2C al escribir reg 0x%02X, code=%u", reg, err);
       return false;
     }
     return true;
@@ -71,13 +72,13 @@ namespace LevelSensorMaster {
     s_wire->beginTransmission(s_addr);
     s_wire->write(reg);
     if (s_wire->endTransmission() != 0) {
-      Serial.printf("[LevelSensorMaster] falló TX byte reg 0x%02X\n", reg);
+      LOG_W(LogMod::I2C, "[LevelSensorMaster] falló TX byte reg 0x%02X", reg);
       return def;
     }
 
     int n = s_wire->requestFrom((int)s_addr, 1);
     if (n != 1 || !s_wire->available()) {
-      Serial.printf("[LevelSensorMaster] esperaba 1 byte en reg 0x%02X, recibí %d\n", reg, n);
+      LOG_W(LogMod::I2C, "[LevelSensorMaster] esperaba 1 byte en reg 0x%02X, recibí %d", reg, n);
       return def;
     }
     return s_wire->read();
@@ -1,5 +1,6 @@
 #include "I2CSlaveManager.h"
 #include "Globals.h"
+#include "log_manager.h"
 
 namespace I2CSlaveManager {
 
@@ -19,7 +20,7 @@ void begin(uint8_t address) {
     Wire.onReceive(onReceive);
     Wire.onRequest(onRequest);
 
-    Serial.printf("[I2C SLAVE] Iniciado en dirección 0x%02X\n", address);
+    LOG_I(LogMod::I2C, "[I2C SLAVE] Iniciado en dirección 0x%02X", address);
 }
 
 void setFilteredDistance(float d) {
@@ -31,7 +32,7 @@ void setRawDistance(float d) {
 }
 
 void printLastRequest() {
-    Serial.printf("[I2C SLAVE] Master pidió registro 0x%02X\n", lastRequestedRegister);
+    LOG_D(LogMod::I2C, "[I2C SLAVE] Master pidió registro 0x%02X", lastRequestedRegister);
 }
 
 // ======================================================
@@ -63,10 +64,10 @@ static void onReceive(int len) {
 
         if (reg == 0x08) {
             Globals::setMinLevel(u.f);
-            Serial.printf("[I2C SLAVE] setMinLevel via I2C = %.2f cm\n", u.f);
+            LOG_I(LogMod::I2C, "[I2C SLAVE] setMinLevel via I2C = %.2f cm", u.f);
         } else { // 0x0C
             Globals::setMaxLevel(u.f);
-            Serial.printf("[I2C SLAVE] setMaxLevel via I2C = %.2f cm\n", u.f);
+            LOG_I(LogMod::I2C, "[I2C SLAVE] setMaxLevel via I2C = %.2f cm", u.f);
         }
 
         // descartar bytes extra si el maestro mandó más de la cuenta
@@ -92,7 +93,7 @@ static void onRequest() {
     case 0x00: {
         union { float f; uint8_t b[4]; } u;
         u.f = Globals::getDistanceFiltered();
-        Serial.printf("[I2C SLAVE] Enviando filtrado=%.2f\n", u.f);
+        LOG_D(LogMod::I2C, "[I2C SLAVE] Enviando filtrado=%.2f", u.f);
         Wire.write(u.b, 4);
         break;
     }
@@ -101,7 +102,7 @@ static void onRequest() {
     case 0x04: {
         union { float f; uint8_t b[4]; } u;
         u.f = Globals::getDistanceRaw();
-        Serial.printf("[I2C SLAVE] Enviando raw=%.2f\n", u.f);
+        LOG_D(LogMod::I2C, "[I2C SLAVE] Enviando raw=%.2f", u.f);
         Wire.write(u.b, 4);
         break;
     }
@@ -110,7 +111,7 @@ static void onRequest() {
     case 0x08: {
         union { float f; uint8_t b[4]; } u;
         u.f = Globals::getMinLevel();
-        Serial.printf("[I2C SLAVE] Enviando nivel minimo=%.2f\n", u.f);
+        LOG_D(LogMod::I2C, "[I2C SLAVE] Enviando nivel minimo=%.2f", u.f);
         Wire.write(u.b, 4);
         break;
     }
@@ -119,7 +120,7 @@ static void onRequest() {
     case 0x0C: {
         union { float f; uint8_t b[4]; } u;
         u.f = Globals::getMaxLevel();
-        Serial.printf("[I2C SLAVE] Enviando nivel maximo=%.2f\n", u.f);
+        LOG_D(LogMod::I2C, "[I2C SLAVE] Enviando nivel maximo=%.2f", u.f);
         Wire.write(u.b, 4);
         break;
     }
@@ -128,7 +129,7 @@ static void onRequest() {
     case 0x10: {
         union { float f; uint8_t b[4]; } u;
         u.f = Globals::getTemperature();   // asegúrate de tener esta función en Globals
-        Serial.printf("[I2C SLAVE] Enviando temperatura=%.2f °C\n", u.f);
+        LOG_D(LogMod::I2C, "[I2C SLAVE] Enviando temperatura=%.2f °C", u.f);
         Wire.write(u.b, 4);
         break;
     }
@@ -0,0 +1,68 @@
+#include "log_manager.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* const kModNames[(size_t)LogMod::COUNT] = {
+  "sys", "sens", "i2c", "cfg"
+};
+
+static const char* const kLvlNames[] = {
+  "none", "error", "warn", "info", "debug"
+};
+
+// Todos arrancan en el máximo compilado
+uint8_t logLevels[(size_t)LogMod::COUNT] = {
+  LOG_LVL_MAX, LOG_LVL_MAX, LOG_LVL_MAX, LOG_LVL_MAX
+};
+
+static LogSink sink_ = nullptr;
+
+void logSetSink(LogSink sink) { sink_ = sink; }
+
+void logSetLevel(LogMod mod, uint8_t lvl) {
+  if ((size_t)mod >= (size_t)LogMod::COUNT) return;
+  logLevels[(size_t)mod] = lvl > LOG_LVL_DEBUG ? LOG_LVL_DEBUG : lvl;
+}
+
+void logSetAll(uint8_t lvl) {
+  for (size_t i = 0; i < (size_t)LogMod::COUNT; ++i) logSetLevel((LogMod)i, lvl);
+}
+
+uint8_t logLevel(LogMod mod) {
+  return (size_t)mod < (size_t)LogMod::COUNT ? logLevels[(size_t)mod] : LOG_LVL_NONE;
+}
+
+const char* logModName(LogMod mod) {
+  return (size_t)mod < (size_t)LogMod::COUNT ? kModNames[(size_t)mod] : "?";
+}
+
+const char* logLevelName(uint8_t lvl) {
+  return lvl <= LOG_LVL_DEBUG ? kLvlNames[lvl] : "?";
+}
+
+bool logParseModule(const char* name, LogMod& mod) {
+  if (!name) return false;
+  for (size_t i = 0; i < (size_t)LogMod::COUNT; ++i) {
+    if (!strcmp(name, kModNames[i])) { mod = (LogMod)i; return true; }
+  }
+  return false;
+}
+
+bool logParseLevel(const char* name, uint8_t& lvl) {
+  if (!name) return false;
+  for (uint8_t i = 0; i <= LOG_LVL_DEBUG; ++i) {
+    if (!strcmp(name, kLvlNames[i])) { lvl = i; return true; }
+  }
+  return false;
+}
+
+void logWrite(const char* fmt, ...) {
+  if (!sink_) return;
+  char line[LOG_LINE_MAX];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(line, sizeof(line), fmt, ap);
+  va_end(ap);
+  sink_(line);
+}
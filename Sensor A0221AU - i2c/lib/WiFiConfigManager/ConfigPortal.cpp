@@ -1,6 +1,7 @@
 #include <stdlib.h> 
 #include "ConfigPortal.h"
 #include "Globals.h"
+#include "log_manager.h"
 
 
 static const byte DNS_PORT = 53;
@@ -20,15 +21,14 @@ String ConfigPortal::makeApName() {
 void ConfigPortal::startAP() {
   _apName = makeApName();
 
-  Serial.println("[ConfigPortal] Iniciando AP: " + _apName);
+  LOG_I(LogMod::CFG, "[ConfigPortal] Iniciando AP: %s", _apName.c_str());
 
   WiFi.mode(WIFI_AP);
   WiFi.softAP(_apName.c_str(), "12345678");   // contraseña por ahora fija
   delay(200);
 
   IPAddress apIP = WiFi.softAPIP();
-  Serial.print("[ConfigPortal] IP AP: ");
-  Serial.println(apIP);
+  LOG_I(LogMod::CFG, "[ConfigPortal] IP AP: %s", apIP.toString().c_str());
 
   // DNS tipo "captive": cualquier dominio -> IP del AP
   _dns.start(DNS_PORT, "*", apIP);
@@ -494,7 +494,7 @@ setInterval(fetchStatus, 100);
         if (val > 127) val = 127;
 
         Globals::setI2CAddress((uint8_t)val);
-        Serial.printf("[ConfigPortal] Nueva dirección I2C (HEX) = 0x%02lX (%ld)\n", val, val);
+        LOG_I(LogMod::CFG, "[ConfigPortal] Nueva dirección I2C (HEX) = 0x%02lX (%ld)", val, val);
     }
 
 
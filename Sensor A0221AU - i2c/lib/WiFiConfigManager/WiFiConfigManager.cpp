@@ -1,5 +1,6 @@
 #include "WiFiConfigManager.h"
 #include <WiFi.h>
+#include "log_manager.h"
 
 void WiFiConfigManager::begin(const char* apName, const char* apPass, uint32_t apTimeoutMs) {
     // En tu arquitectura actual, el AP REAL lo levanta ConfigPortal::startAP().
@@ -8,9 +9,9 @@ void WiFiConfigManager::begin(const char* apName, const char* apPass, uint32_t a
     _apStartMs   = millis();
     _state       = APState::ACTIVE;
 
-    Serial.println("[WiFiConfig] Temporizador de AP iniciado");
-    Serial.printf("[WiFiConfig] AP se apagará en %lu ms (si no se cambia la lógica)\n",
-                  (unsigned long)_apTimeoutMs);
+    LOG_I(LogMod::CFG, "[WiFiConfig] Temporizador de AP iniciado");
+    LOG_I(LogMod::CFG, "[WiFiConfig] AP se apagará en %lu ms (si no se cambia la lógica)",
+          (unsigned long)_apTimeoutMs);
 
     // Si en algún momento quieres que WiFiConfigManager levante el AP él mismo,
     // podrías descomentar esto y quitar el softAP del ConfigPortal:
@@ -28,7 +29,7 @@ void WiFiConfigManager::update() {
 
     unsigned long now = millis();
     if (now - _apStartMs >= _apTimeoutMs) {
-        Serial.println("[WiFiConfig] Timeout alcanzado → apagando AP");
+        LOG_I(LogMod::CFG, "[WiFiConfig] Timeout alcanzado → apagando AP");
         stopAP();
     }
 }
@@ -38,7 +39,7 @@ void WiFiConfigManager::stopAP() {
         return;
     }
 
-    Serial.println("[WiFiConfig] Desconectando softAP y apagando WiFi...");
+    LOG_I(LogMod::CFG, "[WiFiConfig] Desconectando softAP y apagando WiFi...");
 
     // Desconecta el AP (borra clientes y apaga beacon)
     WiFi.softAPdisconnect(true);
@@ -46,5 +47,5 @@ void WiFiConfigManager::stopAP() {
     // WiFi.mode(WIFI_OFF);
 
     _state = APState::OFF;
-    Serial.println("[WiFiConfig] AP apagado");
+    LOG_I(LogMod::CFG, "[WiFiConfig] AP apagado");
 }
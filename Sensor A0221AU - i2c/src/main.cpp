@@ -6,6 +6,7 @@
 #include "Globals.h"
 #include "Storage.h"
 #include "I2CSlaveManager.h"
+#include "log_manager.h"
 
 
 
@@ -66,6 +67,7 @@ float readThermo();
 
 void setup() {
   Serial.begin(115200);
+  logSetSink([](const char* line) { Serial.println(line); });
   delay(300);
 
   // Salidas
@@ -82,7 +84,7 @@ void setup() {
   // Levantar el portal (AP + DNS + Web)
   portal.begin();
 
-  Serial.println("\n[MAIN] Sistema iniciado.");
+  LOG_I(LogMod::SYS, "\n[MAIN] Sistema iniciado.");
 }
 
 void loop() {
@@ -98,10 +100,12 @@ void loop() {
   int sp = g_samplePeriodApplied;
   if (sp <= 0) sp = 200;             // fallback por seguridad
 
+  thermo.update();                   // DS18B20 asíncrono: nunca espera la conversión
+
   if (now - g_lastSampleMs >= (unsigned long)sp) {
     g_lastSampleMs = now;
     readDistance();                  // actualizar Globals con lecturas
-    readThermo();                  // leer temperatura y mostrar por Serial
+    readThermo();                    // último valor convertido (no bloquea)
     printSensorStatusIfChanged();
     updateLevelOutputs();            // actualizar salidas digitales
   }
@@ -122,7 +126,7 @@ void setupOutputs() {
 void setupSlaveI2C() {
     uint8_t addr = Globals::getI2CAddress();
     I2CSlaveManager::begin(addr);
-    Serial.println("[MAIN] Dispositivo iniciado como esclavo I2C");
+    LOG_I(LogMod::I2C, "[MAIN] Dispositivo iniciado como esclavo I2C");
 }
 
 void i2cUpdate() {
@@ -133,7 +137,7 @@ void i2cUpdate() {
   I2CSlaveManager::setRawDistance(rr);
 
   // debug opcional:
-  Serial.printf("[I2CUpdate] Filt=%.2f  Raw=%.2f\n", fr, rr);
+  LOG_D(LogMod::I2C, "[I2CUpdate] Filt=%.2f  Raw=%.2f", fr, rr);
 }
 
 // ------------------------------------------
@@ -157,9 +161,9 @@ void setupDistance() {
   sensor.setEstimateError(g_kalEstApplied);
   sensor.setProcessNoise(g_kalQApplied);
 
-  Serial.println("[MAIN] Sensor A02 listo.");
-  Serial.printf("[MAIN] Kalman: mea=%.3f est=%.3f q=%.4f, sample=%d ms\n",
-                g_kalMeaApplied, g_kalEstApplied, g_kalQApplied, g_samplePeriodApplied);
+  LOG_I(LogMod::SENS, "[MAIN] Sensor A02 listo.");
+  LOG_I(LogMod::SENS, "[MAIN] Kalman: mea=%.3f est=%.3f q=%.4f, sample=%d ms",
+        g_kalMeaApplied, g_kalEstApplied, g_kalQApplied, g_samplePeriodApplied);
 }
 
 // ------------------------------------------
@@ -176,26 +180,26 @@ void readDistance() {
     Globals::setDistanceFiltered(filt);
 
     // Debug si quieres
-    // Serial.printf(">Crudo: %.2f  | Filtrado: %.2f\n", raw, filt);
+    LOG_D(LogMod::SENS, ">Crudo: %.2f  | Filtrado: %.2f", raw, filt);
   }
 }
 
 void initThermo() {
   uint8_t n = thermo.begin();
-  Serial.println("DS18B20 encontrados: " + String(n));
+  LOG_I(LogMod::SENS, "DS18B20 encontrados: %u", n);
 }
 
 float readThermo() {
   if (thermo.sensorCount() == 0) {
-    Serial.println("Sin sensores");
+    LOG_W(LogMod::SENS, "Sin sensores");
     return -1;
   }
-  float c = thermo.readC(0);
+  float c = thermo.cachedC(0, 3000);
   if (isnan(c)) {
-    Serial.println("Lectura inválida");
+    LOG_W(LogMod::SENS, "Lectura inválida");
     return -1;
   } else {
-    // Serial.printf("T0: %.2f °C\n", c);
+    LOG_D(LogMod::SENS, "T0: %.2f °C", c);
     Globals::setTemperature(c);
     return c;
   }
@@ -230,7 +234,7 @@ void monitorConfigChanges() {
   if (km != g_kalMeaApplied) {
     g_kalMeaApplied = km;
     sensor.setMeasurementError(km);
-    Serial.printf("[CFG] Nuevo kalMea = %.3f\n", km);
+    LOG_I(LogMod::CFG, "[CFG] Nuevo kalMea = %.3f", km);
     changed = true;
   }
 
@@ -239,7 +243,7 @@ void monitorConfigChanges() {
   if (ke != g_kalEstApplied) {
     g_kalEstApplied = ke;
     sensor.setEstimateError(ke);
-    Serial.printf("[CFG] Nuevo kalEst = %.3f\n", ke);
+    LOG_I(LogMod::CFG, "[CFG] Nuevo kalEst = %.3f", ke);
     changed = true;
   }
 
@@ -248,7 +252,7 @@ void monitorConfigChanges() {
   if (kq != g_kalQApplied) {
     g_kalQApplied = kq;
     sensor.setProcessNoise(kq);
-    Serial.printf("[CFG] Nuevo kalQ = %.4f\n", kq);
+    LOG_I(LogMod::CFG, "[CFG] Nuevo kalQ = %.4f", kq);
     changed = true;
   }
 
@@ -256,7 +260,7 @@ void monitorConfigChanges() {
   int sp = Globals::getSamplePeriod();
   if (sp != g_samplePeriodApplied && sp > 0) {
     g_samplePeriodApplied = sp;
-    Serial.printf("[CFG] Nuevo samplePeriod = %d ms\n", sp);
+    LOG_I(LogMod::CFG, "[CFG] Nuevo samplePeriod = %d ms", sp);
     changed = true;
   }
 
@@ -264,14 +268,14 @@ void monitorConfigChanges() {
   float minL = Globals::getMinLevel();
   if (minL != g_minLevelApplied) {
     g_minLevelApplied = minL;
-    Serial.printf("[CFG] Nuevo nivel MIN = %.2f cm\n", minL);
+    LOG_I(LogMod::CFG, "[CFG] Nuevo nivel MIN = %.2f cm", minL);
     changed = true;
   }
 
   float maxL = Globals::getMaxLevel();
   if (maxL != g_maxLevelApplied) {
     g_maxLevelApplied = maxL;
-    Serial.printf("[CFG] Nuevo nivel MAX = %.2f cm\n", maxL);
+    LOG_I(LogMod::CFG, "[CFG] Nuevo nivel MAX = %.2f cm", maxL);
     changed = true;
   }
 
@@ -279,7 +283,7 @@ void monitorConfigChanges() {
   uint8_t ia = Globals::getI2CAddress();
   if (ia != g_i2cAddressApplied) {
     g_i2cAddressApplied = ia;
-    Serial.printf("[CFG] Nueva dirección I2C = %u (0x%02X)\n", ia, ia);
+    LOG_I(LogMod::CFG, "[CFG] Nueva dirección I2C = %u (0x%02X)", ia, ia);
     changed = true;
   }
 
@@ -295,7 +299,7 @@ void monitorConfigChanges() {
     cfg.i2cAddress   = Globals::getI2CAddress();
 
     Storage::saveConfig(cfg);
-    Serial.println("[CFG] Config guardada en NVS");
+    LOG_I(LogMod::CFG, "[CFG] Config guardada en NVS");
   }
 }
 
@@ -306,20 +310,16 @@ void printSensorStatusIfChanged() {
   if (st == g_lastSensorStatus) return;
   g_lastSensorStatus = st;
 
-  Serial.print("[SENSOR] Status = 0x");
-  Serial.printf("%02X -> ", st);
-
   if (st == 0) {
-    Serial.println("OK (sin errores)");
+    LOG_I(LogMod::SENS, "[SENSOR] Status = 0x%02X -> OK (sin errores)", st);
     return;
   }
 
   // Decodificar bits
-  if (st & ERR_CHECKSUM)     Serial.print("CHECKSUM_ERROR ");
-  if (st & ERR_OUT_OF_RANGE) Serial.print("OUT_OF_RANGE ");
-  if (st & ERR_NO_DATA)      Serial.print("NO_DATA ");
-  if (st & ERR_FILTER_NAN)   Serial.print("FILTER_NAN ");
-  if (st & ERR_PKT_FORMAT)   Serial.print("PACKET_FORMAT_ERROR ");
-
-  Serial.println();
+  LOG_W(LogMod::SENS, "[SENSOR] Status = 0x%02X -> %s%s%s%s%s", st,
+        (st & ERR_CHECKSUM)     ? "CHECKSUM_ERROR " : "",
+        (st & ERR_OUT_OF_RANGE) ? "OUT_OF_RANGE " : "",
+        (st & ERR_NO_DATA)      ? "NO_DATA " : "",
+        (st & ERR_FILTER_NAN)   ? "FILTER_NAN " : "",
+        (st & ERR_PKT_FORMAT)   ? "PACKET_FORMAT_ERROR " : "");
 }